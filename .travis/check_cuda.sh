@@ -0,0 +1,12 @@
+#!/usr/bin/env bash
+
+set -ex
+
+# Build the GPU backend against the CUDA toolkit and resolve all of its
+# symbols against the CUDA libraries. Build machines have no GPU, so the
+# device kernels are compiled and linked here but not run.
+docker run --rm -v "$(pwd)":/smelt -w /smelt "${CUDA_DOCKER_IMAGE}" \
+    g++ -std=c++17 -Wall -Werror -fPIC -shared -Wl,--no-undefined \
+        -DSMELT_ENABLE_CUDA -Iinclude -I/usr/local/cuda/include \
+        src/device_backend.cc -o /tmp/libsmelt_device.so \
+        -L/usr/local/cuda/lib64 -lcusolver -lcublas -lcufft -lcudart
@@ -0,0 +1,316 @@
+// Benchmarks of the numeric kernels and stochastic models of smelt, built with
+// Google Benchmark. Scenario parameters are part of each benchmark name, such
+// as BM_Fft/size:4096, and are also reported as counters, so results written
+// with --benchmark_format=json (or --benchmark_out=<file>
+// --benchmark_out_format=json) can be compared between releases.
+//
+// Usage: smelt_benchmarks [--benchmark_filter=<regex>]
+//                         [--benchmark_out=<file> --benchmark_out_format=json]
+//
+// Models are created through the factory by their registered keys at sizes
+// typical of production runs and generate records without writing files.
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <Eigen/Dense>
+#include "configure.h"
+#include "dabaghi_der_kiureghian.h"
+#include "distribution.h"
+#include "factory.h"
+#include "nelder_mead.h"
+#include "normal_multivar.h"
+#include "numeric_utils.h"
+#include "record_iterator.h"
+#include "stochastic_model.h"
+#include "time_history_block.h"
+
+namespace {
+/**
+ * Create record of input length with a mix of frequencies
+ * @param[in] size Length of record
+ * @return Record values
+ */
+std::vector<double> test_record(std::size_t size) {
+  std::vector<double> record(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    record[i] = std::sin(0.01 * i) + 0.3 * std::cos(0.37 * i);
+  }
+  return record;
+}
+
+void BM_Fft(benchmark::State& state) {
+  std::size_t size = state.range(0);
+  auto record = test_record(size);
+  std::vector<std::complex<double>> transform;
+
+  for (auto _ : state) {
+    numeric_utils::fft(record, transform);
+    benchmark::DoNotOptimize(transform.data());
+  }
+
+  state.counters["size"] = static_cast<double>(size);
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+void BM_InverseFft(benchmark::State& state) {
+  std::size_t size = state.range(0);
+  std::vector<std::complex<double>> transform;
+  numeric_utils::fft(test_record(size), transform);
+  std::vector<double> record;
+
+  for (auto _ : state) {
+    numeric_utils::inverse_fft(transform, record);
+    benchmark::DoNotOptimize(record.data());
+  }
+
+  state.counters["size"] = static_cast<double>(size);
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+void BM_Convolve1d(benchmark::State& state) {
+  std::size_t size = state.range(0), kernel_size = state.range(1);
+  auto record = test_record(size);
+  auto kernel = test_record(kernel_size);
+  std::vector<double> response;
+
+  for (auto _ : state) {
+    numeric_utils::convolve_1d(record, kernel, response);
+    benchmark::DoNotOptimize(response.data());
+  }
+
+  state.counters["size"] = static_cast<double>(size);
+  state.counters["kernel_size"] = static_cast<double>(kernel_size);
+}
+
+void BM_NormalMultiVarGenerate(benchmark::State& state) {
+  unsigned int num_vars = state.range(0);
+  unsigned int num_cases = state.range(1);
+  // Covariance of equally correlated variables with increasing variance
+  Eigen::VectorXd means = Eigen::VectorXd::LinSpaced(num_vars, 0.0, 1.0);
+  Eigen::MatrixXd cov = Eigen::MatrixXd::Constant(num_vars, num_vars, 0.3);
+  cov.diagonal() = Eigen::VectorXd::LinSpaced(num_vars, 1.0, 2.0);
+  numeric_utils::NormalMultiVar generator(100);
+  Eigen::MatrixXd random_numbers;
+
+  for (auto _ : state) {
+    generator.generate(random_numbers, means, cov, num_cases);
+    benchmark::DoNotOptimize(random_numbers.data());
+  }
+
+  state.counters["num_vars"] = num_vars;
+  state.counters["num_cases"] = num_cases;
+  state.SetItemsProcessed(state.iterations() * num_cases);
+}
+
+void BM_NelderMeadMinimize(benchmark::State& state) {
+  unsigned int num_dimensions = state.range(0);
+  // Rosenbrock function, whose curved valley takes many iterations to follow
+  std::function<double(const std::vector<double>&)> rosenbrock =
+      [](const std::vector<double>& point) {
+        double value = 0.0;
+        for (std::size_t i = 0; i + 1 < point.size(); ++i) {
+          value += 100.0 * std::pow(point[i + 1] - point[i] * point[i], 2) +
+                   std::pow(1.0 - point[i], 2);
+        }
+        return value;
+      };
+  std::vector<double> initial_point(num_dimensions, -1.0);
+
+  for (auto _ : state) {
+    optimization::NelderMead optimizer(1.0e-8);
+    auto minimum = optimizer.minimize(initial_point, 0.5, rosenbrock);
+    benchmark::DoNotOptimize(minimum.data());
+  }
+
+  state.counters["num_dimensions"] = num_dimensions;
+}
+
+/**
+ * Register benchmark of the buffer inverse CDF of a distribution
+ * @param[in] label Name of distribution with its parameters
+ * @param[in] distribution Distribution to evaluate
+ */
+void register_inverse_cdf(
+    const std::string& label,
+    std::shared_ptr<stochastic::Distribution> distribution) {
+  benchmark::RegisterBenchmark(
+      ("BM_InverseCdf/" + label).c_str(),
+      [distribution](benchmark::State& state) {
+        std::size_t num_values = state.range(0);
+        std::vector<double> probabilities(num_values), evaluations(num_values);
+        for (std::size_t i = 0; i < num_values; ++i) {
+          probabilities[i] = (i + 0.5) / num_values;
+        }
+
+        for (auto _ : state) {
+          distribution->inv_cumulative_dist_func(
+              probabilities.data(), evaluations.data(), num_values);
+          benchmark::DoNotOptimize(evaluations.data());
+        }
+
+        state.counters["num_values"] = static_cast<double>(num_values);
+        state.SetItemsProcessed(state.iterations() * num_values);
+      })
+      ->ArgName("num_values")
+      ->Arg(10000);
+}
+
+/**
+ * Register benchmark of a full generate of a stochastic model. The model is
+ * created once and generates new records each iteration.
+ * @param[in] label Key of model in factory with its parameters
+ * @param[in] parameters Scenario parameters reported as counters
+ * @param[in] model Stochastic model to generate records of
+ */
+void register_model(
+    const std::string& label,
+    const std::vector<std::pair<std::string, double>>& parameters,
+    std::shared_ptr<stochastic::StochasticModel> model) {
+  benchmark::RegisterBenchmark(
+      ("BM_Generate/" + label).c_str(),
+      [parameters, model](benchmark::State& state) {
+        std::vector<stochastic::RecordMetadata> metadata;
+        std::size_t num_steps = 0;
+
+        for (auto _ : state) {
+          auto records = model->generate("Benchmark", metadata);
+          num_steps = records.num_records() > 0 ? records.num_steps(0) : 0;
+          benchmark::DoNotOptimize(records.data(0, 0));
+        }
+
+        for (const auto& parameter : parameters) {
+          state.counters[parameter.first] = parameter.second;
+        }
+        state.counters["num_records"] =
+            static_cast<double>(model->num_records());
+        state.counters["num_steps"] = static_cast<double>(num_steps);
+        state.SetItemsProcessed(state.iterations() * model->num_records());
+      })
+      ->Unit(benchmark::kMillisecond);
+}
+}  // namespace
+
+BENCHMARK(BM_Fft)
+    ->ArgName("size")
+    ->Arg(1024)
+    ->Arg(4096)
+    ->Arg(16384)
+    ->Arg(65536)
+    ->Arg(12000)
+    ->Arg(10007);
+BENCHMARK(BM_InverseFft)
+    ->ArgName("size")
+    ->Arg(1024)
+    ->Arg(4096)
+    ->Arg(16384)
+    ->Arg(65536)
+    ->Arg(12000)
+    ->Arg(10007);
+BENCHMARK(BM_Convolve1d)
+    ->ArgNames({"size", "kernel_size"})
+    ->Args({1000, 100})
+    ->Args({10000, 1000})
+    ->Args({100000, 1000});
+BENCHMARK(BM_NormalMultiVarGenerate)
+    ->ArgNames({"num_vars", "num_cases"})
+    ->Args({7, 100})
+    ->Args({19, 100})
+    ->Args({19, 10000});
+BENCHMARK(BM_NelderMeadMinimize)
+    ->ArgName("num_dimensions")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(7);
+
+int main(int argc, char** argv) {
+  config::initialize();
+
+  // Inverse CDFs of each registered distribution
+  using TwoParameters = Factory<stochastic::Distribution, double, double>;
+  using ThreeParameters =
+      Factory<stochastic::Distribution, double, double, double>;
+  using FourParameters =
+      Factory<stochastic::Distribution, double, double, double, double>;
+  register_inverse_cdf("NormalDist",
+                       TwoParameters::instance()->create("NormalDist", 0.0,
+                                                         1.0));
+  register_inverse_cdf("LognormalDist",
+                       TwoParameters::instance()->create("LognormalDist", 0.3,
+                                                         0.5));
+  register_inverse_cdf(
+      "InverseGaussianDist",
+      TwoParameters::instance()->create("InverseGaussianDist", 1.0, 0.5));
+  register_inverse_cdf("BetaDist",
+                       TwoParameters::instance()->create("BetaDist", 2.0, 5.0));
+  register_inverse_cdf(
+      "StudentstDist",
+      ThreeParameters::instance()->create("StudentstDist", 1.0, 2.0, 5.0));
+  register_inverse_cdf("UniformDist",
+                       TwoParameters::instance()->create("UniformDist", -1.0,
+                                                         4.0));
+  register_inverse_cdf(
+      "TabulatedBetaDist",
+      ThreeParameters::instance()->create("TabulatedBetaDist", 2.0, 5.0,
+                                          1.0e-7));
+  register_inverse_cdf(
+      "TabulatedInverseGaussianDist",
+      ThreeParameters::instance()->create("TabulatedInverseGaussianDist", 1.0,
+                                          0.5, 1.0e-7));
+  register_inverse_cdf(
+      "TabulatedStudentstDist",
+      FourParameters::instance()->create("TabulatedStudentstDist", 1.0, 2.0,
+                                         5.0, 1.0e-7));
+
+  // Full generate of each registered stochastic model
+  register_model(
+      "VlachosSiteSpecificEQ/num_spectra:1/num_sims:100",
+      {{"moment_magnitude", 6.5},
+       {"rupture_distance", 30.0},
+       {"vs30", 500.0},
+       {"num_spectra", 1},
+       {"num_sims", 100}},
+      Factory<stochastic::StochasticModel, double, double, double, double,
+              unsigned int, unsigned int, int>::instance()
+          ->create("VlachosSiteSpecificEQ", 6.5, 30.0, 500.0, 0.0, 1u, 100u,
+                   100));
+  register_model(
+      "DabaghiDerKiureghianNFGM/num_sims:10/num_realizations:10",
+      {{"moment_magnitude", 6.5},
+       {"rupture_distance", 10.0},
+       {"vs30", 760.0},
+       {"num_sims", 10},
+       {"num_realizations", 10}},
+      Factory<stochastic::StochasticModel, stochastic::FaultType,
+              stochastic::SimulationType, double, double, double, double,
+              double, double, unsigned int, unsigned int, bool,
+              int>::instance()
+          ->create("DabaghiDerKiureghianNFGM", stochastic::FaultType::StrikeSlip,
+                   stochastic::SimulationType::PulseAndNoPulse, 6.5, 0.0, 10.0,
+                   760.0, 26.0, 0.0, 10u, 10u, true, 100));
+  register_model(
+      "WittigSinhaDiscreteFreqWind/num_floors:20/total_time:600",
+      {{"gust_speed", 30.0},
+       {"height", 60.0},
+       {"num_floors", 20},
+       {"total_time", 600.0}},
+      Factory<stochastic::StochasticModel, std::string, double, double,
+              unsigned int, double, int>::instance()
+          ->create("WittigSinhaDiscreteFreqWind", std::string("B"), 30.0, 60.0,
+                   20u, 600.0, 100));
+
+  benchmark::AddCustomContext("library", "smelt");
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
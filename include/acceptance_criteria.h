@@ -0,0 +1,151 @@
+#ifndef _ACCEPTANCE_CRITERIA_H_
+#define _ACCEPTANCE_CRITERIA_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <Eigen/Dense>
+#include "response_spectrum.h"
+
+namespace stochastic {
+
+/**
+ * Intensity measures of one component of a generated time history
+ */
+struct IntensityMeasures {
+  double peak_acceleration; /**< Peak absolute acceleration */
+  double arias_intensity; /**< Arias intensity */
+  double significant_duration; /**< Time between 5% and 95% of Arias
+                                  intensity */
+  Eigen::MatrixXd response_spectrum; /**< Pseudo-spectral accelerations, with
+                                        rows for damping ratios and columns
+                                        for periods. Empty unless a response
+                                        spectrum calculation is set. */
+};
+
+/**
+ * Acceptance criteria used to screen time histories as they are generated.
+ * Each criterion is a predicate on the intensity measures of all components
+ * of a record, passed in the order in which components are output. Records
+ * are accepted only if they satisfy every criterion. Intensity measures are
+ * calculated in the units of the output time histories.
+ */
+class AcceptanceCriteria {
+ public:
+  /**
+   * Predicate on intensity measures of the components of a record
+   */
+  using Criterion = std::function<bool(const std::vector<IntensityMeasures>&)>;
+
+  /**
+   * @constructor Construct acceptance criteria without any criteria
+   * @param[in] max_attempts Maximum number of candidate records to generate
+   *                         for each accepted record before generation fails.
+   *                         Defaults to 1000.
+   */
+  AcceptanceCriteria(unsigned int max_attempts = 1000);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~AcceptanceCriteria(){};
+
+  /**
+   * Add criterion that records must satisfy
+   * @param[in] criterion Predicate returning true for acceptable records. It
+   *                      is called concurrently from multiple threads when
+   *                      generating with more than one thread.
+   */
+  void add_criterion(Criterion criterion);
+
+  /**
+   * Set response spectrum calculation used for intensity measures. Its time
+   * step must match the time step of the screened records.
+   * @param[in] response_spectrum Response spectrum calculation to use
+   */
+  void set_response_spectrum(
+      std::shared_ptr<const numeric_utils::ResponseSpectrum> response_spectrum);
+
+  /**
+   * Get the maximum number of candidate records per accepted record
+   * @return Maximum number of attempts
+   */
+  unsigned int max_attempts() const { return max_attempts_; };
+
+  /**
+   * Calculate intensity measures of a time history component
+   * @param[in] acceleration Acceleration time history
+   * @param[in] time_step Time step of time history
+   * @return Intensity measures of time history
+   */
+  IntensityMeasures intensity_measures(const std::vector<double>& acceleration,
+                                       double time_step) const;
+
+  /**
+   * Calculate intensity measures of a time history component stored in
+   * contiguous memory
+   * @param[in] acceleration Pointer to acceleration time history
+   * @param[in] num_steps Number of time steps
+   * @param[in] time_step Time step of time history
+   * @return Intensity measures of time history
+   */
+  IntensityMeasures intensity_measures(const double* acceleration,
+                                       std::size_t num_steps,
+                                       double time_step) const;
+
+  /**
+   * Check whether a record satisfies all criteria
+   * @param[in] components Acceleration time histories of record components
+   * @param[in] time_step Time step of time histories
+   * @return True if record is accepted, false otherwise
+   */
+  bool accept(const std::vector<std::vector<double>>& components,
+              double time_step) const;
+
+  /**
+   * Check whether a record stored as a matrix satisfies all criteria
+   * @param[in] components Acceleration time histories of record components,
+   *                       with one column per component
+   * @param[in] time_step Time step of time histories
+   * @return True if record is accepted, false otherwise
+   */
+  bool accept(const Eigen::Ref<const Eigen::MatrixXd>& components,
+              double time_step) const;
+
+  /**
+   * Create criterion requiring the largest peak acceleration of the
+   * components to be within a range
+   * @param[in] min_value Minimum peak acceleration
+   * @param[in] max_value Maximum peak acceleration
+   * @return Criterion checking peak acceleration
+   */
+  static Criterion peak_acceleration_between(double min_value,
+                                             double max_value);
+
+  /**
+   * Create criterion requiring the significant duration of the component
+   * with the largest Arias intensity to be within a range
+   * @param[in] min_value Minimum significant duration
+   * @param[in] max_value Maximum significant duration
+   * @return Criterion checking significant duration
+   */
+  static Criterion significant_duration_between(double min_value,
+                                                double max_value);
+
+ private:
+  /**
+   * Check whether intensity measures of a record satisfy all criteria
+   * @param[in] measures Intensity measures of each record component
+   * @return True if all criteria are satisfied, false otherwise
+   */
+  bool satisfied(const std::vector<IntensityMeasures>& measures) const;
+
+  unsigned int max_attempts_; /**< Maximum candidates per accepted record */
+  std::vector<Criterion> criteria_; /**< Criteria records must satisfy */
+  std::shared_ptr<const numeric_utils::ResponseSpectrum>
+      response_spectrum_; /**< Response spectrum calculation, if any */
+};
+}  // namespace stochastic
+
+#endif  // _ACCEPTANCE_CRITERIA_H_
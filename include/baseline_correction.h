@@ -0,0 +1,91 @@
+#ifndef _BASELINE_CORRECTION_H_
+#define _BASELINE_CORRECTION_H_
+
+#include <memory>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace numeric_utils {
+
+/**
+ * Baseline correction of acceleration time histories by fitting a polynomial
+ * with zero constant and linear terms to the displacement time history and
+ * subtracting its second derivative from the acceleration. The least-squares
+ * projection depends only on the number of time steps, the time step and the
+ * polynomial degree, so it is computed once on construction and reused for
+ * every time history corrected.
+ */
+class BaselineCorrection {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  BaselineCorrection() = delete;
+
+  /**
+   * @constructor Construct least-squares projection for time histories
+   * @param[in] num_steps Number of time steps in time histories
+   * @param[in] time_step Time step of time histories
+   * @param[in] degree Degree of polynomial fit to displacement. Must be at
+   *                   least 2.
+   */
+  BaselineCorrection(unsigned int num_steps, double time_step,
+                     unsigned int degree);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~BaselineCorrection(){};
+
+  /**
+   * Get baseline correction for input dimensions from a cache shared across
+   * threads, constructing it if it has not been used recently. The cache keeps
+   * the most recently used dimensions, so it only saves work when time
+   * histories of the same length are corrected repeatedly; records whose
+   * lengths all differ pay for construction each time and should instead
+   * correct equal-length histories together with the batch correct
+   * @param[in] num_steps Number of time steps in time histories
+   * @param[in] time_step Time step of time histories
+   * @param[in] degree Degree of polynomial fit to displacement
+   * @return Shared pointer to baseline correction
+   */
+  static std::shared_ptr<const BaselineCorrection> cached(
+      unsigned int num_steps, double time_step, unsigned int degree);
+
+  /**
+   * Baseline correct input acceleration time history in place
+   * @param[in, out] acceleration Acceleration time history to correct
+   * @param[in] gfactor Factor that converts acceleration to units of
+   *                    displacement per time squared
+   */
+  void correct(std::vector<double>& acceleration, double gfactor) const;
+
+  /**
+   * Baseline correct several acceleration time histories in place using
+   * matrix-matrix products
+   * @param[in, out] accelerations Acceleration time histories to correct,
+   *                               with one time history per column
+   * @param[in] gfactor Factor that converts acceleration to units of
+   *                    displacement per time squared
+   */
+  void correct(Eigen::Ref<Eigen::MatrixXd> accelerations,
+               double gfactor) const;
+
+  /**
+   * Get the number of time steps this baseline correction applies to
+   * @return Number of time steps
+   */
+  unsigned int num_steps() const { return num_steps_; };
+
+ private:
+  unsigned int num_steps_; /**< Number of time steps */
+  double time_step_; /**< Time step */
+  unsigned int degree_; /**< Degree of polynomial fit */
+  Eigen::MatrixXd projection_; /**< Maps displacement to coefficients of
+                                  polynomial fit */
+  Eigen::MatrixXd correction_basis_; /**< Second derivatives of polynomial
+                                        terms at each time step */
+};
+}  // namespace numeric_utils
+
+#endif  // _BASELINE_CORRECTION_H_
@@ -0,0 +1,114 @@
+#ifndef _BINARY_FILE_WRITER_H_
+#define _BINARY_FILE_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "json_object.h"
+#include "time_history_block.h"
+
+namespace utilities {
+
+/**
+ * Class for writing time histories to a binary file that can be memory
+ * mapped by consumers. Files consist of
+ *   - a fixed 64 byte header holding, in order, the magic string "SMELTBIN",
+ *     the format version (uint32), the byte order mark 0x01020304 (uint32),
+ *     the array alignment in bytes (uint64), the size of the JSON header in
+ *     bytes (uint64), the offset of the data section from the start of the
+ *     file (uint64) and the size of the data section in bytes (uint64),
+ *     followed by zero padding,
+ *   - a compact JSON header with the event metadata,
+ *   - zero padding up to the data section, which starts at a multiple of
+ *     the alignment, and
+ *   - the data section with the float64 arrays in native byte order, each
+ *     starting at a multiple of the alignment.
+ * Arrays are referenced in the JSON header by their offset in bytes from
+ * the start of the data section. Events can be appended to existing files,
+ * whose headers hold the events in their "Events" array.
+ */
+class BinaryFileWriter {
+ public:
+  /**
+   * @constructor Construct writer without any arrays
+   */
+  BinaryFileWriter();
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~BinaryFileWriter(){};
+
+  /**
+   * Add array to data section. The values are not copied, so they must
+   * remain valid until the file is written.
+   * @param[in] values Pointer to values of array
+   * @param[in] num_values Number of values in array
+   * @return Offset of array in bytes from start of data section
+   */
+  std::size_t add_array(const double* values, std::size_t num_values);
+
+  /**
+   * Add each component of each record in block to data section. The values
+   * are not copied, so the block must remain valid until the file is
+   * written.
+   * @param[in] records Block of records to add
+   * @return Offsets of arrays in bytes from start of data section, ordered
+   *         by record and then by component
+   */
+  std::vector<std::size_t> add_records(const TimeHistoryBlock& records);
+
+  /**
+   * Append to an existing file written by this class. Arrays added
+   * afterwards follow the data section of the existing file, so their
+   * offsets refer to the combined data section, and write appends the
+   * elements of the "Events" array of its header to the "Events" array of
+   * the existing header. Must be called before any arrays are added. Throws
+   * exception if arrays have already been added or the file can not be
+   * read or was not written by this class.
+   * @param[in] existing_location Location of existing file
+   */
+  void append_to(const std::string& existing_location);
+
+  /**
+   * Write file with input JSON header followed by all arrays added so far.
+   * When appending, the data section of the existing file is copied in
+   * chunks of bounded size to a temporary file next to the output location,
+   * which then replaces it, so both may be the same location. Appending
+   * therefore needs I/O, but not memory, proportional to the existing file.
+   * An existing file at the output location is kept until the new file has
+   * replaced it. If it can not be replaced, the new file is left at the
+   * temporary location ending in ".append". Throws exception if errors are
+   * encountered when reading the existing file or writing the file.
+   * @param[in] output_location Location to write file to
+   * @param[in] header JSON header with metadata of arrays
+   * @return Returns true if successful, false otherwise
+   */
+  bool write(const std::string& output_location,
+             const JsonObject& header) const;
+
+  /**
+   * Get the size of the data section for the arrays added so far
+   * @return Size of data section in bytes
+   */
+  std::size_t data_size() const { return data_size_; };
+
+  static const char magic[8]; /**< Magic string at start of file */
+  static const std::uint32_t version = 1; /**< File format version */
+  static const std::uint32_t byte_order_mark = 0x01020304; /**< Byte order */
+  static const std::size_t alignment = 64; /**< Alignment of arrays */
+  static const std::size_t fixed_header_size = 64; /**< Fixed header size */
+
+ private:
+  std::vector<const double*> arrays_; /**< Pointers to values of arrays */
+  std::vector<std::size_t> sizes_; /**< Number of values in arrays */
+  std::vector<std::size_t> offsets_; /**< Offsets of arrays in data section */
+  std::size_t data_size_; /**< Size of data section in bytes */
+  std::string existing_location_; /**< Location of existing file appended
+                                     to, empty unless appending */
+  std::size_t existing_size_; /**< Size of data section of existing file */
+};
+}  // namespace utilities
+
+#endif  // _BINARY_FILE_WRITER_H_
@@ -12,6 +12,26 @@ namespace config {
  */
 void initialize();
 
+/**
+ * Set whether models create their beta, inverse Gaussian and Student's t
+ * marginal distributions with the tabulated inverse CDF keys
+ * ("TabulatedBetaDist", "TabulatedInverseGaussianDist" and
+ * "TabulatedStudentstDist") instead of the exact distribution keys. The
+ * factory registrations themselves are never changed, so this is safe to call
+ * while other threads create distributions. Tables use the default maximum
+ * error of stochastic::TabulatedDistribution. Models create their marginal
+ * distributions when constructed, so the setting applies to models
+ * constructed after it is changed. Defaults to false.
+ * @param[in] tabulated Indicates that tabulated distributions are used
+ */
+void set_tabulated_distributions(bool tabulated);
+
+/**
+ * Check whether models use marginal distributions with tabulated inverse CDFs
+ * @return True if tabulated distributions are used, false otherwise
+ */
+bool tabulated_distributions();
+
 }  // namespace config
 
 #endif  // _CONFIGURE_H_
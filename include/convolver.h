@@ -0,0 +1,130 @@
+#ifndef _CONVOLVER_H_
+#define _CONVOLVER_H_
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace numeric_utils {
+
+/**
+ * Full 1-dimensional convolution of input records with a fixed kernel. The
+ * convolution is computed either directly or through FFTs, with the mode
+ * picked from an operation count for each record length unless fixed on
+ * construction. Kernel transforms are computed once for each FFT length and
+ * reused, so a convolver is meant to be constructed once for a kernel and
+ * shared. Convolutions can be computed concurrently from multiple threads.
+ */
+class Convolver {
+ public:
+  /**
+   * Method used to compute convolutions
+   */
+  enum class Mode {
+    Auto,   /**< Pick direct or FFT method from record length */
+    Direct, /**< Sum of shifted and scaled records */
+    FFT     /**< Product of zero-padded transforms */
+  };
+
+  /**
+   * @constructor Delete default constructor
+   */
+  Convolver() = delete;
+
+  /**
+   * @constructor Construct convolver for input kernel
+   * @param[in] kernel Kernel to convolve records with. Must not be empty.
+   * @param[in] mode Method used to compute convolutions. Defaults to picking
+   *                 method from record length.
+   * @param[in] smooth_lengths Indicates that FFTs are padded to the nearest
+   *                           length whose only prime factors are 2, 3 and 5
+   *                           instead of the next power of two. Defaults to
+   *                           false.
+   */
+  Convolver(const std::vector<double>& kernel, Mode mode = Mode::Auto,
+            bool smooth_lengths = false);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~Convolver(){};
+
+  /**
+   * Delete copy constructor
+   */
+  Convolver(const Convolver&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  Convolver& operator=(const Convolver&) = delete;
+
+  /**
+   * Convolve input record with kernel
+   * @param[in] input Pointer to input record
+   * @param[in] size Length of input record
+   * @param[out] output Pointer to buffer for size + kernel size - 1 output
+   *                    values. Must not overlap input.
+   */
+  void convolve(const double* input, std::size_t size, double* output) const;
+
+  /**
+   * Convolve input record with kernel
+   * @param[in] input Input record
+   * @param[in, out] output Vector to write size + kernel size - 1 output
+   *                        values to
+   */
+  void convolve(const std::vector<double>& input,
+                std::vector<double>& output) const;
+
+  /**
+   * Convolve several records of equal length with kernel. In FFT mode, the
+   * records are transformed as one batch.
+   * @param[in] inputs Matrix of input records, with one record per column
+   * @param[in, out] outputs Matrix to write convolved records to, with
+   *                         rows + kernel size - 1 rows
+   */
+  void convolve(const Eigen::MatrixXd& inputs, Eigen::MatrixXd& outputs) const;
+
+  /**
+   * Get method used to convolve records of input length
+   * @param[in] size Length of input records
+   * @return Direct or FFT mode
+   */
+  Mode mode(std::size_t size) const;
+
+  /**
+   * Get length of FFTs used to convolve records of input length
+   * @param[in] size Length of input records
+   * @return Length of FFTs
+   */
+  std::size_t fft_length(std::size_t size) const;
+
+  /**
+   * Get length of kernel
+   * @return Number of kernel samples
+   */
+  std::size_t kernel_size() const { return kernel_.size(); };
+
+ private:
+  /**
+   * Get non-redundant half of kernel transform for input FFT length,
+   * computing it if this length has not been used before
+   * @param[in] length Length of FFT
+   * @return Reference to kernel transform
+   */
+  const Eigen::VectorXcd& kernel_transform(std::size_t length) const;
+
+  Eigen::VectorXd kernel_; /**< Kernel records are convolved with */
+  Mode mode_; /**< Method used to compute convolutions */
+  bool smooth_lengths_; /**< Indicates that FFT lengths have only factors 2, 3
+                           and 5 rather than only factor 2 */
+  mutable std::mutex transforms_mutex_; /**< Lock for kernel transforms */
+  mutable std::map<std::size_t, Eigen::VectorXcd>
+      kernel_transforms_; /**< Kernel transforms for each FFT length */
+};
+}  // namespace numeric_utils
+
+#endif  // _CONVOLVER_H_
@@ -1,6 +1,8 @@
 #ifndef _DABAGHI_DER_KIUREGHIAN_H_
 #define _DABAGHI_DER_KIUREGHIAN_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -10,6 +12,7 @@
 #include "json_object.h"
 #include "numeric_utils.h"
 #include "stochastic_model.h"
+#include "time_history_block.h"
 
 namespace stochastic {
 /** @enum stochastic::FaultType
@@ -119,6 +122,19 @@ class DabaghiDerKiureghian : public StochasticModel {
    */
   DabaghiDerKiureghian& operator=(const DabaghiDerKiureghian&) = delete;
 
+  /**
+   * Generate ground motion time histories based on input parameters into
+   * contiguous storage. Throws exception if errors are encountered during
+   * time history generation.
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return Block with one record per event, with pulse-like records first,
+   *         each ordered by parameter set and then by realization, and with
+   *         both components of acceleration
+   */
+  utilities::TimeHistoryBlock generate_records(bool units = false);
+
   /**
    * Generate ground motion time histories based on input parameters
    * and store outputs as JSON object. Throws exception if errors
@@ -132,6 +148,65 @@ class DabaghiDerKiureghian : public StochasticModel {
   utilities::JsonObject generate(const std::string& event_name,
                                  bool units = false) override;
 
+  /**
+   * Generate ground motion time histories based on input parameters into
+   * contiguous storage, without creating any JSON. Throws exception if errors
+   * are encountered during time history generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in, out] metadata Vector to write metadata of each record to
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return Block with one record per event, in the order of the events
+   *         returned as JSON, with x- and y-components of acceleration
+   */
+  utilities::TimeHistoryBlock generate(const std::string& event_name,
+                                       std::vector<RecordMetadata>& metadata,
+                                       bool units = false) override;
+
+  /**
+   * Get the number of records generated by each call to generate
+   * @return Number of records, which is the number of pulse-like and
+   *         no-pulse parameter sets times the number of realizations
+   */
+  std::size_t num_records() const override;
+
+  /**
+   * Create iterator that generates ground motion time histories on demand.
+   * Model parameters are simulated and modulating function parameters are
+   * back-calculated for all parameter sets when the iterator is created.
+   * Throws exception if errors are encountered during time history
+   * generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @param[in] batch_size Maximum number of records per batch. Defaults to
+   *                       0, which generates one record per thread in each
+   *                       batch.
+   * @return Iterator over records in the order of the events returned as
+   *         JSON, with x- and y-components of acceleration
+   */
+  RecordIterator records(const std::string& event_name, bool units = false,
+                         std::size_t batch_size = 0) override;
+
+  /**
+   * Create JSON objects for events of a block of records. Events are created
+   * concurrently using the number of threads of the model.
+   * @param[in] event_name Name to assign to events
+   * @param[in] records Block of records
+   * @param[in] first_record Index of first record in block among all records
+   * @param[in] data_offsets Offsets of components of records in data section
+   *                         of binary file, ordered by record and then by
+   *                         component. If given, time series reference their
+   *                         values by offset. Defaults to null.
+   * @return Vector of JsonObjects containing events
+   */
+  std::vector<utilities::JsonObject> events_json(
+      const std::string& event_name, const utilities::TimeHistoryBlock& records,
+      std::size_t first_record,
+      const std::vector<std::size_t>* data_offsets = nullptr) const override;
+
   /**
    * Generate ground motion time histories based on input parameters
    * and write results to file in JSON format. Throws exception if
@@ -147,6 +222,45 @@ class DabaghiDerKiureghian : public StochasticModel {
                 const std::string& output_location,
                 bool units = false) override;
 
+  /**
+   * Create iterator over realizations appended to each parameter set of the
+   * last call to generate or records, reusing its simulated model
+   * parameters and random streams. Throws exception if no records have been
+   * generated yet, acceptance criteria are set or errors are encountered
+   * during time history generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in] num_sims Number of realizations to append per parameter set
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @param[in] batch_size Maximum number of records per batch. Defaults to
+   *                       0, which generates one record per thread in each
+   *                       batch.
+   * @return Iterator over appended records, in the order of the events of a
+   *         single call with the larger number of realizations
+   */
+  RecordIterator append_records(const std::string& event_name,
+                                unsigned int num_sims, bool units = false,
+                                std::size_t batch_size = 0) override;
+
+  /**
+   * Append realizations to each parameter set of the last call to generate
+   * or records and add their events to the file written by that call.
+   * Throws exception if no records have been generated yet, acceptance
+   * criteria are set or errors are encountered during time history
+   * generation or when writing.
+   * @param[in] event_name Name to assign to event
+   * @param[in] output_location Location of file to append events to
+   * @param[in] num_sims Number of realizations to append per parameter set
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return Returns true if successful, false otherwise
+   */
+  bool append(const std::string& event_name,
+              const std::string& output_location, unsigned int num_sims,
+              bool units = false) override;
+
   /**
    * Generates proportion of motions that should be pulse-like based on total
    * number of simulations and probability of those motions containing a pulse
@@ -210,21 +324,57 @@ class DabaghiDerKiureghian : public StochasticModel {
    *                             in direction 2. Outputs are written here.
    * @param[in] num_gms Number of ground motions that should be generated.
    *                    Defaults to 1.
+   * @param[in] spectrum_index Index of parameter set used to select random
+   *                           streams. Defaults to 0.
    */
   void simulate_near_fault_ground_motion(
       bool pulse_like, const Eigen::VectorXd& parameters,
       std::vector<std::vector<double>>& accel_comp_1,
       std::vector<std::vector<double>>& accel_comp_2,
-      unsigned int num_gms = 1) const;
+      unsigned int num_gms = 1, unsigned int spectrum_index = 0) const;
+
+  /**
+   * Simulate near-fault ground motion given model parameters, previously
+   * back-calculated modulating function parameters and whether motion is
+   * pulse-like or not.
+   * @param[in] pulse_like Boolean indicating whether ground motions are
+   *                       pulse-like
+   * @param[in] parameters Vector of model parameters to use for ground motion
+   *                       simulation
+   * @param[in] modulating_params_1 Modulating function parameters for
+   *                                direction 1
+   * @param[in] modulating_params_2 Modulating function parameters for
+   *                                direction 2
+   * @param[in,out] accel_comp_1 Simulated near-fault ground motion components
+   *                             in direction 1. Outputs are written here.
+   * @param[in,out] accel_comp_2 Simulated near-fault ground motion components
+   *                             in direction 2. Outputs are written here.
+   * @param[in] num_gms Number of ground motions that should be generated.
+   *                    Defaults to 1.
+   * @param[in] spectrum_index Index of parameter set used to select random
+   *                           streams. Defaults to 0.
+   * @param[in] first_gm Index of first ground motion used to select random
+   *                     streams. Defaults to 0.
+   */
+  void simulate_near_fault_ground_motion(
+      bool pulse_like, const Eigen::VectorXd& parameters,
+      const Eigen::VectorXd& modulating_params_1,
+      const Eigen::VectorXd& modulating_params_2,
+      std::vector<std::vector<double>>& accel_comp_1,
+      std::vector<std::vector<double>>& accel_comp_2, unsigned int num_gms = 1,
+      unsigned int spectrum_index = 0, unsigned int first_gm = 0) const;
 
   /**
    * Backcalculate modulating parameters given Arias Intesity and duration parameters
    * @param[in] q_params Vector containing Ia, D595, D05, and D030
    * @param[in] t0 Initial time. Defaults to 0.0.
+   * @param[in] num_threads Number of threads to minimize from starting points
+   *                        with. Defaults to 1.
    * @return Vector containing parameters alpha, beta, tmaxq, and c
    */
   Eigen::VectorXd backcalculate_modulating_params(
-      const Eigen::VectorXd& q_params, double t0 = 0.0) const;
+      const Eigen::VectorXd& q_params, double t0 = 0.0,
+      unsigned int num_threads = 1) const;
 
   /**
    * Simulate modulated filtered white noise process
@@ -233,13 +383,22 @@ class DabaghiDerKiureghian : public StochasticModel {
    * @param[in] num_steps Total number of time steps to be taken
    * @param[in] num_gms Number of ground motions that should be generated.
    *                    Defaults to 1.
+   * @param[in] spectrum_index Index of parameter set used to select random
+   *                           streams. Defaults to 0.
+   * @param[in] component Index of ground motion component used to select
+   *                      random streams. Defaults to 0.
+   * @param[in] first_gm Index of first ground motion used to select random
+   *                     streams. Defaults to 0.
    * @return Vector of vectors containing time history of simulated modulate
    *         filtered white noise
    */
   Eigen::MatrixXd simulate_white_noise(const Eigen::VectorXd& modulating_params,
                                        const Eigen::VectorXd& filter_params,
                                        unsigned int num_steps,
-                                       unsigned int num_gms = 1) const;
+                                       unsigned int num_gms = 1,
+                                       unsigned int spectrum_index = 0,
+                                       unsigned int component = 0,
+                                       unsigned int first_gm = 0) const;
 
   /**
    * This function defines an error measure based on matching times of the 5%,
@@ -283,6 +442,19 @@ class DabaghiDerKiureghian : public StochasticModel {
   double calc_time_to_intensity(const std::vector<double>& acceleration,
                                 double percentage) const;
 
+  /**
+   * Calculate the times at which each of the input percentages of the Arias
+   * intensity is reached, without forming the cumulative intensity
+   * @param[in] acceleration Acceleration time history
+   * @param[in] percentages Pointer to percentages of Arias intensity
+   * @param[in, out] times Pointer to buffer to write times at which each
+   *                       percentage is reached to
+   * @param[in] num_percentages Number of percentages
+   */
+  void calc_times_to_intensity(const std::vector<double>& acceleration,
+                               const double* percentages, double* times,
+                               unsigned int num_percentages) const;
+
   /**
    * Calculate the linearly varying filter function (in rad/sec) given the
    * filter function parameters (in Hz) and the times of 1%, 30%(mid) and 99%
@@ -315,6 +487,45 @@ class DabaghiDerKiureghian : public StochasticModel {
       unsigned int num_steps, const std::vector<double>& input_filter,
       double zeta) const;
 
+  /**
+   * Filter white noise with the time-varying impulse response filter without
+   * forming the dense impulse response matrix. The response to each impulse
+   * is truncated once its exponential envelope drops below the input
+   * tolerance, so memory is linear and work is proportional to the number of
+   * time steps times the length of the filter support. The result matches
+   * multiplying by the output of calc_impulse_response_filter to within the
+   * tolerance.
+   * @param[in] white_noise White noise with one ground motion per row
+   * @param[in] input_filter Input filter coefficients to use in impulse
+   *                         response
+   * @param[in] zeta Filter parameter
+   * @param[in] tolerance Envelope value relative to the peak at which impulse
+   *                      responses are truncated. Defaults to 1.0e-10.
+   * @return Filtered white noise with one ground motion per row
+   */
+  Eigen::MatrixXd filter_white_noise(const Eigen::MatrixXd& white_noise,
+                                     const std::vector<double>& input_filter,
+                                     double zeta,
+                                     double tolerance = 1.0e-10) const;
+
+  /**
+   * Filter white noise in single precision with the time-varying impulse
+   * response filter as in the double precision overload. Impulse responses
+   * are evaluated in double precision and rounded, while the filtered white
+   * noise is accumulated in single precision.
+   * @param[in] white_noise White noise with one ground motion per row
+   * @param[in] input_filter Input filter coefficients to use in impulse
+   *                         response
+   * @param[in] zeta Filter parameter
+   * @param[in] tolerance Envelope value relative to the peak at which impulse
+   *                      responses are truncated. Defaults to 1.0e-10.
+   * @return Filtered white noise with one ground motion per row
+   */
+  Eigen::MatrixXf filter_white_noise(const Eigen::MatrixXf& white_noise,
+                                     const std::vector<double>& input_filter,
+                                     double zeta,
+                                     double tolerance = 1.0e-10) const;
+
   /**
    * Filters input acceleration time history in frequency domain using
    * acausal high-pass Butterworth filter
@@ -327,6 +538,20 @@ class DabaghiDerKiureghian : public StochasticModel {
                                           double freq_corner,
                                           unsigned int filter_order) const;
 
+  /**
+   * Filters input acceleration time histories in place in frequency domain
+   * using acausal high-pass Butterworth filter. Filter coefficients are
+   * computed once for all time histories.
+   * @param[in, out] accel_histories Acceleration time histories to filter,
+   *                                 with one time history per column. Filtered
+   *                                 time histories are written here.
+   * @param[in] freq_corner Corner frequency
+   * @param[in] filter_order Order of filter
+   */
+  void filter_acceleration(Eigen::MatrixXd& accel_histories,
+                           double freq_corner,
+                           unsigned int filter_order) const;
+
   /**
    * Calculate the pulse acceleration based on the modified Mavroeidis and
    * Papageorgiou model
@@ -358,14 +583,18 @@ class DabaghiDerKiureghian : public StochasticModel {
                                double pgd_lim = 0.01) const;
 
   /**
-   * Baseline correct acceleration time histories by fitting a polynomial
-   * starting from the 2nd degree of the displacement time series
-   * @param[in, out] time_history Acceleration time history to truncate
+   * Baseline correct both components of acceleration time histories by
+   * fitting a polynomial starting from the 2nd degree of the displacement time
+   * series. Both components must have the same length and share a single
+   * least-squares projection.
+   * @param[in, out] time_history_1 Acceleration time history for component 1
+   * @param[in, out] time_history_2 Acceleration time history for component 2
    * @param[in] gfactor Factor to convert acceleration to cm/s^2
    * @param[in] order Order of the polynomial fitted to the displacement time
    *                  series
    */
-  void baseline_correct_time_history(std::vector<double>& time_history,
+  void baseline_correct_time_history(std::vector<double>& time_history_1,
+                                     std::vector<double>& time_history_2,
                                      double gfactor, unsigned int order) const;
 
   /**
@@ -395,23 +624,127 @@ class DabaghiDerKiureghian : public StochasticModel {
   int seed_value_; /**< Integer to seed random distributions with */
   double time_step_; /**< Temporal discretization. Set to 0.005 seconds */
   double start_time_ = 0.0; /**< Start time of ground motion */
-  Eigen::VectorXd std_dev_pulse_; /**< Pulse-like parameter standard deviation */
-  Eigen::VectorXd std_dev_nopulse_; /**< No-pulse-like parameter standard deviation */
-  Eigen::MatrixXd corr_matrix_pulse_; /**< Pulse-like parameter correlation matrix */
-  Eigen::MatrixXd corr_matrix_nopulse_; /**< No-pulse-like parameter correlation matrix */
-  Eigen::MatrixXd beta_distribution_pulse_; /**< Beta distrubution parameters for pulse-like motion */
-  Eigen::MatrixXd beta_distribution_nopulse_; /**< Beta distrubution parameters for no-pulse-like motion */
-  Eigen::VectorXd params_lower_bound_;        /**< Lower bound for marginal distributions fitted to params
+  const Eigen::VectorXd& std_dev_pulse_; /**< Pulse-like parameter standard deviation */
+  const Eigen::VectorXd& std_dev_nopulse_; /**< No-pulse-like parameter standard deviation */
+  const Eigen::MatrixXd& corr_matrix_pulse_; /**< Pulse-like parameter correlation matrix */
+  const Eigen::MatrixXd& corr_matrix_nopulse_; /**< No-pulse-like parameter correlation matrix */
+  const Eigen::MatrixXd& cov_matrix_pulse_; /**< Pulse-like parameter covariance matrix */
+  const Eigen::MatrixXd& cov_matrix_nopulse_; /**< No-pulse-like parameter covariance matrix */
+  const Eigen::MatrixXd& beta_distribution_pulse_; /**< Beta distrubution parameters for pulse-like motion */
+  const Eigen::MatrixXd& beta_distribution_nopulse_; /**< Beta distrubution parameters for no-pulse-like motion */
+  const Eigen::VectorXd& params_lower_bound_; /**< Lower bound for marginal distributions fitted to params
 						 (Table 5 in Dabaghi & Der Kiureghian, 2017) */
-  Eigen::VectorXd params_upper_bound_;        /**< Upper bound for marginal distributions fitted to params
+  const Eigen::VectorXd& params_upper_bound_; /**< Upper bound for marginal distributions fitted to params
 						 (Table 5 in Dabaghi & Der Kiureghian, 2017) */
-  Eigen::VectorXd params_fitted1_; /** Fitted distribution parameters from Table 5 (Dabaghi & Der Kiureghian, 2017) */
-  Eigen::VectorXd params_fitted2_; /** Fitted distribution parameters from Table 5 (Dabaghi & Der Kiureghian, 2017) */
-  Eigen::VectorXd params_fitted3_; /** Fitted distribution parameters from Table 5 (Dabaghi & Der Kiureghian, 2017) */  
+  const Eigen::VectorXd& params_fitted1_; /** Fitted distribution parameters from Table 5 (Dabaghi & Der Kiureghian, 2017) */
+  const Eigen::VectorXd& params_fitted2_; /** Fitted distribution parameters from Table 5 (Dabaghi & Der Kiureghian, 2017) */
+  const Eigen::VectorXd& params_fitted3_; /** Fitted distribution parameters from Table 5 (Dabaghi & Der Kiureghian, 2017) */
+  const std::vector<std::shared_ptr<stochastic::Distribution>>&
+      beta_marginals_; /**< Beta distributions of depth to rupture and gamma
+                          residuals, indexed by parameter */
   const double magnitude_baseline_ = 6.5; /**< Baseline regression factor for magnitude */ 
   const double c6_ = 6.0 ; /**< This factor is set to avoid non-linearity in regression */
   std::shared_ptr<numeric_utils::RandomGenerator>
       sample_generator_; /**< Multivariate normal random number generator */
+
+  /**
+   * Model parameters shared by all records generated from a set of
+   * simulated parameters
+   */
+  struct ParameterSets {
+    Eigen::MatrixXd pulse; /**< Pulse-like parameter sets, one per row */
+    Eigen::MatrixXd nopulse; /**< Non-pulse-like parameter sets, one per row */
+    std::vector<Eigen::VectorXd>
+        modulating_params_1; /**< Modulating function parameters of first
+                                component for each parameter set */
+    std::vector<Eigen::VectorXd>
+        modulating_params_2; /**< Modulating function parameters of second
+                                component for each parameter set */
+  };
+
+  /**
+   * Parameter sets and random streams shared by the records of the last call
+   * to records, which appended realizations continue
+   */
+  struct Campaign {
+    std::shared_ptr<const ParameterSets>
+        parameter_sets; /**< Parameter sets, null until records are
+                           generated */
+    std::uint64_t stream_seed = 0; /**< Seed of random streams */
+  };
+
+  Campaign campaign_; /**< Campaign of the last call to records */
+
+  /**
+   * Grow the number of realizations per parameter set of the campaign of the
+   * last call to records and restore its random streams. Throws exception if
+   * no records have been generated yet or acceptance criteria are set.
+   * @param[in] num_sims Number of realizations to append per parameter set
+   * @return Number of realizations per parameter set before appending
+   */
+  unsigned int extend_campaign(unsigned int num_sims);
+
+  /**
+   * Simulate model parameters and back-calculate modulating function
+   * parameters for all parameter sets
+   * @return Parameter sets, with pulse-like sets indexed first
+   */
+  ParameterSets simulate_parameter_sets();
+
+  /**
+   * Generate a range of records for input parameter sets. Throws exception if
+   * errors are encountered during time history generation.
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Otherwise time histories are returned in
+   *                  units of m/s^2
+   * @param[in] parameter_sets Parameter sets of all records
+   * @param[in] first_record Index of first record of range among all records
+   * @param[in] num_records Number of records in range
+   * @return Block of records in range
+   */
+  utilities::TimeHistoryBlock generate_range(
+      bool units, const ParameterSets& parameter_sets,
+      std::size_t first_record, std::size_t num_records);
+
+  /**
+   * Write metadata of a block of records
+   * @param[in] event_name Name assigned to all events
+   * @param[in] records Block of records
+   * @param[in] first_record Index of first record in block among all records
+   * @param[in, out] metadata Vector to write metadata of each record to
+   */
+  void records_metadata(const std::string& event_name,
+                        const utilities::TimeHistoryBlock& records,
+                        std::size_t first_record,
+                        std::vector<RecordMetadata>& metadata) const;
+
+  /**
+   * Generate ground motion time histories in batches of records, passing
+   * each batch to the input function as soon as it has been generated.
+   * Throws exception if errors are encountered during time history
+   * generation.
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Otherwise time histories are returned in
+   *                  units of m/s^2
+   * @param[in] records_per_batch Number of records generated together in
+   *                              each batch
+   * @param[in] process_batch Function called with block of records of each
+   *                          batch and index of first record in batch. The
+   *                          block may be moved from.
+   */
+  void generate_batches(
+      bool units, unsigned int records_per_batch,
+      const std::function<void(utilities::TimeHistoryBlock&, std::size_t)>&
+          process_batch);
+
+  /**
+   * Get name of event for record
+   * @param[in] event_name Name assigned to all events
+   * @param[in] record Index of record among all records
+   * @return Name of event
+   */
+  std::string record_name(const std::string& event_name,
+                          std::size_t record) const;
 };
 }  // namespace stochastic
 
@@ -0,0 +1,126 @@
+#ifndef _DEVICE_BACKEND_H_
+#define _DEVICE_BACKEND_H_
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+
+namespace numeric_utils {
+namespace device {
+
+/**
+ * Check whether batched kernels can run on a GPU. This requires the library
+ * to be built with BUILD_CUDA_BACKEND, which defines SMELT_ENABLE_CUDA, and a
+ * CUDA device to be present at run time.
+ * @return Returns true if a device is available, false otherwise
+ */
+bool available();
+
+/**
+ * Select whether batched kernels run on the GPU when one is available.
+ * Kernels run on the host otherwise. Applies to all models in the process.
+ * Device kernels are opt-in because their results have not yet been checked
+ * against the host kernels on GPU hardware.
+ * @param[in] enabled Indicates that kernels should run on the GPU. Defaults to
+ *                    false.
+ */
+void set_enabled(bool enabled);
+
+/**
+ * Check whether batched kernels run on the GPU
+ * @return Returns true if a device is available and has been enabled
+ */
+bool enabled();
+
+/**
+ * Batch of 1-dimensional Fast Fourier Transforms computed on the GPU with
+ * cuFFT. Backward transforms are scaled by the inverse of the length as the
+ * MKL plans they replace. Records are contiguous. Device buffers are
+ * allocated once per plan and transforms of the same plan are serialized.
+ */
+class BatchFFT {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  BatchFFT() = delete;
+
+  /**
+   * @constructor Construct cuFFT plan and device buffers. Throws exception if
+   * no device is available.
+   * @param[in] size Length of each transform
+   * @param[in] num_transforms Number of transforms in batch
+   * @param[in] real_domain True for transforms between real records and
+   *                        conjugate-even halves, false for complex records
+   * @param[in] forward True for forward transforms, false for backward
+   * @param[in] single_precision True for records of floats, false for doubles
+   */
+  BatchFFT(std::size_t size, std::size_t num_transforms, bool real_domain,
+           bool forward, bool single_precision);
+
+  /**
+   * @destructor Free plan and device buffers
+   */
+  ~BatchFFT();
+
+  /**
+   * Delete copy constructor
+   */
+  BatchFFT(const BatchFFT&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  BatchFFT& operator=(const BatchFFT&) = delete;
+
+  /**
+   * Copy input records to the device, compute transforms and copy outputs
+   * back to the host
+   * @param[in] input Pointer to input records on host
+   * @param[out] output Pointer to buffer for output records on host
+   */
+  void compute(const void* input, void* output) const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_; /**< cuFFT plan and device buffers */
+};
+
+/**
+ * Factor a batch of symmetric positive definite matrices on the GPU and
+ * multiply each lower Cholesky factor by a complex vector. Only the lower
+ * triangles of the matrices are read and the strictly upper triangles must
+ * be zero. Throws exception if no device is available.
+ * @param[in] size Number of rows and columns of each matrix
+ * @param[in] num_matrices Number of matrices in batch
+ * @param[in] matrices Column-major matrices stored one after another
+ * @param[in] vectors Complex vectors of input size stored one after another
+ * @param[out] products Buffer for product of each factor and vector, stored
+ *                      one after another
+ * @return Returns true if all matrices are positive definite, false otherwise
+ */
+bool cholesky_products(std::size_t size, std::size_t num_matrices,
+                       const double* matrices,
+                       const std::complex<double>* vectors,
+                       std::complex<double>* products);
+
+/**
+ * Factor a batch of symmetric positive definite matrices of floats on the GPU
+ * and multiply each lower Cholesky factor by a complex vector, as in the
+ * double precision overload
+ * @param[in] size Number of rows and columns of each matrix
+ * @param[in] num_matrices Number of matrices in batch
+ * @param[in] matrices Column-major matrices stored one after another
+ * @param[in] vectors Complex vectors of input size stored one after another
+ * @param[out] products Buffer for product of each factor and vector, stored
+ *                      one after another
+ * @return Returns true if all matrices are positive definite, false otherwise
+ */
+bool cholesky_products(std::size_t size, std::size_t num_matrices,
+                       const float* matrices,
+                       const std::complex<float>* vectors,
+                       std::complex<float>* products);
+}  // namespace device
+}  // namespace numeric_utils
+
+#endif  // _DEVICE_BACKEND_H_
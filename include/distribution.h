@@ -1,6 +1,7 @@
 #ifndef _DISTRIBUTION_H_
 #define _DISTRIBUTION_H_
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -55,6 +56,47 @@ class Distribution {
    */
   virtual std::vector<double> inv_cumulative_dist_func(
       const std::vector<double>& probabilities) const = 0;
+
+  /**
+   * Compute the cumulative distribution function (CDF) of the distribution at
+   * specified input locations, writing results to caller-owned buffer
+   * @param[in] locations Pointer to locations at which to calculate CDF
+   * @param[in, out] evaluations Pointer to buffer to write evaluated values of
+   *                             CDF to. May be the same as locations.
+   * @param[in] num_values Number of locations
+   */
+  virtual void cumulative_dist_func(const double* locations,
+                                    double* evaluations,
+                                    std::size_t num_values) const;
+
+  /**
+   * Compute the inverse cumulative distribution function (ICDF) of the
+   * distribution at specified input probabilities, writing results to
+   * caller-owned buffer
+   * @param[in] probabilities Pointer to probabilities at which to calculate
+   *                          ICDF
+   * @param[in, out] evaluations Pointer to buffer to write evaluated values of
+   *                             ICDF to. May be the same as probabilities.
+   * @param[in] num_values Number of probabilities
+   */
+  virtual void inv_cumulative_dist_func(const double* probabilities,
+                                        double* evaluations,
+                                        std::size_t num_values) const;
+
+  /**
+   * Transform realizations of a standard normal random variable to this
+   * distribution, which is the ICDF of the standard normal CDF of the inputs.
+   * By default this is evaluated in those two steps, while distributions with
+   * a closed form transformation override it.
+   * @param[in] std_normal_values Pointer to standard normal values to
+   *                              transform
+   * @param[in, out] evaluations Pointer to buffer to write transformed values
+   *                             to. May be the same as std_normal_values.
+   * @param[in] num_values Number of values to transform
+   */
+  virtual void transform_from_std_normal(const double* std_normal_values,
+                                         double* evaluations,
+                                         std::size_t num_values) const;
 };
 }  // namespace stochastic
 
@@ -31,6 +31,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -42,7 +43,53 @@
  */
 template <typename Tbaseclass, typename... Targs>
 class Factory {
+ private:
+  struct CreatorBase;
+
  public:
+  /**
+   * Copyable handle to a creator registered with the factory. Handles are
+   * obtained once through resolve and then create instances without any key
+   * lookup. A handle keeps its creator alive if the key is registered again.
+   */
+  class Handle {
+   public:
+    /**
+     * @constructor Construct empty handle that does not refer to a creator
+     */
+    Handle() = default;
+
+    /**
+     * Create an instance using the creator referred to by handle
+     * @param[in] args Variadic template arguments
+     * @return shared_ptr<Tbaseclass> Shared pointer to a base class
+     */
+    std::shared_ptr<Tbaseclass> create(Targs&&... args) const {
+      if (!creator_)
+        throw std::runtime_error(
+            "Empty factory handle, resolve creator before creating");
+      return creator_->create(std::forward<Targs>(args)...);
+    }
+
+    /**
+     * Check if handle refers to a creator
+     * @return True if handle refers to a creator, false otherwise
+     */
+    explicit operator bool() const { return creator_ != nullptr; }
+
+   private:
+    friend class Factory;
+
+    /**
+     * @constructor Construct handle referring to input creator
+     * @param[in] creator Creator registered with the factory
+     */
+    explicit Handle(std::shared_ptr<CreatorBase> creator)
+        : creator_{std::move(creator)} {};
+
+    std::shared_ptr<CreatorBase> creator_; /**< Registered creator */
+  };
+
   /**
    * Get the single instance of the factory
    */
@@ -68,10 +115,20 @@ class Factory {
    * @return shared_ptr<Tbaseclass> Shared pointer to a base class
    */
   std::shared_ptr<Tbaseclass> create(const std::string& key, Targs&&... args) {
-    if (!this->check(key))
+    return resolve(key).create(std::forward<Targs>(args)...);
+  }
+
+  /**
+   * Look up a registered creator once for repeated creation
+   * @param[in] key Key to item in registry
+   * @return Handle to registered creator
+   */
+  Handle resolve(const std::string& key) const {
+    auto entry = registry.find(key);
+    if (entry == registry.end())
       throw std::runtime_error("Invalid key: " + key +
                                ", not found in the factory register!");
-    return registry.at(key)->create(std::forward<Targs>(args)...);
+    return Handle(entry->second);
   }
 
   /**
@@ -80,10 +137,7 @@ class Factory {
    * @return status Return if key is in registry or not
    */
   bool check(const std::string& key) const {
-    bool status = false;
-    for (const auto& keyvalue : registry)
-      if (keyvalue.first == key) status = true;
-    return status;
+    return registry.find(key) != registry.end();
   }
   
   /**
@@ -0,0 +1,382 @@
+#ifndef _FFT_PLAN_H_
+#define _FFT_PLAN_H_
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <mkl_dfti.h>
+#include "device_backend.h"
+
+namespace numeric_utils {
+
+/**
+ * Committed MKL descriptor for 1-dimensional double precision FFTs of a fixed
+ * length. Creating and committing a descriptor is often more expensive than
+ * the transform itself, so plans are meant to be constructed once and reused.
+ * The backward transform is scaled by the inverse of the length so it
+ * inverts the forward transform. Transforms of real data store the
+ * conjugate-even transform in CCE format, keeping only the size / 2 + 1
+ * non-redundant values. Computing transforms does not modify the plan, so a
+ * plan can be used concurrently from multiple threads.
+ */
+class FFTPlan {
+ public:
+  /**
+   * Domain of the forward transform input
+   */
+  enum class Domain {
+    Real,   /**< Real input, conjugate-even output */
+    Complex /**< Complex input and output */
+  };
+
+  /**
+   * Placement of transform output
+   */
+  enum class Placement {
+    OutOfPlace, /**< Output written to separate buffer */
+    InPlace     /**< Output overwrites input */
+  };
+
+  /**
+   * @constructor Delete default constructor
+   */
+  FFTPlan() = delete;
+
+  /**
+   * @constructor Construct and commit descriptor for transforms of input
+   * length, domain and placement
+   * @param[in] size Length of transforms
+   * @param[in] domain Domain of forward transform input
+   * @param[in] placement Placement of transform output. Defaults to out of
+   *                      place.
+   */
+  FFTPlan(std::size_t size, Domain domain,
+          Placement placement = Placement::OutOfPlace);
+
+  /**
+   * @destructor Free descriptor
+   */
+  virtual ~FFTPlan();
+
+  /**
+   * Delete copy constructor
+   */
+  FFTPlan(const FFTPlan&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  FFTPlan& operator=(const FFTPlan&) = delete;
+
+  /**
+   * Get plan for input length, domain and placement from a cache shared
+   * across threads, constructing it if it has not been used recently
+   * @param[in] size Length of transforms
+   * @param[in] domain Domain of forward transform input
+   * @param[in] placement Placement of transform output. Defaults to out of
+   *                      place.
+   * @return Shared pointer to plan
+   */
+  static std::shared_ptr<const FFTPlan> cached(
+      std::size_t size, Domain domain,
+      Placement placement = Placement::OutOfPlace);
+
+  /**
+   * Compute forward transform of complex input. Plan must have complex
+   * domain and be out of place.
+   * @param[in] input Pointer to size complex input values
+   * @param[out] output Pointer to buffer for size complex output values. Must
+   *                    not overlap input.
+   */
+  void forward(const std::complex<double>* input,
+               std::complex<double>* output) const;
+
+  /**
+   * Compute forward transform of real input. Plan must have real domain and
+   * be out of place.
+   * @param[in] input Pointer to size real input values
+   * @param[out] output Pointer to buffer for size / 2 + 1 complex output
+   *                    values. Must not overlap input.
+   */
+  void forward(const double* input, std::complex<double>* output) const;
+
+  /**
+   * Compute backward transform of complex input. Plan must have complex
+   * domain and be out of place.
+   * @param[in] input Pointer to size complex input values
+   * @param[out] output Pointer to buffer for size complex output values. Must
+   *                    not overlap input.
+   */
+  void backward(const std::complex<double>* input,
+                std::complex<double>* output) const;
+
+  /**
+   * Compute real backward transform of conjugate-even input. Plan must have
+   * real domain and be out of place. Only the first size / 2 + 1 input values
+   * are used.
+   * @param[in] input Pointer to complex input values
+   * @param[out] output Pointer to buffer for size real output values. Must
+   *                    not overlap input.
+   */
+  void backward(const std::complex<double>* input, double* output) const;
+
+  /**
+   * Compute forward transform of complex data in place. Plan must have
+   * complex domain and be in place.
+   * @param[in, out] data Pointer to size complex values
+   */
+  void forward(std::complex<double>* data) const;
+
+  /**
+   * Compute forward transform of real data in place. Plan must have real
+   * domain and be in place.
+   * @param[in, out] data Pointer to buffer of 2 * (size / 2 + 1) values, with
+   *                      size real input values at start. Overwritten by
+   *                      size / 2 + 1 interleaved complex output values.
+   */
+  void forward(double* data) const;
+
+  /**
+   * Compute backward transform of complex data in place. Plan must have
+   * complex domain and be in place.
+   * @param[in, out] data Pointer to size complex values
+   */
+  void backward(std::complex<double>* data) const;
+
+  /**
+   * Compute real backward transform of conjugate-even data in place. Plan
+   * must have real domain and be in place.
+   * @param[in, out] data Pointer to buffer of 2 * (size / 2 + 1) values
+   *                      holding size / 2 + 1 interleaved complex input
+   *                      values. Overwritten by size real output values at
+   *                      start.
+   */
+  void backward(double* data) const;
+
+  /**
+   * Get the length of transforms computed by this plan
+   * @return Length of transforms
+   */
+  std::size_t size() const { return size_; };
+
+  /**
+   * Get the domain of the forward transform input
+   * @return Domain of plan
+   */
+  Domain domain() const { return domain_; };
+
+  /**
+   * Get the placement of transform output
+   * @return Placement of plan
+   */
+  Placement placement() const { return placement_; };
+
+ private:
+  /**
+   * Check that plan has domain and placement required by a transform
+   * @param[in] domain Required domain
+   * @param[in] placement Required placement
+   * @param[in] function Name of function requiring domain and placement
+   */
+  void check(Domain domain, Placement placement,
+             const char* function) const;
+
+  /**
+   * Compute transform in input direction, checking status
+   * @param[in] forward_direction True for forward transform, false for
+   *                              backward transform
+   * @param[in] input Pointer to input data
+   * @param[out] output Pointer to output data, or null for in place
+   *                    transforms
+   * @param[in] function Name of function computing transform
+   */
+  void compute(bool forward_direction, const void* input, void* output,
+               const char* function) const;
+
+  std::size_t size_; /**< Length of transforms */
+  Domain domain_; /**< Domain of forward transform input */
+  Placement placement_; /**< Placement of transform output */
+  DFTI_DESCRIPTOR_HANDLE descriptor_; /**< Committed MKL descriptor */
+};
+
+/**
+ * Committed MKL descriptor for computing several 1-dimensional double
+ * precision FFTs of the same length in one call. Records are stored one after
+ * another in input and output buffers, separated by fixed distances, such as
+ * the columns of a column-major Eigen matrix. Transforms are out of place in
+ * a single direction, since the storage of real and conjugate-even records
+ * differs. As for FFTPlan, the backward transform is scaled by the inverse of
+ * the length and conjugate-even records are stored in CCE format.
+ */
+class BatchFFTPlan {
+ public:
+  /**
+   * Direction of transforms
+   */
+  enum class Direction {
+    Forward, /**< Forward transforms */
+    Backward /**< Backward transforms */
+  };
+
+  /**
+   * Floating-point precision of records
+   */
+  enum class Precision {
+    Double, /**< Records of doubles */
+    Single  /**< Records of floats */
+  };
+
+  /**
+   * @constructor Delete default constructor
+   */
+  BatchFFTPlan() = delete;
+
+  /**
+   * @constructor Construct and commit descriptor for batch of transforms
+   * @param[in] size Length of each transform
+   * @param[in] num_transforms Number of transforms in batch
+   * @param[in] domain Domain of forward transform input
+   * @param[in] direction Direction of transforms
+   * @param[in] input_distance Distance between starts of input records in
+   *                           elements of input type. A value of 0 packs
+   *                           records contiguously. Defaults to 0.
+   * @param[in] output_distance Distance between starts of output records in
+   *                            elements of output type. A value of 0 packs
+   *                            records contiguously. Defaults to 0.
+   * @param[in] precision Precision of records. Defaults to double.
+   */
+  BatchFFTPlan(std::size_t size, std::size_t num_transforms,
+               FFTPlan::Domain domain, Direction direction,
+               std::size_t input_distance = 0,
+               std::size_t output_distance = 0,
+               Precision precision = Precision::Double);
+
+  /**
+   * @destructor Free descriptor
+   */
+  virtual ~BatchFFTPlan();
+
+  /**
+   * Delete copy constructor
+   */
+  BatchFFTPlan(const BatchFFTPlan&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  BatchFFTPlan& operator=(const BatchFFTPlan&) = delete;
+
+  /**
+   * Get plan for contiguous records from a cache shared across threads,
+   * constructing it if it has not been used recently
+   * @param[in] size Length of each transform
+   * @param[in] num_transforms Number of transforms in batch
+   * @param[in] domain Domain of forward transform input
+   * @param[in] direction Direction of transforms
+   * @param[in] precision Precision of records. Defaults to double.
+   * @return Shared pointer to plan
+   */
+  static std::shared_ptr<const BatchFFTPlan> cached(
+      std::size_t size, std::size_t num_transforms, FFTPlan::Domain domain,
+      Direction direction, Precision precision = Precision::Double);
+
+  /**
+   * Compute transforms of complex records. Plan must have complex domain and
+   * double precision.
+   * @param[in] input Pointer to input records
+   * @param[out] output Pointer to buffer for output records. Must not overlap
+   *                    input.
+   */
+  void compute(const std::complex<double>* input,
+               std::complex<double>* output) const;
+
+  /**
+   * Compute forward transforms of real records. Plan must have real domain,
+   * forward direction and double precision.
+   * @param[in] input Pointer to real input records
+   * @param[out] output Pointer to buffer for size / 2 + 1 complex values per
+   *                    record. Must not overlap input.
+   */
+  void compute(const double* input, std::complex<double>* output) const;
+
+  /**
+   * Compute backward transforms of conjugate-even records. Plan must have
+   * real domain, backward direction and double precision.
+   * @param[in] input Pointer to size / 2 + 1 complex values per record
+   * @param[out] output Pointer to buffer for real output records. Must not
+   *                    overlap input.
+   */
+  void compute(const std::complex<double>* input, double* output) const;
+
+  /**
+   * Compute transforms of complex records. Plan must have complex domain and
+   * single precision.
+   * @param[in] input Pointer to input records
+   * @param[out] output Pointer to buffer for output records. Must not overlap
+   *                    input.
+   */
+  void compute(const std::complex<float>* input,
+               std::complex<float>* output) const;
+
+  /**
+   * Compute forward transforms of real records. Plan must have real domain,
+   * forward direction and single precision.
+   * @param[in] input Pointer to real input records
+   * @param[out] output Pointer to buffer for size / 2 + 1 complex values per
+   *                    record. Must not overlap input.
+   */
+  void compute(const float* input, std::complex<float>* output) const;
+
+  /**
+   * Compute backward transforms of conjugate-even records. Plan must have
+   * real domain, backward direction and single precision.
+   * @param[in] input Pointer to size / 2 + 1 complex values per record
+   * @param[out] output Pointer to buffer for real output records. Must not
+   *                    overlap input.
+   */
+  void compute(const std::complex<float>* input, float* output) const;
+
+  /**
+   * Get the length of each transform
+   * @return Length of transforms
+   */
+  std::size_t size() const { return size_; };
+
+  /**
+   * Get the number of transforms in batch
+   * @return Number of transforms
+   */
+  std::size_t num_transforms() const { return num_transforms_; };
+
+  /**
+   * Get the precision of records
+   * @return Precision of records
+   */
+  Precision precision() const { return precision_; };
+
+ private:
+  /**
+   * Check that plan has domain, direction and precision required by a
+   * transform and compute it
+   * @param[in] domain Required domain
+   * @param[in] real_input True if transform requires real input and complex
+   *                       output, false otherwise
+   * @param[in] precision Required precision
+   * @param[in] input Pointer to input data
+   * @param[out] output Pointer to output data
+   */
+  void compute(FFTPlan::Domain domain, bool real_input, Precision precision,
+               const void* input, void* output) const;
+
+  std::size_t size_; /**< Length of transforms */
+  std::size_t num_transforms_; /**< Number of transforms in batch */
+  FFTPlan::Domain domain_; /**< Domain of forward transform input */
+  Direction direction_; /**< Direction of transforms */
+  Precision precision_; /**< Precision of records */
+  DFTI_DESCRIPTOR_HANDLE descriptor_; /**< Committed MKL descriptor */
+  std::unique_ptr<const device::BatchFFT>
+      device_plan_; /**< Plan of large contiguous batches on the GPU, if any */
+};
+}  // namespace numeric_utils
+
+#endif  // _FFT_PLAN_H_
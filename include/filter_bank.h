@@ -0,0 +1,78 @@
+#ifndef _FILTER_BANK_H_
+#define _FILTER_BANK_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace signal_processing {
+
+/**
+ * Cache of filter and window kernels shared across threads. Kernels are
+ * computed once for each combination of filter type, order, cutoff frequency,
+ * time step and length using the functions registered with the dispatcher,
+ * so models can build their filters once per scenario instead of once per
+ * record. Returned kernels are immutable and remain valid after they are
+ * evicted from the cache.
+ */
+class FilterBank {
+ public:
+  /**
+   * @constructor Delete default constructor, only static members are used
+   */
+  FilterBank() = delete;
+
+  /**
+   * Get coefficients of highpass Butterworth filter
+   * @param[in] filter_order Order of the Butterworth filter
+   * @param[in] cutoff_freq Normalized cutoff frequency
+   * @return Shared pointer to vector containing numerator coefficients
+   *         followed by vector containing denominator coefficients
+   */
+  static std::shared_ptr<const std::vector<std::vector<double>>>
+      highpass_butterworth(int filter_order, double cutoff_freq);
+
+  /**
+   * Get impulse response of highpass Butterworth filter
+   * @param[in] filter_order Order of the Butterworth filter
+   * @param[in] cutoff_freq Normalized cutoff frequency
+   * @param[in] num_samples Number of samples in impulse response
+   * @return Shared pointer to impulse response
+   */
+  static std::shared_ptr<const std::vector<double>> highpass_impulse_response(
+      int filter_order, double cutoff_freq, int num_samples);
+
+  /**
+   * Get frequency domain coefficients of acausal highpass Butterworth filter
+   * @param[in] freq_corner Corner frequency
+   * @param[in] time_step Time step between observations
+   * @param[in] filter_order Order of the filter
+   * @param[in] num_samples Number of samples in filter
+   * @return Shared pointer to filter coefficients
+   */
+  static std::shared_ptr<const std::vector<double>> acausal_highpass(
+      double freq_corner, double time_step, unsigned int filter_order,
+      unsigned int num_samples);
+
+  /**
+   * Get Hann window
+   * @param[in] window_length Length of window
+   * @return Shared pointer to window function evaluations
+   */
+  static std::shared_ptr<const std::vector<double>> hann_window(
+      unsigned int window_length);
+
+  /**
+   * Get the number of kernels currently in the cache
+   * @return Number of cached kernels
+   */
+  static std::size_t size();
+
+  /**
+   * Remove all kernels from the cache
+   */
+  static void clear();
+};
+}  // namespace signal_processing
+
+#endif  // _FILTER_BANK_H_
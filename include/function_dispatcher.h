@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -15,6 +16,52 @@
 template <typename Treturntype, typename... Targs>
 class Dispatcher {
  public:
+  /**
+   * Copyable handle to a function registered with the dispatcher. Handles
+   * are obtained once through resolve and then called without any key
+   * lookup. Registered functions are never removed, so handles stay valid
+   * for the lifetime of the program.
+   */
+  class Handle {
+   public:
+    /**
+     * @constructor Construct empty handle that does not refer to a function
+     */
+    Handle() : function_{nullptr} {};
+
+    /**
+     * Call the function referred to by handle with input arguments
+     * @param args Inputs to function
+     * @return Return result of evaluating function with input args
+     */
+    Treturntype operator()(Targs... args) const {
+      if (!function_) {
+        throw std::runtime_error(
+            "Empty dispatcher handle, resolve function before calling");
+      }
+      return (*function_)(std::forward<Targs>(args)...);
+    }
+
+    /**
+     * Check if handle refers to a function
+     * @return True if handle refers to a function, false otherwise
+     */
+    explicit operator bool() const { return function_ != nullptr; }
+
+   private:
+    friend class Dispatcher;
+
+    /**
+     * @constructor Construct handle referring to input function
+     * @param[in] function Function registered with the dispatcher
+     */
+    explicit Handle(const std::function<Treturntype(Targs...)>* function)
+        : function_{function} {};
+
+    const std::function<Treturntype(Targs...)>* function_; /**< Registered
+                                                               function */
+  };
+
   /**
    * Get the single instance of the dispatcher
    */
@@ -46,11 +93,20 @@ class Dispatcher {
    * @return Return result of evaluating function with input args
    */
   Treturntype dispatch(const std::string& key, Targs... args) {
-    if (!this->check(key)) {
+    return resolve(key)(std::forward<Targs>(args)...);
+  }
+
+  /**
+   * Look up a registered function once for repeated calls
+   * @param[in] key Key to function in dispatcher
+   * @return Handle to registered function
+   */
+  Handle resolve(const std::string& key) const {
+    auto entry = registry.find(key);
+    if (entry == registry.end()) {
       throw std::runtime_error("Invalid key: " + key + ", not found in the function dispatcher");
-    } else {
-      return registry.at(key)(std::forward<Targs>(args)...);
     }
+    return Handle(&entry->second);
   }
 
   /**
@@ -59,10 +115,7 @@ class Dispatcher {
    * @return status Return if key is in registry or not
    */
   bool check(const std::string& key) const {
-    bool status = false;
-    for (const auto& keyvalue : registry)
-      if (keyvalue.first == key) status = true;
-    return status;
+    return registry.find(key) != registry.end();
   }
   
   /**
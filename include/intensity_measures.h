@@ -0,0 +1,80 @@
+#ifndef _INTENSITY_MEASURES_H_
+#define _INTENSITY_MEASURES_H_
+
+#include <cstddef>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace numeric_utils {
+
+/**
+ * Calculate the Arias intensity of an acceleration time history, equal to
+ * pi / 2 times the integral of the squared acceleration. Result is in units
+ * of acceleration squared times time, so dividing by the acceleration of
+ * gravity gives the usual definition.
+ * @param[in] acceleration Pointer to acceleration time history
+ * @param[in] num_steps Number of time steps in time history
+ * @param[in] time_step Time step of time history
+ * @return Arias intensity
+ */
+double arias_intensity(const double* acceleration, std::size_t num_steps,
+                       double time_step);
+
+/**
+ * Calculate the Arias intensity of several acceleration time histories
+ * @param[in] accelerations Acceleration time histories, with one time history
+ *                          per column
+ * @param[in] time_step Time step of time histories
+ * @return Vector containing Arias intensity of each time history
+ */
+Eigen::VectorXd arias_intensity(const Eigen::MatrixXd& accelerations,
+                                double time_step);
+
+/**
+ * Find the first time steps at which each of the input percentages of the
+ * total Arias intensity is reached, without storing the cumulative intensity.
+ * The acceleration is read once to sum the total energy and once more up to
+ * the time step at which the last percentage is reached.
+ * @param[in] acceleration Pointer to acceleration time history
+ * @param[in] num_steps Number of time steps in time history
+ * @param[in] percentages Pointer to percentages of Arias intensity, which do
+ *                        not need to be sorted
+ * @param[in, out] indices Pointer to buffer to write time step indices to.
+ *                         Percentages that are never reached are given an
+ *                         index equal to the number of time steps.
+ * @param[in] num_percentages Number of percentages
+ */
+void intensity_indices(const double* acceleration, std::size_t num_steps,
+                       const double* percentages, std::size_t* indices,
+                       std::size_t num_percentages);
+
+/**
+ * Find the first time steps at which each of the input percentages of the
+ * total Arias intensity is reached for several acceleration time histories
+ * @param[in] accelerations Acceleration time histories, with one time history
+ *                          per column
+ * @param[in] percentages Percentages of Arias intensity
+ * @return Vector containing one vector of time step indices per time history
+ */
+std::vector<std::vector<std::size_t>> intensity_indices(
+    const Eigen::MatrixXd& accelerations,
+    const std::vector<double>& percentages);
+
+/**
+ * Calculate the significant duration of an acceleration time history, which
+ * is the time between reaching two percentages of the total Arias intensity
+ * @param[in] acceleration Pointer to acceleration time history
+ * @param[in] num_steps Number of time steps in time history
+ * @param[in] time_step Time step of time history
+ * @param[in] start_percentage Percentage of Arias intensity at start of
+ *                             duration. Defaults to 5.
+ * @param[in] end_percentage Percentage of Arias intensity at end of duration.
+ *                           Defaults to 95.
+ * @return Significant duration
+ */
+double significant_duration(const double* acceleration, std::size_t num_steps,
+                            double time_step, double start_percentage = 5.0,
+                            double end_percentage = 95.0);
+}  // namespace numeric_utils
+
+#endif  // _INTENSITY_MEASURES_H_
@@ -0,0 +1,90 @@
+#ifndef _JSON_EVENT_WRITER_H_
+#define _JSON_EVENT_WRITER_H_
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include "json_object.h"
+
+namespace utilities {
+
+/**
+ * Class for writing events to file one at a time as the elements of the
+ * "Events" array of a JSON object. Output is identical to writing a
+ * JsonObject containing only the "Events" array with
+ * JsonObject::write_to_file using the same formatting options, but only one
+ * event needs to be held in memory at a time. Events can also be appended to
+ * a file written this way, in which case the output is identical to writing
+ * all events at once.
+ */
+class JsonEventWriter {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  JsonEventWriter() = delete;
+
+  /**
+   * @constructor Open output location and write start of JSON object, or
+   * continue the events array of an existing file when appending. Events
+   * overwrite the end of the existing JSON object, which close writes again,
+   * so existing files are never truncated. Throws exception if output
+   * location can not be opened or, when appending, does not end with an
+   * events array written with the same formatting options.
+   * @param[in] output_location Location to write events to
+   * @param[in] format Formatting options. Defaults to pretty-printed output
+   *                   with shortest round-trip numbers.
+   * @param[in] append Indicates that events are appended to the events of
+   *                   an existing file. Defaults to false, where existing
+   *                   files are overwritten.
+   */
+  explicit JsonEventWriter(const std::string& output_location,
+                           const JsonFormat& format = JsonFormat(),
+                           bool append = false);
+
+  /**
+   * @destructor Close output location if it is still open
+   */
+  virtual ~JsonEventWriter();
+
+  /**
+   * Delete copy constructor
+   */
+  JsonEventWriter(const JsonEventWriter&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  JsonEventWriter& operator=(const JsonEventWriter&) = delete;
+
+  /**
+   * Write event as next element of events array. Throws exception if the
+   * writer has already been closed or writing fails.
+   * @param[in] event Event to write
+   */
+  void write_event(const JsonObject& event);
+
+  /**
+   * Write end of JSON object and close output location. Throws exception if
+   * errors are encountered when writing or closing the output location.
+   * @return Returns true if successful, false otherwise
+   */
+  bool close();
+
+  /**
+   * Get the number of events written so far, excluding events of the
+   * existing file when appending
+   * @return Number of events
+   */
+  std::size_t num_events() const { return num_events_; };
+
+ private:
+  std::ofstream output_file_; /**< Output file stream */
+  JsonFormat format_; /**< Formatting options */
+  std::size_t num_events_; /**< Number of events written */
+  bool existing_events_; /**< Indicates that the events array already held
+                            events when appending */
+};
+}  // namespace utilities
+
+#endif  // _JSON_EVENT_WRITER_H_
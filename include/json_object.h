@@ -1,6 +1,7 @@
 #ifndef _JSON_OBJECT_H_
 #define _JSON_OBJECT_H_
 
+#include <cstddef>
 #include <iomanip>
 #include <iostream>
 // JSON for Modern C++ single-include header
@@ -10,6 +11,20 @@ namespace utilities {
 // Alias for JSON type
   using json = nlohmann::json;
   
+/**
+ * Options for formatting JSON text output
+ */
+struct JsonFormat {
+  bool compact = false; /**< Write without whitespace instead of
+                           pretty-printing with indentation of 4 spaces */
+  unsigned int significant_digits =
+      0; /**< Significant digits of floating point numbers. A value of 0
+            writes the shortest representation that round-trips. */
+  unsigned int num_threads = 1; /**< Number of threads used to format large
+                                   arrays of numbers. A value of 0 uses all
+                                   available hardware threads. */
+};
+
 /**
  * Wrapper class for JSON implementation
  */
@@ -58,6 +73,17 @@ class JsonObject {
    */
   template <typename Tparam>
   bool add_value(const std::string& key, const Tparam& value);
+
+  /**
+   * Add array of values to key in JSON object directly from contiguous
+   * storage, without copying values into an intermediate container
+   * @param[in] key Key to add values to
+   * @param[in] values Pointer to values to add
+   * @param[in] num_values Number of values to add
+   * @return Returns true if successful, false otherwise
+   */
+  bool add_array(const std::string& key, const double* values,
+                 std::size_t num_values);
   
   /**
    * Get the value associated with the input key
@@ -82,6 +108,36 @@ class JsonObject {
    */
   bool write_to_file(const std::string& output_location) const;
 
+  /**
+   * Write JSON object to file using input formatting options
+   * @param[in] output_location Location to write JSON object to
+   * @param[in] format Formatting options. Default options give the same
+   *                   output as writing the JSON object without options.
+   * @return Returns true if successful, false otherwise
+   */
+  bool write_to_file(const std::string& output_location,
+                     const JsonFormat& format) const;
+
+  /**
+   * Replace contents of JSON object by the JSON object read from file.
+   * Throws exception if the file can not be read or does not contain a JSON
+   * object.
+   * @param[in] input_location Location to read JSON object from
+   * @return Returns true if successful, false otherwise
+   */
+  bool read_from_file(const std::string& input_location);
+
+  /**
+   * Write JSON object to output stream using input formatting options
+   * @param[in, out] out Output stream to write JSON object to
+   * @param[in] format Formatting options
+   * @param[in] depth Nesting depth of JSON object in enclosing output, which
+   *                  sets the indentation of pretty-printed lines after the
+   *                  first. Defaults to 0.
+   */
+  void write(std::ostream& out, const JsonFormat& format,
+             unsigned int depth = 0) const;
+
   /**
    * Clear JSON object contents
    */
@@ -1,6 +1,7 @@
 #ifndef _LOGNORMAL_DIST_H_
 #define _LOGNORMAL_DIST_H_
 
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <boost/math/distributions/lognormal.hpp>
@@ -56,6 +57,44 @@ class LognormalDistribution : public Distribution {
   std::vector<double> inv_cumulative_dist_func(
       const std::vector<double>& probabilities) const override;
 
+  /**
+   * Compute the cumulative distribution function (CDF) of the distribution at
+   * specified input locations, writing results to caller-owned buffer
+   * @param[in] locations Pointer to locations at which to calculate CDF
+   * @param[in, out] evaluations Pointer to buffer to write evaluated values of
+   *                             CDF to. May be the same as locations.
+   * @param[in] num_values Number of locations
+   */
+  void cumulative_dist_func(const double* locations, double* evaluations,
+                            std::size_t num_values) const override;
+
+  /**
+   * Compute the inverse cumulative distribution function (ICDF) of the
+   * distribution at specified input probabilities, writing results to
+   * caller-owned buffer
+   * @param[in] probabilities Pointer to probabilities at which to calculate
+   *                          ICDF
+   * @param[in, out] evaluations Pointer to buffer to write evaluated values of
+   *                             ICDF to. May be the same as probabilities.
+   * @param[in] num_values Number of probabilities
+   */
+  void inv_cumulative_dist_func(const double* probabilities,
+                                double* evaluations,
+                                std::size_t num_values) const override;
+
+  /**
+   * Transform realizations of a standard normal random variable to this
+   * distribution in closed form
+   * @param[in] std_normal_values Pointer to standard normal values to
+   *                              transform
+   * @param[in, out] evaluations Pointer to buffer to write transformed values
+   *                             to. May be the same as std_normal_values.
+   * @param[in] num_values Number of values to transform
+   */
+  void transform_from_std_normal(const double* std_normal_values,
+                                 double* evaluations,
+                                 std::size_t num_values) const override;
+
  protected:
   double mean_;                         /**< Distribution mean */
   double std_dev_;                      /**< Distribution standard deviation */
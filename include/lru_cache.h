@@ -0,0 +1,96 @@
+#ifndef _LRU_CACHE_H_
+#define _LRU_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace utilities {
+
+/**
+ * Cache shared across threads that keeps a bounded number of entries and
+ * evicts the least recently used one when full. Entries that are used
+ * repeatedly therefore stay cached while entries that are used only once
+ * come and go.
+ * @tparam Tkey Type of keys, which must be ordered
+ * @tparam Tvalue Type of cached values, which should be cheap to copy
+ */
+template <typename Tkey, typename Tvalue>
+class LruCache {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  LruCache() = delete;
+
+  /**
+   * @constructor Construct empty cache
+   * @param[in] max_entries Maximum number of entries kept. Must be at least
+   *                        1.
+   */
+  explicit LruCache(std::size_t max_entries) : max_entries_{max_entries} {}
+
+  /**
+   * Delete copy constructor
+   */
+  LruCache(const LruCache&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  LruCache& operator=(const LruCache&) = delete;
+
+  /**
+   * Get cached value of key and mark it as most recently used
+   * @param[in] key Key to look up
+   * @param[out] value Cached value, if found
+   * @return Returns true if the key is cached, false otherwise
+   */
+  bool find(const Tkey& key, Tvalue& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto entry = entries_.find(key);
+    if (entry == entries_.end()) {
+      return false;
+    }
+    usage_.splice(usage_.begin(), usage_, entry->second.first);
+    value = entry->second.second;
+    return true;
+  }
+
+  /**
+   * Add value for key as most recently used, evicting the least recently used
+   * entry if the cache is full. If another thread has added the key in the
+   * meantime, its value is kept instead.
+   * @param[in] key Key of value
+   * @param[in] value Value to cache
+   * @return Value cached for key
+   */
+  Tvalue insert(const Tkey& key, Tvalue value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto entry = entries_.find(key);
+    if (entry != entries_.end()) {
+      usage_.splice(usage_.begin(), usage_, entry->second.first);
+      return entry->second.second;
+    }
+    if (entries_.size() >= max_entries_) {
+      entries_.erase(usage_.back());
+      usage_.pop_back();
+    }
+    usage_.push_front(key);
+    return entries_
+        .emplace(key, std::make_pair(usage_.begin(), std::move(value)))
+        .first->second.second;
+  }
+
+ private:
+  std::size_t max_entries_; /**< Maximum number of entries kept */
+  std::mutex mutex_; /**< Serializes access to entries */
+  std::list<Tkey> usage_; /**< Keys from most to least recently used */
+  std::map<Tkey, std::pair<typename std::list<Tkey>::iterator, Tvalue>>
+      entries_; /**< Cached values and their position in usage list */
+};
+}  // namespace utilities
+
+#endif  // _LRU_CACHE_H_
@@ -0,0 +1,80 @@
+#ifndef _MULTI_START_NELDER_MEAD_H_
+#define _MULTI_START_NELDER_MEAD_H_
+
+#include <functional>
+#include <vector>
+
+namespace optimization {
+
+/**
+ * Class that runs independent Nelder-Mead minimizations from several starting
+ * points concurrently and collects the local minima found from each start
+ */
+class MultiStartNelderMead {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  MultiStartNelderMead() = delete;
+
+  /**
+   * @constructor Construct with input function tolerance
+   * @param[in] function_tolerance Tolerance in consecutive function evaluations
+   *                               for convergence of each start
+   * @param[in] num_threads Number of threads to run starts on. A value of 0
+   *                        uses all available hardware threads. Defaults to 1.
+   * @param[in] stop_early If true, starts that have not begun are skipped
+   *                       once any start finds an objective value less than
+   *                       the function tolerance. Defaults to false.
+   */
+  MultiStartNelderMead(double function_tolerance, unsigned int num_threads = 1,
+                       bool stop_early = false)
+      : function_tol_{function_tolerance},
+        num_threads_{num_threads},
+        stop_early_{stop_early},
+        best_index_{0} {};
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~MultiStartNelderMead(){};
+
+  /**
+   * Minimize the input objective function from each of the initial points.
+   * The objective function is called concurrently from multiple threads
+   * unless the number of threads is 1, so it must be safe to call
+   * concurrently.
+   * @param[in] initial_points Initial values to use for each start
+   * @param[in] deltas Vector of step sizes to use for dimensions of each start
+   * @param[in] objective_function Function to minimize
+   * @return Locations of minimum for each start. Skipped starts return their
+   *         initial point.
+   */
+  std::vector<std::vector<double>> minimize(
+      const std::vector<std::vector<double>>& initial_points,
+      const std::vector<std::vector<double>>& deltas,
+      std::function<double(const std::vector<double>&)>& objective_function);
+
+  /**
+   * Get the minimum value of the objective function found from each start.
+   * Skipped starts have a value of infinity.
+   * @return Vector of objective function minima
+   */
+  const std::vector<double>& get_minima() const { return minima_; };
+
+  /**
+   * Get the index of the start with the lowest objective function value
+   * @return Index of best start
+   */
+  unsigned int get_best_index() const { return best_index_; };
+
+ private:
+  double function_tol_;         /**< Function tolerance for convergence */
+  unsigned int num_threads_;    /**< Number of threads to use */
+  bool stop_early_;             /**< Skip remaining starts after convergence */
+  unsigned int best_index_;     /**< Index of start with lowest minimum */
+  std::vector<double> minima_;  /**< Objective function minimum per start */
+};
+}  // namespace optimization
+
+#endif  // _MULTI_START_NELDER_MEAD_H_
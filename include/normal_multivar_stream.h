@@ -0,0 +1,64 @@
+#ifndef _NORMAL_MULTIVAR_STREAM_H_
+#define _NORMAL_MULTIVAR_STREAM_H_
+
+#include <cstdint>
+// Eigen dense matrices
+#include <Eigen/Dense>
+
+#include "numeric_utils.h"
+#include "random_stream.h"
+
+namespace numeric_utils {
+
+/**
+ * Class for generating random realizations of a multivariate normal
+ * distribution from a counter-based random stream keyed by a 64-bit seed.
+ * The stream uses the largest spectrum and simulation indices, which models
+ * do not use for synthesis, so the generator can share its seed with the
+ * streams of a model.
+ */
+class NormalMultiVarStream : public RandomGenerator {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  NormalMultiVarStream() = delete;
+
+  /**
+   * @constructor Construct an instance of the multivariate normal random number
+   * generator
+   * @param[in] seed Seed of random stream
+   */
+  NormalMultiVarStream(std::uint64_t seed);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~NormalMultiVarStream(){};
+
+  /**
+   * Get multivariate random realization
+   * @param[in, out] random_numbers Matrix to store generated random numbers to
+   * @param[in] means Vector of mean values for random variables
+   * @param[in] cov Covariance matrix of for random variables
+   * @param[in] cases Number of cases to generate
+   * @return Returns true if no issues were encountered in Cholesky
+   *         decomposition of covariance matrix, returns false otherwise
+   */
+  bool generate(
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& random_numbers,
+      const Eigen::VectorXd& means, const Eigen::MatrixXd& cov,
+      unsigned int cases = 1) override;
+
+  /**
+   * Get the class name
+   * @return Class name
+   */
+  std::string name() const override;
+
+ private:
+  RandomStream stream_; /**< Philox4x32-10 random stream */
+};
+}  // namespace numeric_utils
+
+#endif  // _NORMAL_MULTIVAR_STREAM_H_
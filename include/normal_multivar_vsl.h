@@ -0,0 +1,70 @@
+#ifndef _NORMAL_MULTIVAR_VSL_H_
+#define _NORMAL_MULTIVAR_VSL_H_
+
+#include <mkl_vsl.h>
+// Eigen dense matrices
+#include <Eigen/Dense>
+
+#include "numeric_utils.h"
+
+namespace numeric_utils {
+
+/**
+ * Class for generating random realizations of a multivariate normal
+ * distribution in bulk using MKL Vector Statistics streams
+ */
+class NormalMultiVarVsl : public RandomGenerator {
+ public:
+  /**
+   * @constructor Default constructor
+   */
+  NormalMultiVarVsl();
+
+  /**
+   * @constructor Construct an instance of the multivariate normal random number
+   * generator
+   * @param[in] seed Seed value to use in random number generator
+   */
+  NormalMultiVarVsl(int seed);
+
+  /**
+   * @destructor Virtual destructor that releases VSL stream
+   */
+  virtual ~NormalMultiVarVsl();
+
+  /**
+   * Delete copy constructor, since the VSL stream is owned by one instance
+   */
+  NormalMultiVarVsl(const NormalMultiVarVsl&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  NormalMultiVarVsl& operator=(const NormalMultiVarVsl&) = delete;
+
+  /**
+   * Get multivariate random realization
+   * @param[in, out] random_numbers Matrix to store generated random numbers to
+   * @param[in] means Vector of mean values for random variables
+   * @param[in] cov Covariance matrix of for random variables
+   * @param[in] cases Number of cases to generate
+   * @return Returns true if no issues were encountered in Cholesky
+   *         decomposition of covariance matrix, returns false otherwise
+   */
+  bool generate(
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& random_numbers,
+      const Eigen::VectorXd& means, const Eigen::MatrixXd& cov,
+      unsigned int cases = 1) override;
+
+  /**
+   * Get the class name
+   * @return Class name
+   */
+  std::string name() const override;
+
+ private:
+  VSLStreamStatePtr stream_; /**< VSL Philox4x32-10 random stream */
+};
+}  // namespace numeric_utils
+
+#endif  // _NORMAL_MULTIVAR_VSL_H_
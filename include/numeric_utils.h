@@ -2,6 +2,7 @@
 #define _NUMERIC_UTILS_H_
 
 #include <complex>
+#include <cstddef>
 #include <ctime>
 #include <utility>
 #include <vector>
@@ -39,7 +40,7 @@ bool convolve_1d(const std::vector<double>& input_x,
  * @param[in, out] output_vector Vector to write output to
  * @return Returns true if computations were successful, false otherwise
  */
-bool inverse_fft(std::vector<std::complex<double>> input_vector,
+bool inverse_fft(const std::vector<std::complex<double>>& input_vector,
                  std::vector<double>& output_vector);
 
 /**
@@ -69,7 +70,7 @@ bool inverse_fft(const Eigen::VectorXcd& input_vector,
  * @param[in, out] output_vector Vector to write output to
  * @return Returns true if computations were successful, false otherwise
  */
-bool fft(std::vector<double> input_vector,
+bool fft(const std::vector<double>& input_vector,
          std::vector<std::complex<double>>& output_vector);
 
 /**
@@ -91,6 +92,125 @@ bool fft(const Eigen::VectorXd& input_vector, Eigen::VectorXcd& output_vector);
 bool fft(const Eigen::VectorXd& input_vector,
          std::vector<std::complex<double>>& output_vector);
 
+/**
+ * Computes the 1-dimensional Fast Fourier Transform (FFT) of real input,
+ * writing the non-redundant half of the conjugate-even transform to a
+ * caller-owned buffer
+ * @param[in] input Pointer to real input values
+ * @param[in] size Length of transform
+ * @param[out] output Pointer to buffer for size / 2 + 1 complex values. Must
+ *                    not overlap input.
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool real_fft(const double* input, std::size_t size,
+              std::complex<double>* output);
+
+/**
+ * Computes the 1-dimensional inverse Fast Fourier Transform (FFT) of
+ * conjugate-even input, writing real output to a caller-owned buffer
+ * @param[in] input Pointer to non-redundant size / 2 + 1 complex values of
+ *                  transform
+ * @param[in] size Length of transform
+ * @param[out] output Pointer to buffer for size real values. Must not overlap
+ *                    input.
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_real_fft(const std::complex<double>* input, std::size_t size,
+                      double* output);
+
+/**
+ * Computes the 1-dimensional Fast Fourier Transform (FFT) of real input in
+ * place
+ * @param[in, out] data Pointer to buffer of 2 * (size / 2 + 1) values, with
+ *                      size real input values at start. Overwritten by
+ *                      size / 2 + 1 interleaved complex values of transform.
+ * @param[in] size Length of transform
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool real_fft(double* data, std::size_t size);
+
+/**
+ * Computes the 1-dimensional inverse Fast Fourier Transform (FFT) of
+ * conjugate-even input in place
+ * @param[in, out] data Pointer to buffer of 2 * (size / 2 + 1) values holding
+ *                      size / 2 + 1 interleaved complex values of transform.
+ *                      Overwritten by size real values at start.
+ * @param[in] size Length of transform
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_real_fft(double* data, std::size_t size);
+
+/**
+ * Computes the 1-dimensional Fast Fourier Transforms (FFT) of the columns of
+ * the input matrix as one batch, keeping the non-redundant half of each
+ * conjugate-even transform
+ * @param[in] inputs Matrix of real records, with one record per column
+ * @param[in, out] outputs Matrix to write rows / 2 + 1 transform values per
+ *                         column to
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool real_fft(const Eigen::MatrixXd& inputs, Eigen::MatrixXcd& outputs);
+
+/**
+ * Computes the 1-dimensional inverse Fast Fourier Transforms (FFT) of the
+ * columns of the input matrix as one batch
+ * @param[in] inputs Matrix of non-redundant halves of conjugate-even
+ *                   transforms, with size / 2 + 1 rows and one transform per
+ *                   column
+ * @param[in] size Length of records
+ * @param[in, out] outputs Matrix to write real records of input length to,
+ *                         with one record per column
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_real_fft(const Eigen::MatrixXcd& inputs, std::size_t size,
+                      Eigen::MatrixXd& outputs);
+
+/**
+ * Computes the 1-dimensional Fast Fourier Transforms (FFT) of the columns of
+ * the input matrix of floats as one batch in single precision, keeping the
+ * non-redundant half of each conjugate-even transform
+ * @param[in] inputs Matrix of real records, with one record per column
+ * @param[in, out] outputs Matrix to write rows / 2 + 1 transform values per
+ *                         column to
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool real_fft(const Eigen::MatrixXf& inputs, Eigen::MatrixXcf& outputs);
+
+/**
+ * Computes the 1-dimensional inverse Fast Fourier Transforms (FFT) of the
+ * columns of the input matrix as one batch in single precision
+ * @param[in] inputs Matrix of non-redundant halves of conjugate-even
+ *                   transforms, with size / 2 + 1 rows and one transform per
+ *                   column
+ * @param[in] size Length of records
+ * @param[in, out] outputs Matrix to write real records of input length to,
+ *                         with one record per column
+ * @return Returns true if computations were successful, false otherwise
+ */
+bool inverse_real_fft(const Eigen::MatrixXcf& inputs, std::size_t size,
+                      Eigen::MatrixXf& outputs);
+
+/**
+ * Get the smallest FFT length not less than the input length whose only prime
+ * factors are 2, 3 and 5. Transforms of such lengths are fast, so records are
+ * zero-padded to them and results trimmed back to the input length.
+ * @param[in] min_length Minimum length of transform
+ * @return Length of transform with only factors 2, 3 and 5
+ */
+std::size_t smooth_fft_length(std::size_t min_length);
+
+/**
+ * Computes the full 1-dimensional Fast Fourier Transform (FFT) of real input
+ * using a real transform, filling the redundant half of the output from
+ * conjugate symmetry
+ * @param[in] input Pointer to real input values
+ * @param[in] size Length of transform
+ * @param[out] output Pointer to buffer for size complex values. Must not
+ *                    overlap input.
+ */
+void full_real_fft(const double* input, std::size_t size,
+                   std::complex<double>* output);
+
 /**
  * Calculate the integral of the input vector with uniform spacing
  * between data points
@@ -219,8 +339,23 @@ class RandomGenerator {
    virtual std::string name() const = 0;
   
  protected:
+  /**
+   * Calculate lower Cholesky factor of input covariance matrix and store it
+   * in lower_cholesky_. The factorization is cached and only recomputed when
+   * the values of the covariance matrix change, so repeated draws for the
+   * same covariance only check and factor it once.
+   * @param[in] cov Covariance matrix for random variables
+   * @return Returns true if covariance matrix is positive semi-definite,
+   *         returns false otherwise
+   */
+  bool factor_covariance(const Eigen::MatrixXd& cov);
+
   int seed_ = static_cast<int>(
       std::time(nullptr)); /**< Seed value to use in random number generator */
+  Eigen::MatrixXd covariance_; /**< Covariance matrix for cached factor */
+  Eigen::MatrixXd lower_cholesky_; /**< Cached lower Cholesky factor of
+                                      covariance matrix */
+  bool factor_success_ = false; /**< Whether cached factorization succeeded */
 };
 }  // namespace numeric_utils
 
@@ -0,0 +1,33 @@
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+#include <functional>
+
+namespace utilities {
+
+/**
+ * Get the number of threads to use for parallel execution
+ * @param[in] requested_threads Requested number of threads. A value of 0
+ *                              corresponds to the number of hardware threads
+ *                              available.
+ * @return Number of threads to use, which is at least 1
+ */
+unsigned int thread_count(unsigned int requested_threads);
+
+/**
+ * Execute tasks in parallel over a range of indices. Tasks are handed out
+ * dynamically so uneven task sizes are balanced across threads. If any task
+ * throws an exception, remaining tasks are abandoned and the first exception
+ * is rethrown on the calling thread once all threads have finished.
+ * @param[in] num_tasks Number of tasks to execute
+ * @param[in] num_threads Number of threads to use for execution. A value of
+ *                        1 executes all tasks in order on the calling thread,
+ *                        while 0 uses all available hardware threads.
+ * @param[in] task Function to execute for each task index in the range
+ *                 [0, num_tasks)
+ */
+void parallel_for(unsigned int num_tasks, unsigned int num_threads,
+                  const std::function<void(unsigned int)>& task);
+}  // namespace utilities
+
+#endif  // _PARALLEL_H_
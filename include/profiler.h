@@ -0,0 +1,211 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include "json_object.h"
+
+/**
+ * Instrumentation of hot paths is compiled in only when SMELT_ENABLE_PROFILING
+ * is defined, which BUILD_PROFILING does. Otherwise the macros below expand to
+ * nothing, so instrumented code has no overhead and profiles stay empty.
+ *   SMELT_PROFILE_ACTIVATE(profile): Record into profile on the calling thread
+ *                                    until the end of the enclosing scope
+ *   SMELT_PROFILE_STAGE(name): Time the enclosing scope as stage name
+ *   SMELT_PROFILE_COUNT(name, amount): Add amount to counter name
+ */
+#ifdef SMELT_ENABLE_PROFILING
+#define SMELT_PROFILE_CONCAT_(a, b) a##b
+#define SMELT_PROFILE_CONCAT(a, b) SMELT_PROFILE_CONCAT_(a, b)
+#define SMELT_PROFILE_ACTIVATE(profile)                         \
+  utilities::ScopedProfile SMELT_PROFILE_CONCAT(smelt_profile_, \
+                                                __LINE__)(&(profile))
+#define SMELT_PROFILE_STAGE(name) \
+  utilities::StageTimer SMELT_PROFILE_CONCAT(smelt_stage_, __LINE__)(name)
+#define SMELT_PROFILE_COUNT(name, amount) \
+  utilities::Profile::count(name, amount)
+#else
+#define SMELT_PROFILE_ACTIVATE(profile)
+#define SMELT_PROFILE_STAGE(name)
+#define SMELT_PROFILE_COUNT(name, amount)
+#endif
+
+namespace utilities {
+
+/**
+ * Check whether the library was built with profiling instrumentation
+ * @return Returns true if SMELT_ENABLE_PROFILING was defined, false otherwise
+ */
+bool profiling_enabled();
+
+/**
+ * Time spent in stages and counts of events, such as Fast Fourier Transforms
+ * or objective function evaluations, recorded while generating records.
+ * Instrumented code records into the profile active on its thread, and
+ * parallel_for activates the profile of the calling thread on its workers, so
+ * times of stages run on several threads are summed over threads. Stages may
+ * be nested, in which case outer stages include the time of inner stages.
+ * Recording is safe to do concurrently.
+ */
+class Profile {
+ public:
+  /**
+   * @constructor Construct empty profile
+   */
+  Profile() = default;
+
+  /**
+   * Delete copy constructor
+   */
+  Profile(const Profile&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  Profile& operator=(const Profile&) = delete;
+
+  /**
+   * Get the profile active on the calling thread
+   * @return Pointer to active profile, or null if no profile is active
+   */
+  static Profile* active();
+
+  /**
+   * Activate profile on the calling thread
+   * @param[in] profile Profile to activate. A null pointer deactivates
+   *                    profiling.
+   */
+  static void set_active(Profile* profile);
+
+  /**
+   * Add amount to counter of the profile active on the calling thread, if any
+   * @param[in] counter Name of counter
+   * @param[in] amount Amount to add to counter
+   */
+  static void count(const char* counter, std::uint64_t amount);
+
+  /**
+   * Add time spent in one call of a stage
+   * @param[in] stage Name of stage
+   * @param[in] seconds Time spent in seconds
+   */
+  void add_time(const std::string& stage, double seconds);
+
+  /**
+   * Add amount to counter
+   * @param[in] counter Name of counter
+   * @param[in] amount Amount to add to counter
+   */
+  void add_count(const std::string& counter, std::uint64_t amount);
+
+  /**
+   * Remove all stages and counters
+   */
+  void reset();
+
+  /**
+   * Create JSON object with the time and number of calls of each stage under
+   * "stages" and the value of each counter under "counters"
+   * @return JsonObject containing profile
+   */
+  JsonObject json() const;
+
+ private:
+  /**
+   * Time spent in a stage summed over its calls
+   */
+  struct Stage {
+    double seconds = 0.0; /**< Time spent in seconds */
+    std::uint64_t calls = 0; /**< Number of calls */
+  };
+
+  mutable std::mutex mutex_; /**< Mutex guarding stages and counters */
+  std::map<std::string, Stage> stages_; /**< Stages by name */
+  std::map<std::string, std::uint64_t> counters_; /**< Counters by name */
+};
+
+/**
+ * Activates a profile on the calling thread for its lifetime and restores
+ * the previously active profile afterwards
+ */
+class ScopedProfile {
+ public:
+  /**
+   * @constructor Activate input profile on calling thread
+   * @param[in] profile Profile to activate. A null pointer deactivates
+   *                    profiling.
+   */
+  explicit ScopedProfile(Profile* profile)
+      : previous_{Profile::active()} {
+    Profile::set_active(profile);
+  };
+
+  /**
+   * @destructor Restore previously active profile
+   */
+  ~ScopedProfile() { Profile::set_active(previous_); };
+
+  /**
+   * Delete copy constructor
+   */
+  ScopedProfile(const ScopedProfile&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  ScopedProfile& operator=(const ScopedProfile&) = delete;
+
+ private:
+  Profile* previous_; /**< Profile active before this scope */
+};
+
+/**
+ * Times its lifetime as one call of a stage of the profile active on the
+ * calling thread when constructed. Does nothing if no profile is active.
+ */
+class StageTimer {
+ public:
+  /**
+   * @constructor Start timing stage
+   * @param[in] stage Name of stage
+   */
+  explicit StageTimer(const char* stage)
+      : stage_{stage}, profile_{Profile::active()} {
+    if (profile_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  };
+
+  /**
+   * @destructor Add elapsed time to stage
+   */
+  ~StageTimer() {
+    if (profile_) {
+      profile_->add_time(
+          stage_, std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start_)
+                      .count());
+    }
+  };
+
+  /**
+   * Delete copy constructor
+   */
+  StageTimer(const StageTimer&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  StageTimer& operator=(const StageTimer&) = delete;
+
+ private:
+  const char* stage_; /**< Name of stage */
+  Profile* profile_; /**< Profile to record into, if any */
+  std::chrono::steady_clock::time_point start_; /**< Start of stage */
+};
+}  // namespace utilities
+
+#endif  // _PROFILER_H_
@@ -0,0 +1,99 @@
+#ifndef _RANDOM_STREAM_H_
+#define _RANDOM_STREAM_H_
+
+#include <array>
+#include <cstdint>
+
+namespace numeric_utils {
+
+/**
+ * Get a seed for random streams from a model seed value
+ * @param[in] seed_value Model seed value. A value equal to
+ *                       std::numeric_limits<int>::infinity() indicates that no
+ *                       seed was provided.
+ * @return The seed value if provided, otherwise a unique seed that differs on
+ *         each call and never coincides with a provided seed value
+ */
+std::uint64_t stream_seed(int seed_value);
+
+/**
+ * Class for counter-based random number streams using the Philox4x32-10
+ * generator after Salmon et al. (2011). Each stream is identified by a seed
+ * and the indices of the spectrum, simulation and component it is used for,
+ * so any stream can be regenerated independently in any order and on any
+ * thread and always gives the same sequence of numbers. The class satisfies
+ * the requirements of a uniform random bit generator so it may also be used
+ * with standard library and boost distributions.
+ */
+class RandomStream {
+ public:
+  typedef std::uint32_t result_type;
+
+  /**
+   * @constructor Construct random stream for input seed and indices
+   * @param[in] seed Seed for stream
+   * @param[in] spectrum Index of spectrum or parameter set stream is used for
+   * @param[in] simulation Index of simulation stream is used for
+   * @param[in] component Index of component stream is used for. Defaults to 0.
+   */
+  RandomStream(std::uint64_t seed, std::uint32_t spectrum,
+               std::uint32_t simulation, std::uint32_t component = 0);
+
+  /**
+   * Get minimum value returned by stream
+   * @return Minimum value
+   */
+  static constexpr result_type min() { return 0; }
+
+  /**
+   * Get maximum value returned by stream
+   * @return Maximum value
+   */
+  static constexpr result_type max() { return 0xFFFFFFFF; }
+
+  /**
+   * Get next 32-bit random integer in stream
+   * @return Random integer uniformly distributed over [min(), max()]
+   */
+  result_type operator()();
+
+  /**
+   * Get next uniform random number in stream with 53 bits of precision
+   * @return Random number uniformly distributed over the open interval (0, 1)
+   */
+  double uniform();
+
+  /**
+   * Get next standard normal random number in stream using the Box-Muller
+   * transform
+   * @return Random number with standard normal distribution
+   */
+  double normal();
+
+  /**
+   * Advance stream by input number of 32-bit integers in constant time
+   * @param[in] num_values Number of values to skip
+   */
+  void discard(unsigned long long num_values);
+
+  /**
+   * Evaluate the Philox4x32-10 bijection for input counter and key
+   * @param[in] counter Counter to evaluate
+   * @param[in] key Key to use for evaluation
+   * @return Block of four random 32-bit integers
+   */
+  static std::array<std::uint32_t, 4> philox(
+      std::array<std::uint32_t, 4> counter, std::array<std::uint32_t, 2> key);
+
+ private:
+  std::array<std::uint32_t, 2> key_; /**< Key formed by stream seed */
+  std::array<std::uint32_t, 4> counter_; /**< Counter formed by block index
+                                            and stream indices */
+  std::array<std::uint32_t, 4> block_; /**< Current block of random values */
+  unsigned int position_; /**< Position of next value in current block */
+  bool has_normal_; /**< Whether a cached normal value is available */
+  double cached_normal_; /**< Second normal value from Box-Muller pair */
+};
+}  // namespace numeric_utils
+
+#endif  // _RANDOM_STREAM_H_
@@ -0,0 +1,153 @@
+#ifndef _RECORD_ITERATOR_H_
+#define _RECORD_ITERATOR_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "time_history_block.h"
+
+namespace stochastic {
+/**
+ * Metadata describing a generated record, without its time series
+ */
+struct RecordMetadata {
+  std::string name; /**< Name of event */
+  std::string type; /**< Type of event, such as "Seismic" or "Wind" */
+  double time_step; /**< Time step of time series */
+  std::size_t num_steps; /**< Number of time steps of time series */
+  std::vector<std::string> components; /**< Names of time series of record
+                                          components, in order */
+};
+
+/**
+ * Class that generates the records of a stochastic model on demand, one
+ * batch of records at a time. Random streams of each record depend only on
+ * the indices of the record, so the records are the same regardless of the
+ * batch size. Only the batch most recently generated is held in memory.
+ */
+class RecordIterator {
+ public:
+  /**
+   * Function that generates a batch of records given the index of the first
+   * record of the batch and the number of records in the batch. Writes the
+   * metadata of each record of the batch if the metadata pointer is not
+   * null.
+   */
+  using BatchFunction = std::function<utilities::TimeHistoryBlock(
+      std::size_t, std::size_t, std::vector<RecordMetadata>*)>;
+
+  /**
+   * @constructor Delete default constructor
+   */
+  RecordIterator() = delete;
+
+  /**
+   * @constructor Construct iterator over input number of records
+   * @param[in] num_records Total number of records
+   * @param[in] batch_size Maximum number of records generated by each call to
+   *                       next. Must be positive.
+   * @param[in] generate_batch Function that generates each batch of records
+   */
+  RecordIterator(std::size_t num_records, std::size_t batch_size,
+                 BatchFunction generate_batch);
+
+  /**
+   * Generate the next batch of records
+   * @param[in, out] records Block to move next batch of records into
+   * @return Returns true if a batch was generated, false if all records have
+   *         already been generated
+   */
+  bool next(utilities::TimeHistoryBlock& records);
+
+  /**
+   * Generate the next batch of records along with their metadata
+   * @param[in, out] records Block to move next batch of records into
+   * @param[in, out] metadata Vector to write metadata of each record of the
+   *                          batch to
+   * @return Returns true if a batch was generated, false if all records have
+   *         already been generated
+   */
+  bool next(utilities::TimeHistoryBlock& records,
+            std::vector<RecordMetadata>& metadata);
+
+  /**
+   * Generate an arbitrary range of records without advancing the iterator.
+   * Ranges of the same iterator may be generated concurrently from several
+   * threads when the model uses a single thread.
+   * @param[in] first_record Index of first record of range among all records
+   * @param[in] num_records Number of records in range
+   * @param[in, out] metadata Pointer to vector to write metadata of each
+   *                          record of range to. Metadata is not written if
+   *                          null. Defaults to null.
+   * @return Block of records in range
+   */
+  utilities::TimeHistoryBlock generate(
+      std::size_t first_record, std::size_t num_records,
+      std::vector<RecordMetadata>* metadata = nullptr) const;
+
+  /**
+   * Get the index of the first record of the next batch among all records
+   * @return Index of next record
+   */
+  std::size_t position() const { return position_; };
+
+  /**
+   * Get the total number of records
+   * @return Number of records
+   */
+  std::size_t num_records() const { return num_records_; };
+
+  /**
+   * Get the maximum number of records of each batch
+   * @return Batch size
+   */
+  std::size_t batch_size() const { return batch_size_; };
+
+  /**
+   * Check whether all records have been generated
+   * @return Returns true if there are no more records to generate
+   */
+  bool done() const { return position_ >= num_records_; };
+
+ private:
+  /**
+   * Generate the next batch of records
+   * @param[in, out] records Block to move next batch of records into
+   * @param[in, out] metadata Pointer to vector to write metadata to. Metadata
+   *                          is not written if null.
+   * @return Returns true if a batch was generated
+   */
+  bool next_batch(utilities::TimeHistoryBlock& records,
+                  std::vector<RecordMetadata>* metadata);
+
+  std::size_t num_records_;      /**< Total number of records */
+  std::size_t batch_size_;       /**< Maximum number of records per batch */
+  std::size_t position_;         /**< Index of first record of next batch */
+  BatchFunction generate_batch_; /**< Function generating each batch */
+};
+
+/**
+ * Create iterator over simulations appended to a campaign of records ordered
+ * by group and then by simulation, such as the simulations of each spectrum.
+ * Record k of the iterator is simulation num_sims + k % num_appended of
+ * group k / num_appended of the extended campaign, which has num_sims +
+ * num_appended simulations per group. Batches are generated from contiguous
+ * ranges of the extended campaign, so appended records and their metadata
+ * match those of a campaign of the extended size.
+ * @param[in] num_groups Number of groups
+ * @param[in] num_sims Number of simulations per group before appending
+ * @param[in] num_appended Number of simulations appended to each group
+ * @param[in] batch_size Maximum number of records generated by each call to
+ *                       next. Must be positive.
+ * @param[in] generate_range Function that generates a range of records of the
+ *                           extended campaign
+ * @return Iterator over appended records
+ */
+RecordIterator appended_records(std::size_t num_groups, std::size_t num_sims,
+                                std::size_t num_appended,
+                                std::size_t batch_size,
+                                RecordIterator::BatchFunction generate_range);
+}  // namespace stochastic
+
+#endif  // _RECORD_ITERATOR_H_
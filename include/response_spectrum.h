@@ -0,0 +1,99 @@
+#ifndef _RESPONSE_SPECTRUM_H_
+#define _RESPONSE_SPECTRUM_H_
+
+#include <cstddef>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace numeric_utils {
+
+/**
+ * Pseudo-acceleration response spectra of acceleration time histories,
+ * calculated for a set of linear single-degree-of-freedom oscillators with
+ * the exact recursion for piecewise-linear excitation of Nigam and Jennings
+ * (1969). Recursion coefficients are computed once on construction and all
+ * oscillators are advanced together at each time step.
+ */
+class ResponseSpectrum {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  ResponseSpectrum() = delete;
+
+  /**
+   * @constructor Construct response spectrum calculation for input periods,
+   * damping ratios and time step
+   * @param[in] periods Oscillator periods, which must be positive
+   * @param[in] damping_ratios Oscillator damping ratios, which must be in the
+   *                           range [0, 1)
+   * @param[in] time_step Time step of acceleration time histories
+   */
+  ResponseSpectrum(const std::vector<double>& periods,
+                   const std::vector<double>& damping_ratios,
+                   double time_step);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~ResponseSpectrum(){};
+
+  /**
+   * Calculate pseudo-acceleration response spectrum of input acceleration
+   * @param[in] acceleration Pointer to acceleration time history
+   * @param[in] num_steps Number of time steps in time history
+   * @return Matrix of pseudo-spectral accelerations in units of input
+   *         acceleration, with one row per damping ratio and one column per
+   *         period
+   */
+  Eigen::MatrixXd compute(const double* acceleration,
+                          std::size_t num_steps) const;
+
+  /**
+   * Calculate pseudo-acceleration response spectrum of input acceleration
+   * @param[in] acceleration Acceleration time history
+   * @return Matrix of pseudo-spectral accelerations in units of input
+   *         acceleration, with one row per damping ratio and one column per
+   *         period
+   */
+  Eigen::MatrixXd compute(const std::vector<double>& acceleration) const;
+
+  /**
+   * Calculate pseudo-acceleration response spectra of several acceleration
+   * time histories in parallel
+   * @param[in] accelerations Acceleration time histories
+   * @param[in] num_threads Number of threads to use. A value of 0 uses all
+   *                        available hardware threads. Defaults to 1.
+   * @return Vector containing response spectrum of each time history
+   */
+  std::vector<Eigen::MatrixXd> compute(
+      const std::vector<std::vector<double>>& accelerations,
+      unsigned int num_threads = 1) const;
+
+  /**
+   * Get oscillator periods
+   * @return Vector of periods
+   */
+  const std::vector<double>& periods() const { return periods_; };
+
+  /**
+   * Get oscillator damping ratios
+   * @return Vector of damping ratios
+   */
+  const std::vector<double>& damping_ratios() const { return damping_ratios_; };
+
+ private:
+  std::vector<double> periods_; /**< Oscillator periods */
+  std::vector<double> damping_ratios_; /**< Oscillator damping ratios */
+  double time_step_; /**< Time step of acceleration time histories */
+  Eigen::ArrayXd omega_squared_; /**< Squared natural frequency of each
+                                    oscillator */
+  Eigen::ArrayXd a11_, a12_, a21_, a22_; /**< Coefficients of displacement
+                                            and velocity in recursion */
+  Eigen::ArrayXd b11_, b12_, b21_, b22_; /**< Coefficients of acceleration at
+                                            start and end of time step in
+                                            recursion */
+};
+}  // namespace numeric_utils
+
+#endif  // _RESPONSE_SPECTRUM_H_
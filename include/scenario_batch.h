@@ -0,0 +1,207 @@
+#ifndef _SCENARIO_BATCH_H_
+#define _SCENARIO_BATCH_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "json_object.h"
+#include "record_iterator.h"
+#include "stochastic_model.h"
+#include "time_history_block.h"
+
+namespace stochastic {
+/**
+ * Class that generates the records of many scenarios, such as the
+ * site-rupture combinations of a regional study, with one pool of threads
+ * and a single output sink. Each scenario is a separate stochastic model,
+ * while coefficient tables, parameter distributions and filter kernels that
+ * do not depend on the scenario are shared by all instances of a model.
+ * Scenarios are processed in windows of one scenario per thread: the setup of
+ * each scenario of a window runs as one task, after which every batch of
+ * records of every scenario in the window runs as a separate task. Results are
+ * passed to the sink in the order of the scenarios and their records.
+ *
+ * Records of all scenarios can be split into shards that are generated
+ * separately, such as by different processes of a distributed campaign.
+ * Random streams depend only on the indices of each record, so when every
+ * model has a fixed seed, the outputs of all shards concatenated in order
+ * match the output of the whole batch exactly.
+ */
+class ScenarioBatch {
+ public:
+  /**
+   * Function called with the index of the scenario, the index of the first
+   * record in the block among all records of the scenario, the block of
+   * records and the metadata of each record. The block may be moved from.
+   */
+  using Sink = std::function<void(std::size_t, std::size_t,
+                                  utilities::TimeHistoryBlock&,
+                                  const std::vector<RecordMetadata>&)>;
+
+  /**
+   * @constructor Construct empty batch
+   * @param[in] num_threads Number of threads shared by all scenarios. A value
+   *                        of 0 uses all available hardware threads. Defaults
+   *                        to 1.
+   */
+  explicit ScenarioBatch(unsigned int num_threads = 1);
+
+  /**
+   * Add a scenario to the batch. Throws exception if the model is null or
+   * has already been added, since records of different scenarios are
+   * generated concurrently.
+   * @param[in] event_name Name to assign to events of scenario
+   * @param[in] model Stochastic model of scenario
+   */
+  void add_scenario(const std::string& event_name,
+                    std::shared_ptr<StochasticModel> model);
+
+  /**
+   * Get the number of scenarios in the batch
+   * @return Number of scenarios
+   */
+  std::size_t num_scenarios() const { return models_.size(); };
+
+  /**
+   * Get the total number of records of all scenarios
+   * @return Number of records
+   */
+  std::size_t num_records() const;
+
+  /**
+   * Set the shard of records generated by this batch. Records of all
+   * scenarios are numbered in the order of the scenarios and their records
+   * and split into contiguous shards of nearly equal size. Models must have
+   * fixed seeds for the outputs of shards generated separately to match the
+   * output of the whole batch. Throws exception if the number of shards is 0
+   * or the shard index is out of range.
+   * @param[in] shard Index of shard to generate
+   * @param[in] num_shards Total number of shards
+   */
+  void set_shard(std::size_t shard, std::size_t num_shards);
+
+  /**
+   * Get the index of the shard generated by this batch
+   * @return Index of shard
+   */
+  std::size_t shard() const { return shard_; };
+
+  /**
+   * Get the total number of shards
+   * @return Number of shards
+   */
+  std::size_t num_shards() const { return num_shards_; };
+
+  /**
+   * Get the range of records of all scenarios generated by a shard. Throws
+   * exception if the shard index is out of range.
+   * @param[in] shard Index of shard
+   * @return Index of first record of shard among all records and number of
+   *         records of shard
+   */
+  std::pair<std::size_t, std::size_t> shard_range(std::size_t shard) const;
+
+  /**
+   * Create index of the outputs of all shards. Events of each shard output
+   * are the records of its range in order, so an event is located by its
+   * index among all records without reading the outputs. Throws exception if
+   * the number of locations does not match the number of shards.
+   * @param[in] shard_locations Output location of each shard, in order
+   * @return JSON object with the total number of records under "numRecords",
+   *         the "location", "firstRecord" and "numRecords" of each shard under
+   *         "shards" and the "name", "firstRecord" and "numRecords" of each
+   *         scenario under "scenarios"
+   */
+  utilities::JsonObject shard_index(
+      const std::vector<std::string>& shard_locations) const;
+
+  /**
+   * Set the number of threads shared by all scenarios
+   * @param[in] num_threads Number of threads. A value of 0 uses all
+   *                        available hardware threads.
+   */
+  void set_num_threads(unsigned int num_threads) {
+    num_threads_ = num_threads;
+  };
+
+  /**
+   * Get the number of threads shared by all scenarios
+   * @return Number of threads
+   */
+  unsigned int num_threads() const { return num_threads_; };
+
+  /**
+   * Set formatting options of JSON files written by generate
+   * @param[in] json_format Formatting options
+   */
+  void set_json_format(const utilities::JsonFormat& json_format) {
+    json_format_ = json_format;
+  };
+
+  /**
+   * Generate the records of all scenarios in the shard of this batch, passing
+   * them to the input sink.
+   * The sink is called from the calling thread. Models use a single thread
+   * while they are generating and their number of threads is restored
+   * afterwards. Throws exception if errors are encountered during time
+   * history generation.
+   * @param[in] sink Function to pass each block of records to
+   * @param[in] units Indicates that time histories should be returned in
+   *                  the units selected by the units flag of each model.
+   *                  Defaults to false.
+   */
+  void generate(const Sink& sink, bool units = false);
+
+  /**
+   * Generate the records of all scenarios in the shard of this batch and
+   * write their events to a single file in JSON format. Events are written as soon as
+   * each window of scenarios has been generated. Throws exception if errors
+   * are encountered during time history generation.
+   * @param[in] output_location Location to write outputs to
+   * @param[in] units Indicates that time histories should be returned in
+   *                  the units selected by the units flag of each model.
+   *                  Defaults to false.
+   * @return Returns true if successful, false otherwise
+   */
+  bool generate(const std::string& output_location, bool units = false);
+
+ private:
+  /**
+   * Batch of records of one scenario
+   */
+  struct Task {
+    std::size_t scenario; /**< Index of scenario */
+    std::size_t first_record; /**< Index of first record among all records of
+                                 scenario */
+    std::size_t num_records; /**< Number of records */
+    utilities::TimeHistoryBlock records; /**< Generated records */
+    std::vector<RecordMetadata> metadata; /**< Metadata of each record */
+    std::vector<utilities::JsonObject> events; /**< Events of each record */
+  };
+
+  /**
+   * Generate records of all scenarios in the shard of this batch in windows
+   * of one scenario per thread
+   * @param[in] units Units flag passed to each model
+   * @param[in] prepare Function called concurrently with each task once its
+   *                    records have been generated. May be empty.
+   * @param[in] consume Function called with each task in order from the
+   *                    calling thread
+   */
+  void generate_windows(bool units, const std::function<void(Task&)>& prepare,
+                        const std::function<void(Task&)>& consume);
+
+  unsigned int num_threads_; /**< Number of threads shared by scenarios */
+  std::size_t shard_; /**< Index of shard generated by batch */
+  std::size_t num_shards_; /**< Total number of shards */
+  utilities::JsonFormat json_format_; /**< Formatting options of JSON files */
+  std::vector<std::string> event_names_; /**< Event name of each scenario */
+  std::vector<std::shared_ptr<StochasticModel>>
+      models_; /**< Stochastic model of each scenario */
+};
+}  // namespace stochastic
+
+#endif  // _SCENARIO_BATCH_H_
@@ -0,0 +1,177 @@
+#ifndef _SCRATCH_ARENA_H_
+#define _SCRATCH_ARENA_H_
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+// Eigen dense matrices
+#include <Eigen/Dense>
+
+namespace utilities {
+
+/**
+ * Monotonic buffer for temporary arrays in model hot paths. Allocations are
+ * taken from large blocks by advancing an offset and are released all at
+ * once by rewinding the arena, so steady-state generation does not touch the
+ * heap. Each thread has its own arena, which removes allocator contention
+ * when records are generated in parallel. Buffers are uninitialized and only
+ * hold trivially destructible types.
+ */
+class ScratchArena {
+ public:
+  /**
+   * Position in arena that allocations can be rewound to
+   */
+  struct Marker {
+    std::size_t block; /**< Index of current block */
+    std::size_t offset; /**< Bytes used in current block */
+  };
+
+  /**
+   * Rewinds arena to position at construction when destroyed, releasing all
+   * allocations made within its lifetime. Scopes may be nested.
+   */
+  class Scope {
+   public:
+    /**
+     * @constructor Delete default constructor
+     */
+    Scope() = delete;
+
+    /**
+     * @constructor Construct scope for allocations from input arena
+     * @param[in, out] arena Arena to rewind on destruction
+     */
+    explicit Scope(ScratchArena& arena)
+        : arena_{arena}, marker_{arena.mark()} {};
+
+    /**
+     * @destructor Rewind arena to position at construction
+     */
+    ~Scope() { arena_.rewind(marker_); };
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    ScratchArena& arena_; /**< Arena allocations are taken from */
+    Marker marker_; /**< Position in arena at construction */
+  };
+
+  /**
+   * @constructor Construct arena, allocating first block on first use
+   * @param[in] block_size Size in bytes of first block. Later blocks double
+   *                       in size. Defaults to 1 MiB.
+   */
+  explicit ScratchArena(std::size_t block_size = 1 << 20);
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  /**
+   * Get arena of calling thread
+   * @return Reference to arena owned by calling thread
+   */
+  static ScratchArena& local();
+
+  /**
+   * Allocate uninitialized buffer for input number of values
+   * @tparam T Type of values, which must be trivially destructible
+   * @param[in] num_values Number of values in buffer
+   * @return Pointer to buffer, valid until arena is rewound past it
+   */
+  template <typename T>
+  T* allocate(std::size_t num_values) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "Scratch arena only holds trivially destructible types");
+    return static_cast<T*>(allocate_bytes(num_values * sizeof(T)));
+  }
+
+  /**
+   * Allocate uninitialized vector
+   * @param[in] size Number of entries
+   * @return Map of vector in arena
+   */
+  Eigen::Map<Eigen::VectorXd> vector(std::size_t size) {
+    return Eigen::Map<Eigen::VectorXd>(allocate<double>(size), size);
+  }
+
+  /**
+   * Allocate uninitialized complex vector
+   * @param[in] size Number of entries
+   * @return Map of complex vector in arena
+   */
+  Eigen::Map<Eigen::VectorXcd> complex_vector(std::size_t size) {
+    return Eigen::Map<Eigen::VectorXcd>(
+        allocate<std::complex<double>>(size), size);
+  }
+
+  /**
+   * Allocate uninitialized column-major matrix
+   * @param[in] rows Number of rows
+   * @param[in] cols Number of columns
+   * @return Map of matrix in arena
+   */
+  Eigen::Map<Eigen::MatrixXd> matrix(std::size_t rows, std::size_t cols) {
+    return Eigen::Map<Eigen::MatrixXd>(allocate<double>(rows * cols), rows,
+                                       cols);
+  }
+
+  /**
+   * Get current position in arena
+   * @return Marker for current position
+   */
+  Marker mark() const { return Marker{current_, offset_}; };
+
+  /**
+   * Release all allocations made after input position. Rewinding to the
+   * start merges blocks into a single block of their combined size, so
+   * memory needed by one record is available contiguously for the next.
+   * @param[in] marker Position to rewind to
+   */
+  void rewind(const Marker& marker);
+
+  /**
+   * Release all allocations
+   */
+  void reset() { rewind(Marker{0, 0}); };
+
+  /**
+   * Get total size of blocks held by arena
+   * @return Capacity in bytes
+   */
+  std::size_t capacity() const;
+
+  /**
+   * Get number of blocks held by arena
+   * @return Number of blocks
+   */
+  std::size_t num_blocks() const { return blocks_.size(); };
+
+ private:
+  /**
+   * Allocate uninitialized bytes aligned for vectorized access
+   * @param[in] num_bytes Number of bytes
+   * @return Pointer to aligned bytes
+   */
+  void* allocate_bytes(std::size_t num_bytes);
+
+  /**
+   * Block of memory allocations are taken from
+   */
+  struct Block {
+    std::unique_ptr<char[]> data; /**< Storage, padded for alignment */
+    std::size_t size; /**< Usable size in bytes */
+  };
+
+  static const std::size_t alignment = 64; /**< Alignment of allocations */
+  std::size_t block_size_; /**< Size of first block in bytes */
+  std::vector<Block> blocks_; /**< Blocks held by arena */
+  std::size_t current_; /**< Index of block allocations are taken from */
+  std::size_t offset_; /**< Bytes used in current block */
+};
+}  // namespace utilities
+
+#endif  // _SCRATCH_ARENA_H_
@@ -0,0 +1,113 @@
+#ifndef _SPATIAL_CORRELATION_H_
+#define _SPATIAL_CORRELATION_H_
+
+#include <cstddef>
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/SparseCore>
+
+namespace numeric_utils {
+
+/**
+ * Correlation of standard normal variables at sites in the horizontal plane
+ * that decays exponentially with the distance between sites. The
+ * exponential model is tapered by the compactly supported Wendland function
+ * (1 - r)^4 (4 r + 1), with r the distance divided by the taper length, so
+ * sites further apart than the taper length are uncorrelated. The tapered
+ * correlation matrix is still positive definite and sparse for regions much
+ * larger than the taper length, so it is factored with a sparse Cholesky
+ * decomposition with fill-reducing ordering instead of a dense one over all
+ * sites. Once constructed, correlated variables can be computed
+ * concurrently from multiple threads.
+ */
+class SpatialCorrelation {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  SpatialCorrelation() = delete;
+
+  /**
+   * @constructor Assemble and factor tapered correlation matrix of sites.
+   * Throws exception if coordinates differ in size, lengths are not
+   * positive or the correlation matrix can not be factored, such as for
+   * sites at the same location.
+   * @param[in] x_coordinates x-coordinate of each site in kilometers
+   * @param[in] y_coordinates y-coordinate of each site in kilometers
+   * @param[in] correlation_length Distance in kilometers over which the
+   *                               correlation decays by a factor of e
+   * @param[in] taper_length Distance in kilometers beyond which sites are
+   *                         uncorrelated
+   */
+  SpatialCorrelation(const std::vector<double>& x_coordinates,
+                     const std::vector<double>& y_coordinates,
+                     double correlation_length, double taper_length);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~SpatialCorrelation(){};
+
+  /**
+   * Delete copy constructor
+   */
+  SpatialCorrelation(const SpatialCorrelation&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  SpatialCorrelation& operator=(const SpatialCorrelation&) = delete;
+
+  /**
+   * Get the number of sites
+   * @return Number of sites
+   */
+  std::size_t num_sites() const { return x_coordinates_.size(); };
+
+  /**
+   * Get the number of nonzero entries of the Cholesky factor
+   * @return Number of nonzeros
+   */
+  std::size_t num_nonzeros() const { return factor_.nonZeros(); };
+
+  /**
+   * Evaluate the tapered correlation between two sites
+   * @param[in] first_site Index of first site
+   * @param[in] second_site Index of second site
+   * @return Correlation between sites
+   */
+  double correlation(std::size_t first_site, std::size_t second_site) const;
+
+  /**
+   * Correlate independent standard normal variables, given as one row of
+   * white noise per site. Each column of the result has the tapered
+   * correlation between sites.
+   * @param[in] white_noise Independent standard normal variables with one
+   *                        row per site
+   * @return Correlated standard normal variables with one row per site
+   */
+  Eigen::MatrixXd correlate(const Eigen::MatrixXd& white_noise) const;
+
+  /**
+   * Get the weights of the rows of white noise whose sum gives the
+   * correlated variables of a site, as computed by correlate. Only the rows
+   * with nonzero weights are needed to compute the variables of one site.
+   * @param[in] site Index of site
+   * @param[out] rows Indices of rows of white noise
+   * @param[out] weights Weight of each row, with unit norm overall
+   */
+  void site_weights(std::size_t site, std::vector<std::size_t>& rows,
+                    std::vector<double>& weights) const;
+
+ private:
+  std::vector<double> x_coordinates_; /**< x-coordinate of each site */
+  std::vector<double> y_coordinates_; /**< y-coordinate of each site */
+  double correlation_length_; /**< Length of exponential decay */
+  double taper_length_; /**< Distance beyond which sites are uncorrelated */
+  Eigen::SparseMatrix<double, Eigen::RowMajor>
+      factor_; /**< Lower Cholesky factor of permuted correlation matrix */
+  std::vector<int> factor_rows_; /**< Row of factor of each site */
+};
+}  // namespace numeric_utils
+
+#endif  // _SPATIAL_CORRELATION_H_
@@ -1,10 +1,45 @@
 #ifndef _STOCHASTIC_MODEL_H_
 #define _STOCHASTIC_MODEL_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "acceptance_criteria.h"
 #include "json_object.h"
+#include "profiler.h"
+#include "random_stream.h"
+#include "record_iterator.h"
+#include "response_spectrum.h"
+#include "time_history_block.h"
 
 namespace stochastic {
+/** @enum stochastic::OutputFormat
+ *  @brief is a strongly typed enum class representing the format of files
+ *  written by generate
+ */
+enum class OutputFormat {
+  JSON, /**< Pretty-printed JSON text */
+  Binary, /**< Compact JSON header followed by float64 arrays that can be
+            memory mapped, as written by utilities::BinaryFileWriter */
+  Spectral /**< JSON archive of the spectral representation of records and
+              the keys of their random streams, as created by
+              spectral_archive, from which records are rebuilt on demand */
+};
+
+/** @enum stochastic::Precision
+ *  @brief is a strongly typed enum class representing the floating-point
+ *  precision of synthesis kernels
+ */
+enum class Precision {
+  Double, /**< Kernels compute in double precision */
+  Single /**< Kernels compute in single precision, while records are still
+            returned in double precision */
+};
 
 /**
  * Abstract base class for stochastic models
@@ -37,6 +72,152 @@ class StochasticModel {
    */
   std::string model_name() const { return model_name_; };
 
+  /**
+   * Set the number of threads to use when generating time histories. Results
+   * for a given seed do not depend on the number of threads.
+   * @param[in] num_threads Number of threads to use. A value of 0 uses all
+   *                        available hardware threads. Defaults to 1.
+   */
+  void set_num_threads(unsigned int num_threads) { num_threads_ = num_threads; };
+
+  /**
+   * Get the number of threads used when generating time histories
+   * @return Number of threads
+   */
+  unsigned int num_threads() const { return num_threads_; };
+
+  /**
+   * Set response spectrum calculation to apply to each generated time history
+   * before it is converted to JSON. If set, events include pseudo-spectral
+   * accelerations in the units of the time histories under the key
+   * "responseSpectra". Models that do not generate accelerations ignore it.
+   * @param[in] response_spectrum Response spectrum calculation to use. A null
+   *                              pointer turns off response spectra.
+   */
+  void set_response_spectrum(
+      std::shared_ptr<const numeric_utils::ResponseSpectrum>
+          response_spectrum) {
+    response_spectrum_ = response_spectrum;
+  };
+
+  /**
+   * Set acceptance criteria used to screen time histories as they are
+   * generated. Rejected candidates are discarded before any further
+   * processing and replaced by new candidates until the requested number of
+   * records is reached. Candidates for each record use their own random
+   * streams, so results for a given seed do not depend on the number of
+   * threads.
+   * @param[in] acceptance_criteria Criteria records must satisfy. A null
+   *                                pointer turns off screening.
+   */
+  void set_acceptance_criteria(
+      std::shared_ptr<const AcceptanceCriteria> acceptance_criteria) {
+    acceptance_criteria_ = acceptance_criteria;
+  };
+
+  /**
+   * Set format of files written when generating loading to an output
+   * location. In binary files, time series reference their values by the
+   * keys "dataOffset", the offset in bytes from the start of the data
+   * section, and "numValues" instead of holding them under the key "data".
+   * @param[in] output_format Format of output files. Defaults to JSON.
+   */
+  void set_output_format(OutputFormat output_format) {
+    output_format_ = output_format;
+  };
+
+  /**
+   * Get format of files written when generating loading to an output
+   * location
+   * @return Format of output files
+   */
+  OutputFormat output_format() const { return output_format_; };
+
+  /**
+   * Set formatting options of JSON files written when generating loading to
+   * an output location. Does not affect binary files.
+   * @param[in] json_format Formatting options. Defaults to pretty-printed
+   *                        output with shortest round-trip numbers.
+   */
+  void set_json_format(const utilities::JsonFormat& json_format) {
+    json_format_ = json_format;
+  };
+
+  /**
+   * Get formatting options of JSON files written when generating loading to
+   * an output location
+   * @return Formatting options
+   */
+  const utilities::JsonFormat& json_format() const { return json_format_; };
+
+  /**
+   * Set whether Fast Fourier Transforms are zero-padded to the nearest length
+   * whose only prime factors are 2, 3 and 5, where transforms are fast.
+   * Results are trimmed afterwards, so records keep their lengths, while
+   * their values change slightly for models whose frequency discretization
+   * depends on the transform length.
+   * @param[in] fft_padding Indicates that transforms are padded. Defaults to
+   *                        false, where lengths follow physical durations.
+   */
+  virtual void set_fft_padding(bool fft_padding) {
+    fft_padding_ = fft_padding;
+  };
+
+  /**
+   * Get whether Fast Fourier Transforms are zero-padded to fast lengths
+   * @return Returns true if transforms are padded
+   */
+  bool fft_padding() const { return fft_padding_; };
+
+  /**
+   * Set floating-point precision of synthesis kernels, such as white noise
+   * filtering, spectral factorizations and Fast Fourier Transforms. Single
+   * precision halves memory and bandwidth of the largest intermediate
+   * matrices, at a relative accuracy of about 1e-6. Models without single
+   * precision kernels compute in double precision regardless.
+   * @param[in] precision Precision of kernels. Defaults to double.
+   */
+  void set_precision(Precision precision) { precision_ = precision; };
+
+  /**
+   * Get floating-point precision of synthesis kernels
+   * @return Precision of kernels
+   */
+  Precision precision() const { return precision_; };
+
+  /**
+   * Set whether intermediates that do not depend on random draws, such as
+   * filters and factorizations of cross-spectral densities, are kept between
+   * calls to generate and records, so later calls only pay for sampling and
+   * synthesis. Cached intermediates are recomputed when parameters they
+   * depend on change and released when caching is turned off. Records do
+   * not depend on caching. Models without such intermediates ignore it.
+   * @param[in] deterministic_cache Indicates that intermediates are cached.
+   *                                Defaults to false.
+   */
+  virtual void set_deterministic_cache(bool deterministic_cache) {
+    deterministic_cache_ = deterministic_cache;
+  };
+
+  /**
+   * Get whether intermediates that do not depend on random draws are kept
+   * between calls to generate
+   * @return Returns true if intermediates are cached
+   */
+  bool deterministic_cache() const { return deterministic_cache_; };
+
+  /**
+   * Get time spent in stages of the last call to generate or records, such
+   * as parameter identification, synthesis and filtering, along with counters
+   * such as Fast Fourier Transforms, bytes allocated and objective function
+   * evaluations. Batches generated by iterators add to the profile of the
+   * call to records that created them. Stages and counters are only recorded
+   * when the library is built with BUILD_PROFILING, and are empty otherwise.
+   * @return JsonObject containing "stages", with seconds summed over threads
+   *         and number of calls of each stage, and "counters"
+   */
+  utilities::JsonObject profile() const { return profile_.json(); };
+
   /**
    * Generate loading based on stochastic model and store
    * outputs as JSON object
@@ -49,6 +230,63 @@ class StochasticModel {
   virtual utilities::JsonObject generate(const std::string& event_name,
                                          bool units = false) = 0;
 
+  /**
+   * Generate loading based on stochastic model into contiguous storage,
+   * without creating any JSON
+   * @param[in] event_name Name to assign to event
+   * @param[in, out] metadata Vector to write metadata of each record to
+   * @param[in] units Indicates that time histories should be returned in
+   *                  specific units. These units will depend on the subclass; the input
+   *                  just allows for ensuring outputs are in a certain unit.
+   * @return Block of records with one record per event
+   */
+  virtual utilities::TimeHistoryBlock generate(
+      const std::string& event_name, std::vector<RecordMetadata>& metadata,
+      bool units = false) = 0;
+
+  /**
+   * Get the number of records generated by each call to generate, which is
+   * also the number of records of each iterator returned by records
+   * @return Number of records
+   */
+  virtual std::size_t num_records() const = 0;
+
+  /**
+   * Create iterator that generates loading based on stochastic model on
+   * demand, one batch of records at a time. Model parameters that are
+   * shared by all records are sampled when the iterator is created. The
+   * model must outlive the iterator, and records should not be generated
+   * concurrently by other calls to generate on the same model.
+   * @param[in] event_name Name to assign to event
+   * @param[in] units Indicates that time histories should be returned in
+   *                  specific units. These units will depend on the subclass; the input
+   *                  just allows for ensuring outputs are in a certain unit.
+   * @param[in] batch_size Maximum number of records generated by each call to
+   *                       next of the iterator. A value of 0 uses a default
+   *                       batch size that depends on the subclass.
+   * @return Iterator over records with one record per event
+   */
+  virtual RecordIterator records(const std::string& event_name,
+                                 bool units = false,
+                                 std::size_t batch_size = 0) = 0;
+
+  /**
+   * Create JSON objects describing the events of a block of records, in the
+   * format of the events written by generate
+   * @param[in] event_name Name to assign to events
+   * @param[in] records Block of records generated by this model
+   * @param[in] first_record Index of first record in block among all records
+   * @param[in] data_offsets Offsets of components of records in data section
+   *                         of binary file, ordered by record and then by
+   *                         component. If given, time series reference their
+   *                         values by offset. Defaults to null.
+   * @return Vector of JsonObjects containing one event per record
+   */
+  virtual std::vector<utilities::JsonObject> events_json(
+      const std::string& event_name, const utilities::TimeHistoryBlock& records,
+      std::size_t first_record,
+      const std::vector<std::size_t>* data_offsets = nullptr) const = 0;
+
   /**
    * Generate loading based on stochastic model and write
    * results to file in JSON format
@@ -63,8 +301,285 @@ class StochasticModel {
                         const std::string& output_location,
                         bool units = false) = 0;
 
+  /**
+   * Create iterator over simulations appended to the campaign of the last
+   * call to generate or records. Model parameters shared by the records of
+   * that call and its random streams are kept, so only the appended records
+   * are generated, and together with the records generated before they
+   * equal the records of a single call with the larger number of
+   * simulations. The number of simulations of the model grows by the input
+   * number, so later calls to generate produce campaigns of the larger size
+   * and later calls to append extend the grown campaign. Iterators created
+   * by earlier calls must not be used afterwards. Throws exception if the
+   * model does not support appending, no records have been generated yet or
+   * acceptance criteria are set, since candidates of screened records
+   * depend on the number of simulations.
+   * @param[in] event_name Name to assign to event
+   * @param[in] num_sims Number of simulations to append for each set of
+   *                     shared model parameters
+   * @param[in] units Indicates that time histories should be returned in
+   *                  specific units. These units will depend on the subclass; the input
+   *                  just allows for ensuring outputs are in a certain unit.
+   * @param[in] batch_size Maximum number of records generated by each call to
+   *                       next of the iterator. A value of 0 uses a default
+   *                       batch size that depends on the subclass.
+   * @return Iterator over appended records, in the order of the records of
+   *         a single call with the larger number of simulations
+   */
+  virtual RecordIterator append_records(const std::string& event_name,
+                                        unsigned int num_sims,
+                                        bool units = false,
+                                        std::size_t batch_size = 0) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::StochasticModel::append_records: " +
+        model_name_ + " does not support appending simulations\n");
+  };
+
+  /**
+   * Append simulations to the campaign of the last call to generate or
+   * records as described for append_records and add their events to the
+   * file written by that call in the current output format. JSON files must
+   * have been written with the current formatting options. Throws exception
+   * if the model does not support appending or errors are encountered
+   * during time history generation or when writing.
+   * @param[in] event_name Name to assign to event
+   * @param[in] output_location Location of file to append events to
+   * @param[in] num_sims Number of simulations to append for each set of
+   *                     shared model parameters
+   * @param[in] units Indicates that time histories should be returned in
+   *                  specific units. These units will depend on the subclass; the input
+   *                  just allows for ensuring outputs are in a certain unit.
+   * @return Returns true if successful, false otherwise
+   */
+  virtual bool append(const std::string& event_name,
+                      const std::string& output_location,
+                      unsigned int num_sims, bool units = false) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::StochasticModel::append: " + model_name_ +
+        " does not support appending simulations\n");
+  };
+
+  /**
+   * Create archive of the records that a call to generate would produce,
+   * holding only the data the records are synthesized from, such as
+   * identified model parameters of each spectrum, and the seed and indices
+   * of the random stream of each record instead of the time histories. The
+   * archive is written by generate when the output format is
+   * OutputFormat::Spectral. Throws exception if the model does not support
+   * spectral archives or acceptance criteria are set, since screened
+   * records are only known once synthesized.
+   * @param[in] event_name Name to assign to event
+   * @param[in] units Indicates that time histories should be returned in
+   *                  specific units. These units will depend on the subclass; the input
+   *                  just allows for ensuring outputs are in a certain unit.
+   * @return JsonObject with the name of the model under "model", the seed of
+   *         random streams under "streamSeed", the units flag under "units"
+   *         and the "name", stream indices and "numSteps" of each record
+   *         under "records", along with data specific to the subclass
+   */
+  virtual utilities::JsonObject spectral_archive(
+      const std::string& event_name, bool units = false) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::StochasticModel::spectral_archive: " +
+        model_name_ + " does not support spectral archives\n");
+  };
+
+  /**
+   * Rebuild a range of records from a spectral archive created by a model
+   * constructed with the same inputs. Rebuilt records equal the records of
+   * the call to generate the archive describes. Throws exception if the
+   * model does not support spectral archives, the archive was created by a
+   * different model or the range is out of bounds.
+   * @param[in] archive Spectral archive of records
+   * @param[in] first_record Index of first record to rebuild
+   * @param[in] num_records Number of records to rebuild
+   * @return Block of rebuilt records, in the order of the archive
+   */
+  virtual utilities::TimeHistoryBlock rebuild_records(
+      const utilities::JsonObject& archive, std::size_t first_record,
+      std::size_t num_records) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::StochasticModel::rebuild_records: " +
+        model_name_ + " does not support spectral archives\n");
+  };
+
+  /**
+   * Rebuild a window of time steps of a single record from a spectral
+   * archive, as described for rebuild_records
+   * @param[in] archive Spectral archive of records
+   * @param[in] record Index of record to rebuild
+   * @param[in] first_step Index of first time step of window. Defaults to 0.
+   * @param[in] num_steps Number of time steps in window. Defaults to all
+   *                      time steps of the record.
+   * @return Block holding the window of the rebuilt record
+   */
+  utilities::TimeHistoryBlock rebuild_record(
+      const utilities::JsonObject& archive, std::size_t record,
+      std::size_t first_step = 0,
+      std::size_t num_steps = std::numeric_limits<std::size_t>::max()) {
+    return rebuild_records(archive, record, 1).window(first_step, num_steps);
+  };
+
  protected:
+  /**
+   * Get contents of a spectral archive after checking that it was created by
+   * this model for its number of records and holds the input range of
+   * records. Throws exception otherwise.
+   * @param[in] archive Spectral archive of records
+   * @param[in] first_record Index of first record of range
+   * @param[in] num_range_records Number of records in range
+   * @return Library JSON object of archive
+   */
+  utilities::json archive_contents(const utilities::JsonObject& archive,
+                                   std::size_t first_record,
+                                   std::size_t num_range_records) const {
+    auto contents = archive.get_library_json();
+    auto model = contents.find("model");
+    auto records = contents.find("records");
+    if (model == contents.end() || *model != model_name_ ||
+        contents.find("streamSeed") == contents.end() ||
+        contents.find("units") == contents.end() ||
+        records == contents.end() || !records->is_array()) {
+      throw std::runtime_error(
+          "\nERROR: in stochastic::StochasticModel::archive_contents: "
+          "Archive is not a spectral archive of " + model_name_ + "\n");
+    }
+    if (records->size() != num_records()) {
+      throw std::runtime_error(
+          "\nERROR: in stochastic::StochasticModel::archive_contents: "
+          "Number of records of archive does not match model\n");
+    }
+    if (first_record + num_range_records > records->size()) {
+      throw std::runtime_error(
+          "\nERROR: in stochastic::StochasticModel::archive_contents: "
+          "Records are out of range of archive\n");
+    }
+    return contents;
+  };
+
+  /**
+   * Create JSON object describing response spectra of the two components of
+   * an event
+   * @param[in] spectrum_x Response spectrum of x component
+   * @param[in] spectrum_y Response spectrum of y component
+   * @return JsonObject containing periods, damping ratios and pseudo-spectral
+   *         accelerations for each damping ratio
+   */
+  utilities::JsonObject response_spectra_json(
+      const Eigen::MatrixXd& spectrum_x,
+      const Eigen::MatrixXd& spectrum_y) const {
+    auto to_rows = [](const Eigen::MatrixXd& spectrum) {
+      std::vector<std::vector<double>> rows(spectrum.rows());
+      for (unsigned int i = 0; i < spectrum.rows(); ++i) {
+        rows[i].resize(spectrum.cols());
+        Eigen::RowVectorXd::Map(rows[i].data(), spectrum.cols()) =
+            spectrum.row(i);
+      }
+      return rows;
+    };
+
+    auto spectra = utilities::JsonObject();
+    spectra.add_value("periods", response_spectrum_->periods());
+    spectra.add_value("dampingRatios", response_spectrum_->damping_ratios());
+    spectra.add_value("accel_x", to_rows(spectrum_x));
+    spectra.add_value("accel_y", to_rows(spectrum_y));
+    return spectra;
+  };
+
+  /**
+   * Create JSON object describing a seismic event with x- and y-components of
+   * acceleration stored as the two components of a record. Response spectra
+   * of both components are added if requested. This is safe to call
+   * concurrently.
+   * @param[in] name Name to assign to event
+   * @param[in] records Block of records containing event
+   * @param[in] record Index of record for event
+   * @param[in] data_offsets Offsets of x- and y-components in data section
+   *                         of binary file. If given, time series reference
+   *                         their values by offset instead of holding them.
+   *                         Defaults to null.
+   * @return JsonObject containing event
+   */
+  utilities::JsonObject seismic_event_json(
+      const std::string& name, const utilities::TimeHistoryBlock& records,
+      std::size_t record, const std::size_t* data_offsets = nullptr) const {
+    auto pattern_x = utilities::JsonObject();
+    auto pattern_y = utilities::JsonObject();
+    pattern_x.add_value("type", "UniformAcceleration");
+    pattern_x.add_value("timeSeries", "accel_x");
+    pattern_x.add_value("dof", 1);
+    pattern_y.add_value("type", "UniformAcceleration");
+    pattern_y.add_value("timeSeries", "accel_y");
+    pattern_y.add_value("dof", 2);
+
+    auto event_data = utilities::JsonObject();
+    event_data.add_value("name", name);
+    event_data.add_value("type", "Seismic");
+    event_data.add_value("dT", records.time_step());
+    event_data.add_value("numSteps", records.num_steps(record));
+    event_data.add_value(
+        "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
+
+    // Add time histories for x and y directions to event
+    auto time_history_x = utilities::JsonObject();
+    auto time_history_y = utilities::JsonObject();
+    time_history_x.add_value("name", "accel_x");
+    time_history_x.add_value("type", "Value");
+    time_history_x.add_value("dT", records.time_step());
+    time_history_y.add_value("name", "accel_y");
+    time_history_y.add_value("type", "Value");
+    time_history_y.add_value("dT", records.time_step());
+    if (data_offsets) {
+      time_history_x.add_value("dataOffset", data_offsets[0]);
+      time_history_x.add_value("numValues", records.num_steps(record));
+      time_history_y.add_value("dataOffset", data_offsets[1]);
+      time_history_y.add_value("numValues", records.num_steps(record));
+    } else {
+      time_history_x.add_array("data", records.data(record, 0),
+                               records.num_steps(record));
+      time_history_y.add_array("data", records.data(record, 1),
+                               records.num_steps(record));
+    }
+    event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
+                                           time_history_x, time_history_y});
+
+    if (response_spectrum_) {
+      event_data.add_value(
+          "responseSpectra",
+          response_spectra_json(
+              response_spectrum_->compute(records.data(record, 0),
+                                          records.num_steps(record)),
+              response_spectrum_->compute(records.data(record, 1),
+                                          records.num_steps(record))));
+    }
+
+    return event_data;
+  };
+
   std::string model_name_ = "StochasticModel"; /**< Name of stochastic model */  
+  unsigned int num_threads_ = 1; /**< Number of threads to use for generation */
+  std::shared_ptr<const numeric_utils::ResponseSpectrum>
+      response_spectrum_; /**< Response spectrum calculation applied to
+                             generated time histories, if any */
+  std::shared_ptr<const AcceptanceCriteria>
+      acceptance_criteria_; /**< Criteria used to screen generated time
+                               histories, if any */
+  OutputFormat output_format_ =
+      OutputFormat::JSON; /**< Format of files written by generate */
+  utilities::JsonFormat json_format_; /**< Formatting options of JSON files */
+  bool fft_padding_ = false; /**< Indicates that FFTs are padded to lengths
+                                with only factors 2, 3 and 5 */
+  Precision precision_ =
+      Precision::Double; /**< Floating-point precision of kernels */
+  bool deterministic_cache_ = false; /**< Indicates that intermediates that do
+                                        not depend on random draws are kept
+                                        between calls to generate */
+  utilities::Profile profile_; /**< Stage times and counters of last call to
+                                  generate or records */
+  std::uint64_t stream_seed_ = numeric_utils::stream_seed(
+      std::numeric_limits<int>::infinity()); /**< Seed of random streams for current call to generate. Streams
+             are keyed by this seed and the spectrum, simulation and
+             component indices. */
 };
 }  // namespace stochastic
 
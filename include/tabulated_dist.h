@@ -0,0 +1,185 @@
+#ifndef _TABULATED_DIST_H_
+#define _TABULATED_DIST_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "distribution.h"
+
+namespace stochastic {
+/**
+ * Wrapper for distributions with expensive inverse cumulative distribution
+ * functions. The inverse CDF is tabulated once as a function of the standard
+ * normal variable on a uniform grid and evaluated with monotone piecewise
+ * cubic Hermite interpolation. The grid is refined until the interpolation
+ * error at the interval midpoints is below the requested maximum error.
+ * Values outside of the table range and the CDF are evaluated exactly using
+ * the wrapped distribution.
+ */
+class TabulatedDistribution : public Distribution {
+ public:
+  /**
+   * @constructor Delete default constructor
+   */
+  TabulatedDistribution() = delete;
+
+  /**
+   * @constructor Construct tabulated inverse CDF for input distribution
+   * @param[in] distribution Distribution to tabulate inverse CDF of
+   * @param[in] max_error Maximum interpolation error relative to the magnitude
+   *                      of the inverse CDF, or absolute for magnitudes less
+   *                      than one. Defaults to 1.0e-6.
+   */
+  TabulatedDistribution(std::shared_ptr<Distribution> distribution,
+                        double max_error = 1.0e-6);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~TabulatedDistribution(){};
+
+  /**
+   * Get the name of the distribution model
+   * @return Model name as a string
+   */
+  std::string name() const override {
+    return "Tabulated" + distribution_->name();
+  };
+
+  /**
+   * Compute the cumulative distribution function (CDF) of the distribution at
+   * specified input locations
+   * @param[in] locations Vector containing locations at which to
+   *                      calculate CDF
+   * @return Vector of evaluated values of CDF at input locations
+   */
+  std::vector<double> cumulative_dist_func(
+      const std::vector<double>& locations) const override;
+
+  /**
+   * Compute the inverse cumulative distribution function (ICDF) of the
+   * distribution at specified input locations
+   * @param[in] probabilities Vector containing probabilities at which to
+   *                          calculate ICDF
+   * @return Vector of evaluated values of ICDF at input locations
+   */
+  std::vector<double> inv_cumulative_dist_func(
+      const std::vector<double>& probabilities) const override;
+
+  /**
+   * Compute the cumulative distribution function (CDF) of the distribution at
+   * specified input locations, writing results to caller-owned buffer
+   * @param[in] locations Pointer to locations at which to calculate CDF
+   * @param[in, out] evaluations Pointer to buffer to write evaluated values of
+   *                             CDF to. May be the same as locations.
+   * @param[in] num_values Number of locations
+   */
+  void cumulative_dist_func(const double* locations, double* evaluations,
+                            std::size_t num_values) const override;
+
+  /**
+   * Compute the inverse cumulative distribution function (ICDF) of the
+   * distribution at specified input probabilities, writing results to
+   * caller-owned buffer
+   * @param[in] probabilities Pointer to probabilities at which to calculate
+   *                          ICDF
+   * @param[in, out] evaluations Pointer to buffer to write evaluated values of
+   *                             ICDF to. May be the same as probabilities.
+   * @param[in] num_values Number of probabilities
+   */
+  void inv_cumulative_dist_func(const double* probabilities,
+                                double* evaluations,
+                                std::size_t num_values) const override;
+
+  /**
+   * Transform realizations of a standard normal random variable to this
+   * distribution by interpolating in the table directly
+   * @param[in] std_normal_values Pointer to standard normal values to
+   *                              transform
+   * @param[in, out] evaluations Pointer to buffer to write transformed values
+   *                             to. May be the same as std_normal_values.
+   * @param[in] num_values Number of values to transform
+   */
+  void transform_from_std_normal(const double* std_normal_values,
+                                 double* evaluations,
+                                 std::size_t num_values) const override;
+
+  /**
+   * Get the number of points in the table
+   * @return Number of table points
+   */
+  std::size_t table_size() const { return values_.size(); };
+
+ protected:
+  /**
+   * Interpolate inverse CDF at input standard normal value
+   * @param[in] std_normal_value Standard normal value
+   * @return Interpolated value of inverse CDF
+   */
+  double interpolate(double std_normal_value) const;
+
+  /**
+   * Calculate monotone slopes for the current table values after Fritsch and
+   * Butland (1984)
+   */
+  void calculate_slopes();
+
+  std::shared_ptr<Distribution> distribution_; /**< Tabulated distribution */
+  double max_error_; /**< Maximum interpolation error */
+  double std_normal_min_; /**< Standard normal value at start of table */
+  double std_normal_max_; /**< Standard normal value at end of table */
+  double step_; /**< Spacing of standard normal values in table */
+  std::vector<double> values_; /**< Inverse CDF at table points */
+  std::vector<double> slopes_; /**< Derivative of inverse CDF with respect to
+                                  standard normal value at table points */
+};
+
+/**
+ * Beta distribution with tabulated inverse CDF
+ */
+class TabulatedBetaDistribution : public TabulatedDistribution {
+ public:
+  /**
+   * @constructor Construct tabulated beta distribution
+   * @param[in] alpha Shape parameter
+   * @param[in] beta Shape parameter
+   * @param[in] max_error Maximum interpolation error. Defaults to 1.0e-6.
+   */
+  TabulatedBetaDistribution(double alpha, double beta,
+                            double max_error = 1.0e-6);
+};
+
+/**
+ * Inverse Gaussian distribution with tabulated inverse CDF
+ */
+class TabulatedInverseGaussianDistribution : public TabulatedDistribution {
+ public:
+  /**
+   * @constructor Construct tabulated inverse Gaussian distribution
+   * @param[in] mean Mean of distribution
+   * @param[in] std_dev Standard deviation of distribution
+   * @param[in] max_error Maximum interpolation error. Defaults to 1.0e-6.
+   */
+  TabulatedInverseGaussianDistribution(double mean, double std_dev,
+                                       double max_error = 1.0e-6);
+};
+
+/**
+ * Student's t distribution with tabulated inverse CDF
+ */
+class TabulatedStudentstDistribution : public TabulatedDistribution {
+ public:
+  /**
+   * @constructor Construct tabulated Student's t distribution
+   * @param[in] mean Mean of distribution
+   * @param[in] std_dev Standard deviation of distribution
+   * @param[in] dof Degrees of freedom
+   * @param[in] max_error Maximum interpolation error. Defaults to 1.0e-6.
+   */
+  TabulatedStudentstDistribution(double mean, double std_dev, double dof,
+                                 double max_error = 1.0e-6);
+};
+}  // namespace stochastic
+
+#endif  // _TABULATED_DIST_H_
@@ -0,0 +1,157 @@
+#ifndef _TIME_HISTORY_BLOCK_H_
+#define _TIME_HISTORY_BLOCK_H_
+
+#include <cstddef>
+#include <vector>
+// Eigen dense matrices
+#include <Eigen/Dense>
+
+namespace utilities {
+
+/**
+ * Contiguous storage for a set of records, each with the same number of
+ * components sampled at the same time step. Records are stored one after
+ * the other and the components of each record are stored one after the
+ * other, so each component is contiguous and each record can be viewed as a
+ * column-major matrix with one column per component. Records may have
+ * different numbers of time steps.
+ */
+class TimeHistoryBlock {
+ public:
+  /**
+   * @constructor Construct empty block without any records
+   */
+  TimeHistoryBlock();
+
+  /**
+   * @constructor Construct zero-initialized block of records with equal
+   * numbers of time steps
+   * @param[in] num_records Number of records
+   * @param[in] num_components Number of components per record
+   * @param[in] num_steps Number of time steps in each record
+   * @param[in] time_step Time step of records
+   */
+  TimeHistoryBlock(std::size_t num_records, std::size_t num_components,
+                   std::size_t num_steps, double time_step);
+
+  /**
+   * @constructor Construct zero-initialized block of records with input
+   * numbers of time steps
+   * @param[in] num_steps Number of time steps in each record
+   * @param[in] num_components Number of components per record
+   * @param[in] time_step Time step of records
+   */
+  TimeHistoryBlock(const std::vector<std::size_t>& num_steps,
+                   std::size_t num_components, double time_step);
+
+  /**
+   * Get the number of records
+   * @return Number of records
+   */
+  std::size_t num_records() const { return num_steps_.size(); };
+
+  /**
+   * Get the number of components per record
+   * @return Number of components
+   */
+  std::size_t num_components() const { return num_components_; };
+
+  /**
+   * Get the number of time steps in a record
+   * @param[in] record Index of record
+   * @return Number of time steps
+   */
+  std::size_t num_steps(std::size_t record) const {
+    return num_steps_[record];
+  };
+
+  /**
+   * Get the time step of records
+   * @return Time step
+   */
+  double time_step() const { return time_step_; };
+
+  /**
+   * Get the total number of values stored for all records
+   * @return Number of values
+   */
+  std::size_t size() const { return values_.size(); };
+
+  /**
+   * Get pointer to first time step of a record component
+   * @param[in] record Index of record
+   * @param[in] component Index of component
+   * @return Pointer to contiguous component values
+   */
+  double* data(std::size_t record, std::size_t component) {
+    return values_.data() + offsets_[record] +
+           component * num_steps_[record];
+  };
+
+  /**
+   * Get pointer to first time step of a record component
+   * @param[in] record Index of record
+   * @param[in] component Index of component
+   * @return Pointer to contiguous component values
+   */
+  const double* data(std::size_t record, std::size_t component) const {
+    return values_.data() + offsets_[record] +
+           component * num_steps_[record];
+  };
+
+  /**
+   * Get view of all components of a record
+   * @param[in] record Index of record
+   * @return Map of matrix with one row per time step and one column per
+   *         component
+   */
+  Eigen::Map<Eigen::MatrixXd> record(std::size_t record) {
+    return Eigen::Map<Eigen::MatrixXd>(data(record, 0), num_steps_[record],
+                                       num_components_);
+  };
+
+  /**
+   * Get view of all components of a record
+   * @param[in] record Index of record
+   * @return Map of matrix with one row per time step and one column per
+   *         component
+   */
+  Eigen::Map<const Eigen::MatrixXd> record(std::size_t record) const {
+    return Eigen::Map<const Eigen::MatrixXd>(
+        data(record, 0), num_steps_[record], num_components_);
+  };
+
+  /**
+   * Copy a record component into a vector
+   * @param[in] record Index of record
+   * @param[in] component Index of component
+   * @return Vector of component values
+   */
+  std::vector<double> component(std::size_t record,
+                                 std::size_t component) const;
+
+  /**
+   * Copy a window of time steps of all records into a new block. Records
+   * shorter than the end of the window are copied up to their last step.
+   * @param[in] first_step Index of first time step of window
+   * @param[in] num_steps Number of time steps in window
+   * @return Block of records holding only the time steps in window
+   */
+  TimeHistoryBlock window(std::size_t first_step, std::size_t num_steps) const;
+
+  /**
+   * Get raw storage of all records
+   * @return Reference to contiguous values of all records
+   */
+  const std::vector<double>& values() const { return values_; };
+
+ private:
+  std::size_t num_components_; /**< Number of components per record */
+  double time_step_; /**< Time step of records */
+  std::vector<std::size_t> num_steps_; /**< Time steps in each record */
+  std::vector<std::size_t> offsets_; /**< Offset of start of each record */
+  std::vector<double> values_; /**< Values of all records */
+};
+}  // namespace utilities
+
+#endif  // _TIME_HISTORY_BLOCK_H_
@@ -1,16 +1,34 @@
 #ifndef _VLACHOS_ET_AL_H_
 #define _VLACHOS_ET_AL_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 #include <Eigen/Dense>
+#include "convolver.h"
 #include "distribution.h"
 #include "json_object.h"
 #include "numeric_utils.h"
+#include "spatial_correlation.h"
 #include "stochastic_model.h"
+#include "time_history_block.h"
 
 namespace stochastic {
+/** @enum stochastic::SynthesisMethod
+ *  @brief is a strongly typed enum class representing the method used to
+ *  synthesize time histories from the evolutionary power spectrum
+ */
+enum class SynthesisMethod {
+  DirectSum, /**< Exact summation of cosines over all times and frequencies */
+  OverlapAddFFT, /**< Piecewise-stationary windows synthesized with inverse
+                    FFT and joined by overlap-add */
+  LowRank /**< Separable low-rank approximation of the spectrum amplitude,
+             with each term synthesized exactly using FFTs */
+};
+
 /**
  * Stochastic model for generating scenario specific ground
  * motion time histories. This is based on the paper:
@@ -68,6 +86,36 @@ class VlachosEtAl : public StochasticModel {
               double orientation, unsigned int num_spectra,
               unsigned int num_sims, int seed_value);  
 
+  /**
+   * @constructor Construct scenario specific ground motion model with
+   * standard normal variables given for the model parameters of each
+   * spectrum instead of drawn independently, such as variables correlated
+   * with those of other sites. The variables are transformed to model
+   * parameters with the Cholesky factor of the parameter covariance.
+   * Throws exception if there are not 18 variables per spectrum.
+   * @param[in] moment_magnitude Moment magnitude of earthquake scenario
+   * @param[in] rupture_distance Closest-to-site rupture distance in kilometers
+   * @param[in] vs30 Soil shear wave velocity averaged over top 30 meters in
+   *                 meters per second
+   * @param[in] orientation Orientation of acceleration relative to global
+   *                        coordinates. Represents counter-clockwise angle (in
+   *                        degrees) away from x-axis rotating around z-axis in
+   *                        right-handed coordinate system.
+   * @param[in] standard_normal_parameters Standard normal variables of model
+   *                                       parameters with one row per
+   *                                       spectrum and one column per
+   *                                       parameter
+   * @param[in] num_sims Number of simulated ground motion time histories that
+   *                     should be generated per evolutionary power
+   * @param[in] stream_seed Seed of the random streams of all random variables
+   *                        of the model, such as one derived from the seed
+   *                        of a region and the index of a site
+   */
+  VlachosEtAl(double moment_magnitude, double rupture_distance, double vs30,
+              double orientation,
+              const Eigen::MatrixXd& standard_normal_parameters,
+              unsigned int num_sims, std::uint64_t stream_seed);
+
   /**
    * @destructor Virtual destructor
    */
@@ -83,6 +131,18 @@ class VlachosEtAl : public StochasticModel {
    */
   VlachosEtAl& operator=(const VlachosEtAl&) = delete;
 
+  /**
+   * Generate ground motion time histories based on input parameters into
+   * contiguous storage. Throws exception if errors are encountered during
+   * time history generation.
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return Block with one record per event, ordered by spectrum and then
+   *         by simulation, each with x- and y-components of acceleration
+   */
+  utilities::TimeHistoryBlock generate_records(bool units = false);
+
   /**
    * Generate ground motion time histories based on input parameters
    * and store outputs as JSON object. Throws exception if errors
@@ -96,6 +156,65 @@ class VlachosEtAl : public StochasticModel {
   utilities::JsonObject generate(const std::string& event_name,
                                  bool units = false) override;
 
+  /**
+   * Generate ground motion time histories based on input parameters into
+   * contiguous storage, without creating any JSON. Throws exception if errors
+   * are encountered during time history generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in, out] metadata Vector to write metadata of each record to
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return Block with one record per event, in the order of the events
+   *         returned as JSON, with x- and y-components of acceleration
+   */
+  utilities::TimeHistoryBlock generate(const std::string& event_name,
+                                       std::vector<RecordMetadata>& metadata,
+                                       bool units = false) override;
+
+  /**
+   * Get the number of records generated by each call to generate
+   * @return Number of records, which is the number of spectra times the
+   *         number of simulations per spectrum
+   */
+  std::size_t num_records() const override;
+
+  /**
+   * Create iterator that generates ground motion time histories on demand.
+   * Model parameters of all spectra are identified when the iterator is
+   * created, while evolutionary power spectra are computed for the spectra
+   * of each batch as it is generated. Throws exception if errors are
+   * encountered during time history generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @param[in] batch_size Maximum number of records per batch. Defaults to
+   *                       0, which generates the family of records of one
+   *                       spectrum per batch.
+   * @return Iterator over records in the order of the events returned as
+   *         JSON, with x- and y-components of acceleration
+   */
+  RecordIterator records(const std::string& event_name, bool units = false,
+                         std::size_t batch_size = 0) override;
+
+  /**
+   * Create JSON objects for events of a block of records. Events are created
+   * concurrently using the number of threads of the model.
+   * @param[in] event_name Name to assign to events
+   * @param[in] records Block of records
+   * @param[in] first_record Index of first record in block among all records
+   * @param[in] data_offsets Offsets of components of records in data section
+   *                         of binary file, ordered by record and then by
+   *                         component. If given, time series reference their
+   *                         values by offset. Defaults to null.
+   * @return Vector of JsonObjects containing events
+   */
+  std::vector<utilities::JsonObject> events_json(
+      const std::string& event_name, const utilities::TimeHistoryBlock& records,
+      std::size_t first_record,
+      const std::vector<std::size_t>* data_offsets = nullptr) const override;
+
   /**
    * Generate ground motion time histories based on input parameters
    * and write results to file in JSON format. Throws exception if
@@ -112,15 +231,148 @@ class VlachosEtAl : public StochasticModel {
                 bool units = false) override;
 
   /**
-   * Compute a family of time histories for a particular power spectrum
+   * Create iterator over simulations appended to the family of each spectrum
+   * of the last call to generate or records, reusing its identified model
+   * parameters and random streams. Throws exception if no records have been
+   * generated yet, acceptance criteria are set or errors are encountered
+   * during time history generation.
+   * @param[in] event_name Name to assign to event
+   * @param[in] num_sims Number of simulations to append per spectrum
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @param[in] batch_size Maximum number of records per batch. Defaults to
+   *                       0, which generates the appended records of one
+   *                       spectrum per batch.
+   * @return Iterator over appended records, in the order of the events of a
+   *         single call with the larger number of simulations
+   */
+  RecordIterator append_records(const std::string& event_name,
+                                unsigned int num_sims, bool units = false,
+                                std::size_t batch_size = 0) override;
+
+  /**
+   * Append simulations to the family of each spectrum of the last call to
+   * generate or records and add their events to the file written by that
+   * call, one spectrum at a time. Throws exception if no records have been
+   * generated yet, acceptance criteria are set or errors are encountered
+   * during time history generation or when writing.
+   * @param[in] event_name Name to assign to event
+   * @param[in] output_location Location of file to append events to
+   * @param[in] num_sims Number of simulations to append per spectrum
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return Returns true if successful, false otherwise
+   */
+  bool append(const std::string& event_name,
+              const std::string& output_location, unsigned int num_sims,
+              bool units = false) override;
+
+  /**
+   * Create archive of the records that a call to generate would produce,
+   * holding the identified model parameters of each spectrum under
+   * "spectra", the number of simulations per spectrum under "numSims" and
+   * the spectrum and simulation indices of the random stream of each record.
+   * Parameters are identified as by generate, while no power spectra or time
+   * histories are computed. Throws exception if acceptance criteria are set.
+   * @param[in] event_name Name to assign to event
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Defaults to false where time histories
+   *                  are returned in units of m/s^2
+   * @return JsonObject containing spectral archive
+   */
+  utilities::JsonObject spectral_archive(const std::string& event_name,
+                                         bool units = false) override;
+
+  /**
+   * Rebuild a range of records from a spectral archive, computing only the
+   * power spectra of the spectra the range touches. Throws exception if the
+   * archive was not created by a model with the same number of spectra and
+   * simulations, or the range is out of bounds.
+   * @param[in] archive Spectral archive of records
+   * @param[in] first_record Index of first record to rebuild
+   * @param[in] num_records Number of records to rebuild
+   * @return Block of rebuilt records with x- and y-components of
+   *         acceleration
+   */
+  utilities::TimeHistoryBlock rebuild_records(
+      const utilities::JsonObject& archive, std::size_t first_record,
+      std::size_t num_records) override;
+
+  /**
+   * Set the method used to synthesize time histories from the evolutionary
+   * power spectrum. Defaults to SynthesisMethod::DirectSum.
+   * @param[in] method Synthesis method to use
+   * @param[in] window_length Number of time steps in each overlap-add
+   *                          window. Must be even since windows overlap by
+   *                          half their length. Only used for
+   *                          SynthesisMethod::OverlapAddFFT. Defaults to 200.
+   */
+  void set_synthesis_method(SynthesisMethod method,
+                            unsigned int window_length = 200);
+
+  /**
+   * Set the tolerance for the low-rank approximation of the square root of
+   * the evolutionary power spectrum used by SynthesisMethod::LowRank. The
+   * rank is the smallest one for which the Frobenius norm of the
+   * approximation error is at most tolerance times the Frobenius norm of the
+   * spectrum amplitude. Since the random phases are independent, the
+   * expected energy of the difference from the direct summation is then at
+   * most tolerance squared times the expected energy of the time history.
+   * Defaults to 1.0e-3.
+   * @param[in] tolerance Relative tolerance in the range [0, 1)
+   */
+  void set_low_rank_tolerance(double tolerance);
+
+  /**
+   * Set whether Fast Fourier Transforms are zero-padded to fast lengths,
+   * discarding the cached highpass filter built for the previous setting
+   * @param[in] fft_padding Indicates that transforms are padded
+   */
+  void set_fft_padding(bool fft_padding) override;
+
+  /**
+   * Set whether the frequency grid, the energy of the highpass Butterworth
+   * filter at each frequency and the highpass filter itself are kept
+   * between calls to generate
+   * @param[in] deterministic_cache Indicates that intermediates are cached
+   */
+  void set_deterministic_cache(bool deterministic_cache) override;
+
+  /**
+   * Set spatially correlated field that phase angles are drawn from. For
+   * each simulation and frequency, the phase angles of all sites of the field
+   * are transformed from correlated standard normal variables, which are
+   * weighted sums of white noise with one random stream per row of the
+   * factor of the spatial correlation. Phase angles of each site remain
+   * uniformly distributed between 0 and 2 pi. Throws exception if the site
+   * is not a site of the field.
+   * @param[in] phase_field Spatial correlation of sites. A null pointer draws
+   *                        phase angles independently again.
+   * @param[in] site Index of the site of this model in the field
+   * @param[in] seed Seed of random streams of the field shared by all sites
+   */
+  void set_phase_field(
+      std::shared_ptr<const numeric_utils::SpatialCorrelation> phase_field,
+      std::size_t site, std::uint64_t seed);
+
+  /**
+   * Compute a family of time histories for a particular power spectrum. If
+   * the parameters are rejected, candidates are drawn from the sample
+   * generator of the model, so calls on the same model must not run
+   * concurrently.
    * @param[in, out] time_histories Location where time histories should be
    *                                stored
    * @param[in] parameters Set of model parameters to use for calculating power
    *                       specturm and time histories
+   * @param[in] spectrum_index Index of spectrum used to select random streams.
+   *                           Defaults to 0.
    * @return Returns true if successful, false otherwise
    */
   bool time_history_family(std::vector<std::vector<double>>& time_histories,
-                           const Eigen::VectorXd& parameters) const;
+                           const Eigen::VectorXd& parameters,
+                           unsigned int spectrum_index = 0);
 
   /**
    * Simulate fully non-stationary ground motion sample realization based on
@@ -129,9 +381,95 @@ class VlachosEtAl : public StochasticModel {
    * @param[in, out] time_history Location where time history should be stored
    * @param[in] power_spectrum Matrix containing values of power spectrum over
    *                           range of frequencies at specified times.
+   * @param[in] spectrum_index Index of spectrum used to select random stream.
+   *                           Defaults to 0.
+   * @param[in] sim_index Index of simulation used to select random stream.
+   *                      Defaults to 0.
    */
   void simulate_time_history(std::vector<double>& time_history,
-                             const Eigen::MatrixXd& power_spectrum) const;
+                             const Eigen::MatrixXd& power_spectrum,
+                             unsigned int spectrum_index = 0,
+                             unsigned int sim_index = 0) const;
+
+  /**
+   * Synthesize time history by treating the evolutionary power spectrum as
+   * stationary over Hann windows with 50% overlap. Each window uses the
+   * spectrum at its centre time, is computed with an inverse FFT whose
+   * frequency spacing is the closest to freq_step_ that fits the time step,
+   * and has its phases anchored at the window start time. Windows are then
+   * joined by overlap-add. Since the Hann windows sum to one, the difference
+   * from the direct summation with the same phase angles is bounded by
+   * overlap_add_error_bound.
+   * @param[in, out] time_history Location where time history should be stored
+   * @param[in] power_spectrum Matrix containing values of power spectrum over
+   *                           range of frequencies at specified times.
+   * @param[in] phase_angles Random phase angle for each frequency
+   */
+  void overlap_add_synthesis(std::vector<double>& time_history,
+                             const Eigen::MatrixXd& power_spectrum,
+                             const std::vector<double>& phase_angles) const;
+
+  /**
+   * Calculate the upper bound on the absolute difference between the
+   * overlap-add synthesis and the direct summation for the same phase angles.
+   * At time t_n the bound is
+   * 2 sqrt(dw) sum_k w_k(n) sum_j [|A(t_n, w_j) - A(c_k, w_j)| +
+   * A(c_k, w_j) |w_j - w'_j| (t_n - s_k)], where A is the square root of the
+   * power spectrum, w_k is the Hann weight of window k with centre c_k and
+   * start time s_k, and w'_j is the FFT frequency used in place of w_j. The
+   * first term is due to holding the spectrum constant over the window and
+   * the second to the phase drift from the frequency mismatch. This is a
+   * worst case over phase angles, so the actual error is typically much
+   * smaller.
+   * @param[in] power_spectrum Matrix containing values of power spectrum over
+   *                           range of frequencies at specified times.
+   * @return Maximum of the error bound over all times
+   */
+  double overlap_add_error_bound(const Eigen::MatrixXd& power_spectrum) const;
+
+  /**
+   * Factor the square root of the evolutionary power spectrum into a sum of
+   * time modulating functions times frequency shapes using a randomized
+   * truncated singular value decomposition. The rank is chosen based on the
+   * low-rank tolerance.
+   * @param[in] power_spectrum Matrix containing values of power spectrum over
+   *                           range of frequencies at specified times.
+   * @param[in, out] time_modulation Matrix to store time modulating functions
+   *                                 to, with one column per term
+   * @param[in, out] frequency_shapes Matrix to store frequency shapes to, with
+   *                                  one column per term
+   * @return Returns true if successful, false otherwise
+   */
+  bool factor_spectrum(const Eigen::MatrixXd& power_spectrum,
+                       Eigen::MatrixXd& time_modulation,
+                       Eigen::MatrixXd& frequency_shapes) const;
+
+  /**
+   * Synthesize time history from low-rank factors of the spectrum amplitude.
+   * Each term is a stationary sum of cosines that is evaluated exactly at all
+   * times as a chirp-z transform using FFT convolution, so the only
+   * approximation relative to the direct summation is the truncation of the
+   * factorization.
+   * @param[in, out] time_history Location where time history should be stored
+   * @param[in] time_modulation Time modulating functions, with one column per
+   *                            term
+   * @param[in] frequency_shapes Frequency shapes, with one column per term
+   * @param[in] phase_angles Random phase angle for each frequency
+   */
+  void low_rank_synthesis(std::vector<double>& time_history,
+                          const Eigen::MatrixXd& time_modulation,
+                          const Eigen::MatrixXd& frequency_shapes,
+                          const std::vector<double>& phase_angles) const;
+
+  /**
+   * Calculate the evolutionary power spectrum with unit variance at each time
+   * step for the input identified model parameters
+   * @param[in] identified_parameters Identified model parameters
+   * @return Matrix containing values of power spectrum over range of
+   *         frequencies at each time step
+   */
+  Eigen::MatrixXd evolutionary_power_spectrum(
+      const Eigen::VectorXd& identified_parameters) const;
 
   /**
    * Post-process the input time history as described in Vlachos et al. using
@@ -146,11 +484,77 @@ class VlachosEtAl : public StochasticModel {
                     const std::vector<double>& filter_imp_resp) const;
 
   /**
-   * Identifies modal frequency parameters for mode 1 and 2
+   * Post-process the input time history as described in Vlachos et al. using
+   * multiple-window estimation technique after Conte & Peng (1997) and
+   * highpass Butterworth filter
+   * @param[in, out] time_history Time history to post-process. Post-processed
+   *                              results are also stored here.
+   * @param[in] highpass_filter Convolver bound to impulse response of
+   *                            Butterworth filter
+   * @return Returns true if successful, false otherwise
+   */
+  bool post_process(std::vector<double>& time_history,
+                    const numeric_utils::Convolver& highpass_filter) const;
+
+  /**
+   * Post-process the input time history as above and rotate the filtered
+   * result into its x- and y-components in the same pass. The record is
+   * demeaned and tapered in place, only the tapered edges are weighted, and
+   * the filtered record is written directly to the output buffers, so no
+   * memory is allocated for buffers that already have sufficient capacity.
+   * @param[in, out] time_history Time history to post-process. Demeaned and
+   *                              tapered record is stored here.
+   * @param[in] highpass_filter Convolver bound to impulse response of
+   *                            Butterworth filter
+   * @param[in, out] x_accels Vector to store x-component of post-processed
+   *                          acceleration to
+   * @param[in, out] y_accels Vector to store y-component of post-processed
+   *                          acceleration to
+   * @param[in] g_units Indicates that time histories should be returned in
+   *                    units of g
+   */
+  void post_process(std::vector<double>& time_history,
+                    const numeric_utils::Convolver& highpass_filter,
+                    std::vector<double>& x_accels,
+                    std::vector<double>& y_accels, bool g_units) const;
+
+  /**
+   * Post-process the input time history and rotate the filtered result into
+   * its x- and y-components as above, writing to raw buffers
+   * @param[in, out] time_history Time history to post-process. Demeaned and
+   *                              tapered record is stored here.
+   * @param[in] highpass_filter Convolver bound to impulse response of
+   *                            Butterworth filter
+   * @param[out] x_accels Pointer to buffer for time history size + filter
+   *                      kernel size - 1 values of x-component
+   * @param[out] y_accels Pointer to buffer of same size for y-component
+   * @param[in] g_units Indicates that time histories should be returned in
+   *                    units of g
+   */
+  void post_process(std::vector<double>& time_history,
+                    const numeric_utils::Convolver& highpass_filter,
+                    double* x_accels, double* y_accels, bool g_units) const;
+
+  /**
+   * Identifies modal frequency parameters for mode 1 and 2. If the initial
+   * parameters do not satisfy the modal frequency constraints, candidates are
+   * drawn in blocks of increasing size and the first accepted candidate is
+   * returned, which is the same candidate as for drawing one at a time.
+   * Unused candidates in the last block are kept and checked first by the
+   * next call, so the sequence of accepted candidates over several calls is
+   * the same as for drawing one at a time. The sample generator is therefore
+   * consumed up to max_block_size - 1 draws ahead of the accepted candidates,
+   * so other draws from it between calls would take candidates from later in
+   * the sequence. Updates the candidates kept by the model, so calls on the
+   * same model must not run concurrently.
    * @param[in] initial_params Initial set of parameters
+   * @param[in] max_block_size Maximum number of candidates to draw and check
+   *                           at once. Defaults to 64. A value of 1 draws
+   *                           candidates one at a time.
    * @return Vector of identified parameters
    */
-  Eigen::VectorXd identify_parameters(const Eigen::VectorXd& initial_params) const;
+  Eigen::VectorXd identify_parameters(const Eigen::VectorXd& initial_params,
+                                      unsigned int max_block_size = 64);
 
   /**
    * Calculate the dominant modal frequencies as a function of non-dimensional
@@ -270,7 +674,233 @@ class VlachosEtAl : public StochasticModel {
       physical_parameters_; /**< Normal parameters transformed to
                                physical space */
   std::shared_ptr<numeric_utils::RandomGenerator>
-      sample_generator_; /**< Multivariate normal random number generator */
+      sample_generator_; /**< Multivariate normal random number generator.
+                            Candidates of identify_parameters are drawn
+                            ahead of those that are checked, so it is only
+                            used for candidates after construction. */
+  Eigen::MatrixXd
+      parameter_candidates_; /**< Candidates of physical parameters drawn in
+                                blocks by identify_parameters, one per
+                                column */
+  Eigen::Index next_candidate_ =
+      0; /**< Index of first candidate not yet checked by
+            identify_parameters */
+  SynthesisMethod synthesis_method_ =
+      SynthesisMethod::DirectSum; /**< Method used to synthesize time
+                                     histories */
+  unsigned int window_length_ = 200; /**< Number of time steps in each
+                                        overlap-add window */
+  double low_rank_tolerance_ = 1.0e-3; /**< Relative tolerance for low-rank
+                                          spectrum approximation */
+  std::vector<double> frequencies_; /**< Cached frequencies of power spectra,
+                                       empty unless caching */
+  std::vector<double> highpass_butter_energy_; /**< Cached energy of highpass
+                                                  Butterworth filter at each
+                                                  frequency, empty unless
+                                                  caching */
+  std::shared_ptr<const numeric_utils::Convolver>
+      highpass_filter_; /**< Cached highpass filter, null unless caching */
+  std::shared_ptr<const numeric_utils::SpatialCorrelation>
+      phase_field_; /**< Field phase angles are drawn from, null if phase
+                       angles are independent */
+  std::size_t phase_site_ = 0; /**< Index of site in phase field */
+  std::uint64_t phase_seed_ = 0; /**< Seed of random streams of phase field */
+  bool fixed_stream_seed_ = false; /**< Indicates that random streams use
+                                      model_stream_seed_ instead of a seed
+                                      selected from seed_value_ */
+  std::uint64_t model_stream_seed_ = 0; /**< Seed of random streams given at
+                                           construction */
+
+  /**
+   * Parameters and random streams shared by the records of the last call to
+   * records, which appended simulations continue
+   */
+  struct Campaign {
+    std::shared_ptr<const std::vector<Eigen::VectorXd>>
+        identified_parameters; /**< Identified parameters of each spectrum,
+                                  null until records are generated */
+    std::shared_ptr<const numeric_utils::Convolver>
+        highpass_filter; /**< Highpass filter applied to records */
+    std::uint64_t stream_seed = 0; /**< Seed of random streams */
+  };
+
+  Campaign campaign_; /**< Campaign of the last call to records */
+
+  /**
+   * Grow the number of simulations per spectrum of the campaign of the last
+   * call to records and restore its random streams. Throws exception if no
+   * records have been generated yet or acceptance criteria are set.
+   * @param[in] num_sims Number of simulations to append per spectrum
+   * @return Number of simulations per spectrum before appending
+   */
+  unsigned int extend_campaign(unsigned int num_sims);
+
+  /**
+   * Calculate the frequencies at which power spectra are evaluated
+   * @return Frequencies from 0 up to the cutoff frequency
+   */
+  std::vector<double> spectrum_frequencies() const;
+
+  /**
+   * Calculate the energy content of the transfer function of the highpass
+   * Butterworth filter at each frequency of the power spectra
+   * @param[in] frequencies Frequencies of power spectra
+   * @return Energy of filter at each frequency
+   */
+  std::vector<double> highpass_butter_energy(
+      const std::vector<double>& frequencies) const;
+
+  /**
+   * Generate random phase angles uniformly distributed between 0 and 2 pi
+   * from the random stream for the input spectrum and simulation, or from
+   * the random streams of the phase field if one is set
+   * @param[in] num_freqs Number of frequencies to generate phase angles for
+   * @param[in] spectrum_index Index of spectrum
+   * @param[in] sim_index Index of simulation
+   * @return Vector of phase angles
+   */
+  std::vector<double> generate_phase_angles(unsigned int num_freqs,
+                                            unsigned int spectrum_index,
+                                            unsigned int sim_index) const;
+
+  /**
+   * Calculate the impulse response of the highpass Butterworth filter used in
+   * post-processing
+   * @return Filter impulse response
+   */
+  std::vector<double> highpass_impulse_response() const;
+
+  /**
+   * Generate ground motion time histories in batches of spectra, passing
+   * each batch to the input function as soon as it has been generated.
+   * Throws exception if errors are encountered during time history
+   * generation.
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Otherwise time histories are returned in
+   *                  units of m/s^2
+   * @param[in] spectra_per_batch Number of spectra whose records are
+   *                              generated together in each batch
+   * @param[in] process_batch Function called with block of records of each
+   *                          batch and index of first record in batch. The
+   *                          block may be moved from.
+   */
+  void generate_batches(
+      bool units, unsigned int spectra_per_batch,
+      const std::function<void(utilities::TimeHistoryBlock&, std::size_t)>&
+          process_batch);
+
+  /**
+   * Generate a range of records for input identified parameters of all
+   * spectra. Throws exception if errors are encountered during time history
+   * generation.
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of g. Otherwise time histories are returned in
+   *                  units of m/s^2
+   * @param[in] identified_parameters Identified model parameters of each
+   *                                  spectrum
+   * @param[in] highpass_filter Highpass filter used in post-processing
+   * @param[in] first_record Index of first record of range among all records
+   * @param[in] num_records Number of records in range
+   * @return Block of records in range, ordered by spectrum and then by
+   *         simulation
+   */
+  utilities::TimeHistoryBlock generate_range(
+      bool units, const std::vector<Eigen::VectorXd>& identified_parameters,
+      const numeric_utils::Convolver& highpass_filter,
+      std::size_t first_record, std::size_t num_records);
+
+  /**
+   * Write metadata of a block of records
+   * @param[in] event_name Name assigned to all events
+   * @param[in] records Block of records
+   * @param[in] first_record Index of first record in block among all records
+   * @param[in, out] metadata Vector to write metadata of each record to
+   */
+  void records_metadata(const std::string& event_name,
+                        const utilities::TimeHistoryBlock& records,
+                        std::size_t first_record,
+                        std::vector<RecordMetadata>& metadata) const;
+
+  /**
+   * Select the seed of random streams for a call to generate, which is the
+   * seed given at construction if any, otherwise selected from seed_value_
+   * @return Seed of random streams
+   */
+  std::uint64_t select_stream_seed() const;
+
+  /**
+   * Get name of event for record
+   * @param[in] event_name Name assigned to all events
+   * @param[in] record Index of record among all records
+   * @return Name of event
+   */
+  std::string record_name(const std::string& event_name,
+                          std::size_t record) const;
+
+  /**
+   * Get the number of time steps of the evolutionary power spectrum for the
+   * input identified parameters
+   * @param[in] identified_parameters Identified modal frequency parameters
+   * @return Number of time steps before post-processing
+   */
+  unsigned int num_time_steps(
+      const Eigen::VectorXd& identified_parameters) const;
+
+  /**
+   * Simulate a single time history in a family using the selected synthesis
+   * method without post-processing it. This is safe to call concurrently.
+   * @param[in, out] time_history Location where time history should be stored
+   * @param[in] power_spectrum Evolutionary power spectrum for family
+   * @param[in] time_modulation Low-rank time modulating functions for family.
+   *                            Only used for low-rank synthesis.
+   * @param[in] frequency_shapes Low-rank frequency shapes for family. Only
+   *                             used for low-rank synthesis.
+   * @param[in] spectrum_index Index of spectrum for family
+   * @param[in] sim_index Index of time history in family
+   */
+  void synthesize_family_member(std::vector<double>& time_history,
+                                const Eigen::MatrixXd& power_spectrum,
+                                const Eigen::MatrixXd& time_modulation,
+                                const Eigen::MatrixXd& frequency_shapes,
+                                unsigned int spectrum_index,
+                                unsigned int sim_index) const;
+
+  /**
+   * Remove the mean of the input time history and taper its edges with
+   * halves of a Hann window in place
+   * @param[in, out] time_history Time history to demean and taper
+   */
+  void demean_and_taper(std::vector<double>& time_history) const;
+
+  /**
+   * Simulate and post-process a single time history in a family using the
+   * selected synthesis method. This is safe to call concurrently.
+   * @param[in, out] time_history Location where time history should be stored
+   * @param[in] power_spectrum Evolutionary power spectrum for family
+   * @param[in] time_modulation Low-rank time modulating functions for family.
+   *                            Only used for low-rank synthesis.
+   * @param[in] frequency_shapes Low-rank frequency shapes for family. Only
+   *                             used for low-rank synthesis.
+   * @param[in] highpass_filter Convolver bound to impulse response of
+   *                            highpass filter
+   * @param[in] spectrum_index Index of spectrum for family
+   * @param[in] sim_index Index of time history in family
+   */
+  void simulate_family_member(std::vector<double>& time_history,
+                              const Eigen::MatrixXd& power_spectrum,
+                              const Eigen::MatrixXd& time_modulation,
+                              const Eigen::MatrixXd& frequency_shapes,
+                              const numeric_utils::Convolver& highpass_filter,
+                              unsigned int spectrum_index,
+                              unsigned int sim_index) const;
+
+  /**
+   * Get length of inverse FFT used for overlap-add synthesis. This is the
+   * number of time steps for which the FFT frequency spacing is closest to
+   * freq_step_.
+   * @return Length of inverse FFT
+   */
+  unsigned int overlap_add_fft_length() const;
 };
 }  // namespace stochastic
 
@@ -0,0 +1,132 @@
+#ifndef _VLACHOS_MULTI_SITE_H_
+#define _VLACHOS_MULTI_SITE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "scenario_batch.h"
+#include "spatial_correlation.h"
+#include "vlachos_et_al.h"
+
+namespace stochastic {
+/**
+ * Multi-site mode of the Vlachos et al. (2018) model for ground motions at
+ * the sites of a region during one earthquake. The standard normal model
+ * parameters of each spectrum are drawn jointly across sites, correlated
+ * between sites by the tapered spatial correlation and between parameters of
+ * each site by the covariance of the model, so the covariance of all
+ * variables is the Kronecker product of the two. Instead of a dense Cholesky
+ * decomposition over sites times 18 variables, white noise is correlated
+ * across sites with the sparse factor of the spatial correlation and across
+ * parameters with the factor of the 18 x 18 parameter covariance. Phase
+ * angles may optionally be drawn from spatially correlated fields as well.
+ * Each site is a separate model, so records of all sites are synthesized in
+ * parallel when they are added to a ScenarioBatch.
+ */
+class VlachosMultiSite {
+ public:
+  /**
+   * Location and conditions of a site
+   */
+  struct Site {
+    double x; /**< x-coordinate in kilometers */
+    double y; /**< y-coordinate in kilometers */
+    double rupture_distance; /**< Closest-to-site rupture distance in
+                                kilometers */
+    double vs30; /**< Soil shear wave velocity averaged over top 30 meters in
+                    meters per second */
+  };
+
+  /**
+   * @constructor Delete default constructor
+   */
+  VlachosMultiSite() = delete;
+
+  /**
+   * @constructor Draw spatially correlated model parameters and construct
+   * ground motion model of each site. Throws exception if there are no
+   * sites or the spatial correlation can not be factored.
+   * @param[in] moment_magnitude Moment magnitude of earthquake scenario
+   * @param[in] sites Location and conditions of each site
+   * @param[in] orientation Orientation of acceleration relative to global
+   *                        coordinates. Represents counter-clockwise angle (in
+   *                        degrees) away from x-axis rotating around z-axis in
+   *                        right-handed coordinate system.
+   * @param[in] num_spectra Number of evolutionary power spectra that should be
+   *                        generated at each site
+   * @param[in] num_sims Number of simulated ground motion time histories that
+   *                     should be generated per evolutionary power
+   * @param[in] correlation_length Distance in kilometers over which the
+   *                               correlation between sites decays by a
+   *                               factor of e
+   * @param[in] taper_length Distance in kilometers beyond which sites are
+   *                         uncorrelated
+   * @param[in] correlated_phases Indicates that phase angles are drawn from
+   *                              spatially correlated fields. Otherwise phase
+   *                              angles of sites are independent.
+   * @param[in] seed_value Value to seed random variables with to ensure
+   *                       repeatability
+   */
+  VlachosMultiSite(double moment_magnitude, const std::vector<Site>& sites,
+                   double orientation, unsigned int num_spectra,
+                   unsigned int num_sims, double correlation_length,
+                   double taper_length, bool correlated_phases,
+                   int seed_value);
+
+  /**
+   * @destructor Virtual destructor
+   */
+  virtual ~VlachosMultiSite(){};
+
+  /**
+   * Delete copy constructor
+   */
+  VlachosMultiSite(const VlachosMultiSite&) = delete;
+
+  /**
+   * Delete assignment operator
+   */
+  VlachosMultiSite& operator=(const VlachosMultiSite&) = delete;
+
+  /**
+   * Get the number of sites
+   * @return Number of sites
+   */
+  std::size_t num_sites() const { return models_.size(); };
+
+  /**
+   * Get the ground motion model of a site
+   * @param[in] site Index of site
+   * @return Model of site
+   */
+  std::shared_ptr<VlachosEtAl> model(std::size_t site) const {
+    return models_[site];
+  };
+
+  /**
+   * Get the spatial correlation of the sites
+   * @return Spatial correlation
+   */
+  const numeric_utils::SpatialCorrelation& correlation() const {
+    return *correlation_;
+  };
+
+  /**
+   * Add the model of each site to a batch as a separate scenario, named by
+   * the event name followed by "_Site" and the index of the site
+   * @param[in, out] batch Batch to add scenarios to
+   * @param[in] event_name Name to assign to events
+   */
+  void add_scenarios(ScenarioBatch& batch,
+                     const std::string& event_name) const;
+
+ private:
+  std::shared_ptr<const numeric_utils::SpatialCorrelation>
+      correlation_; /**< Spatial correlation of sites */
+  std::vector<std::shared_ptr<VlachosEtAl>> models_; /**< Model of each
+                                                        site */
+};
+}  // namespace stochastic
+
+#endif  // _VLACHOS_MULTI_SITE_H_
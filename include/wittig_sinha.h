@@ -1,11 +1,16 @@
 #ifndef _WITTIG_SINHA_H_
 #define _WITTIG_SINHA_H_
 
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <Eigen/Dense>
 #include "json_object.h"
 #include "stochastic_model.h"
+#include "time_history_block.h"
 
 namespace stochastic {
 
@@ -114,6 +119,128 @@ class WittigSinha : public StochasticModel {
   utilities::JsonObject generate(const std::string& event_name,
                                  bool units = false) override;
 
+  /**
+   * Generate wind velocity time histories based on Wittig & Sinha (1975) model
+   * with provided inputs into contiguous storage
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Defaults to false where time histories
+   *                  are returned in units of m/s
+   * @return Block with one record per horizontal location, ordered by x- and
+   *         then y-location, and one component per vertical location
+   */
+  utilities::TimeHistoryBlock generate_records(bool units = false);
+
+  /**
+   * Generate wind velocity time histories based on Wittig & Sinha (1975) model
+   * with provided inputs into contiguous storage, without creating any JSON
+   * @param[in] event_name Name to assign to event. Events at more than one
+   *                       horizontal location are numbered by location.
+   * @param[in, out] metadata Vector to write metadata of each record to
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Defaults to false where time histories
+   *                  are returned in units of m/s
+   * @return Block with one record per horizontal location, ordered by x- and
+   *         then y-location, and one component per vertical location
+   */
+  utilities::TimeHistoryBlock generate(const std::string& event_name,
+                                       std::vector<RecordMetadata>& metadata,
+                                       bool units = false) override;
+
+  /**
+   * Get the number of records generated by each call to generate
+   * @return Number of records, which is the number of horizontal
+   *         locations
+   */
+  std::size_t num_records() const override;
+
+  /**
+   * Set the tolerance for interpolating the lower Cholesky factors of the
+   * cross-spectral density between frequencies. With a positive tolerance,
+   * frequencies are split into segments whose factors are computed only at
+   * the ends and at midpoints chosen by bisection. A midpoint is accepted
+   * once the Frobenius norm of the difference between its exact factor and
+   * the linear interpolation of the factors at the ends of its interval is
+   * at most tolerance times the norm of its exact factor. Factors at the
+   * remaining frequencies are then interpolated linearly. Interpolated
+   * factors are lower triangular, so the resulting cross-spectral density
+   * remains positive semi-definite. Defaults to 0, which factors the
+   * cross-spectral density at every frequency.
+   * @param[in] tolerance Relative tolerance in the range [0, 1)
+   */
+  void set_cholesky_tolerance(double tolerance);
+
+  /**
+   * Get the tolerance for interpolating the lower Cholesky factors of the
+   * cross-spectral density between frequencies
+   * @return Relative tolerance, with 0 factoring every frequency
+   */
+  double cholesky_tolerance() const { return cholesky_tolerance_; };
+
+  /**
+   * Set the fraction of the energy of the cross-spectral density retained
+   * by proper orthogonal decomposition. With a positive fraction, complex
+   * random numbers are generated from the dominant eigenvectors of the
+   * cross-spectral density instead of its Cholesky factors. The energy is
+   * the trace of the cross-spectral density summed over all frequencies, and
+   * each frequency keeps its dominant mode and the fewest further modes such
+   * that the energy it discards is at most an equal share of the energy that
+   * may be discarded. Frequencies with little energy, usually the highest
+   * ones, therefore keep few modes. Modes are found by subspace iteration started from the modes of the
+   * previous frequency, so cost scales with the square of the number of
+   * locations times the number of modes per frequency rather than with the
+   * cube of the number of locations. Frequencies that need more modes than
+   * one eighth of the number of locations use Cholesky factors instead, so
+   * savings depend on how quickly coherence decays between locations.
+   * Takes precedence over the Cholesky tolerance.
+   * Defaults to 0, which uses Cholesky factors.
+   * @param[in] energy_fraction Fraction of energy in the range [0, 1]
+   */
+  void set_pod_energy_fraction(double energy_fraction);
+
+  /**
+   * Get the fraction of the energy of the cross-spectral density retained
+   * by proper orthogonal decomposition
+   * @return Fraction of energy, with 0 using Cholesky factors
+   */
+  double pod_energy_fraction() const { return pod_energy_fraction_; };
+
+  /**
+   * Create iterator that generates wind velocity time histories based on
+   * Wittig & Sinha (1975) model on demand, one batch of horizontal locations
+   * at a time
+   * @param[in] event_name Name to assign to event. Events at more than one
+   *                       horizontal location are numbered by location.
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Defaults to false where time histories
+   *                  are returned in units of m/s
+   * @param[in] batch_size Maximum number of horizontal locations per batch.
+   *                       Defaults to 0, which generates one location per
+   *                       batch.
+   * @return Iterator over records with one record per horizontal location,
+   *         ordered by x- and then y-location
+   */
+  RecordIterator records(const std::string& event_name, bool units = false,
+                         std::size_t batch_size = 0) override;
+
+  /**
+   * Create JSON objects for wind events of a block of records. Events at more
+   * than one horizontal location also include their name, numbered by
+   * location, and their "x" and "y" locations.
+   * @param[in] event_name Name assigned to events, which is only included in
+   *                       wind events at more than one horizontal location
+   * @param[in] records Block of records
+   * @param[in] first_record Index of first record in block among all records
+   * @param[in] data_offsets Offsets of time histories in data section of
+   *                         binary file, ordered by record and then by
+   *                         height. If given, time series reference their
+   *                         values by offset. Defaults to null.
+   * @return Vector of JsonObjects containing one event per record
+   */
+  std::vector<utilities::JsonObject> events_json(
+      const std::string& event_name, const utilities::TimeHistoryBlock& records,
+      std::size_t first_record,
+      const std::vector<std::size_t>* data_offsets = nullptr) const override;
+
   /**
    * Generate wind velocity time histories based on Wittig & Sinha (1975) model
    * with provided inputs and write results to file in JSON format
@@ -128,7 +255,62 @@ class WittigSinha : public StochasticModel {
                 const std::string& output_location, bool units = false) override;
 
   /**
-   * Calculate the cross-spectral density matrix 
+   * Create archive of the records that a call to generate would produce,
+   * holding the location index of each record and the seed of the white
+   * noise. Complex random numbers are as large as the time histories, so
+   * they are not stored but recomputed from the white noise when records are
+   * rebuilt.
+   * @param[in] event_name Name to assign to event
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Defaults to false where time histories
+   *                  are returned in units of m/s
+   * @return JsonObject containing spectral archive
+   */
+  utilities::JsonObject spectral_archive(const std::string& event_name,
+                                         bool units = false) override;
+
+  /**
+   * Rebuild a range of records from a spectral archive. The complex random
+   * numbers of all points are recomputed since velocities at all points are
+   * correlated, while only the velocities of the records in range are
+   * transformed. Enabling the deterministic cache keeps the factors of the
+   * cross-spectral density matrices between calls. Throws exception if the
+   * archive was not created by a model with the same number of locations or
+   * the range is out of bounds.
+   * @param[in] archive Spectral archive of records
+   * @param[in] first_record Index of first record to rebuild
+   * @param[in] num_records Number of records to rebuild
+   * @return Block of rebuilt records with velocities at all heights
+   */
+  utilities::TimeHistoryBlock rebuild_records(
+      const utilities::JsonObject& archive, std::size_t first_record,
+      std::size_t num_records) override;
+
+  /**
+   * Set whether the inverse Fast Fourier Transforms are zero-padded to the
+   * nearest length whose only prime factors are 2, 3 and 5. Padding refines
+   * the frequency discretization over the same cut-off frequency, so the
+   * velocities change slightly, and is trimmed from the time histories.
+   * @param[in] fft_padding Indicates that transforms are padded
+   */
+  void set_fft_padding(bool fft_padding) override;
+
+  /**
+   * Set whether the lower Cholesky factors of the cross-spectral density at
+   * every frequency are kept between calls to generate, so later calls only
+   * generate white noise and multiply it by the factors. Factors hold the
+   * square of the number of points for every frequency, so caching suits
+   * models with moderate numbers of points. Only used when the
+   * cross-spectral density is factored at every frequency, which is the
+   * default, and factors are then computed on the host.
+   * @param[in] deterministic_cache Indicates that factors are cached
+   */
+  void set_deterministic_cache(bool deterministic_cache) override;
+
+  /**
+   * Calculate the cross-spectral density matrix of all points, ordered by
+   * horizontal location and then by height. Coherence decays with both the
+   * vertical and the horizontal separation of points.
    * @param[in] frequency Frequency at which to calculate cross-spectral density
    * @return Matrix containing cross-spectral density functions
    */
@@ -136,11 +318,29 @@ class WittigSinha : public StochasticModel {
 
   /**
    * Generate matrix of complex random number from standard normal distribution scaled
-   * by lower Cholesky decomposition of the cross-spectral density matrix
-   * @return A matrix containing complex random numbers
+   * by lower Cholesky decomposition of the cross-spectral density matrix.
+   * Frequencies are independent, so they are split across the threads of the
+   * model. Factors are interpolated between frequencies if the Cholesky
+   * tolerance is positive, while dominant modes are used in place of factors
+   * if the energy fraction of proper orthogonal decomposition is positive.
+   * Velocities at all points are correlated, so they are generated jointly
+   * from one random stream.
+   * @return A matrix containing complex random numbers with one column per
+   *         point, ordered by horizontal location and then by height
    */
   Eigen::MatrixXcd complex_random_numbers() const;
 
+  /**
+   * Generate matrix of complex random numbers as in complex_random_numbers,
+   * with the white noise, the factorizations of the cross-spectral density
+   * matrices and the result in single precision. Random numbers of
+   * interpolated factors and proper orthogonal decomposition are computed in
+   * double precision and rounded.
+   * @return A matrix containing complex random numbers with one column per
+   *         point, ordered by horizontal location and then by height
+   */
+  Eigen::MatrixXcf single_complex_random_numbers() const;
+
   /**
    * Generate velocity time histories at vertical location specified
    * @param[in] random_numbers Matrix of complex random numbers to use for
@@ -157,6 +357,53 @@ class WittigSinha : public StochasticModel {
                                         unsigned int column_index,
                                         bool units) const;
 
+  /**
+   * Generate velocity time histories at all vertical locations, computing
+   * the inverse Fast Fourier Transforms for all locations in one batch
+   * @param[in] random_numbers Matrix of complex random numbers to use for
+   *                           velocity time history generation, with one
+   *                           column per vertical location
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Otherwise time histories are returned
+   *                  in units of m/s
+   * @return Vector containing velocity time histories for each vertical
+   *         location
+   */
+  std::vector<std::vector<double>> gen_location_hists(
+      const Eigen::MatrixXcd& random_numbers, bool units) const;
+
+  /**
+   * Generate velocity time histories at all vertical locations into
+   * caller-owned matrix, computing the inverse Fast Fourier Transforms for
+   * all locations in one batch
+   * @param[in] random_numbers Matrix of complex random numbers to use for
+   *                           velocity time history generation, with one
+   *                           column per vertical location
+   * @param[in, out] time_histories Matrix to write velocity time histories
+   *                                to, with one column per vertical location
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Otherwise time histories are returned
+   *                  in units of m/s
+   */
+  void gen_location_hists(const Eigen::MatrixXcd& random_numbers,
+                          Eigen::MatrixXd& time_histories, bool units) const;
+
+  /**
+   * Generate velocity time histories at all vertical locations into
+   * caller-owned matrix in single precision, computing the inverse Fast
+   * Fourier Transforms for all locations in one batch
+   * @param[in] random_numbers Matrix of complex random numbers to use for
+   *                           velocity time history generation, with one
+   *                           column per vertical location
+   * @param[in, out] time_histories Matrix to write velocity time histories
+   *                                to, with one column per vertical location
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Otherwise time histories are returned
+   *                  in units of m/s
+   */
+  void gen_location_hists(const Eigen::MatrixXcf& random_numbers,
+                          Eigen::MatrixXf& time_histories, bool units) const;
+
  private:
   std::string exposure_category_; /**< Exposure category for building based on ASCE-7 */
   double gust_speed_; /**< Gust speed for wind */
@@ -173,9 +420,206 @@ class WittigSinha : public StochasticModel {
   double time_step_; /**< Time step in time histories */
   unsigned int num_times_; /**< Total number of time steps */
   unsigned int num_freqs_; /**< Total number of frequency steps */
+  unsigned int first_frequency_; /**< Number of frequency steps to first
+                                    frequency of range */
   std::vector<double> frequencies_; /**< Range of frequencies */
   std::vector<double> wind_velocities_; /**< Vertical wind velocity profile */
   double friction_velocity_; /**< Friction velocity */
+  Eigen::ArrayXd spectrum_coeffs_; /**< Coefficient of spectral density at
+                                      each point */
+  Eigen::ArrayXd spectrum_scales_; /**< Scale of frequency in spectral density
+                                      at each point */
+  Eigen::ArrayXXd coherence_decay_; /**< Coherence coefficients times
+                                       separation between each pair of points
+                                       divided by their mean wind velocity */
+  double cholesky_tolerance_ = 0.0; /**< Relative tolerance of interpolated
+                                       Cholesky factors */
+  double pod_energy_fraction_ = 0.0; /**< Fraction of energy retained by
+                                        proper orthogonal decomposition */
+  mutable std::vector<Eigen::MatrixXd>
+      cholesky_factors_; /**< Cached lower Cholesky factors of cross-spectral
+                            density at each frequency, empty unless caching */
+  mutable std::vector<Eigen::MatrixXf>
+      single_cholesky_factors_; /**< Cached single precision lower Cholesky
+                                   factors, empty unless caching */
+
+  /**
+   * Calculate the range of frequencies from the number of time steps and the
+   * cut-off frequency
+   */
+  void initialize_frequencies();
+
+  /**
+   * Precompute the terms of the cross-spectral density of all points that do
+   * not depend on frequency from the locations and the wind velocity profile
+   */
+  void initialize_cross_spectra();
+
+  /**
+   * Calculate the cross-spectral density matrix into caller-owned matrix
+   * @param[in] frequency Frequency at which to calculate cross-spectral density
+   * @param[in, out] cross_spectral_density Matrix to write cross-spectral
+   *                                        density functions to. Must be
+   *                                        square with one row per point.
+   */
+  void cross_spectral_density(double frequency,
+                              Eigen::MatrixXd& cross_spectral_density) const;
+
+  /**
+   * Calculate the lower Cholesky factor of the cross-spectral density matrix
+   * @param[in] frequency Frequency at which to factor cross-spectral density
+   * @param[in, out] lower_cholesky Matrix to write lower factor to, with zeros
+   *                                above the diagonal
+   * @return Returns true if the cross-spectral density is positive definite,
+   *         false otherwise
+   */
+  bool lower_cholesky(double frequency, Eigen::MatrixXd& lower_cholesky) const;
+
+  /**
+   * Generate complex random numbers at the frequencies strictly between two
+   * frequencies with known lower Cholesky factors, refining the interval by
+   * bisection until the factors at its midpoints are interpolated within the
+   * Cholesky tolerance
+   * @param[in] white_noise Complex white noise with one column per frequency
+   * @param[in] first_freq Index of frequency at start of interval
+   * @param[in] first_factor Lower Cholesky factor at start of interval
+   * @param[in] last_freq Index of frequency at end of interval
+   * @param[in] last_factor Lower Cholesky factor at end of interval
+   * @param[in, out] complex_random Matrix to write complex random numbers to,
+   *                                with one row per frequency
+   * @return Returns true if the cross-spectral density is positive definite
+   *         at all factored frequencies, false otherwise
+   */
+  bool interpolate_random_numbers(const Eigen::MatrixXcd& white_noise,
+                                  unsigned int first_freq,
+                                  const Eigen::MatrixXd& first_factor,
+                                  unsigned int last_freq,
+                                  const Eigen::MatrixXd& last_factor,
+                                  Eigen::MatrixXcd& complex_random) const;
+
+  /**
+   * Generate complex random numbers for a range of frequencies from the
+   * dominant modes of the cross-spectral density. Modes at the first
+   * frequency of the range are found from columns of the cross-spectral
+   * density, while modes at each later frequency are found starting from
+   * the modes of the previous one. Frequencies that need more modes than one
+   * eighth of the number of locations use Cholesky factors, which are
+   * cheaper at that point, as do several frequencies after them.
+   * @param[in] white_noise Complex white noise with one column per frequency
+   * @param[in] first_freq Index of first frequency of range
+   * @param[in] last_freq Index one past the last frequency of range
+   * @param[in] discarded_energy Energy each frequency may discard
+   * @param[in, out] complex_random Matrix to write complex random numbers to,
+   *                                with one row per frequency
+   * @return Returns true if the cross-spectral density is positive definite
+   *         at all factored frequencies, false otherwise
+   */
+  bool pod_random_numbers(const Eigen::MatrixXcd& white_noise,
+                          unsigned int first_freq, unsigned int last_freq,
+                          double discarded_energy,
+                          Eigen::MatrixXcd& complex_random) const;
+
+  /**
+   * Create JSON object describing event with time histories at each vertical
+   * location, with one event per horizontal location
+   * @param[in] event_name Name assigned to events at more than one horizontal
+   *                       location
+   * @param[in] records Block of records generated by generate_records
+   * @param[in] data_offsets Offsets of time histories in data section of
+   *                         binary file. If given, time series reference
+   *                         their values by offset. Defaults to null.
+   * @return JsonObject containing event
+   */
+  utilities::JsonObject event_json(
+      const std::string& event_name, const utilities::TimeHistoryBlock& records,
+      const std::vector<std::size_t>* data_offsets = nullptr) const;
+
+  /**
+   * Generate complex random numbers by factoring the cross-spectral density
+   * matrix of every frequency
+   * @tparam Tscalar Floating-point type of factorizations and random numbers
+   * @param[in] white_noise Complex white noise with one row per point and one
+   *                        column per frequency
+   * @param[in, out] complex_random Matrix to write complex random numbers to,
+   *                                with one row per frequency and one column
+   *                                per point
+   * @param[in, out] cached_factors Factors at every frequency of a previous
+   *                                call, which are reused, or an empty vector
+   *                                to store the factors in. Defaults to null,
+   *                                which factors without caching.
+   * @return Returns true if all cross-spectral density matrices are positive
+   *         definite, false otherwise
+   */
+  template <typename Tscalar>
+  bool cholesky_random_numbers(
+      const Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic,
+                          Eigen::Dynamic>& white_noise,
+      Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic, Eigen::Dynamic>&
+          complex_random,
+      std::vector<Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>>*
+          cached_factors = nullptr) const;
+
+  /**
+   * Generate complex white noise at all points and frequencies from one
+   * random stream
+   * @tparam Tscalar Floating-point type of white noise
+   * @return Complex white noise with one row per point and one column per
+   *         frequency
+   */
+  template <typename Tscalar>
+  Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic, Eigen::Dynamic>
+  complex_white_noise() const;
+
+  /**
+   * Create iterator over records generated from complex random numbers
+   * shared by all batches
+   * @tparam Tscalar Floating-point type of random numbers and transforms
+   * @param[in] event_name Name assigned to events
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s
+   * @param[in] batch_size Number of records of each batch
+   * @param[in] stream_seed Seed of random streams restored by each batch
+   * @param[in] complex_random Complex random numbers of all points
+   * @return Iterator over records
+   */
+  template <typename Tscalar>
+  RecordIterator range_iterator(
+      const std::string& event_name, bool units, std::size_t batch_size,
+      std::uint64_t stream_seed,
+      std::shared_ptr<const Eigen::Matrix<
+          std::complex<Tscalar>, Eigen::Dynamic, Eigen::Dynamic>>
+          complex_random);
+
+  /**
+   * Generate a range of records, one per horizontal location
+   * @tparam Tscalar Floating-point type of random numbers and transforms
+   * @param[in] units Indicates that time histories should be returned in
+   *                  units of ft/s. Otherwise time histories are returned
+   *                  in units of m/s
+   * @param[in] complex_random Complex random numbers of all points
+   * @param[in] first_location Index of first horizontal location of range
+   * @param[in] num_locations Number of horizontal locations in range
+   * @return Block of records in range
+   */
+  template <typename Tscalar>
+  utilities::TimeHistoryBlock generate_range(
+      bool units,
+      const Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic,
+                          Eigen::Dynamic>& complex_random,
+      std::size_t first_location, std::size_t num_locations) const;
+
+  /**
+   * Write metadata of a block of records
+   * @param[in] event_name Name assigned to all events
+   * @param[in] records Block of records
+   * @param[in] first_location Index of horizontal location of first record
+   *                           in block
+   * @param[in, out] metadata Vector to write metadata of each record to
+   */
+  void records_metadata(const std::string& event_name,
+                        const utilities::TimeHistoryBlock& records,
+                        std::size_t first_location,
+                        std::vector<RecordMetadata>& metadata) const;
 };
 }  // namespace stochastic
 
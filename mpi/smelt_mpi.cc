@@ -0,0 +1,192 @@
+// Runner that splits a campaign of scenarios across MPI ranks. Records of all
+// scenarios are numbered in order and each rank generates one contiguous shard
+// of them, writing its events to <prefix>_shard<rank>.json. Rank 0 also writes
+// <prefix>_index.json locating the records of every shard and scenario.
+// Random streams depend only on the seed of each scenario and the indices of
+// each record, so the shards concatenated in order match the output of a
+// single process bit for bit. Seeds are therefore required for all scenarios.
+//
+// Usage: mpirun -n <ranks> smelt_mpi <campaign file> <output prefix>
+//
+// The campaign file lists the scenarios under "scenarios", each with its
+// "name", the factory key of its "model" and the constructor inputs of the
+// model. Optional keys "numThreads" and "units" set the number of threads of
+// each rank, with 0 using all hardware threads, and the units flag.
+//   VlachosSiteSpecificEQ: momentMagnitude, ruptureDistance, vs30,
+//     orientation, numSpectra, numSims, seed
+//   DabaghiDerKiureghianNFGM: faultType (StrikeSlip or ReverseAndRevObliq),
+//     simulationType (PulseAndNoPulse, Pulse or NoPulse), momentMagnitude,
+//     depthToRupture, ruptureDistance, vs30, sOrD, thetaOrPhi, numSims,
+//     numRealizations, truncate, seed
+//   WittigSinhaDiscreteFreqWind: exposureCategory, gustSpeed, height,
+//     numFloors, totalTime, seed
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <mpi.h>
+#include <nlohmann/json.hpp>
+#include "configure.h"
+#include "dabaghi_der_kiureghian.h"
+#include "factory.h"
+#include "scenario_batch.h"
+#include "stochastic_model.h"
+
+namespace {
+/**
+ * Create the stochastic model of a scenario of the campaign. Throws exception
+ * if the model is not supported or the scenario has no seed.
+ * @param[in] scenario Scenario inputs from campaign file
+ * @return Stochastic model of scenario
+ */
+std::shared_ptr<stochastic::StochasticModel> create_model(
+    const nlohmann::json& scenario) {
+  std::string model = scenario.at("model").get<std::string>();
+
+  if (scenario.count("seed") == 0) {
+    throw std::runtime_error(
+        "\nERROR: in smelt_mpi: Scenario " +
+        scenario.at("name").get<std::string>() +
+        " requires a seed so that all ranks share its random streams\n");
+  }
+
+  if (model == "VlachosSiteSpecificEQ") {
+    return Factory<stochastic::StochasticModel, double, double, double, double,
+                   unsigned int, unsigned int, int>::instance()
+        ->create(model, scenario.at("momentMagnitude").get<double>(),
+                 scenario.at("ruptureDistance").get<double>(),
+                 scenario.at("vs30").get<double>(),
+                 scenario.at("orientation").get<double>(),
+                 scenario.at("numSpectra").get<unsigned int>(),
+                 scenario.at("numSims").get<unsigned int>(),
+                 scenario.at("seed").get<int>());
+  } else if (model == "DabaghiDerKiureghianNFGM") {
+    std::string fault_type = scenario.at("faultType").get<std::string>();
+    std::string simulation_type =
+        scenario.at("simulationType").get<std::string>();
+
+    stochastic::FaultType faulting;
+    if (fault_type == "StrikeSlip") {
+      faulting = stochastic::FaultType::StrikeSlip;
+    } else if (fault_type == "ReverseAndRevObliq") {
+      faulting = stochastic::FaultType::ReverseAndRevObliq;
+    } else {
+      throw std::runtime_error("\nERROR: in smelt_mpi: Invalid fault type " +
+                               fault_type + "\n");
+    }
+
+    stochastic::SimulationType simulation;
+    if (simulation_type == "PulseAndNoPulse") {
+      simulation = stochastic::SimulationType::PulseAndNoPulse;
+    } else if (simulation_type == "Pulse") {
+      simulation = stochastic::SimulationType::Pulse;
+    } else if (simulation_type == "NoPulse") {
+      simulation = stochastic::SimulationType::NoPulse;
+    } else {
+      throw std::runtime_error(
+          "\nERROR: in smelt_mpi: Invalid simulation type " + simulation_type +
+          "\n");
+    }
+
+    return Factory<stochastic::StochasticModel, stochastic::FaultType,
+                   stochastic::SimulationType, double, double, double, double,
+                   double, double, unsigned int, unsigned int, bool,
+                   int>::instance()
+        ->create(model, std::move(faulting), std::move(simulation),
+                 scenario.at("momentMagnitude").get<double>(),
+                 scenario.at("depthToRupture").get<double>(),
+                 scenario.at("ruptureDistance").get<double>(),
+                 scenario.at("vs30").get<double>(),
+                 scenario.at("sOrD").get<double>(),
+                 scenario.at("thetaOrPhi").get<double>(),
+                 scenario.at("numSims").get<unsigned int>(),
+                 scenario.at("numRealizations").get<unsigned int>(),
+                 scenario.at("truncate").get<bool>(),
+                 scenario.at("seed").get<int>());
+  } else if (model == "WittigSinhaDiscreteFreqWind") {
+    return Factory<stochastic::StochasticModel, std::string, double, double,
+                   unsigned int, double, int>::instance()
+        ->create(model, scenario.at("exposureCategory").get<std::string>(),
+                 scenario.at("gustSpeed").get<double>(),
+                 scenario.at("height").get<double>(),
+                 scenario.at("numFloors").get<unsigned int>(),
+                 scenario.at("totalTime").get<double>(),
+                 scenario.at("seed").get<int>());
+  }
+
+  throw std::runtime_error("\nERROR: in smelt_mpi: Model " + model +
+                           " is not supported\n");
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  MPI_Init(&argc, &argv);
+
+  int rank = 0;
+  int num_ranks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &num_ranks);
+
+  if (argc != 3) {
+    if (rank == 0) {
+      std::cerr << "Usage: " << argv[0] << " <campaign file> <output prefix>"
+                << std::endl;
+    }
+    MPI_Finalize();
+    return 1;
+  }
+
+  int status = 0;
+  try {
+    config::initialize();
+
+    std::ifstream campaign_file(argv[1]);
+    if (!campaign_file) {
+      throw std::runtime_error(
+          "\nERROR: in smelt_mpi: Could not open campaign file " +
+          std::string(argv[1]) + "\n");
+    }
+    nlohmann::json campaign;
+    campaign_file >> campaign;
+
+    stochastic::ScenarioBatch batch(campaign.value("numThreads", 0u));
+    for (auto const& scenario : campaign.at("scenarios")) {
+      batch.add_scenario(scenario.at("name").get<std::string>(),
+                         create_model(scenario));
+    }
+
+    // Every rank knows the ranges of all shards, so the index is written
+    // without gathering anything from the other ranks
+    std::string prefix(argv[2]);
+    std::vector<std::string> shard_locations(num_ranks);
+    for (int i = 0; i < num_ranks; ++i) {
+      shard_locations[i] = prefix + "_shard" + std::to_string(i) + ".json";
+    }
+
+    batch.set_shard(rank, num_ranks);
+    if (!batch.generate(shard_locations[rank],
+                        campaign.value("units", false))) {
+      status = 1;
+    }
+
+    if (rank == 0 && !batch.shard_index(shard_locations)
+                          .write_to_file(prefix + "_index.json")) {
+      status = 1;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    status = 1;
+  }
+
+  // Fail on every rank if any rank failed
+  int campaign_status = 0;
+  MPI_Allreduce(&status, &campaign_status, 1, MPI_INT, MPI_MAX,
+                MPI_COMM_WORLD);
+
+  MPI_Finalize();
+  return campaign_status;
+}
@@ -0,0 +1,283 @@
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include "configure.h"
+#include "dabaghi_der_kiureghian.h"
+#include "factory.h"
+#include "json_object.h"
+#include "record_iterator.h"
+#include "stochastic_model.h"
+#include "time_history_block.h"
+
+namespace py = pybind11;
+
+namespace {
+/**
+ * Add overload of create function to module that constructs stochastic
+ * models registered in the factory with the input argument types
+ * @tparam Targs Types of arguments of registered constructor
+ * @param[in, out] module Module to add overload to
+ */
+template <typename... Targs>
+void def_create(py::module& module) {
+  module.def("create", [](const std::string& key, Targs... args) {
+    return Factory<stochastic::StochasticModel, Targs...>::instance()->create(
+        key, std::forward<Targs>(args)...);
+  });
+}
+
+/**
+ * Create NumPy array viewing all components of a record without copying
+ * @param[in] self Python object owning block of records
+ * @param[in] record Index of record
+ * @return Array with one row per component and one column per time step
+ */
+py::array_t<double> record_array(py::object self, std::size_t record) {
+  auto& records = self.cast<utilities::TimeHistoryBlock&>();
+  if (record >= records.num_records()) {
+    throw py::index_error("Record index out of range");
+  }
+
+  std::vector<py::ssize_t> shape = {
+      static_cast<py::ssize_t>(records.num_components()),
+      static_cast<py::ssize_t>(records.num_steps(record))};
+  std::vector<py::ssize_t> strides = {
+      static_cast<py::ssize_t>(records.num_steps(record) * sizeof(double)),
+      static_cast<py::ssize_t>(sizeof(double))};
+  // Block object is the base of the array so the view keeps it alive
+  return py::array_t<double>(shape, strides, records.data(record, 0), self);
+}
+}  // namespace
+
+PYBIND11_MODULE(smelt, module) {
+  module.doc() = "Stochastic, Modular, and Extensible Library for Time histories";
+
+  // Register models in factories once when module is imported
+  config::initialize();
+
+  module.def("set_tabulated_distributions", &config::set_tabulated_distributions,
+             py::arg("tabulated"),
+             "Set whether beta, inverse Gaussian and Student's t marginals of "
+             "models constructed afterwards use tabulated inverse CDFs");
+  module.def("tabulated_distributions", &config::tabulated_distributions,
+             "Check whether marginals use tabulated inverse CDFs");
+
+  py::enum_<stochastic::FaultType>(module, "FaultType")
+      .value("StrikeSlip", stochastic::FaultType::StrikeSlip)
+      .value("ReverseAndRevObliq", stochastic::FaultType::ReverseAndRevObliq);
+
+  py::enum_<stochastic::SimulationType>(module, "SimulationType")
+      .value("PulseAndNoPulse", stochastic::SimulationType::PulseAndNoPulse)
+      .value("Pulse", stochastic::SimulationType::Pulse)
+      .value("NoPulse", stochastic::SimulationType::NoPulse);
+
+  py::enum_<stochastic::OutputFormat>(module, "OutputFormat")
+      .value("JSON", stochastic::OutputFormat::JSON)
+      .value("Binary", stochastic::OutputFormat::Binary)
+      .value("Spectral", stochastic::OutputFormat::Spectral);
+
+  py::enum_<stochastic::Precision>(module, "Precision")
+      .value("Double", stochastic::Precision::Double)
+      .value("Single", stochastic::Precision::Single);
+
+  py::class_<stochastic::RecordMetadata>(module, "RecordMetadata")
+      .def_readonly("name", &stochastic::RecordMetadata::name)
+      .def_readonly("type", &stochastic::RecordMetadata::type)
+      .def_readonly("time_step", &stochastic::RecordMetadata::time_step)
+      .def_readonly("num_steps", &stochastic::RecordMetadata::num_steps)
+      .def_readonly("components", &stochastic::RecordMetadata::components);
+
+  py::class_<utilities::TimeHistoryBlock,
+             std::shared_ptr<utilities::TimeHistoryBlock>>(module, "Records")
+      .def_property_readonly("num_records",
+                             &utilities::TimeHistoryBlock::num_records)
+      .def_property_readonly("num_components",
+                             &utilities::TimeHistoryBlock::num_components)
+      .def_property_readonly("time_step",
+                             &utilities::TimeHistoryBlock::time_step)
+      .def("num_steps", &utilities::TimeHistoryBlock::num_steps,
+           py::arg("record"))
+      .def("record", &record_array, py::arg("record"))
+      .def("__len__", &utilities::TimeHistoryBlock::num_records)
+      .def("__getitem__", &record_array);
+
+  py::class_<stochastic::RecordIterator>(module, "RecordIterator")
+      .def_property_readonly("num_records",
+                             &stochastic::RecordIterator::num_records)
+      .def_property_readonly("position", &stochastic::RecordIterator::position)
+      .def("__iter__",
+           [](stochastic::RecordIterator& iterator)
+               -> stochastic::RecordIterator& { return iterator; })
+      .def("__next__", [](stochastic::RecordIterator& iterator) {
+        std::vector<stochastic::RecordMetadata> metadata;
+        utilities::TimeHistoryBlock records;
+        bool generated;
+        {
+          py::gil_scoped_release release;
+          generated = iterator.next(records, metadata);
+        }
+        if (!generated) {
+          throw py::stop_iteration();
+        }
+        return py::make_tuple(
+            std::make_shared<utilities::TimeHistoryBlock>(std::move(records)),
+            metadata);
+      });
+
+  py::class_<stochastic::StochasticModel,
+             std::shared_ptr<stochastic::StochasticModel>>(module,
+                                                           "StochasticModel")
+      .def_property_readonly("model_name",
+                             &stochastic::StochasticModel::model_name)
+      .def_property_readonly("num_records",
+                             &stochastic::StochasticModel::num_records)
+      .def_property("num_threads", &stochastic::StochasticModel::num_threads,
+                    &stochastic::StochasticModel::set_num_threads)
+      .def_property("output_format",
+                    &stochastic::StochasticModel::output_format,
+                    &stochastic::StochasticModel::set_output_format)
+      .def_property("fft_padding", &stochastic::StochasticModel::fft_padding,
+                    &stochastic::StochasticModel::set_fft_padding)
+      .def_property("precision", &stochastic::StochasticModel::precision,
+                    &stochastic::StochasticModel::set_precision)
+      .def_property("deterministic_cache",
+                    &stochastic::StochasticModel::deterministic_cache,
+                    &stochastic::StochasticModel::set_deterministic_cache)
+      .def_property_readonly(
+          "profile",
+          [](const stochastic::StochasticModel& model) {
+            return py::module::import("json").attr("loads")(
+                model.profile().get_library_json().dump());
+          },
+          "Stage times and counters of the last call to generate or records")
+      .def(
+          "generate",
+          [](stochastic::StochasticModel& model, const std::string& event_name,
+             bool units) {
+            std::vector<stochastic::RecordMetadata> metadata;
+            utilities::TimeHistoryBlock records;
+            {
+              py::gil_scoped_release release;
+              records = model.generate(event_name, metadata, units);
+            }
+            return py::make_tuple(
+                std::make_shared<utilities::TimeHistoryBlock>(
+                    std::move(records)),
+                metadata);
+          },
+          py::arg("event_name"), py::arg("units") = false,
+          "Generate records, returning block of records and list of record "
+          "metadata")
+      .def(
+          "records",
+          [](stochastic::StochasticModel& model, const std::string& event_name,
+             bool units, std::size_t batch_size) {
+            py::gil_scoped_release release;
+            return model.records(event_name, units, batch_size);
+          },
+          py::arg("event_name"), py::arg("units") = false,
+          py::arg("batch_size") = 0, py::keep_alive<0, 1>(),
+          "Create iterator yielding batches of records and their metadata as "
+          "they are generated")
+      .def(
+          "generate_file",
+          [](stochastic::StochasticModel& model, const std::string& event_name,
+             const std::string& output_location, bool units) {
+            py::gil_scoped_release release;
+            return model.generate(event_name, output_location, units);
+          },
+          py::arg("event_name"), py::arg("output_location"),
+          py::arg("units") = false,
+          "Generate records and write them to output location")
+      .def(
+          "append_records",
+          [](stochastic::StochasticModel& model, const std::string& event_name,
+             unsigned int num_sims, bool units, std::size_t batch_size) {
+            py::gil_scoped_release release;
+            return model.append_records(event_name, num_sims, units,
+                                        batch_size);
+          },
+          py::arg("event_name"), py::arg("num_sims"), py::arg("units") = false,
+          py::arg("batch_size") = 0, py::keep_alive<0, 1>(),
+          "Append simulations to the last campaign, creating iterator "
+          "yielding batches of only the appended records and their metadata")
+      .def(
+          "append_file",
+          [](stochastic::StochasticModel& model, const std::string& event_name,
+             const std::string& output_location, unsigned int num_sims,
+             bool units) {
+            py::gil_scoped_release release;
+            return model.append(event_name, output_location, num_sims, units);
+          },
+          py::arg("event_name"), py::arg("output_location"),
+          py::arg("num_sims"), py::arg("units") = false,
+          "Append simulations to the last campaign and add their events to "
+          "the file written by it")
+      .def(
+          "rebuild_records",
+          [](stochastic::StochasticModel& model,
+             const std::string& archive_location, std::size_t first_record,
+             std::size_t num_records) {
+            utilities::TimeHistoryBlock records;
+            {
+              py::gil_scoped_release release;
+              utilities::JsonObject archive;
+              archive.read_from_file(archive_location);
+              records =
+                  model.rebuild_records(archive, first_record, num_records);
+            }
+            return std::make_shared<utilities::TimeHistoryBlock>(
+                std::move(records));
+          },
+          py::arg("archive_location"), py::arg("first_record"),
+          py::arg("num_records"),
+          "Rebuild block of records from spectral archive written in the "
+          "Spectral output format")
+      .def(
+          "rebuild_record",
+          [](stochastic::StochasticModel& model,
+             const std::string& archive_location, std::size_t record,
+             std::size_t first_step, std::size_t num_steps) {
+            utilities::TimeHistoryBlock records;
+            {
+              py::gil_scoped_release release;
+              utilities::JsonObject archive;
+              archive.read_from_file(archive_location);
+              records =
+                  model.rebuild_record(archive, record, first_step, num_steps);
+            }
+            return std::make_shared<utilities::TimeHistoryBlock>(
+                std::move(records));
+          },
+          py::arg("archive_location"), py::arg("record"),
+          py::arg("first_step") = 0,
+          py::arg("num_steps") = std::numeric_limits<std::size_t>::max(),
+          "Rebuild window of time steps of one record from spectral archive "
+          "written in the Spectral output format");
+
+  // Constructors registered in config::initialize, in the same order
+  def_create<double, double, double, double, unsigned int, unsigned int>(
+      module);
+  def_create<double, double, double, double, unsigned int, unsigned int,
+             int>(module);
+  def_create<stochastic::FaultType, stochastic::SimulationType, double,
+             double, double, double, double, double, unsigned int,
+             unsigned int, bool>(module);
+  def_create<stochastic::FaultType, stochastic::SimulationType, double,
+             double, double, double, double, double, unsigned int,
+             unsigned int, bool, int>(module);
+  def_create<std::string, double, double, unsigned int, double>(module);
+  def_create<std::string, double, double, unsigned int, double, int>(module);
+  def_create<std::string, double, const std::vector<double>&,
+             const std::vector<double>&, const std::vector<double>&, double>(
+      module);
+  def_create<std::string, double, const std::vector<double>&,
+             const std::vector<double>&, const std::vector<double>&, double,
+             int>(module);
+}
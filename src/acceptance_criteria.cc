@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "acceptance_criteria.h"
+#include "intensity_measures.h"
+
+stochastic::AcceptanceCriteria::AcceptanceCriteria(unsigned int max_attempts)
+    : max_attempts_{max_attempts} {
+  if (max_attempts_ == 0) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::AcceptanceCriteria::AcceptanceCriteria: "
+        "Maximum number of attempts must be positive\n");
+  }
+}
+
+void stochastic::AcceptanceCriteria::add_criterion(Criterion criterion) {
+  criteria_.push_back(criterion);
+}
+
+void stochastic::AcceptanceCriteria::set_response_spectrum(
+    std::shared_ptr<const numeric_utils::ResponseSpectrum> response_spectrum) {
+  response_spectrum_ = response_spectrum;
+}
+
+stochastic::IntensityMeasures
+stochastic::AcceptanceCriteria::intensity_measures(
+    const std::vector<double>& acceleration, double time_step) const {
+  return intensity_measures(acceleration.data(), acceleration.size(),
+                            time_step);
+}
+
+stochastic::IntensityMeasures
+stochastic::AcceptanceCriteria::intensity_measures(const double* acceleration,
+                                                   std::size_t num_steps,
+                                                   double time_step) const {
+  IntensityMeasures measures;
+  measures.peak_acceleration = 0.0;
+  for (std::size_t i = 0; i < num_steps; ++i) {
+    measures.peak_acceleration =
+        std::max(measures.peak_acceleration, std::abs(acceleration[i]));
+  }
+  measures.arias_intensity =
+      numeric_utils::arias_intensity(acceleration, num_steps, time_step);
+  measures.significant_duration =
+      numeric_utils::significant_duration(acceleration, num_steps, time_step);
+  if (response_spectrum_) {
+    measures.response_spectrum =
+        response_spectrum_->compute(acceleration, num_steps);
+  }
+
+  return measures;
+}
+
+bool stochastic::AcceptanceCriteria::accept(
+    const std::vector<std::vector<double>>& components,
+    double time_step) const {
+  std::vector<IntensityMeasures> measures(components.size());
+  for (unsigned int i = 0; i < components.size(); ++i) {
+    measures[i] = intensity_measures(components[i], time_step);
+  }
+
+  return satisfied(measures);
+}
+
+bool stochastic::AcceptanceCriteria::accept(
+    const Eigen::Ref<const Eigen::MatrixXd>& components,
+    double time_step) const {
+  std::vector<IntensityMeasures> measures(components.cols());
+  for (unsigned int i = 0; i < components.cols(); ++i) {
+    measures[i] = intensity_measures(components.col(i).data(),
+                                     components.rows(), time_step);
+  }
+
+  return satisfied(measures);
+}
+
+bool stochastic::AcceptanceCriteria::satisfied(
+    const std::vector<IntensityMeasures>& measures) const {
+  for (auto& criterion : criteria_) {
+    if (!criterion(measures)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+stochastic::AcceptanceCriteria::Criterion
+stochastic::AcceptanceCriteria::peak_acceleration_between(double min_value,
+                                                          double max_value) {
+  return [min_value,
+          max_value](const std::vector<IntensityMeasures>& measures) {
+    double peak = 0.0;
+    for (auto& component : measures) {
+      peak = std::max(peak, component.peak_acceleration);
+    }
+    return peak >= min_value && peak <= max_value;
+  };
+}
+
+stochastic::AcceptanceCriteria::Criterion
+stochastic::AcceptanceCriteria::significant_duration_between(double min_value,
+                                                             double max_value) {
+  return [min_value,
+          max_value](const std::vector<IntensityMeasures>& measures) {
+    if (measures.empty()) {
+      return false;
+    }
+    auto strongest = std::max_element(
+        measures.begin(), measures.end(),
+        [](const IntensityMeasures& lhs, const IntensityMeasures& rhs) {
+          return lhs.arias_intensity < rhs.arias_intensity;
+        });
+    return strongest->significant_duration >= min_value &&
+           strongest->significant_duration <= max_value;
+  };
+}
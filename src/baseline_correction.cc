@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+#include <Eigen/Dense>
+#include "baseline_correction.h"
+#include "lru_cache.h"
+
+numeric_utils::BaselineCorrection::BaselineCorrection(unsigned int num_steps,
+                                                      double time_step,
+                                                      unsigned int degree)
+    : num_steps_{num_steps}, time_step_{time_step}, degree_{degree} {
+  if (degree_ < 2 || num_steps_ < degree_) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::BaselineCorrection::BaselineCorrection: "
+        "Degree must be at least 2 and no more than number of time steps\n");
+  }
+
+  // Polynomial terms of powers 2 to degree are written in normalized time,
+  // which keeps the least-squares system well conditioned for long records
+  unsigned int num_terms = degree_ - 1;
+  double duration = std::max(time_step_ * (num_steps_ - 1), time_step_);
+  Eigen::MatrixXd vandermonde(num_steps_, num_terms);
+  correction_basis_.resize(num_steps_, num_terms);
+
+  for (unsigned int i = 0; i < num_steps_; ++i) {
+    double time = i * time_step_ / duration;
+    for (unsigned int j = 0; j < num_terms; ++j) {
+      double power = j + 2.0;
+      vandermonde(i, j) = std::pow(time, power);
+      correction_basis_(i, j) = power * (power - 1.0) *
+                                std::pow(time, power - 2.0) /
+                                (duration * duration);
+    }
+  }
+
+  // Projection is inverse of R times thin Q of QR factorization
+  Eigen::HouseholderQR<Eigen::MatrixXd> qr(vandermonde);
+  Eigen::MatrixXd thin_q =
+      qr.householderQ() * Eigen::MatrixXd::Identity(num_steps_, num_terms);
+  projection_ = qr.matrixQR()
+                    .topLeftCorner(num_terms, num_terms)
+                    .triangularView<Eigen::Upper>()
+                    .solve(thin_q.transpose());
+}
+
+std::shared_ptr<const numeric_utils::BaselineCorrection>
+numeric_utils::BaselineCorrection::cached(unsigned int num_steps,
+                                          double time_step,
+                                          unsigned int degree) {
+  // Number of entries kept before the least recently used one is evicted,
+  // which bounds memory when time histories of many different lengths are
+  // corrected without discarding lengths that are still in use
+  const std::size_t max_entries = 16;
+  static utilities::LruCache<std::tuple<unsigned int, double, unsigned int>,
+                             std::shared_ptr<const BaselineCorrection>>
+      cache(max_entries);
+
+  auto key = std::make_tuple(num_steps, time_step, degree);
+  std::shared_ptr<const BaselineCorrection> correction;
+  if (cache.find(key, correction)) {
+    return correction;
+  }
+
+  // Construct outside of lock so other threads are not blocked
+  correction =
+      std::make_shared<const BaselineCorrection>(num_steps, time_step, degree);
+  return cache.insert(key, correction);
+}
+
+void numeric_utils::BaselineCorrection::correct(
+    std::vector<double>& acceleration, double gfactor) const {
+  correct(Eigen::Map<Eigen::MatrixXd>(acceleration.data(), acceleration.size(),
+                                      1),
+          gfactor);
+}
+
+void numeric_utils::BaselineCorrection::correct(
+    Eigen::Ref<Eigen::MatrixXd> accelerations, double gfactor) const {
+  if (accelerations.rows() != num_steps_) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::BaselineCorrection::correct: Number of "
+        "time steps does not match baseline correction\n");
+  }
+
+  // Calculate displacement time histories by integrating twice
+  Eigen::MatrixXd displacements(accelerations.rows(), accelerations.cols());
+  for (unsigned int j = 0; j < accelerations.cols(); ++j) {
+    double velocity = 0.0, displacement = 0.0;
+    for (unsigned int i = 0; i < accelerations.rows(); ++i) {
+      velocity += accelerations(i, j) * gfactor * time_step_;
+      displacement += velocity * time_step_;
+      displacements(i, j) = displacement;
+    }
+  }
+
+  // Fit polynomials and subtract their second derivatives
+  Eigen::MatrixXd coefficients = projection_ * displacements;
+  accelerations.noalias() -= (correction_basis_ / gfactor) * coefficients;
+}
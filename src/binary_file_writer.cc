@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "binary_file_writer.h"
+#include "json_object.h"
+#include "time_history_block.h"
+
+const char utilities::BinaryFileWriter::magic[8] = {'S', 'M', 'E', 'L',
+                                                    'T', 'B', 'I', 'N'};
+const std::uint32_t utilities::BinaryFileWriter::version;
+const std::uint32_t utilities::BinaryFileWriter::byte_order_mark;
+const std::size_t utilities::BinaryFileWriter::alignment;
+const std::size_t utilities::BinaryFileWriter::fixed_header_size;
+
+namespace {
+// Round input size up to next multiple of the array alignment
+std::size_t align(std::size_t size) {
+  const std::size_t alignment = utilities::BinaryFileWriter::alignment;
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * Sizes and offsets of the sections of a binary file
+ */
+struct FileLayout {
+  std::uint64_t header_size; /**< Size of JSON header in bytes */
+  std::uint64_t data_offset; /**< Offset of data section from start of file */
+  std::uint64_t data_size; /**< Size of data section in bytes */
+};
+
+/**
+ * Read and check fixed header of binary file. Throws exception if the file
+ * was not written by utilities::BinaryFileWriter on a machine with the same
+ * byte order.
+ * @param[in, out] input_file Stream of file, positioned at its start
+ * @return Layout of file
+ */
+FileLayout read_layout(std::ifstream& input_file) {
+  using utilities::BinaryFileWriter;
+  std::vector<char> fixed_header(BinaryFileWriter::fixed_header_size, 0);
+  input_file.read(fixed_header.data(), fixed_header.size());
+
+  std::uint32_t version, byte_order_mark;
+  std::uint64_t array_alignment;
+  FileLayout layout;
+  std::memcpy(&version, fixed_header.data() + 8, sizeof(version));
+  std::memcpy(&byte_order_mark, fixed_header.data() + 12,
+              sizeof(byte_order_mark));
+  std::memcpy(&array_alignment, fixed_header.data() + 16,
+              sizeof(array_alignment));
+  std::memcpy(&layout.header_size, fixed_header.data() + 24,
+              sizeof(layout.header_size));
+  std::memcpy(&layout.data_offset, fixed_header.data() + 32,
+              sizeof(layout.data_offset));
+  std::memcpy(&layout.data_size, fixed_header.data() + 40,
+              sizeof(layout.data_size));
+
+  if (input_file.fail() ||
+      std::memcmp(fixed_header.data(), BinaryFileWriter::magic,
+                  sizeof(BinaryFileWriter::magic)) != 0 ||
+      version != BinaryFileWriter::version ||
+      byte_order_mark != BinaryFileWriter::byte_order_mark ||
+      array_alignment != BinaryFileWriter::alignment) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::BinaryFileWriter::append_to(): Existing file "
+        "was not written by this version of BinaryFileWriter\n");
+  }
+
+  return layout;
+}
+}  // namespace
+
+utilities::BinaryFileWriter::BinaryFileWriter()
+    : data_size_{0}, existing_size_{0} {}
+
+void utilities::BinaryFileWriter::append_to(
+    const std::string& existing_location) {
+  if (!arrays_.empty()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::BinaryFileWriter::append_to(): Arrays have "
+        "already been added\n");
+  }
+
+  std::ifstream input_file(existing_location, std::ios::binary);
+  if (!input_file.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::BinaryFileWriter::append_to(): Could not open "
+        "existing file\n");
+  }
+
+  existing_location_ = existing_location;
+  existing_size_ = read_layout(input_file).data_size;
+  data_size_ = existing_size_;
+}
+
+std::size_t utilities::BinaryFileWriter::add_array(const double* values,
+                                                   std::size_t num_values) {
+  std::size_t offset = align(data_size_);
+  arrays_.push_back(values);
+  sizes_.push_back(num_values);
+  offsets_.push_back(offset);
+  data_size_ = offset + num_values * sizeof(double);
+  return offset;
+}
+
+std::vector<std::size_t> utilities::BinaryFileWriter::add_records(
+    const TimeHistoryBlock& records) {
+  std::vector<std::size_t> offsets;
+  offsets.reserve(records.num_records() * records.num_components());
+  for (std::size_t i = 0; i < records.num_records(); ++i) {
+    for (std::size_t j = 0; j < records.num_components(); ++j) {
+      offsets.push_back(add_array(records.data(i, j), records.num_steps(i)));
+    }
+  }
+  return offsets;
+}
+
+bool utilities::BinaryFileWriter::write(const std::string& output_location,
+                                        const JsonObject& header) const {
+  // When appending, events and data of the existing file precede the new
+  // events and arrays
+  auto header_json = header.get_library_json();
+  std::ifstream input_file;
+  FileLayout existing_layout{0, 0, 0};
+  if (!existing_location_.empty()) {
+    input_file.open(existing_location_, std::ios::binary);
+    if (!input_file.is_open()) {
+      throw std::runtime_error(
+          "\nERROR: In utilities::BinaryFileWriter::write(): Could not open "
+          "existing file\n");
+    }
+    existing_layout = read_layout(input_file);
+    std::string existing_header(existing_layout.header_size, '\0');
+    input_file.read(&existing_header[0], existing_header.size());
+    if (input_file.fail() || existing_layout.data_size != existing_size_) {
+      throw std::runtime_error(
+          "\nERROR: In utilities::BinaryFileWriter::write(): Error when "
+          "reading existing file\n");
+    }
+
+    auto combined_header = json::parse(existing_header);
+    if (!combined_header["Events"].is_array() ||
+        !header_json["Events"].is_array()) {
+      throw std::runtime_error(
+          "\nERROR: In utilities::BinaryFileWriter::write(): Headers of "
+          "existing file and appended arrays must hold an events array\n");
+    }
+    for (const auto& event : header_json["Events"]) {
+      combined_header["Events"].push_back(event);
+    }
+    header_json = std::move(combined_header);
+  }
+
+  std::string header_string = header_json.dump();
+  std::uint64_t header_size = header_string.size();
+  std::uint64_t data_offset = align(fixed_header_size + header_size);
+  std::uint64_t data_size = data_size_;
+  std::uint64_t array_alignment = alignment;
+
+  std::vector<char> fixed_header(fixed_header_size, 0);
+  std::memcpy(fixed_header.data(), magic, sizeof(magic));
+  std::memcpy(fixed_header.data() + 8, &version, sizeof(version));
+  std::memcpy(fixed_header.data() + 12, &byte_order_mark,
+              sizeof(byte_order_mark));
+  std::memcpy(fixed_header.data() + 16, &array_alignment,
+              sizeof(array_alignment));
+  std::memcpy(fixed_header.data() + 24, &header_size, sizeof(header_size));
+  std::memcpy(fixed_header.data() + 32, &data_offset, sizeof(data_offset));
+  std::memcpy(fixed_header.data() + 40, &data_size, sizeof(data_size));
+
+  // The JSON header precedes the data section and grows with the appended
+  // events, so the existing data section moves and is copied. It is copied
+  // in chunks of bounded size to a temporary file that then replaces the
+  // output location, so memory use does not grow with the existing file
+  // while its I/O does, and the existing file may be the output location.
+  bool appending = input_file.is_open();
+  std::string write_location =
+      appending ? output_location + ".append" : output_location;
+  std::ofstream output_file(write_location, std::ios::binary);
+  if (!output_file.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::BinaryFileWriter::write(): Could not open "
+        "output location\n");
+  }
+
+  const std::vector<char> padding(alignment, 0);
+  output_file.write(fixed_header.data(), fixed_header.size());
+  output_file.write(header_string.data(), header_string.size());
+  output_file.write(padding.data(),
+                    data_offset - fixed_header_size - header_size);
+
+  if (appending) {
+    const std::size_t chunk_size = std::size_t(1) << 23;
+    std::vector<char> chunk(
+        std::min<std::uint64_t>(chunk_size, existing_layout.data_size));
+    input_file.seekg(existing_layout.data_offset);
+    for (std::uint64_t copied = 0; copied < existing_layout.data_size;
+         copied += chunk.size()) {
+      std::size_t num_bytes = static_cast<std::size_t>(std::min<std::uint64_t>(
+          chunk.size(), existing_layout.data_size - copied));
+      input_file.read(chunk.data(), num_bytes);
+      output_file.write(chunk.data(), num_bytes);
+    }
+    if (input_file.fail()) {
+      output_file.close();
+      std::remove(write_location.c_str());
+      throw std::runtime_error(
+          "\nERROR: In utilities::BinaryFileWriter::write(): Error when "
+          "reading existing file\n");
+    }
+    input_file.close();
+  }
+
+  std::size_t position = existing_layout.data_size;
+  for (std::size_t i = 0; i < arrays_.size(); ++i) {
+    output_file.write(padding.data(), offsets_[i] - position);
+    output_file.write(reinterpret_cast<const char*>(arrays_[i]),
+                      sizes_[i] * sizeof(double));
+    position = offsets_[i] + sizes_[i] * sizeof(double);
+  }
+
+  output_file.close();
+
+  if (output_file.fail()) {
+    if (appending) {
+      std::remove(write_location.c_str());
+    }
+    throw std::runtime_error(
+        "\nERROR: In utilities::BinaryFileWriter::write(): Error when writing "
+        "to output location\n");
+  }
+
+  // Renaming does not replace existing files on all platforms, so the
+  // existing file is moved aside and only removed once the new file is in
+  // place. On failure, the existing file is restored and the new file is left
+  // at its temporary location.
+  if (appending && std::rename(write_location.c_str(),
+                               output_location.c_str()) != 0) {
+    std::string backup_location = output_location + ".backup";
+    if (std::rename(output_location.c_str(), backup_location.c_str()) != 0) {
+      throw std::runtime_error(
+          "\nERROR: In utilities::BinaryFileWriter::write(): Could not "
+          "replace output location, new file left at " +
+          write_location + "\n");
+    }
+    if (std::rename(write_location.c_str(), output_location.c_str()) != 0) {
+      std::rename(backup_location.c_str(), output_location.c_str());
+      throw std::runtime_error(
+          "\nERROR: In utilities::BinaryFileWriter::write(): Could not "
+          "replace output location, new file left at " +
+          write_location + "\n");
+    }
+    std::remove(backup_location.c_str());
+  }
+
+  return true;
+}
@@ -1,3 +1,5 @@
+#include <atomic>
+#include <cstdint>
 #include <Eigen/Dense>
 #include "beta_dist.h"
 #include "configure.h"
@@ -10,13 +12,21 @@
 #include "numeric_utils.h"
 #include "normal_dist.h"
 #include "normal_multivar.h"
+#include "normal_multivar_stream.h"
+#include "normal_multivar_vsl.h"
 #include "students_t_dist.h"
+#include "tabulated_dist.h"
 #include "uniform_dist.h"
 #include "vlachos_et_al.h"
 #include "wind_profile.h"
 #include "window.h"
 #include "wittig_sinha.h"
 
+namespace {
+std::atomic<bool> tabulated_marginals{
+    false}; /**< Indicates that models use tabulated marginal distributions */
+}  // namespace
+
 void config::initialize() {
   // RANDOM VARIABLE GENERATION
   // Register multivariate normal distribution random number generator
@@ -25,6 +35,17 @@ void config::initialize() {
   static Register<numeric_utils::RandomGenerator, numeric_utils::NormalMultiVar,
                   int>
       normal_multivar("MultivariateNormal");
+  // Register multivariate normal generator using MKL VSL streams
+  static Register<numeric_utils::RandomGenerator,
+                  numeric_utils::NormalMultiVarVsl>
+      normal_multivar_vsl_default("MultivariateNormalVSL");
+  static Register<numeric_utils::RandomGenerator,
+                  numeric_utils::NormalMultiVarVsl, int>
+      normal_multivar_vsl("MultivariateNormalVSL");
+  // Register multivariate normal generator using keyed random streams
+  static Register<numeric_utils::RandomGenerator,
+                  numeric_utils::NormalMultiVarStream, std::uint64_t>
+      normal_multivar_stream("MultivariateNormalStream");
 
   // DISTRIBUTION TYPES
   // Register normal distribution
@@ -51,6 +72,30 @@ void config::initialize() {
   static Register<stochastic::Distribution, stochastic::UniformDistribution,
                   double, double>
       uniform_dist("UniformDist");
+  // Register distributions with tabulated inverse CDF, with and without
+  // maximum interpolation error
+  static Register<stochastic::Distribution,
+                  stochastic::TabulatedBetaDistribution, double, double>
+      tabulated_beta_dist("TabulatedBetaDist");
+  static Register<stochastic::Distribution,
+                  stochastic::TabulatedBetaDistribution, double, double, double>
+      tabulated_beta_dist_error("TabulatedBetaDist");
+  static Register<stochastic::Distribution,
+                  stochastic::TabulatedInverseGaussianDistribution, double,
+                  double>
+      tabulated_inv_gauss_dist("TabulatedInverseGaussianDist");
+  static Register<stochastic::Distribution,
+                  stochastic::TabulatedInverseGaussianDistribution, double,
+                  double, double>
+      tabulated_inv_gauss_dist_error("TabulatedInverseGaussianDist");
+  static Register<stochastic::Distribution,
+                  stochastic::TabulatedStudentstDistribution, double, double,
+                  double>
+      tabulated_student_t_dist("TabulatedStudentstDist");
+  static Register<stochastic::Distribution,
+                  stochastic::TabulatedStudentstDistribution, double, double,
+                  double, double>
+      tabulated_student_t_dist_error("TabulatedStudentstDist");
 
   // STOCHASTIC MODELS
   // Earthquake
@@ -120,3 +165,9 @@ void config::initialize() {
       exposure_category_vel("ExposureCategoryVel",
                             wind::exposure_category_velocity());
 }
+
+void config::set_tabulated_distributions(bool tabulated) {
+  tabulated_marginals = tabulated;
+}
+
+bool config::tabulated_distributions() { return tabulated_marginals; }
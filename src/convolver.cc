@@ -0,0 +1,126 @@
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include "convolver.h"
+#include "numeric_utils.h"
+#include "scratch_arena.h"
+
+numeric_utils::Convolver::Convolver(const std::vector<double>& kernel,
+                                    Mode mode, bool smooth_lengths)
+    : kernel_{Eigen::Map<const Eigen::VectorXd>(kernel.data(), kernel.size())},
+      mode_{mode},
+      smooth_lengths_{smooth_lengths} {
+  if (kernel.empty()) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::Convolver::Convolver: Kernel must not be "
+        "empty\n");
+  }
+}
+
+void numeric_utils::Convolver::convolve(const double* input, std::size_t size,
+                                        double* output) const {
+  std::size_t output_size = size + kernel_.size() - 1;
+  Eigen::Map<Eigen::VectorXd> output_vector(output, output_size);
+  Eigen::Map<const Eigen::VectorXd> input_vector(input, size);
+
+  if (mode(size) == Mode::Direct) {
+    // Accumulate input shifted by each kernel lag
+    output_vector.setZero();
+    for (unsigned int i = 0; i < kernel_.size(); ++i) {
+      output_vector.segment(i, size) += kernel_(i) * input_vector;
+    }
+    return;
+  }
+
+  // Multiply transforms of zero-padded input and kernel, using scratch
+  // buffers of calling thread
+  std::size_t length = fft_length(size);
+  auto& arena = utilities::ScratchArena::local();
+  utilities::ScratchArena::Scope scope(arena);
+  auto padded = arena.vector(length);
+  padded.head(size) = input_vector;
+  padded.tail(length - size).setZero();
+  auto transform = arena.complex_vector(length / 2 + 1);
+  real_fft(padded.data(), length, transform.data());
+  transform.array() *= kernel_transform(length).array();
+  inverse_real_fft(transform.data(), length, padded.data());
+  output_vector = padded.head(output_size);
+}
+
+void numeric_utils::Convolver::convolve(const std::vector<double>& input,
+                                        std::vector<double>& output) const {
+  output.resize(input.size() + kernel_.size() - 1);
+  convolve(input.data(), input.size(), output.data());
+}
+
+void numeric_utils::Convolver::convolve(const Eigen::MatrixXd& inputs,
+                                        Eigen::MatrixXd& outputs) const {
+  std::size_t size = inputs.rows();
+  outputs.resize(size + kernel_.size() - 1, inputs.cols());
+
+  if (mode(size) == Mode::Direct || inputs.cols() == 0) {
+    for (unsigned int i = 0; i < inputs.cols(); ++i) {
+      convolve(inputs.col(i).data(), size, outputs.col(i).data());
+    }
+    return;
+  }
+
+  // Transform all zero-padded records in one batch
+  std::size_t length = fft_length(size);
+  Eigen::MatrixXd padded = Eigen::MatrixXd::Zero(length, inputs.cols());
+  padded.topRows(size) = inputs;
+  Eigen::MatrixXcd transforms;
+  real_fft(padded, transforms);
+  transforms.array().colwise() *= kernel_transform(length).array();
+  inverse_real_fft(transforms, length, padded);
+  outputs = padded.topRows(outputs.rows());
+}
+
+numeric_utils::Convolver::Mode numeric_utils::Convolver::mode(
+    std::size_t size) const {
+  if (mode_ != Mode::Auto) {
+    return mode_;
+  }
+
+  // Direct convolution takes one multiply-add per input value and kernel
+  // value, while FFT convolution takes roughly two real transforms and a
+  // complex product of the padded length
+  double length = static_cast<double>(fft_length(size));
+  double direct_cost = static_cast<double>(size) * kernel_.size();
+  double fft_cost = 5.0 * length * std::log2(length) + 4.0 * length;
+  return direct_cost <= fft_cost ? Mode::Direct : Mode::FFT;
+}
+
+std::size_t numeric_utils::Convolver::fft_length(std::size_t size) const {
+  std::size_t output_size = size + kernel_.size() - 1;
+  if (smooth_lengths_) {
+    return smooth_fft_length(output_size);
+  }
+
+  std::size_t length = 1;
+  while (length < output_size) {
+    length *= 2;
+  }
+  return length;
+}
+
+const Eigen::VectorXcd& numeric_utils::Convolver::kernel_transform(
+    std::size_t length) const {
+  std::lock_guard<std::mutex> lock(transforms_mutex_);
+  auto entry = kernel_transforms_.find(length);
+  if (entry != kernel_transforms_.end()) {
+    return entry->second;
+  }
+
+  // References to map entries stay valid as other lengths are added
+  Eigen::VectorXd padded = Eigen::VectorXd::Zero(length);
+  padded.head(kernel_.size()) = kernel_;
+  Eigen::VectorXcd transform(length / 2 + 1);
+  real_fft(padded.data(), length, transform.data());
+  return kernel_transforms_.emplace(length, transform).first->second;
+}
@@ -1,29 +1,356 @@
 #define _USE_MATH_DEFINES
 #include <algorithm>
 #include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <stdexcept>
 #include <string>
 #include <vector>
 // Boost random generator
-#include <boost/random/normal_distribution.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_real_distribution.hpp>
 #include <boost/random/variate_generator.hpp>
 // Eigen dense matrices
 #include <Eigen/Dense>
 
+#include "baseline_correction.h"
 #include "beta_dist.h"
+#include "binary_file_writer.h"
+#include "configure.h"
 #include "dabaghi_der_kiureghian.h"
 #include "factory.h"
+#include "filter_bank.h"
 #include "function_dispatcher.h"
+#include "intensity_measures.h"
+#include "json_event_writer.h"
 #include "json_object.h"
+#include "multi_start_nelder_mead.h"
 #include "nelder_mead.h"
 #include "normal_dist.h"
 #include "normal_multivar.h"
 #include "numeric_utils.h"
+#include "parallel.h"
+#include "profiler.h"
+#include "random_stream.h"
+#include "record_iterator.h"
+#include "scratch_arena.h"
+#include "time_history_block.h"
+
+namespace {
+/**
+ * Regression constants of the model parameters (Dabaghi & Der Kiureghian,
+ * 2017). These do not depend on the scenario, so they are built once and
+ * shared by all instances of the model.
+ */
+struct RegressionTables {
+  Eigen::VectorXd std_dev_pulse; /**< Pulse-like parameter standard deviation */
+  Eigen::VectorXd std_dev_nopulse; /**< No-pulse-like parameter standard
+                                      deviation */
+  Eigen::MatrixXd corr_matrix_pulse; /**< Pulse-like parameter correlation
+                                        matrix */
+  Eigen::MatrixXd corr_matrix_nopulse; /**< No-pulse-like parameter
+                                          correlation matrix */
+  Eigen::MatrixXd cov_matrix_pulse; /**< Pulse-like parameter covariance
+                                       matrix */
+  Eigen::MatrixXd cov_matrix_nopulse; /**< No-pulse-like parameter covariance
+                                         matrix */
+  Eigen::MatrixXd beta_distribution_pulse; /**< Regression coefficients for
+                                              pulse-like motion */
+  Eigen::MatrixXd beta_distribution_nopulse; /**< Regression coefficients for
+                                                no-pulse-like motion */
+  Eigen::VectorXd params_lower_bound; /**< Lower bound for marginal
+                                         distributions */
+  Eigen::VectorXd params_upper_bound; /**< Upper bound for marginal
+                                         distributions */
+  Eigen::VectorXd params_fitted1; /**< Fitted distribution parameters */
+  Eigen::VectorXd params_fitted2; /**< Fitted distribution parameters */
+  Eigen::VectorXd params_fitted3; /**< Fitted distribution parameters */
+};
+
+/**
+ * Get the regression tables shared by all instances, building them the first
+ * time they are requested
+ * @return Shared regression tables
+ */
+const RegressionTables& regression_tables() {
+  static const RegressionTables shared_tables = []() {
+    RegressionTables tables;
+    tables.std_dev_pulse.resize(19);
+    tables.std_dev_nopulse.resize(14);
+    tables.corr_matrix_pulse.resize(19, 19);
+    tables.corr_matrix_nopulse.resize(14, 14);
+    tables.beta_distribution_pulse.resize(19, 8);
+    tables.beta_distribution_nopulse.resize(14, 8);
+    tables.params_lower_bound.resize(19);
+    tables.params_upper_bound.resize(19);
+    tables.params_fitted1.resize(19);
+    tables.params_fitted2.resize(19);
+    tables.params_fitted3.resize(19);  
+
+    // clang-format off
+    tables.std_dev_pulse <<
+        0.385316782551070, 0.580604607504062, 1.000000000000000,
+        1.000000000000000, 0.468600626648626, 0.781462017439926,
+        0.371951335342951, 0.442124880737131, 0.393548709857826,
+        0.409988222892834, 0.820134132413354, 1.096436125406160,
+        0.746552904533869, 0.402440900041447, 0.461424491954810,
+        0.407724539607907, 0.440166826670740, 0.824632603897275,
+        0.961997443697123;
+    tables.std_dev_nopulse <<
+        1.052723262620090, 0.398427668080412, 0.456828618083131,
+        0.305727090125879, 0.447517114210032, 0.941288665677244,
+        1.007680943597980, 1.028226030318770, 0.375877126809162,
+        0.458413470215522, 0.294118965466636, 0.399966941388161,
+        0.831550984874095, 0.887870513796394;
+
+    tables.corr_matrix_pulse <<
+        1, -0.175836500638571, -0.0203457508302324, 0.173589795302921, 0.191081284058678, 0.446601858355920, 0.0422292189436895, 0.0268120615665615, 0.120003074985399, -0.382241273128019, 0.0573276270760638, 0.155115849407343, 0.407222009805941, -0.0405527073664880, 0.0164573906036360, 0.0415103476380082, -0.282855958356553, 0.106173613413053, 0.0486136094283240,
+        -0.175836500638571, 1, 0.183359484001117, 0.00131202858838653, 0.431552926960257, -0.0802776119560438, 0.0983744630339078, 0.310456055209018, 0.368157334142620, 0.0509849248659661, 0.0223164167958617, 0.175239604674009, -0.0979434412969958, 0.143078236501468, 0.295214504980143, 0.370873286184142, 0.0409704140512328, -0.0681917932721656, 0.243299650091412,
+        -0.0203457508302324, 0.183359484001117, 1, -0.190019984820145, 0.242770958876810, 0.178170099097870, 0.107202069371700, 0.150512140384424, 0.236433714526518, -0.114026379004051, 0.0535511100783777, 0.0642193542887409, 0.0688913090123055, 0.127858468767928, 0.0893601270266779, 0.213748741406994, -0.0697188946975121, 0.0212082250410815, 0.123098089235859,
+        0.173589795302921, 0.00131202858838653, -0.190019984820145, 1, 0.119159474433286, -0.0812496120969922, 0.0911626190533515, 0.0653720081018262, 0.0718151835177181, -0.133641807530098, -0.0920397447082436, 0.0299407456292105, -0.0242282623085006, -0.0172855366304964, 0.0663348465393307, 0.0729217102589892, -0.146245197915904, 0.0999563418090508, -0.0409433584122388,
+        0.191081284058678, 0.431552926960257, 0.242770958876810, 0.119159474433286, 1, 0.0597439686298471, 0.163724290728144, 0.733127256394521, 0.788656583220928, -0.0312901152364670, -0.153794052040040, 0.126072923696987, 0.0157717534215698, 0.186868291148981, 0.680765575675777, 0.749289248752773, 0.00752109582582447, -0.165776964800244, 0.192516732945902,
+        0.446601858355920, -0.0802776119560438, 0.178170099097870, -0.0812496120969922, 0.0597439686298471, 1, -0.0244049816649646, 0.0584250580150467, 0.0856617566986387, 0.0783654782068241, 0.0990943110343599, 0.0264806656713516, 0.837794567493788, 0.0235744551632278, 0.00722635162195151, 0.0801743456052000, 0.125480219427063, 0.0813027074983168, 0.0454360407125637,
+        0.0422292189436895, 0.0983744630339078, 0.107202069371700, 0.0911626190533515, 0.163724290728144, -0.0244049816649646, 1, 0.0612360822187756, 0.245411252666782, -0.0247015935697729, -0.224809121780326, 0.0459354003374228, 0.0364365286784528, 0.760546075583923, 0.0370009049319755, 0.205658174145097, -0.0837872744722257, -0.0338684418879410, -0.0274880324550587,
+        0.0268120615665615, 0.310456055209018, 0.150512140384424, 0.0653720081018262, 0.733127256394521, 0.0584250580150467, 0.0612360822187756, 1, 0.855219194729329, 0.0120435632525462, -0.0489647334211007, 0.199955997824984, 0.0212627853872894, 0.146801029873847, 0.931624963947970, 0.850430406207709, 0.0232039506387295, -0.00394570150177181, 0.244390432559234,
+        0.120003074985399, 0.368157334142620, 0.236433714526518, 0.0718151835177181, 0.788656583220928, 0.0856617566986387, 0.245411252666782, 0.855219194729329, 1, 0.0298843738756568, -0.0618147333807716, 0.197760496777865, 0.104861038989822, 0.262606914312613, 0.795537444898935, 0.906602423826413, 0.0381266607245457, -0.0143594270096637, 0.226001111347866,
+        -0.382241273128019, 0.0509849248659661, -0.114026379004051, -0.133641807530098, -0.0312901152364670, 0.0783654782068241, -0.0247015935697729, 0.0120435632525462, 0.0298843738756568, 1, -0.241519621897699, 0.112473855187119, 0.171776282660699, -0.0492035952139502, 0.0493755848461730, 0.112703656481410, 0.864715714588433, -0.286206615545551, 0.157882561174870,
+        0.0573276270760638, 0.0223164167958617, 0.0535511100783777, -0.0920397447082436, -0.153794052040040, 0.0990943110343599, -0.224809121780326, -0.0489647334211007, -0.0618147333807716, -0.241519621897699, 1, 0.112365366315021, -0.0106706754632641, -0.0488287220881385, -0.0635241398373312, -0.0911374530847290, -0.0885687207002145, 0.421522224993818, 0.239492035016932,
+        0.155115849407343, 0.175239604674009, 0.0642193542887409, 0.0299407456292105, 0.126072923696987, 0.0264806656713516, 0.0459354003374228, 0.199955997824984, 0.197760496777865, 0.112473855187119, 0.112365366315021, 1, -0.0274158393051499, 0.0871234642667006, 0.160919524797887, 0.256368904115107, 0.275537783357955, -0.175867301345906, 0.792491388890200,
+        0.407222009805941, -0.0979434412969958, 0.0688913090123055, -0.0242282623085006, 0.0157717534215698, 0.837794567493788, 0.0364365286784528, 0.0212627853872894, 0.104861038989822, 0.171776282660699, -0.0106706754632641, -0.0274158393051499, 1, -0.168436208860883, 0.0139228196755138, 0.0606940022435021, 0.0950730856215810, 0.166344473008140, -0.0377746475967110,
+        -0.0405527073664880, 0.143078236501468, 0.127858468767928, -0.0172855366304964, 0.186868291148981, 0.0235744551632278, 0.760546075583923, 0.146801029873847, 0.262606914312613, -0.0492035952139502, -0.0488287220881385, 0.0871234642667006, -0.168436208860883, 1, 0.0584697041090115, 0.243068478704018, 0.0101378284587601, -0.134310788077535, 0.0858141211009980,
+        0.0164573906036360, 0.295214504980143, 0.0893601270266779, 0.0663348465393307, 0.680765575675777, 0.00722635162195151, 0.0370009049319755, 0.931624963947970, 0.795537444898935, 0.0493755848461730, -0.0635241398373312, 0.160919524797887, 0.0139228196755138, 0.0584697041090115, 1, 0.841226866362572, 0.0319804533198723, 0.0395868643324250, 0.183336741524880,
+        0.0415103476380082, 0.370873286184142, 0.213748741406994, 0.0729217102589892, 0.749289248752773, 0.0801743456052000, 0.205658174145097, 0.850430406207709, 0.906602423826413, 0.112703656481410, -0.0911374530847290, 0.256368904115107, 0.0606940022435021, 0.243068478704018, 0.841226866362572, 1, 0.0999775444207582, -0.0848763381048173, 0.277349661980356,
+        -0.282855958356553, 0.0409704140512328, -0.0697188946975121, -0.146245197915904, 0.00752109582582447, 0.125480219427063, -0.0837872744722257, 0.0232039506387295, 0.0381266607245457, 0.864715714588433, -0.0885687207002145, 0.275537783357955, 0.0950730856215810, 0.0101378284587601, 0.0319804533198723, 0.0999775444207582, 1, -0.432951535761925, 0.262376572921422,
+        0.106173613413053, -0.0681917932721656, 0.0212082250410815, 0.0999563418090508, -0.165776964800244, 0.0813027074983168, -0.0338684418879410, -0.00394570150177181, -0.0143594270096637, -0.286206615545551, 0.421522224993818, -0.175867301345906, 0.166344473008140, -0.134310788077535, 0.0395868643324250, -0.0848763381048173, -0.432951535761925, 1, -0.184861197592255,
+        0.0486136094283240, 0.243299650091412, 0.123098089235859, -0.0409433584122388, 0.192516732945902, 0.0454360407125637, -0.0274880324550587, 0.244390432559234, 0.226001111347866, 0.157882561174870, 0.239492035016932, 0.792491388890200, -0.0377746475967110, 0.0858141211009980, 0.183336741524880, 0.277349661980356, 0.262376572921422, -0.184861197592255, 1;
+
+    tables.corr_matrix_nopulse <<
+        1, -0.183620641202513, 0.0890171218487119, 0.104132896092390, 0.0143281984142704, 0.202871723469377, -0.151909317725644, 0.945163870283100, -0.0778432911362303, 0.0495683691288216, 0.0966843496273208, 0.0917721771113965, 0.103741261286614, -0.121195511065596,
+        -0.183620641202513, 1, 0.0854423655718587, 0.307373593686928, -0.0150490152853094, -0.149397471797000, 0.0888348816281089, -0.0794047082384602, 0.848433024094089, 0.0950830201555768, 0.288741920713302, -0.0596971902001111, -0.0160895956989375, 0.113905908782625,
+        0.0890171218487119, 0.0854423655718587, 1, 0.813213357087557, -0.225438606252670, 0.000735703328121357, -0.0840944291284059, 0.0562899783045387, 0.137192754102300, 0.907605550316775, 0.788263163970441, -0.189167012249831, -0.0219422025252862, -0.0931560965857281,
+        0.104132896092390, 0.307373593686928, 0.813213357087557, 1, -0.162877782549727, -0.0946212742252604, -0.0192432432422716, 0.131014027317413, 0.289495591671556, 0.752836252137069, 0.908489822222397, -0.151488045845577, -0.0637984858287899, -0.0498615936932623,
+        0.0143281984142704, -0.0150490152853094, -0.225438606252670, -0.162877782549727, 1, -0.187527904866745, -0.163661457269968, 0.0720174301613615, -0.0805658506819631, -0.173027594836660, -0.165135405413428, 0.897082085156820, -0.0778400029130002, -0.00420375269007833,
+        0.202871723469377, -0.149397471797000, 0.000735703328121357, -0.0946212742252604, -0.187527904866745, 1, -0.0853760806838177, 0.151981779909482, -0.0282514238500333, 0.00217240817323823, -0.0879254146125414, -0.0874961774514421, 0.647468312996265, -0.157070775414507,
+        -0.151909317725644, 0.0888348816281089, -0.0840944291284059, -0.0192432432422716, -0.163661457269968, -0.0853760806838177, 1, -0.109821275189057, 0.0605607584025393, -0.0674419385042876, -0.0178734643092523, -0.0879585887923949, -0.105931812299965, 0.761324011431321,
+        0.945163870283100, -0.0794047082384602, 0.0562899783045387, 0.131014027317413, 0.0720174301613615, 0.151981779909482, -0.109821275189057, 1, -0.0744735914486929, 0.0477307773362732, 0.116976058986177, 0.104731056969540, 0.137507782979518, -0.107158677162180,
+        -0.0778432911362303, 0.848433024094089, 0.137192754102300, 0.289495591671556, -0.0805658506819631, -0.0282514238500333, 0.0605607584025393, -0.0744735914486929, 1, 0.0782297693189997, 0.294723991917604, -0.0895932216480470, -0.0501878780366773, 0.0967842822751738,
+        0.0495683691288216, 0.0950830201555768, 0.907605550316775, 0.752836252137069, -0.173027594836660, 0.00217240817323823, -0.0674419385042876, 0.0477307773362732, 0.0782297693189997, 1, 0.786122088469745, -0.177521125226899, 0.00868592321024064, -0.0671981184080449,
+        0.0966843496273208, 0.288741920713302, 0.788263163970441, 0.908489822222397, -0.165135405413428, -0.0879254146125414, -0.0178734643092523, 0.116976058986177, 0.294723991917604, 0.786122088469745, 1, -0.168356869639510, -0.0773913106180435, -0.0274804568206274,
+        0.0917721771113965, -0.0596971902001111, -0.189167012249831, -0.151488045845577, 0.897082085156820, -0.0874961774514421, -0.0879585887923949, 0.104731056969540, -0.0895932216480470, -0.177521125226899, -0.168356869639510, 1, -0.183773515755380, 0.00693211686662153,
+        0.103741261286614, -0.0160895956989375, -0.0219422025252862, -0.0637984858287899, -0.0778400029130002, 0.647468312996265, -0.105931812299965, 0.137507782979518, -0.0501878780366773, 0.00868592321024064, -0.0773913106180435, -0.183773515755380, 1, -0.110874872058067,
+        -0.121195511065596, 0.113905908782625, -0.0931560965857281, -0.0498615936932623, -0.00420375269007833, -0.157070775414507, 0.761324011431321, -0.107158677162180, 0.0967842822751738, -0.0671981184080449, -0.0274804568206274, 0.00693211686662153, -0.110874872058067, 1;
+
+    tables.beta_distribution_pulse <<
+      1.69862554416145, 0.608190177030033, -0.608190177030033, -0.576217471720854, 0, 0.183071013159864, -0.0939319189357984, 0.00657091132855174,
+      -2.47924338395758, 0.670395625327187, 0, 0, 0, -0.263957799575519, -0.232548659903406, 0.00791988432530859,
+      0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0,
+      -4.24873260256537, 0.852185710838635, 0, 0.389602053633798, 0, -0.380323064996537, -0.0880126751081291, 0,
+      -2.11599237942931, 1.47405211856417, -1.37810504103118, -1.07311968166742, 0, 0.336513504829882, 0, 0,
+      -0.381092000896248, 0.732824259094057, 0, 0.216502277780155, 0, -0.162653108888503, -0.426573570884097, 0,
+      -5.56310544580757, 0.905239391642438, 0, 0.385150957140062, 0, -0.282428134685156, 0, 0,
+      -4.77682417817789, 0.879981585446539, 0, 0.310609998745732, 0, -0.339225914155431, 0, 0,
+      0.966712608298821, -0.110938996751065, 0, 0, 0, 0, 0.183289269601829, 0,
+      -2.16587686889173, 0.321501356495567, 0, 0, 0, 0, 0, 0,
+      -1.70734873800232, 0.433032709755610, 0, -0.412648447269525, 0, 0, 0, 0,
+      -0.263198077701693, 1.13060571952101, -1.16957372638359, -1.65164476300789, 0.104746885300915, 0.404058507352901, 0, 0,
+      -0.515969600508314, 0.754135122993588, 0, 0.191575083960373, 0, -0.121665118341219, -0.423844926774291, 0,
+      -5.77208004012831, 0.923144661954273, 0, 0.402940883581593, 0, -0.238200773846646, 0, 0,
+      -5.01588271867143, 0.905027154000921, 0, 0.326841161038211, 0, -0.328283913521590, 0, 0,
+      0.434339606308037, -0.125225415996048, 0, 0, 0, 0, 0.301631247865572, 0,
+      -2.87544520181323, 0.415682222485807, 0, 0, 0, 0, 0, 0,
+      -1.86755738290362, 0.457448335779201, 0, -0.501103981295545, 0, 0, 0, 0;
+
+    tables.beta_distribution_nopulse <<
+      8.09695881287823, 1.00609515629221, -1.39347614723327, -4.85869770683701, 0.472644100309933, 0.434550762616159, -0.862562872197509, 0,
+      -1.03473761679032, 0.769091178587874, 0, 0.412237308297152, 0, -0.377739650769220, -0.424234099315427, 0,
+      -4.72728279119446, 0.709717476708319, 0, 0.470974168011549, 0, -0.123518047425648, 0, 0,
+      -4.44400222195478, 0.798093247074753, 0, 0.345405210060350, 0, -0.230823340141895, 0, 0,
+      0.247133528936450, -0.149209862203390, 0, 0, 0, 0, 0.377202902904920, 0,
+      -1.44302935447839, 0.223053706671624, 0, 0, 0, 0, 0, 0,
+      -0.380413278316438, 0.159342468070527, 0, -0.298208438215333, 0, 0, 0, 0,
+      7.30682757526241, 0.999256668956432, -1.33082594407524, -4.95306361630276, 0.490554994733579, 0.442502068793772, -0.835310070621911, 0,
+      -0.403711730133755, 0.672375321924977, 0, 0.335372498461681, 0, -0.330322239630250, -0.366700025738387, 0,
+      -4.79820204505010, 0.709160958437296, 0, 0.472560804537015, 0, -0.0755764830052928, 0, 0,
+      -4.35041760661412, 0.785290791385159, 0, 0.325462132630085, 0, -0.221525656800750, 0, 0,
+      0.424849811725595, -0.181204207590470, 0, 0, 0, 0, 0.401549107903204, 0,
+      -2.97911606394595, 0.420016455603546, 0, 0, 0, 0, 0, 0,
+      -0.703694160589291, 0.160571013696218, 0, -0.145792047865653, 0, 0, 0, 0;
+  
+    tables.params_lower_bound << 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, -3.5, -4.7, 0, 0, 0, 0, 0, -3.5, -4.7;
+
+    tables.params_upper_bound << 0, 0, 3.2, 2, 0, 0, 0, 0, 0, 0, 1.5, 0, 0, 0, 0, 0, 0, 1.5, 0;
+  
+    tables.params_fitted1 << 0, 0, 1.30326178289206, 0, 0, 0, 0, 0, 0, 0, 14.2935537214223, 5.33551936215137, 0, 0, 0, 0, 0, 14.2935537214223, 5.33551936215137;
+  
+    tables.params_fitted2 << 0, 0, 3.96858083951547, 0, 0, 0, 0, 0, 0, 0, 6.40242376475815, 3.82954843573707, 0, 0, 0, 0, 0, 6.40242376475815, 3.82954843573707;
+
+    tables.params_fitted3 << 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4.42179588354923, 0, 0, 0, 0, 0, 0, 4.42179588354923, 0;
+    // clang-format on
+
+    // Covariance of errors in normal space
+    tables.cov_matrix_pulse = numeric_utils::corr_to_cov(
+        tables.corr_matrix_pulse, tables.std_dev_pulse);
+    tables.cov_matrix_nopulse = numeric_utils::corr_to_cov(
+        tables.corr_matrix_nopulse, tables.std_dev_nopulse);
+
+    return tables;
+  }();
+
+  return shared_tables;
+}
+
+/**
+ * Generate white noise with a separate random stream for each ground motion
+ * @tparam Tscalar Floating-point type of white noise
+ * @param[in] stream_seed Seed of random streams
+ * @param[in] spectrum_index Index of parameter set
+ * @param[in] component Index of ground motion component
+ * @param[in] first_gm Index of first ground motion
+ * @param[in] num_gms Number of ground motions
+ * @param[in] num_steps Number of time steps
+ * @return White noise with one ground motion per row
+ */
+template <typename Tscalar>
+Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic> normal_white_noise(
+    std::uint64_t stream_seed, unsigned int spectrum_index,
+    unsigned int component, unsigned int first_gm, unsigned int num_gms,
+    unsigned int num_steps) {
+  Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic> white_noise(
+      num_gms, num_steps);
+  for (unsigned int i = 0; i < num_gms; ++i) {
+    numeric_utils::RandomStream stream(stream_seed, spectrum_index,
+                                       first_gm + i, component);
+    for (unsigned int j = 0; j < num_steps; ++j) {
+      white_noise(i, j) = static_cast<Tscalar>(stream.normal());
+    }
+  }
+
+  return white_noise;
+}
+
+/**
+ * Filter white noise with the time-varying impulse response filter,
+ * truncating the response to each impulse once its exponential envelope drops
+ * below the input tolerance. Impulse responses are evaluated in double
+ * precision and accumulated in the precision of the white noise.
+ * @tparam Tscalar Floating-point type of white noise
+ * @param[in] white_noise White noise with one ground motion per row
+ * @param[in] input_filter Input filter coefficients to use in impulse response
+ * @param[in] zeta Filter parameter
+ * @param[in] tolerance Envelope value relative to the peak at which impulse
+ *                      responses are truncated
+ * @param[in] time_step Time step of white noise
+ * @return Filtered white noise with one ground motion per row
+ */
+template <typename Tscalar>
+Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>
+truncated_impulse_filter(
+    const Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>& white_noise,
+    const std::vector<double>& input_filter, double zeta, double tolerance,
+    double time_step) {
+  const unsigned int num_steps = white_noise.cols();
+  // Work on columns so each time step is contiguous across ground motions
+  Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic> filtered =
+      Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>::Zero(
+          white_noise.rows(), num_steps);
+  auto& arena = utilities::ScratchArena::local();
+  utilities::ScratchArena::Scope scope(arena);
+  auto denominator = arena.vector(num_steps);
+  denominator.setZero();
+  const double damping_factor = std::sqrt(1.0 - zeta * zeta);
+  const double log_tolerance = -std::log(tolerance);
+  // Number of steps after which response is recomputed directly to avoid
+  // accumulating round-off in the recursion
+  const unsigned int anchor_steps = 512;
+
+  for (unsigned int i = 0; i < num_steps; ++i) {
+    double omega = input_filter[i];
+    double decay = zeta * omega;
+    double omega_damped = omega * damping_factor;
+    double amplitude = omega / damping_factor;
+
+    // Truncate where exp(-zeta * omega * t) drops below tolerance
+    unsigned int support = num_steps - i;
+    if (decay > 0.0) {
+      double cutoff = std::ceil(log_tolerance / (decay * time_step)) + 1.0;
+      if (cutoff < support) {
+        support = static_cast<unsigned int>(cutoff);
+      }
+    }
+
+    // Evaluate amplitude * exp((-decay + i * omega_damped) * t) by
+    // multiplying by constant rotation each time step; impulse response is
+    // the imaginary part
+    const std::complex<double> exponent(-decay, omega_damped);
+    const std::complex<double> rotation = std::exp(exponent * time_step);
+    std::complex<double> response(amplitude, 0.0);
+
+    for (unsigned int j = 1; j < support; ++j) {
+      if (j % anchor_steps == 0) {
+        response = amplitude *
+                   std::exp(exponent * (static_cast<double>(j) * time_step));
+      } else {
+        response *= rotation;
+      }
+      double value = response.imag();
+      denominator(i + j) += value * value;
+      filtered.col(i + j).noalias() +=
+          static_cast<Tscalar>(value) * white_noise.col(i);
+    }
+  }
+
+  // Normalize by square root of sum of squared impulse responses at each time
+  denominator = denominator.array().sqrt();
+  denominator(0) = 0.1;
+  for (unsigned int j = 0; j < num_steps; ++j) {
+    filtered.col(j) /= static_cast<Tscalar>(denominator(j));
+  }
+
+  return filtered;
+}
+
+/**
+ * Get the beta distributions of the depth to rupture and gamma residuals
+ * shared by all instances, indexed by parameter. They are created through
+ * the distribution factory key the first time they are requested for the
+ * current setting of config::tabulated_distributions, using the tabulated key
+ * when it is set.
+ * @return Shared beta distributions, null for parameters with other
+ *         marginal distributions
+ */
+const std::vector<std::shared_ptr<stochastic::Distribution>>&
+beta_marginals() {
+  static std::mutex mutex;
+  static std::vector<std::shared_ptr<stochastic::Distribution>>
+      shared_marginals[2];
+  std::lock_guard<std::mutex> lock(mutex);
+  // Read setting once so cached distributions always match their slot
+  const bool tabulated = config::tabulated_distributions();
+  auto& marginals = shared_marginals[tabulated];
+  if (!marginals.empty()) {
+    return marginals;
+  }
+
+  const auto& tables = regression_tables();
+  auto beta_dist_creator =
+      Factory<stochastic::Distribution, double, double>::instance()->resolve(
+          tabulated ? "TabulatedBetaDist" : "BetaDist");
+  marginals.resize(tables.params_fitted1.size());
+  for (unsigned int index : {2, 11, 18}) {
+    marginals[index] = beta_dist_creator.create(
+        static_cast<double>(tables.params_fitted1(index)),
+        static_cast<double>(tables.params_fitted2(index)));
+  }
+  return marginals;
+}
+}  // namespace
 
 stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
     stochastic::FaultType faulting, stochastic::SimulationType simulation_type,
@@ -42,8 +369,21 @@ stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
       truncate_{truncate},
       num_realizations_{num_realizations},
       seed_value_{std::numeric_limits<int>::infinity()},
-      time_step_{0.005}
-{
+      time_step_{0.005},
+      std_dev_pulse_(regression_tables().std_dev_pulse),
+      std_dev_nopulse_(regression_tables().std_dev_nopulse),
+      corr_matrix_pulse_(regression_tables().corr_matrix_pulse),
+      corr_matrix_nopulse_(regression_tables().corr_matrix_nopulse),
+      cov_matrix_pulse_(regression_tables().cov_matrix_pulse),
+      cov_matrix_nopulse_(regression_tables().cov_matrix_nopulse),
+      beta_distribution_pulse_(regression_tables().beta_distribution_pulse),
+      beta_distribution_nopulse_(regression_tables().beta_distribution_nopulse),
+      params_lower_bound_(regression_tables().params_lower_bound),
+      params_upper_bound_(regression_tables().params_upper_bound),
+      params_fitted1_(regression_tables().params_fitted1),
+      params_fitted2_(regression_tables().params_fitted2),
+      params_fitted3_(regression_tables().params_fitted3),
+      beta_marginals_(beta_marginals()) {
   model_name_ = "DabaghiDerKiureghian";
 
   switch (sim_type_) {
@@ -66,120 +406,6 @@ stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
   sample_generator_ =
       Factory<numeric_utils::RandomGenerator>::instance()->create(
           "MultivariateNormal");
-  
-  // Set regression constants
-  std_dev_pulse_.resize(19);
-  std_dev_nopulse_.resize(14);
-  corr_matrix_pulse_.resize(19, 19);
-  corr_matrix_nopulse_.resize(14, 14);
-  beta_distribution_pulse_.resize(19, 8);
-  beta_distribution_nopulse_.resize(14, 8);
-  params_lower_bound_.resize(19);
-  params_upper_bound_.resize(19);
-  params_fitted1_.resize(19);
-  params_fitted2_.resize(19);
-  params_fitted3_.resize(19);  
-
-  // clang-format off
-  std_dev_pulse_ <<
-      0.385316782551070, 0.580604607504062, 1.000000000000000,
-      1.000000000000000, 0.468600626648626, 0.781462017439926,
-      0.371951335342951, 0.442124880737131, 0.393548709857826,
-      0.409988222892834, 0.820134132413354, 1.096436125406160,
-      0.746552904533869, 0.402440900041447, 0.461424491954810,
-      0.407724539607907, 0.440166826670740, 0.824632603897275,
-      0.961997443697123;
-  std_dev_nopulse_ <<
-      1.052723262620090, 0.398427668080412, 0.456828618083131,
-      0.305727090125879, 0.447517114210032, 0.941288665677244,
-      1.007680943597980, 1.028226030318770, 0.375877126809162,
-      0.458413470215522, 0.294118965466636, 0.399966941388161,
-      0.831550984874095, 0.887870513796394;
-
-  corr_matrix_pulse_ <<
-      1, -0.175836500638571, -0.0203457508302324, 0.173589795302921, 0.191081284058678, 0.446601858355920, 0.0422292189436895, 0.0268120615665615, 0.120003074985399, -0.382241273128019, 0.0573276270760638, 0.155115849407343, 0.407222009805941, -0.0405527073664880, 0.0164573906036360, 0.0415103476380082, -0.282855958356553, 0.106173613413053, 0.0486136094283240,
-      -0.175836500638571, 1, 0.183359484001117, 0.00131202858838653, 0.431552926960257, -0.0802776119560438, 0.0983744630339078, 0.310456055209018, 0.368157334142620, 0.0509849248659661, 0.0223164167958617, 0.175239604674009, -0.0979434412969958, 0.143078236501468, 0.295214504980143, 0.370873286184142, 0.0409704140512328, -0.0681917932721656, 0.243299650091412,
-      -0.0203457508302324, 0.183359484001117, 1, -0.190019984820145, 0.242770958876810, 0.178170099097870, 0.107202069371700, 0.150512140384424, 0.236433714526518, -0.114026379004051, 0.0535511100783777, 0.0642193542887409, 0.0688913090123055, 0.127858468767928, 0.0893601270266779, 0.213748741406994, -0.0697188946975121, 0.0212082250410815, 0.123098089235859,
-      0.173589795302921, 0.00131202858838653, -0.190019984820145, 1, 0.119159474433286, -0.0812496120969922, 0.0911626190533515, 0.0653720081018262, 0.0718151835177181, -0.133641807530098, -0.0920397447082436, 0.0299407456292105, -0.0242282623085006, -0.0172855366304964, 0.0663348465393307, 0.0729217102589892, -0.146245197915904, 0.0999563418090508, -0.0409433584122388,
-      0.191081284058678, 0.431552926960257, 0.242770958876810, 0.119159474433286, 1, 0.0597439686298471, 0.163724290728144, 0.733127256394521, 0.788656583220928, -0.0312901152364670, -0.153794052040040, 0.126072923696987, 0.0157717534215698, 0.186868291148981, 0.680765575675777, 0.749289248752773, 0.00752109582582447, -0.165776964800244, 0.192516732945902,
-      0.446601858355920, -0.0802776119560438, 0.178170099097870, -0.0812496120969922, 0.0597439686298471, 1, -0.0244049816649646, 0.0584250580150467, 0.0856617566986387, 0.0783654782068241, 0.0990943110343599, 0.0264806656713516, 0.837794567493788, 0.0235744551632278, 0.00722635162195151, 0.0801743456052000, 0.125480219427063, 0.0813027074983168, 0.0454360407125637,
-      0.0422292189436895, 0.0983744630339078, 0.107202069371700, 0.0911626190533515, 0.163724290728144, -0.0244049816649646, 1, 0.0612360822187756, 0.245411252666782, -0.0247015935697729, -0.224809121780326, 0.0459354003374228, 0.0364365286784528, 0.760546075583923, 0.0370009049319755, 0.205658174145097, -0.0837872744722257, -0.0338684418879410, -0.0274880324550587,
-      0.0268120615665615, 0.310456055209018, 0.150512140384424, 0.0653720081018262, 0.733127256394521, 0.0584250580150467, 0.0612360822187756, 1, 0.855219194729329, 0.0120435632525462, -0.0489647334211007, 0.199955997824984, 0.0212627853872894, 0.146801029873847, 0.931624963947970, 0.850430406207709, 0.0232039506387295, -0.00394570150177181, 0.244390432559234,
-      0.120003074985399, 0.368157334142620, 0.236433714526518, 0.0718151835177181, 0.788656583220928, 0.0856617566986387, 0.245411252666782, 0.855219194729329, 1, 0.0298843738756568, -0.0618147333807716, 0.197760496777865, 0.104861038989822, 0.262606914312613, 0.795537444898935, 0.906602423826413, 0.0381266607245457, -0.0143594270096637, 0.226001111347866,
-      -0.382241273128019, 0.0509849248659661, -0.114026379004051, -0.133641807530098, -0.0312901152364670, 0.0783654782068241, -0.0247015935697729, 0.0120435632525462, 0.0298843738756568, 1, -0.241519621897699, 0.112473855187119, 0.171776282660699, -0.0492035952139502, 0.0493755848461730, 0.112703656481410, 0.864715714588433, -0.286206615545551, 0.157882561174870,
-      0.0573276270760638, 0.0223164167958617, 0.0535511100783777, -0.0920397447082436, -0.153794052040040, 0.0990943110343599, -0.224809121780326, -0.0489647334211007, -0.0618147333807716, -0.241519621897699, 1, 0.112365366315021, -0.0106706754632641, -0.0488287220881385, -0.0635241398373312, -0.0911374530847290, -0.0885687207002145, 0.421522224993818, 0.239492035016932,
-      0.155115849407343, 0.175239604674009, 0.0642193542887409, 0.0299407456292105, 0.126072923696987, 0.0264806656713516, 0.0459354003374228, 0.199955997824984, 0.197760496777865, 0.112473855187119, 0.112365366315021, 1, -0.0274158393051499, 0.0871234642667006, 0.160919524797887, 0.256368904115107, 0.275537783357955, -0.175867301345906, 0.792491388890200,
-      0.407222009805941, -0.0979434412969958, 0.0688913090123055, -0.0242282623085006, 0.0157717534215698, 0.837794567493788, 0.0364365286784528, 0.0212627853872894, 0.104861038989822, 0.171776282660699, -0.0106706754632641, -0.0274158393051499, 1, -0.168436208860883, 0.0139228196755138, 0.0606940022435021, 0.0950730856215810, 0.166344473008140, -0.0377746475967110,
-      -0.0405527073664880, 0.143078236501468, 0.127858468767928, -0.0172855366304964, 0.186868291148981, 0.0235744551632278, 0.760546075583923, 0.146801029873847, 0.262606914312613, -0.0492035952139502, -0.0488287220881385, 0.0871234642667006, -0.168436208860883, 1, 0.0584697041090115, 0.243068478704018, 0.0101378284587601, -0.134310788077535, 0.0858141211009980,
-      0.0164573906036360, 0.295214504980143, 0.0893601270266779, 0.0663348465393307, 0.680765575675777, 0.00722635162195151, 0.0370009049319755, 0.931624963947970, 0.795537444898935, 0.0493755848461730, -0.0635241398373312, 0.160919524797887, 0.0139228196755138, 0.0584697041090115, 1, 0.841226866362572, 0.0319804533198723, 0.0395868643324250, 0.183336741524880,
-      0.0415103476380082, 0.370873286184142, 0.213748741406994, 0.0729217102589892, 0.749289248752773, 0.0801743456052000, 0.205658174145097, 0.850430406207709, 0.906602423826413, 0.112703656481410, -0.0911374530847290, 0.256368904115107, 0.0606940022435021, 0.243068478704018, 0.841226866362572, 1, 0.0999775444207582, -0.0848763381048173, 0.277349661980356,
-      -0.282855958356553, 0.0409704140512328, -0.0697188946975121, -0.146245197915904, 0.00752109582582447, 0.125480219427063, -0.0837872744722257, 0.0232039506387295, 0.0381266607245457, 0.864715714588433, -0.0885687207002145, 0.275537783357955, 0.0950730856215810, 0.0101378284587601, 0.0319804533198723, 0.0999775444207582, 1, -0.432951535761925, 0.262376572921422,
-      0.106173613413053, -0.0681917932721656, 0.0212082250410815, 0.0999563418090508, -0.165776964800244, 0.0813027074983168, -0.0338684418879410, -0.00394570150177181, -0.0143594270096637, -0.286206615545551, 0.421522224993818, -0.175867301345906, 0.166344473008140, -0.134310788077535, 0.0395868643324250, -0.0848763381048173, -0.432951535761925, 1, -0.184861197592255,
-      0.0486136094283240, 0.243299650091412, 0.123098089235859, -0.0409433584122388, 0.192516732945902, 0.0454360407125637, -0.0274880324550587, 0.244390432559234, 0.226001111347866, 0.157882561174870, 0.239492035016932, 0.792491388890200, -0.0377746475967110, 0.0858141211009980, 0.183336741524880, 0.277349661980356, 0.262376572921422, -0.184861197592255, 1;
-
-  corr_matrix_nopulse_ <<
-      1, -0.183620641202513, 0.0890171218487119, 0.104132896092390, 0.0143281984142704, 0.202871723469377, -0.151909317725644, 0.945163870283100, -0.0778432911362303, 0.0495683691288216, 0.0966843496273208, 0.0917721771113965, 0.103741261286614, -0.121195511065596,
-      -0.183620641202513, 1, 0.0854423655718587, 0.307373593686928, -0.0150490152853094, -0.149397471797000, 0.0888348816281089, -0.0794047082384602, 0.848433024094089, 0.0950830201555768, 0.288741920713302, -0.0596971902001111, -0.0160895956989375, 0.113905908782625,
-      0.0890171218487119, 0.0854423655718587, 1, 0.813213357087557, -0.225438606252670, 0.000735703328121357, -0.0840944291284059, 0.0562899783045387, 0.137192754102300, 0.907605550316775, 0.788263163970441, -0.189167012249831, -0.0219422025252862, -0.0931560965857281,
-      0.104132896092390, 0.307373593686928, 0.813213357087557, 1, -0.162877782549727, -0.0946212742252604, -0.0192432432422716, 0.131014027317413, 0.289495591671556, 0.752836252137069, 0.908489822222397, -0.151488045845577, -0.0637984858287899, -0.0498615936932623,
-      0.0143281984142704, -0.0150490152853094, -0.225438606252670, -0.162877782549727, 1, -0.187527904866745, -0.163661457269968, 0.0720174301613615, -0.0805658506819631, -0.173027594836660, -0.165135405413428, 0.897082085156820, -0.0778400029130002, -0.00420375269007833,
-      0.202871723469377, -0.149397471797000, 0.000735703328121357, -0.0946212742252604, -0.187527904866745, 1, -0.0853760806838177, 0.151981779909482, -0.0282514238500333, 0.00217240817323823, -0.0879254146125414, -0.0874961774514421, 0.647468312996265, -0.157070775414507,
-      -0.151909317725644, 0.0888348816281089, -0.0840944291284059, -0.0192432432422716, -0.163661457269968, -0.0853760806838177, 1, -0.109821275189057, 0.0605607584025393, -0.0674419385042876, -0.0178734643092523, -0.0879585887923949, -0.105931812299965, 0.761324011431321,
-      0.945163870283100, -0.0794047082384602, 0.0562899783045387, 0.131014027317413, 0.0720174301613615, 0.151981779909482, -0.109821275189057, 1, -0.0744735914486929, 0.0477307773362732, 0.116976058986177, 0.104731056969540, 0.137507782979518, -0.107158677162180,
-      -0.0778432911362303, 0.848433024094089, 0.137192754102300, 0.289495591671556, -0.0805658506819631, -0.0282514238500333, 0.0605607584025393, -0.0744735914486929, 1, 0.0782297693189997, 0.294723991917604, -0.0895932216480470, -0.0501878780366773, 0.0967842822751738,
-      0.0495683691288216, 0.0950830201555768, 0.907605550316775, 0.752836252137069, -0.173027594836660, 0.00217240817323823, -0.0674419385042876, 0.0477307773362732, 0.0782297693189997, 1, 0.786122088469745, -0.177521125226899, 0.00868592321024064, -0.0671981184080449,
-      0.0966843496273208, 0.288741920713302, 0.788263163970441, 0.908489822222397, -0.165135405413428, -0.0879254146125414, -0.0178734643092523, 0.116976058986177, 0.294723991917604, 0.786122088469745, 1, -0.168356869639510, -0.0773913106180435, -0.0274804568206274,
-      0.0917721771113965, -0.0596971902001111, -0.189167012249831, -0.151488045845577, 0.897082085156820, -0.0874961774514421, -0.0879585887923949, 0.104731056969540, -0.0895932216480470, -0.177521125226899, -0.168356869639510, 1, -0.183773515755380, 0.00693211686662153,
-      0.103741261286614, -0.0160895956989375, -0.0219422025252862, -0.0637984858287899, -0.0778400029130002, 0.647468312996265, -0.105931812299965, 0.137507782979518, -0.0501878780366773, 0.00868592321024064, -0.0773913106180435, -0.183773515755380, 1, -0.110874872058067,
-      -0.121195511065596, 0.113905908782625, -0.0931560965857281, -0.0498615936932623, -0.00420375269007833, -0.157070775414507, 0.761324011431321, -0.107158677162180, 0.0967842822751738, -0.0671981184080449, -0.0274804568206274, 0.00693211686662153, -0.110874872058067, 1;
-
-  beta_distribution_pulse_ <<
-    1.69862554416145, 0.608190177030033, -0.608190177030033, -0.576217471720854, 0, 0.183071013159864, -0.0939319189357984, 0.00657091132855174,
-    -2.47924338395758, 0.670395625327187, 0, 0, 0, -0.263957799575519, -0.232548659903406, 0.00791988432530859,
-    0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0,
-    -4.24873260256537, 0.852185710838635, 0, 0.389602053633798, 0, -0.380323064996537, -0.0880126751081291, 0,
-    -2.11599237942931, 1.47405211856417, -1.37810504103118, -1.07311968166742, 0, 0.336513504829882, 0, 0,
-    -0.381092000896248, 0.732824259094057, 0, 0.216502277780155, 0, -0.162653108888503, -0.426573570884097, 0,
-    -5.56310544580757, 0.905239391642438, 0, 0.385150957140062, 0, -0.282428134685156, 0, 0,
-    -4.77682417817789, 0.879981585446539, 0, 0.310609998745732, 0, -0.339225914155431, 0, 0,
-    0.966712608298821, -0.110938996751065, 0, 0, 0, 0, 0.183289269601829, 0,
-    -2.16587686889173, 0.321501356495567, 0, 0, 0, 0, 0, 0,
-    -1.70734873800232, 0.433032709755610, 0, -0.412648447269525, 0, 0, 0, 0,
-    -0.263198077701693, 1.13060571952101, -1.16957372638359, -1.65164476300789, 0.104746885300915, 0.404058507352901, 0, 0,
-    -0.515969600508314, 0.754135122993588, 0, 0.191575083960373, 0, -0.121665118341219, -0.423844926774291, 0,
-    -5.77208004012831, 0.923144661954273, 0, 0.402940883581593, 0, -0.238200773846646, 0, 0,
-    -5.01588271867143, 0.905027154000921, 0, 0.326841161038211, 0, -0.328283913521590, 0, 0,
-    0.434339606308037, -0.125225415996048, 0, 0, 0, 0, 0.301631247865572, 0,
-    -2.87544520181323, 0.415682222485807, 0, 0, 0, 0, 0, 0,
-    -1.86755738290362, 0.457448335779201, 0, -0.501103981295545, 0, 0, 0, 0;
-
-  beta_distribution_nopulse_ <<
-    8.09695881287823, 1.00609515629221, -1.39347614723327, -4.85869770683701, 0.472644100309933, 0.434550762616159, -0.862562872197509, 0,
-    -1.03473761679032, 0.769091178587874, 0, 0.412237308297152, 0, -0.377739650769220, -0.424234099315427, 0,
-    -4.72728279119446, 0.709717476708319, 0, 0.470974168011549, 0, -0.123518047425648, 0, 0,
-    -4.44400222195478, 0.798093247074753, 0, 0.345405210060350, 0, -0.230823340141895, 0, 0,
-    0.247133528936450, -0.149209862203390, 0, 0, 0, 0, 0.377202902904920, 0,
-    -1.44302935447839, 0.223053706671624, 0, 0, 0, 0, 0, 0,
-    -0.380413278316438, 0.159342468070527, 0, -0.298208438215333, 0, 0, 0, 0,
-    7.30682757526241, 0.999256668956432, -1.33082594407524, -4.95306361630276, 0.490554994733579, 0.442502068793772, -0.835310070621911, 0,
-    -0.403711730133755, 0.672375321924977, 0, 0.335372498461681, 0, -0.330322239630250, -0.366700025738387, 0,
-    -4.79820204505010, 0.709160958437296, 0, 0.472560804537015, 0, -0.0755764830052928, 0, 0,
-    -4.35041760661412, 0.785290791385159, 0, 0.325462132630085, 0, -0.221525656800750, 0, 0,
-    0.424849811725595, -0.181204207590470, 0, 0, 0, 0, 0.401549107903204, 0,
-    -2.97911606394595, 0.420016455603546, 0, 0, 0, 0, 0, 0,
-    -0.703694160589291, 0.160571013696218, 0, -0.145792047865653, 0, 0, 0, 0;
-  
-  params_lower_bound_ << 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, -3.5, -4.7, 0, 0, 0, 0, 0, -3.5, -4.7;
-
-  params_upper_bound_ << 0, 0, 3.2, 2, 0, 0, 0, 0, 0, 0, 1.5, 0, 0, 0, 0, 0, 0, 1.5, 0;
-  
-  params_fitted1_ << 0, 0, 1.30326178289206, 0, 0, 0, 0, 0, 0, 0, 14.2935537214223, 5.33551936215137, 0, 0, 0, 0, 0, 14.2935537214223, 5.33551936215137;
-  
-  params_fitted2_ << 0, 0, 3.96858083951547, 0, 0, 0, 0, 0, 0, 0, 6.40242376475815, 3.82954843573707, 0, 0, 0, 0, 0, 6.40242376475815, 3.82954843573707;
-
-  params_fitted3_ << 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4.42179588354923, 0, 0, 0, 0, 0, 0, 4.42179588354923, 0;
-  // clang-format on  
 }
 
 stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
@@ -199,8 +425,21 @@ stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
       truncate_{truncate},
       num_realizations_{num_realizations},
       seed_value_{seed_value},
-      time_step_{0.005}
-{
+      time_step_{0.005},
+      std_dev_pulse_(regression_tables().std_dev_pulse),
+      std_dev_nopulse_(regression_tables().std_dev_nopulse),
+      corr_matrix_pulse_(regression_tables().corr_matrix_pulse),
+      corr_matrix_nopulse_(regression_tables().corr_matrix_nopulse),
+      cov_matrix_pulse_(regression_tables().cov_matrix_pulse),
+      cov_matrix_nopulse_(regression_tables().cov_matrix_nopulse),
+      beta_distribution_pulse_(regression_tables().beta_distribution_pulse),
+      beta_distribution_nopulse_(regression_tables().beta_distribution_nopulse),
+      params_lower_bound_(regression_tables().params_lower_bound),
+      params_upper_bound_(regression_tables().params_upper_bound),
+      params_fitted1_(regression_tables().params_fitted1),
+      params_fitted2_(regression_tables().params_fitted2),
+      params_fitted3_(regression_tables().params_fitted3),
+      beta_marginals_(beta_marginals()) {
   model_name_ = "DabaghiDerKiureghian";
 
   switch (sim_type_) {
@@ -223,311 +462,314 @@ stochastic::DabaghiDerKiureghian::DabaghiDerKiureghian(
   sample_generator_ =
       Factory<numeric_utils::RandomGenerator, int>::instance()->create(
           "MultivariateNormal", std::move(seed_value_));
-  
-  // Set regression constants
-  std_dev_pulse_.resize(19);
-  std_dev_nopulse_.resize(14);
-  corr_matrix_pulse_.resize(19, 19);
-  corr_matrix_nopulse_.resize(14, 14);
-  beta_distribution_pulse_.resize(19, 8);
-  beta_distribution_nopulse_.resize(14, 8);
-  params_lower_bound_.resize(19);
-  params_upper_bound_.resize(19);
-  params_fitted1_.resize(19);
-  params_fitted2_.resize(19);
-  params_fitted3_.resize(19);  
-
-  // clang-format off
-  std_dev_pulse_ <<
-      0.385316782551070, 0.580604607504062, 1.000000000000000,
-      1.000000000000000, 0.468600626648626, 0.781462017439926,
-      0.371951335342951, 0.442124880737131, 0.393548709857826,
-      0.409988222892834, 0.820134132413354, 1.096436125406160,
-      0.746552904533869, 0.402440900041447, 0.461424491954810,
-      0.407724539607907, 0.440166826670740, 0.824632603897275,
-      0.961997443697123;
-  std_dev_nopulse_ <<
-      1.052723262620090, 0.398427668080412, 0.456828618083131,
-      0.305727090125879, 0.447517114210032, 0.941288665677244,
-      1.007680943597980, 1.028226030318770, 0.375877126809162,
-      0.458413470215522, 0.294118965466636, 0.399966941388161,
-      0.831550984874095, 0.887870513796394;
-
-  corr_matrix_pulse_ <<
-      1, -0.175836500638571, -0.0203457508302324, 0.173589795302921, 0.191081284058678, 0.446601858355920, 0.0422292189436895, 0.0268120615665615, 0.120003074985399, -0.382241273128019, 0.0573276270760638, 0.155115849407343, 0.407222009805941, -0.0405527073664880, 0.0164573906036360, 0.0415103476380082, -0.282855958356553, 0.106173613413053, 0.0486136094283240,
-      -0.175836500638571, 1, 0.183359484001117, 0.00131202858838653, 0.431552926960257, -0.0802776119560438, 0.0983744630339078, 0.310456055209018, 0.368157334142620, 0.0509849248659661, 0.0223164167958617, 0.175239604674009, -0.0979434412969958, 0.143078236501468, 0.295214504980143, 0.370873286184142, 0.0409704140512328, -0.0681917932721656, 0.243299650091412,
-      -0.0203457508302324, 0.183359484001117, 1, -0.190019984820145, 0.242770958876810, 0.178170099097870, 0.107202069371700, 0.150512140384424, 0.236433714526518, -0.114026379004051, 0.0535511100783777, 0.0642193542887409, 0.0688913090123055, 0.127858468767928, 0.0893601270266779, 0.213748741406994, -0.0697188946975121, 0.0212082250410815, 0.123098089235859,
-      0.173589795302921, 0.00131202858838653, -0.190019984820145, 1, 0.119159474433286, -0.0812496120969922, 0.0911626190533515, 0.0653720081018262, 0.0718151835177181, -0.133641807530098, -0.0920397447082436, 0.0299407456292105, -0.0242282623085006, -0.0172855366304964, 0.0663348465393307, 0.0729217102589892, -0.146245197915904, 0.0999563418090508, -0.0409433584122388,
-      0.191081284058678, 0.431552926960257, 0.242770958876810, 0.119159474433286, 1, 0.0597439686298471, 0.163724290728144, 0.733127256394521, 0.788656583220928, -0.0312901152364670, -0.153794052040040, 0.126072923696987, 0.0157717534215698, 0.186868291148981, 0.680765575675777, 0.749289248752773, 0.00752109582582447, -0.165776964800244, 0.192516732945902,
-      0.446601858355920, -0.0802776119560438, 0.178170099097870, -0.0812496120969922, 0.0597439686298471, 1, -0.0244049816649646, 0.0584250580150467, 0.0856617566986387, 0.0783654782068241, 0.0990943110343599, 0.0264806656713516, 0.837794567493788, 0.0235744551632278, 0.00722635162195151, 0.0801743456052000, 0.125480219427063, 0.0813027074983168, 0.0454360407125637,
-      0.0422292189436895, 0.0983744630339078, 0.107202069371700, 0.0911626190533515, 0.163724290728144, -0.0244049816649646, 1, 0.0612360822187756, 0.245411252666782, -0.0247015935697729, -0.224809121780326, 0.0459354003374228, 0.0364365286784528, 0.760546075583923, 0.0370009049319755, 0.205658174145097, -0.0837872744722257, -0.0338684418879410, -0.0274880324550587,
-      0.0268120615665615, 0.310456055209018, 0.150512140384424, 0.0653720081018262, 0.733127256394521, 0.0584250580150467, 0.0612360822187756, 1, 0.855219194729329, 0.0120435632525462, -0.0489647334211007, 0.199955997824984, 0.0212627853872894, 0.146801029873847, 0.931624963947970, 0.850430406207709, 0.0232039506387295, -0.00394570150177181, 0.244390432559234,
-      0.120003074985399, 0.368157334142620, 0.236433714526518, 0.0718151835177181, 0.788656583220928, 0.0856617566986387, 0.245411252666782, 0.855219194729329, 1, 0.0298843738756568, -0.0618147333807716, 0.197760496777865, 0.104861038989822, 0.262606914312613, 0.795537444898935, 0.906602423826413, 0.0381266607245457, -0.0143594270096637, 0.226001111347866,
-      -0.382241273128019, 0.0509849248659661, -0.114026379004051, -0.133641807530098, -0.0312901152364670, 0.0783654782068241, -0.0247015935697729, 0.0120435632525462, 0.0298843738756568, 1, -0.241519621897699, 0.112473855187119, 0.171776282660699, -0.0492035952139502, 0.0493755848461730, 0.112703656481410, 0.864715714588433, -0.286206615545551, 0.157882561174870,
-      0.0573276270760638, 0.0223164167958617, 0.0535511100783777, -0.0920397447082436, -0.153794052040040, 0.0990943110343599, -0.224809121780326, -0.0489647334211007, -0.0618147333807716, -0.241519621897699, 1, 0.112365366315021, -0.0106706754632641, -0.0488287220881385, -0.0635241398373312, -0.0911374530847290, -0.0885687207002145, 0.421522224993818, 0.239492035016932,
-      0.155115849407343, 0.175239604674009, 0.0642193542887409, 0.0299407456292105, 0.126072923696987, 0.0264806656713516, 0.0459354003374228, 0.199955997824984, 0.197760496777865, 0.112473855187119, 0.112365366315021, 1, -0.0274158393051499, 0.0871234642667006, 0.160919524797887, 0.256368904115107, 0.275537783357955, -0.175867301345906, 0.792491388890200,
-      0.407222009805941, -0.0979434412969958, 0.0688913090123055, -0.0242282623085006, 0.0157717534215698, 0.837794567493788, 0.0364365286784528, 0.0212627853872894, 0.104861038989822, 0.171776282660699, -0.0106706754632641, -0.0274158393051499, 1, -0.168436208860883, 0.0139228196755138, 0.0606940022435021, 0.0950730856215810, 0.166344473008140, -0.0377746475967110,
-      -0.0405527073664880, 0.143078236501468, 0.127858468767928, -0.0172855366304964, 0.186868291148981, 0.0235744551632278, 0.760546075583923, 0.146801029873847, 0.262606914312613, -0.0492035952139502, -0.0488287220881385, 0.0871234642667006, -0.168436208860883, 1, 0.0584697041090115, 0.243068478704018, 0.0101378284587601, -0.134310788077535, 0.0858141211009980,
-      0.0164573906036360, 0.295214504980143, 0.0893601270266779, 0.0663348465393307, 0.680765575675777, 0.00722635162195151, 0.0370009049319755, 0.931624963947970, 0.795537444898935, 0.0493755848461730, -0.0635241398373312, 0.160919524797887, 0.0139228196755138, 0.0584697041090115, 1, 0.841226866362572, 0.0319804533198723, 0.0395868643324250, 0.183336741524880,
-      0.0415103476380082, 0.370873286184142, 0.213748741406994, 0.0729217102589892, 0.749289248752773, 0.0801743456052000, 0.205658174145097, 0.850430406207709, 0.906602423826413, 0.112703656481410, -0.0911374530847290, 0.256368904115107, 0.0606940022435021, 0.243068478704018, 0.841226866362572, 1, 0.0999775444207582, -0.0848763381048173, 0.277349661980356,
-      -0.282855958356553, 0.0409704140512328, -0.0697188946975121, -0.146245197915904, 0.00752109582582447, 0.125480219427063, -0.0837872744722257, 0.0232039506387295, 0.0381266607245457, 0.864715714588433, -0.0885687207002145, 0.275537783357955, 0.0950730856215810, 0.0101378284587601, 0.0319804533198723, 0.0999775444207582, 1, -0.432951535761925, 0.262376572921422,
-      0.106173613413053, -0.0681917932721656, 0.0212082250410815, 0.0999563418090508, -0.165776964800244, 0.0813027074983168, -0.0338684418879410, -0.00394570150177181, -0.0143594270096637, -0.286206615545551, 0.421522224993818, -0.175867301345906, 0.166344473008140, -0.134310788077535, 0.0395868643324250, -0.0848763381048173, -0.432951535761925, 1, -0.184861197592255,
-      0.0486136094283240, 0.243299650091412, 0.123098089235859, -0.0409433584122388, 0.192516732945902, 0.0454360407125637, -0.0274880324550587, 0.244390432559234, 0.226001111347866, 0.157882561174870, 0.239492035016932, 0.792491388890200, -0.0377746475967110, 0.0858141211009980, 0.183336741524880, 0.277349661980356, 0.262376572921422, -0.184861197592255, 1;
-
-  corr_matrix_nopulse_ <<
-      1, -0.183620641202513, 0.0890171218487119, 0.104132896092390, 0.0143281984142704, 0.202871723469377, -0.151909317725644, 0.945163870283100, -0.0778432911362303, 0.0495683691288216, 0.0966843496273208, 0.0917721771113965, 0.103741261286614, -0.121195511065596,
-      -0.183620641202513, 1, 0.0854423655718587, 0.307373593686928, -0.0150490152853094, -0.149397471797000, 0.0888348816281089, -0.0794047082384602, 0.848433024094089, 0.0950830201555768, 0.288741920713302, -0.0596971902001111, -0.0160895956989375, 0.113905908782625,
-      0.0890171218487119, 0.0854423655718587, 1, 0.813213357087557, -0.225438606252670, 0.000735703328121357, -0.0840944291284059, 0.0562899783045387, 0.137192754102300, 0.907605550316775, 0.788263163970441, -0.189167012249831, -0.0219422025252862, -0.0931560965857281,
-      0.104132896092390, 0.307373593686928, 0.813213357087557, 1, -0.162877782549727, -0.0946212742252604, -0.0192432432422716, 0.131014027317413, 0.289495591671556, 0.752836252137069, 0.908489822222397, -0.151488045845577, -0.0637984858287899, -0.0498615936932623,
-      0.0143281984142704, -0.0150490152853094, -0.225438606252670, -0.162877782549727, 1, -0.187527904866745, -0.163661457269968, 0.0720174301613615, -0.0805658506819631, -0.173027594836660, -0.165135405413428, 0.897082085156820, -0.0778400029130002, -0.00420375269007833,
-      0.202871723469377, -0.149397471797000, 0.000735703328121357, -0.0946212742252604, -0.187527904866745, 1, -0.0853760806838177, 0.151981779909482, -0.0282514238500333, 0.00217240817323823, -0.0879254146125414, -0.0874961774514421, 0.647468312996265, -0.157070775414507,
-      -0.151909317725644, 0.0888348816281089, -0.0840944291284059, -0.0192432432422716, -0.163661457269968, -0.0853760806838177, 1, -0.109821275189057, 0.0605607584025393, -0.0674419385042876, -0.0178734643092523, -0.0879585887923949, -0.105931812299965, 0.761324011431321,
-      0.945163870283100, -0.0794047082384602, 0.0562899783045387, 0.131014027317413, 0.0720174301613615, 0.151981779909482, -0.109821275189057, 1, -0.0744735914486929, 0.0477307773362732, 0.116976058986177, 0.104731056969540, 0.137507782979518, -0.107158677162180,
-      -0.0778432911362303, 0.848433024094089, 0.137192754102300, 0.289495591671556, -0.0805658506819631, -0.0282514238500333, 0.0605607584025393, -0.0744735914486929, 1, 0.0782297693189997, 0.294723991917604, -0.0895932216480470, -0.0501878780366773, 0.0967842822751738,
-      0.0495683691288216, 0.0950830201555768, 0.907605550316775, 0.752836252137069, -0.173027594836660, 0.00217240817323823, -0.0674419385042876, 0.0477307773362732, 0.0782297693189997, 1, 0.786122088469745, -0.177521125226899, 0.00868592321024064, -0.0671981184080449,
-      0.0966843496273208, 0.288741920713302, 0.788263163970441, 0.908489822222397, -0.165135405413428, -0.0879254146125414, -0.0178734643092523, 0.116976058986177, 0.294723991917604, 0.786122088469745, 1, -0.168356869639510, -0.0773913106180435, -0.0274804568206274,
-      0.0917721771113965, -0.0596971902001111, -0.189167012249831, -0.151488045845577, 0.897082085156820, -0.0874961774514421, -0.0879585887923949, 0.104731056969540, -0.0895932216480470, -0.177521125226899, -0.168356869639510, 1, -0.183773515755380, 0.00693211686662153,
-      0.103741261286614, -0.0160895956989375, -0.0219422025252862, -0.0637984858287899, -0.0778400029130002, 0.647468312996265, -0.105931812299965, 0.137507782979518, -0.0501878780366773, 0.00868592321024064, -0.0773913106180435, -0.183773515755380, 1, -0.110874872058067,
-      -0.121195511065596, 0.113905908782625, -0.0931560965857281, -0.0498615936932623, -0.00420375269007833, -0.157070775414507, 0.761324011431321, -0.107158677162180, 0.0967842822751738, -0.0671981184080449, -0.0274804568206274, 0.00693211686662153, -0.110874872058067, 1;
-
-  beta_distribution_pulse_ <<
-    1.69862554416145, 0.608190177030033, -0.608190177030033, -0.576217471720854, 0, 0.183071013159864, -0.0939319189357984, 0.00657091132855174,
-    -2.47924338395758, 0.670395625327187, 0, 0, 0, -0.263957799575519, -0.232548659903406, 0.00791988432530859,
-    0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0,
-    -4.24873260256537, 0.852185710838635, 0, 0.389602053633798, 0, -0.380323064996537, -0.0880126751081291, 0,
-    -2.11599237942931, 1.47405211856417, -1.37810504103118, -1.07311968166742, 0, 0.336513504829882, 0, 0,
-    -0.381092000896248, 0.732824259094057, 0, 0.216502277780155, 0, -0.162653108888503, -0.426573570884097, 0,
-    -5.56310544580757, 0.905239391642438, 0, 0.385150957140062, 0, -0.282428134685156, 0, 0,
-    -4.77682417817789, 0.879981585446539, 0, 0.310609998745732, 0, -0.339225914155431, 0, 0,
-    0.966712608298821, -0.110938996751065, 0, 0, 0, 0, 0.183289269601829, 0,
-    -2.16587686889173, 0.321501356495567, 0, 0, 0, 0, 0, 0,
-    -1.70734873800232, 0.433032709755610, 0, -0.412648447269525, 0, 0, 0, 0,
-    -0.263198077701693, 1.13060571952101, -1.16957372638359, -1.65164476300789, 0.104746885300915, 0.404058507352901, 0, 0,
-    -0.515969600508314, 0.754135122993588, 0, 0.191575083960373, 0, -0.121665118341219, -0.423844926774291, 0,
-    -5.77208004012831, 0.923144661954273, 0, 0.402940883581593, 0, -0.238200773846646, 0, 0,
-    -5.01588271867143, 0.905027154000921, 0, 0.326841161038211, 0, -0.328283913521590, 0, 0,
-    0.434339606308037, -0.125225415996048, 0, 0, 0, 0, 0.301631247865572, 0,
-    -2.87544520181323, 0.415682222485807, 0, 0, 0, 0, 0, 0,
-    -1.86755738290362, 0.457448335779201, 0, -0.501103981295545, 0, 0, 0, 0;
-
-  beta_distribution_nopulse_ <<
-    8.09695881287823, 1.00609515629221, -1.39347614723327, -4.85869770683701, 0.472644100309933, 0.434550762616159, -0.862562872197509, 0,
-    -1.03473761679032, 0.769091178587874, 0, 0.412237308297152, 0, -0.377739650769220, -0.424234099315427, 0,
-    -4.72728279119446, 0.709717476708319, 0, 0.470974168011549, 0, -0.123518047425648, 0, 0,
-    -4.44400222195478, 0.798093247074753, 0, 0.345405210060350, 0, -0.230823340141895, 0, 0,
-    0.247133528936450, -0.149209862203390, 0, 0, 0, 0, 0.377202902904920, 0,
-    -1.44302935447839, 0.223053706671624, 0, 0, 0, 0, 0, 0,
-    -0.380413278316438, 0.159342468070527, 0, -0.298208438215333, 0, 0, 0, 0,
-    7.30682757526241, 0.999256668956432, -1.33082594407524, -4.95306361630276, 0.490554994733579, 0.442502068793772, -0.835310070621911, 0,
-    -0.403711730133755, 0.672375321924977, 0, 0.335372498461681, 0, -0.330322239630250, -0.366700025738387, 0,
-    -4.79820204505010, 0.709160958437296, 0, 0.472560804537015, 0, -0.0755764830052928, 0, 0,
-    -4.35041760661412, 0.785290791385159, 0, 0.325462132630085, 0, -0.221525656800750, 0, 0,
-    0.424849811725595, -0.181204207590470, 0, 0, 0, 0, 0.401549107903204, 0,
-    -2.97911606394595, 0.420016455603546, 0, 0, 0, 0, 0, 0,
-    -0.703694160589291, 0.160571013696218, 0, -0.145792047865653, 0, 0, 0, 0;
-
-  params_lower_bound_ << 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, -3.5, -4.7, 0, 0, 0, 0, 0, -3.5, -4.7;
-  
-  params_upper_bound_ << 0, 0, 3.2, 2, 0, 0, 0, 0, 0, 0, 1.5, 0, 0, 0, 0, 0, 0, 1.5, 0;
-  
-  params_fitted1_ << 0, 0, 1.30326178289206, 0, 0, 0, 0, 0, 0, 0, 14.2935537214223, 5.33551936215137, 0, 0, 0, 0, 0, 14.2935537214223, 5.33551936215137;
-  
-  params_fitted2_ << 0, 0, 3.96858083951547, 0, 0, 0, 0, 0, 0, 0, 6.40242376475815, 3.82954843573707, 0, 0, 0, 0, 0, 6.40242376475815, 3.82954843573707;
-
-  params_fitted3_ << 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4.42179588354923, 0, 0, 0, 0, 0, 0, 4.42179588354923, 0;
-  // clang-format on
 }
 
-utilities::JsonObject stochastic::DabaghiDerKiureghian::generate(
-    const std::string& event_name, bool units) {
-
-  // Create vectors for pulse-like and non-pulse-like motions
-  std::vector<std::vector<std::vector<double>>> pulse_motions_comp1(
-      num_sims_pulse_, std::vector<std::vector<double>>(num_realizations_,
-                                                        std::vector<double>()));
-
-  std::vector<std::vector<std::vector<double>>> pulse_motions_comp2(
-      num_sims_pulse_, std::vector<std::vector<double>>(num_realizations_,
-                                                        std::vector<double>()));
+std::size_t stochastic::DabaghiDerKiureghian::num_records() const {
+  return static_cast<std::size_t>(num_sims_pulse_ + num_sims_nopulse_) *
+         num_realizations_;
+}
 
-  std::vector<std::vector<std::vector<double>>> nopulse_motions_comp1(
-      num_sims_nopulse_, std::vector<std::vector<double>>(
-                             num_realizations_, std::vector<double>()));
+stochastic::RecordIterator stochastic::DabaghiDerKiureghian::records(
+    const std::string& event_name, bool units, std::size_t batch_size) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
 
-  std::vector<std::vector<std::vector<double>>> nopulse_motions_comp2(
-      num_sims_nopulse_, std::vector<std::vector<double>>(
-                             num_realizations_, std::vector<double>()));
+  // Select seed of random streams used for white noise. Each batch restores
+  // the seed, so records of the iterator share one set of streams even when
+  // other calls to generate select new seeds in between.
+  std::uint64_t stream_seed = numeric_utils::stream_seed(seed_value_);
+  stream_seed_ = stream_seed;
 
-  // Generated simulated acceleration time histories
+  std::shared_ptr<ParameterSets> parameter_sets;
   try {
-    // Simulate model parameters
-    Eigen::MatrixXd parameters_pulse =
-        simulate_model_parameters(true, num_sims_pulse_);
-    Eigen::MatrixXd parameters_nopulse =
-        simulate_model_parameters(false, num_sims_nopulse_);
-
-    // Simulate pulse-like motions
-    for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-        simulate_near_fault_ground_motion(
-            true, parameters_pulse.row(i), pulse_motions_comp1[i],
-            pulse_motions_comp2[i], num_realizations_);
-    } 
-
-    // Simulate non-pulse-like motions
-    for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
-      simulate_near_fault_ground_motion(
-          false, parameters_nopulse.row(i), nopulse_motions_comp1[i],
-          nopulse_motions_comp2[i], num_realizations_);
-    }
-
-    // If requested, truncate and baseline correct time histories
-    double gfactor = 981;
-    unsigned int fit_order = 5;
-    if (truncate_) {
-      // First truncate motions
-      for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-        truncate_time_histories(pulse_motions_comp1[i], pulse_motions_comp2[i],
-                                gfactor);
-      }
-
-      for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
-        truncate_time_histories(nopulse_motions_comp1[i],
-                                nopulse_motions_comp2[i], gfactor);
-      }
+    parameter_sets = std::make_shared<ParameterSets>(simulate_parameter_sets());
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    throw;
+  }
 
-      // Baseline correct truncated pulse-like motions
-      for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-        for (unsigned int j = 0; j < num_realizations_; ++j) {
-          baseline_correct_time_history(pulse_motions_comp1[i][j], gfactor,
-                                        fit_order);
-          baseline_correct_time_history(pulse_motions_comp2[i][j], gfactor,
-                                        fit_order);
+  // Appended realizations continue the campaign of this call
+  campaign_.parameter_sets = parameter_sets;
+  campaign_.stream_seed = stream_seed;
+
+  return RecordIterator(
+      num_records(),
+      batch_size > 0 ? batch_size : utilities::thread_count(num_threads_),
+      [this, event_name, units, stream_seed, parameter_sets](
+          std::size_t first_record, std::size_t num_records,
+          std::vector<RecordMetadata>* metadata) {
+        SMELT_PROFILE_ACTIVATE(profile_);
+        if (stream_seed_ != stream_seed) {
+          stream_seed_ = stream_seed;
         }
-      }
-
-      // Baseline correct trunacted non-pulse-like motions
-      for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
-        for (unsigned int j = 0; j < num_realizations_; ++j) {
-          baseline_correct_time_history(nopulse_motions_comp1[i][j], gfactor,
-                                        fit_order);
-          baseline_correct_time_history(nopulse_motions_comp2[i][j], gfactor,
-                                        fit_order);
+        auto records =
+            generate_range(units, *parameter_sets, first_record, num_records);
+        if (metadata) {
+          records_metadata(event_name, records, first_record, *metadata);
         }
-      }
-    }
+        return records;
+      });
+}
+
+stochastic::DabaghiDerKiureghian::ParameterSets
+stochastic::DabaghiDerKiureghian::simulate_parameter_sets() {
+  // Simulate model parameters
+  ParameterSets parameter_sets;
+  parameter_sets.pulse = simulate_model_parameters(true, num_sims_pulse_);
+  parameter_sets.nopulse = simulate_model_parameters(false, num_sims_nopulse_);
+
+  // Back-calculate modulating function parameters once per parameter set
+  // and component. Threads left over when there are fewer tasks than
+  // threads are used for the starting points of each minimization.
+  unsigned int num_param_sets = num_sims_pulse_ + num_sims_nopulse_;
+  parameter_sets.modulating_params_1.resize(num_param_sets);
+  parameter_sets.modulating_params_2.resize(num_param_sets);
+  unsigned int num_modulating_tasks = 2 * num_param_sets;
+  unsigned int minimizer_threads =
+      std::max(1u, utilities::thread_count(num_threads_) /
+                       std::max(num_modulating_tasks, 1u));
+  utilities::parallel_for(
+      num_modulating_tasks, num_threads_, [&](unsigned int k) {
+        unsigned int i = k / 2, component = k % 2;
+        Eigen::VectorXd parameters =
+            i < num_sims_pulse_
+                ? parameter_sets.pulse.row(i).transpose()
+                : parameter_sets.nopulse.row(i - num_sims_pulse_).transpose();
+        unsigned int offset = (i < num_sims_pulse_ ? 5 : 0) + 7 * component;
+        (component == 0 ? parameter_sets.modulating_params_1
+                        : parameter_sets.modulating_params_2)[i] =
+            backcalculate_modulating_params(parameters.segment(offset, 4),
+                                            start_time_, minimizer_threads);
+      });
+
+  return parameter_sets;
+}
+
+utilities::TimeHistoryBlock stochastic::DabaghiDerKiureghian::generate_range(
+    bool units, const ParameterSets& parameter_sets, std::size_t first_record,
+    std::size_t num_records) {
+  // Parameter sets are indexed with pulse-like sets first, followed by
+  // non-pulse-like sets. This index also selects the random streams.
+  auto param_set = [&](unsigned int index) -> Eigen::VectorXd {
+    return index < num_sims_pulse_
+               ? parameter_sets.pulse.row(index).transpose()
+               : parameter_sets.nopulse.row(index - num_sims_pulse_)
+                     .transpose();
+  };
+
+  // Simulate each realization as a separate task. Record lengths differ
+  // between parameter sets, so tasks are handed out dynamically to idle
+  // threads. Random streams depend only on the task indices, so results
+  // do not depend on the number of threads. Records are indexed with
+  // pulse-like records first, which matches the order of events.
+  double gfactor = 981;
+  unsigned int fit_order = 5;
+
+  // Record lengths are only known once records are truncated, so each
+  // task keeps its record until the range is packed into contiguous
+  // storage
+  std::vector<std::vector<double>> motions_comp1(num_records),
+      motions_comp2(num_records);
+  try {
+    utilities::parallel_for(
+        num_records, num_threads_, [&](unsigned int batch_index) {
+          std::size_t k = first_record + batch_index;
+          unsigned int i = k / num_realizations_, j = k % num_realizations_;
+          bool pulse_like = i < num_sims_pulse_;
+          std::vector<std::vector<double>> accel_comp_1, accel_comp_2;
+
+          // When screening, candidates for each record use every
+          // num_realizations_-th random stream, starting from the stream
+          // used without screening
+          unsigned int max_attempts =
+              acceptance_criteria_ ? acceptance_criteria_->max_attempts() : 1;
+          bool accepted = false;
+          for (unsigned int attempt = 0; attempt < max_attempts && !accepted;
+               ++attempt) {
+            SMELT_PROFILE_COUNT("candidates", 1);
+            simulate_near_fault_ground_motion(
+                pulse_like, param_set(i),
+                parameter_sets.modulating_params_1[i],
+                parameter_sets.modulating_params_2[i], accel_comp_1,
+                accel_comp_2, 1, i, j + attempt * num_realizations_);
+
+            // If requested, truncate and baseline correct time histories
+            if (truncate_) {
+              truncate_time_histories(accel_comp_1, accel_comp_2, gfactor);
+              baseline_correct_time_history(accel_comp_1[0], accel_comp_2[0],
+                                            gfactor, fit_order);
+            }
+
+            // Convert units while records are still in cache
+            convert_time_history_units(accel_comp_1[0], units);
+            convert_time_history_units(accel_comp_2[0], units);
+            accepted = !acceptance_criteria_ ||
+                       acceptance_criteria_->accept(
+                           std::vector<std::vector<double>>{accel_comp_1[0],
+                                                            accel_comp_2[0]},
+                           time_step_);
+          }
+
+          if (!accepted) {
+            throw std::runtime_error(
+                "\nERROR: in stochastic::DabaghiDerKiureghian::generate: No "
+                "candidate time history satisfied acceptance criteria "
+                "within maximum number of attempts\n");
+          }
+
+          motions_comp1[batch_index] = std::move(accel_comp_1[0]);
+          motions_comp2[batch_index] = std::move(accel_comp_2[0]);
+        });
   } catch (const std::exception& e) {
     std::cerr << e.what();
     throw;
   }
 
-  // Create JsonObject for events
-  auto events = utilities::JsonObject();
-  std::vector<utilities::JsonObject> events_array(
-      num_realizations_ * (num_sims_pulse_ + num_sims_nopulse_));
-
-  // Add pattern information for JSON
-  auto pattern_x = utilities::JsonObject();
-  auto pattern_y = utilities::JsonObject();  
-  pattern_x.add_value("type", "UniformAcceleration");
-  pattern_x.add_value("timeSeries", "accel_x");
-  pattern_x.add_value("dof", 1);
-  pattern_y.add_value("type", "UniformAcceleration");
-  pattern_y.add_value("timeSeries", "accel_y");
-  pattern_y.add_value("dof", 2);
-
-  // Create JSON for specific event
-  auto event_data = utilities::JsonObject();
-  // Loop over simulations for different parameter sets for pulse-like
-  // motions
-  for (unsigned int i = 0; i < num_sims_pulse_; ++i) {
-    // Loop over number of realizations per parameter set realization    
-    for (unsigned int j = 0; j < num_realizations_; ++j) {
-      event_data.add_value("name", event_name + "_ParameterSetPulse" + std::to_string(i) +
-                                       "_Sim" + std::to_string(j));
-      event_data.add_value("type", "Seismic");
-      event_data.add_value("dT", time_step_);
-      event_data.add_value("numSteps", pulse_motions_comp1[i][j].size());
-      event_data.add_value(
-          "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
-
-      // Rotate accelerations, if necessary      
-      std::vector<double> x_accels(pulse_motions_comp1[i][j].size());
-      std::vector<double> y_accels(pulse_motions_comp2[i][j].size());
-      convert_time_history_units(pulse_motions_comp1[i][j], units);
-      convert_time_history_units(pulse_motions_comp2[i][j], units);
-
-      // Add time histories for x and y directions to event
-      auto time_history_x = utilities::JsonObject();
-      auto time_history_y = utilities::JsonObject();
-      time_history_x.add_value("name", "accel_x");
-      time_history_x.add_value("type", "Value");
-      time_history_x.add_value("dT", time_step_);
-      time_history_x.add_value("data", pulse_motions_comp1[i][j]);
-      time_history_y.add_value("name", "accel_y");
-      time_history_y.add_value("type", "Value");
-      time_history_y.add_value("dT", time_step_);
-      time_history_y.add_value("data", pulse_motions_comp2[i][j]);
-      event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
-                                             time_history_x, time_history_y});
-      events_array[i * num_realizations_ + j] = event_data;
-      event_data.clear();
-    }
+  // Pack records, releasing each record once it has been copied
+  std::vector<std::size_t> record_lengths(num_records);
+  for (std::size_t k = 0; k < num_records; ++k) {
+    record_lengths[k] = motions_comp1[k].size();
+  }
+  utilities::TimeHistoryBlock records(record_lengths, 2, time_step_);
+  for (std::size_t k = 0; k < num_records; ++k) {
+    std::copy(motions_comp1[k].begin(), motions_comp1[k].end(),
+              records.data(k, 0));
+    std::copy(motions_comp2[k].begin(), motions_comp2[k].end(),
+              records.data(k, 1));
+    std::vector<double>().swap(motions_comp1[k]);
+    std::vector<double>().swap(motions_comp2[k]);
   }
-  
 
-  // Loop over different simulations for parameter sets non-pulse-like
-  // motions
-  for (unsigned int i = 0; i < num_sims_nopulse_; ++i) {
-    // Loop over number of realizations per parameter set realization
-    for (unsigned int j = 0; j < num_realizations_; ++j) {
-      event_data.add_value("name", event_name + "_ParameterSetNoPulse" + std::to_string(i) +
-                                       "_Sim" + std::to_string(j + num_sims_pulse_));
-      event_data.add_value("type", "Seismic");
-      event_data.add_value("dT", time_step_);
-      event_data.add_value("numSteps", nopulse_motions_comp1[i][j].size());
-      event_data.add_value(
-          "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
-
-      // Rotate accelerations, if necessary
-      std::vector<double> x_accels(nopulse_motions_comp1[i][j].size());
-      std::vector<double> y_accels(nopulse_motions_comp2[i][j].size());
-      convert_time_history_units(nopulse_motions_comp1[i][j], units);
-      convert_time_history_units(nopulse_motions_comp2[i][j], units);
-
-      // Add time histories for x and y directions to event
-      auto time_history_x = utilities::JsonObject();
-      auto time_history_y = utilities::JsonObject();
-      time_history_x.add_value("name", "accel_x");
-      time_history_x.add_value("type", "Value");
-      time_history_x.add_value("dT", time_step_);
-      time_history_x.add_value("data", nopulse_motions_comp1[i][j]);
-      time_history_y.add_value("name", "accel_y");
-      time_history_y.add_value("type", "Value");
-      time_history_y.add_value("dT", time_step_);
-      time_history_y.add_value("data", nopulse_motions_comp2[i][j]);
-      event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
-                                             time_history_x, time_history_y});
-      events_array[i * num_realizations_ + j +
-                   num_realizations_ * num_sims_pulse_] = event_data;
-      event_data.clear();
-    }
+  return records;
+}
+
+void stochastic::DabaghiDerKiureghian::generate_batches(
+    bool units, unsigned int records_per_batch,
+    const std::function<void(utilities::TimeHistoryBlock&, std::size_t)>&
+        process_batch) {
+  auto iterator = records("", units, std::max(records_per_batch, 1u));
+
+  utilities::TimeHistoryBlock batch;
+  std::size_t first_record = iterator.position();
+  while (iterator.next(batch)) {
+    process_batch(batch, first_record);
+    first_record = iterator.position();
   }
+}
+
+utilities::TimeHistoryBlock
+stochastic::DabaghiDerKiureghian::generate_records(bool units) {
+  utilities::TimeHistoryBlock records;
+  generate_batches(
+      units, (num_sims_pulse_ + num_sims_nopulse_) * num_realizations_,
+      [&records](utilities::TimeHistoryBlock& batch, std::size_t) {
+        records = std::move(batch);
+      });
+  return records;
+}
 
-  events.add_value("Events", events_array);
+std::string stochastic::DabaghiDerKiureghian::record_name(
+    const std::string& event_name, std::size_t record) const {
+  std::size_t i = record / num_realizations_, j = record % num_realizations_;
+
+  // Simulations of non-pulse-like parameter sets are numbered after the
+  // pulse-like parameter sets
+  return i < num_sims_pulse_
+             ? event_name + "_ParameterSetPulse" + std::to_string(i) +
+                   "_Sim" + std::to_string(j)
+             : event_name + "_ParameterSetNoPulse" +
+                   std::to_string(i - num_sims_pulse_) + "_Sim" +
+                   std::to_string(j + num_sims_pulse_);
+}
 
+std::vector<utilities::JsonObject>
+stochastic::DabaghiDerKiureghian::events_json(
+    const std::string& event_name, const utilities::TimeHistoryBlock& records,
+    std::size_t first_record,
+    const std::vector<std::size_t>* data_offsets) const {
+  SMELT_PROFILE_STAGE("eventsJson");
+  std::vector<utilities::JsonObject> events(records.num_records());
+  utilities::parallel_for(
+      records.num_records(), num_threads_, [&](unsigned int k) {
+        events[k] = seismic_event_json(
+            record_name(event_name, first_record + k), records, k,
+            data_offsets ? data_offsets->data() + 2 * k : nullptr);
+      });
   return events;
 }
 
+utilities::JsonObject stochastic::DabaghiDerKiureghian::generate(
+    const std::string& event_name, bool units) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+  auto records = generate_records(units);
+
+  // Create JsonObject for events
+  auto events = utilities::JsonObject();
+  events.add_value("Events", events_json(event_name, records, 0));
+
+  return events;
+}
+
+void stochastic::DabaghiDerKiureghian::records_metadata(
+    const std::string& event_name, const utilities::TimeHistoryBlock& records,
+    std::size_t first_record, std::vector<RecordMetadata>& metadata) const {
+  metadata.resize(records.num_records());
+  for (std::size_t i = 0; i < records.num_records(); ++i) {
+    metadata[i].name = record_name(event_name, first_record + i);
+    metadata[i].type = "Seismic";
+    metadata[i].time_step = records.time_step();
+    metadata[i].num_steps = records.num_steps(i);
+    metadata[i].components = {"accel_x", "accel_y"};
+  }
+}
+
+utilities::TimeHistoryBlock stochastic::DabaghiDerKiureghian::generate(
+    const std::string& event_name, std::vector<RecordMetadata>& metadata,
+    bool units) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+  auto records = generate_records(units);
+  records_metadata(event_name, records, 0, metadata);
+  return records;
+}
+
 bool stochastic::DabaghiDerKiureghian::generate(
     const std::string& event_name, const std::string& output_location,
     bool units) {
   bool status = true;
-  
-  // Generate pool of acceleration time histories
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+
+  // Write events of each batch of records as soon as they are generated so
+  // only one batch of time histories is held in memory
   try{
-    auto json_output = generate(event_name, units);
-    json_output.write_to_file(output_location);
+    if (output_format_ == OutputFormat::Spectral) {
+      // Model does not support spectral archives, so this throws
+      return spectral_archive(event_name, units)
+          .write_to_file(output_location, json_format_);
+    }
+
+    if (output_format_ == OutputFormat::Binary) {
+      // Binary header precedes all arrays, so all records are generated first
+      auto records = generate_records(units);
+      utilities::BinaryFileWriter binary_writer;
+      auto data_offsets = binary_writer.add_records(records);
+      auto events = utilities::JsonObject();
+      events.add_value("Events",
+                       events_json(event_name, records, 0, &data_offsets));
+      return binary_writer.write(output_location, events);
+    }
+
+    utilities::JsonEventWriter writer(output_location, json_format_);
+    generate_batches(
+        units, 4 * utilities::thread_count(num_threads_),
+        [&](utilities::TimeHistoryBlock& batch, std::size_t first_record) {
+          for (auto& event : events_json(event_name, batch, first_record)) {
+            writer.write_event(event);
+          }
+        });
+    status = writer.close();
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -537,6 +779,121 @@ bool stochastic::DabaghiDerKiureghian::generate(
   return status;  
 }
 
+unsigned int stochastic::DabaghiDerKiureghian::extend_campaign(
+    unsigned int num_sims) {
+  if (!campaign_.parameter_sets) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::DabaghiDerKiureghian::extend_campaign: No "
+        "records have been generated to append realizations to\n");
+  }
+  if (acceptance_criteria_) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::DabaghiDerKiureghian::extend_campaign: "
+        "Realizations can not be appended when screening with acceptance "
+        "criteria\n");
+  }
+
+  unsigned int previous_realizations = num_realizations_;
+  num_realizations_ += num_sims;
+  stream_seed_ = campaign_.stream_seed;
+  return previous_realizations;
+}
+
+stochastic::RecordIterator stochastic::DabaghiDerKiureghian::append_records(
+    const std::string& event_name, unsigned int num_sims, bool units,
+    std::size_t batch_size) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+  unsigned int previous_realizations = extend_campaign(num_sims);
+
+  // White noise of each record depends only on its parameter set and
+  // realization indices, so appended records continue the streams of the
+  // campaign
+  Campaign campaign = campaign_;
+  return appended_records(
+      num_sims_pulse_ + num_sims_nopulse_, previous_realizations, num_sims,
+      batch_size > 0 ? batch_size : utilities::thread_count(num_threads_),
+      [this, event_name, units, campaign](
+          std::size_t first_record, std::size_t num_records,
+          std::vector<RecordMetadata>* metadata) {
+        SMELT_PROFILE_ACTIVATE(profile_);
+        stream_seed_ = campaign.stream_seed;
+        auto records = generate_range(units, *campaign.parameter_sets,
+                                      first_record, num_records);
+        if (metadata) {
+          records_metadata(event_name, records, first_record, *metadata);
+        }
+        return records;
+      });
+}
+
+bool stochastic::DabaghiDerKiureghian::append(
+    const std::string& event_name, const std::string& output_location,
+    unsigned int num_sims, bool units) {
+  if (output_format_ == OutputFormat::Spectral) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::DabaghiDerKiureghian::append: Simulations "
+        "can not be appended to spectral archives\n");
+  }
+  bool status = true;
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+  unsigned int previous_realizations = extend_campaign(num_sims);
+  unsigned int num_param_sets = num_sims_pulse_ + num_sims_nopulse_;
+
+  // Appended realizations of each parameter set are contiguous among all
+  // records, so they are generated in batches within each parameter set
+  try {
+    if (output_format_ == OutputFormat::Binary) {
+      // Binary file is rewritten with the appended arrays after the
+      // existing ones, so all appended records are generated first
+      utilities::BinaryFileWriter binary_writer;
+      binary_writer.append_to(output_location);
+      std::vector<utilities::TimeHistoryBlock> parameter_sets(num_param_sets);
+      std::vector<utilities::JsonObject> events;
+      for (unsigned int i = 0; i < num_param_sets; ++i) {
+        std::size_t first_record =
+            static_cast<std::size_t>(i) * num_realizations_ +
+            previous_realizations;
+        parameter_sets[i] = generate_range(units, *campaign_.parameter_sets,
+                                           first_record, num_sims);
+        auto data_offsets = binary_writer.add_records(parameter_sets[i]);
+        auto set_events = events_json(event_name, parameter_sets[i],
+                                      first_record, &data_offsets);
+        events.insert(events.end(), set_events.begin(), set_events.end());
+      }
+      auto header = utilities::JsonObject();
+      header.add_value("Events", events);
+      return binary_writer.write(output_location, header);
+    }
+
+    utilities::JsonEventWriter writer(output_location, json_format_, true);
+    std::size_t records_per_batch = 4 * utilities::thread_count(num_threads_);
+    for (unsigned int i = 0; i < num_param_sets; ++i) {
+      std::size_t end_record = static_cast<std::size_t>(i + 1) *
+                               num_realizations_;
+      for (std::size_t first_record = end_record - num_sims;
+           first_record < end_record; first_record += records_per_batch) {
+        auto records = generate_range(
+            units, *campaign_.parameter_sets, first_record,
+            std::min(records_per_batch, end_record - first_record));
+        for (auto& event : events_json(event_name, records, first_record)) {
+          writer.write_event(event);
+        }
+      }
+    }
+    status = writer.close();
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    // Campaign keeps its size when realizations could not be appended
+    num_realizations_ = previous_realizations;
+    status = false;
+    throw;
+  }
+
+  return status;
+}
+
 unsigned int stochastic::DabaghiDerKiureghian::simulate_pulse_type(
     unsigned int num_sims) const {
   double pulse_probability = 0.0;
@@ -577,11 +934,11 @@ unsigned int stochastic::DabaghiDerKiureghian::simulate_pulse_type(
 
 Eigen::MatrixXd stochastic::DabaghiDerKiureghian::simulate_model_parameters(
     bool pulse_like, unsigned int num_sims) {
-  // Calculate covariance matrix
-  Eigen::MatrixXd error_cov =
-      pulse_like
-          ? numeric_utils::corr_to_cov(corr_matrix_pulse_, std_dev_pulse_)
-          : numeric_utils::corr_to_cov(corr_matrix_nopulse_, std_dev_nopulse_);
+  SMELT_PROFILE_STAGE("parameterSimulation");
+
+  // Covariance matrix is shared by all instances
+  const Eigen::MatrixXd& error_cov =
+      pulse_like ? cov_matrix_pulse_ : cov_matrix_nopulse_;
 
   Eigen::MatrixXd simulated_params = pulse_like
                                          ? Eigen::MatrixXd::Zero(num_sims, 19)
@@ -676,10 +1033,30 @@ Eigen::VectorXd
 
 void stochastic::DabaghiDerKiureghian::transform_parameters_from_normal_space(
     bool pulse_like, Eigen::VectorXd& parameters) {
+  // Creators are looked up once and reused for every realization
+  static const auto normal_dist =
+      Factory<stochastic::Distribution, double, double>::instance()->resolve(
+          "NormalDist");
+  static const auto uniform_dist_creator =
+      Factory<stochastic::Distribution, double, double>::instance()->resolve(
+          "UniformDist");
+
   Eigen::VectorXd transformed_params(parameters.size());
-  auto standard_normal =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.0), std::move(1.0));
+  auto standard_normal = normal_dist.create(0.0, 1.0);
+
+  // Standard normal CDF of all parameters at once
+  Eigen::VectorXd probabilities(parameters.size());
+  standard_normal->cumulative_dist_func(parameters.data(), probabilities.data(),
+                                        parameters.size());
+
+  // Transform standard normal parameter to input marginal distribution
+  auto from_std_normal =
+      [&parameters](const std::shared_ptr<stochastic::Distribution>& dist,
+                    unsigned int index) -> double {
+    double value;
+    dist->transform_from_std_normal(&parameters(index), &value, 1);
+    return value;
+  };
 
   if (pulse_like) {
     std::vector<unsigned int> indices = {0, 1, 4, 5, 6, 7, 8, 9, 12, 13, 14, 15, 16};
@@ -688,69 +1065,45 @@ void stochastic::DabaghiDerKiureghian::transform_parameters_from_normal_space(
     }
 
     // Calculate gamma
-    auto beta_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "BetaDist", std::move(params_fitted1_(2)),
-            std::move(params_fitted2_(2)));
+    auto beta_dist = beta_marginals_[2];
 
     transformed_params(2) =
-        ((beta_dist->inv_cumulative_dist_func(
-              standard_normal->cumulative_dist_func(
-                  std::vector<double>{parameters(2)})))
-             .at(0)) *
+        from_std_normal(beta_dist, 2) *
             (params_upper_bound_(2) - params_lower_bound_(2)) +
         params_lower_bound_(2);
 
     // Calculate nu
-    auto uniform_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "UniformDist", std::move(params_lower_bound_(3)),
-            std::move(params_upper_bound_(3)));
+    auto uniform_dist = uniform_dist_creator.create(
+        static_cast<double>(params_lower_bound_(3)),
+        static_cast<double>(params_upper_bound_(3)));
 
-    transformed_params(3) = (uniform_dist->inv_cumulative_dist_func(
-                                 standard_normal->cumulative_dist_func(
-                                     std::vector<double>{parameters(3)})))
-                                .at(0);
+    transformed_params(3) = from_std_normal(uniform_dist, 3);
 
     // Calculate f' residual
     transformed_params(10) =
-        inv_double_exp(standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(10)})[0],
-                       params_fitted1_(10), params_fitted2_(10),
-                       params_fitted3_(10), params_lower_bound_(10));
+        inv_double_exp(probabilities(10), params_fitted1_(10),
+                       params_fitted2_(10), params_fitted3_(10),
+                       params_lower_bound_(10));
 
     // Calculate depth_to_rupt residual
-    beta_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "BetaDist", std::move(params_fitted1_(11)),
-            std::move(params_fitted2_(11)));
+    beta_dist = beta_marginals_[11];
 
     transformed_params(11) =
-        std::exp(((beta_dist->inv_cumulative_dist_func(
-                       standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(11)})))
-                      .at(0)) *
+        std::exp(from_std_normal(beta_dist, 11) *
                      (params_upper_bound_(11) - params_lower_bound_(11)) +
                  params_lower_bound_(11));
 
     // Calculate f' pulse-only
     transformed_params(17) =
-        inv_double_exp(standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(17)})[0],
-                       params_fitted1_(17), params_fitted2_(17),
-                       params_fitted3_(17), params_lower_bound_(17));
+        inv_double_exp(probabilities(17), params_fitted1_(17),
+                       params_fitted2_(17), params_fitted3_(17),
+                       params_lower_bound_(17));
 
     // Calculate depth_to_rupt pulse-only
-    beta_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "BetaDist", std::move(params_fitted1_(18)),
-            std::move(params_fitted2_(18)));
+    beta_dist = beta_marginals_[18];
 
     transformed_params(18) =
-        std::exp(((beta_dist->inv_cumulative_dist_func(
-                       standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(18)})))
-                      .at(0)) *
+        std::exp(from_std_normal(beta_dist, 18) *
                      (params_upper_bound_(18) - params_lower_bound_(18)) +
                  params_lower_bound_(18));
   } else {
@@ -761,43 +1114,29 @@ void stochastic::DabaghiDerKiureghian::transform_parameters_from_normal_space(
 
     // Calculate f' component 1
     transformed_params(5) =
-        inv_double_exp(standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(5)})[0],
-                       params_fitted1_(10), params_fitted2_(10),
-                       params_fitted3_(10), params_lower_bound_(10));
+        inv_double_exp(probabilities(5), params_fitted1_(10),
+                       params_fitted2_(10), params_fitted3_(10),
+                       params_lower_bound_(10));
 
     // Calculate depth_to_rupture component 1
-    auto beta_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "BetaDist", std::move(params_fitted1_(11)),
-            std::move(params_fitted2_(11)));
+    auto beta_dist = beta_marginals_[11];
 
     transformed_params(6) =
-        std::exp(((beta_dist->inv_cumulative_dist_func(
-                       standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(6)})))
-                      .at(0)) *
+        std::exp(from_std_normal(beta_dist, 6) *
                      (params_upper_bound_(11) - params_lower_bound_(11)) +
                  params_lower_bound_(11));
 
     // Calculate f' component 2
     transformed_params(12) =
-        inv_double_exp(standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(12)})[0],
-                       params_fitted1_(17), params_fitted2_(17),
-                       params_fitted3_(17), params_lower_bound_(17));
+        inv_double_exp(probabilities(12), params_fitted1_(17),
+                       params_fitted2_(17), params_fitted3_(17),
+                       params_lower_bound_(17));
 
     // Calculate depth_to_rupture compenent 2
-    beta_dist =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "BetaDist", std::move(params_fitted1_(18)),
-            std::move(params_fitted2_(18)));
+    beta_dist = beta_marginals_[18];
 
     transformed_params(13) =
-        std::exp(((beta_dist->inv_cumulative_dist_func(
-                       standard_normal->cumulative_dist_func(
-                           std::vector<double>{parameters(13)})))
-                      .at(0)) *
+        std::exp(from_std_normal(beta_dist, 13) *
                      (params_upper_bound_(18) - params_lower_bound_(18)) +
                  params_lower_bound_(18));
   }
@@ -833,7 +1172,26 @@ void stochastic::DabaghiDerKiureghian::simulate_near_fault_ground_motion(
     bool pulse_like, const Eigen::VectorXd& parameters,
     std::vector<std::vector<double>>& accel_comp_1,
     std::vector<std::vector<double>>& accel_comp_2,
-    unsigned int num_gms) const {
+    unsigned int num_gms, unsigned int spectrum_index) const {
+  // Back-calculate modulating parameters for two components of ground motion
+  unsigned int offset = pulse_like ? 5 : 0;
+  Eigen::VectorXd modulating_params_1 = backcalculate_modulating_params(
+      parameters.segment(offset, 4), start_time_);
+  Eigen::VectorXd modulating_params_2 = backcalculate_modulating_params(
+      parameters.segment(offset + 7, 4), start_time_);
+
+  simulate_near_fault_ground_motion(pulse_like, parameters, modulating_params_1,
+                                    modulating_params_2, accel_comp_1,
+                                    accel_comp_2, num_gms, spectrum_index);
+}
+
+void stochastic::DabaghiDerKiureghian::simulate_near_fault_ground_motion(
+    bool pulse_like, const Eigen::VectorXd& parameters,
+    const Eigen::VectorXd& modulating_params_1,
+    const Eigen::VectorXd& modulating_params_2,
+    std::vector<std::vector<double>>& accel_comp_1,
+    std::vector<std::vector<double>>& accel_comp_2, unsigned int num_gms,
+    unsigned int spectrum_index, unsigned int first_gm) const {
 
   // Extract parameters for two components of ground motion
   Eigen::VectorXd alpha_1(7);
@@ -846,12 +1204,7 @@ void stochastic::DabaghiDerKiureghian::simulate_near_fault_ground_motion(
     alpha_2 = parameters.segment(7, 7);
   }
 
-  // Set modulating and filter parameters
-  Eigen::VectorXd modulating_params_1 =
-      backcalculate_modulating_params(alpha_1.segment(0, 4), start_time_);
-  Eigen::VectorXd modulating_params_2 =
-      backcalculate_modulating_params(alpha_2.segment(0, 4), start_time_);
-
+  // Set filter parameters
   Eigen::VectorXd filter_params_1 = alpha_1.segment(4, 3);
   Eigen::VectorXd filter_params_2 = alpha_2.segment(4, 3);
 
@@ -867,10 +1220,12 @@ void stochastic::DabaghiDerKiureghian::simulate_near_fault_ground_motion(
   num_steps = num_steps % 2 == 1 ? num_steps + 1 : num_steps;
 
   // Generated modulated filtered white noise
-  auto white_noise_1 = simulate_white_noise(
-      modulating_params_1, filter_params_1, num_steps, num_gms);
-  auto white_noise_2 = simulate_white_noise(
-      modulating_params_2, filter_params_2, num_steps, num_gms);
+  auto white_noise_1 =
+      simulate_white_noise(modulating_params_1, filter_params_1, num_steps,
+                           num_gms, spectrum_index, 0, first_gm);
+  auto white_noise_2 =
+      simulate_white_noise(modulating_params_2, filter_params_2, num_steps,
+                           num_gms, spectrum_index, 1, first_gm);
 
   // Calculate high-pass filter and padding
   double freq_corner = std::pow(10.0, 1.4071 - 0.3452 * moment_magnitude_);
@@ -879,134 +1234,94 @@ void stochastic::DabaghiDerKiureghian::simulate_near_fault_ground_motion(
   unsigned int num_pads =
       static_cast<unsigned int>(std::ceil(padding_duration / time_step_));
 
-  // Add zero-padding
-  Eigen::MatrixXd accel_padded_1 =
-      Eigen::MatrixXd::Zero(num_gms, num_pads + num_steps + num_pads);
-  Eigen::MatrixXd accel_padded_2 =
-      Eigen::MatrixXd::Zero(num_gms, num_pads + num_steps + num_pads);
-
-  for (unsigned int i = 0; i < num_gms; ++i) {
-    // Pad component 1
-    accel_padded_1.block(i, 0, 1, num_pads) =
-        Eigen::RowVectorXd::Zero(num_pads);
-    accel_padded_1.block(i, num_pads - 1, 1, num_steps) = white_noise_1.row(i);
-    accel_padded_1.block(i, num_pads + num_steps - 1, 1, num_pads) =
-        Eigen::RowVectorXd::Zero(num_pads);
-
-    // Pad component 2
-    accel_padded_2.block(i, 0, 1, num_pads) =
-        Eigen::RowVectorXd::Zero(num_pads);
-    accel_padded_2.block(i, num_pads - 1, 1, num_steps) = white_noise_2.row(i);
-    accel_padded_2.block(i, num_pads + num_steps - 1, 1, num_pads) =
-        Eigen::RowVectorXd::Zero(num_pads);
-  }
-
-  // Apply filter to padded acceleration time histories
-  accel_comp_1.resize(num_gms);
-  accel_comp_2.resize(num_gms);
-  for (unsigned int i = 0; i < num_gms; ++i) {
-    accel_comp_1[i] = filter_acceleration(accel_padded_1.row(i), freq_corner, filter_order);
-    accel_comp_2[i] = filter_acceleration(accel_padded_2.row(i), freq_corner, filter_order);    
-  }
-
-  // Rescale time histories for energy consistency:
+  // Stack zero-padded components as columns, with all component 1 motions
+  // followed by all component 2 motions, so that both components are
+  // processed together and each record is contiguous. Components are
+  // padded further to a fast FFT length if selected.
+  unsigned int num_samples = num_pads + num_steps + num_pads;
+  unsigned int fft_length =
+      fft_padding_ ? numeric_utils::smooth_fft_length(num_samples)
+                   : num_samples;
+  Eigen::MatrixXd accels = Eigen::MatrixXd::Zero(fft_length, 2 * num_gms);
+  accels.block(num_pads - 1, 0, num_steps, num_gms) = white_noise_1.transpose();
+  accels.block(num_pads - 1, num_gms, num_steps, num_gms) =
+      white_noise_2.transpose();
+
+  // Apply filter to padded acceleration time histories, trimming any padding
+  // added for the FFT length
+  filter_acceleration(accels, freq_corner, filter_order);
+  accels.conservativeResize(num_samples, Eigen::NoChange);
+
+  // Rescale time histories for energy consistency using total Arias
+  // intensity of each record:
   // Target Arias intensity for rescaling after high-pass filter in g-sec
   double target_ai_1 = alpha_1(0) / 981;
   double target_ai_2 = alpha_2(0) / 981;
+  Eigen::VectorXd arias_intensity =
+      numeric_utils::arias_intensity(accels, time_step_);
 
-  std::vector<std::vector<double>> arias_intensity_1(
-      num_gms, std::vector<double>(accel_comp_1[0].size()));
-  std::vector<std::vector<double>> arias_intensity_2(
-      num_gms, std::vector<double>(accel_comp_2[0].size()));
-
-  // Calculate Arias intensity
-  for (unsigned int i = 0; i < num_gms; ++i) {
-    std::transform(accel_comp_1[i].begin(), accel_comp_1[i].end(),
-                   arias_intensity_1[i].begin(),
-                   [this](double value) -> double {
-                     return value * value * time_step_ * M_PI / 2.0;
-                   });
-
-    std::partial_sum(arias_intensity_1[i].begin(), arias_intensity_1[i].end(),
-                     arias_intensity_1[i].begin());
-
-    std::transform(accel_comp_2[i].begin(), accel_comp_2[i].end(),
-                   arias_intensity_2[i].begin(),
-                   [this](double value) -> double {
-                     return value * value * time_step_ * M_PI / 2.0;
-                   });
-
-    std::partial_sum(arias_intensity_2[i].begin(), arias_intensity_2[i].end(),
-                     arias_intensity_2[i].begin());
-  }
-
-  // Calculate scaling factors and scale accelerations to match Arias intensity
-  for (unsigned int i = 0; i < num_gms; ++i) {
-    double scale_factor_1 = std::sqrt(
-        target_ai_1 / arias_intensity_1[i][arias_intensity_1[i].size() - 1]);
-    double scale_factor_2 = std::sqrt(
-        target_ai_2 / arias_intensity_2[i][arias_intensity_2[i].size() - 1]);
-
-    std::transform(accel_comp_1[i].begin(), accel_comp_1[i].end(),
-                   accel_comp_1[i].begin(),
-                   [&scale_factor_1](double value) -> double {
-                     return value * scale_factor_1;
-                   });
-
-    std::transform(accel_comp_2[i].begin(), accel_comp_2[i].end(),
-                   accel_comp_2[i].begin(),
-                   [&scale_factor_2](double value) -> double {
-                     return value * scale_factor_2;
-                   });
+  for (unsigned int i = 0; i < 2 * num_gms; ++i) {
+    double target_ai = i < num_gms ? target_ai_1 : target_ai_2;
+    accels.col(i) *= std::sqrt(target_ai / arias_intensity(i));
   }
 
   // If pulse-like, add pulse acceleration to component 1 direction
   if (pulse_like) {
     // Calculate pulse acceleration
     auto pulse_accel = calc_pulse_acceleration(num_steps, parameters);
+    Eigen::Map<const Eigen::VectorXd> pulse_vector(pulse_accel.data(),
+                                                   pulse_accel.size());
 
     // Add pulse motion to component 1
-    for (unsigned int i = 0; i < num_gms; ++i) {
-      for (unsigned int j = 0; j < pulse_accel.size(); ++j) {
-        accel_comp_1[i][j + num_pads - 1] =
-            accel_comp_1[i][j + num_pads - 1] + pulse_accel[j];
-      }
-    }
+    accels.block(num_pads - 1, 0, pulse_accel.size(), num_gms).colwise() +=
+        pulse_vector;
+  }
+
+  accel_comp_1.resize(num_gms);
+  accel_comp_2.resize(num_gms);
+  for (unsigned int i = 0; i < num_gms; ++i) {
+    accel_comp_1[i].assign(accels.col(i).data(),
+                           accels.col(i).data() + num_samples);
+    accel_comp_2[i].assign(accels.col(num_gms + i).data(),
+                           accels.col(num_gms + i).data() + num_samples);
   }
 }
 
 Eigen::VectorXd
     stochastic::DabaghiDerKiureghian::backcalculate_modulating_params(
-        const Eigen::VectorXd& q_params, double t0) const {
+        const Eigen::VectorXd& q_params, double t0,
+        unsigned int num_threads) const {
+  SMELT_PROFILE_STAGE("modulatingParameters");
   double arias_intensity = q_params(0) / 981,  // Convert from cm/s to g-s
     d595 = q_params(1), d05 = q_params(2),
     d030 = q_params(3), d095 = d05 + d595,
     t30 = t0 + d030;
 
   // Search for local minimum by trying several starting points
-  optimization::NelderMead minimizer(1e-10);
-  std::vector<double> diffs(6);
+  optimization::MultiStartNelderMead minimizer(1e-10, num_threads);
   std::function<double(const std::vector<double>&)> error_function =
       std::bind(&stochastic::DabaghiDerKiureghian::calc_parameter_error, this,
                 std::placeholders::_1, d05, d030, d095, t0);
 
-  // Iterate over starting points
+  // Minimize from each starting point
   std::vector<std::vector<double>> starting_points = {
       {1.0, 0.2, t30}, {2.0, 0.2, t30}, {5.0, 0.2, t30},
       {1.0, 1.0, t30}, {2.0, 1.0, t30}, {5.0, 1.0, t30}};
-  std::vector<double> deltas(starting_points[0].size());
+  std::vector<std::vector<double>> deltas(
+      starting_points.size(), std::vector<double>(starting_points[0].size()));
 
-  unsigned int point_counter = 0;
-  for (auto& point : starting_points) {
-    for (unsigned int i = 0; i < deltas.size(); ++i) {
-      deltas[i] = std::abs(point[i]) < 1.0e-6 ? 0.00025 : 0.05 * std::abs(point[i]);
+  for (unsigned int i = 0; i < starting_points.size(); ++i) {
+    for (unsigned int j = 0; j < deltas[i].size(); ++j) {
+      deltas[i][j] = std::abs(starting_points[i][j]) < 1.0e-6
+                         ? 0.00025
+                         : 0.05 * std::abs(starting_points[i][j]);
     }
-
-    point = minimizer.minimize(point, deltas, error_function);
-    diffs[point_counter] = error_function(point);
-    ++point_counter;
   }
 
+  starting_points =
+      minimizer.minimize(starting_points, deltas, error_function);
+  std::vector<double> diffs = minimizer.get_minima();
+
   // To avoid negative values of alpha, multiply cost value by 10000 if so
   for (unsigned int i = 0; i < starting_points.size(); ++i) {
     if (starting_points[i][0] < 0.0) {
@@ -1037,47 +1352,30 @@ double stochastic::DabaghiDerKiureghian::calc_parameter_error(
   double alpha = parameters[0], beta = parameters[1], t_max_q = parameters[2];
 
   // Arias intensity times corresponding to the selected modulating function
-  // and parameters
-  double t5_fit =
-      t0 + std::pow((5.0 / 100.0) * std::pow(t_max_q - t0, 2.0 * alpha) *
-                        ((t_max_q - t0) + (2.0 * alpha + 1.0) / (2.0 * beta)),
-                    1.0 / (2.0 * alpha + 1.0));
-
-  double t30_fit =
-      t0 + std::pow((30.0 / 100.0) * std::pow(t_max_q - t0, 2.0 * alpha) *
-                        ((t_max_q - t0) + (2.0 * alpha + 1.0) / (2.0 * beta)),
-                    1.0 / (2.0 * alpha + 1.0));
-
-  double t95_fit =
-      t0 + std::pow((95.0 / 100.0) * std::pow(t_max_q - t0, 2.0 * alpha) *
-                        ((t_max_q - t0) + (2.0 * alpha + 1.0) / (2.0 * beta)),
-                    1.0 / (2.0 * alpha + 1.0));
-
-  if (t5_fit > t_max_q) {
-    t5_fit = t_max_q -
-             (1.0 / (2.0 * beta)) *
-                 std::log(((100.0 - 5.0) / 100.0) *
-                          ((t_max_q - t0) * (2.0 * beta) / (2.0 * alpha + 1.0) +
-                           1.0));
-  }
+  // and parameters, which have closed form. Terms that do not depend on the
+  // percentage are evaluated once.
+  double rise_factor = std::pow(t_max_q - t0, 2.0 * alpha);
+  double rise_energy = (t_max_q - t0) + (2.0 * alpha + 1.0) / (2.0 * beta);
+  double rise_exponent = 1.0 / (2.0 * alpha + 1.0);
+  double decay_energy =
+      (t_max_q - t0) * (2.0 * beta) / (2.0 * alpha + 1.0) + 1.0;
+
+  auto time_to_intensity = [&](double percentage) -> double {
+    double time =
+        t0 + std::pow((percentage / 100.0) * rise_factor * rise_energy,
+                      rise_exponent);
+    // Percentage is reached after peak of modulating function
+    if (time > t_max_q) {
+      time = t_max_q - (1.0 / (2.0 * beta)) *
+                           std::log(((100.0 - percentage) / 100.0) *
+                                    decay_energy);
+    }
+    return time;
+  };
 
-  if (t30_fit > t_max_q) {
-    t30_fit =
-        t_max_q -
-        (1.0 / (2.0 * beta)) *
-            std::log(
-                ((100.0 - 30.0) / 100.0) *
-                ((t_max_q - t0) * (2.0 * beta) / (2.0 * alpha + 1.0) + 1.0));
-  }
-
-  if (t95_fit > t_max_q) {
-    t95_fit =
-        t_max_q -
-        (1.0 / (2.0 * beta)) *
-            std::log(
-                ((100.0 - 95.0) / 100.0) *
-                ((t_max_q - t0) * (2.0 * beta) / (2.0 * alpha + 1.0) + 1.0));
-  }
+  double t5_fit = time_to_intensity(5.0);
+  double t30_fit = time_to_intensity(30.0);
+  double t95_fit = time_to_intensity(95.0);
 
   // Duration parameters of corresponding modulating function
   double d05_fit = t5_fit - t0;
@@ -1094,49 +1392,45 @@ double stochastic::DabaghiDerKiureghian::calc_parameter_error(
 Eigen::MatrixXd stochastic::DabaghiDerKiureghian::simulate_white_noise(
     const Eigen::VectorXd& modulating_params,
     const Eigen::VectorXd& filter_params, unsigned int num_steps,
-    unsigned int num_gms) const {
+    unsigned int num_gms, unsigned int spectrum_index, unsigned int component,
+    unsigned int first_gm) const {
+  SMELT_PROFILE_STAGE("whiteNoise");
+
   // CALCULATE MODULATING FUNCTION:
   auto modulating_func =
       calc_modulating_func(num_steps, start_time_, modulating_params);
 
   // CALCULATE FREQUENCY FUNCTION:
   // For any general modulating function, get the discretized times of interest
-  // Lower bound before t01
-  double t01 = calc_time_to_intensity(modulating_func, 1.0);
-  // Middle set to t30
-  double tmid = calc_time_to_intensity(modulating_func, 30.0);
-  // Upper bound after t99
-  double t99 = calc_time_to_intensity(modulating_func, 99.0);
+  // Lower bound before t01, middle set to t30 and upper bound after t99
+  double intensity_times[3];
+  const double percentages[3] = {1.0, 30.0, 99.0};
+  calc_times_to_intensity(modulating_func, percentages, intensity_times, 3);
+  double t01 = intensity_times[0], tmid = intensity_times[1],
+         t99 = intensity_times[2];
 
   // Define the filter frequency and bandwidth
   auto frequency_filter =
       calc_linear_filter(num_steps, filter_params, t01, tmid, t99);
 
-  // Generate white noise
-  auto generator =
-      seed_value_ != std::numeric_limits<int>::infinity()
-          ? boost::random::mt19937(static_cast<unsigned int>(seed_value_))
-          : boost::random::mt19937(
-                static_cast<unsigned int>(std::time(nullptr)));
-  
-  boost::random::normal_distribution<> distribution(0.0, 1.0);
-  boost::random::variate_generator<boost::random::mt19937&,
-                                   boost::random::normal_distribution<>>
-      noise_gen(generator, distribution);
-
-  Eigen::MatrixXd white_noise(num_gms, num_steps);
-  for (unsigned int i = 0; i < num_gms; ++i) {
-    for (unsigned int j = 0; j < num_steps; ++j) {
-      white_noise(i, j) = noise_gen();
-    }
+  // Generate white noise with separate random stream for each ground motion
+  // and filter it with truncated impulse responses, in single precision if
+  // selected
+  Eigen::MatrixXd freq_func;
+  if (precision_ == Precision::Single) {
+    freq_func = filter_white_noise(
+                    normal_white_noise<float>(stream_seed_, spectrum_index,
+                                              component, first_gm, num_gms,
+                                              num_steps),
+                    frequency_filter, filter_params(2))
+                    .cast<double>();
+  } else {
+    freq_func = filter_white_noise(
+        normal_white_noise<double>(stream_seed_, spectrum_index, component,
+                                   first_gm, num_gms, num_steps),
+        frequency_filter, filter_params(2));
   }
 
-  // Calculate impulse response
-  Eigen::MatrixXd impulse_response = calc_impulse_response_filter(
-      num_steps, frequency_filter, filter_params(2));
-
-  auto freq_func = white_noise * impulse_response;
-
   Eigen::MatrixXd filtered_white_noise(num_gms, num_steps);
   // Convert modulating function to Eigen::VectorXd
   Eigen::VectorXd mod_func_vec = Eigen::Map<Eigen::VectorXd>(
@@ -1175,29 +1469,28 @@ std::vector<double> stochastic::DabaghiDerKiureghian::calc_modulating_func(
 
 double stochastic::DabaghiDerKiureghian::calc_time_to_intensity(
     const std::vector<double>& acceleration, double percentage) const {
-  // Calculate cumulative energy in acceleration time series, which is
-  // proportional to Arias intensity
-  std::vector<double> t01_sum(acceleration.size());
-
-  std::transform(acceleration.begin(), acceleration.end(), t01_sum.begin(),
-                [](double value) -> double { return value * value; });
-
-  std::partial_sum(t01_sum.begin(), t01_sum.end(), t01_sum.begin());
-
-  // Calculate normalized cumulative Arias intensity in percent
-  std::transform(t01_sum.begin(), t01_sum.end(), t01_sum.begin(),
-                 [&t01_sum](double value) -> double {
-                   return value / t01_sum[t01_sum.size() - 1] * 100.0;
-                 });
-
-  return time_step_ *
-         static_cast<double>(
-             std::distance(t01_sum.begin(),
-                           std::find_if(t01_sum.begin(), t01_sum.end(),
-                                        [percentage](double value) {
-                                          return value >= percentage;
-                                        })) +
-             1);
+  double time;
+  calc_times_to_intensity(acceleration, &percentage, &time, 1);
+  return time;
+}
+
+void stochastic::DabaghiDerKiureghian::calc_times_to_intensity(
+    const std::vector<double>& acceleration, const double* percentages,
+    double* times, unsigned int num_percentages) const {
+  // Find time step indices in chunks so no storage needs to be allocated
+  const unsigned int chunk_size = 8;
+  std::size_t indices[chunk_size];
+
+  for (unsigned int start = 0; start < num_percentages; start += chunk_size) {
+    unsigned int num_chunk = std::min(chunk_size, num_percentages - start);
+    numeric_utils::intensity_indices(acceleration.data(), acceleration.size(),
+                                     percentages + start, indices, num_chunk);
+
+    // Times are at the end of the time step at which percentage is reached
+    for (unsigned int i = 0; i < num_chunk; ++i) {
+      times[start + i] = time_step_ * static_cast<double>(indices[i] + 1);
+    }
+  }
 }
 
 std::vector<double> stochastic::DabaghiDerKiureghian::calc_linear_filter(
@@ -1240,13 +1533,17 @@ Eigen::MatrixXd stochastic::DabaghiDerKiureghian::calc_impulse_response_filter(
   Eigen::MatrixXd impulse_response =
       Eigen::MatrixXd::Zero(num_steps, num_steps);
 
+  // Times for each row are a leading segment of the times for the first row
+  auto& arena = utilities::ScratchArena::local();
+  utilities::ScratchArena::Scope scope(arena);
+  auto all_times = arena.vector(num_steps);
+  for (unsigned int j = 0; j < num_steps; ++j) {
+    all_times(j) = static_cast<double>(j) * time_step_;
+  }
+
   for (unsigned int i = 0; i < num_steps; ++i) {
     double omega = input_filter[i];
-    Eigen::VectorXd times(num_steps - i);
-    
-    for (unsigned int j = 0; j < times.size(); ++j) {
-      times(j) = static_cast<double>(j) * time_step_;
-    }
+    auto times = all_times.head(num_steps - i);
 
     impulse_response.block(i, i, 1, times.size()) =
         ((omega / std::sqrt(1.0 - zeta * zeta)) *
@@ -1270,34 +1567,69 @@ Eigen::MatrixXd stochastic::DabaghiDerKiureghian::calc_impulse_response_filter(
   return impulse_response;
 }
 
+Eigen::MatrixXd stochastic::DabaghiDerKiureghian::filter_white_noise(
+    const Eigen::MatrixXd& white_noise, const std::vector<double>& input_filter,
+    double zeta, double tolerance) const {
+  SMELT_PROFILE_STAGE("noiseFiltering");
+  return truncated_impulse_filter(white_noise, input_filter, zeta, tolerance,
+                                  time_step_);
+}
+
+Eigen::MatrixXf stochastic::DabaghiDerKiureghian::filter_white_noise(
+    const Eigen::MatrixXf& white_noise, const std::vector<double>& input_filter,
+    double zeta, double tolerance) const {
+  SMELT_PROFILE_STAGE("noiseFiltering");
+  return truncated_impulse_filter(white_noise, input_filter, zeta, tolerance,
+                                  time_step_);
+}
+
 std::vector<double> stochastic::DabaghiDerKiureghian::filter_acceleration(
     const Eigen::VectorXd& accel_history, double freq_corner,
     unsigned int filter_order) const {
 
-  // Calculate normalized cutoff frequency
-  std::vector<std::complex<double>> accel_fft(accel_history.size());
-
-  // Compute FFT of acceleration history
-  numeric_utils::fft(accel_history, accel_fft);
+  // Compute non-redundant half of FFT of acceleration history
+  std::size_t num_steps = accel_history.size();
+  std::vector<std::complex<double>> accel_fft(num_steps / 2 + 1);
+  numeric_utils::real_fft(accel_history.data(), num_steps, accel_fft.data());
 
   // Get filter coefficients
-  auto filter = Dispatcher<std::vector<double>, double, double, unsigned int,
-                           unsigned int>::instance()
-                    ->dispatch("AcausalHighpassButterworth", freq_corner,
-                               time_step_, filter_order, accel_fft.size());
+  auto filter = signal_processing::FilterBank::acausal_highpass(
+      freq_corner, time_step_, filter_order, num_steps);
 
   // Filter acceleration in frequency domain
   for (unsigned int i = 0; i < accel_fft.size(); ++i) {
-    accel_fft[i] = accel_fft[i] * filter[i];
+    accel_fft[i] = accel_fft[i] * (*filter)[i];
   }
 
   // Compute inverse FFT of filtered transformed acceleration
-  std::vector<double> filtered_acc(accel_fft.size());
-  numeric_utils::inverse_fft(accel_fft, filtered_acc);
+  std::vector<double> filtered_acc(num_steps);
+  numeric_utils::inverse_real_fft(accel_fft.data(), num_steps,
+                                  filtered_acc.data());
 
   return filtered_acc;
 }
 
+void stochastic::DabaghiDerKiureghian::filter_acceleration(
+    Eigen::MatrixXd& accel_histories, double freq_corner,
+    unsigned int filter_order) const {
+  SMELT_PROFILE_STAGE("highpassFiltering");
+
+  // Get filter coefficients once for all records
+  auto filter = signal_processing::FilterBank::acausal_highpass(
+      freq_corner, time_step_, filter_order, accel_histories.rows());
+  // Only non-redundant half of conjugate-even transforms is filtered
+  unsigned int num_freqs = accel_histories.rows() / 2 + 1;
+  Eigen::Map<const Eigen::VectorXd> filter_vector(filter->data(), num_freqs);
+
+  // Transform all records in one batch, filter in frequency domain and
+  // write filtered records back in place
+  Eigen::MatrixXcd accel_fft;
+  numeric_utils::real_fft(accel_histories, accel_fft);
+  accel_fft.array().colwise() *= filter_vector.array();
+  numeric_utils::inverse_real_fft(accel_fft, accel_histories.rows(),
+                                  accel_histories);
+}
+
 std::vector<double> stochastic::DabaghiDerKiureghian::calc_pulse_acceleration(
     unsigned int num_steps, const Eigen::VectorXd& parameters) const {
   double pulse_velocity = parameters(0);  
@@ -1341,6 +1673,7 @@ void stochastic::DabaghiDerKiureghian::truncate_time_histories(
     std::vector<std::vector<double>>& accel_comp_1,
     std::vector<std::vector<double>>& accel_comp_2, double gfactor,
     double amplitude_lim, double pgd_lim) const {
+  SMELT_PROFILE_STAGE("truncation");
 
   // Iterate over time histories
   for (unsigned int i = 0; i < accel_comp_1.size(); ++i) {
@@ -1455,49 +1788,34 @@ void stochastic::DabaghiDerKiureghian::truncate_time_histories(
 }
 
 void stochastic::DabaghiDerKiureghian::baseline_correct_time_history(
-    std::vector<double>& time_history, double gfactor,
-    unsigned int order) const {
-
-  // Calculate velocity and displacment time histories
-  std::vector<double> vel_series(time_history.size());
-  std::vector<double> disp_series(time_history.size());
-
-  std::transform(time_history.begin(), time_history.end(), vel_series.begin(),
-                 [&gfactor, this](double value) -> double {
-                   return value * gfactor * time_step_;
-                 });
-
-  std::partial_sum(vel_series.begin(), vel_series.end(), vel_series.begin());
-
-  std::transform(vel_series.begin(), vel_series.end(), disp_series.begin(),
-                 [this](double value) -> double { return value * time_step_; });
-
-  std::partial_sum(disp_series.begin(), disp_series.end(), disp_series.begin());
-
-  Eigen::VectorXd times(time_history.size());
-
-  for (unsigned int i = 0; i < times.size(); ++i) {
-    times(i) = i * time_step_;
-  }
-
-  // Convert input time history from std vector to Eigen vector
-  Eigen::VectorXd disp_vector =
-      Eigen::Map<Eigen::VectorXd>(disp_series.data(), disp_series.size());
-
-  // Fit zero-intercept polynomial to displacement time history
-  auto displacement_poly =
-    numeric_utils::polyfit_intercept(times, disp_vector, 0.0, 5);
-  auto velocity_poly = numeric_utils::polynomial_derivative(displacement_poly);
-  auto accel_poly = numeric_utils::polynomial_derivative(velocity_poly);
-
-  // Calculate acceleration correction based on polynomial
-  auto accel_correction =
-      numeric_utils::evaluate_polynomial(accel_poly, times) / gfactor;
-
-  // Correct time series based on acceleration correction
-  for (unsigned int i = 0; i < accel_correction.size(); ++i) {
-    time_history[i] = time_history[i] - accel_correction(i);
+    std::vector<double>& time_history_1, std::vector<double>& time_history_2,
+    double gfactor, unsigned int order) const {
+  SMELT_PROFILE_STAGE("baselineCorrection");
+
+  // Truncated record lengths rarely repeat between records, so the shared
+  // cache seldom hits across records. Both components have the same length
+  // after truncation, however, so they are corrected together with a single
+  // projection in one matrix-matrix product.
+  if (time_history_1.size() != time_history_2.size()) {
+    throw std::runtime_error(
+        "\nERROR: in "
+        "stochastic::DabaghiDerKiureghian::baseline_correct_time_history: "
+        "Components must have the same number of time steps\n");
   }
+  const auto num_steps = time_history_1.size();
+  Eigen::MatrixXd components(num_steps, 2);
+  components.col(0) =
+      Eigen::Map<const Eigen::VectorXd>(time_history_1.data(), num_steps);
+  components.col(1) =
+      Eigen::Map<const Eigen::VectorXd>(time_history_2.data(), num_steps);
+
+  numeric_utils::BaselineCorrection::cached(num_steps, time_step_, order)
+      ->correct(components, gfactor);
+
+  Eigen::Map<Eigen::VectorXd>(time_history_1.data(), num_steps) =
+      components.col(0);
+  Eigen::Map<Eigen::VectorXd>(time_history_2.data(), num_steps) =
+      components.col(1);
 }
 
 void stochastic::DabaghiDerKiureghian::convert_time_history_units(
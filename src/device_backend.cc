@@ -0,0 +1,459 @@
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#ifdef SMELT_ENABLE_CUDA
+#include <mutex>
+#include <vector>
+#include <cublas_v2.h>
+#include <cuda_runtime.h>
+#include <cufft.h>
+#include <cusolverDn.h>
+#endif
+#include "device_backend.h"
+
+namespace {
+std::atomic<bool> device_enabled(false); /**< Selection of GPU kernels */
+
+#ifdef SMELT_ENABLE_CUDA
+/**
+ * Throw exception if a CUDA runtime call failed
+ * @param[in] status Status returned by call
+ * @param[in] function Name of calling function
+ */
+void check_status(cudaError_t status, const std::string& function) {
+  if (status != cudaSuccess) {
+    throw std::runtime_error("\nERROR: in numeric_utils::device::" + function +
+                             ": " + cudaGetErrorString(status) + "\n");
+  }
+}
+
+/**
+ * Throw exception if a cuFFT call failed
+ * @param[in] status Status returned by call
+ * @param[in] function Name of calling function
+ */
+void check_status(cufftResult status, const std::string& function) {
+  if (status != CUFFT_SUCCESS) {
+    throw std::runtime_error("\nERROR: in numeric_utils::device::" + function +
+                             ": cuFFT error " + std::to_string(status) + "\n");
+  }
+}
+
+/**
+ * Throw exception if a cuBLAS call failed
+ * @param[in] status Status returned by call
+ * @param[in] function Name of calling function
+ */
+void check_status(cublasStatus_t status, const std::string& function) {
+  if (status != CUBLAS_STATUS_SUCCESS) {
+    throw std::runtime_error("\nERROR: in numeric_utils::device::" + function +
+                             ": cuBLAS error " + std::to_string(status) +
+                             "\n");
+  }
+}
+
+/**
+ * Throw exception if a cuSOLVER call failed
+ * @param[in] status Status returned by call
+ * @param[in] function Name of calling function
+ */
+void check_status(cusolverStatus_t status, const std::string& function) {
+  if (status != CUSOLVER_STATUS_SUCCESS) {
+    throw std::runtime_error("\nERROR: in numeric_utils::device::" + function +
+                             ": cuSOLVER error " + std::to_string(status) +
+                             "\n");
+  }
+}
+
+/**
+ * Buffer in device memory, freed on destruction
+ */
+class DeviceBuffer {
+ public:
+  /**
+   * @constructor Allocate device memory
+   * @param[in] bytes Size of buffer in bytes
+   */
+  explicit DeviceBuffer(std::size_t bytes) : data_{nullptr} {
+    check_status(cudaMalloc(&data_, bytes), "DeviceBuffer");
+  }
+
+  /**
+   * @destructor Free device memory
+   */
+  ~DeviceBuffer() { cudaFree(data_); }
+
+  DeviceBuffer(const DeviceBuffer&) = delete;
+  DeviceBuffer& operator=(const DeviceBuffer&) = delete;
+
+  /**
+   * Get pointer to device memory
+   * @return Pointer to device memory
+   */
+  void* data() const { return data_; }
+
+ private:
+  void* data_; /**< Device memory */
+};
+
+/**
+ * cuBLAS and cuSOLVER handles, destroyed on destruction. Creating handles
+ * initializes library state on the device, so they are kept for the lifetime
+ * of the process and calls using them are serialized.
+ */
+struct SolverHandles {
+  SolverHandles() {
+    check_status(cublasCreate(&blas), "cholesky_products");
+    cusolverStatus_t status = cusolverDnCreate(&solver);
+    if (status != CUSOLVER_STATUS_SUCCESS) {
+      cublasDestroy(blas);
+      check_status(status, "cholesky_products");
+    }
+  }
+
+  ~SolverHandles() {
+    cusolverDnDestroy(solver);
+    cublasDestroy(blas);
+  }
+
+  SolverHandles(const SolverHandles&) = delete;
+  SolverHandles& operator=(const SolverHandles&) = delete;
+
+  /**
+   * Get handles shared by all batched factorizations, creating them on first
+   * use
+   * @return Shared handles
+   */
+  static SolverHandles& shared() {
+    static SolverHandles handles;
+    return handles;
+  }
+
+  cublasHandle_t blas; /**< cuBLAS handle */
+  cusolverDnHandle_t solver; /**< cuSOLVER handle */
+  std::mutex mutex; /**< Serializes calls using handles */
+};
+
+// Precision-specific cuSOLVER and cuBLAS calls
+cusolverStatus_t potrf_batched(cusolverDnHandle_t handle, int size,
+                               double** matrices, int* info, int batch) {
+  return cusolverDnDpotrfBatched(handle, CUBLAS_FILL_MODE_LOWER, size,
+                                 matrices, size, info, batch);
+}
+
+cusolverStatus_t potrf_batched(cusolverDnHandle_t handle, int size,
+                               float** matrices, int* info, int batch) {
+  return cusolverDnSpotrfBatched(handle, CUBLAS_FILL_MODE_LOWER, size,
+                                 matrices, size, info, batch);
+}
+
+cublasStatus_t gemm_strided_batched(cublasHandle_t handle, int size,
+                                    const double* vectors,
+                                    const double* factors, double* products,
+                                    int batch) {
+  const double one = 1.0, zero = 0.0;
+  return cublasDgemmStridedBatched(
+      handle, CUBLAS_OP_N, CUBLAS_OP_T, 2, size, size, &one, vectors, 2,
+      2 * static_cast<long long>(size), factors, size,
+      static_cast<long long>(size) * size, &zero, products, 2,
+      2 * static_cast<long long>(size), batch);
+}
+
+cublasStatus_t gemm_strided_batched(cublasHandle_t handle, int size,
+                                    const float* vectors, const float* factors,
+                                    float* products, int batch) {
+  const float one = 1.0f, zero = 0.0f;
+  return cublasSgemmStridedBatched(
+      handle, CUBLAS_OP_N, CUBLAS_OP_T, 2, size, size, &one, vectors, 2,
+      2 * static_cast<long long>(size), factors, size,
+      static_cast<long long>(size) * size, &zero, products, 2,
+      2 * static_cast<long long>(size), batch);
+}
+#endif
+
+/**
+ * Factor a batch of matrices on the device and multiply each lower factor by
+ * a complex vector
+ * @tparam Tscalar Floating-point type of matrices and vectors
+ * @param[in] size Number of rows and columns of each matrix
+ * @param[in] num_matrices Number of matrices in batch
+ * @param[in] matrices Column-major matrices with zero upper triangles
+ * @param[in] vectors Complex vectors stored one after another
+ * @param[out] products Buffer for products stored one after another
+ * @return Returns true if all matrices are positive definite
+ */
+template <typename Tscalar>
+bool batch_cholesky_products(std::size_t size, std::size_t num_matrices,
+                             const Tscalar* matrices,
+                             const std::complex<Tscalar>* vectors,
+                             std::complex<Tscalar>* products) {
+  if (!numeric_utils::device::available()) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::device::cholesky_products: No GPU "
+        "available\n");
+  }
+
+#ifdef SMELT_ENABLE_CUDA
+  if (num_matrices == 0) {
+    return true;
+  }
+
+  std::size_t matrix_bytes = num_matrices * size * size * sizeof(Tscalar);
+  std::size_t vector_bytes =
+      num_matrices * size * sizeof(std::complex<Tscalar>);
+  DeviceBuffer device_matrices(matrix_bytes), device_vectors(vector_bytes),
+      device_products(vector_bytes),
+      device_pointers(num_matrices * sizeof(Tscalar*)),
+      device_info(num_matrices * sizeof(int));
+  check_status(cudaMemcpy(device_matrices.data(), matrices, matrix_bytes,
+                          cudaMemcpyHostToDevice),
+               "cholesky_products");
+  check_status(cudaMemcpy(device_vectors.data(), vectors, vector_bytes,
+                          cudaMemcpyHostToDevice),
+               "cholesky_products");
+
+  // Batched factorization takes an array of pointers to the matrices
+  Tscalar* first_matrix = static_cast<Tscalar*>(device_matrices.data());
+  std::vector<Tscalar*> pointers(num_matrices);
+  for (std::size_t i = 0; i < num_matrices; ++i) {
+    pointers[i] = first_matrix + i * size * size;
+  }
+  check_status(cudaMemcpy(device_pointers.data(), pointers.data(),
+                          num_matrices * sizeof(Tscalar*),
+                          cudaMemcpyHostToDevice),
+               "cholesky_products");
+
+  auto& handles = SolverHandles::shared();
+  std::lock_guard<std::mutex> lock(handles.mutex);
+  check_status(potrf_batched(handles.solver, static_cast<int>(size),
+                             static_cast<Tscalar**>(device_pointers.data()),
+                             static_cast<int*>(device_info.data()),
+                             static_cast<int>(num_matrices)),
+               "cholesky_products");
+
+  // Each complex vector is a 2 x size real matrix, so the product of a
+  // factor and a vector is the vector times the transposed factor
+  check_status(
+      gemm_strided_batched(
+          handles.blas, static_cast<int>(size),
+          static_cast<const Tscalar*>(device_vectors.data()), first_matrix,
+          static_cast<Tscalar*>(device_products.data()),
+          static_cast<int>(num_matrices)),
+      "cholesky_products");
+
+  std::vector<int> info(num_matrices);
+  check_status(cudaMemcpy(products, device_products.data(), vector_bytes,
+                          cudaMemcpyDeviceToHost),
+               "cholesky_products");
+  check_status(cudaMemcpy(info.data(), device_info.data(),
+                          num_matrices * sizeof(int), cudaMemcpyDeviceToHost),
+               "cholesky_products");
+
+  for (auto status : info) {
+    if (status != 0) {
+      return false;
+    }
+  }
+#endif
+
+  return true;
+}
+}  // namespace
+
+bool numeric_utils::device::available() {
+#ifdef SMELT_ENABLE_CUDA
+  static const bool has_device = []() {
+    int num_devices = 0;
+    return cudaGetDeviceCount(&num_devices) == cudaSuccess && num_devices > 0;
+  }();
+  return has_device;
+#else
+  return false;
+#endif
+}
+
+void numeric_utils::device::set_enabled(bool enabled) {
+  device_enabled = enabled;
+}
+
+bool numeric_utils::device::enabled() {
+  return device_enabled && available();
+}
+
+#ifdef SMELT_ENABLE_CUDA
+/**
+ * cuFFT plan with device buffers of a batch of transforms
+ */
+struct numeric_utils::device::BatchFFT::Impl {
+  cufftHandle plan; /**< cuFFT plan */
+  cublasHandle_t blas; /**< cuBLAS handle used to scale backward transforms */
+  cufftType type; /**< Type of transforms */
+  bool forward; /**< Direction of transforms */
+  std::size_t input_bytes; /**< Size of input records in bytes */
+  std::size_t output_bytes; /**< Size of output records in bytes */
+  std::size_t num_outputs; /**< Number of real values of output records */
+  double scale; /**< Scale of backward transforms */
+  std::unique_ptr<DeviceBuffer> input; /**< Device input records */
+  std::unique_ptr<DeviceBuffer> output; /**< Device output records */
+  std::mutex mutex; /**< Serializes transforms using buffers */
+};
+#else
+/**
+ * Placeholder for cuFFT plan in builds without GPU backend
+ */
+struct numeric_utils::device::BatchFFT::Impl {};
+#endif
+
+numeric_utils::device::BatchFFT::BatchFFT(std::size_t size,
+                                          std::size_t num_transforms,
+                                          bool real_domain, bool forward,
+                                          bool single_precision) {
+  if (!available()) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::device::BatchFFT::BatchFFT: No GPU "
+        "available\n");
+  }
+
+#ifdef SMELT_ENABLE_CUDA
+  impl_.reset(new Impl);
+  impl_->forward = forward;
+  impl_->scale = 1.0 / static_cast<double>(size);
+
+  // Sizes of records in each domain
+  std::size_t real_bytes = single_precision ? sizeof(float) : sizeof(double);
+  std::size_t complex_length = real_domain ? size / 2 + 1 : size;
+  std::size_t real_record_bytes = (real_domain ? 1 : 2) * size * real_bytes;
+  std::size_t complex_record_bytes = 2 * complex_length * real_bytes;
+  impl_->input_bytes =
+      num_transforms * (forward ? real_record_bytes : complex_record_bytes);
+  impl_->output_bytes =
+      num_transforms * (forward ? complex_record_bytes : real_record_bytes);
+  impl_->num_outputs = impl_->output_bytes / real_bytes;
+
+  if (real_domain) {
+    impl_->type = forward ? (single_precision ? CUFFT_R2C : CUFFT_D2Z)
+                          : (single_precision ? CUFFT_C2R : CUFFT_Z2D);
+  } else {
+    impl_->type = single_precision ? CUFFT_C2C : CUFFT_Z2Z;
+  }
+
+  int length = static_cast<int>(size);
+  check_status(cufftPlan1d(&impl_->plan, length, impl_->type,
+                           static_cast<int>(num_transforms)),
+               "BatchFFT::BatchFFT");
+  cublasStatus_t blas_status = cublasCreate(&impl_->blas);
+  if (blas_status != CUBLAS_STATUS_SUCCESS) {
+    cufftDestroy(impl_->plan);
+    check_status(blas_status, "BatchFFT::BatchFFT");
+  }
+
+  try {
+    impl_->input.reset(new DeviceBuffer(impl_->input_bytes));
+    impl_->output.reset(new DeviceBuffer(impl_->output_bytes));
+  } catch (const std::exception&) {
+    cublasDestroy(impl_->blas);
+    cufftDestroy(impl_->plan);
+    throw;
+  }
+#endif
+}
+
+numeric_utils::device::BatchFFT::~BatchFFT() {
+#ifdef SMELT_ENABLE_CUDA
+  if (impl_) {
+    cublasDestroy(impl_->blas);
+    cufftDestroy(impl_->plan);
+  }
+#endif
+}
+
+void numeric_utils::device::BatchFFT::compute(const void* input,
+                                              void* output) const {
+#ifdef SMELT_ENABLE_CUDA
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  void* device_input = impl_->input->data();
+  void* device_output = impl_->output->data();
+  check_status(cudaMemcpy(device_input, input, impl_->input_bytes,
+                          cudaMemcpyHostToDevice),
+               "BatchFFT::compute");
+
+  int direction = impl_->forward ? CUFFT_FORWARD : CUFFT_INVERSE;
+  cufftResult status = CUFFT_SUCCESS;
+  switch (impl_->type) {
+    case CUFFT_D2Z:
+      status = cufftExecD2Z(impl_->plan,
+                            static_cast<cufftDoubleReal*>(device_input),
+                            static_cast<cufftDoubleComplex*>(device_output));
+      break;
+    case CUFFT_Z2D:
+      status = cufftExecZ2D(impl_->plan,
+                            static_cast<cufftDoubleComplex*>(device_input),
+                            static_cast<cufftDoubleReal*>(device_output));
+      break;
+    case CUFFT_Z2Z:
+      status = cufftExecZ2Z(impl_->plan,
+                            static_cast<cufftDoubleComplex*>(device_input),
+                            static_cast<cufftDoubleComplex*>(device_output),
+                            direction);
+      break;
+    case CUFFT_R2C:
+      status = cufftExecR2C(impl_->plan, static_cast<cufftReal*>(device_input),
+                            static_cast<cufftComplex*>(device_output));
+      break;
+    case CUFFT_C2R:
+      status = cufftExecC2R(impl_->plan,
+                            static_cast<cufftComplex*>(device_input),
+                            static_cast<cufftReal*>(device_output));
+      break;
+    case CUFFT_C2C:
+      status = cufftExecC2C(impl_->plan,
+                            static_cast<cufftComplex*>(device_input),
+                            static_cast<cufftComplex*>(device_output),
+                            direction);
+      break;
+  }
+  check_status(status, "BatchFFT::compute");
+
+  // cuFFT does not scale backward transforms
+  if (!impl_->forward) {
+    int num_outputs = static_cast<int>(impl_->num_outputs);
+    bool single_precision = impl_->type == CUFFT_C2R ||
+                            impl_->type == CUFFT_C2C;
+    if (single_precision) {
+      float scale = static_cast<float>(impl_->scale);
+      check_status(cublasSscal(impl_->blas, num_outputs, &scale,
+                               static_cast<float*>(device_output), 1),
+                   "BatchFFT::compute");
+    } else {
+      check_status(cublasDscal(impl_->blas, num_outputs, &impl_->scale,
+                               static_cast<double*>(device_output), 1),
+                   "BatchFFT::compute");
+    }
+  }
+
+  check_status(cudaMemcpy(output, device_output, impl_->output_bytes,
+                          cudaMemcpyDeviceToHost),
+               "BatchFFT::compute");
+#else
+  throw std::runtime_error(
+      "\nERROR: in numeric_utils::device::BatchFFT::compute: No GPU "
+      "available\n");
+#endif
+}
+
+bool numeric_utils::device::cholesky_products(
+    std::size_t size, std::size_t num_matrices, const double* matrices,
+    const std::complex<double>* vectors, std::complex<double>* products) {
+  return batch_cholesky_products(size, num_matrices, matrices, vectors,
+                                 products);
+}
+
+bool numeric_utils::device::cholesky_products(
+    std::size_t size, std::size_t num_matrices, const float* matrices,
+    const std::complex<float>* vectors, std::complex<float>* products) {
+  return batch_cholesky_products(size, num_matrices, matrices, vectors,
+                                 products);
+}
@@ -0,0 +1,28 @@
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <mkl_vml.h>
+#include "distribution.h"
+
+void stochastic::Distribution::cumulative_dist_func(
+    const double* locations, double* evaluations,
+    std::size_t num_values) const {
+  auto results = cumulative_dist_func(
+      std::vector<double>(locations, locations + num_values));
+  std::copy(results.begin(), results.end(), evaluations);
+}
+
+void stochastic::Distribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations,
+    std::size_t num_values) const {
+  auto results = inv_cumulative_dist_func(
+      std::vector<double>(probabilities, probabilities + num_values));
+  std::copy(results.begin(), results.end(), evaluations);
+}
+
+void stochastic::Distribution::transform_from_std_normal(
+    const double* std_normal_values, double* evaluations,
+    std::size_t num_values) const {
+  vdCdfNorm(static_cast<MKL_INT>(num_values), std_normal_values, evaluations);
+  inv_cumulative_dist_func(evaluations, evaluations, num_values);
+}
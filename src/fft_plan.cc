@@ -0,0 +1,371 @@
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <mkl_dfti.h>
+#include "device_backend.h"
+#include "fft_plan.h"
+#include "lru_cache.h"
+#include "profiler.h"
+
+numeric_utils::FFTPlan::FFTPlan(std::size_t size, Domain domain,
+                                Placement placement)
+    : size_{size},
+      domain_{domain},
+      placement_{placement},
+      descriptor_{nullptr} {
+  if (size_ == 0) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::FFTPlan::FFTPlan: Transform length must be "
+        "positive\n");
+  }
+
+  // Allocate the descriptor data structure and initializes it with default
+  // configuration values
+  MKL_LONG fft_status = DftiCreateDescriptor(
+      &descriptor_, DFTI_DOUBLE,
+      domain_ == Domain::Real ? DFTI_REAL : DFTI_COMPLEX, 1,
+      static_cast<MKL_LONG>(size_));
+  if (fft_status != DFTI_NO_ERROR) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::FFTPlan::FFTPlan: Error in descriptor "
+        "creation\n");
+  }
+
+  // Set placement and set the backward scale factor to be 1 divided by the
+  // transform length to make the backward tranform the inverse of the
+  // forward transform. Conjugate-even data is stored as size / 2 + 1 complex
+  // values.
+  fft_status = DftiSetValue(
+      descriptor_, DFTI_PLACEMENT,
+      placement_ == Placement::InPlace ? DFTI_INPLACE : DFTI_NOT_INPLACE);
+  if (fft_status == DFTI_NO_ERROR) {
+    fft_status = DftiSetValue(descriptor_, DFTI_BACKWARD_SCALE,
+                              static_cast<double>(1.0 / size_));
+  }
+  if (fft_status == DFTI_NO_ERROR && domain_ == Domain::Real) {
+    fft_status = DftiSetValue(descriptor_, DFTI_CONJUGATE_EVEN_STORAGE,
+                              DFTI_COMPLEX_COMPLEX);
+  }
+  if (fft_status != DFTI_NO_ERROR) {
+    DftiFreeDescriptor(&descriptor_);
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::FFTPlan::FFTPlan: Error in setting "
+        "configuration\n");
+  }
+
+  // Perform all initialization for the actual FFT computation
+  fft_status = DftiCommitDescriptor(descriptor_);
+  if (fft_status != DFTI_NO_ERROR) {
+    DftiFreeDescriptor(&descriptor_);
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::FFTPlan::FFTPlan: Error in committing "
+        "descriptor\n");
+  }
+}
+
+numeric_utils::FFTPlan::~FFTPlan() {
+  if (descriptor_) {
+    DftiFreeDescriptor(&descriptor_);
+  }
+}
+
+std::shared_ptr<const numeric_utils::FFTPlan> numeric_utils::FFTPlan::cached(
+    std::size_t size, Domain domain, Placement placement) {
+  // Number of entries kept before the least recently used one is evicted,
+  // which bounds memory when transforms of many different lengths are
+  // computed without discarding lengths that are still in use
+  const std::size_t max_entries = 32;
+  static utilities::LruCache<std::tuple<std::size_t, Domain, Placement>,
+                             std::shared_ptr<const FFTPlan>>
+      cache(max_entries);
+
+  auto key = std::make_tuple(size, domain, placement);
+  std::shared_ptr<const FFTPlan> plan;
+  if (cache.find(key, plan)) {
+    return plan;
+  }
+
+  // Construct outside of lock so other threads are not blocked
+  plan = std::make_shared<const FFTPlan>(size, domain, placement);
+  return cache.insert(key, plan);
+}
+
+void numeric_utils::FFTPlan::forward(const std::complex<double>* input,
+                                     std::complex<double>* output) const {
+  check(Domain::Complex, Placement::OutOfPlace, "forward");
+  compute(true, input, output, "forward");
+}
+
+void numeric_utils::FFTPlan::forward(const double* input,
+                                     std::complex<double>* output) const {
+  check(Domain::Real, Placement::OutOfPlace, "forward");
+  compute(true, input, output, "forward");
+}
+
+void numeric_utils::FFTPlan::backward(const std::complex<double>* input,
+                                      std::complex<double>* output) const {
+  check(Domain::Complex, Placement::OutOfPlace, "backward");
+  compute(false, input, output, "backward");
+}
+
+void numeric_utils::FFTPlan::backward(const std::complex<double>* input,
+                                      double* output) const {
+  check(Domain::Real, Placement::OutOfPlace, "backward");
+  compute(false, input, output, "backward");
+}
+
+void numeric_utils::FFTPlan::forward(std::complex<double>* data) const {
+  check(Domain::Complex, Placement::InPlace, "forward");
+  compute(true, data, nullptr, "forward");
+}
+
+void numeric_utils::FFTPlan::forward(double* data) const {
+  check(Domain::Real, Placement::InPlace, "forward");
+  compute(true, data, nullptr, "forward");
+}
+
+void numeric_utils::FFTPlan::backward(std::complex<double>* data) const {
+  check(Domain::Complex, Placement::InPlace, "backward");
+  compute(false, data, nullptr, "backward");
+}
+
+void numeric_utils::FFTPlan::backward(double* data) const {
+  check(Domain::Real, Placement::InPlace, "backward");
+  compute(false, data, nullptr, "backward");
+}
+
+void numeric_utils::FFTPlan::check(Domain domain, Placement placement,
+                                   const char* function) const {
+  if (domain != domain_ || placement != placement_) {
+    throw std::runtime_error(
+        std::string("\nERROR: in numeric_utils::FFTPlan::") + function +
+        ": Plan domain or placement does not match transform\n");
+  }
+}
+
+void numeric_utils::FFTPlan::compute(bool forward_direction, const void* input,
+                                     void* output,
+                                     const char* function) const {
+  SMELT_PROFILE_COUNT("fftTransforms", 1);
+
+  // Input is not modified by out of place transforms
+  void* input_data = const_cast<void*>(input);
+  MKL_LONG fft_status;
+  if (output) {
+    fft_status = forward_direction
+                     ? DftiComputeForward(descriptor_, input_data, output)
+                     : DftiComputeBackward(descriptor_, input_data, output);
+  } else {
+    fft_status = forward_direction
+                     ? DftiComputeForward(descriptor_, input_data)
+                     : DftiComputeBackward(descriptor_, input_data);
+  }
+
+  if (fft_status != DFTI_NO_ERROR) {
+    throw std::runtime_error(
+        std::string("\nERROR: in numeric_utils::FFTPlan::") + function +
+        ": Error in computing FFT\n");
+  }
+}
+
+numeric_utils::BatchFFTPlan::BatchFFTPlan(std::size_t size,
+                                          std::size_t num_transforms,
+                                          FFTPlan::Domain domain,
+                                          Direction direction,
+                                          std::size_t input_distance,
+                                          std::size_t output_distance,
+                                          Precision precision)
+    : size_{size},
+      num_transforms_{num_transforms},
+      domain_{domain},
+      direction_{direction},
+      precision_{precision},
+      descriptor_{nullptr} {
+  if (size_ == 0 || num_transforms_ == 0) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::BatchFFTPlan::BatchFFTPlan: Transform "
+        "length and number of transforms must be positive\n");
+  }
+
+  // Contiguous records use the length of the record in each domain
+  std::size_t real_length = size_, complex_length = size_;
+  if (domain_ == FFTPlan::Domain::Real) {
+    complex_length = size_ / 2 + 1;
+  }
+  bool forward_direction = direction_ == Direction::Forward;
+  if (input_distance == 0) {
+    input_distance = forward_direction ? real_length : complex_length;
+  }
+  if (output_distance == 0) {
+    output_distance = forward_direction ? complex_length : real_length;
+  }
+
+  // Allocate the descriptor data structure and initializes it with default
+  // configuration values
+  MKL_LONG fft_status = DftiCreateDescriptor(
+      &descriptor_,
+      precision_ == Precision::Single ? DFTI_SINGLE : DFTI_DOUBLE,
+      domain_ == FFTPlan::Domain::Real ? DFTI_REAL : DFTI_COMPLEX, 1,
+      static_cast<MKL_LONG>(size_));
+  if (fft_status != DFTI_NO_ERROR) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::BatchFFTPlan::BatchFFTPlan: Error in "
+        "descriptor creation\n");
+  }
+
+  // Configure out of place batch of transforms, with backward transforms
+  // scaled to invert forward transforms
+  fft_status = DftiSetValue(descriptor_, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
+  if (fft_status == DFTI_NO_ERROR) {
+    fft_status = DftiSetValue(descriptor_, DFTI_BACKWARD_SCALE,
+                              static_cast<double>(1.0 / size_));
+  }
+  if (fft_status == DFTI_NO_ERROR && domain_ == FFTPlan::Domain::Real) {
+    fft_status = DftiSetValue(descriptor_, DFTI_CONJUGATE_EVEN_STORAGE,
+                              DFTI_COMPLEX_COMPLEX);
+  }
+  if (fft_status == DFTI_NO_ERROR) {
+    fft_status = DftiSetValue(descriptor_, DFTI_NUMBER_OF_TRANSFORMS,
+                              static_cast<MKL_LONG>(num_transforms_));
+  }
+  if (fft_status == DFTI_NO_ERROR) {
+    fft_status = DftiSetValue(descriptor_, DFTI_INPUT_DISTANCE,
+                              static_cast<MKL_LONG>(input_distance));
+  }
+  if (fft_status == DFTI_NO_ERROR) {
+    fft_status = DftiSetValue(descriptor_, DFTI_OUTPUT_DISTANCE,
+                              static_cast<MKL_LONG>(output_distance));
+  }
+  if (fft_status != DFTI_NO_ERROR) {
+    DftiFreeDescriptor(&descriptor_);
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::BatchFFTPlan::BatchFFTPlan: Error in "
+        "setting configuration\n");
+  }
+
+  // Perform all initialization for the actual FFT computation
+  fft_status = DftiCommitDescriptor(descriptor_);
+  if (fft_status != DFTI_NO_ERROR) {
+    DftiFreeDescriptor(&descriptor_);
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::BatchFFTPlan::BatchFFTPlan: Error in "
+        "committing descriptor\n");
+  }
+
+  // Large contiguous batches are also planned on the GPU, if enabled, where
+  // transforms outweigh the transfers of records. Plans constructed while GPU
+  // kernels are disabled stay on the host.
+  const std::size_t min_device_values = 1 << 16;
+  bool contiguous =
+      input_distance == (forward_direction ? real_length : complex_length) &&
+      output_distance == (forward_direction ? complex_length : real_length);
+  if (device::enabled() && contiguous &&
+      size_ * num_transforms_ >= min_device_values) {
+    try {
+      device_plan_.reset(new device::BatchFFT(
+          size_, num_transforms_, domain_ == FFTPlan::Domain::Real,
+          forward_direction, precision_ == Precision::Single));
+    } catch (const std::exception&) {
+      DftiFreeDescriptor(&descriptor_);
+      throw;
+    }
+  }
+}
+
+numeric_utils::BatchFFTPlan::~BatchFFTPlan() {
+  if (descriptor_) {
+    DftiFreeDescriptor(&descriptor_);
+  }
+}
+
+std::shared_ptr<const numeric_utils::BatchFFTPlan>
+numeric_utils::BatchFFTPlan::cached(std::size_t size,
+                                    std::size_t num_transforms,
+                                    FFTPlan::Domain domain,
+                                    Direction direction,
+                                    Precision precision) {
+  // Number of entries kept before the least recently used one is evicted,
+  // which bounds memory when batches of many different sizes are computed
+  // without discarding sizes that are still in use
+  const std::size_t max_entries = 32;
+  static utilities::LruCache<std::tuple<std::size_t, std::size_t,
+                                        FFTPlan::Domain, Direction, Precision>,
+                             std::shared_ptr<const BatchFFTPlan>>
+      cache(max_entries);
+
+  auto key =
+      std::make_tuple(size, num_transforms, domain, direction, precision);
+  std::shared_ptr<const BatchFFTPlan> plan;
+  if (cache.find(key, plan)) {
+    return plan;
+  }
+
+  // Construct outside of lock so other threads are not blocked
+  plan = std::make_shared<const BatchFFTPlan>(size, num_transforms, domain,
+                                              direction, 0, 0, precision);
+  return cache.insert(key, plan);
+}
+
+void numeric_utils::BatchFFTPlan::compute(const std::complex<double>* input,
+                                          std::complex<double>* output) const {
+  compute(FFTPlan::Domain::Complex, false, Precision::Double, input, output);
+}
+
+void numeric_utils::BatchFFTPlan::compute(const double* input,
+                                          std::complex<double>* output) const {
+  compute(FFTPlan::Domain::Real, true, Precision::Double, input, output);
+}
+
+void numeric_utils::BatchFFTPlan::compute(const std::complex<double>* input,
+                                          double* output) const {
+  compute(FFTPlan::Domain::Real, false, Precision::Double, input, output);
+}
+
+void numeric_utils::BatchFFTPlan::compute(const std::complex<float>* input,
+                                          std::complex<float>* output) const {
+  compute(FFTPlan::Domain::Complex, false, Precision::Single, input, output);
+}
+
+void numeric_utils::BatchFFTPlan::compute(const float* input,
+                                          std::complex<float>* output) const {
+  compute(FFTPlan::Domain::Real, true, Precision::Single, input, output);
+}
+
+void numeric_utils::BatchFFTPlan::compute(const std::complex<float>* input,
+                                          float* output) const {
+  compute(FFTPlan::Domain::Real, false, Precision::Single, input, output);
+}
+
+void numeric_utils::BatchFFTPlan::compute(FFTPlan::Domain domain,
+                                          bool real_input, Precision precision,
+                                          const void* input,
+                                          void* output) const {
+  bool forward_direction = direction_ == Direction::Forward;
+  if (domain != domain_ || precision != precision_ ||
+      (domain_ == FFTPlan::Domain::Real && real_input != forward_direction)) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::BatchFFTPlan::compute: Plan domain, "
+        "direction or precision does not match transform\n");
+  }
+
+  SMELT_PROFILE_COUNT("fftTransforms", num_transforms_);
+
+  if (device_plan_ && device::enabled()) {
+    device_plan_->compute(input, output);
+    return;
+  }
+
+  // Input is not modified by out of place transforms
+  void* input_data = const_cast<void*>(input);
+  MKL_LONG fft_status =
+      forward_direction ? DftiComputeForward(descriptor_, input_data, output)
+                        : DftiComputeBackward(descriptor_, input_data, output);
+  if (fft_status != DFTI_NO_ERROR) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::BatchFFTPlan::compute: Error in computing "
+        "FFT\n");
+  }
+}
@@ -0,0 +1,140 @@
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+// Eigen dense matrices
+#include <Eigen/Dense>
+
+#include "filter_bank.h"
+#include "function_dispatcher.h"
+
+namespace {
+// Types of kernels held in filter bank
+enum class KernelType {
+  HighpassButterworth,
+  HighpassImpulseResponse,
+  AcausalHighpass,
+  HannWindow
+};
+
+// Kernels are keyed by type, order, cutoff frequency, time step and length
+using KernelKey =
+    std::tuple<KernelType, unsigned int, double, double, unsigned int>;
+
+// Number of entries kept before the cache is cleared, which bounds memory
+// when many different record lengths are filtered
+const std::size_t max_entries = 64;
+
+std::mutex cache_mutex;
+std::map<KernelKey, std::shared_ptr<const std::vector<double>>> kernel_cache;
+std::map<KernelKey, std::shared_ptr<const std::vector<std::vector<double>>>>
+    coefficient_cache;
+
+/**
+ * Find kernel in cache, computing and inserting it if not present
+ * @tparam Kernel Type of kernel stored in cache
+ * @tparam Compute Type of function computing kernel
+ * @param[in, out] cache Cache to look up kernel in
+ * @param[in] key Key of kernel
+ * @param[in] compute Function returning kernel for key
+ * @return Shared pointer to cached kernel
+ */
+template <typename Kernel, typename Compute>
+std::shared_ptr<const Kernel> lookup(
+    std::map<KernelKey, std::shared_ptr<const Kernel>>& cache,
+    const KernelKey& key, Compute compute) {
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto entry = cache.find(key);
+    if (entry != cache.end()) {
+      return entry->second;
+    }
+  }
+
+  // Compute outside of lock so other threads are not blocked
+  auto kernel = std::make_shared<const Kernel>(compute());
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  if (kernel_cache.size() + coefficient_cache.size() >= max_entries) {
+    kernel_cache.clear();
+    coefficient_cache.clear();
+  }
+  return cache.emplace(key, kernel).first->second;
+}
+}  // namespace
+
+std::shared_ptr<const std::vector<std::vector<double>>>
+signal_processing::FilterBank::highpass_butterworth(int filter_order,
+                                                    double cutoff_freq) {
+  return lookup(
+      coefficient_cache,
+      KernelKey(KernelType::HighpassButterworth,
+                static_cast<unsigned int>(filter_order), cutoff_freq, 0.0, 0),
+      [filter_order, cutoff_freq]() {
+        return Dispatcher<std::vector<std::vector<double>>, int,
+                          double>::instance()
+            ->dispatch("HighPassButter", filter_order, cutoff_freq);
+      });
+}
+
+std::shared_ptr<const std::vector<double>>
+signal_processing::FilterBank::highpass_impulse_response(int filter_order,
+                                                         double cutoff_freq,
+                                                         int num_samples) {
+  return lookup(
+      kernel_cache,
+      KernelKey(KernelType::HighpassImpulseResponse,
+                static_cast<unsigned int>(filter_order), cutoff_freq, 0.0,
+                static_cast<unsigned int>(num_samples)),
+      [filter_order, cutoff_freq, num_samples]() {
+        auto coefficients = highpass_butterworth(filter_order, cutoff_freq);
+        return Dispatcher<std::vector<double>, std::vector<double>,
+                          std::vector<double>, int, int>::instance()
+            ->dispatch("ImpulseResponse", (*coefficients)[0],
+                       (*coefficients)[1], filter_order, num_samples);
+      });
+}
+
+std::shared_ptr<const std::vector<double>>
+signal_processing::FilterBank::acausal_highpass(double freq_corner,
+                                                double time_step,
+                                                unsigned int filter_order,
+                                                unsigned int num_samples) {
+  return lookup(
+      kernel_cache,
+      KernelKey(KernelType::AcausalHighpass, filter_order, freq_corner,
+                time_step, num_samples),
+      [freq_corner, time_step, filter_order, num_samples]() {
+        return Dispatcher<std::vector<double>, double, double, unsigned int,
+                          unsigned int>::instance()
+            ->dispatch("AcausalHighpassButterworth", freq_corner, time_step,
+                       filter_order, num_samples);
+      });
+}
+
+std::shared_ptr<const std::vector<double>>
+signal_processing::FilterBank::hann_window(unsigned int window_length) {
+  return lookup(
+      kernel_cache,
+      KernelKey(KernelType::HannWindow, 0, 0.0, 0.0, window_length),
+      [window_length]() {
+        auto window =
+            Dispatcher<Eigen::VectorXd, unsigned int>::instance()->dispatch(
+                "HannWindow", window_length);
+        return std::vector<double>(window.data(),
+                                   window.data() + window.size());
+      });
+}
+
+std::size_t signal_processing::FilterBank::size() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return kernel_cache.size() + coefficient_cache.size();
+}
+
+void signal_processing::FilterBank::clear() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  kernel_cache.clear();
+  coefficient_cache.clear();
+}
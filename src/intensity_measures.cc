@@ -0,0 +1,76 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <Eigen/Dense>
+#include "intensity_measures.h"
+
+namespace numeric_utils {
+
+double arias_intensity(const double* acceleration, std::size_t num_steps,
+                       double time_step) {
+  return Eigen::Map<const Eigen::VectorXd>(acceleration, num_steps)
+             .squaredNorm() *
+         (time_step * M_PI / 2.0);
+}
+
+Eigen::VectorXd arias_intensity(const Eigen::MatrixXd& accelerations,
+                                double time_step) {
+  return accelerations.colwise().squaredNorm().transpose() *
+         (time_step * M_PI / 2.0);
+}
+
+void intensity_indices(const double* acceleration, std::size_t num_steps,
+                       const double* percentages, std::size_t* indices,
+                       std::size_t num_percentages) {
+  // Sum energy sequentially so normalized values match a cumulative sum
+  double total_energy = 0.0;
+  for (std::size_t i = 0; i < num_steps; ++i) {
+    total_energy += acceleration[i] * acceleration[i];
+  }
+
+  // Indices equal to number of steps mark percentages not reached yet
+  for (std::size_t j = 0; j < num_percentages; ++j) {
+    indices[j] = num_steps;
+  }
+
+  double energy = 0.0;
+  std::size_t num_found = 0;
+  for (std::size_t i = 0; i < num_steps && num_found < num_percentages; ++i) {
+    energy += acceleration[i] * acceleration[i];
+    double intensity = energy / total_energy * 100.0;
+    for (std::size_t j = 0; j < num_percentages; ++j) {
+      if (indices[j] == num_steps && intensity >= percentages[j]) {
+        indices[j] = i;
+        ++num_found;
+      }
+    }
+  }
+}
+
+std::vector<std::vector<std::size_t>> intensity_indices(
+    const Eigen::MatrixXd& accelerations,
+    const std::vector<double>& percentages) {
+  std::vector<std::vector<std::size_t>> indices(
+      accelerations.cols(), std::vector<std::size_t>(percentages.size()));
+
+  for (unsigned int i = 0; i < accelerations.cols(); ++i) {
+    intensity_indices(accelerations.col(i).data(), accelerations.rows(),
+                      percentages.data(), indices[i].data(),
+                      percentages.size());
+  }
+
+  return indices;
+}
+
+double significant_duration(const double* acceleration, std::size_t num_steps,
+                            double time_step, double start_percentage,
+                            double end_percentage) {
+  const double percentages[2] = {start_percentage, end_percentage};
+  std::size_t indices[2];
+  intensity_indices(acceleration, num_steps, percentages, indices, 2);
+
+  return (static_cast<double>(indices[1]) - static_cast<double>(indices[0])) *
+         time_step;
+}
+}  // namespace numeric_utils
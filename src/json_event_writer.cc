@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "json_event_writer.h"
+#include "json_object.h"
+
+utilities::JsonEventWriter::JsonEventWriter(
+    const std::string& output_location, const JsonFormat& format, bool append)
+    : format_(format), num_events_{0}, existing_events_{false} {
+  if (!append) {
+    output_file_.open(output_location);
+
+    if (!output_file_.is_open()) {
+      throw std::runtime_error(
+          "\nERROR: In utilities::JsonEventWriter::JsonEventWriter(): Could "
+          "not open output location\n");
+    }
+
+    output_file_ << (format_.compact ? "{\"Events\":["
+                                     : "{\n    \"Events\": [");
+    return;
+  }
+
+  // Find the end of the events array, as written by close, from the last
+  // characters of the existing file
+  std::ifstream input_file(output_location);
+  if (!input_file.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonEventWriter::JsonEventWriter(): Could not "
+        "open output location to append to\n");
+  }
+  input_file.seekg(0, std::ios::end);
+  std::streamoff file_size = input_file.tellg();
+  std::string file_end(std::min<std::streamoff>(file_size, 16), '\0');
+  input_file.seekg(file_size - static_cast<std::streamoff>(file_end.size()));
+  input_file.read(&file_end[0], file_end.size());
+  input_file.close();
+
+  auto ends_with = [&file_end](const std::string& end) {
+    return file_end.size() >= end.size() &&
+           file_end.compare(file_end.size() - end.size(), end.size(), end) ==
+               0;
+  };
+  std::string events_end = format_.compact ? "]}\n" : "\n    ]\n}\n";
+  std::string empty_end = format_.compact ? "[]}\n" : "[]\n}\n";
+  std::streamoff end_position;
+  if (ends_with(empty_end)) {
+    // Keep the opening bracket of the empty array
+    end_position = file_size - empty_end.size() + 1;
+  } else if (ends_with(events_end)) {
+    end_position = file_size - events_end.size();
+    existing_events_ = true;
+  } else {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonEventWriter::JsonEventWriter(): Output "
+        "location does not end with an events array written with the same "
+        "formatting options\n");
+  }
+
+  // Opening for reading as well keeps the existing contents
+  output_file_.open(output_location, std::ios::in | std::ios::out);
+  if (!output_file_.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonEventWriter::JsonEventWriter(): Could not "
+        "open output location to append to\n");
+  }
+  output_file_.seekp(end_position);
+}
+
+utilities::JsonEventWriter::~JsonEventWriter() {
+  if (output_file_.is_open()) {
+    try {
+      close();
+    } catch (const std::exception& e) {
+      std::cerr << e.what();
+    }
+  }
+}
+
+void utilities::JsonEventWriter::write_event(const JsonObject& event) {
+  if (!output_file_.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonEventWriter::write_event(): Output "
+        "location has already been closed\n");
+  }
+
+  // Events are elements of the events array, which is nested in the
+  // top-level object
+  if (num_events_ > 0 || existing_events_) {
+    output_file_ << ',';
+  }
+  if (!format_.compact) {
+    output_file_ << "\n        ";
+  }
+  event.write(output_file_, format_, 2);
+
+  if (output_file_.fail()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonEventWriter::write_event(): Error when "
+        "writing to output location\n");
+  }
+
+  ++num_events_;
+}
+
+bool utilities::JsonEventWriter::close() {
+  if (!output_file_.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonEventWriter::close(): Output location has "
+        "already been closed\n");
+  }
+
+  if (format_.compact) {
+    output_file_ << "]}" << std::endl;
+  } else {
+    output_file_ << (num_events_ == 0 && !existing_events_ ? "]" : "\n    ]")
+                 << "\n}" << std::endl;
+  }
+  output_file_.close();
+
+  if (output_file_.fail()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonEventWriter::close(): Error when closing "
+        "output location\n");
+  }
+
+  return true;
+}
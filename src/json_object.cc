@@ -1,11 +1,206 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 // JSON for Modern C++ single-include header
 #include <nlohmann/json.hpp>
 #include "json_object.h"
+#include "parallel.h"
+
+namespace {
+// Arrays of numbers with at least this many elements are formatted in
+// parallel when more than one thread is requested
+const std::size_t parallel_array_size = 16384;
+
+/**
+ * Buffered writer of formatted JSON text to an output stream
+ */
+class JsonTextWriter {
+ public:
+  JsonTextWriter(std::ostream& out, const utilities::JsonFormat& format)
+      : out_(out), format_(format) {}
+
+  ~JsonTextWriter() { flush(); }
+
+  void write(const utilities::json& value, unsigned int depth);
+
+  void flush() {
+    out_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+
+ private:
+  void append(const char* characters, std::size_t num_characters) {
+    buffer_.append(characters, num_characters);
+    if (buffer_.size() > (1 << 20)) {
+      flush();
+    }
+  }
+
+  void append(const std::string& characters) {
+    append(characters.data(), characters.size());
+  }
+
+  // Start new pretty-printed line indented to nesting depth
+  void new_line(unsigned int depth) {
+    if (!format_.compact) {
+      buffer_.push_back('\n');
+      buffer_.append(4 * depth, ' ');
+    }
+  }
+
+  void write_numbers(const utilities::json& values, unsigned int depth);
+
+  std::ostream& out_;
+  const utilities::JsonFormat& format_;
+  std::string buffer_;
+};
+
+// Format number into buffer of at least 64 characters, returning number of
+// characters written
+std::size_t format_number(const utilities::json& value,
+                          unsigned int significant_digits, char* buffer) {
+  const std::size_t buffer_size = 64;
+  if (value.is_number_integer() && !value.is_number_unsigned()) {
+    return std::snprintf(buffer, buffer_size, "%lld",
+                         static_cast<long long>(value.get<std::int64_t>()));
+  }
+  if (value.is_number_unsigned()) {
+    return std::snprintf(
+        buffer, buffer_size, "%llu",
+        static_cast<unsigned long long>(value.get<std::uint64_t>()));
+  }
+
+  double number = value.get<double>();
+  if (!std::isfinite(number)) {
+    std::memcpy(buffer, "null", 4);
+    return 4;
+  }
+
+  // Shortest representation that round-trips, as written by the JSON library
+  if (significant_digits == 0) {
+    return nlohmann::detail::to_chars(buffer, buffer + buffer_size, number) -
+           buffer;
+  }
+
+  std::size_t length = std::snprintf(
+      buffer, buffer_size, "%.*g",
+      static_cast<int>(std::min(significant_digits, 17u)), number);
+  // Keep integral values as floating point numbers
+  if (std::none_of(buffer, buffer + length,
+                   [](char c) { return c == '.' || c == 'e'; })) {
+    std::memcpy(buffer + length, ".0", 2);
+    length += 2;
+  }
+  return length;
+}
+
+void JsonTextWriter::write(const utilities::json& value, unsigned int depth) {
+  switch (value.type()) {
+    case utilities::json::value_t::object: {
+      if (value.empty()) {
+        append("{}", 2);
+        return;
+      }
+      append("{", 1);
+      bool first = true;
+      for (auto it = value.cbegin(); it != value.cend(); ++it) {
+        if (!first) {
+          append(",", 1);
+        }
+        first = false;
+        new_line(depth + 1);
+        append(utilities::json(it.key()).dump());
+        append(format_.compact ? ":" : ": ", format_.compact ? 1 : 2);
+        write(it.value(), depth + 1);
+      }
+      new_line(depth);
+      append("}", 1);
+      return;
+    }
+    case utilities::json::value_t::array: {
+      if (value.empty()) {
+        append("[]", 2);
+        return;
+      }
+      append("[", 1);
+      if (value.size() >= parallel_array_size &&
+          utilities::thread_count(format_.num_threads) > 1 &&
+          std::all_of(value.cbegin(), value.cend(),
+                      [](const utilities::json& element) {
+                        return element.is_number();
+                      })) {
+        write_numbers(value, depth + 1);
+      } else {
+        for (std::size_t i = 0; i < value.size(); ++i) {
+          if (i > 0) {
+            append(",", 1);
+          }
+          new_line(depth + 1);
+          write(value[i], depth + 1);
+        }
+      }
+      new_line(depth);
+      append("]", 1);
+      return;
+    }
+    case utilities::json::value_t::number_integer:
+    case utilities::json::value_t::number_unsigned:
+    case utilities::json::value_t::number_float: {
+      char number_buffer[64];
+      append(number_buffer,
+             format_number(value, format_.significant_digits, number_buffer));
+      return;
+    }
+    default:
+      // Strings, booleans and null are written by the JSON library so
+      // escaping matches its output
+      append(value.dump());
+      return;
+  }
+}
+
+void JsonTextWriter::write_numbers(const utilities::json& values,
+                                   unsigned int depth) {
+  // Format contiguous chunks of the array concurrently and write them in
+  // order, so the output does not depend on the number of threads
+  std::size_t num_chunks = 4 * utilities::thread_count(format_.num_threads);
+  std::size_t chunk_size = (values.size() + num_chunks - 1) / num_chunks;
+  std::vector<std::string> chunks(num_chunks);
+  const std::string separator =
+      format_.compact ? "," : ",\n" + std::string(4 * depth, ' ');
+
+  utilities::parallel_for(
+      num_chunks, format_.num_threads, [&](unsigned int chunk) {
+        std::size_t start = chunk * chunk_size;
+        std::size_t end = std::min(start + chunk_size, values.size());
+        char number_buffer[64];
+        for (std::size_t i = start; i < end; ++i) {
+          if (i > 0) {
+            chunks[chunk].append(separator);
+          }
+          chunks[chunk].append(
+              number_buffer,
+              format_number(values[i], format_.significant_digits,
+                            number_buffer));
+        }
+      });
+
+  new_line(depth);
+  for (const auto& chunk : chunks) {
+    append(chunk);
+  }
+}
+}  // namespace
 
 utilities::JsonObject::JsonObject() { 
   // This is constructed here to ensure the JSON member is stored as an object
@@ -18,6 +213,26 @@ utilities::JsonObject::JsonObject(json library_json)
   json_object_ = library_json;
 }
 
+bool utilities::JsonObject::add_array(const std::string& key,
+                                      const double* values,
+                                      std::size_t num_values) {
+  if (json_object_.find(key) != json_object_.end()) {
+    throw std::runtime_error(
+        "\nWARNING: In utilities::JsonObject::add_array: Input already "
+        "exists, so no value was added!\n");
+  }
+
+  json array = json::array();
+  auto& elements = array.get_ref<json::array_t&>();
+  elements.reserve(num_values);
+  for (std::size_t i = 0; i < num_values; ++i) {
+    elements.emplace_back(values[i]);
+  }
+  json_object_.emplace(key, std::move(array));
+
+  return true;
+}
+
 bool utilities::JsonObject::delete_key(const std::string& key) {
   bool status = true;
   
@@ -61,6 +276,67 @@ bool utilities::JsonObject::write_to_file(
   return status;
 }
 
+bool utilities::JsonObject::write_to_file(const std::string& output_location,
+                                         const JsonFormat& format) const {
+  bool status = true;
+  std::ofstream output_file;
+  output_file.open(output_location);
+
+  if (!output_file.is_open()) {
+    status = false;
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonObject::write_to_file(): Could not open "
+        "output location\n");
+  }
+
+  write(output_file, format);
+  output_file << std::endl;
+
+  output_file.close();
+
+  if (output_file.fail()) {
+    status = false;
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonObject::write_to_file(): Error when "
+        "closing output location\n");
+  }
+
+  return status;
+}
+
+bool utilities::JsonObject::read_from_file(const std::string& input_location) {
+  std::ifstream input_file(input_location);
+
+  if (!input_file.is_open()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonObject::read_from_file(): Could not open "
+        "input location\n");
+  }
+
+  json contents;
+  try {
+    input_file >> contents;
+  } catch (const std::exception&) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonObject::read_from_file(): Input location "
+        "does not contain valid JSON\n");
+  }
+  if (!contents.is_object()) {
+    throw std::runtime_error(
+        "\nERROR: In utilities::JsonObject::read_from_file(): Input location "
+        "does not contain a JSON object\n");
+  }
+
+  json_object_ = std::move(contents);
+  return true;
+}
+
+void utilities::JsonObject::write(std::ostream& out, const JsonFormat& format,
+                                  unsigned int depth) const {
+  JsonTextWriter writer(out, format);
+  writer.write(json_object_, depth);
+}
+
 void utilities::JsonObject::clear() {
   json_object_.clear();
 }
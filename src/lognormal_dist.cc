@@ -1,5 +1,9 @@
+#include <cmath>
+#include <cstddef>
+#include <limits>
 #include <vector>
 #include <boost/math/distributions/lognormal.hpp>
+#include <mkl_vml.h>
 #include "lognormal_dist.h"
 
 stochastic::LognormalDistribution::LognormalDistribution(double mean, double std_dev)
@@ -12,21 +16,47 @@ stochastic::LognormalDistribution::LognormalDistribution(double mean, double std
 std::vector<double> stochastic::LognormalDistribution::cumulative_dist_func(
     const std::vector<double>& locations) const {
   std::vector<double> evaluations(locations.size());
-
-  for (unsigned int i = 0; i < locations.size(); ++i) {
-    evaluations[i] = cdf(distribution_, locations[i]);
-  }
-
+  cumulative_dist_func(locations.data(), evaluations.data(), locations.size());
   return evaluations;
 }
 
 std::vector<double> stochastic::LognormalDistribution::inv_cumulative_dist_func(
     const std::vector<double>& probabilities) const {
   std::vector<double> evaluations(probabilities.size());
+  inv_cumulative_dist_func(probabilities.data(), evaluations.data(),
+                           probabilities.size());
+  return evaluations;
+}
 
-  for (unsigned int i = 0; i < probabilities.size(); ++i) {
-    evaluations[i] = quantile(distribution_, probabilities[i]);
+void stochastic::LognormalDistribution::cumulative_dist_func(
+    const double* locations, double* evaluations,
+    std::size_t num_values) const {
+  // Logarithm of non-positive locations is not a number or negative infinity,
+  // both of which correspond to a CDF value of zero
+  vdLn(static_cast<MKL_INT>(num_values), locations, evaluations);
+  for (std::size_t i = 0; i < num_values; ++i) {
+    evaluations[i] = std::isnan(evaluations[i])
+                         ? -std::numeric_limits<double>::infinity()
+                         : (evaluations[i] - mean_) / std_dev_;
   }
+  vdCdfNorm(static_cast<MKL_INT>(num_values), evaluations, evaluations);
+}
 
-  return evaluations;
+void stochastic::LognormalDistribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations,
+    std::size_t num_values) const {
+  vdCdfNormInv(static_cast<MKL_INT>(num_values), probabilities, evaluations);
+  for (std::size_t i = 0; i < num_values; ++i) {
+    evaluations[i] = mean_ + std_dev_ * evaluations[i];
+  }
+  vdExp(static_cast<MKL_INT>(num_values), evaluations, evaluations);
+}
+
+void stochastic::LognormalDistribution::transform_from_std_normal(
+    const double* std_normal_values, double* evaluations,
+    std::size_t num_values) const {
+  for (std::size_t i = 0; i < num_values; ++i) {
+    evaluations[i] = mean_ + std_dev_ * std_normal_values[i];
+  }
+  vdExp(static_cast<MKL_INT>(num_values), evaluations, evaluations);
 }
@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "multi_start_nelder_mead.h"
+#include "nelder_mead.h"
+#include "parallel.h"
+
+std::vector<std::vector<double>> optimization::MultiStartNelderMead::minimize(
+    const std::vector<std::vector<double>>& initial_points,
+    const std::vector<std::vector<double>>& deltas,
+    std::function<double(const std::vector<double>&)>& objective_function) {
+  if (initial_points.empty() || initial_points.size() != deltas.size()) {
+    throw std::runtime_error(
+        "\nERROR: in optimization::MultiStartNelderMead::minimize: Number of "
+        "initial points must be positive and match number of step sizes\n");
+  }
+
+  std::vector<std::vector<double>> locations = initial_points;
+  minima_.assign(initial_points.size(),
+                 std::numeric_limits<double>::infinity());
+  std::atomic<bool> converged(false);
+
+  // Each start uses its own minimizer so starts are independent of each other
+  // and of the number of threads
+  utilities::parallel_for(
+      initial_points.size(), num_threads_, [&](unsigned int i) {
+        if (stop_early_ && converged) {
+          return;
+        }
+
+        NelderMead minimizer(function_tol_);
+        locations[i] =
+            minimizer.minimize(initial_points[i], deltas[i], objective_function);
+        minima_[i] = minimizer.get_minimum();
+
+        if (minima_[i] < function_tol_) {
+          converged = true;
+        }
+      });
+
+  best_index_ = static_cast<unsigned int>(std::distance(
+      minima_.begin(), std::min_element(minima_.begin(), minima_.end())));
+
+  return locations;
+}
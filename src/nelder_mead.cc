@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include <vector>
 #include "nelder_mead.h"
+#include "profiler.h"
 
 std::vector<double> optimization::NelderMead::minimize(
     const std::vector<double>& initial_point, double delta,
@@ -59,6 +60,7 @@ std::vector<double> optimization::NelderMead::minimize(
     }
     func_vals_[i] = objective_function(evaluation_point);
   }
+  SMELT_PROFILE_COUNT("optimizerEvaluations", num_points_);
 
   num_evals_ = 0;
 
@@ -150,6 +152,7 @@ std::vector<double> optimization::NelderMead::minimize(
           }
         }
         num_evals_ += num_dimensions_;
+        SMELT_PROFILE_COUNT("optimizerEvaluations", num_dimensions_);
         centroids = calc_centroid(simplex_, num_dimensions_, num_points_);
       }
     } else {
@@ -174,6 +177,7 @@ double optimization::NelderMead::reflect(
   }
 
   double objective_value = objective_function(evaluations);
+  SMELT_PROFILE_COUNT("optimizerEvaluations", 1);
 
   if (objective_value < objective_vals[index_worst]) {
     objective_vals[index_worst] = objective_value;
@@ -1,5 +1,7 @@
+#include <cstddef>
 #include <vector>
 #include <boost/math/distributions/normal.hpp>
+#include <mkl_vml.h>
 #include "normal_dist.h"
 
 stochastic::NormalDistribution::NormalDistribution(double mean, double std_dev)
@@ -12,21 +14,40 @@ stochastic::NormalDistribution::NormalDistribution(double mean, double std_dev)
 std::vector<double> stochastic::NormalDistribution::cumulative_dist_func(
     const std::vector<double>& locations) const {
   std::vector<double> evaluations(locations.size());
-
-  for (unsigned int i = 0; i < locations.size(); ++i) {
-    evaluations[i] = cdf(distribution_, locations[i]);
-  }
-
+  cumulative_dist_func(locations.data(), evaluations.data(), locations.size());
   return evaluations;
 }
 
 std::vector<double> stochastic::NormalDistribution::inv_cumulative_dist_func(
     const std::vector<double>& probabilities) const {
   std::vector<double> evaluations(probabilities.size());
+  inv_cumulative_dist_func(probabilities.data(), evaluations.data(),
+                           probabilities.size());
+  return evaluations;
+}
 
-  for (unsigned int i = 0; i < probabilities.size(); ++i) {
-    evaluations[i] = quantile(distribution_, probabilities[i]);
+void stochastic::NormalDistribution::cumulative_dist_func(
+    const double* locations, double* evaluations,
+    std::size_t num_values) const {
+  for (std::size_t i = 0; i < num_values; ++i) {
+    evaluations[i] = (locations[i] - mean_) / std_dev_;
   }
+  vdCdfNorm(static_cast<MKL_INT>(num_values), evaluations, evaluations);
+}
 
-  return evaluations;
+void stochastic::NormalDistribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations,
+    std::size_t num_values) const {
+  vdCdfNormInv(static_cast<MKL_INT>(num_values), probabilities, evaluations);
+  for (std::size_t i = 0; i < num_values; ++i) {
+    evaluations[i] = mean_ + std_dev_ * evaluations[i];
+  }
+}
+
+void stochastic::NormalDistribution::transform_from_std_normal(
+    const double* std_normal_values, double* evaluations,
+    std::size_t num_values) const {
+  for (std::size_t i = 0; i < num_values; ++i) {
+    evaluations[i] = mean_ + std_dev_ * std_normal_values[i];
+  }
 }
@@ -31,23 +31,7 @@ bool NormalMultiVar::generate(
     const Eigen::VectorXd& means, const Eigen::MatrixXd& cov,
     unsigned int cases) {
 
-  bool success = true;
-  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> lower_cholesky;
-  
-  try {
-    auto llt = cov.llt();
-    lower_cholesky = llt.matrixL();
-
-    if (llt.info() == Eigen::NumericalIssue) {
-      throw std::runtime_error(
-          "\nERROR: In NormalMultivar::generate method: Input covariance matrix is not "
-          "positive semi-definite\n");
-    }
-  } catch (const std::exception& e) {
-    std::cerr << "\nERROR: In normal multivariate random number generation: "
-              << e.what() << std::endl;
-    success = false;
-  }
+  bool success = factor_covariance(cov);
 
   random_numbers.resize(cov.rows(), cases);
 
@@ -59,10 +43,10 @@ bool NormalMultiVar::generate(
     }
   }
 
-  // Transform from unit normal distribution based on covariance and mean values
-  for (unsigned int i = 0; i < random_numbers.cols(); ++i) {
-    random_numbers.col(i) = lower_cholesky * random_numbers.col(i) + means;
-  }
+  // Transform from unit normal distribution based on covariance and mean
+  // values for all cases at once
+  random_numbers = lower_cholesky_ * random_numbers;
+  random_numbers.colwise() += means;
 
   return success;
 }
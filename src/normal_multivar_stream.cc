@@ -0,0 +1,45 @@
+#include <cstdint>
+#include <limits>
+#include <string>
+// Eigen dense matrices
+#include <Eigen/Dense>
+
+#include "normal_multivar_stream.h"
+#include "random_stream.h"
+
+namespace numeric_utils {
+
+NormalMultiVarStream::NormalMultiVarStream(std::uint64_t seed)
+    : RandomGenerator(),
+      stream_(seed, std::numeric_limits<std::uint32_t>::max(),
+              std::numeric_limits<std::uint32_t>::max()) {}
+
+bool NormalMultiVarStream::generate(
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& random_numbers,
+    const Eigen::VectorXd& means, const Eigen::MatrixXd& cov,
+    unsigned int cases) {
+
+  bool success = factor_covariance(cov);
+
+  random_numbers.resize(cov.rows(), cases);
+
+  // Cases are drawn one after the other, so drawing several cases at once
+  // gives the same values as drawing them one at a time
+  for (unsigned int i = 0; i < random_numbers.cols(); ++i) {
+    for (unsigned int j = 0; j < random_numbers.rows(); ++j) {
+      random_numbers(j, i) = stream_.normal();
+    }
+  }
+
+  // Transform from unit normal distribution based on covariance and mean
+  // values for all cases at once
+  random_numbers = lower_cholesky_ * random_numbers;
+  random_numbers.colwise() += means;
+
+  return success;
+}
+
+std::string NormalMultiVarStream::name() const {
+  return "NormalMultiVarStream";
+}
+}  // namespace numeric_utils
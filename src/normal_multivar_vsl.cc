@@ -0,0 +1,72 @@
+#include <iostream>
+#include <stdexcept>
+#include <mkl_vsl.h>
+// Eigen dense matrices
+#include <Eigen/Dense>
+
+#include "normal_multivar_vsl.h"
+
+namespace numeric_utils {
+
+NormalMultiVarVsl::NormalMultiVarVsl()
+  : RandomGenerator()
+{
+  if (vslNewStream(&stream_, VSL_BRNG_PHILOX4X32X10,
+                   static_cast<unsigned int>(seed_)) != VSL_STATUS_OK) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::NormalMultiVarVsl: Error in VSL stream "
+        "construction\n");
+  }
+}
+
+NormalMultiVarVsl::NormalMultiVarVsl(int seed)
+  : RandomGenerator()
+{
+  seed_ = seed;
+  if (vslNewStream(&stream_, VSL_BRNG_PHILOX4X32X10,
+                   static_cast<unsigned int>(seed_)) != VSL_STATUS_OK) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::NormalMultiVarVsl: Error in VSL stream "
+        "construction\n");
+  }
+}
+
+NormalMultiVarVsl::~NormalMultiVarVsl() {
+  vslDeleteStream(&stream_);
+}
+
+bool NormalMultiVarVsl::generate(
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& random_numbers,
+    const Eigen::VectorXd& means, const Eigen::MatrixXd& cov,
+    unsigned int cases) {
+
+  bool success = factor_covariance(cov);
+
+  random_numbers.resize(cov.rows(), cases);
+
+  if (cases == 0 || cov.rows() == 0) {
+    return success;
+  }
+
+  // VSL expects the full Cholesky factor in row-major order, which is the
+  // transpose in Eigen's column-major storage. Each generated realization is
+  // stored contiguously, so results are written as columns.
+  Eigen::MatrixXd cholesky_row_major = lower_cholesky_.transpose();
+  int status = vdRngGaussianMV(
+      VSL_RNG_METHOD_GAUSSIANMV_ICDF, stream_, static_cast<MKL_INT>(cases),
+      random_numbers.data(), static_cast<MKL_INT>(cov.rows()),
+      VSL_MATRIX_STORAGE_FULL, means.data(), cholesky_row_major.data());
+
+  if (status != VSL_STATUS_OK) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::NormalMultiVarVsl::generate: Error in VSL "
+        "multivariate normal generation\n");
+  }
+
+  return success;
+}
+
+std::string NormalMultiVarVsl::name() const {
+  return "NormalMultiVarVsl";
+}
+}  // namespace numeric_utils
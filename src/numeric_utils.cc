@@ -1,10 +1,13 @@
+#include <algorithm>
 #include <complex>
+#include <cstddef>
 #include <iostream>
 #include <stdexcept>
 #include <Eigen/Dense>
 #include <mkl.h>
 #include <mkl_dfti.h>
 #include <mkl_vsl.h>
+#include "fft_plan.h"
 #include "numeric_utils.h"
 
 namespace numeric_utils {
@@ -30,9 +33,10 @@ bool convolve_1d(const std::vector<double>& input_x,
   // Create convolution status and task pointer
   int conv_status;
   VSLConvTaskPtr conv_task;
-  // Construct convolution task, with solution mode set to direct
+  // Construct convolution task, letting MKL pick direct or FFT solution
+  // mode from the input sizes
   conv_status =
-      vsldConvNewTask1D(&conv_task, VSL_CONV_MODE_DIRECT, input_x.size(),
+      vsldConvNewTask1D(&conv_task, VSL_CONV_MODE_AUTO, input_x.size(),
                         input_y.size(), response.size());
 
   // Check if convolution construction was successful
@@ -64,100 +68,35 @@ bool convolve_1d(const std::vector<double>& input_x,
   return status;
 }
 
-bool inverse_fft(std::vector<std::complex<double>> input_vector,
+bool inverse_fft(const std::vector<std::complex<double>>& input_vector,
                  std::vector<double>& output_vector) {
   output_vector.resize(input_vector.size());
-
-  // Create task descriptor and MKL status
-  DFTI_DESCRIPTOR_HANDLE fft_descriptor;
-  MKL_LONG fft_status;
-
-  // Allocate the descriptor data structure and initializes it with default
-  // configuration values
-  fft_status = DftiCreateDescriptor(&fft_descriptor, DFTI_DOUBLE, DFTI_REAL, 1,
-                                input_vector.size());
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in descriptor creation\n");
-    return false;
-  }
-  
-  // Set configuration value to not do inplace transformation
-  fft_status = DftiSetValue(fft_descriptor, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in setting configuration\n");
-    return false;
-  }
-
-  // Set the backward scale factor to be 1 divided by the size of the input vector
-  // to make the backward tranform the inverse of the forward transform
-  fft_status = DftiSetValue(fft_descriptor, DFTI_BACKWARD_SCALE,
-                            static_cast<double>(1.0 / input_vector.size()));
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in setting backward "
-        "scale factor\n");
-    return false;
-  }  
-
-  // Perform all initialization for the actual FFT computation
-  fft_status = DftiCommitDescriptor(fft_descriptor);
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in committing descriptor\n");
-    return false;
-  }
-  
-  // Compute the backward FFT
-  fft_status = DftiComputeBackward(fft_descriptor, input_vector.data(),
-                                   output_vector.data());
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in computing backward FFT\n");
-    return false;
-  }
-  
-  // Free the memory allocated for descriptor
-  fft_status = DftiFreeDescriptor(&fft_descriptor);
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::inverse_fft: Error in freeing FFT descriptor\n");
-    return false;
-  }  
-
-  return true;
+  return inverse_real_fft(input_vector.data(), input_vector.size(),
+                          output_vector.data());
 }
 
 bool inverse_fft(const Eigen::VectorXcd& input_vector,
                  Eigen::VectorXd& output_vector) {
-  // Convert input Eigen vector to std vector
-  std::vector<std::complex<double>> input_vals(input_vector.size());
-  std::vector<double> outputs(input_vals.size());
-  Eigen::VectorXcd::Map(&input_vals[0], input_vector.size()) = input_vector;
- 
+  output_vector.resize(input_vector.size());
+
   try {
-    inverse_fft(input_vals, outputs);
+    inverse_real_fft(input_vector.data(), input_vector.size(),
+                     output_vector.data());
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In numeric_utils::inverse_fft (With Eigen Vectors):"
               << e.what() << std::endl;
   }
 
-  // Convert output from std vector to Eigen vector
-  output_vector = Eigen::Map<Eigen::VectorXd>(outputs.data(), outputs.size());
-
   return true;
 }
 
 bool inverse_fft(const Eigen::VectorXcd& input_vector,
                  std::vector<double>& output_vector) {
-  // Convert input Eigen vector to std vector
-  std::vector<std::complex<double>> input_vals(input_vector.size());
-  Eigen::VectorXcd::Map(&input_vals[0], input_vector.size()) = input_vector;
   output_vector.resize(input_vector.size());  
  
   try {
-    inverse_fft(input_vals, output_vector);
+    inverse_real_fft(input_vector.data(), input_vector.size(),
+                     output_vector.data());
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In numeric_utils::inverse_fft (With Eigen Vectors):"
               << e.what() << std::endl;
@@ -166,99 +105,176 @@ bool inverse_fft(const Eigen::VectorXcd& input_vector,
   return true;  
 }
 
-bool fft(std::vector<double> input_vector,
+bool fft(const std::vector<double>& input_vector,
          std::vector<std::complex<double>>& output_vector) {
-  // Convert input vector to complex values
-  std::vector<std::complex<double>> input_complex(input_vector.size());
-  std::copy(input_vector.begin(), input_vector.end(), input_complex.begin());
-  
   output_vector.resize(input_vector.size());
-
-  // Create task descriptor and MKL status
-  DFTI_DESCRIPTOR_HANDLE fft_descriptor;
-  MKL_LONG fft_status;
-
-  // Allocate the descriptor data structure and initializes it with default
-  // configuration values
-  fft_status = DftiCreateDescriptor(&fft_descriptor, DFTI_DOUBLE, DFTI_COMPLEX,
-                                    1, input_complex.size());
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::fft: Error in descriptor creation\n");
-    return false;
-  }
-  
-  // Set configuration value to not do inplace transformation
-  fft_status = DftiSetValue(fft_descriptor, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::fft: Error in setting configuration\n");
-    return false;
-  }
-
-  // Perform all initialization for the actual FFT computation
-  fft_status = DftiCommitDescriptor(fft_descriptor);
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::fft: Error in committing descriptor\n");
-    return false;
-  }
-  
-  // Compute the backward FFT
-  fft_status = DftiComputeForward(fft_descriptor, input_complex.data(),
-                                  output_vector.data());
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::fft: Error in computing FFT\n");
-    return false;
-  }
-  
-  // Free the memory allocated for descriptor
-  fft_status = DftiFreeDescriptor(&fft_descriptor);
-  if (fft_status != DFTI_NO_ERROR) {
-    throw std::runtime_error(
-        "\nERROR: in numeric_utils::fft: Error in freeing FFT descriptor\n");
-    return false;
-  }  
+  full_real_fft(input_vector.data(), input_vector.size(),
+                output_vector.data());
 
   return true;
 }
 
 bool fft(const Eigen::VectorXd& input_vector, Eigen::VectorXcd& output_vector) {
-  // Convert input Eigen vector to std vector
-  std::vector<double> input_vals(input_vector.size());
-  std::vector<std::complex<double>> outputs(input_vals.size());
-  Eigen::VectorXd::Map(&input_vals[0], input_vector.size()) = input_vector;
- 
+  output_vector.resize(input_vector.size());
+
   try {
-    fft(input_vals, outputs);
+    full_real_fft(input_vector.data(), input_vector.size(),
+                  output_vector.data());
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In numeric_utils::fft (With Eigen Vectors):"
               << e.what() << std::endl;
   }
 
-  // Convert output from std vector to Eigen vector
-  output_vector = Eigen::Map<Eigen::VectorXcd>(outputs.data(), outputs.size());
-
   return true;
 }
 
 bool fft(const Eigen::VectorXd& input_vector,
                  std::vector<std::complex<double>>& output_vector) {
-  // Convert input Eigen vector to std vector
-  std::vector<double> input_vals(input_vector.size());
-  Eigen::VectorXd::Map(&input_vals[0], input_vector.size()) = input_vector;
   output_vector.resize(input_vector.size());  
  
   try {
-    fft(input_vals, output_vector);
+    full_real_fft(input_vector.data(), input_vector.size(),
+                  output_vector.data());
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In numeric_utils::fft (With Eigen Vector and STL vector):"
               << e.what() << std::endl;
   }
 
   return true;  
-}  
+}
+
+std::size_t smooth_fft_length(std::size_t min_length) {
+  // Search products of powers of 5 and 3 and pad each with powers of 2
+  std::size_t length = 1;
+  while (length < min_length) {
+    length *= 2;
+  }
+  for (std::size_t power_5 = 1; power_5 < length; power_5 *= 5) {
+    for (std::size_t power_35 = power_5; power_35 < length; power_35 *= 3) {
+      std::size_t candidate = power_35;
+      while (candidate < min_length) {
+        candidate *= 2;
+      }
+      length = std::min(length, candidate);
+    }
+  }
+  return length;
+}
+
+bool real_fft(const double* input, std::size_t size,
+              std::complex<double>* output) {
+  FFTPlan::cached(size, FFTPlan::Domain::Real)->forward(input, output);
+  return true;
+}
+
+bool inverse_real_fft(const std::complex<double>* input, std::size_t size,
+                      double* output) {
+  FFTPlan::cached(size, FFTPlan::Domain::Real)->backward(input, output);
+  return true;
+}
+
+bool real_fft(double* data, std::size_t size) {
+  FFTPlan::cached(size, FFTPlan::Domain::Real, FFTPlan::Placement::InPlace)
+      ->forward(data);
+  return true;
+}
+
+bool inverse_real_fft(double* data, std::size_t size) {
+  FFTPlan::cached(size, FFTPlan::Domain::Real, FFTPlan::Placement::InPlace)
+      ->backward(data);
+  return true;
+}
+
+namespace {
+/**
+ * Computes the forward transforms of the columns of a real matrix as one batch
+ * @tparam Tscalar Floating-point type of records
+ * @param[in] inputs Matrix of real records, with one record per column
+ * @param[in] precision Precision of plan matching scalar type
+ * @param[in, out] outputs Matrix to write rows / 2 + 1 transform values per
+ *                         column to
+ * @return Returns true if computations were successful, false otherwise
+ */
+template <typename Tscalar>
+bool batch_real_fft(
+    const Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>& inputs,
+    BatchFFTPlan::Precision precision,
+    Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic, Eigen::Dynamic>&
+        outputs) {
+  outputs.resize(inputs.rows() / 2 + 1, inputs.cols());
+  if (inputs.size() == 0) {
+    return true;
+  }
+
+  BatchFFTPlan::cached(inputs.rows(), inputs.cols(), FFTPlan::Domain::Real,
+                       BatchFFTPlan::Direction::Forward, precision)
+      ->compute(inputs.data(), outputs.data());
+  return true;
+}
+
+/**
+ * Computes the backward transforms of the columns of a matrix of
+ * conjugate-even halves as one batch
+ * @tparam Tscalar Floating-point type of records
+ * @param[in] inputs Matrix of non-redundant halves of transforms
+ * @param[in] size Length of records
+ * @param[in] precision Precision of plan matching scalar type
+ * @param[in, out] outputs Matrix to write real records to
+ * @return Returns true if computations were successful, false otherwise
+ */
+template <typename Tscalar>
+bool batch_inverse_real_fft(
+    const Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic,
+                        Eigen::Dynamic>& inputs,
+    std::size_t size, BatchFFTPlan::Precision precision,
+    Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>& outputs) {
+  if (static_cast<std::size_t>(inputs.rows()) != size / 2 + 1) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::inverse_real_fft: Number of rows of "
+        "transforms does not match record length\n");
+  }
+
+  outputs.resize(size, inputs.cols());
+  if (inputs.cols() == 0) {
+    return true;
+  }
+
+  BatchFFTPlan::cached(size, inputs.cols(), FFTPlan::Domain::Real,
+                       BatchFFTPlan::Direction::Backward, precision)
+      ->compute(inputs.data(), outputs.data());
+  return true;
+}
+}  // namespace
+
+bool real_fft(const Eigen::MatrixXd& inputs, Eigen::MatrixXcd& outputs) {
+  return batch_real_fft(inputs, BatchFFTPlan::Precision::Double, outputs);
+}
+
+bool inverse_real_fft(const Eigen::MatrixXcd& inputs, std::size_t size,
+                      Eigen::MatrixXd& outputs) {
+  return batch_inverse_real_fft(inputs, size, BatchFFTPlan::Precision::Double,
+                                outputs);
+}
+
+bool real_fft(const Eigen::MatrixXf& inputs, Eigen::MatrixXcf& outputs) {
+  return batch_real_fft(inputs, BatchFFTPlan::Precision::Single, outputs);
+}
+
+bool inverse_real_fft(const Eigen::MatrixXcf& inputs, std::size_t size,
+                      Eigen::MatrixXf& outputs) {
+  return batch_inverse_real_fft(inputs, size, BatchFFTPlan::Precision::Single,
+                                outputs);
+}
+
+void full_real_fft(const double* input, std::size_t size,
+                   std::complex<double>* output) {
+  // Compute non-redundant half of transform and fill remaining values using
+  // conjugate symmetry
+  real_fft(input, size, output);
+  for (std::size_t i = size / 2 + 1; i < size; ++i) {
+    output[i] = std::conj(output[size - i]);
+  }
+}
   
 double trapazoid_rule(const std::vector<double>& input_vector, double spacing) {
   double result = (input_vector[0] + input_vector[input_vector.size() - 1]) / 2.0;
@@ -382,4 +398,32 @@ std::vector<double> evaluate_polynomial(const std::vector<double>& coefficients,
 
   return evaluations;
 }  
+
+bool RandomGenerator::factor_covariance(const Eigen::MatrixXd& cov) {
+  // Reuse factorization if covariance is unchanged
+  if (cov.rows() == covariance_.rows() && cov.cols() == covariance_.cols() &&
+      cov == covariance_) {
+    return factor_success_;
+  }
+
+  covariance_ = cov;
+  factor_success_ = true;
+
+  try {
+    auto llt = cov.llt();
+    lower_cholesky_ = llt.matrixL();
+
+    if (llt.info() == Eigen::NumericalIssue) {
+      throw std::runtime_error(
+          "\nERROR: In RandomGenerator::factor_covariance method: Input "
+          "covariance matrix is not positive semi-definite\n");
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "\nERROR: In normal multivariate random number generation: "
+              << e.what() << std::endl;
+    factor_success_ = false;
+  }
+
+  return factor_success_;
+}
 }  // namespace numeric_utils
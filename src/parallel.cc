@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "parallel.h"
+#include "profiler.h"
+
+namespace utilities {
+
+unsigned int thread_count(unsigned int requested_threads) {
+  if (requested_threads == 0) {
+    requested_threads = std::thread::hardware_concurrency();
+  }
+
+  return std::max(requested_threads, 1u);
+}
+
+void parallel_for(unsigned int num_tasks, unsigned int num_threads,
+                  const std::function<void(unsigned int)>& task) {
+  num_threads = std::min(thread_count(num_threads), num_tasks);
+
+  // Run serially on calling thread when parallel execution is not needed
+  if (num_threads <= 1) {
+    for (unsigned int i = 0; i < num_tasks; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  std::atomic<unsigned int> next_task(0);
+  std::atomic<bool> failed(false);
+  std::exception_ptr exception = nullptr;
+  std::mutex exception_mutex;
+#ifdef SMELT_ENABLE_PROFILING
+  // Workers record into the profile of the calling thread
+  Profile* profile = Profile::active();
+#endif
+
+  auto worker = [&]() {
+    SMELT_PROFILE_ACTIVATE(*profile);
+    unsigned int index;
+    while (!failed && (index = next_task++) < num_tasks) {
+      try {
+        task(index);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(exception_mutex);
+        if (!exception) {
+          exception = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+
+  // Calling thread acts as one of the workers
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (unsigned int i = 0; i < num_threads - 1; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+}  // namespace utilities
@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include "json_object.h"
+#include "profiler.h"
+
+namespace {
+thread_local utilities::Profile* active_profile =
+    nullptr; /**< Profile active on each thread */
+}  // namespace
+
+bool utilities::profiling_enabled() {
+#ifdef SMELT_ENABLE_PROFILING
+  return true;
+#else
+  return false;
+#endif
+}
+
+utilities::Profile* utilities::Profile::active() { return active_profile; }
+
+void utilities::Profile::set_active(Profile* profile) {
+  active_profile = profile;
+}
+
+void utilities::Profile::count(const char* counter, std::uint64_t amount) {
+  if (active_profile) {
+    active_profile->add_count(counter, amount);
+  }
+}
+
+void utilities::Profile::add_time(const std::string& stage, double seconds) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& entry = stages_[stage];
+  entry.seconds += seconds;
+  ++entry.calls;
+}
+
+void utilities::Profile::add_count(const std::string& counter,
+                                   std::uint64_t amount) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  counters_[counter] += amount;
+}
+
+void utilities::Profile::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stages_.clear();
+  counters_.clear();
+}
+
+utilities::JsonObject utilities::Profile::json() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto stages = JsonObject();
+  for (const auto& stage : stages_) {
+    auto entry = JsonObject();
+    entry.add_value("seconds", stage.second.seconds);
+    entry.add_value("calls", stage.second.calls);
+    stages.add_value(stage.first, entry);
+  }
+
+  auto counters = JsonObject();
+  for (const auto& counter : counters_) {
+    counters.add_value(counter.first, counter.second);
+  }
+
+  auto profile = JsonObject();
+  profile.add_value("stages", stages);
+  profile.add_value("counters", counters);
+  return profile;
+}
@@ -0,0 +1,108 @@
+#define _USE_MATH_DEFINES
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "random_stream.h"
+
+namespace numeric_utils {
+
+std::uint64_t stream_seed(int seed_value) {
+  if (seed_value != std::numeric_limits<int>::infinity()) {
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(seed_value));
+  }
+
+  // Mix clock and call counter with splitmix64 finalizer so seeds differ
+  // between calls, then set upper bit so they can't match a provided seed
+  static std::atomic<std::uint64_t> num_calls(0);
+  std::uint64_t value =
+      static_cast<std::uint64_t>(
+          std::chrono::high_resolution_clock::now().time_since_epoch().count()) +
+      0x9E3779B97F4A7C15ULL * (num_calls.fetch_add(1) + 1);
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+  value = value ^ (value >> 31);
+
+  return value | (1ULL << 63);
+}
+
+RandomStream::RandomStream(std::uint64_t seed, std::uint32_t spectrum,
+                           std::uint32_t simulation, std::uint32_t component)
+    : key_{{static_cast<std::uint32_t>(seed),
+            static_cast<std::uint32_t>(seed >> 32)}},
+      counter_{{0, component, simulation, spectrum}},
+      block_{{0, 0, 0, 0}},
+      position_{4},
+      has_normal_{false},
+      cached_normal_{0.0} {}
+
+RandomStream::result_type RandomStream::operator()() {
+  if (position_ == 4) {
+    block_ = philox(counter_, key_);
+    counter_[0]++;
+    position_ = 0;
+  }
+  return block_[position_++];
+}
+
+double RandomStream::uniform() {
+  // Combine 27 and 26 bits into 53-bit value, offset by one half so
+  // result is never exactly 0 or 1
+  double upper = static_cast<double>((*this)() >> 5);
+  double lower = static_cast<double>((*this)() >> 6);
+  return (upper * 67108864.0 + lower + 0.5) / 9007199254740992.0;
+}
+
+double RandomStream::normal() {
+  if (has_normal_) {
+    has_normal_ = false;
+    return cached_normal_;
+  }
+
+  double radius = std::sqrt(-2.0 * std::log(uniform()));
+  double angle = 2.0 * M_PI * uniform();
+  cached_normal_ = radius * std::sin(angle);
+  has_normal_ = true;
+
+  return radius * std::cos(angle);
+}
+
+void RandomStream::discard(unsigned long long num_values) {
+  // Use remaining values in current block first
+  while (num_values > 0 && position_ < 4) {
+    position_++;
+    num_values--;
+  }
+
+  if (num_values > 0) {
+    counter_[0] += static_cast<std::uint32_t>((num_values - 1) / 4);
+    block_ = philox(counter_, key_);
+    counter_[0]++;
+    position_ = static_cast<unsigned int>((num_values - 1) % 4) + 1;
+  }
+}
+
+std::array<std::uint32_t, 4> RandomStream::philox(
+    std::array<std::uint32_t, 4> counter, std::array<std::uint32_t, 2> key) {
+  const std::uint64_t multiplier_0 = 0xD2511F53, multiplier_1 = 0xCD9E8D57;
+  const std::uint32_t weyl_0 = 0x9E3779B9, weyl_1 = 0xBB67AE85;
+
+  for (unsigned int round = 0; round < 10; ++round) {
+    if (round > 0) {
+      key[0] += weyl_0;
+      key[1] += weyl_1;
+    }
+
+    std::uint64_t product_0 = multiplier_0 * counter[0];
+    std::uint64_t product_1 = multiplier_1 * counter[2];
+
+    counter = {{static_cast<std::uint32_t>(product_1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<std::uint32_t>(product_1),
+                static_cast<std::uint32_t>(product_0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<std::uint32_t>(product_0)}};
+  }
+
+  return counter;
+}
+}  // namespace numeric_utils
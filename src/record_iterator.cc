@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "record_iterator.h"
+#include "time_history_block.h"
+
+stochastic::RecordIterator::RecordIterator(std::size_t num_records,
+                                           std::size_t batch_size,
+                                           BatchFunction generate_batch)
+    : num_records_{num_records},
+      batch_size_{batch_size},
+      position_{0},
+      generate_batch_{std::move(generate_batch)} {
+  if (batch_size_ == 0) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::RecordIterator::RecordIterator: Batch size "
+        "must be positive\n");
+  }
+}
+
+bool stochastic::RecordIterator::next(utilities::TimeHistoryBlock& records) {
+  return next_batch(records, nullptr);
+}
+
+bool stochastic::RecordIterator::next(utilities::TimeHistoryBlock& records,
+                                      std::vector<RecordMetadata>& metadata) {
+  return next_batch(records, &metadata);
+}
+
+utilities::TimeHistoryBlock stochastic::RecordIterator::generate(
+    std::size_t first_record, std::size_t num_records,
+    std::vector<RecordMetadata>* metadata) const {
+  if (first_record > num_records_ ||
+      num_records > num_records_ - first_record) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::RecordIterator::generate: Range of records "
+        "exceeds number of records\n");
+  }
+
+  return generate_batch_(first_record, num_records, metadata);
+}
+
+bool stochastic::RecordIterator::next_batch(
+    utilities::TimeHistoryBlock& records,
+    std::vector<RecordMetadata>* metadata) {
+  if (done()) {
+    return false;
+  }
+
+  std::size_t num_batch_records =
+      std::min(batch_size_, num_records_ - position_);
+  records = generate_batch_(position_, num_batch_records, metadata);
+  position_ += num_batch_records;
+
+  return true;
+}
+
+stochastic::RecordIterator stochastic::appended_records(
+    std::size_t num_groups, std::size_t num_sims, std::size_t num_appended,
+    std::size_t batch_size, RecordIterator::BatchFunction generate_range) {
+  std::size_t group_size = num_sims + num_appended;
+
+  return RecordIterator(
+      num_groups * num_appended, batch_size,
+      [num_sims, num_appended, group_size, generate_range](
+          std::size_t first_record, std::size_t num_records,
+          std::vector<RecordMetadata>* metadata)
+          -> utilities::TimeHistoryBlock {
+        // Appended simulations of each group are contiguous in the extended
+        // campaign, so batches are generated one group at a time
+        std::vector<utilities::TimeHistoryBlock> ranges;
+        std::vector<RecordMetadata> range_metadata;
+        if (metadata) {
+          metadata->clear();
+        }
+        std::size_t last_record = first_record + num_records;
+        for (std::size_t k = first_record; k < last_record;) {
+          std::size_t group = k / num_appended, sim = k % num_appended;
+          std::size_t range_size =
+              std::min(num_appended - sim, last_record - k);
+          ranges.push_back(generate_range(
+              group * group_size + num_sims + sim, range_size,
+              metadata ? &range_metadata : nullptr));
+          if (metadata) {
+            metadata->insert(metadata->end(), range_metadata.begin(),
+                             range_metadata.end());
+          }
+          k += range_size;
+        }
+
+        if (ranges.size() == 1) {
+          return std::move(ranges[0]);
+        }
+
+        // Pack records of all groups into one block
+        std::vector<std::size_t> num_steps;
+        for (const auto& range : ranges) {
+          for (std::size_t i = 0; i < range.num_records(); ++i) {
+            num_steps.push_back(range.num_steps(i));
+          }
+        }
+        utilities::TimeHistoryBlock records(
+            num_steps, ranges.empty() ? 0 : ranges[0].num_components(),
+            ranges.empty() ? 0.0 : ranges[0].time_step());
+        std::size_t record = 0;
+        for (const auto& range : ranges) {
+          for (std::size_t i = 0; i < range.num_records(); ++i, ++record) {
+            std::copy(range.data(i, 0),
+                      range.data(i, 0) +
+                          range.num_steps(i) * range.num_components(),
+                      records.data(record, 0));
+          }
+        }
+        return records;
+      });
+}
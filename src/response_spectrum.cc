@@ -0,0 +1,133 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include "parallel.h"
+#include "response_spectrum.h"
+
+numeric_utils::ResponseSpectrum::ResponseSpectrum(
+    const std::vector<double>& periods,
+    const std::vector<double>& damping_ratios, double time_step)
+    : periods_{periods},
+      damping_ratios_{damping_ratios},
+      time_step_{time_step} {
+  if (periods_.empty() || damping_ratios_.empty() || !(time_step_ > 0.0)) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::ResponseSpectrum::ResponseSpectrum: "
+        "Periods and damping ratios must be provided and time step must be "
+        "positive\n");
+  }
+
+  // Oscillators are ordered by damping ratio, then by period
+  unsigned int num_oscillators = periods_.size() * damping_ratios_.size();
+  omega_squared_.resize(num_oscillators);
+  a11_.resize(num_oscillators);
+  a12_.resize(num_oscillators);
+  a21_.resize(num_oscillators);
+  a22_.resize(num_oscillators);
+  b11_.resize(num_oscillators);
+  b12_.resize(num_oscillators);
+  b21_.resize(num_oscillators);
+  b22_.resize(num_oscillators);
+
+  double dt = time_step_;
+  for (unsigned int i = 0; i < damping_ratios_.size(); ++i) {
+    double zeta = damping_ratios_[i];
+    if (zeta < 0.0 || zeta >= 1.0) {
+      throw std::runtime_error(
+          "\nERROR: in numeric_utils::ResponseSpectrum::ResponseSpectrum: "
+          "Damping ratios must be in the range [0, 1)\n");
+    }
+
+    for (unsigned int j = 0; j < periods_.size(); ++j) {
+      if (!(periods_[j] > 0.0)) {
+        throw std::runtime_error(
+            "\nERROR: in numeric_utils::ResponseSpectrum::ResponseSpectrum: "
+            "Periods must be positive\n");
+      }
+
+      unsigned int k = i * periods_.size() + j;
+      double omega = 2.0 * M_PI / periods_[j];
+      double root = std::sqrt(1.0 - zeta * zeta);
+      double omega_damped = omega * root;
+      double decay = std::exp(-zeta * omega * dt);
+      double sine = std::sin(omega_damped * dt);
+      double cosine = std::cos(omega_damped * dt);
+      double ratio = zeta / root;
+
+      omega_squared_(k) = omega * omega;
+
+      // Free vibration terms
+      a11_(k) = decay * (ratio * sine + cosine);
+      a12_(k) = decay * sine / omega_damped;
+      a21_(k) = -omega / root * decay * sine;
+      a22_(k) = decay * (cosine - ratio * sine);
+
+      // Forced vibration terms for ground acceleration varying linearly over
+      // the time step
+      double term_1 = (2.0 * zeta * zeta - 1.0) / (omega * omega * dt);
+      double term_2 = 2.0 * zeta / (omega * omega * omega * dt);
+      double inv_omega_squared = 1.0 / (omega * omega);
+      b11_(k) = decay * ((term_1 + zeta / omega) * sine / omega_damped +
+                         (term_2 + inv_omega_squared) * cosine) -
+                term_2;
+      b12_(k) = -decay * (term_1 * sine / omega_damped + term_2 * cosine) -
+                inv_omega_squared + term_2;
+      b21_(k) = decay * ((term_1 + zeta / omega) * (cosine - ratio * sine) -
+                         (term_2 + inv_omega_squared) *
+                             (omega_damped * sine + zeta * omega * cosine)) +
+                inv_omega_squared / dt;
+      b22_(k) =
+          -decay * (term_1 * (cosine - ratio * sine) -
+                    term_2 * (omega_damped * sine + zeta * omega * cosine)) -
+          inv_omega_squared / dt;
+    }
+  }
+}
+
+Eigen::MatrixXd numeric_utils::ResponseSpectrum::compute(
+    const double* acceleration, std::size_t num_steps) const {
+  unsigned int num_oscillators = omega_squared_.size();
+  Eigen::ArrayXd displacement = Eigen::ArrayXd::Zero(num_oscillators);
+  Eigen::ArrayXd velocity = Eigen::ArrayXd::Zero(num_oscillators);
+  Eigen::ArrayXd next_displacement(num_oscillators);
+  Eigen::ArrayXd max_displacement = Eigen::ArrayXd::Zero(num_oscillators);
+
+  // Oscillators start at rest and are advanced together at each time step
+  for (std::size_t i = 0; i + 1 < num_steps; ++i) {
+    double start_accel = acceleration[i], end_accel = acceleration[i + 1];
+    next_displacement = a11_ * displacement + a12_ * velocity +
+                        b11_ * start_accel + b12_ * end_accel;
+    velocity = a21_ * displacement + a22_ * velocity + b21_ * start_accel +
+               b22_ * end_accel;
+    displacement.swap(next_displacement);
+    max_displacement = max_displacement.max(displacement.abs());
+  }
+
+  // Pseudo-spectral acceleration, with rows for damping ratios
+  Eigen::ArrayXd pseudo_accel = omega_squared_ * max_displacement;
+  return Eigen::Map<const Eigen::MatrixXd>(pseudo_accel.data(),
+                                           periods_.size(),
+                                           damping_ratios_.size())
+      .transpose();
+}
+
+Eigen::MatrixXd numeric_utils::ResponseSpectrum::compute(
+    const std::vector<double>& acceleration) const {
+  return compute(acceleration.data(), acceleration.size());
+}
+
+std::vector<Eigen::MatrixXd> numeric_utils::ResponseSpectrum::compute(
+    const std::vector<std::vector<double>>& accelerations,
+    unsigned int num_threads) const {
+  std::vector<Eigen::MatrixXd> spectra(accelerations.size());
+
+  utilities::parallel_for(accelerations.size(), num_threads,
+                          [&](unsigned int i) {
+                            spectra[i] = compute(accelerations[i]);
+                          });
+
+  return spectra;
+}
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "json_event_writer.h"
+#include "json_object.h"
+#include "parallel.h"
+#include "record_iterator.h"
+#include "scenario_batch.h"
+#include "stochastic_model.h"
+#include "time_history_block.h"
+
+stochastic::ScenarioBatch::ScenarioBatch(unsigned int num_threads)
+    : num_threads_{num_threads}, shard_{0}, num_shards_{1} {}
+
+void stochastic::ScenarioBatch::add_scenario(
+    const std::string& event_name, std::shared_ptr<StochasticModel> model) {
+  if (!model) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::ScenarioBatch::add_scenario: Model of "
+        "scenario must not be null\n");
+  }
+
+  if (std::find(models_.begin(), models_.end(), model) != models_.end()) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::ScenarioBatch::add_scenario: Each scenario "
+        "requires a separate model\n");
+  }
+
+  event_names_.push_back(event_name);
+  models_.push_back(std::move(model));
+}
+
+std::size_t stochastic::ScenarioBatch::num_records() const {
+  std::size_t num_records = 0;
+  for (const auto& model : models_) {
+    num_records += model->num_records();
+  }
+  return num_records;
+}
+
+void stochastic::ScenarioBatch::set_shard(std::size_t shard,
+                                          std::size_t num_shards) {
+  if (shard >= num_shards) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::ScenarioBatch::set_shard: Shard index must be "
+        "less than the number of shards\n");
+  }
+
+  shard_ = shard;
+  num_shards_ = num_shards;
+}
+
+std::pair<std::size_t, std::size_t> stochastic::ScenarioBatch::shard_range(
+    std::size_t shard) const {
+  if (shard >= num_shards_) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::ScenarioBatch::shard_range: Shard index must "
+        "be less than the number of shards\n");
+  }
+
+  std::size_t total_records = num_records();
+  std::size_t first_record = shard * total_records / num_shards_;
+  std::size_t last_record = (shard + 1) * total_records / num_shards_;
+
+  return std::make_pair(first_record, last_record - first_record);
+}
+
+utilities::JsonObject stochastic::ScenarioBatch::shard_index(
+    const std::vector<std::string>& shard_locations) const {
+  if (shard_locations.size() != num_shards_) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::ScenarioBatch::shard_index: Number of "
+        "locations must match the number of shards\n");
+  }
+
+  std::vector<utilities::JsonObject> shards(num_shards_);
+  for (std::size_t i = 0; i < num_shards_; ++i) {
+    auto range = shard_range(i);
+    shards[i].add_value("location", shard_locations[i]);
+    shards[i].add_value("firstRecord", range.first);
+    shards[i].add_value("numRecords", range.second);
+  }
+
+  std::vector<utilities::JsonObject> scenarios(models_.size());
+  std::size_t first_record = 0;
+  for (std::size_t i = 0; i < models_.size(); ++i) {
+    scenarios[i].add_value("name", event_names_[i]);
+    scenarios[i].add_value("firstRecord", first_record);
+    scenarios[i].add_value("numRecords", models_[i]->num_records());
+    first_record += models_[i]->num_records();
+  }
+
+  utilities::JsonObject index;
+  index.add_value("numRecords", first_record);
+  index.add_value("shards", shards);
+  index.add_value("scenarios", scenarios);
+
+  return index;
+}
+
+void stochastic::ScenarioBatch::generate(const Sink& sink, bool units) {
+  generate_windows(units, std::function<void(Task&)>(), [&sink](Task& task) {
+    sink(task.scenario, task.first_record, task.records, task.metadata);
+  });
+}
+
+bool stochastic::ScenarioBatch::generate(const std::string& output_location,
+                                         bool units) {
+  bool status = true;
+
+  try {
+    utilities::JsonEventWriter writer(output_location, json_format_);
+
+    // Events are created by the task that generated the records, which then
+    // releases its records
+    generate_windows(
+        units,
+        [this](Task& task) {
+          task.events = models_[task.scenario]->events_json(
+              event_names_[task.scenario], task.records, task.first_record);
+          task.records = utilities::TimeHistoryBlock();
+        },
+        [&writer](Task& task) {
+          for (auto& event : task.events) {
+            writer.write_event(event);
+          }
+        });
+    status = writer.close();
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    status = false;
+    throw;
+  }
+
+  return status;
+}
+
+void stochastic::ScenarioBatch::generate_windows(
+    bool units, const std::function<void(Task&)>& prepare,
+    const std::function<void(Task&)>& consume) {
+  // Find the scenarios with records in the shard along with the range of
+  // their records in the shard, so scenarios outside the shard are not set up
+  auto range = shard_range(shard_);
+  std::size_t shard_end = range.first + range.second;
+  std::vector<std::size_t> scenarios;
+  std::vector<std::size_t> first_records;
+  std::vector<std::size_t> last_records;
+  std::size_t scenario_start = 0;
+  for (std::size_t i = 0; i < models_.size(); ++i) {
+    std::size_t scenario_end = scenario_start + models_[i]->num_records();
+    std::size_t first = std::max(scenario_start, range.first);
+    std::size_t last = std::min(scenario_end, shard_end);
+    if (first < last) {
+      scenarios.push_back(i);
+      first_records.push_back(first - scenario_start);
+      last_records.push_back(last - scenario_start);
+    }
+    scenario_start = scenario_end;
+  }
+
+  std::size_t window_size = utilities::thread_count(num_threads_);
+
+  for (std::size_t window_start = 0; window_start < scenarios.size();
+       window_start += window_size) {
+    std::size_t window_end =
+        std::min(window_start + window_size, scenarios.size());
+    std::size_t num_window_scenarios = window_end - window_start;
+
+    // Tasks of all scenarios share the threads of the batch, so each model
+    // uses a single thread while the window is generated
+    std::vector<unsigned int> model_threads(num_window_scenarios);
+    for (std::size_t i = 0; i < num_window_scenarios; ++i) {
+      auto& model = models_[scenarios[window_start + i]];
+      model_threads[i] = model->num_threads();
+      model->set_num_threads(1);
+    }
+    auto restore_threads = [&]() {
+      for (std::size_t i = 0; i < num_window_scenarios; ++i) {
+        models_[scenarios[window_start + i]]->set_num_threads(
+            model_threads[i]);
+      }
+    };
+
+    try {
+      // Set up each scenario of the window as one task
+      std::vector<std::unique_ptr<RecordIterator>> iterators(
+          num_window_scenarios);
+      utilities::parallel_for(
+          num_window_scenarios, num_threads_, [&](unsigned int i) {
+            std::size_t scenario = scenarios[window_start + i];
+            iterators[i].reset(new RecordIterator(
+                models_[scenario]->records(event_names_[scenario], units)));
+          });
+
+      // Every batch of every scenario of the window is a separate task.
+      // Batches start at multiples of the batch size of the scenario, so
+      // shards split batches only at their boundaries.
+      std::vector<Task> tasks;
+      std::vector<std::size_t> task_iterators;
+      for (std::size_t i = 0; i < num_window_scenarios; ++i) {
+        std::size_t batch_size = iterators[i]->batch_size();
+        std::size_t last = last_records[window_start + i];
+        for (std::size_t first = first_records[window_start + i]; first < last;
+             first = (first / batch_size + 1) * batch_size) {
+          Task task;
+          task.scenario = scenarios[window_start + i];
+          task.first_record = first;
+          task.num_records =
+              std::min((first / batch_size + 1) * batch_size, last) - first;
+          tasks.push_back(std::move(task));
+          task_iterators.push_back(i);
+        }
+      }
+
+      utilities::parallel_for(tasks.size(), num_threads_, [&](unsigned int k) {
+        Task& task = tasks[k];
+        task.records = iterators[task_iterators[k]]->generate(
+            task.first_record, task.num_records, &task.metadata);
+        if (prepare) {
+          prepare(task);
+        }
+      });
+
+      // Results are consumed in order, releasing each task once consumed
+      for (auto& task : tasks) {
+        consume(task);
+        task = Task();
+      }
+    } catch (const std::exception&) {
+      restore_threads();
+      throw;
+    }
+
+    restore_threads();
+  }
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "profiler.h"
+#include "scratch_arena.h"
+
+const std::size_t utilities::ScratchArena::alignment;
+
+utilities::ScratchArena::ScratchArena(std::size_t block_size)
+    : block_size_{std::max(block_size, alignment)}, current_{0}, offset_{0} {}
+
+utilities::ScratchArena& utilities::ScratchArena::local() {
+  static thread_local ScratchArena arena;
+  return arena;
+}
+
+void utilities::ScratchArena::rewind(const Marker& marker) {
+  current_ = marker.block;
+  offset_ = marker.offset;
+
+  // Merge blocks once nothing is allocated so later records fit in one block
+  if (current_ == 0 && offset_ == 0 && blocks_.size() > 1) {
+    std::size_t total_size = capacity();
+    blocks_.clear();
+    blocks_.push_back(
+        Block{std::unique_ptr<char[]>(new char[total_size + alignment]),
+              total_size});
+  }
+}
+
+std::size_t utilities::ScratchArena::capacity() const {
+  std::size_t total_size = 0;
+  for (const auto& block : blocks_) {
+    total_size += block.size;
+  }
+  return total_size;
+}
+
+void* utilities::ScratchArena::allocate_bytes(std::size_t num_bytes) {
+  // Round up so following allocation stays aligned
+  num_bytes = (num_bytes + alignment - 1) / alignment * alignment;
+
+  // Move to next block that is large enough, adding one if needed
+  while (current_ < blocks_.size() &&
+         offset_ + num_bytes > blocks_[current_].size) {
+    ++current_;
+    offset_ = 0;
+  }
+  if (current_ == blocks_.size()) {
+    std::size_t size = blocks_.empty() ? block_size_ : 2 * blocks_.back().size;
+    size = std::max(size, num_bytes);
+    blocks_.push_back(
+        Block{std::unique_ptr<char[]>(new char[size + alignment]), size});
+    offset_ = 0;
+    SMELT_PROFILE_COUNT("scratchBytesAllocated", size + alignment);
+  }
+
+  // Align start of block storage
+  char* data = blocks_[current_].data.get();
+  std::uintptr_t address = reinterpret_cast<std::uintptr_t>(data);
+  std::size_t padding = (alignment - address % alignment) % alignment;
+
+  void* allocation = data + padding + offset_;
+  offset_ += num_bytes;
+  return allocation;
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseCore>
+#include "spatial_correlation.h"
+
+numeric_utils::SpatialCorrelation::SpatialCorrelation(
+    const std::vector<double>& x_coordinates,
+    const std::vector<double>& y_coordinates, double correlation_length,
+    double taper_length)
+    : x_coordinates_{x_coordinates},
+      y_coordinates_{y_coordinates},
+      correlation_length_{correlation_length},
+      taper_length_{taper_length} {
+  if (x_coordinates_.size() != y_coordinates_.size()) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::SpatialCorrelation::SpatialCorrelation: "
+        "Number of x- and y-coordinates must match\n");
+  }
+  if (correlation_length_ <= 0.0 || taper_length_ <= 0.0) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::SpatialCorrelation::SpatialCorrelation: "
+        "Correlation and taper lengths must be positive\n");
+  }
+
+  // Sites are visited in order of their x-coordinates, so each site is only
+  // compared with the following sites within the taper length along x.
+  // Only the lower triangle is assembled.
+  int num_sites = static_cast<int>(x_coordinates_.size());
+  std::vector<int> order(num_sites);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [this](int first, int second) {
+    return x_coordinates_[first] < x_coordinates_[second];
+  });
+
+  std::vector<Eigen::Triplet<double>> entries;
+  for (int k = 0; k < num_sites; ++k) {
+    int i = order[k];
+    entries.emplace_back(i, i, 1.0);
+    for (int l = k + 1; l < num_sites; ++l) {
+      int j = order[l];
+      if (x_coordinates_[j] - x_coordinates_[i] >= taper_length_) {
+        break;
+      }
+      double value = correlation(i, j);
+      if (value > 0.0) {
+        entries.emplace_back(std::max(i, j), std::min(i, j), value);
+      }
+    }
+  }
+  Eigen::SparseMatrix<double> correlation_matrix(num_sites, num_sites);
+  correlation_matrix.setFromTriplets(entries.begin(), entries.end());
+
+  // Factorization of the permuted matrix P A P^-1 = L L^T keeps fill-in low
+  Eigen::SimplicialLLT<Eigen::SparseMatrix<double>, Eigen::Lower> cholesky(
+      correlation_matrix);
+  if (cholesky.info() != Eigen::Success) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::SpatialCorrelation::SpatialCorrelation: "
+        "Correlation matrix is not positive definite\n");
+  }
+  factor_ = Eigen::SparseMatrix<double>(cholesky.matrixL());
+
+  // Variables of site i are row P(i) of L times the white noise
+  const auto& permutation = cholesky.permutationP().indices();
+  factor_rows_.assign(permutation.data(), permutation.data() + num_sites);
+}
+
+double numeric_utils::SpatialCorrelation::correlation(
+    std::size_t first_site, std::size_t second_site) const {
+  double distance =
+      std::hypot(x_coordinates_[first_site] - x_coordinates_[second_site],
+                 y_coordinates_[first_site] - y_coordinates_[second_site]);
+  double ratio = distance / taper_length_;
+  if (ratio >= 1.0) {
+    return 0.0;
+  }
+
+  return std::exp(-distance / correlation_length_) *
+         std::pow(1.0 - ratio, 4) * (4.0 * ratio + 1.0);
+}
+
+Eigen::MatrixXd numeric_utils::SpatialCorrelation::correlate(
+    const Eigen::MatrixXd& white_noise) const {
+  if (static_cast<std::size_t>(white_noise.rows()) != num_sites()) {
+    throw std::runtime_error(
+        "\nERROR: in numeric_utils::SpatialCorrelation::correlate: White "
+        "noise must have one row per site\n");
+  }
+
+  Eigen::MatrixXd factor_product = factor_ * white_noise;
+  Eigen::MatrixXd correlated(white_noise.rows(), white_noise.cols());
+  for (std::size_t i = 0; i < num_sites(); ++i) {
+    correlated.row(i) = factor_product.row(factor_rows_[i]);
+  }
+  return correlated;
+}
+
+void numeric_utils::SpatialCorrelation::site_weights(
+    std::size_t site, std::vector<std::size_t>& rows,
+    std::vector<double>& weights) const {
+  rows.clear();
+  weights.clear();
+  for (Eigen::SparseMatrix<double, Eigen::RowMajor>::InnerIterator entry(
+           factor_, factor_rows_[site]);
+       entry; ++entry) {
+    rows.push_back(entry.col());
+    weights.push_back(entry.value());
+  }
+}
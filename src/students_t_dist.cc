@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <vector>
 #include <boost/math/distributions/students_t.hpp>
 #include "students_t_dist.h"
@@ -15,22 +16,31 @@ stochastic::StudentstDistribution::StudentstDistribution(double mean,
 std::vector<double> stochastic::StudentstDistribution::cumulative_dist_func(
     const std::vector<double>& locations) const {
   std::vector<double> evaluations(locations.size());
+  cumulative_dist_func(locations.data(), evaluations.data(), locations.size());
+  return evaluations;
+}
 
-  for (unsigned int i = 0; i < locations.size(); ++i) {
+void stochastic::StudentstDistribution::cumulative_dist_func(
+    const double* locations, double* evaluations,
+    std::size_t num_values) const {
+  for (std::size_t i = 0; i < num_values; ++i) {
     evaluations[i] = cdf(distribution_, (locations[i] - mean_) / std_dev_);
   }
-
-  return evaluations;
 }
 
 std::vector<double> stochastic::StudentstDistribution::inv_cumulative_dist_func(
     const std::vector<double>& probabilities) const {
   std::vector<double> evaluations(probabilities.size());
+  inv_cumulative_dist_func(probabilities.data(), evaluations.data(),
+                           probabilities.size());
+  return evaluations;
+}
 
-  for (unsigned int i = 0; i < probabilities.size(); ++i) {
+void stochastic::StudentstDistribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations,
+    std::size_t num_values) const {
+  for (std::size_t i = 0; i < num_values; ++i) {
     evaluations[i] =
         std_dev_ * quantile(distribution_, probabilities[i]) + mean_;
   }
-
-  return evaluations;
 }
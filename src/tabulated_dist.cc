@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <mkl_vml.h>
+#include "beta_dist.h"
+#include "inv_gauss_dist.h"
+#include "students_t_dist.h"
+#include "tabulated_dist.h"
+
+stochastic::TabulatedDistribution::TabulatedDistribution(
+    std::shared_ptr<Distribution> distribution, double max_error)
+    : Distribution(),
+      distribution_{distribution},
+      max_error_{max_error},
+      std_normal_min_{-6.0},
+      std_normal_max_{6.0} {
+  if (!(max_error_ > 0.0)) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::TabulatedDistribution::TabulatedDistribution: "
+        "Maximum error must be positive\n");
+  }
+
+  // Start with coarse table and double number of intervals until error at
+  // interval midpoints is acceptable. Exact midpoint values become table
+  // points of next refinement.
+  std::size_t num_intervals = 64;
+  const std::size_t max_intervals = 65536;
+  std::vector<double> points(num_intervals + 1);
+  step_ = (std_normal_max_ - std_normal_min_) / num_intervals;
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    points[i] = std_normal_min_ + i * step_;
+  }
+  values_.resize(points.size());
+  distribution_->transform_from_std_normal(points.data(), values_.data(),
+                                           points.size());
+
+  std::vector<double> midpoints, midpoint_values;
+  while (true) {
+    calculate_slopes();
+
+    midpoints.resize(num_intervals);
+    midpoint_values.resize(num_intervals);
+    for (std::size_t i = 0; i < num_intervals; ++i) {
+      midpoints[i] = std_normal_min_ + (i + 0.5) * step_;
+    }
+    distribution_->transform_from_std_normal(
+        midpoints.data(), midpoint_values.data(), num_intervals);
+
+    bool converged = true;
+    for (std::size_t i = 0; i < num_intervals && converged; ++i) {
+      converged = std::abs(interpolate(midpoints[i]) - midpoint_values[i]) <=
+                  max_error_ * std::max(1.0, std::abs(midpoint_values[i]));
+    }
+
+    if (converged) {
+      break;
+    }
+
+    if (num_intervals >= max_intervals) {
+      throw std::runtime_error(
+          "\nERROR: in stochastic::TabulatedDistribution::TabulatedDistribution: "
+          "Maximum error could not be reached with maximum table size\n");
+    }
+
+    // Interleave midpoints with current table points
+    std::vector<double> refined_values(2 * num_intervals + 1);
+    for (std::size_t i = 0; i < num_intervals; ++i) {
+      refined_values[2 * i] = values_[i];
+      refined_values[2 * i + 1] = midpoint_values[i];
+    }
+    refined_values.back() = values_.back();
+    values_ = std::move(refined_values);
+    num_intervals *= 2;
+    step_ = 0.5 * step_;
+  }
+}
+
+std::vector<double> stochastic::TabulatedDistribution::cumulative_dist_func(
+    const std::vector<double>& locations) const {
+  return distribution_->cumulative_dist_func(locations);
+}
+
+std::vector<double> stochastic::TabulatedDistribution::inv_cumulative_dist_func(
+    const std::vector<double>& probabilities) const {
+  std::vector<double> evaluations(probabilities.size());
+  inv_cumulative_dist_func(probabilities.data(), evaluations.data(),
+                           probabilities.size());
+  return evaluations;
+}
+
+void stochastic::TabulatedDistribution::cumulative_dist_func(
+    const double* locations, double* evaluations,
+    std::size_t num_values) const {
+  distribution_->cumulative_dist_func(locations, evaluations, num_values);
+}
+
+void stochastic::TabulatedDistribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations,
+    std::size_t num_values) const {
+  vdCdfNormInv(static_cast<MKL_INT>(num_values), probabilities, evaluations);
+  transform_from_std_normal(evaluations, evaluations, num_values);
+}
+
+void stochastic::TabulatedDistribution::transform_from_std_normal(
+    const double* std_normal_values, double* evaluations,
+    std::size_t num_values) const {
+  for (std::size_t i = 0; i < num_values; ++i) {
+    evaluations[i] = interpolate(std_normal_values[i]);
+  }
+}
+
+double stochastic::TabulatedDistribution::interpolate(
+    double std_normal_value) const {
+  // Evaluate exactly outside of table range
+  if (!(std_normal_value >= std_normal_min_ &&
+        std_normal_value <= std_normal_max_)) {
+    double value;
+    distribution_->transform_from_std_normal(&std_normal_value, &value, 1);
+    return value;
+  }
+
+  double position = (std_normal_value - std_normal_min_) / step_;
+  std::size_t index = std::min(static_cast<std::size_t>(position),
+                               values_.size() - 2);
+  double s = position - index;
+
+  // Cubic Hermite basis functions
+  double h00 = (1.0 + 2.0 * s) * (1.0 - s) * (1.0 - s);
+  double h10 = s * (1.0 - s) * (1.0 - s);
+  double h01 = s * s * (3.0 - 2.0 * s);
+  double h11 = s * s * (s - 1.0);
+
+  return h00 * values_[index] + h10 * step_ * slopes_[index] +
+         h01 * values_[index + 1] + h11 * step_ * slopes_[index + 1];
+}
+
+void stochastic::TabulatedDistribution::calculate_slopes() {
+  std::size_t num_intervals = values_.size() - 1;
+  std::vector<double> secants(num_intervals);
+  for (std::size_t i = 0; i < num_intervals; ++i) {
+    secants[i] = (values_[i + 1] - values_[i]) / step_;
+  }
+
+  // Harmonic mean of adjacent secants keeps interpolant monotone for uniform
+  // spacing, with zero slope at local extrema
+  slopes_.resize(values_.size());
+  slopes_.front() = secants.front();
+  slopes_.back() = secants.back();
+  for (std::size_t i = 1; i < num_intervals; ++i) {
+    slopes_[i] = secants[i - 1] * secants[i] > 0.0
+                     ? 2.0 * secants[i - 1] * secants[i] /
+                           (secants[i - 1] + secants[i])
+                     : 0.0;
+  }
+}
+
+stochastic::TabulatedBetaDistribution::TabulatedBetaDistribution(
+    double alpha, double beta, double max_error)
+    : TabulatedDistribution(
+          std::make_shared<BetaDistribution>(alpha, beta), max_error) {}
+
+stochastic::TabulatedInverseGaussianDistribution::
+    TabulatedInverseGaussianDistribution(double mean, double std_dev,
+                                         double max_error)
+    : TabulatedDistribution(
+          std::make_shared<InverseGaussianDistribution>(mean, std_dev),
+          max_error) {}
+
+stochastic::TabulatedStudentstDistribution::TabulatedStudentstDistribution(
+    double mean, double std_dev, double dof, double max_error)
+    : TabulatedDistribution(
+          std::make_shared<StudentstDistribution>(mean, std_dev, dof),
+          max_error) {}
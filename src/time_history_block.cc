@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "profiler.h"
+#include "time_history_block.h"
+
+utilities::TimeHistoryBlock::TimeHistoryBlock()
+    : num_components_{0}, time_step_{0.0} {}
+
+utilities::TimeHistoryBlock::TimeHistoryBlock(std::size_t num_records,
+                                              std::size_t num_components,
+                                              std::size_t num_steps,
+                                              double time_step)
+    : TimeHistoryBlock(std::vector<std::size_t>(num_records, num_steps),
+                       num_components, time_step) {}
+
+utilities::TimeHistoryBlock::TimeHistoryBlock(
+    const std::vector<std::size_t>& num_steps, std::size_t num_components,
+    double time_step)
+    : num_components_{num_components},
+      time_step_{time_step},
+      num_steps_{num_steps},
+      offsets_(num_steps.size()) {
+  std::size_t offset = 0;
+  for (std::size_t i = 0; i < num_steps_.size(); ++i) {
+    offsets_[i] = offset;
+    offset += num_components_ * num_steps_[i];
+  }
+  values_.assign(offset, 0.0);
+  SMELT_PROFILE_COUNT("recordBytesAllocated", offset * sizeof(double));
+}
+
+std::vector<double> utilities::TimeHistoryBlock::component(
+    std::size_t record, std::size_t component) const {
+  const double* values = data(record, component);
+  return std::vector<double>(values, values + num_steps_[record]);
+}
+
+utilities::TimeHistoryBlock utilities::TimeHistoryBlock::window(
+    std::size_t first_step, std::size_t num_steps) const {
+  std::vector<std::size_t> window_steps(num_steps_.size());
+  for (std::size_t i = 0; i < num_steps_.size(); ++i) {
+    window_steps[i] =
+        first_step < num_steps_[i]
+            ? std::min(num_steps, num_steps_[i] - first_step)
+            : 0;
+  }
+
+  TimeHistoryBlock block(window_steps, num_components_, time_step_);
+  for (std::size_t i = 0; i < num_steps_.size(); ++i) {
+    for (std::size_t j = 0; j < num_components_; ++j) {
+      std::copy_n(data(i, j) + std::min(first_step, num_steps_[i]),
+                  window_steps[i], block.data(i, j));
+    }
+  }
+  return block;
+}
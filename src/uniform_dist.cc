@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <vector>
 #include <boost/math/distributions/uniform.hpp>
 #include "uniform_dist.h"
@@ -12,21 +13,30 @@ stochastic::UniformDistribution::UniformDistribution(double lower, double upper)
 std::vector<double> stochastic::UniformDistribution::cumulative_dist_func(
     const std::vector<double>& locations) const {
   std::vector<double> evaluations(locations.size());
+  cumulative_dist_func(locations.data(), evaluations.data(), locations.size());
+  return evaluations;
+}
 
-  for (unsigned int i = 0; i < locations.size(); ++i) {
+void stochastic::UniformDistribution::cumulative_dist_func(
+    const double* locations, double* evaluations,
+    std::size_t num_values) const {
+  for (std::size_t i = 0; i < num_values; ++i) {
     evaluations[i] = cdf(distribution_, locations[i]);
   }
-
-  return evaluations;
 }
 
 std::vector<double> stochastic::UniformDistribution::inv_cumulative_dist_func(
     const std::vector<double>& probabilities) const {
   std::vector<double> evaluations(probabilities.size());
+  inv_cumulative_dist_func(probabilities.data(), evaluations.data(),
+                           probabilities.size());
+  return evaluations;
+}
 
-  for (unsigned int i = 0; i < probabilities.size(); ++i) {
+void stochastic::UniformDistribution::inv_cumulative_dist_func(
+    const double* probabilities, double* evaluations,
+    std::size_t num_values) const {
+  for (std::size_t i = 0; i < num_values; ++i) {
     evaluations[i] = quantile(distribution_, probabilities[i]);
   }
-
-  return evaluations;
 }
@@ -1,28 +1,216 @@
 #define _USE_MATH_DEFINES
 #include <algorithm>
 #include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 // Boost random generator
 #include <boost/random/mersenne_twister.hpp>
-#include <boost/random/uniform_real_distribution.hpp>
-#include <boost/random/variate_generator.hpp>
+#include <boost/random/normal_distribution.hpp>
 // Eigen dense matrices
 #include <Eigen/Dense>
 
+#include "binary_file_writer.h"
+#include "configure.h"
 #include "factory.h"
+#include "filter_bank.h"
 #include "function_dispatcher.h"
+#include "json_event_writer.h"
 #include "json_object.h"
 #include "lognormal_dist.h"
 #include "normal_dist.h"
 #include "normal_multivar.h"
 #include "numeric_utils.h"
+#include "parallel.h"
+#include "profiler.h"
+#include "random_stream.h"
+#include "record_iterator.h"
+#include "scratch_arena.h"
+#include "time_history_block.h"
 #include "vlachos_et_al.h"
 
+namespace {
+/**
+ * Regression coefficients and covariance of the normal model parameters.
+ * These do not depend on the scenario, so they are built once and shared by
+ * all instances of the model.
+ */
+struct RegressionModel {
+  Eigen::MatrixXd beta; /**< Regression coefficients of parameter means */
+  Eigen::MatrixXd covariance; /**< Covariance of normal model parameters */
+};
+
+/**
+ * Get the regression model shared by all instances, building it the first
+ * time it is requested
+ * @return Shared regression model
+ */
+const RegressionModel& regression_model() {
+  static const RegressionModel shared_model = []() {
+    RegressionModel model;
+
+    // Restricted Maximum Likelihood method regression coefficients and variance
+    // components of the normal model parameters (Table 3 on page 13)
+    model.beta.resize(18, 7);
+    // clang-format off
+    model.beta <<
+      -1.1417, 1.0917, 1.9125, -0.9696, 0.0971, 0.3476, -0.6740,
+      1.8052,-1.8381, -3.5874, 3.7895, 0.3236, 0.5497, 0.2876,
+      1.8969,-1.8819, -2.0818, 1.9000, -0.3520, -0.6959, -0.0025,
+      1.6627,-1.6922, -1.2509, 1.1880, -0.5170, -1.0157, -0.1041,
+      3.8703,-3.4745, -0.0816, 0.0166, 0.4904, 0.8697, 0.3179,
+      1.1043,-1.1852, -1.0068, 0.9388, -0.5603, -0.8855, -0.3174,
+      1.1935,-1.2922, -0.7028, 0.6975, -0.6629, -1.1075, -0.4542,
+      1.7895,-1.5014, -0.0300, -0.1306, 0.4526, 0.7132, 0.1522,
+      -3.6404, 3.3189, -0.5316, 0.3874, -0.3757, -0.8334, 0.1006,
+      -2.2742, 2.1454, 0.6315, -0.6620, 0.1093, -0.1028, -0.0479,
+      0.6930, -0.6202, 1.8037, -1.6064, 0.0727, -0.1498, -0.0722,
+      1.3003, -1.2004, -1.2210, 1.0623, -0.0252, 0.1885, 0.0069,
+      0.4604, -0.4087, -0.5057, 0.4486, 0.1073, -0.0219, -0.1352,
+      2.2304, -2.0398, -0.1364, 0.1910, 0.2425, 0.1801, 0.3233,
+      2.3806, -2.2011, -0.3256, 0.2226, -0.0221, 0.0970, 0.0762,
+      0.2057, -0.1714, 0.3385, -0.2229, 0.0802, 0.2649, 0.0396,
+      -7.6011, 6.8507, -2.3609, 0.9201, -0.7508, -0.7903, -0.6204,
+      -6.3472, 5.8241, 3.2994, -2.8774, -0.1411, -0.5298, -0.0203;
+    // clang-format on
+
+    // Variance of model parameters (Table 3 on page 13)
+    Eigen::VectorXd variance(18);
+    // clang-format off
+    variance <<
+        0.90, 0.80, 0.78, 0.74, 0.66, 0.73, 0.72, 0.70, 0.69,
+        0.78, 0.90, 0.90, 0.90, 0.90, 0.80, 0.90, 0.35, 0.80;
+    // clang-format on
+  
+    // Estimated correlation matrix (Table A1 on page 24)
+    Eigen::MatrixXd correlation_matrix(18, 18);
+    // clang-format off
+    correlation_matrix <<
+      1.0000, 0.0382, -0.0912, -0.0701, -0.0214, -0.0849, -0.0545, -0.0185, 0.0270, -0.0122, 0.0059, -0.0344, -0.0342, 0.0409, -0.0137, -0.0168, -0.0990, -0.6701,
+      0.0382, 1.0000, -0.1159, -0.1856, 0.0681, -0.2018, -0.2765, -0.0304, -0.1719, -0.1157, -0.0347, -0.0277, -0.0189, 0.0357, 0.0657, -0.0070, 0.3690, -0.0510,
+      -0.0912, -0.1159, 1.0000, 0.9467, 0.4123, 0.4815, 0.4240, 0.2120, 0.1070, -0.1898, 0.0506, -0.0661, -0.0380, 0.0260, 0.0506, -0.0317, -0.0278, 0.0245,
+      -0.0701, -0.1856, 0.9467, 1.0000, 0.4075, 0.4891, 0.4940, 0.2285, 0.2009, -0.1709, 0.0365, -0.0579, -0.0999, 0.0467, 0.0410, 0.0027, -0.0966, 0.0631,
+      -0.0214, 0.0681, 0.4123, 0.4075, 1.0000, 0.1772, 0.1337, 0.7315, -0.0066, -0.2787, 0.0703, -0.0541, -0.0453, 0.1597, 0.0792, 0.0220, 0.0606, -0.0844,
+      -0.0849, -0.2018, 0.4815, 0.4891, 0.1772, 1.0000, 0.9448, 0.3749, 0.1682, -0.0831, 0.0124, -0.1236, -0.0346, -0.0054, 0.0877, -0.0197, -0.0867, 0.0281,
+      -0.0545, -0.2765, 0.4240, 0.4940, 0.1337, 0.9448, 1.0000, 0.3530, 0.2305, -0.0546, -0.0223, -0.0782, -0.0872, 0.0074, 0.0999, 0.0066, -0.1358, 0.0626,
+      -0.0185, -0.0304, 0.2120, 0.2285, 0.7315, 0.3749, 0.3530, 1.0000, 0.1939, -0.0617, -0.0017, -0.0942, -0.0332, 0.0813, 0.0810, -0.0032, -0.0870, -0.0599,
+      0.0270, -0.1719, 0.1070, 0.2009, -0.0066, 0.1682, 0.2305, 0.1939, 1.0000, -0.1851, -0.2073, -0.0756, -0.1637, -0.0865, 0.0699, -0.0485, -0.2153, 0.0320,
+      -0.0122, -0.1157, -0.1898, -0.1709, -0.2787, -0.0831, -0.0546, -0.0617, -0.1851, 1.0000, 0.2139, 0.0769, 0.1391, 0.0769, -0.1838, 0.0377, -0.1615, 0.1000,
+      0.0059, -0.0347, 0.0506, 0.0365, 0.0703, 0.0124, -0.0223, -0.0017, -0.2073, 0.2139, 1.0000, -0.1102, -0.0530, 0.0791, 0.0012, 0.0090, -0.0236, 0.0037,
+      -0.0344, -0.0277, -0.0661, -0.0579, -0.0541, -0.1236, -0.0782, -0.0942, -0.0756, 0.0769, -0.1102, 1.0000, -0.2562, -0.0406, 0.3154, 0.0065, -0.0093, -0.0354,
+      -0.0342, -0.0189, -0.0380, -0.0999, -0.0453, -0.0346, -0.0872, -0.0332, -0.1637, 0.1391, -0.0530, -0.2562, 1.0000, -0.1836, -0.1624, -0.5646, 0.0216, 0.0243,
+      0.0409, 0.0357, 0.0260, 0.0467, 0.1597, -0.0054, 0.0074, 0.0813, -0.0865, 0.0769, 0.0791, -0.0406, -0.1836, 1.0000, 0.1624, 0.1989, 0.0549, -0.0411,
+      -0.0137, 0.0657, 0.0506, 0.0410, 0.0792, 0.0877, 0.0999, 0.0810, 0.0699, -0.1838, 0.0012, 0.3154, -0.1624, 0.1624, 1.0000, 0.1552, 0.0844, -0.0637,
+      -0.0168, -0.0070, -0.0317, 0.0027, 0.0220, -0.0197, 0.0066, -0.0032, -0.0485, 0.0377, 0.0090, 0.0065, -0.5646, 0.1989, 0.1552, 1.0000, 0.0058, 0.0503,
+      -0.0990, 0.3690, -0.0278, -0.0966, 0.0606, -0.0867, -0.1358, -0.0870, -0.2153, -0.1615, -0.0236, -0.0093, 0.0216, 0.0549, 0.0844, 0.0058, 1.0000, -0.0930,
+      -0.6701, -0.0510, 0.0245, 0.0631, -0.0844, 0.0281, 0.0626, -0.0599, 0.0320, 0.1000, 0.0037, -0.0354, 0.0243, -0.0411, -0.0637, 0.0503, -0.0930, 1.0000;
+    // clang-format on
+
+    // Convert the standard deviation and correlation to covariance
+    model.covariance = numeric_utils::corr_to_cov(
+        correlation_matrix, (variance.array().sqrt()).matrix());
+
+    return model;
+  }();
+
+  return shared_model;
+}
+
+/**
+ * Get the marginal distributions of the model parameters shared by all
+ * instances. They are created through the distribution factory keys the
+ * first time they are requested for the current setting of
+ * config::tabulated_distributions, using the tabulated keys for beta, Student's
+ * t and inverse Gaussian marginals when it is set.
+ * @return Shared marginal distributions of model parameters
+ */
+const std::vector<std::shared_ptr<stochastic::Distribution>>&
+marginal_distributions() {
+  static std::mutex mutex;
+  static std::vector<std::shared_ptr<stochastic::Distribution>>
+      shared_distributions[2];
+  std::lock_guard<std::mutex> lock(mutex);
+  // Read setting once so cached distributions always match their slot
+  const bool tabulated = config::tabulated_distributions();
+  auto& distributions = shared_distributions[tabulated];
+  if (!distributions.empty()) {
+    return distributions;
+  }
+  const std::string prefix = tabulated ? "Tabulated" : "";
+
+  distributions.resize(18);
+  distributions[0] =
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "LognormalDist", std::move(-1.735), std::move(0.523));
+  distributions[1] =
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "LognormalDist", std::move(1.009), std::move(0.422));
+  distributions[2] =
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "NormalDist", std::move(0.249), std::move(1.759));
+  distributions[3] =
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "NormalDist", std::move(0.768), std::move(1.958));  
+  distributions[4] =
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "LognormalDist", std::move(2.568), std::move(0.557));
+  distributions[5] =
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "NormalDist", std::move(0.034), std::move(1.471));
+  distributions[6] =
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "NormalDist", std::move(0.441), std::move(1.733));
+  distributions[7] =
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "LognormalDist", std::move(3.356), std::move(0.473));    
+  distributions[8] =
+    Factory<stochastic::Distribution, double, double>::instance()->create(
+          prefix + "BetaDist", std::move(2.516), std::move(9.714));
+  distributions[9] =
+    Factory<stochastic::Distribution, double, double>::instance()->create(
+          prefix + "BetaDist", std::move(3.582), std::move(15.209));
+  distributions[10] =
+    Factory<stochastic::Distribution, double, double>::instance()->create(
+          "LognormalDist", std::move(0.746), std::move(0.404));
+  distributions[11] =
+      Factory<stochastic::Distribution, double, double, double>::instance()
+          ->create(prefix + "StudentstDist", std::move(0.205),
+                   std::move(0.232), std::move(7.250));
+  distributions[12] =
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            prefix + "InverseGaussianDist", std::move(0.499),
+            std::move(0.213));
+  distributions[13] =
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "LognormalDist", std::move(0.702), std::move(0.435));
+  distributions[14] =
+      Factory<stochastic::Distribution, double, double, double>::instance()
+          ->create(prefix + "StudentstDist", std::move(0.792),
+                   std::move(0.157), std::move(4.223));
+  distributions[15] =
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            prefix + "InverseGaussianDist", std::move(0.350),
+            std::move(0.170));
+  distributions[16] =
+    Factory<stochastic::Distribution, double, double>::instance()->create(
+          "LognormalDist", std::move(9.470), std::move(1.317));
+  distributions[17] =
+      Factory<stochastic::Distribution, double, double>::instance()->create(
+          "LognormalDist", std::move(3.658), std::move(0.375));
+
+  return distributions;
+}
+}  // namespace
+
 stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
                                      double rupture_distance, double vs30,
                                      double orientation,
@@ -38,8 +226,7 @@ stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
       cutoff_freq_{220.0},
       num_spectra_{num_spectra},
       num_sims_{num_sims},
-      seed_value_{std::numeric_limits<int>::infinity()},
-      model_parameters_{18} {
+      seed_value_{std::numeric_limits<int>::infinity()} {
   model_name_ = "VlachosEtAl";
   // Factors for site condition based on Vs30
   double site_soft = 0.0, site_medium = 0.0, site_hard = 0.0;
@@ -60,69 +247,13 @@ stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
       site_medium * std::log(vs30_), site_hard * std::log(vs30_);
   // clang-format on
 
-  // Restricted Maximum Likelihood method regression coefficients and variance
-  // components of the normal model parameters (Table 3 on page 13)
-  Eigen::MatrixXd beta(18, 7);
-  // clang-format off
-  beta <<
-    -1.1417, 1.0917, 1.9125, -0.9696, 0.0971, 0.3476, -0.6740,
-    1.8052,-1.8381, -3.5874, 3.7895, 0.3236, 0.5497, 0.2876,
-    1.8969,-1.8819, -2.0818, 1.9000, -0.3520, -0.6959, -0.0025,
-    1.6627,-1.6922, -1.2509, 1.1880, -0.5170, -1.0157, -0.1041,
-    3.8703,-3.4745, -0.0816, 0.0166, 0.4904, 0.8697, 0.3179,
-    1.1043,-1.1852, -1.0068, 0.9388, -0.5603, -0.8855, -0.3174,
-    1.1935,-1.2922, -0.7028, 0.6975, -0.6629, -1.1075, -0.4542,
-    1.7895,-1.5014, -0.0300, -0.1306, 0.4526, 0.7132, 0.1522,
-    -3.6404, 3.3189, -0.5316, 0.3874, -0.3757, -0.8334, 0.1006,
-    -2.2742, 2.1454, 0.6315, -0.6620, 0.1093, -0.1028, -0.0479,
-    0.6930, -0.6202, 1.8037, -1.6064, 0.0727, -0.1498, -0.0722,
-    1.3003, -1.2004, -1.2210, 1.0623, -0.0252, 0.1885, 0.0069,
-    0.4604, -0.4087, -0.5057, 0.4486, 0.1073, -0.0219, -0.1352,
-    2.2304, -2.0398, -0.1364, 0.1910, 0.2425, 0.1801, 0.3233,
-    2.3806, -2.2011, -0.3256, 0.2226, -0.0221, 0.0970, 0.0762,
-    0.2057, -0.1714, 0.3385, -0.2229, 0.0802, 0.2649, 0.0396,
-    -7.6011, 6.8507, -2.3609, 0.9201, -0.7508, -0.7903, -0.6204,
-    -6.3472, 5.8241, 3.2994, -2.8774, -0.1411, -0.5298, -0.0203;
-  // clang-format on
-
-  // Variance of model parameters (Table 3 on page 13)
-  Eigen::VectorXd variance(18);
-  // clang-format off
-  variance <<
-      0.90, 0.80, 0.78, 0.74, 0.66, 0.73, 0.72, 0.70, 0.69,
-      0.78, 0.90, 0.90, 0.90, 0.90, 0.80, 0.90, 0.35, 0.80;
-  // clang-format on
-  
-  // Estimated correlation matrix (Table A1 on page 24)
-  Eigen::MatrixXd correlation_matrix(18, 18);
-  // clang-format off
-  correlation_matrix <<
-    1.0000, 0.0382, -0.0912, -0.0701, -0.0214, -0.0849, -0.0545, -0.0185, 0.0270, -0.0122, 0.0059, -0.0344, -0.0342, 0.0409, -0.0137, -0.0168, -0.0990, -0.6701,
-    0.0382, 1.0000, -0.1159, -0.1856, 0.0681, -0.2018, -0.2765, -0.0304, -0.1719, -0.1157, -0.0347, -0.0277, -0.0189, 0.0357, 0.0657, -0.0070, 0.3690, -0.0510,
-    -0.0912, -0.1159, 1.0000, 0.9467, 0.4123, 0.4815, 0.4240, 0.2120, 0.1070, -0.1898, 0.0506, -0.0661, -0.0380, 0.0260, 0.0506, -0.0317, -0.0278, 0.0245,
-    -0.0701, -0.1856, 0.9467, 1.0000, 0.4075, 0.4891, 0.4940, 0.2285, 0.2009, -0.1709, 0.0365, -0.0579, -0.0999, 0.0467, 0.0410, 0.0027, -0.0966, 0.0631,
-    -0.0214, 0.0681, 0.4123, 0.4075, 1.0000, 0.1772, 0.1337, 0.7315, -0.0066, -0.2787, 0.0703, -0.0541, -0.0453, 0.1597, 0.0792, 0.0220, 0.0606, -0.0844,
-    -0.0849, -0.2018, 0.4815, 0.4891, 0.1772, 1.0000, 0.9448, 0.3749, 0.1682, -0.0831, 0.0124, -0.1236, -0.0346, -0.0054, 0.0877, -0.0197, -0.0867, 0.0281,
-    -0.0545, -0.2765, 0.4240, 0.4940, 0.1337, 0.9448, 1.0000, 0.3530, 0.2305, -0.0546, -0.0223, -0.0782, -0.0872, 0.0074, 0.0999, 0.0066, -0.1358, 0.0626,
-    -0.0185, -0.0304, 0.2120, 0.2285, 0.7315, 0.3749, 0.3530, 1.0000, 0.1939, -0.0617, -0.0017, -0.0942, -0.0332, 0.0813, 0.0810, -0.0032, -0.0870, -0.0599,
-    0.0270, -0.1719, 0.1070, 0.2009, -0.0066, 0.1682, 0.2305, 0.1939, 1.0000, -0.1851, -0.2073, -0.0756, -0.1637, -0.0865, 0.0699, -0.0485, -0.2153, 0.0320,
-    -0.0122, -0.1157, -0.1898, -0.1709, -0.2787, -0.0831, -0.0546, -0.0617, -0.1851, 1.0000, 0.2139, 0.0769, 0.1391, 0.0769, -0.1838, 0.0377, -0.1615, 0.1000,
-    0.0059, -0.0347, 0.0506, 0.0365, 0.0703, 0.0124, -0.0223, -0.0017, -0.2073, 0.2139, 1.0000, -0.1102, -0.0530, 0.0791, 0.0012, 0.0090, -0.0236, 0.0037,
-    -0.0344, -0.0277, -0.0661, -0.0579, -0.0541, -0.1236, -0.0782, -0.0942, -0.0756, 0.0769, -0.1102, 1.0000, -0.2562, -0.0406, 0.3154, 0.0065, -0.0093, -0.0354,
-    -0.0342, -0.0189, -0.0380, -0.0999, -0.0453, -0.0346, -0.0872, -0.0332, -0.1637, 0.1391, -0.0530, -0.2562, 1.0000, -0.1836, -0.1624, -0.5646, 0.0216, 0.0243,
-    0.0409, 0.0357, 0.0260, 0.0467, 0.1597, -0.0054, 0.0074, 0.0813, -0.0865, 0.0769, 0.0791, -0.0406, -0.1836, 1.0000, 0.1624, 0.1989, 0.0549, -0.0411,
-    -0.0137, 0.0657, 0.0506, 0.0410, 0.0792, 0.0877, 0.0999, 0.0810, 0.0699, -0.1838, 0.0012, 0.3154, -0.1624, 0.1624, 1.0000, 0.1552, 0.0844, -0.0637,
-    -0.0168, -0.0070, -0.0317, 0.0027, 0.0220, -0.0197, 0.0066, -0.0032, -0.0485, 0.0377, 0.0090, 0.0065, -0.5646, 0.1989, 0.1552, 1.0000, 0.0058, 0.0503,
-    -0.0990, 0.3690, -0.0278, -0.0966, 0.0606, -0.0867, -0.1358, -0.0870, -0.2153, -0.1615, -0.0236, -0.0093, 0.0216, 0.0549, 0.0844, 0.0058, 1.0000, -0.0930,
-    -0.6701, -0.0510, 0.0245, 0.0631, -0.0844, 0.0281, 0.0626, -0.0599, 0.0320, 0.1000, 0.0037, -0.0354, 0.0243, -0.0411, -0.0637, 0.0503, -0.0930, 1.0000;
-  // clang-format on
+  // Regression model is shared by all instances
+  const auto& regression = regression_model();
 
   // Mean of transformed normal model parameters (described by Eq. 25 on page 12)
-  means_ = beta * conditional_means;
+  means_ = regression.beta * conditional_means;
 
-  // Convert the standard deviation and correlation to covariance
-  covariance_ = numeric_utils::corr_to_cov(correlation_matrix,
-                                           (variance.array().sqrt()).matrix());
+  covariance_ = regression.covariance;
 
   // Generate realizations of model parameters
   sample_generator_ =
@@ -132,80 +263,18 @@ stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
                               num_spectra_);
   parameter_realizations_.transposeInPlace();
 
-  // Create distributions for model parameters
-  model_parameters_[0] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(-1.735), std::move(0.523));
-  model_parameters_[1] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(1.009), std::move(0.422));
-  model_parameters_[2] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.249), std::move(1.759));
-  model_parameters_[3] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.768), std::move(1.958));  
-  model_parameters_[4] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(2.568), std::move(0.557));
-  model_parameters_[5] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.034), std::move(1.471));
-  model_parameters_[6] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.441), std::move(1.733));
-  model_parameters_[7] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(3.356), std::move(0.473));    
-  model_parameters_[8] =
-    Factory<stochastic::Distribution, double, double>::instance()->create(
-          "BetaDist", std::move(2.516), std::move(9.174));
-  model_parameters_[9] =
-    Factory<stochastic::Distribution, double, double>::instance()->create(
-          "BetaDist", std::move(3.582), std::move(15.209));
-  model_parameters_[10] =
-    Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(0.746), std::move(0.404));
-  model_parameters_[11] =
-      Factory<stochastic::Distribution, double, double, double>::instance()
-          ->create("StudentstDist", std::move(0.205), std::move(0.232),
-                   std::move(7.250));
-  model_parameters_[12] =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "InverseGaussianDist", std::move(0.499), std::move(0.213));
-  model_parameters_[13] =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "LognormalDist", std::move(0.702), std::move(0.435));
-  model_parameters_[14] =
-      Factory<stochastic::Distribution, double, double, double>::instance()
-          ->create("StudentstDist", std::move(0.792), std::move(0.157),
-                   std::move(4.223));
-  model_parameters_[15] =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "InverseGaussianDist", std::move(0.350), std::move(0.170));
-  model_parameters_[16] =
-    Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(9.470), std::move(1.317));
-  model_parameters_[17] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(3.658), std::move(0.375));
-
-  // Standard normal distribution with mean at 0.0 and standard deviation of 1.0
-  auto std_normal_dist =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.0), std::move(1.0));
+  // Distributions of model parameters are shared by all instances
+  model_parameters_ = marginal_distributions();
 
   physical_parameters_.resize(parameter_realizations_.rows(),
                               parameter_realizations_.cols());
 
-  // Transform sample normal model parameters to physical space
-  for (unsigned int i = 0; i < parameter_realizations_.rows(); ++i) {
-    for (unsigned int j = 0; j < model_parameters_.size(); ++j) {
-      physical_parameters_(i, j) =
-          (model_parameters_[j]->inv_cumulative_dist_func(
-              std_normal_dist->cumulative_dist_func(
-                  std::vector<double>{parameter_realizations_(i, j)})))[0];
-    }
+  // Transform sample normal model parameters to physical space, one
+  // parameter for all realizations at a time
+  for (unsigned int j = 0; j < model_parameters_.size(); ++j) {
+    model_parameters_[j]->transform_from_std_normal(
+        parameter_realizations_.col(j).data(),
+        physical_parameters_.col(j).data(), parameter_realizations_.rows());
   }
 }
 
@@ -226,8 +295,7 @@ stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
       cutoff_freq_{220.0},
       num_spectra_{num_spectra},
       num_sims_{num_sims},
-      seed_value_{seed_value},
-      model_parameters_{18} {
+      seed_value_{seed_value} {
   model_name_ = "VlachosEtAl";
   // Factors for site condition based on Vs30
   double site_soft = 0.0, site_medium = 0.0, site_hard = 0.0;
@@ -248,69 +316,13 @@ stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
       site_medium * std::log(vs30_), site_hard * std::log(vs30_);
   // clang-format on
 
-  // Restricted Maximum Likelihood method regression coefficients and variance
-  // components of the normal model parameters (Table 3 on page 13)
-  Eigen::MatrixXd beta(18, 7);
-  // clang-format off
-  beta <<
-    -1.1417, 1.0917, 1.9125, -0.9696, 0.0971, 0.3476, -0.6740,
-    1.8052,-1.8381, -3.5874, 3.7895, 0.3236, 0.5497, 0.2876,
-    1.8969,-1.8819, -2.0818, 1.9000, -0.3520, -0.6959, -0.0025,
-    1.6627,-1.6922, -1.2509, 1.1880, -0.5170, -1.0157, -0.1041,
-    3.8703,-3.4745, -0.0816, 0.0166, 0.4904, 0.8697, 0.3179,
-    1.1043,-1.1852, -1.0068, 0.9388, -0.5603, -0.8855, -0.3174,
-    1.1935,-1.2922, -0.7028, 0.6975, -0.6629, -1.1075, -0.4542,
-    1.7895,-1.5014, -0.0300, -0.1306, 0.4526, 0.7132, 0.1522,
-    -3.6404, 3.3189, -0.5316, 0.3874, -0.3757, -0.8334, 0.1006,
-    -2.2742, 2.1454, 0.6315, -0.6620, 0.1093, -0.1028, -0.0479,
-    0.6930, -0.6202, 1.8037, -1.6064, 0.0727, -0.1498, -0.0722,
-    1.3003, -1.2004, -1.2210, 1.0623, -0.0252, 0.1885, 0.0069,
-    0.4604, -0.4087, -0.5057, 0.4486, 0.1073, -0.0219, -0.1352,
-    2.2304, -2.0398, -0.1364, 0.1910, 0.2425, 0.1801, 0.3233,
-    2.3806, -2.2011, -0.3256, 0.2226, -0.0221, 0.0970, 0.0762,
-    0.2057, -0.1714, 0.3385, -0.2229, 0.0802, 0.2649, 0.0396,
-    -7.6011, 6.8507, -2.3609, 0.9201, -0.7508, -0.7903, -0.6204,
-    -6.3472, 5.8241, 3.2994, -2.8774, -0.1411, -0.5298, -0.0203;
-  // clang-format on
+  // Regression model is shared by all instances
+  const auto& regression = regression_model();
 
-  // Variance of model parameters (Table 3 on page 13)
-  Eigen::VectorXd variance(18);
-  // clang-format off
-  variance <<
-      0.90, 0.80, 0.78, 0.74, 0.66, 0.73, 0.72, 0.70, 0.69,
-      0.78, 0.90, 0.90, 0.90, 0.90, 0.80, 0.90, 0.35, 0.80;
-  // clang-format on
-  
-  // Estimated correlation matrix (Table A1 on page 24)
-  Eigen::MatrixXd correlation_matrix(18, 18);
-  // clang-format off
-  correlation_matrix <<
-    1.0000, 0.0382, -0.0912, -0.0701, -0.0214, -0.0849, -0.0545, -0.0185, 0.0270, -0.0122, 0.0059, -0.0344, -0.0342, 0.0409, -0.0137, -0.0168, -0.0990, -0.6701,
-    0.0382, 1.0000, -0.1159, -0.1856, 0.0681, -0.2018, -0.2765, -0.0304, -0.1719, -0.1157, -0.0347, -0.0277, -0.0189, 0.0357, 0.0657, -0.0070, 0.3690, -0.0510,
-    -0.0912, -0.1159, 1.0000, 0.9467, 0.4123, 0.4815, 0.4240, 0.2120, 0.1070, -0.1898, 0.0506, -0.0661, -0.0380, 0.0260, 0.0506, -0.0317, -0.0278, 0.0245,
-    -0.0701, -0.1856, 0.9467, 1.0000, 0.4075, 0.4891, 0.4940, 0.2285, 0.2009, -0.1709, 0.0365, -0.0579, -0.0999, 0.0467, 0.0410, 0.0027, -0.0966, 0.0631,
-    -0.0214, 0.0681, 0.4123, 0.4075, 1.0000, 0.1772, 0.1337, 0.7315, -0.0066, -0.2787, 0.0703, -0.0541, -0.0453, 0.1597, 0.0792, 0.0220, 0.0606, -0.0844,
-    -0.0849, -0.2018, 0.4815, 0.4891, 0.1772, 1.0000, 0.9448, 0.3749, 0.1682, -0.0831, 0.0124, -0.1236, -0.0346, -0.0054, 0.0877, -0.0197, -0.0867, 0.0281,
-    -0.0545, -0.2765, 0.4240, 0.4940, 0.1337, 0.9448, 1.0000, 0.3530, 0.2305, -0.0546, -0.0223, -0.0782, -0.0872, 0.0074, 0.0999, 0.0066, -0.1358, 0.0626,
-    -0.0185, -0.0304, 0.2120, 0.2285, 0.7315, 0.3749, 0.3530, 1.0000, 0.1939, -0.0617, -0.0017, -0.0942, -0.0332, 0.0813, 0.0810, -0.0032, -0.0870, -0.0599,
-    0.0270, -0.1719, 0.1070, 0.2009, -0.0066, 0.1682, 0.2305, 0.1939, 1.0000, -0.1851, -0.2073, -0.0756, -0.1637, -0.0865, 0.0699, -0.0485, -0.2153, 0.0320,
-    -0.0122, -0.1157, -0.1898, -0.1709, -0.2787, -0.0831, -0.0546, -0.0617, -0.1851, 1.0000, 0.2139, 0.0769, 0.1391, 0.0769, -0.1838, 0.0377, -0.1615, 0.1000,
-    0.0059, -0.0347, 0.0506, 0.0365, 0.0703, 0.0124, -0.0223, -0.0017, -0.2073, 0.2139, 1.0000, -0.1102, -0.0530, 0.0791, 0.0012, 0.0090, -0.0236, 0.0037,
-    -0.0344, -0.0277, -0.0661, -0.0579, -0.0541, -0.1236, -0.0782, -0.0942, -0.0756, 0.0769, -0.1102, 1.0000, -0.2562, -0.0406, 0.3154, 0.0065, -0.0093, -0.0354,
-    -0.0342, -0.0189, -0.0380, -0.0999, -0.0453, -0.0346, -0.0872, -0.0332, -0.1637, 0.1391, -0.0530, -0.2562, 1.0000, -0.1836, -0.1624, -0.5646, 0.0216, 0.0243,
-    0.0409, 0.0357, 0.0260, 0.0467, 0.1597, -0.0054, 0.0074, 0.0813, -0.0865, 0.0769, 0.0791, -0.0406, -0.1836, 1.0000, 0.1624, 0.1989, 0.0549, -0.0411,
-    -0.0137, 0.0657, 0.0506, 0.0410, 0.0792, 0.0877, 0.0999, 0.0810, 0.0699, -0.1838, 0.0012, 0.3154, -0.1624, 0.1624, 1.0000, 0.1552, 0.0844, -0.0637,
-    -0.0168, -0.0070, -0.0317, 0.0027, 0.0220, -0.0197, 0.0066, -0.0032, -0.0485, 0.0377, 0.0090, 0.0065, -0.5646, 0.1989, 0.1552, 1.0000, 0.0058, 0.0503,
-    -0.0990, 0.3690, -0.0278, -0.0966, 0.0606, -0.0867, -0.1358, -0.0870, -0.2153, -0.1615, -0.0236, -0.0093, 0.0216, 0.0549, 0.0844, 0.0058, 1.0000, -0.0930,
-    -0.6701, -0.0510, 0.0245, 0.0631, -0.0844, 0.0281, 0.0626, -0.0599, 0.0320, 0.1000, 0.0037, -0.0354, 0.0243, -0.0411, -0.0637, 0.0503, -0.0930, 1.0000;
-  // clang-format on
-
-  // Mean of transformed normal model parameters (described by Eq. 25 on page 12)   
-  means_ = beta * conditional_means;
+  // Mean of transformed normal model parameters (described by Eq. 25 on page 12)
+  means_ = regression.beta * conditional_means;
   
-  // Convert the standard deviation and correlation to covariance
-  covariance_ = numeric_utils::corr_to_cov(correlation_matrix,
-                                           (variance.array().sqrt()).matrix());
+  covariance_ = regression.covariance;
 
   // Generate realizations of model parameters
   sample_generator_ =
@@ -320,168 +332,350 @@ stochastic::VlachosEtAl::VlachosEtAl(double moment_magnitude,
                               num_spectra_);
   parameter_realizations_.transposeInPlace();
 
-  // Create distributions for model parameters
-  model_parameters_[0] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(-1.735), std::move(0.523));
-  model_parameters_[1] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(1.009), std::move(0.422));
-  model_parameters_[2] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.249), std::move(1.759));
-  model_parameters_[3] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.768), std::move(1.958));  
-  model_parameters_[4] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(2.568), std::move(0.557));
-  model_parameters_[5] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.034), std::move(1.471));
-  model_parameters_[6] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.441), std::move(1.733));
-  model_parameters_[7] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(3.356), std::move(0.473));    
-  model_parameters_[8] =
-    Factory<stochastic::Distribution, double, double>::instance()->create(
-          "BetaDist", std::move(2.516), std::move(9.714));
-  model_parameters_[9] =
-    Factory<stochastic::Distribution, double, double>::instance()->create(
-          "BetaDist", std::move(3.582), std::move(15.209));
-  model_parameters_[10] =
-    Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(0.746), std::move(0.404));
-  model_parameters_[11] =
-      Factory<stochastic::Distribution, double, double, double>::instance()
-          ->create("StudentstDist", std::move(0.205), std::move(0.232),
-                   std::move(7.250));
-  model_parameters_[12] =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "InverseGaussianDist", std::move(0.499), std::move(0.213));
-  model_parameters_[13] =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "LognormalDist", std::move(0.702), std::move(0.435));
-  model_parameters_[14] =
-      Factory<stochastic::Distribution, double, double, double>::instance()
-          ->create("StudentstDist", std::move(0.792), std::move(0.157),
-                   std::move(4.223));
-  model_parameters_[15] =
-        Factory<stochastic::Distribution, double, double>::instance()->create(
-            "InverseGaussianDist", std::move(0.350), std::move(0.170));
-  model_parameters_[16] =
-    Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(9.470), std::move(1.317));
-  model_parameters_[17] =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "LognormalDist", std::move(3.658), std::move(0.375));
-
-  // Standard normal distribution with mean at 0.0 and standard deviation of 1.0
-  auto std_normal_dist =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.0), std::move(1.0));
+  // Distributions of model parameters are shared by all instances
+  model_parameters_ = marginal_distributions();
 
   physical_parameters_.resize(parameter_realizations_.rows(),
                               parameter_realizations_.cols());
 
-  // Transform sample normal model parameters to physical space
-  for (unsigned int i = 0; i < parameter_realizations_.rows(); ++i) {
-    for (unsigned int j = 0; j < model_parameters_.size(); ++j) {
-      physical_parameters_(i, j) =
-          (model_parameters_[j]->inv_cumulative_dist_func(
-              std_normal_dist->cumulative_dist_func(
-                  std::vector<double>{parameter_realizations_(i, j)})))[0];
-    }
+  // Transform sample normal model parameters to physical space, one
+  // parameter for all realizations at a time
+  for (unsigned int j = 0; j < model_parameters_.size(); ++j) {
+    model_parameters_[j]->transform_from_std_normal(
+        parameter_realizations_.col(j).data(),
+        physical_parameters_.col(j).data(), parameter_realizations_.rows());
   }
 }
 
-utilities::JsonObject stochastic::VlachosEtAl::generate(
-    const std::string& event_name, bool units) {
+stochastic::VlachosEtAl::VlachosEtAl(
+    double moment_magnitude, double rupture_distance, double vs30,
+    double orientation, const Eigen::MatrixXd& standard_normal_parameters,
+    unsigned int num_sims, std::uint64_t stream_seed)
+    : VlachosEtAl(moment_magnitude, rupture_distance, vs30, orientation,
+                  static_cast<unsigned int>(standard_normal_parameters.rows()),
+                  num_sims) {
+  if (standard_normal_parameters.cols() != means_.size()) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::VlachosEtAl: Standard normal "
+        "variables must be given for each of the 18 model parameters\n");
+  }
+
+  // All random variables are drawn from streams keyed by the input seed,
+  // including candidates of rejection sampling in identify_parameters
+  fixed_stream_seed_ = true;
+  model_stream_seed_ = stream_seed;
+  sample_generator_ =
+      Factory<numeric_utils::RandomGenerator, std::uint64_t>::instance()
+          ->create("MultivariateNormalStream", std::move(stream_seed));
+
+  // Replace independent realizations by the input variables correlated
+  // with the parameter covariance, which have the same distribution
+  Eigen::MatrixXd lower_cholesky = covariance_.llt().matrixL();
+  parameter_realizations_ =
+      (standard_normal_parameters * lower_cholesky.transpose()).rowwise() +
+      means_.transpose();
+
+  for (unsigned int j = 0; j < model_parameters_.size(); ++j) {
+    model_parameters_[j]->transform_from_std_normal(
+        parameter_realizations_.col(j).data(),
+        physical_parameters_.col(j).data(), parameter_realizations_.rows());
+  }
+}
+
+std::size_t stochastic::VlachosEtAl::num_records() const {
+  return static_cast<std::size_t>(num_spectra_) * num_sims_;
+}
 
-  // Pool of acceleration time histories based on number of spectra and
-  // simulations requested
-  std::vector<std::vector<std::vector<double>>> acceleration_pool(
-      num_spectra_,
-      std::vector<std::vector<double>>(num_sims_, std::vector<double>()));
+stochastic::RecordIterator stochastic::VlachosEtAl::records(
+    const std::string& event_name, bool units, std::size_t batch_size) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+
+  // Select seed of random streams used for phase angles. Each batch restores
+  // the seed, so records of the iterator share one set of streams even when
+  // other calls to generate select new seeds in between.
+  std::uint64_t stream_seed = select_stream_seed();
+  stream_seed_ = stream_seed;
+
+  // Identify parameters in order since rejection sampling draws from the
+  // shared sample generator, which keeps results independent of the
+  // number of threads
+  auto identified_parameters =
+      std::make_shared<std::vector<Eigen::VectorXd>>(num_spectra_);
+  for (unsigned int i = 0; i < num_spectra_; ++i) {
+    (*identified_parameters)[i] =
+        identify_parameters(physical_parameters_.row(i));
+  }
+
+  // Intermediates that do not depend on random draws are reused by later
+  // calls when caching
+  std::shared_ptr<const numeric_utils::Convolver> highpass_filter =
+      highpass_filter_;
+  if (!highpass_filter) {
+    highpass_filter = std::make_shared<const numeric_utils::Convolver>(
+        highpass_impulse_response(), numeric_utils::Convolver::Mode::Auto,
+        fft_padding_);
+  }
+  if (deterministic_cache_) {
+    highpass_filter_ = highpass_filter;
+    if (frequencies_.empty()) {
+      frequencies_ = spectrum_frequencies();
+      highpass_butter_energy_ = highpass_butter_energy(frequencies_);
+    }
+  }
+
+  // Appended simulations continue the campaign of this call
+  campaign_.identified_parameters = identified_parameters;
+  campaign_.highpass_filter = highpass_filter;
+  campaign_.stream_seed = stream_seed;
+
+  return RecordIterator(
+      num_records(),
+      batch_size > 0 ? batch_size : std::max(num_sims_, 1u),
+      [this, event_name, units, stream_seed, identified_parameters,
+       highpass_filter](std::size_t first_record, std::size_t num_records,
+                        std::vector<RecordMetadata>* metadata) {
+        SMELT_PROFILE_ACTIVATE(profile_);
+        if (stream_seed_ != stream_seed) {
+          stream_seed_ = stream_seed;
+        }
+        auto records = generate_range(units, *identified_parameters,
+                                      *highpass_filter, first_record,
+                                      num_records);
+        if (metadata) {
+          records_metadata(event_name, records, first_record, *metadata);
+        }
+        return records;
+      });
+}
+
+utilities::TimeHistoryBlock stochastic::VlachosEtAl::generate_range(
+    bool units, const std::vector<Eigen::VectorXd>& identified_parameters,
+    const numeric_utils::Convolver& highpass_filter, std::size_t first_record,
+    std::size_t num_records) {
+  std::size_t last_record = first_record + num_records;
+
+  // Record lengths are known from identified parameters, so x- and
+  // y-components of all records are written directly into their final
+  // location. Records are ordered by spectrum and then by simulation.
+  std::vector<std::size_t> record_lengths(num_records);
+  for (std::size_t k = 0; k < num_records; ++k) {
+    record_lengths[k] =
+        num_time_steps(identified_parameters[(first_record + k) / num_sims_]) +
+        highpass_filter.kernel_size() - 1;
+  }
+  utilities::TimeHistoryBlock records(record_lengths, 2, time_step_);
 
   // Generate family of time histories for each spectrum. Family size is
   // specified by requested number of simulations per spectra.
   try {
-    for (unsigned int i = 0; i < num_spectra_; ++i) {
-      time_history_family(acceleration_pool[i], physical_parameters_.row(i));
+    if (num_records == 0) {
+      return records;
+    }
+
+    // Power spectra are computed for the spectra the range touches in groups
+    // of one per thread to bound the number of power spectra held in memory
+    // at once
+    unsigned int first_spectrum = first_record / num_sims_;
+    unsigned int end_spectrum = (last_record - 1) / num_sims_ + 1;
+    unsigned int group_size = std::min(utilities::thread_count(num_threads_),
+                                       end_spectrum - first_spectrum);
+    std::vector<Eigen::MatrixXd> power_spectra(group_size),
+        time_modulations(group_size), frequency_shapes(group_size);
+
+    for (unsigned int group_start = first_spectrum; group_start < end_spectrum;
+         group_start += group_size) {
+      unsigned int num_group_spectra =
+          std::min(group_size, end_spectrum - group_start);
+
+      utilities::parallel_for(
+          num_group_spectra, num_threads_, [&](unsigned int i) {
+            power_spectra[i] = evolutionary_power_spectrum(
+                identified_parameters[group_start + i]);
+            if (synthesis_method_ == SynthesisMethod::LowRank) {
+              factor_spectrum(power_spectra[i], time_modulations[i],
+                              frequency_shapes[i]);
+            }
+          });
+
+      // When screening, candidates for each record use every num_sims_-th
+      // random stream, starting from the stream used without screening.
+      // Criteria are on intensity measures in output units, so each
+      // candidate is filtered and rotated before it is checked.
+      std::size_t group_first = std::max(
+          first_record, static_cast<std::size_t>(group_start) * num_sims_);
+      std::size_t group_last = std::min(
+          last_record,
+          static_cast<std::size_t>(group_start + num_group_spectra) *
+              num_sims_);
+      unsigned int max_attempts =
+          acceptance_criteria_ ? acceptance_criteria_->max_attempts() : 1;
+      utilities::parallel_for(
+          group_last - group_first, num_threads_, [&](unsigned int k) {
+            std::size_t index = group_first + k;
+            unsigned int spectrum = index / num_sims_, j = index % num_sims_;
+            unsigned int i = spectrum - group_start;
+            std::size_t record = index - first_record;
+            std::vector<double> time_history;
+            for (unsigned int attempt = 0; attempt < max_attempts;
+                 ++attempt) {
+              SMELT_PROFILE_COUNT("candidates", 1);
+              synthesize_family_member(time_history, power_spectra[i],
+                                       time_modulations[i],
+                                       frequency_shapes[i], spectrum,
+                                       j + attempt * num_sims_);
+              post_process(time_history, highpass_filter,
+                           records.data(record, 0), records.data(record, 1),
+                           units);
+              if (!acceptance_criteria_ ||
+                  acceptance_criteria_->accept(records.record(record),
+                                               time_step_)) {
+                return;
+              }
+            }
+            throw std::runtime_error(
+                "\nERROR: in stochastic::VlachosEtAl::generate: No "
+                "candidate time history satisfied acceptance criteria "
+                "within maximum number of attempts\n");
+          });
     }
   } catch (const std::exception& e) {
     std::cerr << e.what();
     throw;
   }
 
-  // Create JsonObject for events
-  auto events = utilities::JsonObject();
-  std::vector<utilities::JsonObject> events_array(num_spectra_ * num_sims_);
-
-  // Add pattern information for JSON
-  auto pattern_x = utilities::JsonObject();
-  auto pattern_y = utilities::JsonObject();  
-  pattern_x.add_value("type", "UniformAcceleration");
-  pattern_x.add_value("timeSeries", "accel_x");
-  pattern_x.add_value("dof", 1);
-  pattern_y.add_value("type", "UniformAcceleration");
-  pattern_y.add_value("timeSeries", "accel_y");
-  pattern_y.add_value("dof", 2);
-
-  // Create JSON for specific event
-  auto event_data = utilities::JsonObject();
-  // Loop over spectra
-  for (unsigned int i = 0; i < num_spectra_; ++i) {
-    // Loop over different simulations for current spectra
-    for (unsigned int j = 0; j < num_sims_; ++j) {
-      event_data.add_value("name", event_name + "_Spectra" + std::to_string(i) +
-                                       "_Sim" + std::to_string(j));
-      event_data.add_value("type", "Seismic");
-      event_data.add_value("dT", time_step_);
-      event_data.add_value("numSteps", acceleration_pool[i][j].size());
-      event_data.add_value(
-          "pattern", std::vector<utilities::JsonObject>{pattern_x, pattern_y});
-
-      // Rotate accelerations, if necessary      
-      std::vector<double> x_accels(acceleration_pool[i][j].size());
-      std::vector<double> y_accels(acceleration_pool[i][j].size());
-      rotate_acceleration(acceleration_pool[i][j], x_accels, y_accels, units);
-
-      // Add time histories for x and y directions to event
-      auto time_history_x = utilities::JsonObject();
-      auto time_history_y = utilities::JsonObject();
-      time_history_x.add_value("name", "accel_x");
-      time_history_x.add_value("type", "Value");
-      time_history_x.add_value("dT", time_step_);
-      time_history_x.add_value("data", x_accels);
-      time_history_y.add_value("name", "accel_y");
-      time_history_y.add_value("type", "Value");
-      time_history_y.add_value("dT", time_step_);
-      time_history_y.add_value("data", y_accels);
-      event_data.add_value("timeSeries", std::vector<utilities::JsonObject>{
-                                             time_history_x, time_history_y});
-      events_array[i * num_sims_ + j] = event_data;	
-      event_data.clear();
-    }
+  return records;
+}
+
+void stochastic::VlachosEtAl::generate_batches(
+    bool units, unsigned int spectra_per_batch,
+    const std::function<void(utilities::TimeHistoryBlock&, std::size_t)>&
+        process_batch) {
+  auto iterator = records(
+      "", units,
+      static_cast<std::size_t>(std::max(spectra_per_batch, 1u)) *
+          std::max(num_sims_, 1u));
+
+  utilities::TimeHistoryBlock batch;
+  std::size_t first_record = iterator.position();
+  while (iterator.next(batch)) {
+    process_batch(batch, first_record);
+    first_record = iterator.position();
   }
+}
 
-  events.add_value("Events", events_array);
+utilities::TimeHistoryBlock stochastic::VlachosEtAl::generate_records(
+    bool units) {
+  utilities::TimeHistoryBlock records;
+  generate_batches(units, num_spectra_,
+                   [&records](utilities::TimeHistoryBlock& batch,
+                              std::size_t) {
+                     records = std::move(batch);
+                   });
+  return records;
+}
+
+std::uint64_t stochastic::VlachosEtAl::select_stream_seed() const {
+  return fixed_stream_seed_ ? model_stream_seed_
+                            : numeric_utils::stream_seed(seed_value_);
+}
+
+std::string stochastic::VlachosEtAl::record_name(
+    const std::string& event_name, std::size_t record) const {
+  return event_name + "_Spectra" + std::to_string(record / num_sims_) +
+         "_Sim" + std::to_string(record % num_sims_);
+}
+
+std::vector<utilities::JsonObject> stochastic::VlachosEtAl::events_json(
+    const std::string& event_name, const utilities::TimeHistoryBlock& records,
+    std::size_t first_record,
+    const std::vector<std::size_t>* data_offsets) const {
+  SMELT_PROFILE_STAGE("eventsJson");
+  std::vector<utilities::JsonObject> events(records.num_records());
+  utilities::parallel_for(
+      records.num_records(), num_threads_, [&](unsigned int k) {
+        events[k] = seismic_event_json(
+            record_name(event_name, first_record + k), records, k,
+            data_offsets ? data_offsets->data() + 2 * k : nullptr);
+      });
+  return events;
+}
+
+utilities::JsonObject stochastic::VlachosEtAl::generate(
+    const std::string& event_name, bool units) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+  auto records = generate_records(units);
+
+  // Create JsonObject for events
+  auto events = utilities::JsonObject();
+  events.add_value("Events", events_json(event_name, records, 0));
 
   return events;
 }
 
+void stochastic::VlachosEtAl::records_metadata(
+    const std::string& event_name, const utilities::TimeHistoryBlock& records,
+    std::size_t first_record, std::vector<RecordMetadata>& metadata) const {
+  metadata.resize(records.num_records());
+  for (std::size_t i = 0; i < records.num_records(); ++i) {
+    metadata[i].name = record_name(event_name, first_record + i);
+    metadata[i].type = "Seismic";
+    metadata[i].time_step = records.time_step();
+    metadata[i].num_steps = records.num_steps(i);
+    metadata[i].components = {"accel_x", "accel_y"};
+  }
+}
+
+utilities::TimeHistoryBlock stochastic::VlachosEtAl::generate(
+    const std::string& event_name, std::vector<RecordMetadata>& metadata,
+    bool units) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+  auto records = generate_records(units);
+  records_metadata(event_name, records, 0, metadata);
+  return records;
+}
+
 bool stochastic::VlachosEtAl::generate(const std::string& event_name,
                                        const std::string& output_location,
                                        bool units) {
   bool status = true;
-  
-  // Generate pool of acceleration time histories
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+
+  // Write events of each batch of spectra as soon as they are generated so
+  // only one batch of time histories is held in memory
   try{
-    auto json_output = generate(event_name, units);
-    json_output.write_to_file(output_location);
+    if (output_format_ == OutputFormat::Spectral) {
+      // Parameters are written with round-trip precision so rebuilt records
+      // match the records of the archive exactly
+      auto format = json_format_;
+      format.significant_digits = 0;
+      return spectral_archive(event_name, units)
+          .write_to_file(output_location, format);
+    }
+
+    if (output_format_ == OutputFormat::Binary) {
+      // Binary header precedes all arrays, so all records are generated first
+      auto records = generate_records(units);
+      utilities::BinaryFileWriter binary_writer;
+      auto data_offsets = binary_writer.add_records(records);
+      auto events = utilities::JsonObject();
+      events.add_value("Events",
+                       events_json(event_name, records, 0, &data_offsets));
+      return binary_writer.write(output_location, events);
+    }
+
+    utilities::JsonEventWriter writer(output_location, json_format_);
+    generate_batches(
+        units, utilities::thread_count(num_threads_),
+        [&](utilities::TimeHistoryBlock& batch, std::size_t first_record) {
+          for (auto& event : events_json(event_name, batch, first_record)) {
+            writer.write_event(event);
+          }
+        });
+    status = writer.close();
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -491,19 +685,299 @@ bool stochastic::VlachosEtAl::generate(const std::string& event_name,
   return status;
 }
 
+unsigned int stochastic::VlachosEtAl::extend_campaign(unsigned int num_sims) {
+  if (!campaign_.identified_parameters) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::extend_campaign: No records "
+        "have been generated to append simulations to\n");
+  }
+  if (acceptance_criteria_) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::extend_campaign: Simulations "
+        "can not be appended when screening with acceptance criteria\n");
+  }
+
+  unsigned int previous_sims = num_sims_;
+  num_sims_ += num_sims;
+  stream_seed_ = campaign_.stream_seed;
+  return previous_sims;
+}
+
+stochastic::RecordIterator stochastic::VlachosEtAl::append_records(
+    const std::string& event_name, unsigned int num_sims, bool units,
+    std::size_t batch_size) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+  unsigned int previous_sims = extend_campaign(num_sims);
+
+  // Phase angles of each record depend only on its spectrum and simulation
+  // indices, so appended records continue the streams of the campaign
+  Campaign campaign = campaign_;
+  return appended_records(
+      num_spectra_, previous_sims, num_sims,
+      batch_size > 0 ? batch_size : std::max(num_sims, 1u),
+      [this, event_name, units, campaign](
+          std::size_t first_record, std::size_t num_records,
+          std::vector<RecordMetadata>* metadata) {
+        SMELT_PROFILE_ACTIVATE(profile_);
+        stream_seed_ = campaign.stream_seed;
+        auto records = generate_range(units, *campaign.identified_parameters,
+                                      *campaign.highpass_filter, first_record,
+                                      num_records);
+        if (metadata) {
+          records_metadata(event_name, records, first_record, *metadata);
+        }
+        return records;
+      });
+}
+
+bool stochastic::VlachosEtAl::append(const std::string& event_name,
+                                     const std::string& output_location,
+                                     unsigned int num_sims, bool units) {
+  if (output_format_ == OutputFormat::Spectral) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::append: Simulations can not be "
+        "appended to spectral archives\n");
+  }
+  bool status = true;
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+  unsigned int previous_sims = extend_campaign(num_sims);
+
+  // Appended simulations of each spectrum are contiguous among all records,
+  // so they are generated one spectrum at a time
+  auto generate_spectrum = [&](unsigned int spectrum,
+                               std::size_t& first_record) {
+    first_record = static_cast<std::size_t>(spectrum) * num_sims_ +
+                   previous_sims;
+    return generate_range(units, *campaign_.identified_parameters,
+                          *campaign_.highpass_filter, first_record, num_sims);
+  };
+
+  try {
+    if (output_format_ == OutputFormat::Binary) {
+      // Binary file is rewritten with the appended arrays after the
+      // existing ones, so all appended records are generated first
+      utilities::BinaryFileWriter binary_writer;
+      binary_writer.append_to(output_location);
+      std::vector<utilities::TimeHistoryBlock> spectra(num_spectra_);
+      std::vector<utilities::JsonObject> events;
+      for (unsigned int i = 0; i < num_spectra_; ++i) {
+        std::size_t first_record;
+        spectra[i] = generate_spectrum(i, first_record);
+        auto data_offsets = binary_writer.add_records(spectra[i]);
+        auto spectrum_events =
+            events_json(event_name, spectra[i], first_record, &data_offsets);
+        events.insert(events.end(), spectrum_events.begin(),
+                      spectrum_events.end());
+      }
+      auto header = utilities::JsonObject();
+      header.add_value("Events", events);
+      return binary_writer.write(output_location, header);
+    }
+
+    utilities::JsonEventWriter writer(output_location, json_format_, true);
+    for (unsigned int i = 0; i < num_spectra_; ++i) {
+      std::size_t first_record;
+      auto records = generate_spectrum(i, first_record);
+      for (auto& event : events_json(event_name, records, first_record)) {
+        writer.write_event(event);
+      }
+    }
+    status = writer.close();
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    // Campaign keeps its size when simulations could not be appended
+    num_sims_ = previous_sims;
+    status = false;
+    throw;
+  }
+
+  return status;
+}
+
+utilities::JsonObject stochastic::VlachosEtAl::spectral_archive(
+    const std::string& event_name, bool units) {
+  if (acceptance_criteria_) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::spectral_archive: Spectral "
+        "archives can not be created when screening with acceptance "
+        "criteria\n");
+  }
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+
+  // Records are synthesized from the identified parameters of their spectrum
+  // and the random stream of their spectrum and simulation
+  std::vector<std::vector<double>> spectra(num_spectra_);
+  std::vector<std::size_t> spectrum_steps(num_spectra_);
+  std::size_t kernel_size = highpass_filter_
+                                ? highpass_filter_->kernel_size()
+                                : highpass_impulse_response().size();
+  for (unsigned int i = 0; i < num_spectra_; ++i) {
+    Eigen::VectorXd parameters =
+        identify_parameters(physical_parameters_.row(i));
+    spectra[i].assign(parameters.data(), parameters.data() + parameters.size());
+    spectrum_steps[i] = num_time_steps(parameters) + kernel_size - 1;
+  }
+
+  std::vector<utilities::JsonObject> records(num_records());
+  for (std::size_t k = 0; k < records.size(); ++k) {
+    records[k].add_value("name", record_name(event_name, k));
+    records[k].add_value("spectrum", k / num_sims_);
+    records[k].add_value("simulation", k % num_sims_);
+    records[k].add_value("numSteps", spectrum_steps[k / num_sims_]);
+  }
+
+  auto archive = utilities::JsonObject();
+  archive.add_value("model", model_name_);
+  archive.add_value("streamSeed", select_stream_seed());
+  if (phase_field_) {
+    archive.add_value("phaseSeed", phase_seed_);
+  }
+  archive.add_value("units", units);
+  archive.add_value("timeStep", time_step_);
+  archive.add_value("numSims", num_sims_);
+  archive.add_value("spectra", spectra);
+  archive.add_value("records", records);
+  return archive;
+}
+
+utilities::TimeHistoryBlock stochastic::VlachosEtAl::rebuild_records(
+    const utilities::JsonObject& archive, std::size_t first_record,
+    std::size_t num_records) {
+  auto contents = archive_contents(archive, first_record, num_records);
+  const auto& spectra = contents["spectra"];
+  if (contents["numSims"] != num_sims_ || spectra.size() != num_spectra_) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::rebuild_records: Archive does "
+        "not match number of spectra and simulations of model\n");
+  }
+  if ((contents.find("phaseSeed") != contents.end()) != bool(phase_field_)) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::rebuild_records: Archive and "
+        "model must both use a phase field or both not use one\n");
+  }
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+
+  std::vector<Eigen::VectorXd> identified_parameters(num_spectra_);
+  for (unsigned int i = 0; i < num_spectra_; ++i) {
+    auto parameters = spectra[i].get<std::vector<double>>();
+    identified_parameters[i] =
+        Eigen::Map<Eigen::VectorXd>(parameters.data(), parameters.size());
+  }
+
+  std::shared_ptr<const numeric_utils::Convolver> highpass_filter =
+      highpass_filter_;
+  if (!highpass_filter) {
+    highpass_filter = std::make_shared<const numeric_utils::Convolver>(
+        highpass_impulse_response(), numeric_utils::Convolver::Mode::Auto,
+        fft_padding_);
+  }
+  if (deterministic_cache_) {
+    highpass_filter_ = highpass_filter;
+  }
+
+  // Random streams of the archived call are restored
+  stream_seed_ = contents["streamSeed"].get<std::uint64_t>();
+  if (phase_field_) {
+    phase_seed_ = contents["phaseSeed"].get<std::uint64_t>();
+  }
+  return generate_range(contents["units"].get<bool>(), identified_parameters,
+                        *highpass_filter, first_record, num_records);
+}
+
+void stochastic::VlachosEtAl::set_synthesis_method(SynthesisMethod method,
+                                                   unsigned int window_length) {
+  if (method == SynthesisMethod::OverlapAddFFT &&
+      (window_length < 2 || window_length % 2 != 0)) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::set_synthesis_method: Window "
+        "length must be a positive even number of time steps\n");
+  }
+
+  synthesis_method_ = method;
+  window_length_ = window_length;
+}
+
+void stochastic::VlachosEtAl::set_fft_padding(bool fft_padding) {
+  fft_padding_ = fft_padding;
+  highpass_filter_.reset();
+}
+
+void stochastic::VlachosEtAl::set_deterministic_cache(
+    bool deterministic_cache) {
+  deterministic_cache_ = deterministic_cache;
+  if (!deterministic_cache) {
+    std::vector<double>().swap(frequencies_);
+    std::vector<double>().swap(highpass_butter_energy_);
+    highpass_filter_.reset();
+  }
+}
+
+void stochastic::VlachosEtAl::set_phase_field(
+    std::shared_ptr<const numeric_utils::SpatialCorrelation> phase_field,
+    std::size_t site, std::uint64_t seed) {
+  if (phase_field && site >= phase_field->num_sites()) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::set_phase_field: Site is not "
+        "a site of the phase field\n");
+  }
+  phase_field_ = std::move(phase_field);
+  phase_site_ = site;
+  phase_seed_ = seed;
+}
+
+void stochastic::VlachosEtAl::set_low_rank_tolerance(double tolerance) {
+  if (tolerance < 0.0 || tolerance >= 1.0) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::set_low_rank_tolerance: "
+        "Tolerance must be in the range [0, 1)\n");
+  }
+
+  low_rank_tolerance_ = tolerance;
+}
+
 bool stochastic::VlachosEtAl::time_history_family(
     std::vector<std::vector<double>>& time_histories,
-    const Eigen::VectorXd& parameters) const {
+    const Eigen::VectorXd& parameters, unsigned int spectrum_index) {
   bool status = true;
   auto identified_parameters = identify_parameters(parameters);
-  
-  unsigned int num_times =
-      static_cast<unsigned int>(std::ceil(identified_parameters[17] / time_step_)) + 1;
-  unsigned int num_freqs =
-      static_cast<unsigned int>(std::ceil(cutoff_freq_ / freq_step_)) + 1;
+  auto power_spectrum = evolutionary_power_spectrum(identified_parameters);
+  numeric_utils::Convolver highpass_filter(
+      highpass_impulse_response(), numeric_utils::Convolver::Mode::Auto,
+      fft_padding_);
+
+  try {
+    // Factors of spectrum are shared by all time histories in family
+    Eigen::MatrixXd time_modulation, frequency_shapes;
+    if (synthesis_method_ == SynthesisMethod::LowRank) {
+      factor_spectrum(power_spectrum, time_modulation, frequency_shapes);
+    }
+
+    // Generate family of time histories
+    time_histories.resize(num_sims_);
+    utilities::parallel_for(num_sims_, num_threads_, [&](unsigned int i) {
+      simulate_family_member(time_histories[i], power_spectrum,
+                             time_modulation, frequency_shapes,
+                             highpass_filter, spectrum_index, i);
+    });
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    status = false;
+    throw;
+  }
+
+  return status;
+}
+
+Eigen::MatrixXd stochastic::VlachosEtAl::evolutionary_power_spectrum(
+    const Eigen::VectorXd& identified_parameters) const {
+  SMELT_PROFILE_STAGE("powerSpectrum");
+  unsigned int num_times = num_time_steps(identified_parameters);
 
   std::vector<double> times(num_times);
-  std::vector<double> frequencies(num_freqs);
   double total_time = (num_times - 1) * time_step_;
   
   for (unsigned int i = 0; i < times.size(); ++i) {
@@ -511,9 +985,18 @@ bool stochastic::VlachosEtAl::time_history_family(
   }
   times[0] = 1E-6;
 
-  for (unsigned int i = 0; i < frequencies.size(); ++i) {
-    frequencies[i] = i * freq_step_;
+  // Frequencies and filter energy do not depend on parameters, so cached
+  // values are used when available
+  std::vector<double> computed_frequencies, computed_energy;
+  if (frequencies_.empty()) {
+    computed_frequencies = spectrum_frequencies();
+    computed_energy = highpass_butter_energy(computed_frequencies);
   }
+  const std::vector<double>& frequencies =
+      frequencies_.empty() ? computed_frequencies : frequencies_;
+  const std::vector<double>& highpass_energy =
+      frequencies_.empty() ? computed_energy : highpass_butter_energy_;
+  unsigned int num_freqs = frequencies.size();
 
   // Calculate non-dimensional energy accumulation
   auto energy = energy_accumulation(
@@ -543,6 +1026,58 @@ bool stochastic::VlachosEtAl::time_history_family(
       std::vector<double>{identified_parameters[0], identified_parameters[1]},
       times);
 
+  // Calculate the evolutionary power spectrum with unit variance at each
+  // time step. The K-T model is evaluated for all times at once, one
+  // frequency at a time, writing each contiguous column of the spectrum and
+  // accumulating the trapezoidal integrals over frequency of all times.
+  Eigen::Map<const Eigen::ArrayXd> mode_1(mode_1_freqs.data(), num_times);
+  Eigen::Map<const Eigen::ArrayXd> mode_2(mode_2_freqs.data(), num_times);
+  Eigen::Map<const Eigen::ArrayXd> participation(mode_2_participation.data(),
+                                                 num_times);
+  Eigen::Map<const Eigen::ArrayXd> modulation(amplitude_modulation.data(),
+                                              num_times);
+  double damping_1 =
+      4.0 * identified_parameters[8] * identified_parameters[8];
+  double damping_2 =
+      4.0 * identified_parameters[9] * identified_parameters[9];
+
+  Eigen::MatrixXd power_spectrum(num_times, num_freqs);
+  Eigen::ArrayXd ratio_sq(num_times);
+  Eigen::ArrayXd freq_domain_integrals = Eigen::ArrayXd::Zero(num_times);
+
+  for (unsigned int j = 0; j < num_freqs; ++j) {
+    auto column = power_spectrum.col(j).array();
+    ratio_sq = (frequencies[j] / mode_1).square();
+    column = (1.0 + damping_1 * ratio_sq) /
+             ((1.0 - ratio_sq).square() + damping_1 * ratio_sq);
+    ratio_sq = (frequencies[j] / mode_2).square();
+    column += participation * (1.0 + damping_2 * ratio_sq) /
+              ((1.0 - ratio_sq).square() + damping_2 * ratio_sq);
+    column *= highpass_energy[j];
+
+    double weight = j == 0 || j == num_freqs - 1 ? 0.5 : 1.0;
+    freq_domain_integrals += weight * column;
+  }
+
+  // Normalize each time step by twice its integral over frequency
+  freq_domain_integrals *= 2.0 * freq_step_;
+  power_spectrum.array().colwise() *= modulation / freq_domain_integrals;
+
+  return power_spectrum;
+}
+
+std::vector<double> stochastic::VlachosEtAl::spectrum_frequencies() const {
+  unsigned int num_freqs =
+      static_cast<unsigned int>(std::ceil(cutoff_freq_ / freq_step_)) + 1;
+  std::vector<double> frequencies(num_freqs);
+  for (unsigned int i = 0; i < frequencies.size(); ++i) {
+    frequencies[i] = i * freq_step_;
+  }
+  return frequencies;
+}
+
+std::vector<double> stochastic::VlachosEtAl::highpass_butter_energy(
+    const std::vector<double>& frequencies) const {
   // Parameters for high-pass Butterworth filter
   int filter_order = 4;
   double norm_cutoff_freq = 0.20;
@@ -555,25 +1090,13 @@ bool stochastic::VlachosEtAl::time_history_family(
                              2 * filter_order);
     highpass_butter_energy[i] = freq_ratio_sq / (1.0 + freq_ratio_sq);
   }
+  return highpass_butter_energy;
+}
 
-  // Calculate the evolutionary power spectrum with unit variance at
-  // each time step
-  Eigen::MatrixXd power_spectrum(times.size(), frequencies.size());
-
-  for (unsigned int i = 0; i < times.size(); ++i) {
-    power_spectrum.row(i) =
-        kt_2(std::vector<double>{mode_1_freqs[i], identified_parameters[8], 1.0,
-                                 mode_2_freqs[i], identified_parameters[9],
-                                 mode_2_participation[i]},
-             frequencies, highpass_butter_energy);
-
-    double freq_domain_integral =
-      2.0 * numeric_utils::trapazoid_rule(power_spectrum.row(i), freq_step_);
-    
-    power_spectrum.row(i) =
-        power_spectrum.row(i) * amplitude_modulation[i] / freq_domain_integral;
-
-  }
+std::vector<double> stochastic::VlachosEtAl::highpass_impulse_response() const {
+  // Parameters for high-pass Butterworth filter
+  int filter_order = 4;
+  double norm_cutoff_freq = 0.20;
 
   // Get coefficients for highpass Butterworth filter  
   int num_samples =
@@ -582,69 +1105,82 @@ bool stochastic::VlachosEtAl::time_history_family(
                            time_step_ +
                        1);
 
-  auto hp_butter =
-      Dispatcher<std::vector<std::vector<double>>, int, double>::instance()
-          ->dispatch("HighPassButter", filter_order,
-                     norm_cutoff_freq / (1.0 / time_step_ / 2.0));
-
-  // Calculate filter impulse response for calculated number of samples
-  auto impulse_response =
-      Dispatcher<std::vector<double>, std::vector<double>, std::vector<double>,
-                 int, int>::instance()
-          ->dispatch("ImpulseResponse", hp_butter[0], hp_butter[1],
-                     filter_order, num_samples);
-  
-  try {
-    // Generate family of time histories
-    for (unsigned int i = 0; i < num_sims_; ++i) {
-      simulate_time_history(time_histories[i], power_spectrum);
-      post_process(time_histories[i], impulse_response);
-    }
-  } catch (const std::exception& e) {
-    std::cerr << e.what();
-    status = false;
-    throw;
-  }
+  // Impulse response for calculated number of samples is shared by all
+  // records with the same time step
+  return *signal_processing::FilterBank::highpass_impulse_response(
+      filter_order, norm_cutoff_freq / (1.0 / time_step_ / 2.0), num_samples);
+}
 
-  return status;
+unsigned int stochastic::VlachosEtAl::num_time_steps(
+    const Eigen::VectorXd& identified_parameters) const {
+  return static_cast<unsigned int>(
+             std::ceil(identified_parameters[17] / time_step_)) +
+         1;
+}
+
+void stochastic::VlachosEtAl::simulate_family_member(
+    std::vector<double>& time_history, const Eigen::MatrixXd& power_spectrum,
+    const Eigen::MatrixXd& time_modulation,
+    const Eigen::MatrixXd& frequency_shapes,
+    const numeric_utils::Convolver& highpass_filter,
+    unsigned int spectrum_index, unsigned int sim_index) const {
+  synthesize_family_member(time_history, power_spectrum, time_modulation,
+                           frequency_shapes, spectrum_index, sim_index);
+  post_process(time_history, highpass_filter);
+}
+
+void stochastic::VlachosEtAl::synthesize_family_member(
+    std::vector<double>& time_history, const Eigen::MatrixXd& power_spectrum,
+    const Eigen::MatrixXd& time_modulation,
+    const Eigen::MatrixXd& frequency_shapes, unsigned int spectrum_index,
+    unsigned int sim_index) const {
+  SMELT_PROFILE_STAGE("synthesis");
+  if (synthesis_method_ == SynthesisMethod::LowRank) {
+    low_rank_synthesis(
+        time_history, time_modulation, frequency_shapes,
+        generate_phase_angles(power_spectrum.cols(), spectrum_index, sim_index));
+  } else {
+    simulate_time_history(time_history, power_spectrum, spectrum_index,
+                          sim_index);
+  }
 }
 
 void stochastic::VlachosEtAl::simulate_time_history(
-    std::vector<double>& time_history,
-    const Eigen::MatrixXd& power_spectrum) const {
+    std::vector<double>& time_history, const Eigen::MatrixXd& power_spectrum,
+    unsigned int spectrum_index, unsigned int sim_index) const {
   unsigned int num_times = power_spectrum.rows(),
                num_freqs = power_spectrum.cols();
 
-  time_history.resize(num_times, 0.0);
+  // Reused buffers may hold a previous record
+  time_history.assign(num_times, 0.0);
 
-  std::vector<double> times(num_times);
-  std::vector<double> frequencies(num_freqs);
+  auto& arena = utilities::ScratchArena::local();
+  utilities::ScratchArena::Scope scope(arena);
+  double* times = arena.allocate<double>(num_times);
+  double* frequencies = arena.allocate<double>(num_freqs);
 
-  for (unsigned int i = 0; i < times.size(); ++i) {
+  for (unsigned int i = 0; i < num_times; ++i) {
     times[i] = i * time_step_;
   }
 
-  for (unsigned int i = 0; i < frequencies.size(); ++i) {
+  for (unsigned int i = 0; i < num_freqs; ++i) {
     frequencies[i] = i * freq_step_;
   }
 
-  static unsigned int history_seed = static_cast<unsigned int>(std::time(nullptr));
-  history_seed = history_seed + 10;
-  
-  auto generator =
-    seed_value_ != std::numeric_limits<int>::infinity()
-    ? boost::random::mt19937(static_cast<unsigned int>(seed_value_ + 10))
-    : boost::random::mt19937(history_seed);
-
-  boost::random::uniform_real_distribution<> distribution(0.0, 2.0 * M_PI);
-  boost::random::variate_generator<boost::random::mt19937&,
-                                   boost::random::uniform_real_distribution<>>
-      angle_gen(generator, distribution);
+  auto phase_angle =
+      generate_phase_angles(num_freqs, spectrum_index, sim_index);
 
-  std::vector<double> phase_angle(num_freqs, 0.0);
+  if (synthesis_method_ == SynthesisMethod::OverlapAddFFT) {
+    overlap_add_synthesis(time_history, power_spectrum, phase_angle);
+    return;
+  }
 
-  for (auto & angle : phase_angle) {
-    angle = angle_gen();
+  if (synthesis_method_ == SynthesisMethod::LowRank) {
+    Eigen::MatrixXd time_modulation, frequency_shapes;
+    factor_spectrum(power_spectrum, time_modulation, frequency_shapes);
+    low_rank_synthesis(time_history, time_modulation, frequency_shapes,
+                       phase_angle);
+    return;
   }
 
   // Loop over all frequencies and times to calculate time history
@@ -659,14 +1195,380 @@ void stochastic::VlachosEtAl::simulate_time_history(
   }
 }
 
+void stochastic::VlachosEtAl::overlap_add_synthesis(
+    std::vector<double>& time_history, const Eigen::MatrixXd& power_spectrum,
+    const std::vector<double>& phase_angles) const {
+  int num_times = static_cast<int>(power_spectrum.rows());
+  unsigned int num_freqs = power_spectrum.cols();
+  unsigned int fft_length = overlap_add_fft_length();
+  int hop_size = static_cast<int>(window_length_ / 2);
+
+  if (window_length_ > fft_length || 2 * (num_freqs - 1) >= fft_length) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosEtAl::overlap_add_synthesis: Window "
+        "length or number of frequencies too large for inverse FFT length\n");
+  }
+
+  time_history.assign(num_times, 0.0);
+
+  auto& arena = utilities::ScratchArena::local();
+  utilities::ScratchArena::Scope scope(arena);
+
+  // Periodic Hann window, which sums to one when overlapped by half its length
+  double* window = arena.allocate<double>(window_length_);
+  for (unsigned int i = 0; i < window_length_; ++i) {
+    window[i] = 0.5 * (1.0 - std::cos(2.0 * M_PI * i / window_length_));
+  }
+
+  // Only non-redundant half of conjugate-even spectrum is stored
+  unsigned int spectrum_size = fft_length / 2 + 1;
+  std::complex<double>* spectrum =
+      arena.allocate<std::complex<double>>(spectrum_size);
+  double* segment = arena.allocate<double>(fft_length);
+  double amplitude_factor = 2.0 * std::sqrt(freq_step_);
+
+  // First window starts half a window before the record so every time step
+  // is covered by exactly two windows
+  for (int start = -hop_size; start < num_times; start += hop_size) {
+    // Use spectrum at centre of part of window that lies within record
+    int centre = (std::max(start, 0) +
+                  std::min(start + static_cast<int>(window_length_), num_times) -
+                  1) / 2;
+    double start_time = start * time_step_;
+
+    // Conjugate-even spectrum scaled so that inverse FFT returns the sum of
+    // cosines over the window, with phases anchored at window start
+    std::fill(spectrum, spectrum + spectrum_size,
+              std::complex<double>(0.0, 0.0));
+    spectrum[0] = fft_length * std::sqrt(power_spectrum(centre, 0)) *
+                  std::cos(phase_angles[0]);
+    for (unsigned int j = 1; j < num_freqs; ++j) {
+      spectrum[j] =
+          0.5 * fft_length * std::sqrt(power_spectrum(centre, j)) *
+          std::polar(1.0, j * freq_step_ * start_time + phase_angles[j]);
+    }
+
+    numeric_utils::inverse_real_fft(spectrum, fft_length, segment);
+
+    for (int i = std::max(0, -start);
+         i < static_cast<int>(window_length_) && start + i < num_times; ++i) {
+      time_history[start + i] += amplitude_factor * window[i] * segment[i];
+    }
+  }
+}
+
+double stochastic::VlachosEtAl::overlap_add_error_bound(
+    const Eigen::MatrixXd& power_spectrum) const {
+  int num_times = static_cast<int>(power_spectrum.rows());
+  unsigned int num_freqs = power_spectrum.cols();
+  int hop_size = static_cast<int>(window_length_ / 2);
+  double freq_mismatch =
+      std::abs(freq_step_ - 2.0 * M_PI / (overlap_add_fft_length() * time_step_));
+
+  Eigen::MatrixXd amplitudes = power_spectrum.array().sqrt().matrix();
+  Eigen::VectorXd freq_indices =
+      Eigen::VectorXd::LinSpaced(num_freqs, 0.0, num_freqs - 1.0);
+  std::vector<double> sample_error(num_times, 0.0);
+
+  for (int start = -hop_size; start < num_times; start += hop_size) {
+    int first = std::max(start, 0);
+    int last = std::min(start + static_cast<int>(window_length_), num_times);
+    int centre = (first + last - 1) / 2;
+
+    // Phase drift grows linearly from window start
+    double drift_rate =
+        freq_mismatch * time_step_ * amplitudes.row(centre).dot(freq_indices);
+
+    for (int i = first; i < last; ++i) {
+      double window_weight =
+          0.5 * (1.0 - std::cos(2.0 * M_PI * (i - start) / window_length_));
+      sample_error[i] +=
+          window_weight *
+          ((amplitudes.row(i) - amplitudes.row(centre)).cwiseAbs().sum() +
+           drift_rate * (i - start));
+    }
+  }
+
+  return 2.0 * std::sqrt(freq_step_) *
+         *std::max_element(sample_error.begin(), sample_error.end());
+}
+
+std::vector<double> stochastic::VlachosEtAl::generate_phase_angles(
+    unsigned int num_freqs, unsigned int spectrum_index,
+    unsigned int sim_index) const {
+  std::vector<double> phase_angle(num_freqs, 0.0);
+
+  if (phase_field_) {
+    // Component 0 of the streams of the field is left to other variables
+    // of the sites, such as model parameters
+    std::vector<std::size_t> rows;
+    std::vector<double> weights;
+    phase_field_->site_weights(phase_site_, rows, weights);
+    std::vector<numeric_utils::RandomStream> streams;
+    streams.reserve(rows.size());
+    for (auto row : rows) {
+      streams.emplace_back(phase_seed_, spectrum_index, sim_index,
+                           static_cast<std::uint32_t>(row + 1));
+    }
+
+    // Correlated standard normal variables are mapped to uniform phase
+    // angles through the standard normal distribution function
+    for (auto & angle : phase_angle) {
+      double variable = 0.0;
+      for (std::size_t i = 0; i < streams.size(); ++i) {
+        variable += weights[i] * streams[i].normal();
+      }
+      angle = M_PI * std::erfc(-variable / std::sqrt(2.0));
+    }
+    return phase_angle;
+  }
+
+  numeric_utils::RandomStream stream(stream_seed_, spectrum_index, sim_index);
+
+  for (auto & angle : phase_angle) {
+    angle = 2.0 * M_PI * stream.uniform();
+  }
+
+  return phase_angle;
+}
+
+bool stochastic::VlachosEtAl::factor_spectrum(
+    const Eigen::MatrixXd& power_spectrum, Eigen::MatrixXd& time_modulation,
+    Eigen::MatrixXd& frequency_shapes) const {
+  SMELT_PROFILE_STAGE("spectrumFactorization");
+  Eigen::MatrixXd amplitudes = power_spectrum.array().sqrt().matrix();
+  unsigned int max_rank = std::min(amplitudes.rows(), amplitudes.cols());
+  double total_energy = amplitudes.squaredNorm();
+  double allowed_error =
+      low_rank_tolerance_ * low_rank_tolerance_ * total_energy;
+
+  // Fixed seed for test matrix so factorization is deterministic
+  boost::random::mt19937 generator(0);
+  boost::random::normal_distribution<double> distribution(0.0, 1.0);
+
+  unsigned int rank = std::min(8u, max_rank);
+
+  // Randomized range finder, doubling number of samples until the retained
+  // singular values capture required fraction of energy
+  while (true) {
+    unsigned int num_samples = std::min(rank + 5, max_rank);
+    Eigen::MatrixXd test_matrix(amplitudes.cols(), num_samples);
+    for (unsigned int i = 0; i < test_matrix.size(); ++i) {
+      test_matrix(i) = distribution(generator);
+    }
+
+    // Single power iteration to sharpen singular value decay
+    Eigen::HouseholderQR<Eigen::MatrixXd> range_qr(amplitudes * test_matrix);
+    Eigen::MatrixXd basis =
+        range_qr.householderQ() *
+        Eigen::MatrixXd::Identity(amplitudes.rows(), num_samples);
+    range_qr.compute(amplitudes * (amplitudes.transpose() * basis));
+    basis = range_qr.householderQ() *
+            Eigen::MatrixXd::Identity(amplitudes.rows(), num_samples);
+
+    Eigen::MatrixXd projection = basis.transpose() * amplitudes;
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(
+        projection, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    Eigen::VectorXd singular_values = svd.singularValues();
+
+    // Squared Frobenius error of truncation at rank k is total energy less
+    // sum of squares of first k singular values of projection. This loses
+    // accuracy for tolerances near the square root of machine precision, so
+    // the residual of the selected rank is checked directly.
+    double captured_energy = 0.0;
+    for (unsigned int k = 0; k < singular_values.size(); ++k) {
+      captured_energy += singular_values(k) * singular_values(k);
+      bool full_rank =
+          k + 1 == singular_values.size() && num_samples == max_rank;
+      if (total_energy - captured_energy <= allowed_error || full_rank) {
+        time_modulation = basis * svd.matrixU().leftCols(k + 1) *
+                          singular_values.head(k + 1).asDiagonal();
+        frequency_shapes = svd.matrixV().leftCols(k + 1);
+        if (full_rank ||
+            (amplitudes - time_modulation * frequency_shapes.transpose())
+                    .squaredNorm() <= allowed_error) {
+          return true;
+        }
+      }
+    }
+
+    rank = std::min(2 * rank, max_rank);
+  }
+}
+
+void stochastic::VlachosEtAl::low_rank_synthesis(
+    std::vector<double>& time_history, const Eigen::MatrixXd& time_modulation,
+    const Eigen::MatrixXd& frequency_shapes,
+    const std::vector<double>& phase_angles) const {
+  int num_times = static_cast<int>(time_modulation.rows());
+  int num_freqs = static_cast<int>(frequency_shapes.rows());
+  double angle_step = freq_step_ * time_step_;
+
+  // Each term is a stationary sum over frequencies at angles j * n * dw * dt,
+  // which are evaluated exactly as a chirp-z transform by writing
+  // j * n = (j^2 + n^2 - (n - j)^2) / 2 and convolving with FFTs
+  unsigned int min_length = num_times + num_freqs - 1;
+  unsigned int fft_length = 1;
+  if (fft_padding_) {
+    fft_length = numeric_utils::smooth_fft_length(min_length);
+  }
+  while (fft_length < min_length) {
+    fft_length *= 2;
+  }
+
+  std::vector<double> chirp_real(fft_length, 0.0), chirp_imag(fft_length, 0.0);
+  for (int i = 1 - num_freqs; i < num_times; ++i) {
+    double angle = -0.5 * angle_step * i * i;
+    unsigned int index = (i + static_cast<int>(fft_length)) % fft_length;
+    chirp_real[index] = std::cos(angle);
+    chirp_imag[index] = std::sin(angle);
+  }
+
+  // Transforms of real sequences are conjugate-even, so only their
+  // non-redundant halves are computed and combined
+  unsigned int num_fft_freqs = fft_length / 2 + 1;
+  std::vector<std::complex<double>> chirp_real_fft(num_fft_freqs),
+      chirp_imag_fft(num_fft_freqs);
+  numeric_utils::real_fft(chirp_real.data(), fft_length,
+                          chirp_real_fft.data());
+  numeric_utils::real_fft(chirp_imag.data(), fft_length,
+                          chirp_imag_fft.data());
+
+  // Random phases combined with chirp at each frequency
+  std::vector<std::complex<double>> phase_factors(num_freqs);
+  for (int j = 0; j < num_freqs; ++j) {
+    phase_factors[j] =
+        std::polar(1.0, phase_angles[j] + 0.5 * angle_step * j * j);
+  }
+
+  std::vector<double> weights_real(fft_length), weights_imag(fft_length);
+  std::vector<std::complex<double>> weights_real_fft(num_fft_freqs),
+      weights_imag_fft(num_fft_freqs);
+  std::vector<std::complex<double>> conv_real_fft(num_fft_freqs),
+      conv_imag_fft(num_fft_freqs);
+  std::vector<double> conv_real(fft_length), conv_imag(fft_length);
+
+  time_history.assign(num_times, 0.0);
+
+  for (unsigned int r = 0; r < time_modulation.cols(); ++r) {
+    std::fill(weights_real.begin(), weights_real.end(), 0.0);
+    std::fill(weights_imag.begin(), weights_imag.end(), 0.0);
+    for (int j = 0; j < num_freqs; ++j) {
+      weights_real[j] = frequency_shapes(j, r) * phase_factors[j].real();
+      weights_imag[j] = frequency_shapes(j, r) * phase_factors[j].imag();
+    }
+
+    numeric_utils::real_fft(weights_real.data(), fft_length,
+                            weights_real_fft.data());
+    numeric_utils::real_fft(weights_imag.data(), fft_length,
+                            weights_imag_fft.data());
+
+    // Complex convolution split into real and imaginary parts
+    for (unsigned int k = 0; k < num_fft_freqs; ++k) {
+      conv_real_fft[k] = weights_real_fft[k] * chirp_real_fft[k] -
+                         weights_imag_fft[k] * chirp_imag_fft[k];
+      conv_imag_fft[k] = weights_real_fft[k] * chirp_imag_fft[k] +
+                         weights_imag_fft[k] * chirp_real_fft[k];
+    }
+
+    numeric_utils::inverse_real_fft(conv_real_fft.data(), fft_length,
+                                    conv_real.data());
+    numeric_utils::inverse_real_fft(conv_imag_fft.data(), fft_length,
+                                    conv_imag.data());
+
+    for (int i = 0; i < num_times; ++i) {
+      double angle = 0.5 * angle_step * i * i;
+      time_history[i] +=
+          time_modulation(i, r) *
+          (std::cos(angle) * conv_real[i] - std::sin(angle) * conv_imag[i]);
+    }
+  }
+
+  for (auto& value : time_history) {
+    value = 2.0 * std::sqrt(freq_step_) * value;
+  }
+}
+
+unsigned int stochastic::VlachosEtAl::overlap_add_fft_length() const {
+  return static_cast<unsigned int>(
+      std::round(2.0 * M_PI / (freq_step_ * time_step_)));
+}
+
 bool stochastic::VlachosEtAl::post_process(
     std::vector<double>& time_history,
     const std::vector<double>& filter_imp_resp) const {
+  return post_process(time_history, numeric_utils::Convolver(filter_imp_resp));
+}
+
+bool stochastic::VlachosEtAl::post_process(
+    std::vector<double>& time_history,
+    const numeric_utils::Convolver& highpass_filter) const {
   
   bool status = true;
-  double time_hann_2 = 1.0;
+  demean_and_taper(time_history);
+
+  // Apply 4th order Butterworth filter
+  std::vector<double> filtered_history;
+  try {
+    highpass_filter.convolve(time_history, filtered_history);
+  } catch (const std::exception& e) {
+    std::cerr << e.what();
+    status = false;
+    throw;
+  }
+  
+  // Move filtered results to time_history
+  time_history = std::move(filtered_history);
+  
+  return status;
+}
+
+void stochastic::VlachosEtAl::post_process(
+    std::vector<double>& time_history,
+    const numeric_utils::Convolver& highpass_filter,
+    std::vector<double>& x_accels, std::vector<double>& y_accels,
+    bool g_units) const {
+  std::size_t num_steps =
+      time_history.size() + highpass_filter.kernel_size() - 1;
+  x_accels.resize(num_steps);
+  y_accels.resize(num_steps);
+  post_process(time_history, highpass_filter, x_accels.data(),
+               y_accels.data(), g_units);
+}
+
+void stochastic::VlachosEtAl::post_process(
+    std::vector<double>& time_history,
+    const numeric_utils::Convolver& highpass_filter, double* x_accels,
+    double* y_accels, bool g_units) const {
+  SMELT_PROFILE_STAGE("filtering");
+  demean_and_taper(time_history);
+
+  // Filter directly into x-component, which is rotated in place below
+  std::size_t num_steps =
+      time_history.size() + highpass_filter.kernel_size() - 1;
+  highpass_filter.convolve(time_history.data(), time_history.size(),
+                           x_accels);
+
+  // Division by conversion factor converts either to m/s^2 or g
+  double conversion_factor = g_units ? 100.0 * 9.81 : 100.0;
+  if (std::abs(orientation_) < 1E-6) {
+    for (std::size_t i = 0; i < num_steps; ++i) {
+      x_accels[i] = x_accels[i] / conversion_factor;
+      y_accels[i] = 0.0;
+    }
+  } else {
+    double x_factor = std::cos(orientation_ * M_PI / 180.0) / conversion_factor;
+    double y_factor = std::sin(orientation_ * M_PI / 180.0) / conversion_factor;
+    for (std::size_t i = 0; i < num_steps; ++i) {
+      y_accels[i] = y_factor * x_accels[i];
+      x_accels[i] = x_factor * x_accels[i];
+    }
+  }
+}
 
-  Eigen::VectorXd window = Eigen::VectorXd::Ones(time_history.size());
+void stochastic::VlachosEtAl::demean_and_taper(
+    std::vector<double>& time_history) const {
+  double time_hann_2 = 1.0;
   unsigned int window1_size =
       static_cast<unsigned int>(time_hann_2 / time_step_ + 1);
   unsigned int window2_size = static_cast<unsigned int>((window1_size - 1) / 2);
@@ -679,41 +1581,34 @@ bool stochastic::VlachosEtAl::post_process(
   }
 
   // Get Hanning window of length window1_size
-  auto hann_window =
-      Dispatcher<Eigen::VectorXd, unsigned int>::instance()->dispatch(
-          "HannWindow", window1_size);
-
-  window.head(window2_size) = hann_window.head(window2_size);
-  window.tail(window2_size) = hann_window.head(window2_size).reverse();
+  auto hann_window = signal_processing::FilterBank::hann_window(window1_size);
+  const std::vector<double>& hann = *hann_window;
 
   // Calculate mean of time history
-  double mean = std::accumulate(time_history.begin(), time_history.end(), 0.0) /
-                static_cast<double>(time_history.size());
-
-  // Apply window
-  for (unsigned int i = 0; i < time_history.size(); ++i) {
-    time_history[i] = window[i] * (time_history[i] - mean);
+  std::size_t num_steps = time_history.size();
+  double mean = 0.0;
+  for (std::size_t i = 0; i < num_steps; ++i) {
+    mean += time_history[i];
   }
+  mean = mean / static_cast<double>(num_steps);
 
-  // Apply 4th order Butterworth filter
-  std::vector<double> filtered_history(filter_imp_resp.size() +
-                                       time_history.size() - 1);
-  try {
-    numeric_utils::convolve_1d(filter_imp_resp, time_history, filtered_history);
-  } catch (const std::exception& e) {
-    std::cerr << e.what();
-    status = false;
-    throw;
+  // Remove mean, weighting only the tapered edges by the window
+  for (std::size_t i = 0; i < window2_size; ++i) {
+    time_history[i] = hann[i] * (time_history[i] - mean);
+  }
+  for (std::size_t i = window2_size; i < num_steps - window2_size; ++i) {
+    time_history[i] = time_history[i] - mean;
+  }
+  for (std::size_t i = 0; i < window2_size; ++i) {
+    time_history[num_steps - 1 - i] =
+        hann[i] * (time_history[num_steps - 1 - i] - mean);
   }
-  
-  // Copy filtered results to time_history
-  time_history = filtered_history;
-  
-  return status;
 }
 
 Eigen::VectorXd stochastic::VlachosEtAl::identify_parameters(
-    const Eigen::VectorXd& initial_params) const {
+    const Eigen::VectorXd& initial_params, unsigned int max_block_size) {
+  SMELT_PROFILE_STAGE("parameterIdentification");
+
   // Initialize non-dimensional cumulative energy
   std::vector<double> energy(static_cast<unsigned int>(1.0 / 0.05) + 1, 0.0);
 
@@ -721,94 +1616,83 @@ Eigen::VectorXd stochastic::VlachosEtAl::identify_parameters(
     energy[i] = energy[i - 1] + 0.05;
   }
 
-  // Initialze mode 1 parameters and frequencies
-  std::vector<double> mode_1_params = {initial_params(2),
-				       initial_params(3),
-				       initial_params(4)};
-  auto mode_1_freqs = modal_frequencies(mode_1_params, energy);
-
-  // Initialize mode 2 parameters and frequencies
-  std::vector<double> mode_2_params = {initial_params(5),
-				       initial_params(6),
-				       initial_params(7)};
-  auto mode_2_freqs = modal_frequencies(mode_2_params, energy);
-
-  double mode_1_mean = initial_params(11), mode_2_mean = initial_params(14);
+  Eigen::ArrayXd energy_terms_1(energy.size()), energy_terms_2(energy.size());
+  for (unsigned int i = 0; i < energy.size(); ++i) {
+    energy_terms_1(i) = 0.5 + energy[i];
+    energy_terms_2(i) = 1.5 - energy[i];
+  }
 
-  // Standard normal distribution with mean at 0.0 and standard deviation of 1.0
-  auto std_normal_dist =
-      Factory<stochastic::Distribution, double, double>::instance()->create(
-          "NormalDist", std::move(0.0), std::move(1.0));  
-
-  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> realizations(
-      initial_params.size(), 1);
-  Eigen::VectorXd transformed_realizations = initial_params;
-
-  // Check if any mode 1 dominant frequencies across all non-dimensional energy
-  // values are greater than the corresponding values for mode 2
-  bool freq_comparison = false;
-  for (unsigned int i = 0; i < mode_1_freqs.size(); ++i) {
-    if (mode_1_freqs[i] > mode_2_freqs[i]) {
-      freq_comparison = true;
-      break;
+  // Check whether parameters satisfy constraints that mode 1 dominant
+  // frequencies are not greater than the corresponding values for mode 2 for
+  // all non-dimensional energy values and that the mode 1 mean is not
+  // greater than the mode 2 mean. Frequencies are evaluated as in
+  // modal_frequencies.
+  auto accepted = [&energy_terms_1,
+                   &energy_terms_2](const Eigen::VectorXd& params) -> bool {
+    if (params(11) > params(14)) {
+      return false;
     }
+    Eigen::ArrayXd mode_1_freqs = params(4) *
+                                  energy_terms_1.pow(params(2)) *
+                                  energy_terms_2.pow(params(3));
+    Eigen::ArrayXd mode_2_freqs = params(7) *
+                                  energy_terms_1.pow(params(5)) *
+                                  energy_terms_2.pow(params(6));
+    return !(mode_1_freqs > mode_2_freqs).any();
+  };
+
+  if (accepted(initial_params)) {
+    return initial_params;
   }
 
-  // Iterate until suitable parameter values have been identified
-  while (freq_comparison || (mode_1_mean > mode_2_mean)) {
-    
-    // Generate realizations of parameters
-    sample_generator_->generate(realizations, means_, covariance_, 1);
-    
-    // Transform parameter realizations to physical space
-    for (unsigned int i = 0; i < initial_params.size(); ++i) {
-      transformed_realizations(i) =
-          (model_parameters_[i]->inv_cumulative_dist_func(
-              std_normal_dist->cumulative_dist_func(
-                  std::vector<double>{realizations(i, 0)})))[0];
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> realizations;
+  Eigen::RowVectorXd parameter_values, physical_values;
+  unsigned int block_size = 1;
+  max_block_size = std::max(max_block_size, 1u);
+
+  // Iterate until suitable parameter values have been identified. Candidates
+  // are drawn in blocks that double in size after each rejected block. Since
+  // the generator returns the candidates of a block in the same order as
+  // drawing them one at a time, and candidates left over from the previous
+  // call are checked first, the accepted candidates are the same as for
+  // sequential sampling.
+  while (true) {
+    if (next_candidate_ == parameter_candidates_.cols()) {
+      // Generate realizations of parameters
+      SMELT_PROFILE_COUNT("parameterCandidates", block_size);
+      sample_generator_->generate(realizations, means_, covariance_,
+                                  block_size);
+
+      // Transform parameter realizations to physical space
+      parameter_candidates_.resize(initial_params.size(), block_size);
+      physical_values.resize(block_size);
+      for (unsigned int i = 0; i < initial_params.size(); ++i) {
+        parameter_values = realizations.row(i);
+        model_parameters_[i]->transform_from_std_normal(
+            parameter_values.data(), physical_values.data(), block_size);
+        parameter_candidates_.row(i) = physical_values;
+      }
+      next_candidate_ = 0;
+      block_size = std::min(2 * block_size, max_block_size);
     }
 
-    // Calculate dominant modal frequencies
-    mode_1_freqs =
-        modal_frequencies(std::vector<double>{transformed_realizations(2),
-                                              transformed_realizations(3),
-                                              transformed_realizations(4)},
-                          energy);
-
-    mode_2_params = {transformed_realizations(5), transformed_realizations(6),
-                     transformed_realizations(7)};
-    mode_2_freqs =
-        modal_frequencies(std::vector<double>{transformed_realizations(5),
-                                              transformed_realizations(6),
-                                              transformed_realizations(7)},
-                          energy);
-
-    mode_1_mean = transformed_realizations(11);
-    mode_2_mean = transformed_realizations(14);
-
-    // Check if any mode 1 dominant frequencies across all non-dimensional energy values
-    // are greater than the corresponding values for mode 2
-    freq_comparison = false;
-    for (unsigned int i = 0; i < mode_1_freqs.size(); ++i) {
-      if (mode_1_freqs[i] > mode_2_freqs[i]) {
-	freq_comparison = true;
-	break;
+    while (next_candidate_ < parameter_candidates_.cols()) {
+      if (accepted(parameter_candidates_.col(next_candidate_++))) {
+        return parameter_candidates_.col(next_candidate_ - 1);
       }
     }
   }
-
-  return transformed_realizations;
 }
 
 std::vector<double> stochastic::VlachosEtAl::modal_frequencies(
     const std::vector<double>& parameters,
     const std::vector<double>& energy) const {
   std::vector<double> frequencies(energy.size());
+  Eigen::Map<const Eigen::ArrayXd> energy_values(energy.data(), energy.size());
 
-  for (unsigned int i = 0; i < energy.size(); ++i) {
-    frequencies[i] = parameters[2] * std::pow(0.5 + energy[i], parameters[0]) *
-                     std::pow(1.5 - energy[i], parameters[1]);
-  }
+  Eigen::Map<Eigen::ArrayXd>(frequencies.data(), frequencies.size()) =
+      parameters[2] * (0.5 + energy_values).pow(parameters[0]) *
+      (1.5 - energy_values).pow(parameters[1]);
 
   return frequencies;
 }
@@ -817,12 +1701,12 @@ std::vector<double> stochastic::VlachosEtAl::energy_accumulation(
     const std::vector<double>& parameters,
     const std::vector<double>& times) const {
   std::vector<double> accumulated_energy(times.size());
+  Eigen::Map<const Eigen::ArrayXd> time_values(times.data(), times.size());
 
-  for (unsigned int i = 0; i < times.size(); ++i) {
-    accumulated_energy[i] =
-        std::exp(-std::pow(times[i] / parameters[0], -parameters[1])) /
-        std::exp(-std::pow(1.0 / parameters[0], -parameters[1]));
-  }
+  Eigen::Map<Eigen::ArrayXd>(accumulated_energy.data(),
+                             accumulated_energy.size()) =
+      (-(time_values / parameters[0]).pow(-parameters[1])).exp() /
+      std::exp(-std::pow(1.0 / parameters[0], -parameters[1]));
 
   return accumulated_energy;
 }
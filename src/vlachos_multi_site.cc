@@ -0,0 +1,86 @@
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "random_stream.h"
+#include "scenario_batch.h"
+#include "spatial_correlation.h"
+#include "vlachos_et_al.h"
+#include "vlachos_multi_site.h"
+
+namespace {
+constexpr unsigned int NUM_PARAMETERS = 18; /**< Parameters per spectrum */
+constexpr std::uint32_t SITE_SEED_SPECTRUM =
+    std::numeric_limits<std::uint32_t>::max(); /**< Spectrum index of the
+                                                  streams site seeds are
+                                                  taken from */
+}  // namespace
+
+stochastic::VlachosMultiSite::VlachosMultiSite(
+    double moment_magnitude, const std::vector<Site>& sites,
+    double orientation, unsigned int num_spectra, unsigned int num_sims,
+    double correlation_length, double taper_length, bool correlated_phases,
+    int seed_value) {
+  if (sites.empty()) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::VlachosMultiSite::VlachosMultiSite: At least "
+        "one site is required\n");
+  }
+
+  std::vector<double> x_coordinates, y_coordinates;
+  for (const auto& site : sites) {
+    x_coordinates.push_back(site.x);
+    y_coordinates.push_back(site.y);
+  }
+  correlation_ = std::make_shared<numeric_utils::SpatialCorrelation>(
+      x_coordinates, y_coordinates, correlation_length, taper_length);
+
+  // White noise of row j is drawn from component 0 of the stream of each
+  // spectrum and row, leaving other components to the phase fields
+  std::uint64_t region_seed = numeric_utils::stream_seed(seed_value);
+  Eigen::MatrixXd white_noise(sites.size(), num_spectra * NUM_PARAMETERS);
+  for (std::size_t j = 0; j < sites.size(); ++j) {
+    for (unsigned int k = 0; k < num_spectra; ++k) {
+      numeric_utils::RandomStream stream(region_seed, k,
+                                         static_cast<std::uint32_t>(j));
+      for (unsigned int p = 0; p < NUM_PARAMETERS; ++p) {
+        white_noise(j, k * NUM_PARAMETERS + p) = stream.normal();
+      }
+    }
+  }
+  Eigen::MatrixXd correlated = correlation_->correlate(white_noise);
+
+  // Each site draws its remaining random variables, such as independent
+  // phase angles, from streams keyed by a seed taken from a stream of the
+  // region indexed by site. The spectrum index of that stream is not used by
+  // the white noise or phase fields.
+  models_.reserve(sites.size());
+  for (std::size_t i = 0; i < sites.size(); ++i) {
+    Eigen::MatrixXd standard_normal_parameters(num_spectra, NUM_PARAMETERS);
+    for (unsigned int k = 0; k < num_spectra; ++k) {
+      standard_normal_parameters.row(k) =
+          correlated.block(i, k * NUM_PARAMETERS, 1, NUM_PARAMETERS);
+    }
+    numeric_utils::RandomStream site_stream(
+        region_seed, SITE_SEED_SPECTRUM, static_cast<std::uint32_t>(i));
+    std::uint64_t site_seed = site_stream();
+    site_seed = (site_seed << 32) | site_stream();
+    models_.push_back(std::make_shared<VlachosEtAl>(
+        moment_magnitude, sites[i].rupture_distance, sites[i].vs30,
+        orientation, standard_normal_parameters, num_sims, site_seed));
+    if (correlated_phases) {
+      models_.back()->set_phase_field(correlation_, i, region_seed);
+    }
+  }
+}
+
+void stochastic::VlachosMultiSite::add_scenarios(
+    ScenarioBatch& batch, const std::string& event_name) const {
+  for (std::size_t i = 0; i < models_.size(); ++i) {
+    batch.add_scenario(event_name + "_Site" + std::to_string(i), models_[i]);
+  }
+}
@@ -1,19 +1,74 @@
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
-// Boost random generator
-#include <boost/random/mersenne_twister.hpp>
-#include <boost/random/normal_distribution.hpp>
-#include <boost/random/variate_generator.hpp>
+#include <vector>
 // Eigen dense matrices
 #include <Eigen/Dense>
 
+#include "binary_file_writer.h"
+#include "device_backend.h"
 #include "function_dispatcher.h"
 #include "json_object.h"
 #include "numeric_utils.h"
+#include "parallel.h"
+#include "profiler.h"
+#include "random_stream.h"
+#include "record_iterator.h"
+#include "time_history_block.h"
 #include "wittig_sinha.h"
 
+namespace {
+/**
+ * Calculate velocity time histories at all vertical locations with one batch
+ * of real inverse Fast Fourier Transforms of the non-redundant halves of the
+ * full range of random numbers, as expressed in Equations 7 & 8
+ * @tparam Tscalar Floating-point type of random numbers and transforms
+ * @param[in] random_numbers Matrix of complex random numbers, with one column
+ *                           per vertical location
+ * @param[in] num_freqs Number of frequencies
+ * @param[in] units Indicates that time histories should be converted to ft/s
+ * @param[in, out] time_histories Matrix to write velocity time histories to
+ */
+template <typename Tscalar>
+void half_range_velocities(
+    const Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic,
+                        Eigen::Dynamic>& random_numbers,
+    unsigned int num_freqs, bool units,
+    Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>& time_histories) {
+  SMELT_PROFILE_STAGE("synthesis");
+
+  // Non-redundant halves of full range of random numbers for all locations,
+  // formed as in gen_location_hist
+  Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic, Eigen::Dynamic>
+      complex_half_ranges(num_freqs + 1, random_numbers.cols());
+  complex_half_ranges.row(0).setZero();
+  complex_half_ranges.middleRows(1, num_freqs - 1) =
+      random_numbers.topRows(num_freqs - 1);
+  complex_half_ranges.row(num_freqs) =
+      random_numbers.row(num_freqs - 1)
+          .cwiseAbs()
+          .template cast<std::complex<Tscalar>>();
+
+  // Calculate wind speeds at all locations with one batch of real inverse
+  // Fast Fourier Transforms
+  numeric_utils::inverse_real_fft(complex_half_ranges, 2 * num_freqs,
+                                  time_histories);
+
+  // Check if time histories need to be converted to ft/s
+  if (units) {
+    time_histories *= static_cast<Tscalar>(3.28084);
+  }
+}
+}  // namespace
+
 stochastic::WittigSinha::WittigSinha(std::string exposure_category,
                                      double gust_speed, double height,
                                      unsigned int num_floors, double total_time)
@@ -34,12 +89,8 @@ stochastic::WittigSinha::WittigSinha(std::string exposure_category,
           : static_cast<unsigned int>(std::ceil(total_time / time_step_) + 1);
 
   // Calculate range of frequencies based on cutoff frequency
-  num_freqs_ = num_times_ / 2;
-  frequencies_.resize(num_freqs_);
-
-  for (unsigned int i = 0; i < frequencies_.size(); ++i) {
-    frequencies_[i] = (i + 1) * freq_cutoff_ / num_freqs_;
-  }
+  first_frequency_ = 1;
+  initialize_frequencies();
   
   // Calculate heights of each floor
   heights_ = std::vector<double>(num_floors_);  
@@ -55,6 +106,8 @@ stochastic::WittigSinha::WittigSinha(std::string exposure_category,
                  double, std::vector<double>&>::instance()
           ->dispatch("ExposureCategoryVel", exposure_category, heights_, 0.4,
                      gust_speed, wind_velocities_);
+
+  initialize_cross_spectra();
 }
 
 stochastic::WittigSinha::WittigSinha(std::string exposure_category,
@@ -90,19 +143,17 @@ stochastic::WittigSinha::WittigSinha(std::string exposure_category,
           : static_cast<unsigned int>(std::ceil(total_time / time_step_) + 1);
 
   // Calculate range of frequencies based on cutoff frequency
-  num_freqs_ = num_times_ / 2;
-  frequencies_.resize(num_freqs_);
-
-  for (unsigned int i = 0; i < frequencies_.size(); ++i) {
-    frequencies_[i] = i * freq_cutoff_ / num_freqs_;
-  }
+  first_frequency_ = 0;
+  initialize_frequencies();
 
   // Calculate velocity profile
   friction_velocity_ =
       Dispatcher<double, const std::string&, const std::vector<double>&, double,
                  double, std::vector<double>&>::instance()
           ->dispatch("ExposureCategoryVel", exposure_category, heights_, 0.4,
-                     gust_speed, wind_velocities_);  
+                     gust_speed, wind_velocities_);
+
+  initialize_cross_spectra();
 }
 
 stochastic::WittigSinha::WittigSinha(std::string exposure_category,
@@ -116,49 +167,182 @@ stochastic::WittigSinha::WittigSinha(std::string exposure_category,
   seed_value_ = seed_value;
 }
 
-utilities::JsonObject stochastic::WittigSinha::generate(const std::string& event_name, bool units) {
-  // Initialize wind velocity vectors
-  std::vector<std::vector<std::vector<std::vector<double>>>> wind_vels(
-      local_x_.size(),
-      std::vector<std::vector<std::vector<double>>>(
-          local_y_.size(),
-          std::vector<std::vector<double>>(
-              heights_.size(), std::vector<double>(num_times_, 0.0))));
-
-  Eigen::MatrixXcd complex_random_vals(num_freqs_, heights_.size());
-  
+std::size_t stochastic::WittigSinha::num_records() const {
+  return local_x_.size() * local_y_.size();
+}
+
+stochastic::RecordIterator stochastic::WittigSinha::records(
+    const std::string& event_name, bool units, std::size_t batch_size) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+
+  // Select seed of random streams used for white noise. Each batch restores
+  // the seed, so records of the iterator share one set of streams even when
+  // other calls to generate select new seeds in between.
+  std::uint64_t stream_seed = numeric_utils::stream_seed(seed_value_);
+  stream_seed_ = stream_seed;
+
+  // Velocities at all points are correlated, so the complex random numbers
+  // of all points are generated jointly once and shared by all batches
+  if (precision_ == Precision::Single) {
+    return range_iterator<float>(
+        event_name, units, batch_size, stream_seed,
+        std::make_shared<const Eigen::MatrixXcf>(
+            single_complex_random_numbers()));
+  }
+
+  return range_iterator<double>(
+      event_name, units, batch_size, stream_seed,
+      std::make_shared<const Eigen::MatrixXcd>(complex_random_numbers()));
+}
+
+template <typename Tscalar>
+stochastic::RecordIterator stochastic::WittigSinha::range_iterator(
+    const std::string& event_name, bool units, std::size_t batch_size,
+    std::uint64_t stream_seed,
+    std::shared_ptr<const Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic,
+                                        Eigen::Dynamic>>
+        complex_random) {
+  return RecordIterator(
+      num_records(), batch_size > 0 ? batch_size : 1,
+      [this, event_name, units, stream_seed, complex_random](
+          std::size_t first_location, std::size_t num_batch_locations,
+          std::vector<RecordMetadata>* metadata) {
+        SMELT_PROFILE_ACTIVATE(profile_);
+        if (stream_seed_ != stream_seed) {
+          stream_seed_ = stream_seed;
+        }
+        auto records = generate_range(units, *complex_random, first_location,
+                                      num_batch_locations);
+        if (metadata) {
+          records_metadata(event_name, records, first_location, *metadata);
+        }
+        return records;
+      });
+}
+
+template <typename Tscalar>
+utilities::TimeHistoryBlock stochastic::WittigSinha::generate_range(
+    bool units,
+    const Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic,
+                        Eigen::Dynamic>& complex_random,
+    std::size_t first_location, std::size_t num_locations) const {
+  // Records hold the velocities at all heights of one horizontal location,
+  // which is the column-major layout of the batched inverse FFT output.
+  // Velocities past the duration of padded transforms are trimmed.
+  utilities::TimeHistoryBlock records(num_locations, heights_.size(),
+                                      num_times_, time_step_);
+  Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic, Eigen::Dynamic>
+      complex_random_vals(num_freqs_, heights_.size());
+  Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic> location_hists;
+
   // Loop over heights to find time histories
   try {
-    for (unsigned int i = 0; i < local_x_.size(); ++i) {
-      for (unsigned int j = 0; j < local_y_.size(); ++j) {
-        // Generate complex random numbers to use for calculation of discrete
-        // time series
-        complex_random_vals = complex_random_numbers();
-        for (unsigned int k = 0; k < heights_.size(); ++k) {
-          wind_vels[i][j][k] = gen_location_hist(complex_random_vals, k, units);
-        }
-      }
+    for (std::size_t k = 0; k < num_locations; ++k) {
+      // Select complex random numbers at all heights of this location.
+      // Locations are ordered by x- and then y-location.
+      std::size_t location = first_location + k;
+      complex_random_vals = complex_random.middleCols(
+          location * heights_.size(), heights_.size());
+      gen_location_hists(complex_random_vals, location_hists, units);
+      records.record(k) =
+          location_hists.topRows(num_times_).template cast<double>();
     }
   } catch (const std::exception& e) {
     std::cerr << "\nERROR: In stochastic::WittigSinha::generate: "
               << e.what() << std::endl;
   }
 
+  return records;
+}
+
+utilities::TimeHistoryBlock stochastic::WittigSinha::generate_records(
+    bool units) {
+  auto iterator = records(
+      "", units, std::max<std::size_t>(local_x_.size() * local_y_.size(), 1));
+  utilities::TimeHistoryBlock block;
+  iterator.next(block);
+  return block;
+}
+
+utilities::JsonObject stochastic::WittigSinha::generate(const std::string& event_name, bool units) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+  auto records = generate_records(units);
+  return event_json(event_name, records);
+}
+
+void stochastic::WittigSinha::records_metadata(
+    const std::string& event_name, const utilities::TimeHistoryBlock& records,
+    std::size_t first_location, std::vector<RecordMetadata>& metadata) const {
+  // Time series are named by floor, as in JSON output
+  std::vector<std::string> components(heights_.size());
+  for (unsigned int i = 0; i < heights_.size(); ++i) {
+    components[i] = std::to_string(i + 1);
+  }
+
+  metadata.resize(records.num_records());
+  for (std::size_t i = 0; i < records.num_records(); ++i) {
+    metadata[i].name =
+        local_x_.size() * local_y_.size() == 1
+            ? event_name
+            : event_name + "_Location" + std::to_string(first_location + i);
+    metadata[i].type = "Wind";
+    metadata[i].time_step = records.time_step();
+    metadata[i].num_steps = records.num_steps(i);
+    metadata[i].components = components;
+  }
+}
+
+utilities::TimeHistoryBlock stochastic::WittigSinha::generate(
+    const std::string& event_name, std::vector<RecordMetadata>& metadata,
+    bool units) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+  auto records = generate_records(units);
+  records_metadata(event_name, records, 0, metadata);
+  return records;
+}
+
+utilities::JsonObject stochastic::WittigSinha::event_json(
+    const std::string& event_name, const utilities::TimeHistoryBlock& records,
+    const std::vector<std::size_t>* data_offsets) const {
   // Create JsonObject for event
   auto event = utilities::JsonObject();
   event.add_value("dT", time_step_);
   event.add_value("numSteps", num_times_);
-  
-  // Consider case when only looking at floor loads, so only have time histories as
-  // one location along the z-axis
-  if (local_x_.size() == 1 && local_y_.size() == 1) {
-    // Arrays of patterns and time histories for each floor
+  event.add_value("Events", events_json(event_name, records, 0, data_offsets));
+
+  return event;
+}
+
+std::vector<utilities::JsonObject> stochastic::WittigSinha::events_json(
+    const std::string& event_name, const utilities::TimeHistoryBlock& records,
+    std::size_t first_record,
+    const std::vector<std::size_t>* data_offsets) const {
+  SMELT_PROFILE_STAGE("eventsJson");
+
+  // Events at more than one horizontal location are named by location, as
+  // in the metadata of records, and record the location
+  bool multiple_locations = num_records() > 1;
+
+  // Arrays of patterns and time histories for each floor
+  std::vector<utilities::JsonObject> event_array(records.num_records());
+  for (std::size_t record = 0; record < records.num_records(); ++record) {
     std::vector<utilities::JsonObject> pattern_array(heights_.size());
-    std::vector<utilities::JsonObject> event_array(1);
     std::vector<utilities::JsonObject> time_history_array(heights_.size());
     auto time_history = utilities::JsonObject();
-    event_array[0].add_value("type", "Wind");
-    event_array[0].add_value("subtype", model_name_);
+    event_array[record].add_value("type", "Wind");
+    event_array[record].add_value("subtype", model_name_);
+    if (multiple_locations) {
+      std::size_t location = first_record + record;
+      event_array[record].add_value(
+          "name", event_name + "_Location" + std::to_string(location));
+      event_array[record].add_value("x",
+                                    local_x_[location / local_y_.size()]);
+      event_array[record].add_value("y",
+                                    local_y_[location % local_y_.size()]);
+    }
 
     for (unsigned int i = 0; i < heights_.size(); ++i) {
       // Create pattern
@@ -173,21 +357,23 @@ utilities::JsonObject stochastic::WittigSinha::generate(const std::string& event
       time_history.add_value("name", std::to_string(i + 1));
       time_history.add_value("dT", time_step_);
       time_history.add_value("type", "Value");
-      time_history.add_value("data", wind_vels[0][0][i]);
+      if (data_offsets) {
+        time_history.add_value("dataOffset",
+                               (*data_offsets)[record * heights_.size() + i]);
+        time_history.add_value("numValues", records.num_steps(record));
+      } else {
+        time_history.add_array("data", records.data(record, i),
+                               records.num_steps(record));
+      }
       time_history_array[i] = time_history;
       time_history.clear();
     }
     
-    event_array[0].add_value("timeSeries", time_history_array);
-    event_array[0].add_value("pattern", pattern_array);
-    event.add_value("Events", event_array);   
-  } else {
-    throw std::runtime_error(
-        "ERROR: In stochastic::WittigSinha::generate: Currently, only supports "
-        "time histories along z-axis at single location\n");
+    event_array[record].add_value("timeSeries", time_history_array);
+    event_array[record].add_value("pattern", pattern_array);
   }
 
-  return event;
+  return event_array;
 }
 
 bool stochastic::WittigSinha::generate(const std::string& event_name,
@@ -195,10 +381,26 @@ bool stochastic::WittigSinha::generate(const std::string& event_name,
                                        bool units) {
 
   bool status = true;
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+
   // Generate time histories at specified locations
   try {
+    if (output_format_ == OutputFormat::Spectral) {
+      return spectral_archive(event_name, units)
+          .write_to_file(output_location, json_format_);
+    }
+
+    if (output_format_ == OutputFormat::Binary) {
+      auto records = generate_records(units);
+      utilities::BinaryFileWriter binary_writer;
+      auto data_offsets = binary_writer.add_records(records);
+      return binary_writer.write(
+          output_location, event_json(event_name, records, &data_offsets));
+    }
+
     auto json_output = generate(event_name, units);
-    json_output.write_to_file(output_location);
+    json_output.write_to_file(output_location, json_format_);
   } catch (const std::exception& e) {
     std::cerr << e.what();
     status = false;
@@ -208,121 +410,674 @@ bool stochastic::WittigSinha::generate(const std::string& event_name,
   return status;
 }
 
-Eigen::MatrixXd stochastic::WittigSinha::cross_spectral_density(double frequency) const {
-  // Coefficient for coherence function
+utilities::JsonObject stochastic::WittigSinha::spectral_archive(
+    const std::string& event_name, bool units) {
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+
+  // Records are named as in JSON output
+  std::vector<utilities::JsonObject> records(num_records());
+  for (std::size_t k = 0; k < records.size(); ++k) {
+    records[k].add_value(
+        "name", records.size() == 1
+                    ? event_name
+                    : event_name + "_Location" + std::to_string(k));
+    records[k].add_value("location", k);
+    records[k].add_value("numSteps", num_times_);
+  }
+
+  auto archive = utilities::JsonObject();
+  archive.add_value("model", model_name_);
+  archive.add_value("streamSeed", numeric_utils::stream_seed(seed_value_));
+  archive.add_value("units", units);
+  archive.add_value("timeStep", time_step_);
+  archive.add_value("records", records);
+  return archive;
+}
+
+utilities::TimeHistoryBlock stochastic::WittigSinha::rebuild_records(
+    const utilities::JsonObject& archive, std::size_t first_record,
+    std::size_t num_records) {
+  auto contents = archive_contents(archive, first_record, num_records);
+  profile_.reset();
+  SMELT_PROFILE_ACTIVATE(profile_);
+
+  // White noise of the archived call is restored
+  stream_seed_ = contents["streamSeed"].get<std::uint64_t>();
+  bool units = contents["units"].get<bool>();
+  if (precision_ == Precision::Single) {
+    return generate_range(units, single_complex_random_numbers(),
+                          first_record, num_records);
+  }
+
+  return generate_range(units, complex_random_numbers(), first_record,
+                        num_records);
+}
+
+void stochastic::WittigSinha::set_fft_padding(bool fft_padding) {
+  fft_padding_ = fft_padding;
+  initialize_frequencies();
+
+  // Cached factors belong to the previous frequencies
+  std::vector<Eigen::MatrixXd>().swap(cholesky_factors_);
+  std::vector<Eigen::MatrixXf>().swap(single_cholesky_factors_);
+}
+
+void stochastic::WittigSinha::set_deterministic_cache(
+    bool deterministic_cache) {
+  deterministic_cache_ = deterministic_cache;
+  if (!deterministic_cache) {
+    std::vector<Eigen::MatrixXd>().swap(cholesky_factors_);
+    std::vector<Eigen::MatrixXf>().swap(single_cholesky_factors_);
+  }
+}
+
+void stochastic::WittigSinha::initialize_frequencies() {
+  // Frequencies are spaced by the cut-off frequency over half the length of
+  // the inverse FFT, which is padded to a fast length if selected
+  num_freqs_ = fft_padding_ ? numeric_utils::smooth_fft_length(num_times_ / 2)
+                            : num_times_ / 2;
+  frequencies_.resize(num_freqs_);
+
+  for (unsigned int i = 0; i < frequencies_.size(); ++i) {
+    frequencies_[i] = (i + first_frequency_) * freq_cutoff_ / num_freqs_;
+  }
+}
+
+void stochastic::WittigSinha::initialize_cross_spectra() {
+  // Coefficients for coherence function over vertical and horizontal
+  // separations
   double coherence_coeff = 10.0;
-  Eigen::MatrixXd cross_spectral_density =
-      Eigen::MatrixXd::Zero(heights_.size(), heights_.size());
-  
-  for (unsigned int i = 0; i < cross_spectral_density.rows(); ++i) {
-    cross_spectral_density(i, i) =
-        200.0 * friction_velocity_ * friction_velocity_ * heights_[i] /
-        (wind_velocities_[i] *
-         std::pow(1.0 + 50.0 * frequency * heights_[i] / wind_velocities_[i],
-                  5.0 / 3.0));
+  double horizontal_coherence_coeff = 16.0;
+  unsigned int num_heights = heights_.size();
+  unsigned int num_points = num_records() * num_heights;
+
+  // Points are ordered by horizontal location and then by height, which is
+  // the order of the components of all records
+  std::vector<double> point_x(num_points), point_y(num_points);
+  std::vector<unsigned int> point_heights(num_points);
+  spectrum_coeffs_.resize(num_points);
+  spectrum_scales_.resize(num_points);
+  for (unsigned int p = 0; p < num_points; ++p) {
+    unsigned int location = p / num_heights;
+    unsigned int i = p % num_heights;
+    point_x[p] = local_x_[location / local_y_.size()];
+    point_y[p] = local_y_[location % local_y_.size()];
+    point_heights[p] = i;
+    spectrum_coeffs_(p) = 200.0 * friction_velocity_ * friction_velocity_ *
+                          heights_[i] / wind_velocities_[i];
+    spectrum_scales_(p) = 50.0 * heights_[i] / wind_velocities_[i];
   }
 
-  for (unsigned int i = 0; i < cross_spectral_density.rows(); ++i) {
-    for (unsigned int j = i + 1; j < cross_spectral_density.cols(); ++j) {
-      cross_spectral_density(i, j) =
-          std::sqrt(cross_spectral_density(i, i) *
-                    cross_spectral_density(j, j)) *
-          std::exp(-coherence_coeff * frequency *
-                   std::abs(heights_[i] - heights_[j]) /
-                   (0.5 * (wind_velocities_[i] + wind_velocities_[j]))) *
-          0.999;
+  coherence_decay_.resize(num_points, num_points);
+  for (unsigned int q = 0; q < num_points; ++q) {
+    for (unsigned int p = 0; p < num_points; ++p) {
+      unsigned int i = point_heights[p];
+      unsigned int j = point_heights[q];
+      double vertical = coherence_coeff * (heights_[i] - heights_[j]);
+      double horizontal_x =
+          horizontal_coherence_coeff * (point_x[p] - point_x[q]);
+      double horizontal_y =
+          horizontal_coherence_coeff * (point_y[p] - point_y[q]);
+      coherence_decay_(p, q) =
+          std::sqrt(vertical * vertical + horizontal_x * horizontal_x +
+                    horizontal_y * horizontal_y) /
+          (0.5 * (wind_velocities_[i] + wind_velocities_[j]));
     }
   }
+}
 
-  // Get diagonal of cross spectral density matrix--avoids compiler errors where type
-  // of diagonal matrix is not correctly deduced
-  Eigen::MatrixXd diag_mat = cross_spectral_density.diagonal().asDiagonal();
+Eigen::MatrixXd stochastic::WittigSinha::cross_spectral_density(double frequency) const {
+  Eigen::MatrixXd cross_spectral_density(spectrum_coeffs_.size(),
+                                         spectrum_coeffs_.size());
+  this->cross_spectral_density(frequency, cross_spectral_density);
+  return cross_spectral_density;
+}
 
-  return cross_spectral_density.transpose() + cross_spectral_density - diag_mat;
+void stochastic::WittigSinha::cross_spectral_density(
+    double frequency, Eigen::MatrixXd& cross_spectral_density) const {
+  Eigen::ArrayXd spectra =
+      spectrum_coeffs_ / (1.0 + frequency * spectrum_scales_).pow(5.0 / 3.0);
+  Eigen::VectorXd root_spectra = spectra.sqrt().matrix();
+
+  // Off-diagonal terms are the geometric mean of the spectra at both heights
+  // scaled by their coherence
+  cross_spectral_density.noalias() = root_spectra * root_spectra.transpose();
+  cross_spectral_density.array() *=
+      0.999 * (-frequency * coherence_decay_).exp();
+  cross_spectral_density.diagonal() = spectra.matrix();
 }
 
-Eigen::MatrixXcd stochastic::WittigSinha::complex_random_numbers() const {
-  // Construct random number generator for standard normal distribution
-  static unsigned int history_seed = static_cast<unsigned int>(std::time(nullptr));
-  history_seed = history_seed + 10;
-
-  auto generator =
-    seed_value_ != std::numeric_limits<int>::infinity()
-    ? boost::random::mt19937(static_cast<unsigned int>(seed_value_ + 10))
-    : boost::random::mt19937(history_seed);
-  
-  boost::random::normal_distribution<> distribution;
-  boost::random::variate_generator<boost::random::mt19937&,
-                                   boost::random::normal_distribution<>>
-      distribution_gen(generator, distribution);
+template <typename Tscalar>
+Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic, Eigen::Dynamic>
+stochastic::WittigSinha::complex_white_noise() const {
+  // Random stream for standard normal distribution at all points
+  numeric_utils::RandomStream stream(stream_seed_, 0, 0);
+  Eigen::Index num_points = spectrum_coeffs_.size();
 
   // Generate white noise consisting of complex numbers
-  Eigen::MatrixXcd white_noise(heights_.size(), num_freqs_);
+  Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic, Eigen::Dynamic>
+      white_noise(num_points, num_freqs_);
 
   for (unsigned int i = 0; i < white_noise.rows(); ++i) {
     for (unsigned int j = 0; j < white_noise.cols(); ++j) {
-      white_noise(i, j) = std::complex<double>(
-          distribution_gen() * std::sqrt(0.5),
-          distribution_gen() * std::sqrt(std::complex<double>(-0.5)).imag());
+      white_noise(i, j) = std::complex<Tscalar>(
+          static_cast<Tscalar>(stream.normal() * std::sqrt(0.5)),
+          static_cast<Tscalar>(
+              stream.normal() *
+              std::sqrt(std::complex<double>(-0.5)).imag()));
     }
   }
 
-  // Iterator over all frequencies and generate complex random numbers
-  // for discrete time series simulation
-  Eigen::MatrixXd cross_spec_density_matrix(heights_.size(), heights_.size());
-  Eigen::MatrixXcd complex_random(num_freqs_, heights_.size());
+  return white_noise;
+}
 
-  for (unsigned int i = 0; i < frequencies_.size(); ++i) {
-    // Calculate cross-spectral density matrix for current frequency
-    cross_spec_density_matrix = cross_spectral_density(frequencies_[i]);
+Eigen::MatrixXcd stochastic::WittigSinha::complex_random_numbers() const {
+  SMELT_PROFILE_STAGE("complexRandomNumbers");
+  Eigen::Index num_points = spectrum_coeffs_.size();
+  auto white_noise = complex_white_noise<double>();
+
+  Eigen::MatrixXcd complex_random(num_freqs_, num_points);
+  double scale = num_freqs_ * std::sqrt(2.0 * freq_cutoff_ / num_freqs_);
+  std::atomic<bool> positive_definite(true);
+
+  if (pod_energy_fraction_ > 0.0) {
+    // Energy that may be discarded at each frequency is an equal share of
+    // the energy discarded over all frequencies, which keeps most modes at
+    // the frequencies holding most of the energy
+    double total_energy = 0.0;
+    for (unsigned int i = 0; i < num_freqs_; ++i) {
+      total_energy +=
+          (spectrum_coeffs_ /
+           (1.0 + frequencies_[i] * spectrum_scales_).pow(5.0 / 3.0))
+              .sum();
+    }
+    double discarded_energy =
+        (1.0 - pod_energy_fraction_) * total_energy / num_freqs_;
+
+    // Modes start from those of the previous frequency within segments of
+    // fixed length, so modes do not depend on the number of threads
+    const unsigned int segment_length = 256;
+    unsigned int num_segments =
+        (num_freqs_ + segment_length - 1) / segment_length;
+
+    utilities::parallel_for(num_segments, num_threads_, [&](unsigned int k) {
+      if (!pod_random_numbers(white_noise, k * segment_length,
+                              std::min((k + 1) * segment_length, num_freqs_),
+                              discarded_energy, complex_random)) {
+        positive_definite = false;
+      }
+    });
+  } else if (cholesky_tolerance_ > 0.0 && num_freqs_ > 2) {
+    // Factors are interpolated within segments of fixed length, so the
+    // frequencies that are factored do not depend on the number of threads
+    const unsigned int segment_length = 256;
+    unsigned int num_segments =
+        (num_freqs_ - 1 + segment_length - 1) / segment_length;
+
+    utilities::parallel_for(num_segments, num_threads_, [&](unsigned int k) {
+      unsigned int first_freq = k * segment_length;
+      unsigned int last_freq =
+          std::min(first_freq + segment_length, num_freqs_ - 1);
+      Eigen::MatrixXd first_factor, last_factor;
+      bool first_positive_definite =
+          lower_cholesky(frequencies_[first_freq], first_factor);
+      bool last_positive_definite =
+          lower_cholesky(frequencies_[last_freq], last_factor);
 
-    // Find lower Cholesky factorization of cross-spectral density
-    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> lower_cholesky;
+      // Each segment writes its first frequency, while its last frequency is
+      // written by the next segment
+      complex_random.row(first_freq).transpose().noalias() =
+          first_factor.triangularView<Eigen::Lower>() *
+          white_noise.col(first_freq);
+      complex_random.row(first_freq) *= scale;
+      if (last_freq == num_freqs_ - 1) {
+        complex_random.row(last_freq).transpose().noalias() =
+            last_factor.triangularView<Eigen::Lower>() *
+            white_noise.col(last_freq);
+        complex_random.row(last_freq) *= scale;
+      }
+
+      if (!interpolate_random_numbers(white_noise, first_freq, first_factor,
+                                      last_freq, last_factor,
+                                      complex_random) ||
+          !first_positive_definite || !last_positive_definite) {
+        positive_definite = false;
+      }
+    });
+  } else if (!cholesky_random_numbers(
+                 white_noise, complex_random,
+                 deterministic_cache_ ? &cholesky_factors_ : nullptr)) {
+    positive_definite = false;
+  }
+
+  if (!positive_definite) {
+    std::cerr << "\nERROR: In stochastic::WittigSinha::complex_random_numbers: "
+                 "Cross-Spectral Density matrix is not positive "
+                 "semi-definite\n"
+              << std::endl;
+  }
+
+  return complex_random;
+}
+
+Eigen::MatrixXcf stochastic::WittigSinha::single_complex_random_numbers()
+    const {
+  // Interpolation and decomposition start from factors of the previous
+  // frequency, so they are kept in double precision
+  if (pod_energy_fraction_ > 0.0 ||
+      (cholesky_tolerance_ > 0.0 && num_freqs_ > 2)) {
+    return complex_random_numbers().cast<std::complex<float>>();
+  }
+
+  SMELT_PROFILE_STAGE("complexRandomNumbers");
+  auto white_noise = complex_white_noise<float>();
+  Eigen::MatrixXcf complex_random(num_freqs_, spectrum_coeffs_.size());
+
+  if (!cholesky_random_numbers(
+          white_noise, complex_random,
+          deterministic_cache_ ? &single_cholesky_factors_ : nullptr)) {
+    std::cerr << "\nERROR: In "
+                 "stochastic::WittigSinha::single_complex_random_numbers: "
+                 "Cross-Spectral Density matrix is not positive "
+                 "semi-definite\n"
+              << std::endl;
+  }
+
+  return complex_random;
+}
+
+template <typename Tscalar>
+bool stochastic::WittigSinha::cholesky_random_numbers(
+    const Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic,
+                        Eigen::Dynamic>& white_noise,
+    Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic, Eigen::Dynamic>&
+        complex_random,
+    std::vector<Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>>*
+        cached_factors) const {
+  Eigen::Index num_points = spectrum_coeffs_.size();
+  const Tscalar scale = static_cast<Tscalar>(
+      num_freqs_ * std::sqrt(2.0 * freq_cutoff_ / num_freqs_));
+  std::atomic<bool> positive_definite(true);
+
+  // Factors of a previous call are only multiplied by the white noise, while
+  // factors of a first call to cache are computed on the host and stored
+  bool reuse_factors = cached_factors && cached_factors->size() == num_freqs_;
+  if (cached_factors && !reuse_factors) {
+    cached_factors->resize(num_freqs_);
+  }
+  if (!reuse_factors) {
+    SMELT_PROFILE_COUNT("factorizations", num_freqs_);
+  }
+
+  if (!cached_factors && numeric_utils::device::enabled()) {
+    // Cross-spectral densities of a chunk of frequencies are evaluated on the
+    // host and the whole chunk is factored on the GPU. Chunks are bounded so
+    // the device holds at most about 64 million matrix entries at a time.
+    const std::size_t max_entries = std::size_t(1) << 26;
+    std::size_t matrix_entries = num_points * num_points;
+    unsigned int chunk_size = static_cast<unsigned int>(std::min<std::size_t>(
+        std::max<std::size_t>(max_entries / matrix_entries, 1), num_freqs_));
+    std::vector<Tscalar> matrices;
+    std::vector<std::complex<Tscalar>> vectors(chunk_size * num_points),
+        products(chunk_size * num_points);
+
+    for (unsigned int first_freq = 0; first_freq < num_freqs_;
+         first_freq += chunk_size) {
+      unsigned int num_chunk_freqs =
+          std::min(chunk_size, num_freqs_ - first_freq);
+      // Factorization reads only lower triangles, which are left in place
+      matrices.assign(num_chunk_freqs * matrix_entries, Tscalar(0));
+
+      utilities::parallel_for(
+          num_chunk_freqs, num_threads_, [&](unsigned int k) {
+            Eigen::MatrixXd cross_spec_density_matrix(num_points, num_points);
+            cross_spectral_density(frequencies_[first_freq + k],
+                                   cross_spec_density_matrix);
+            Eigen::Map<Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>>(
+                matrices.data() + k * matrix_entries, num_points, num_points)
+                .template triangularView<Eigen::Lower>() =
+                cross_spec_density_matrix.cast<Tscalar>();
+            Eigen::Map<Eigen::Matrix<std::complex<Tscalar>, Eigen::Dynamic, 1>>(
+                vectors.data() + k * num_points, num_points) =
+                white_noise.col(first_freq + k);
+          });
+
+      if (!numeric_utils::device::cholesky_products(
+              num_points, num_chunk_freqs, matrices.data(), vectors.data(),
+              products.data())) {
+        positive_definite = false;
+      }
+
+      // This is Equation 5(a) from Wittig & Sinha (1975)
+      for (unsigned int k = 0; k < num_chunk_freqs; ++k) {
+        complex_random.row(first_freq + k) =
+            Eigen::Map<const Eigen::Matrix<std::complex<Tscalar>, 1,
+                                           Eigen::Dynamic>>(
+                products.data() + k * num_points, num_points);
+        complex_random.row(first_freq + k) *= scale;
+      }
+    }
+
+    return positive_definite;
+  }
 
-    try {
-      auto llt = cross_spec_density_matrix.llt();
-      lower_cholesky = llt.matrixL();
+  // Iterate over all frequencies and generate complex random numbers for
+  // discrete time series simulation. Each thread handles a contiguous range
+  // of frequencies, reusing its cross-spectral density matrix and
+  // factorization storage. Cross-spectral densities are evaluated in double
+  // precision and rounded to the precision of the factorization.
+  unsigned int num_ranges =
+      std::min(utilities::thread_count(num_threads_), num_freqs_);
+
+  utilities::parallel_for(num_ranges, num_threads_, [&](unsigned int k) {
+    unsigned int first_freq = static_cast<unsigned int>(
+        static_cast<std::size_t>(k) * num_freqs_ / num_ranges);
+    unsigned int last_freq = static_cast<unsigned int>(
+        static_cast<std::size_t>(k + 1) * num_freqs_ / num_ranges);
+    Eigen::MatrixXd cross_spec_density_matrix(num_points, num_points);
+    Eigen::LLT<Eigen::Matrix<Tscalar, Eigen::Dynamic, Eigen::Dynamic>> llt(
+        num_points);
+
+    for (unsigned int i = first_freq; i < last_freq; ++i) {
+      // This is Equation 5(a) from Wittig & Sinha (1975)
+      if (reuse_factors) {
+        complex_random.row(i).transpose().noalias() =
+            (*cached_factors)[i].template triangularView<Eigen::Lower>() *
+            white_noise.col(i);
+        complex_random.row(i) *= scale;
+        continue;
+      }
 
+      // Find lower Cholesky factorization of cross-spectral density for
+      // current frequency
+      cross_spectral_density(frequencies_[i], cross_spec_density_matrix);
+      llt.compute(cross_spec_density_matrix.cast<Tscalar>());
       if (llt.info() == Eigen::NumericalIssue) {
-        throw std::runtime_error(
-            "\nERROR: In stochastic::WittigSinha::generate method: Cross-Spectral Density "
-            "matrix is not positive semi-definite\n");
+        positive_definite = false;
+      }
+
+      complex_random.row(i).transpose().noalias() =
+          llt.matrixL() * white_noise.col(i);
+      complex_random.row(i) *= scale;
+      if (cached_factors) {
+        (*cached_factors)[i] = llt.matrixL();
       }
-    } catch (const std::exception& e) {
-      std::cerr << "\nERROR: In time history generation: " << e.what()
-                << std::endl;
     }
-    
-    // This is Equation 5(a) from Wittig & Sinha (1975)
-    complex_random.row(i) = num_freqs_ *
-                            std::sqrt(2.0 * freq_cutoff_ / num_freqs_) *
-                            lower_cholesky * white_noise.col(i);
+  });
+
+  // Factors are not kept if any factorization failed, so later calls
+  // report the failure again
+  if (cached_factors && !positive_definite) {
+    cached_factors->clear();
   }
 
-  return complex_random;
+  return positive_definite;
+}
+
+void stochastic::WittigSinha::set_cholesky_tolerance(double tolerance) {
+  if (tolerance < 0.0 || tolerance >= 1.0) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::WittigSinha::set_cholesky_tolerance: "
+        "Tolerance must be in the range [0, 1)\n");
+  }
+
+  cholesky_tolerance_ = tolerance;
+}
+
+void stochastic::WittigSinha::set_pod_energy_fraction(double energy_fraction) {
+  if (energy_fraction < 0.0 || energy_fraction > 1.0) {
+    throw std::runtime_error(
+        "\nERROR: in stochastic::WittigSinha::set_pod_energy_fraction: "
+        "Energy fraction must be in the range [0, 1]\n");
+  }
+
+  pod_energy_fraction_ = energy_fraction;
+}
+
+bool stochastic::WittigSinha::lower_cholesky(
+    double frequency, Eigen::MatrixXd& lower_cholesky) const {
+  SMELT_PROFILE_COUNT("factorizations", 1);
+  Eigen::MatrixXd cross_spec_density_matrix(spectrum_coeffs_.size(),
+                                            spectrum_coeffs_.size());
+  cross_spectral_density(frequency, cross_spec_density_matrix);
+
+  Eigen::LLT<Eigen::MatrixXd> llt(cross_spec_density_matrix);
+  lower_cholesky = llt.matrixL();
+
+  return llt.info() != Eigen::NumericalIssue;
+}
+
+bool stochastic::WittigSinha::interpolate_random_numbers(
+    const Eigen::MatrixXcd& white_noise, unsigned int first_freq,
+    const Eigen::MatrixXd& first_factor, unsigned int last_freq,
+    const Eigen::MatrixXd& last_factor,
+    Eigen::MatrixXcd& complex_random) const {
+  if (last_freq - first_freq < 2) {
+    return true;
+  }
+
+  double scale = num_freqs_ * std::sqrt(2.0 * freq_cutoff_ / num_freqs_);
+  unsigned int mid_freq = first_freq + (last_freq - first_freq) / 2;
+  Eigen::MatrixXd mid_factor;
+  bool positive_definite = lower_cholesky(frequencies_[mid_freq], mid_factor);
+
+  // This is Equation 5(a) from Wittig & Sinha (1975)
+  complex_random.row(mid_freq).transpose().noalias() =
+      mid_factor.triangularView<Eigen::Lower>() * white_noise.col(mid_freq);
+  complex_random.row(mid_freq) *= scale;
+
+  double weight = static_cast<double>(mid_freq - first_freq) /
+                  (last_freq - first_freq);
+  double error =
+      (mid_factor - (1.0 - weight) * first_factor - weight * last_factor)
+          .norm();
+
+  if (error > cholesky_tolerance_ * mid_factor.norm()) {
+    // Refine both halves of the interval
+    positive_definite =
+        interpolate_random_numbers(white_noise, first_freq, first_factor,
+                                   mid_freq, mid_factor, complex_random) &&
+        positive_definite;
+    positive_definite =
+        interpolate_random_numbers(white_noise, mid_freq, mid_factor,
+                                   last_freq, last_factor, complex_random) &&
+        positive_definite;
+  } else {
+    // Interpolate factors linearly between the factored frequencies, which
+    // interpolates the products of factors and white noise
+    Eigen::VectorXcd start_product(spectrum_coeffs_.size());
+    Eigen::VectorXcd end_product(spectrum_coeffs_.size());
+    for (unsigned int i = first_freq + 1; i < last_freq; ++i) {
+      if (i == mid_freq) {
+        continue;
+      }
+      bool lower_half = i < mid_freq;
+      const Eigen::MatrixXd& start_factor =
+          lower_half ? first_factor : mid_factor;
+      const Eigen::MatrixXd& end_factor = lower_half ? mid_factor : last_factor;
+      unsigned int start_freq = lower_half ? first_freq : mid_freq;
+      unsigned int end_freq = lower_half ? mid_freq : last_freq;
+      double end_weight =
+          static_cast<double>(i - start_freq) / (end_freq - start_freq);
+
+      start_product.noalias() =
+          start_factor.triangularView<Eigen::Lower>() * white_noise.col(i);
+      end_product.noalias() =
+          end_factor.triangularView<Eigen::Lower>() * white_noise.col(i);
+      complex_random.row(i) =
+          scale * ((1.0 - end_weight) * start_product +
+                   end_weight * end_product).transpose();
+    }
+  }
+
+  return positive_definite;
+}
+
+bool stochastic::WittigSinha::pod_random_numbers(
+    const Eigen::MatrixXcd& white_noise, unsigned int first_freq,
+    unsigned int last_freq, double discarded_energy,
+    Eigen::MatrixXcd& complex_random) const {
+  // Residual tolerance of modes relative to the largest eigenvalue, maximum
+  // number of subspace iterations per frequency and number of extra modes
+  // iterated to speed up convergence of the kept modes
+  const double residual_tol = 1.0e-4;
+  const unsigned int max_iterations = 50;
+  const Eigen::Index num_extra_modes = 4;
+
+  // Subspace iteration only pays off when few modes are needed, so
+  // frequencies needing more modes than this use Cholesky factors. Since
+  // neighbouring frequencies need similar numbers of modes, a number of the
+  // following frequencies use Cholesky factors before modes are tried again.
+  Eigen::Index num_points = spectrum_coeffs_.size();
+  Eigen::Index max_subspace = std::max<Eigen::Index>(
+      std::min(num_points, 2 * num_extra_modes), num_points / 8);
+  const unsigned int retry_interval = 16;
+
+  double scale = num_freqs_ * std::sqrt(2.0 * freq_cutoff_ / num_freqs_);
+  Eigen::MatrixXd cross_spec_density_matrix(num_points, num_points);
+  Eigen::MatrixXd basis, products, modes, mode_products;
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver;
+  Eigen::LLT<Eigen::MatrixXd> llt(num_points);
+  unsigned int retry_freq = first_freq;
+  bool positive_definite = true;
+
+  // Orthonormal basis of columns of input matrix
+  auto orthonormalize = [](const Eigen::MatrixXd& columns) {
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(columns);
+    return Eigen::MatrixXd(
+        qr.householderQ() *
+        Eigen::MatrixXd::Identity(columns.rows(), columns.cols()));
+  };
+
+  // Columns of the cross-spectral density at evenly spaced points, which
+  // extend the subspace beyond the modes found so far
+  auto density_columns = [&](Eigen::Index num_columns) {
+    Eigen::MatrixXd columns(num_points, num_columns);
+    for (Eigen::Index j = 0; j < num_columns; ++j) {
+      columns.col(j) =
+          cross_spec_density_matrix.col(j * num_points / num_columns);
+    }
+    return columns;
+  };
+
+  for (unsigned int i = first_freq; i < last_freq; ++i) {
+    cross_spectral_density(frequencies_[i], cross_spec_density_matrix);
+    double kept_energy =
+        cross_spec_density_matrix.trace() - discarded_energy;
+
+    if (i == first_freq) {
+      basis = orthonormalize(
+          density_columns(std::min(num_points, 2 * num_extra_modes)));
+    }
+
+    Eigen::Index num_modes = 0;
+    Eigen::VectorXd eigenvalues;
+    bool use_cholesky = i < retry_freq;
+    for (unsigned int iteration = 0;
+         !use_cholesky && iteration < max_iterations; ++iteration) {
+      // Rayleigh-Ritz projection of the cross-spectral density onto basis,
+      // with modes ordered by decreasing eigenvalue
+      products.noalias() = cross_spec_density_matrix * basis;
+      solver.compute(basis.transpose() * products);
+      eigenvalues = solver.eigenvalues().reverse();
+      modes.noalias() = basis * solver.eigenvectors().rowwise().reverse();
+      mode_products.noalias() =
+          products * solver.eigenvectors().rowwise().reverse();
+
+      // Ritz values do not exceed the eigenvalues, so the subspace is grown
+      // until its modes hold the requested energy
+      if (eigenvalues.sum() < kept_energy && basis.cols() < num_points) {
+        Eigen::Index num_columns =
+            std::min<Eigen::Index>(num_points, 2 * basis.cols());
+        if (num_columns > max_subspace) {
+          use_cholesky = true;
+          retry_freq = i + retry_interval;
+          basis = modes;
+          break;
+        }
+        Eigen::MatrixXd columns(num_points, num_columns);
+        columns << modes, density_columns(num_columns - modes.cols());
+        basis = orthonormalize(columns);
+        continue;
+      }
+
+      // Keep the fewest modes holding the requested energy, and at least the
+      // dominant mode
+      double mode_energy = 0.0;
+      num_modes = 0;
+      while (num_modes < eigenvalues.size() &&
+             (num_modes == 0 || mode_energy < kept_energy)) {
+        mode_energy += eigenvalues(num_modes);
+        ++num_modes;
+      }
+
+      double residual = 0.0;
+      for (Eigen::Index j = 0; j < num_modes; ++j) {
+        residual = std::max(
+            residual,
+            (mode_products.col(j) - eigenvalues(j) * modes.col(j)).norm());
+      }
+      if (residual <= residual_tol * eigenvalues(0) ||
+          basis.cols() == num_points) {
+        break;
+      }
+
+      basis = orthonormalize(mode_products);
+    }
+
+    if (use_cholesky) {
+      // This is Equation 5(a) from Wittig & Sinha (1975)
+      llt.compute(cross_spec_density_matrix);
+      if (llt.info() == Eigen::NumericalIssue) {
+        positive_definite = false;
+      }
+      complex_random.row(i).transpose().noalias() =
+          llt.matrixL() * white_noise.col(i);
+      complex_random.row(i) *= scale;
+      continue;
+    }
+
+    // Complex random numbers are the modes scaled by the square root of
+    // their eigenvalues applied to the leading white noise of the frequency
+    Eigen::VectorXcd mode_noise =
+        white_noise.col(i).head(num_modes).cwiseProduct(
+            eigenvalues.head(num_modes)
+                .cwiseMax(0.0)
+                .cwiseSqrt()
+                .cast<std::complex<double>>());
+    complex_random.row(i).transpose().noalias() =
+        modes.leftCols(num_modes) * mode_noise;
+    complex_random.row(i) *= scale;
+
+    // Next frequency starts from the kept modes along with a few extra ones
+    basis = modes.leftCols(
+        std::min<Eigen::Index>(modes.cols(), num_modes + num_extra_modes));
+  }
+
+  return positive_definite;
 }
 
 std::vector<double> stochastic::WittigSinha::gen_location_hist(
     const Eigen::MatrixXcd& random_numbers, unsigned int column_index,
     bool units) const {
 
-  // This following block implements what is expressed in Equations 7 & 8
-  Eigen::VectorXcd complex_full_range = Eigen::VectorXcd::Zero(2 * num_freqs_);
+  // This following block implements what is expressed in Equations 7 & 8.
+  // The full range of random numbers is conjugate-even, so only its
+  // non-redundant first half is formed.
+  Eigen::VectorXcd complex_half_range(num_freqs_ + 1);
+  complex_half_range(0) = 0.0;
+  complex_half_range.segment(1, num_freqs_ - 1) =
+      random_numbers.block(0, column_index, num_freqs_ - 1, 1);
+  complex_half_range(num_freqs_) =
+      std::abs(random_numbers(num_freqs_ - 1, column_index));
 
-  complex_full_range.segment(1, num_freqs_) =
-      random_numbers.block(0, column_index, num_freqs_, 1);
-
-  complex_full_range.segment(num_freqs_ + 1, num_freqs_ - 1) =
-      random_numbers.block(0, column_index, num_freqs_ - 1, 1)
-          .reverse()
-          .conjugate();
- 
-  complex_full_range(num_freqs_) = std::abs(random_numbers(num_freqs_ - 1, column_index)); 
-
-  // Calculate wind speed using real portion of inverse Fast Fourier Transform
-  // full range of random numbers
-  std::vector<double> node_time_history(complex_full_range.size());
-  numeric_utils::inverse_fft(complex_full_range, node_time_history);
+  // Calculate wind speed using real inverse Fast Fourier Transform of full
+  // range of random numbers
+  std::vector<double> node_time_history(2 * num_freqs_);
+  numeric_utils::inverse_real_fft(complex_half_range.data(),
+                                  node_time_history.size(),
+                                  node_time_history.data());
 
   // Check if time histories need to be converted to ft/s
   if (units) {
@@ -333,3 +1088,30 @@ std::vector<double> stochastic::WittigSinha::gen_location_hist(
   
   return node_time_history;
 }
+
+std::vector<std::vector<double>> stochastic::WittigSinha::gen_location_hists(
+    const Eigen::MatrixXcd& random_numbers, bool units) const {
+  Eigen::MatrixXd node_time_histories;
+  gen_location_hists(random_numbers, node_time_histories, units);
+
+  std::vector<std::vector<double>> time_histories(random_numbers.cols());
+  for (unsigned int i = 0; i < time_histories.size(); ++i) {
+    time_histories[i].assign(
+        node_time_histories.col(i).data(),
+        node_time_histories.col(i).data() + node_time_histories.rows());
+  }
+
+  return time_histories;
+}
+
+void stochastic::WittigSinha::gen_location_hists(
+    const Eigen::MatrixXcd& random_numbers, Eigen::MatrixXd& time_histories,
+    bool units) const {
+  half_range_velocities(random_numbers, num_freqs_, units, time_histories);
+}
+
+void stochastic::WittigSinha::gen_location_hists(
+    const Eigen::MatrixXcf& random_numbers, Eigen::MatrixXf& time_histories,
+    bool units) const {
+  half_range_velocities(random_numbers, num_freqs_, units, time_histories);
+}
@@ -64,4 +64,27 @@ TEST_CASE("Check the dispatcher class implementation", "[Dispatcher]") {
       std::cout << "Dispatcher error: " << exception.what() << std::endl;
     }
   }
+
+  SECTION("Resolve handles to registered functions") {
+    DispatchRegister<int, int, int> add_integers(
+        "AddIntegers", [](int first, int second) { return first + second; });
+
+    auto add = Dispatcher<int, int, int>::instance()->resolve("AddIntegers");
+    REQUIRE(add);
+    REQUIRE(add(2, 3) == 5);
+
+    // Handles are copyable and refer to the same function
+    auto add_copy = add;
+    REQUIRE(add_copy(4, 5) ==
+            (Dispatcher<int, int, int>::instance()->dispatch("AddIntegers", 4,
+                                                              5)));
+
+    // Empty handles and unknown keys throw
+    Dispatcher<int, int, int>::Handle empty;
+    REQUIRE(!empty);
+    REQUIRE_THROWS_AS(empty(1, 2), std::runtime_error);
+    REQUIRE_THROWS_AS(
+        (Dispatcher<int, int, int>::instance()->resolve("NoFunc")),
+        std::runtime_error);
+  }
 }
@@ -1,9 +1,14 @@
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 #include <catch2/catch.hpp>
 #include <Eigen/Dense>
+#include "configure.h"
 #include "factory.h"
 #include "normal_dist.h"
+#include "tabulated_dist.h"
 
 TEST_CASE("Test different distribution types", "[Distributions]") {
 
@@ -113,4 +118,143 @@ TEST_CASE("Test different distribution types", "[Distributions]") {
     REQUIRE(probabilities[2] == Approx(1.0).epsilon(0.01));
     REQUIRE(calced_locations[2] == Approx(1.0).epsilon(0.01));
   }
+
+  SECTION("Test batch evaluation and transformation from standard normal") {
+    std::vector<std::shared_ptr<stochastic::Distribution>> distributions = {
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "NormalDist", std::move(1.5), std::move(2.0)),
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "LognormalDist", std::move(0.3), std::move(0.5)),
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "BetaDist", std::move(2.0), std::move(3.0)),
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "UniformDist", std::move(-1.0), std::move(4.0))};
+
+    std::vector<double> std_normal_values = {-2.5, -1.0, -0.1, 0.0,
+                                             0.4,  1.3,  2.2};
+    auto std_normal =
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "NormalDist", std::move(0.0), std::move(1.0));
+    auto probabilities = std_normal->cumulative_dist_func(std_normal_values);
+
+    for (auto const& distribution : distributions) {
+      // Fused transformation matches ICDF of standard normal CDF
+      auto expected = distribution->inv_cumulative_dist_func(probabilities);
+      std::vector<double> transformed(std_normal_values.size());
+      distribution->transform_from_std_normal(
+          std_normal_values.data(), transformed.data(), transformed.size());
+
+      // Batch CDF recovers probabilities, also when evaluated in place
+      std::vector<double> batch_probabilities = transformed;
+      distribution->cumulative_dist_func(batch_probabilities.data(),
+                                         batch_probabilities.data(),
+                                         batch_probabilities.size());
+
+      for (unsigned int i = 0; i < transformed.size(); ++i) {
+        REQUIRE(transformed[i] == Approx(expected[i]).epsilon(1.0e-8));
+        REQUIRE(batch_probabilities[i] ==
+                Approx(probabilities[i]).epsilon(1.0e-8));
+      }
+    }
+
+    // Lognormal CDF is zero for non-positive locations
+    std::vector<double> locations = {-1.0, 0.0, 1.0};
+    std::vector<double> evaluations(locations.size());
+    distributions[1]->cumulative_dist_func(locations.data(), evaluations.data(),
+                                           locations.size());
+    REQUIRE(evaluations[0] == 0.0);
+    REQUIRE(evaluations[1] == 0.0);
+    REQUIRE(evaluations[2] > 0.0);
+  }
+
+  SECTION("Test tabulated inverse CDF against exact inverse CDF") {
+    std::vector<std::shared_ptr<stochastic::Distribution>> exact = {
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "BetaDist", std::move(2.0), std::move(5.0)),
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "InverseGaussianDist", std::move(1.0), std::move(0.5)),
+        Factory<stochastic::Distribution, double, double, double>::instance()
+            ->create("StudentstDist", std::move(1.0), std::move(2.0),
+                     std::move(5.0))};
+    double max_error = 1.0e-7;
+    std::vector<std::shared_ptr<stochastic::Distribution>> tabulated = {
+        Factory<stochastic::Distribution, double, double, double>::instance()
+            ->create("TabulatedBetaDist", std::move(2.0), std::move(5.0),
+                     std::move(max_error)),
+        Factory<stochastic::Distribution, double, double, double>::instance()
+            ->create("TabulatedInverseGaussianDist", std::move(1.0),
+                     std::move(0.5), std::move(max_error)),
+        Factory<stochastic::Distribution, double, double, double, double>::
+            instance()
+                ->create("TabulatedStudentstDist", std::move(1.0),
+                         std::move(2.0), std::move(5.0), std::move(max_error))};
+
+    REQUIRE(tabulated[0]->name() == "TabulatedBetaDist");
+
+    // Points between table points, including beyond table range
+    std::vector<double> std_normal_values;
+    for (double value = -7.0; value <= 7.0; value += 0.01237) {
+      std_normal_values.push_back(value);
+    }
+
+    for (unsigned int i = 0; i < exact.size(); ++i) {
+      std::vector<double> expected(std_normal_values.size()),
+          interpolated(std_normal_values.size());
+      exact[i]->transform_from_std_normal(
+          std_normal_values.data(), expected.data(), expected.size());
+      tabulated[i]->transform_from_std_normal(
+          std_normal_values.data(), interpolated.data(), interpolated.size());
+
+      for (unsigned int j = 0; j < expected.size(); ++j) {
+        REQUIRE(std::abs(interpolated[j] - expected[j]) <=
+                2.0 * max_error * std::max(1.0, std::abs(expected[j])));
+        if (j > 0) {
+          REQUIRE(interpolated[j] >= interpolated[j - 1]);
+        }
+      }
+
+      // Inverse CDF and CDF go through same table and exact distribution
+      std::vector<double> probabilities = {0.001, 0.2, 0.5, 0.9, 0.999};
+      auto exact_locations = exact[i]->inv_cumulative_dist_func(probabilities);
+      auto tabulated_locations =
+          tabulated[i]->inv_cumulative_dist_func(probabilities);
+      auto tabulated_probabilities =
+          tabulated[i]->cumulative_dist_func(exact_locations);
+      for (unsigned int j = 0; j < probabilities.size(); ++j) {
+        REQUIRE(tabulated_locations[j] ==
+                Approx(exact_locations[j]).epsilon(1.0e-6).margin(1.0e-6));
+        REQUIRE(tabulated_probabilities[j] ==
+                Approx(probabilities[j]).epsilon(1.0e-8));
+      }
+    }
+
+    // Looser error needs smaller table
+    auto coarse = std::make_shared<stochastic::TabulatedBetaDistribution>(
+        2.0, 5.0, 1.0e-3);
+    auto fine = std::make_shared<stochastic::TabulatedBetaDistribution>(
+        2.0, 5.0, 1.0e-7);
+    REQUIRE(coarse->table_size() < fine->table_size());
+    REQUIRE_THROWS_AS(stochastic::TabulatedBetaDistribution(2.0, 5.0, 0.0),
+                      std::runtime_error);
+  }
+
+  SECTION("Test tabulated switch leaves distribution keys unchanged") {
+    config::set_tabulated_distributions(true);
+    REQUIRE(config::tabulated_distributions());
+    auto beta = Factory<stochastic::Distribution, double, double>::instance()
+                    ->create("BetaDist", std::move(2.0), std::move(5.0));
+    auto inv_gauss =
+        Factory<stochastic::Distribution, double, double>::instance()->create(
+            "InverseGaussianDist", std::move(1.0), std::move(0.5));
+    auto students_t =
+        Factory<stochastic::Distribution, double, double, double>::instance()
+            ->create("StudentstDist", std::move(1.0), std::move(2.0),
+                     std::move(5.0));
+    config::set_tabulated_distributions(false);
+
+    REQUIRE(beta->name() == "BetaDist");
+    REQUIRE(inv_gauss->name() == "InverseGaussianDist");
+    REQUIRE(students_t->name() == "StudentstDist");
+    REQUIRE(!config::tabulated_distributions());
+  }
 }
@@ -96,4 +96,28 @@ TEST_CASE("Check the factory class implementation", "[Factory]") {
       ->create("TestingClass", std::move(seed));
     REQUIRE(testing_class->name() == "TestingClass");    
   }
+
+  SECTION("Resolve handles to registered creators") {
+    auto creator = Factory<BaseClass>::instance()->resolve("DerivedClass");
+    REQUIRE(creator);
+    REQUIRE(creator.create()->name() == "DerivedClass");
+
+    // Handles are copyable and create new instances each time
+    auto creator_copy = creator;
+    REQUIRE(creator_copy.create() != creator.create());
+
+    Register<numeric_utils::RandomGenerator, numeric_utils::TestingClass, int>
+        testing_multivar("TestingClass");
+    auto testing_creator =
+        Factory<numeric_utils::RandomGenerator, int>::instance()->resolve(
+            "TestingClass");
+    REQUIRE(testing_creator.create(std::move(seed))->name() == "TestingClass");
+
+    // Empty handles and unknown keys throw
+    Factory<BaseClass>::Handle empty;
+    REQUIRE(!empty);
+    REQUIRE_THROWS_AS(empty.create(), std::runtime_error);
+    REQUIRE_THROWS_AS(Factory<BaseClass>::instance()->resolve("Garbage"),
+                      std::runtime_error);
+  }
 }
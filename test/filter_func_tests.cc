@@ -1,5 +1,8 @@
 #include <vector>
 #include <catch2/catch.hpp>
+#include <Eigen/Dense>
+#include "configure.h"
+#include "filter_bank.h"
 #include "function_dispatcher.h"
 
 TEST_CASE("Test filter functions", "[FilterFuncs][Helpers]") {
@@ -153,3 +156,78 @@ TEST_CASE("Test filter functions", "[FilterFuncs][Helpers]") {
     }        
   }
 }
+
+TEST_CASE("Test filter bank", "[FilterFuncs][Helpers]") {
+  config::initialize();
+  signal_processing::FilterBank::clear();
+
+  SECTION("Test repeated requests share kernels") {
+    auto coefficients =
+        signal_processing::FilterBank::highpass_butterworth(2, 0.5);
+    REQUIRE(signal_processing::FilterBank::highpass_butterworth(2, 0.5) ==
+            coefficients);
+    REQUIRE(signal_processing::FilterBank::highpass_butterworth(2, 0.25) !=
+            coefficients);
+
+    auto response =
+        signal_processing::FilterBank::highpass_impulse_response(4, 0.2, 64);
+    REQUIRE(signal_processing::FilterBank::highpass_impulse_response(
+                4, 0.2, 64) == response);
+    REQUIRE(signal_processing::FilterBank::highpass_impulse_response(
+                4, 0.2, 32) != response);
+
+    auto filter =
+        signal_processing::FilterBank::acausal_highpass(0.1, 0.01, 4, 128);
+    REQUIRE(signal_processing::FilterBank::acausal_highpass(0.1, 0.01, 4,
+                                                            128) == filter);
+    REQUIRE(signal_processing::FilterBank::acausal_highpass(0.1, 0.02, 4,
+                                                            128) != filter);
+
+    auto window = signal_processing::FilterBank::hann_window(10);
+    REQUIRE(signal_processing::FilterBank::hann_window(10) == window);
+
+    // Kernels remain valid after cache is cleared
+    signal_processing::FilterBank::clear();
+    REQUIRE(signal_processing::FilterBank::size() == 0);
+    REQUIRE(window->size() == 10);
+    REQUIRE(signal_processing::FilterBank::hann_window(10) != window);
+  }
+
+  SECTION("Test kernels match dispatched functions") {
+    int filter_order = 4;
+    double cutoff_freq = 0.2;
+    int num_samples = 64;
+    auto hp_butter =
+        Dispatcher<std::vector<std::vector<double>>, int, double>::instance()
+            ->dispatch("HighPassButter", filter_order, cutoff_freq);
+    auto expected_response =
+        Dispatcher<std::vector<double>, std::vector<double>,
+                   std::vector<double>, int, int>::instance()
+            ->dispatch("ImpulseResponse", hp_butter[0], hp_butter[1],
+                       filter_order, num_samples);
+    REQUIRE(*signal_processing::FilterBank::highpass_butterworth(
+                filter_order, cutoff_freq) == hp_butter);
+    REQUIRE(*signal_processing::FilterBank::highpass_impulse_response(
+                filter_order, cutoff_freq, num_samples) == expected_response);
+
+    double freq_corner = 0.1, time_step = 0.01;
+    unsigned int order = 4, length = 128;
+    auto expected_filter =
+        Dispatcher<std::vector<double>, double, double, unsigned int,
+                   unsigned int>::instance()
+            ->dispatch("AcausalHighpassButterworth", freq_corner, time_step,
+                       order, length);
+    REQUIRE(*signal_processing::FilterBank::acausal_highpass(
+                freq_corner, time_step, order, length) == expected_filter);
+
+    unsigned int window_length = 10;
+    auto expected_window =
+        Dispatcher<Eigen::VectorXd, unsigned int>::instance()->dispatch(
+            "HannWindow", window_length);
+    auto window = signal_processing::FilterBank::hann_window(window_length);
+    REQUIRE(window->size() == window_length);
+    for (unsigned int i = 0; i < window_length; ++i) {
+      REQUIRE((*window)[i] == expected_window(i));
+    }
+  }
+}
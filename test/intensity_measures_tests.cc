@@ -0,0 +1,79 @@
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <Eigen/Dense>
+#include "intensity_measures.h"
+
+TEST_CASE("Test intensity measure calculations", "[Helpers][Seismic]") {
+  double time_step = 0.01;
+  std::vector<double> accel = {0.0, 1.0, -2.0, 0.5, 0.0, -1.0, 3.0, 0.0};
+
+  SECTION("Test Arias intensity") {
+    double energy = 0.0;
+    for (auto value : accel) {
+      energy += value * value;
+    }
+
+    REQUIRE(numeric_utils::arias_intensity(accel.data(), accel.size(),
+                                           time_step) ==
+            Approx(energy * time_step * M_PI / 2.0));
+
+    Eigen::MatrixXd accels(accel.size(), 2);
+    accels.col(0) = Eigen::Map<Eigen::VectorXd>(accel.data(), accel.size());
+    accels.col(1) = 2.0 * accels.col(0);
+    auto intensities = numeric_utils::arias_intensity(accels, time_step);
+    REQUIRE(intensities.size() == 2);
+    REQUIRE(intensities(0) == Approx(energy * time_step * M_PI / 2.0));
+    REQUIRE(intensities(1) == Approx(4.0 * intensities(0)));
+  }
+
+  SECTION("Test intensity indices against cumulative intensity") {
+    std::vector<double> cumulative(accel.size());
+    std::transform(accel.begin(), accel.end(), cumulative.begin(),
+                   [](double value) { return value * value; });
+    std::partial_sum(cumulative.begin(), cumulative.end(), cumulative.begin());
+
+    // Unsorted percentages, including one that is never reached
+    std::vector<double> percentages = {95.0, 5.0, 30.0, 0.0, 100.0, 101.0};
+    std::vector<std::size_t> indices(percentages.size());
+    numeric_utils::intensity_indices(accel.data(), accel.size(),
+                                     percentages.data(), indices.data(),
+                                     percentages.size());
+
+    for (unsigned int j = 0; j < percentages.size(); ++j) {
+      std::size_t expected = accel.size();
+      for (std::size_t i = 0; i < cumulative.size(); ++i) {
+        if (cumulative[i] / cumulative.back() * 100.0 >= percentages[j]) {
+          expected = i;
+          break;
+        }
+      }
+      REQUIRE(indices[j] == expected);
+    }
+    REQUIRE(indices[3] == 0);
+    REQUIRE(indices[5] == accel.size());
+
+    // Batched indices match single time history indices
+    Eigen::MatrixXd accels(accel.size(), 2);
+    accels.col(0) = Eigen::Map<Eigen::VectorXd>(accel.data(), accel.size());
+    accels.col(1) = accels.col(0).reverse();
+    auto batch_indices = numeric_utils::intensity_indices(accels, percentages);
+    REQUIRE(batch_indices.size() == 2);
+    REQUIRE(batch_indices[0] == indices);
+    REQUIRE(batch_indices[1][1] == 1);
+  }
+
+  SECTION("Test significant duration") {
+    // 5% reached at index 1 and 95% at index 6
+    REQUIRE(numeric_utils::significant_duration(accel.data(), accel.size(),
+                                                time_step) ==
+            Approx(5.0 * time_step));
+    REQUIRE(numeric_utils::significant_duration(accel.data(), accel.size(),
+                                                time_step, 5.0, 30.0) ==
+            Approx(1.0 * time_step));
+  }
+}
@@ -1,8 +1,17 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <catch2/catch.hpp>
 #include <nlohmann/json.hpp>
+#include "binary_file_writer.h"
+#include "json_event_writer.h"
 #include "json_object.h"
+#include "time_history_block.h"
 
 TEST_CASE("Test JSON object wrapper", "[Helpers][Json]") { 
   SECTION("Test JSON object basic functionality") {
@@ -44,4 +53,405 @@ TEST_CASE("Test JSON object wrapper", "[Helpers][Json]") {
     test_object.clear();
     REQUIRE(test_object.is_empty());
   }
+
+  SECTION("Test adding array of values from pointer") {
+    utilities::JsonObject test_object;
+    std::vector<double> double_vec = {0.0, 1.0, 2.0, 3.0};
+    REQUIRE(test_object.add_array("Array", double_vec.data() + 1, 2));
+    REQUIRE(test_object.get_value<std::vector<double>>("Array") ==
+            std::vector<double>({1.0, 2.0}));
+    REQUIRE_THROWS(test_object.add_array("Array", double_vec.data(), 4));
+
+    // Same JSON as adding vector
+    utilities::JsonObject vector_object;
+    vector_object.add_value("Array", std::vector<double>({1.0, 2.0}));
+    REQUIRE(vector_object == test_object);
+  }
+
+  SECTION("Test reading JSON object from file") {
+    utilities::JsonObject test_object;
+    test_object.add_value("Vector", std::vector<double>({0.1, 1.0 / 3.0}));
+    test_object.add_value("Seed", std::uint64_t(1) << 63);
+    REQUIRE(test_object.write_to_file("./json_object_read.json"));
+
+    utilities::JsonObject read_object;
+    read_object.add_value("Foo", 17);
+    REQUIRE(read_object.read_from_file("./json_object_read.json"));
+    REQUIRE(read_object == test_object);
+
+    std::ofstream("./json_object_invalid.json") << "[1, 2";
+    REQUIRE_THROWS_AS(read_object.read_from_file("./json_object_invalid.json"),
+                      std::runtime_error);
+    std::ofstream("./json_object_invalid.json") << "[1, 2]";
+    REQUIRE_THROWS_AS(read_object.read_from_file("./json_object_invalid.json"),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(read_object.read_from_file("./missing/file.json"),
+                      std::runtime_error);
+  }
+}
+
+TEST_CASE("Test time history block", "[Helpers]") {
+  SECTION("Test block of records with equal lengths") {
+    utilities::TimeHistoryBlock block(3, 2, 4, 0.01);
+    REQUIRE(block.num_records() == 3);
+    REQUIRE(block.num_components() == 2);
+    REQUIRE(block.num_steps(2) == 4);
+    REQUIRE(block.time_step() == 0.01);
+    REQUIRE(block.size() == 24);
+    REQUIRE(block.values() == std::vector<double>(24, 0.0));
+
+    // Components are contiguous and records follow each other
+    REQUIRE(block.data(0, 1) == block.data(0, 0) + 4);
+    REQUIRE(block.data(1, 0) == block.data(0, 0) + 8);
+
+    // Record views share storage with component pointers
+    block.record(1).col(1).setConstant(2.5);
+    block.data(1, 0)[3] = -1.0;
+    REQUIRE(block.component(1, 1) == std::vector<double>(4, 2.5));
+    REQUIRE(block.record(1)(3, 0) == -1.0);
+    REQUIRE(block.component(0, 0) == std::vector<double>(4, 0.0));
+    REQUIRE(block.component(2, 1) == std::vector<double>(4, 0.0));
+  }
+
+  SECTION("Test block of records with different lengths") {
+    utilities::TimeHistoryBlock block(std::vector<std::size_t>({3, 0, 5}), 2,
+                                      0.005);
+    REQUIRE(block.num_records() == 3);
+    REQUIRE(block.num_steps(0) == 3);
+    REQUIRE(block.num_steps(1) == 0);
+    REQUIRE(block.num_steps(2) == 5);
+    REQUIRE(block.size() == 16);
+    REQUIRE(block.data(2, 0) == block.data(0, 0) + 6);
+    REQUIRE(block.record(2).rows() == 5);
+    REQUIRE(block.record(2).cols() == 2);
+    REQUIRE(block.component(1, 1).empty());
+
+    utilities::TimeHistoryBlock empty_block;
+    REQUIRE(empty_block.num_records() == 0);
+    REQUIRE(empty_block.size() == 0);
+  }
+
+  SECTION("Test window of time steps of records") {
+    utilities::TimeHistoryBlock block(std::vector<std::size_t>({6, 2}), 2,
+                                      0.01);
+    for (std::size_t i = 0; i < 6; ++i) {
+      block.data(0, 0)[i] = i;
+      block.data(0, 1)[i] = -1.0 * i;
+    }
+    block.data(1, 1)[1] = 3.0;
+
+    auto window = block.window(1, 3);
+    REQUIRE(window.num_records() == 2);
+    REQUIRE(window.time_step() == 0.01);
+    REQUIRE(window.component(0, 0) == std::vector<double>({1.0, 2.0, 3.0}));
+    REQUIRE(window.component(0, 1) ==
+            std::vector<double>({-1.0, -2.0, -3.0}));
+    REQUIRE(window.component(1, 1) == std::vector<double>({3.0}));
+    REQUIRE(block.window(4, 10).num_steps(0) == 2);
+    REQUIRE(block.window(4, 10).num_steps(1) == 0);
+  }
+}
+
+namespace {
+std::string file_contents(const std::string& file_name) {
+  std::ifstream file(file_name);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+}  // namespace
+
+TEST_CASE("Test streaming JSON event writer", "[Helpers][Json]") {
+  std::vector<utilities::JsonObject> events(3);
+  for (unsigned int i = 0; i < events.size(); ++i) {
+    events[i].add_value("name", "Event" + std::to_string(i));
+    events[i].add_value("dT", 0.01);
+    events[i].add_value("data", std::vector<double>{0.5 * i, -1.25, 3.0e-5});
+    utilities::JsonObject pattern;
+    pattern.add_value("type", "Value\nwith line break");
+    events[i].add_value("pattern",
+                        std::vector<utilities::JsonObject>{pattern, pattern});
+  }
+
+  SECTION("Test streamed output matches output of JSON object") {
+    utilities::JsonObject all_events;
+    all_events.add_value("Events", events);
+    all_events.write_to_file("./json_object_events.json");
+
+    utilities::JsonEventWriter writer("./json_writer_events.json");
+    for (const auto& event : events) {
+      writer.write_event(event);
+    }
+    REQUIRE(writer.num_events() == 3);
+    REQUIRE(writer.close());
+    REQUIRE_THROWS(writer.write_event(events[0]));
+
+    REQUIRE(file_contents("./json_writer_events.json") ==
+            file_contents("./json_object_events.json"));
+  }
+
+  SECTION("Test streamed output without events") {
+    utilities::JsonObject no_events;
+    no_events.add_value("Events", std::vector<utilities::JsonObject>());
+    no_events.write_to_file("./json_object_no_events.json");
+
+    {
+      // Destructor closes output location
+      utilities::JsonEventWriter writer("./json_writer_no_events.json");
+    }
+
+    REQUIRE(file_contents("./json_writer_no_events.json") ==
+            file_contents("./json_object_no_events.json"));
+  }
+
+  SECTION("Test appended events match output of JSON object") {
+    utilities::JsonObject all_events;
+    all_events.add_value("Events", events);
+    utilities::JsonFormat compact_format;
+    compact_format.compact = true;
+
+    for (const auto& format : {utilities::JsonFormat(), compact_format}) {
+      all_events.write_to_file("./json_object_events.json", format);
+
+      // Start from an empty events array and append in two steps
+      utilities::JsonEventWriter("./json_writer_append.json", format).close();
+      {
+        utilities::JsonEventWriter writer("./json_writer_append.json", format,
+                                          true);
+        writer.write_event(events[0]);
+      }
+      utilities::JsonEventWriter writer("./json_writer_append.json", format,
+                                        true);
+      writer.write_event(events[1]);
+      writer.write_event(events[2]);
+      REQUIRE(writer.num_events() == 2);
+      REQUIRE(writer.close());
+
+      REQUIRE(file_contents("./json_writer_append.json") ==
+              file_contents("./json_object_events.json"));
+
+      // Appending no events keeps the file
+      utilities::JsonEventWriter("./json_writer_append.json", format, true)
+          .close();
+      REQUIRE(file_contents("./json_writer_append.json") ==
+              file_contents("./json_object_events.json"));
+    }
+
+    // Files must end with an events array of the same format
+    REQUIRE_THROWS(utilities::JsonEventWriter("./json_writer_append.json",
+                                              utilities::JsonFormat(), true));
+    REQUIRE_THROWS(utilities::JsonEventWriter("./no_such_file.json",
+                                              compact_format, true));
+  }
+
+  SECTION("Test invalid output location") {
+    REQUIRE_THROWS(utilities::JsonEventWriter("./no_such_dir/events.json"));
+  }
+}
+
+TEST_CASE("Test binary file writer", "[Helpers]") {
+  SECTION("Test layout of binary file") {
+    utilities::TimeHistoryBlock block(std::vector<std::size_t>({3, 5}), 2,
+                                      0.01);
+    for (std::size_t i = 0; i < block.size(); ++i) {
+      block.data(0, 0)[i] = 0.25 * i - 1.0;
+    }
+
+    utilities::BinaryFileWriter writer;
+    std::vector<double> extra = {7.0};
+    auto offsets = writer.add_records(block);
+    REQUIRE(offsets == std::vector<std::size_t>({0, 64, 128, 192}));
+    REQUIRE(writer.add_array(extra.data(), extra.size()) == 256);
+    REQUIRE(writer.data_size() == 264);
+
+    utilities::JsonObject header;
+    header.add_value("dT", block.time_step());
+    header.add_value("offsets", offsets);
+    REQUIRE(writer.write("./binary_writer_test.bin", header));
+
+    auto contents = file_contents("./binary_writer_test.bin");
+    REQUIRE(contents.compare(0, 8, "SMELTBIN") == 0);
+    std::uint32_t version, byte_order_mark;
+    std::uint64_t alignment, header_size, data_offset, data_size;
+    std::memcpy(&version, contents.data() + 8, sizeof(version));
+    std::memcpy(&byte_order_mark, contents.data() + 12,
+                sizeof(byte_order_mark));
+    std::memcpy(&alignment, contents.data() + 16, sizeof(alignment));
+    std::memcpy(&header_size, contents.data() + 24, sizeof(header_size));
+    std::memcpy(&data_offset, contents.data() + 32, sizeof(data_offset));
+    std::memcpy(&data_size, contents.data() + 40, sizeof(data_size));
+    REQUIRE(version == 1);
+    REQUIRE(byte_order_mark == 0x01020304);
+    REQUIRE(alignment == 64);
+    REQUIRE(data_offset % 64 == 0);
+    REQUIRE(data_size == 264);
+    REQUIRE(contents.size() == data_offset + data_size);
+
+    auto parsed_header = nlohmann::json::parse(contents.substr(64, header_size));
+    REQUIRE(parsed_header == header.get_library_json());
+
+    for (std::size_t i = 0; i < block.num_records(); ++i) {
+      for (std::size_t j = 0; j < block.num_components(); ++j) {
+        std::vector<double> values(block.num_steps(i));
+        std::memcpy(values.data(),
+                    contents.data() + data_offset +
+                        offsets[i * block.num_components() + j],
+                    values.size() * sizeof(double));
+        REQUIRE(values == block.component(i, j));
+      }
+    }
+    double extra_value;
+    std::memcpy(&extra_value, contents.data() + data_offset + 256,
+                sizeof(double));
+    REQUIRE(extra_value == 7.0);
+  }
+
+  SECTION("Test appending to binary file") {
+    std::vector<double> first = {1.0, 2.0, 3.0}, second = {-4.0, 5.5};
+    utilities::JsonObject first_event, second_event;
+    utilities::BinaryFileWriter first_writer;
+    first_event.add_value(
+        "dataOffset", first_writer.add_array(first.data(), first.size()));
+    utilities::JsonObject first_header;
+    first_header.add_value("Events",
+                           std::vector<utilities::JsonObject>{first_event});
+    REQUIRE(first_writer.write("./binary_writer_append.bin", first_header));
+
+    // Appended arrays follow the existing data section
+    utilities::BinaryFileWriter writer;
+    writer.append_to("./binary_writer_append.bin");
+    std::size_t second_offset = writer.add_array(second.data(), second.size());
+    REQUIRE(second_offset == 64);
+    REQUIRE(writer.data_size() == 80);
+    second_event.add_value("dataOffset", second_offset);
+    utilities::JsonObject second_header;
+    second_header.add_value("Events",
+                            std::vector<utilities::JsonObject>{second_event});
+    REQUIRE(writer.write("./binary_writer_append.bin", second_header));
+    REQUIRE_THROWS(writer.append_to("./binary_writer_append.bin"));
+
+    auto contents = file_contents("./binary_writer_append.bin");
+    std::uint64_t header_size, data_offset, data_size;
+    std::memcpy(&header_size, contents.data() + 24, sizeof(header_size));
+    std::memcpy(&data_offset, contents.data() + 32, sizeof(data_offset));
+    std::memcpy(&data_size, contents.data() + 40, sizeof(data_size));
+    REQUIRE(data_size == 80);
+    REQUIRE(contents.size() == data_offset + data_size);
+    auto parsed_header = nlohmann::json::parse(contents.substr(64, header_size));
+    REQUIRE(parsed_header["Events"].size() == 2);
+    REQUIRE(parsed_header["Events"][0] == first_event.get_library_json());
+    REQUIRE(parsed_header["Events"][1] == second_event.get_library_json());
+
+    std::vector<double> first_values(first.size()),
+        second_values(second.size());
+    std::memcpy(first_values.data(), contents.data() + data_offset,
+                first.size() * sizeof(double));
+    std::memcpy(second_values.data(), contents.data() + data_offset + 64,
+                second.size() * sizeof(double));
+    REQUIRE(first_values == first);
+    REQUIRE(second_values == second);
+
+    utilities::BinaryFileWriter invalid_writer;
+    REQUIRE_THROWS(invalid_writer.append_to("./json_object_events.json"));
+    REQUIRE_THROWS(invalid_writer.append_to("./no_such_file.bin"));
+  }
+
+  SECTION("Test invalid output location") {
+    utilities::BinaryFileWriter writer;
+    REQUIRE_THROWS(
+        writer.write("./no_such_dir/events.bin", utilities::JsonObject()));
+  }
+}
+
+TEST_CASE("Test JSON output formatting options", "[Helpers][Json]") {
+  utilities::JsonObject test_object;
+  test_object.add_value("string", "Quote \" and\ttab\n");
+  test_object.add_value("integer", -17);
+  test_object.add_value("unsigned", 4000000000u);
+  test_object.add_value("flag", false);
+  test_object.add_value("empty array", std::vector<double>());
+  test_object.add_value("empty object", utilities::JsonObject());
+  test_object.add_value("doubles",
+                        std::vector<double>{1.0, -0.1, 1.0e-300, 123456.789,
+                                            1.0 / 3.0});
+  std::vector<double> large_array(20000);
+  for (unsigned int i = 0; i < large_array.size(); ++i) {
+    large_array[i] = std::sin(0.01 * i) * 1.0e3;
+  }
+  utilities::JsonObject nested_object;
+  nested_object.add_value("data", large_array);
+  nested_object.add_value("nested", std::vector<std::vector<int>>{{1, 2}, {}});
+  test_object.add_value("nested object",
+                        std::vector<utilities::JsonObject>{nested_object});
+  auto library_json = test_object.get_library_json();
+
+  SECTION("Test default options match prettified output") {
+    utilities::JsonFormat format;
+    test_object.write_to_file("./json_format_pretty.json");
+    test_object.write_to_file("./json_format_default.json", format);
+    REQUIRE(file_contents("./json_format_default.json") ==
+            file_contents("./json_format_pretty.json"));
+
+    // Formatting in parallel gives the same output
+    format.num_threads = 4;
+    test_object.write_to_file("./json_format_parallel.json", format);
+    REQUIRE(file_contents("./json_format_parallel.json") ==
+            file_contents("./json_format_pretty.json"));
+  }
+
+  SECTION("Test compact output") {
+    utilities::JsonFormat format;
+    format.compact = true;
+    std::ostringstream serial_stream;
+    test_object.write(serial_stream, format);
+    REQUIRE(serial_stream.str() == library_json.dump());
+
+    format.num_threads = 3;
+    std::ostringstream parallel_stream;
+    test_object.write(parallel_stream, format);
+    REQUIRE(parallel_stream.str() == library_json.dump());
+  }
+
+  SECTION("Test output with significant digits") {
+    utilities::JsonFormat format;
+    format.compact = true;
+    format.significant_digits = 4;
+    utilities::JsonObject doubles_object;
+    doubles_object.add_value(
+        "doubles", std::vector<double>{2.0, -0.123456, 1.0e-300, 123456.789});
+    std::ostringstream output;
+    doubles_object.write(output, format);
+    REQUIRE(output.str() == "{\"doubles\":[2.0,-0.1235,1e-300,1.235e+05]}");
+
+    // Parallel formatting of large arrays rounds in the same way
+    format.num_threads = 4;
+    std::ostringstream parallel_output;
+    test_object.write(parallel_output, format);
+    auto parsed = nlohmann::json::parse(parallel_output.str());
+    auto parsed_data =
+        parsed["nested object"][0]["data"].get<std::vector<double>>();
+    REQUIRE(parsed_data.size() == large_array.size());
+    for (unsigned int i = 0; i < large_array.size(); ++i) {
+      REQUIRE(parsed_data[i] ==
+              Approx(large_array[i]).epsilon(1.0e-3).margin(1.0e-12));
+    }
+    REQUIRE(parsed["integer"] == -17);
+    REQUIRE(parsed["unsigned"] == 4000000000u);
+  }
+
+  SECTION("Test streamed compact output matches JSON object output") {
+    utilities::JsonFormat format;
+    format.compact = true;
+    utilities::JsonObject all_events;
+    all_events.add_value("Events",
+                         std::vector<utilities::JsonObject>{test_object,
+                                                            nested_object});
+    all_events.write_to_file("./json_object_compact.json", format);
+
+    utilities::JsonEventWriter writer("./json_writer_compact.json", format);
+    writer.write_event(test_object);
+    writer.write_event(nested_object);
+    writer.close();
+    REQUIRE(file_contents("./json_writer_compact.json") ==
+            file_contents("./json_object_compact.json"));
+  }
 }
@@ -1,4 +1,5 @@
 #include <cmath>
+#include <cstdint>
 #include <catch2/catch.hpp>
 #include <Eigen/Dense>
 #include "configure.h"
@@ -128,7 +129,173 @@ TEST_CASE("Test generation of random numbers", "[RandomNumbers]") {
     cov(0, 0) = 0.0123;
 
     random_generator1->generate(random_numbers1, means, cov, 100);
-    random_generator2->generate(random_numbers2, means, cov, 100);    
+    random_generator2->generate(random_numbers2, means, cov, 100);
     REQUIRE(random_numbers1 == random_numbers2);
   }
+
+  SECTION("Check that changes to covariance are used after repeated draws",
+          "[RandomNumbers]") {
+    Eigen::VectorXd means = Eigen::VectorXd::Zero(2);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Identity(2, 2);
+
+    // Draws in one block and several blocks give the same numbers
+    int seed = 700;
+    auto random_generator1 =
+        Factory<numeric_utils::RandomGenerator, int>::instance()->create(
+            "MultivariateNormal", std::move(seed));
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> block_numbers;
+    random_generator1->generate(block_numbers, means, cov, 10);
+    random_generator->generate(random_numbers, means, cov, 1);
+
+    seed = 700;
+    auto random_generator2 =
+        Factory<numeric_utils::RandomGenerator, int>::instance()->create(
+            "MultivariateNormal", std::move(seed));
+    for (unsigned int i = 0; i < 10; ++i) {
+      random_generator2->generate(random_numbers, means, cov, 1);
+      REQUIRE(random_numbers.col(0) == block_numbers.col(i));
+    }
+
+    // Modify covariance in place so cached factorization is stale
+    cov(0, 0) = 16.0;
+    cov(1, 1) = 0.25;
+    random_generator->generate(random_numbers, means, cov, 100000);
+
+    Eigen::VectorXd variances =
+        random_numbers.array().square().rowwise().mean();
+    REQUIRE(variances(0) == Approx(16.0).epsilon(0.02));
+    REQUIRE(variances(1) == Approx(0.25).epsilon(0.02));
+  }
+}
+
+TEST_CASE("Test generation of random numbers using VSL streams",
+          "[RandomNumbers]") {
+  int seed = 100;
+  auto random_generator = Factory<numeric_utils::RandomGenerator, int>::instance()
+    ->create("MultivariateNormalVSL", std::move(seed));
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> random_numbers;
+
+  SECTION("Generate normally distributed random numbers for correlated random "
+          "variable") {
+    Eigen::VectorXd means(3);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(3, 3);
+    means << 64.0, 300.0, 60.0;
+
+    // Try bad COV matrix
+    // clang-format off
+    cov << 1.0, 1.0, 0.0, 
+           1.0, 1.0, 1.0,
+           0.0, 1.0, 1.0;    
+    // clang-format on
+
+    bool success = random_generator->generate(random_numbers, means, cov, 100);
+    REQUIRE(success == false);
+
+    // Try good COV matrix
+    // clang-format off   
+    cov << 504.0, 360.0, 180.0, 
+           360.0, 360.0, 0.0,
+           180.0, 0.0, 720.0;
+    // clang-format on
+    success = random_generator->generate(random_numbers, means, cov, 250000);
+    REQUIRE(success == true);
+    REQUIRE(random_numbers.rows() == 3);
+    REQUIRE(random_numbers.cols() == 250000);
+
+    Eigen::VectorXd averages = random_numbers.rowwise().mean();
+
+    REQUIRE(averages(0) == Approx(means(0)).epsilon(0.01));
+    REQUIRE(averages(1) == Approx(means(1)).epsilon(0.01));
+    REQUIRE(averages(2) == Approx(means(2)).epsilon(0.01));
+
+    // Compute covariance matrix from random values
+    Eigen::MatrixXd deviation_scores = random_numbers.colwise() - averages;
+    Eigen::MatrixXd calculated_cov =
+        (deviation_scores * deviation_scores.transpose()) / random_numbers.cols();
+
+    for (unsigned int i = 0; i < cov.rows(); ++i) {
+      for (unsigned int j = 0; j < cov.cols(); ++j) {
+        REQUIRE(calculated_cov(i, j) + 1000.0 ==
+                Approx(cov(i, j) + 1000.0).epsilon(0.01));
+      }
+    }
+  }
+
+  SECTION("Check that number generated using the same seed match") {
+    int seed = 500;
+    auto random_generator1 =
+        Factory<numeric_utils::RandomGenerator, int>::instance()->create(
+            "MultivariateNormalVSL", std::move(seed));
+    auto random_generator2 =
+        Factory<numeric_utils::RandomGenerator, int>::instance()->create(
+            "MultivariateNormalVSL", std::move(seed));
+    REQUIRE(random_generator1->name() == "NormalMultiVarVsl");
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> random_numbers1;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> random_numbers2;
+    Eigen::VectorXd means(1);
+    Eigen::MatrixXd cov(1,1);
+    means(0) = 1.789;
+    cov(0, 0) = 0.0123;
+
+    random_generator1->generate(random_numbers1, means, cov, 100);
+    random_generator2->generate(random_numbers2, means, cov, 100);
+    REQUIRE(random_numbers1 == random_numbers2);
+
+    // Generating in two blocks continues the same stream
+    random_generator1->generate(random_numbers1, means, cov, 50);
+    random_generator2->generate(random_numbers2, means, cov, 50);
+    REQUIRE(random_numbers1 == random_numbers2);
+  }
+}
+
+TEST_CASE("Test generation of random numbers using keyed random streams",
+          "[RandomNumbers]") {
+  config::initialize();
+  Eigen::VectorXd means(2);
+  Eigen::MatrixXd cov(2, 2);
+  means << 1.0, -2.0;
+  // clang-format off
+  cov << 4.0, 1.0,
+         1.0, 0.25;
+  // clang-format on
+
+  auto create = [](std::uint64_t seed) {
+    return Factory<numeric_utils::RandomGenerator, std::uint64_t>::instance()
+        ->create("MultivariateNormalStream", std::move(seed));
+  };
+
+  SECTION("Check moments of generated numbers") {
+    auto random_generator = create(100);
+    REQUIRE(random_generator->name() == "NormalMultiVarStream");
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> random_numbers;
+    REQUIRE(random_generator->generate(random_numbers, means, cov, 100000));
+
+    Eigen::VectorXd averages = random_numbers.rowwise().mean();
+    REQUIRE(averages(0) == Approx(means(0)).epsilon(0.02));
+    REQUIRE(averages(1) == Approx(means(1)).epsilon(0.02));
+    Eigen::MatrixXd deviation_scores = random_numbers.colwise() - averages;
+    Eigen::MatrixXd calculated_cov =
+        (deviation_scores * deviation_scores.transpose()) /
+        random_numbers.cols();
+    REQUIRE(calculated_cov(0, 0) == Approx(4.0).epsilon(0.02));
+    REQUIRE(calculated_cov(0, 1) == Approx(1.0).epsilon(0.05));
+  }
+
+  SECTION("Check blocks of cases match cases drawn one at a time") {
+    // Seeds differing in the upper 32 bits give different numbers
+    std::uint64_t seed = (std::uint64_t(7) << 32) | 100;
+    auto block_generator = create(seed);
+    auto single_generator = create(seed);
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> block, single;
+    block_generator->generate(block, means, cov, 5);
+    for (unsigned int i = 0; i < 5; ++i) {
+      single_generator->generate(single, means, cov, 1);
+      REQUIRE(single.col(0) == block.col(i));
+    }
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> other;
+    create(100)->generate(other, means, cov, 5);
+    REQUIRE(other != block);
+  }
 }
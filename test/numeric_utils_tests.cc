@@ -1,9 +1,18 @@
+#include <algorithm>
 #include <cmath>
+#include <complex>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 #include <catch2/catch.hpp>
 #include <Eigen/Dense>
+#include "baseline_correction.h"
+#include "convolver.h"
+#include "device_backend.h"
+#include "fft_plan.h"
 #include "numeric_utils.h"
+#include "parallel.h"
+#include "spatial_correlation.h"
 
 TEST_CASE("Test correlation to covariance functionality", "[Helpers]") {
   SECTION("Correlation is diagonal matrix with values of 1.0 along diagonal") {
@@ -72,6 +81,95 @@ TEST_CASE("Test one dimensional convolution", "[Helpers][Convolution]") {
   }  
 }
 
+TEST_CASE("Test reusable convolver", "[Helpers][Convolution]") {
+  std::vector<double> kernel(40);
+  for (unsigned int i = 0; i < kernel.size(); ++i) {
+    kernel[i] = std::exp(-0.1 * i) * std::cos(0.5 * i);
+  }
+  std::vector<double> input(300);
+  for (unsigned int i = 0; i < input.size(); ++i) {
+    input[i] = std::sin(0.05 * i) + 0.01 * i;
+  }
+
+  std::vector<double> expected;
+  numeric_utils::convolve_1d(kernel, input, expected);
+
+  SECTION("Direct and FFT modes match convolution") {
+    numeric_utils::Convolver direct(kernel,
+                                    numeric_utils::Convolver::Mode::Direct);
+    numeric_utils::Convolver fft(kernel, numeric_utils::Convolver::Mode::FFT);
+    REQUIRE(direct.mode(input.size()) ==
+            numeric_utils::Convolver::Mode::Direct);
+    REQUIRE(fft.mode(input.size()) == numeric_utils::Convolver::Mode::FFT);
+    REQUIRE(fft.fft_length(input.size()) == 512);
+
+    std::vector<double> direct_output, fft_output;
+    direct.convolve(input, direct_output);
+    // Repeated calls reuse kernel transform
+    fft.convolve(input, fft_output);
+    fft.convolve(input, fft_output);
+
+    REQUIRE(direct_output.size() == expected.size());
+    REQUIRE(fft_output.size() == expected.size());
+    for (unsigned int i = 0; i < expected.size(); ++i) {
+      REQUIRE(direct_output[i] + 10.0 ==
+              Approx(expected[i] + 10.0).epsilon(1.0e-12));
+      REQUIRE(fft_output[i] + 10.0 ==
+              Approx(expected[i] + 10.0).epsilon(1.0e-12));
+    }
+  }
+
+  SECTION("Automatic mode uses FFTs for long kernels") {
+    numeric_utils::Convolver short_kernel(std::vector<double>{1.0, -1.0});
+    REQUIRE(short_kernel.mode(10000) == numeric_utils::Convolver::Mode::Direct);
+
+    numeric_utils::Convolver long_kernel(std::vector<double>(2000, 1.0));
+    REQUIRE(long_kernel.mode(10000) == numeric_utils::Convolver::Mode::FFT);
+  }
+
+  SECTION("Batched convolution matches single record convolution") {
+    Eigen::MatrixXd inputs(input.size(), 3);
+    for (unsigned int i = 0; i < inputs.cols(); ++i) {
+      inputs.col(i) =
+          (i + 1.0) * Eigen::Map<Eigen::VectorXd>(input.data(), input.size());
+    }
+
+    for (auto mode : {numeric_utils::Convolver::Mode::Direct,
+                      numeric_utils::Convolver::Mode::FFT}) {
+      numeric_utils::Convolver convolver(kernel, mode);
+      Eigen::MatrixXd outputs;
+      convolver.convolve(inputs, outputs);
+      REQUIRE(outputs.rows() == expected.size());
+      REQUIRE(outputs.cols() == 3);
+      for (unsigned int i = 0; i < outputs.cols(); ++i) {
+        for (unsigned int j = 0; j < expected.size(); ++j) {
+          REQUIRE(outputs(j, i) + 10.0 ==
+                  Approx((i + 1.0) * expected[j] + 10.0).epsilon(1.0e-12));
+        }
+      }
+    }
+  }
+
+  SECTION("Smooth FFT lengths match convolution") {
+    numeric_utils::Convolver fft(kernel, numeric_utils::Convolver::Mode::FFT,
+                                 true);
+    REQUIRE(fft.fft_length(input.size()) == 360);
+
+    std::vector<double> fft_output;
+    fft.convolve(input, fft_output);
+    REQUIRE(fft_output.size() == expected.size());
+    for (unsigned int i = 0; i < expected.size(); ++i) {
+      REQUIRE(fft_output[i] + 10.0 ==
+              Approx(expected[i] + 10.0).epsilon(1.0e-12));
+    }
+  }
+
+  SECTION("Kernel must not be empty") {
+    REQUIRE_THROWS_AS(numeric_utils::Convolver(std::vector<double>()),
+                      std::runtime_error);
+  }
+}
+
 TEST_CASE("Test trapazoid rule", "[Helpers][Trapazoid]") {
 
   SECTION("STL vector with unit spacing") {
@@ -211,6 +309,258 @@ TEST_CASE("Test 1-D Fast Fourier Transform", "[Helpers][FFT]") {
   }
 }
 
+TEST_CASE("Test smooth FFT lengths", "[Helpers][FFT]") {
+  REQUIRE(numeric_utils::smooth_fft_length(1) == 1);
+  REQUIRE(numeric_utils::smooth_fft_length(7) == 8);
+  REQUIRE(numeric_utils::smooth_fft_length(11) == 12);
+  REQUIRE(numeric_utils::smooth_fft_length(97) == 100);
+  REQUIRE(numeric_utils::smooth_fft_length(1025) == 1080);
+  REQUIRE(numeric_utils::smooth_fft_length(4097) == 4320);
+  REQUIRE(numeric_utils::smooth_fft_length(4320) == 4320);
+}
+
+TEST_CASE("Test FFT plans", "[Helpers][FFT]") {
+  SECTION("Cached plans are shared for same length and domain") {
+    auto plan = numeric_utils::FFTPlan::cached(
+        8, numeric_utils::FFTPlan::Domain::Complex);
+    REQUIRE(plan->size() == 8);
+    REQUIRE(plan->domain() == numeric_utils::FFTPlan::Domain::Complex);
+    REQUIRE(numeric_utils::FFTPlan::cached(
+                8, numeric_utils::FFTPlan::Domain::Complex) == plan);
+    REQUIRE(numeric_utils::FFTPlan::cached(
+                8, numeric_utils::FFTPlan::Domain::Real) != plan);
+    REQUIRE(numeric_utils::FFTPlan::cached(
+                6, numeric_utils::FFTPlan::Domain::Complex) != plan);
+
+    // Recently used plans survive while many other lengths are cached
+    for (unsigned int i = 0; i < 80; ++i) {
+      numeric_utils::FFTPlan::cached(
+          16 + i, numeric_utils::FFTPlan::Domain::Complex);
+      REQUIRE(numeric_utils::FFTPlan::cached(
+                  8, numeric_utils::FFTPlan::Domain::Complex) == plan);
+    }
+  }
+
+  SECTION("Held plans invert forward transforms from several threads") {
+    unsigned int num_steps = 12;
+    numeric_utils::FFTPlan forward_plan(
+        num_steps, numeric_utils::FFTPlan::Domain::Complex);
+    numeric_utils::FFTPlan backward_plan(num_steps,
+                                         numeric_utils::FFTPlan::Domain::Real);
+
+    std::vector<std::vector<double>> outputs(8);
+    utilities::parallel_for(outputs.size(), 4, [&](unsigned int i) {
+      std::vector<std::complex<double>> input(num_steps), transform(num_steps);
+      for (unsigned int j = 0; j < num_steps; ++j) {
+        input[j] = std::sin(0.3 * (i + 1) * j);
+      }
+      forward_plan.forward(input.data(), transform.data());
+      outputs[i].resize(num_steps);
+      backward_plan.backward(transform.data(), outputs[i].data());
+    });
+
+    for (unsigned int i = 0; i < outputs.size(); ++i) {
+      for (unsigned int j = 0; j < num_steps; ++j) {
+        REQUIRE(outputs[i][j] + 10.0 ==
+                Approx(std::sin(0.3 * (i + 1) * j) + 10.0).epsilon(1.0e-12));
+      }
+    }
+  }
+
+  SECTION("Real transforms match complex transforms") {
+    for (unsigned int num_steps : {8u, 9u}) {
+      std::vector<double> input(num_steps);
+      for (unsigned int i = 0; i < num_steps; ++i) {
+        input[i] = std::cos(0.7 * i) + 0.1 * i;
+      }
+
+      std::vector<std::complex<double>> full_transform;
+      numeric_utils::fft(input, full_transform);
+      std::vector<std::complex<double>> half_transform(num_steps / 2 + 1);
+      REQUIRE(numeric_utils::real_fft(input.data(), num_steps,
+                                      half_transform.data()));
+      for (unsigned int i = 0; i < half_transform.size(); ++i) {
+        REQUIRE(std::abs(half_transform[i] - full_transform[i]) < 1.0e-12);
+      }
+
+      // In place transforms use buffer padded to hold complex output
+      std::vector<double> buffer(2 * (num_steps / 2 + 1), 0.0);
+      std::copy(input.begin(), input.end(), buffer.begin());
+      REQUIRE(numeric_utils::real_fft(buffer.data(), num_steps));
+      for (unsigned int i = 0; i < half_transform.size(); ++i) {
+        REQUIRE(std::abs(std::complex<double>(buffer[2 * i],
+                                              buffer[2 * i + 1]) -
+                         half_transform[i]) < 1.0e-12);
+      }
+
+      std::vector<double> output(num_steps);
+      REQUIRE(numeric_utils::inverse_real_fft(half_transform.data(),
+                                              num_steps, output.data()));
+      REQUIRE(numeric_utils::inverse_real_fft(buffer.data(), num_steps));
+      for (unsigned int i = 0; i < num_steps; ++i) {
+        REQUIRE(output[i] == Approx(input[i]).epsilon(1.0e-12));
+        REQUIRE(buffer[i] == Approx(input[i]).epsilon(1.0e-12));
+      }
+    }
+  }
+
+  SECTION("In place complex plans invert forward transforms") {
+    numeric_utils::FFTPlan plan(6, numeric_utils::FFTPlan::Domain::Complex,
+                                numeric_utils::FFTPlan::Placement::InPlace);
+    REQUIRE(plan.placement() == numeric_utils::FFTPlan::Placement::InPlace);
+    std::vector<std::complex<double>> data = {{1.0, 0.5},  {2.0, -1.0},
+                                              {0.0, 0.0},  {-3.0, 2.0},
+                                              {1.5, 1.0},  {0.0, -2.0}};
+    auto original = data;
+    plan.forward(data.data());
+    plan.backward(data.data());
+    for (unsigned int i = 0; i < data.size(); ++i) {
+      REQUIRE(std::abs(data[i] - original[i]) < 1.0e-12);
+    }
+
+    // Out of place transforms are not available from in place plans
+    std::vector<std::complex<double>> output(6);
+    REQUIRE_THROWS_AS(plan.forward(data.data(), output.data()),
+                      std::runtime_error);
+  }
+
+  SECTION("Batched transforms match single transforms") {
+    unsigned int num_steps = 10, num_records = 4;
+    Eigen::MatrixXd records(num_steps, num_records);
+    for (unsigned int i = 0; i < num_records; ++i) {
+      for (unsigned int j = 0; j < num_steps; ++j) {
+        records(j, i) = std::sin(0.4 * (i + 1) * j) + 0.05 * j;
+      }
+    }
+
+    Eigen::MatrixXcd transforms;
+    REQUIRE(numeric_utils::real_fft(records, transforms));
+    REQUIRE(transforms.rows() == num_steps / 2 + 1);
+    REQUIRE(transforms.cols() == num_records);
+
+    Eigen::MatrixXd inverses;
+    REQUIRE(numeric_utils::inverse_real_fft(transforms, num_steps, inverses));
+    REQUIRE(inverses.rows() == num_steps);
+
+    std::vector<std::complex<double>> transform(num_steps / 2 + 1);
+    for (unsigned int i = 0; i < num_records; ++i) {
+      numeric_utils::real_fft(records.col(i).data(), num_steps,
+                              transform.data());
+      for (unsigned int j = 0; j < transform.size(); ++j) {
+        REQUIRE(std::abs(transforms(j, i) - transform[j]) < 1.0e-12);
+      }
+      for (unsigned int j = 0; j < num_steps; ++j) {
+        REQUIRE(inverses(j, i) + 10.0 ==
+                Approx(records(j, i) + 10.0).epsilon(1.0e-12));
+      }
+    }
+
+    // Complex records strided within larger buffer
+    std::vector<std::complex<double>> input(3 * 8), output(3 * 6);
+    for (unsigned int i = 0; i < input.size(); ++i) {
+      input[i] = std::complex<double>(std::cos(0.3 * i), 0.1 * i);
+    }
+    numeric_utils::BatchFFTPlan strided_plan(
+        6, 3, numeric_utils::FFTPlan::Domain::Complex,
+        numeric_utils::BatchFFTPlan::Direction::Forward, 8, 6);
+    REQUIRE(strided_plan.num_transforms() == 3);
+    strided_plan.compute(input.data(), output.data());
+
+    numeric_utils::FFTPlan single_plan(
+        6, numeric_utils::FFTPlan::Domain::Complex);
+    std::vector<std::complex<double>> single_output(6);
+    for (unsigned int i = 0; i < 3; ++i) {
+      single_plan.forward(&input[8 * i], single_output.data());
+      for (unsigned int j = 0; j < 6; ++j) {
+        REQUIRE(std::abs(output[6 * i + j] - single_output[j]) < 1.0e-12);
+      }
+    }
+
+    // Direction of real batches must match transform
+    REQUIRE_THROWS_AS(
+        numeric_utils::BatchFFTPlan::cached(
+            num_steps, num_records, numeric_utils::FFTPlan::Domain::Real,
+            numeric_utils::BatchFFTPlan::Direction::Backward)
+            ->compute(records.data(), transforms.data()),
+        std::runtime_error);
+
+    // Single precision batches match double precision to float accuracy
+    Eigen::MatrixXf single_records = records.cast<float>();
+    Eigen::MatrixXcf single_transforms;
+    REQUIRE(numeric_utils::real_fft(single_records, single_transforms));
+    REQUIRE(single_transforms.rows() == num_steps / 2 + 1);
+    Eigen::MatrixXf single_inverses;
+    REQUIRE(numeric_utils::inverse_real_fft(single_transforms, num_steps,
+                                            single_inverses));
+    double scale = transforms.cwiseAbs().maxCoeff();
+    REQUIRE((single_transforms.cast<std::complex<double>>() - transforms)
+                .cwiseAbs()
+                .maxCoeff() < 1.0e-5 * scale);
+    REQUIRE((single_inverses.cast<double>() - records).cwiseAbs().maxCoeff() <
+            1.0e-5 * records.cwiseAbs().maxCoeff());
+
+    // Precision of plan must match records
+    auto float_plan = numeric_utils::BatchFFTPlan::cached(
+        num_steps, num_records, numeric_utils::FFTPlan::Domain::Real,
+        numeric_utils::BatchFFTPlan::Direction::Forward,
+        numeric_utils::BatchFFTPlan::Precision::Single);
+    REQUIRE(float_plan->precision() ==
+            numeric_utils::BatchFFTPlan::Precision::Single);
+    REQUIRE_THROWS_AS(
+        numeric_utils::BatchFFTPlan::cached(
+            num_steps, num_records, numeric_utils::FFTPlan::Domain::Real,
+            numeric_utils::BatchFFTPlan::Direction::Forward)
+            ->compute(single_records.data(), single_transforms.data()),
+        std::runtime_error);
+  }
+
+  SECTION("Plans check length and domain") {
+    REQUIRE_THROWS_AS(
+        numeric_utils::FFTPlan(0, numeric_utils::FFTPlan::Domain::Real),
+        std::runtime_error);
+
+    numeric_utils::FFTPlan real_plan(4, numeric_utils::FFTPlan::Domain::Real);
+    std::vector<std::complex<double>> values(4);
+    REQUIRE_THROWS_AS(real_plan.forward(values.data(), values.data()),
+                      std::runtime_error);
+  }
+}
+
+TEST_CASE("Test GPU backend for batched FFTs", "[Helpers][FFT]") {
+  // Batch is large enough to be planned on the GPU when one is available,
+  // otherwise both transforms run on the host
+  unsigned int num_steps = 1000, num_records = 80;
+  Eigen::MatrixXd records(num_steps, num_records);
+  for (unsigned int i = 0; i < num_records; ++i) {
+    for (unsigned int j = 0; j < num_steps; ++j) {
+      records(j, i) = std::cos(0.01 * (i + 1) * j) + 0.001 * j;
+    }
+  }
+
+  // GPU kernels are opt-in
+  REQUIRE(!numeric_utils::device::enabled());
+  numeric_utils::device::set_enabled(true);
+  REQUIRE(numeric_utils::device::enabled() ==
+          numeric_utils::device::available());
+  Eigen::MatrixXcd device_transforms, host_transforms;
+  Eigen::MatrixXd device_inverses, host_inverses;
+  REQUIRE(numeric_utils::real_fft(records, device_transforms));
+  REQUIRE(numeric_utils::inverse_real_fft(device_transforms, num_steps,
+                                          device_inverses));
+
+  numeric_utils::device::set_enabled(false);
+  REQUIRE(!numeric_utils::device::enabled());
+  REQUIRE(numeric_utils::real_fft(records, host_transforms));
+  REQUIRE(numeric_utils::inverse_real_fft(host_transforms, num_steps,
+                                          host_inverses));
+
+  double scale = host_transforms.cwiseAbs().maxCoeff();
+  REQUIRE((device_transforms - host_transforms).cwiseAbs().maxCoeff() <
+          1.0e-12 * scale);
+  REQUIRE((device_inverses - host_inverses).cwiseAbs().maxCoeff() < 1.0e-12);
+  REQUIRE((host_inverses - records).cwiseAbs().maxCoeff() < 1.0e-12);
+}
+
 TEST_CASE("Test polynomial curve fitting, derivatives, and evaluation",
           "[Helpers][Polynomial]") {
   SECTION("Fit polynomial with non-zero intercept--should be degree 0") {
@@ -311,3 +661,150 @@ TEST_CASE("Test polynomial curve fitting, derivatives, and evaluation",
     REQUIRE(evaluations[3] == Approx(170.0).epsilon(0.01));
   }    
 }
+
+TEST_CASE("Test baseline correction", "[Helpers]") {
+  unsigned int num_steps = 800;
+  double time_step = 0.005, gfactor = 981.0;
+  unsigned int degree = 5;
+  Eigen::MatrixXd accels = Eigen::MatrixXd::Random(num_steps, 3);
+
+  // Reference correction fitting polynomial to each displacement directly
+  Eigen::MatrixXd expected = accels;
+  Eigen::VectorXd times(num_steps);
+  for (unsigned int i = 0; i < num_steps; ++i) {
+    times(i) = i * time_step;
+  }
+  for (unsigned int j = 0; j < accels.cols(); ++j) {
+    Eigen::VectorXd displacement(num_steps);
+    double velocity = 0.0, disp = 0.0;
+    for (unsigned int i = 0; i < num_steps; ++i) {
+      velocity += accels(i, j) * gfactor * time_step;
+      disp += velocity * time_step;
+      displacement(i) = disp;
+    }
+    auto displacement_poly =
+        numeric_utils::polyfit_intercept(times, displacement, 0.0, degree);
+    auto accel_poly = numeric_utils::polynomial_derivative(
+        numeric_utils::polynomial_derivative(displacement_poly));
+    expected.col(j) -=
+        numeric_utils::evaluate_polynomial(accel_poly, times) / gfactor;
+  }
+
+  SECTION("Batched and single record corrections match polynomial fit") {
+    numeric_utils::BaselineCorrection correction(num_steps, time_step, degree);
+    Eigen::MatrixXd corrected = accels;
+    correction.correct(corrected, gfactor);
+    REQUIRE((corrected - expected).cwiseAbs().maxCoeff() < 1.0e-8);
+
+    std::vector<double> record(accels.col(1).data(),
+                               accels.col(1).data() + num_steps);
+    correction.correct(record, gfactor);
+    for (unsigned int i = 0; i < num_steps; ++i) {
+      REQUIRE(record[i] == Approx(corrected(i, 1)).margin(1.0e-12));
+    }
+
+    std::vector<double> short_record(10);
+    REQUIRE_THROWS_AS(correction.correct(short_record, gfactor),
+                      std::runtime_error);
+  }
+
+  SECTION("Cached corrections are shared for same dimensions") {
+    auto correction_1 =
+        numeric_utils::BaselineCorrection::cached(num_steps, time_step, degree);
+    auto correction_2 =
+        numeric_utils::BaselineCorrection::cached(num_steps, time_step, degree);
+    auto correction_3 = numeric_utils::BaselineCorrection::cached(
+        num_steps + 1, time_step, degree);
+    REQUIRE(correction_1 == correction_2);
+    REQUIRE(correction_1 != correction_3);
+    REQUIRE(correction_3->num_steps() == num_steps + 1);
+
+    // Recently used lengths survive while many other lengths are cached
+    for (unsigned int i = 2; i < 40; ++i) {
+      numeric_utils::BaselineCorrection::cached(num_steps + i, time_step,
+                                                degree);
+      REQUIRE(numeric_utils::BaselineCorrection::cached(
+                  num_steps, time_step, degree) == correction_1);
+    }
+    REQUIRE_THROWS_AS(
+        numeric_utils::BaselineCorrection(num_steps, time_step, 1),
+        std::runtime_error);
+  }
+}
+
+TEST_CASE("Test tapered spatial correlation", "[Helpers][Spatial]") {
+  // Grid of 10 x 10 sites spaced 3 km apart
+  std::vector<double> x_coordinates, y_coordinates;
+  for (unsigned int i = 0; i < 10; ++i) {
+    for (unsigned int j = 0; j < 10; ++j) {
+      x_coordinates.push_back(3.0 * j);
+      y_coordinates.push_back(3.0 * i);
+    }
+  }
+  numeric_utils::SpatialCorrelation correlation(x_coordinates, y_coordinates,
+                                                5.0, 8.0);
+  REQUIRE(correlation.num_sites() == 100);
+
+  SECTION("Correlation decays with distance and vanishes beyond taper") {
+    REQUIRE(correlation.correlation(0, 0) == Approx(1.0));
+    REQUIRE(correlation.correlation(0, 1) == correlation.correlation(1, 0));
+    REQUIRE(correlation.correlation(0, 1) > correlation.correlation(0, 2));
+    REQUIRE(correlation.correlation(0, 2) > 0.0);
+    REQUIRE(correlation.correlation(0, 3) == 0.0);
+    REQUIRE(correlation.correlation(0, 99) == 0.0);
+
+    // Factor stays sparse compared to the dense lower triangle
+    REQUIRE(correlation.num_nonzeros() < 100 * 101 / 4);
+  }
+
+  SECTION("Site weights reproduce correlation") {
+    std::vector<std::vector<double>> dense_weights(
+        100, std::vector<double>(100, 0.0));
+    std::vector<std::size_t> rows;
+    std::vector<double> weights;
+    for (std::size_t i = 0; i < 100; ++i) {
+      correlation.site_weights(i, rows, weights);
+      REQUIRE(rows.size() == weights.size());
+      for (std::size_t k = 0; k < rows.size(); ++k) {
+        dense_weights[i][rows[k]] = weights[k];
+      }
+    }
+
+    for (std::size_t i = 0; i < 100; ++i) {
+      for (std::size_t j = 0; j < 100; ++j) {
+        double product = 0.0;
+        for (std::size_t k = 0; k < 100; ++k) {
+          product += dense_weights[i][k] * dense_weights[j][k];
+        }
+        REQUIRE(product ==
+                Approx(correlation.correlation(i, j)).margin(1.0e-10));
+      }
+    }
+
+    Eigen::MatrixXd white_noise = Eigen::MatrixXd::Random(100, 3);
+    Eigen::MatrixXd correlated = correlation.correlate(white_noise);
+    for (std::size_t i = 0; i < 100; ++i) {
+      for (unsigned int m = 0; m < 3; ++m) {
+        double expected = 0.0;
+        for (std::size_t k = 0; k < 100; ++k) {
+          expected += dense_weights[i][k] * white_noise(k, m);
+        }
+        REQUIRE(correlated(i, m) == Approx(expected).margin(1.0e-12));
+      }
+    }
+    REQUIRE_THROWS_AS(correlation.correlate(Eigen::MatrixXd::Zero(99, 3)),
+                      std::runtime_error);
+  }
+
+  SECTION("Invalid sites and lengths throw exceptions") {
+    REQUIRE_THROWS_AS(
+        numeric_utils::SpatialCorrelation({0.0, 0.0}, {1.0, 1.0}, 5.0, 8.0),
+        std::runtime_error);
+    REQUIRE_THROWS_AS(
+        numeric_utils::SpatialCorrelation({0.0, 1.0}, {1.0}, 5.0, 8.0),
+        std::runtime_error);
+    REQUIRE_THROWS_AS(
+        numeric_utils::SpatialCorrelation({0.0, 1.0}, {1.0, 1.0}, 0.0, 8.0),
+        std::runtime_error);
+  }
+}
@@ -1,9 +1,12 @@
 #include <cmath>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 #include <catch2/catch.hpp>
 #include <Eigen/Dense>
+#include "multi_start_nelder_mead.h"
 #include "nelder_mead.h"
 
 TEST_CASE("Test Nelder-Mead Optimization", "[Helpers][Optimization]") {
@@ -49,4 +52,52 @@ TEST_CASE("Test Nelder-Mead Optimization", "[Helpers][Optimization]") {
     REQUIRE(calced_min_location[0] == Approx(1.0).epsilon(0.01));
     REQUIRE(calced_min_location[1] == Approx(1.0).epsilon(0.01));
   }
+
+  SECTION("Test multi-start minimization") {
+    std::function<double(const std::vector<double>&)> himmelblau =
+        [](const std::vector<double>& points) -> double {
+      return std::pow(points[0] * points[0] + points[1] - 11.0, 2) +
+             std::pow(points[0] + points[1] * points[1] - 7.0, 2);
+    };
+
+    // Starting points in different basins of attraction
+    std::vector<std::vector<double>> initial_points = {
+        {2.0, 2.0}, {-2.0, 2.0}, {-2.0, -2.0}, {2.0, -2.0}};
+    std::vector<std::vector<double>> deltas(initial_points.size(),
+                                            std::vector<double>(2, 0.1));
+
+    optimization::MultiStartNelderMead serial_optimizer(1e-10);
+    optimization::MultiStartNelderMead parallel_optimizer(1e-10, 4);
+    auto serial_locations =
+        serial_optimizer.minimize(initial_points, deltas, himmelblau);
+    auto parallel_locations =
+        parallel_optimizer.minimize(initial_points, deltas, himmelblau);
+
+    REQUIRE(serial_locations.size() == 4);
+    REQUIRE(serial_locations == parallel_locations);
+    REQUIRE(serial_optimizer.get_minima() == parallel_optimizer.get_minima());
+
+    // Each start matches an independent minimization from that start
+    for (unsigned int i = 0; i < initial_points.size(); ++i) {
+      optimization::NelderMead optimizer(1e-10);
+      auto location =
+          optimizer.minimize(initial_points[i], deltas[i], himmelblau);
+      REQUIRE(location == serial_locations[i]);
+      REQUIRE(optimizer.get_minimum() == serial_optimizer.get_minima()[i]);
+      REQUIRE(serial_optimizer.get_minima()[i] < 1.0e-6);
+    }
+
+    // Starts after convergence are skipped when stopping early
+    optimization::MultiStartNelderMead early_optimizer(1e-6, 1, true);
+    auto early_locations =
+        early_optimizer.minimize(initial_points, deltas, himmelblau);
+    REQUIRE(early_optimizer.get_best_index() == 0);
+    REQUIRE(early_optimizer.get_minima()[0] < 1.0e-6);
+    REQUIRE(early_optimizer.get_minima()[1] ==
+            std::numeric_limits<double>::infinity());
+    REQUIRE(early_locations[1] == initial_points[1]);
+
+    REQUIRE_THROWS_AS(serial_optimizer.minimize({}, {}, himmelblau),
+                      std::runtime_error);
+  }
 }
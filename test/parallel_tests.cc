@@ -0,0 +1,186 @@
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "parallel.h"
+#include "profiler.h"
+#include "scratch_arena.h"
+
+TEST_CASE("Test parallel execution of tasks", "[Helpers][Parallel]") {
+
+  SECTION("Test number of threads to use") {
+    REQUIRE(utilities::thread_count(1) == 1);
+    REQUIRE(utilities::thread_count(3) == 3);
+    REQUIRE(utilities::thread_count(0) >= 1);
+  }
+
+  SECTION("Test serial execution runs tasks in order") {
+    std::vector<unsigned int> order;
+    utilities::parallel_for(10, 1, [&order](unsigned int i) {
+      order.push_back(i);
+    });
+
+    REQUIRE(order.size() == 10);
+    for (unsigned int i = 0; i < order.size(); ++i) {
+      REQUIRE(order[i] == i);
+    }
+  }
+
+  SECTION("Test parallel execution runs each task once") {
+    std::vector<unsigned int> counts(1000, 0);
+    std::atomic<unsigned int> total(0);
+    utilities::parallel_for(1000, 4, [&](unsigned int i) {
+      counts[i] += 1;
+      total += i;
+    });
+
+    REQUIRE(total == 999 * 1000 / 2);
+    for (auto count : counts) {
+      REQUIRE(count == 1);
+    }
+
+    // No tasks should not call function
+    bool called = false;
+    utilities::parallel_for(0, 4, [&called](unsigned int i) { called = true; });
+    REQUIRE(!called);
+  }
+
+  SECTION("Test exceptions are rethrown on calling thread") {
+    auto failing_task = [](unsigned int i) {
+      if (i == 37) {
+        throw std::runtime_error("Task failed");
+      }
+    };
+
+    REQUIRE_THROWS_AS(utilities::parallel_for(100, 1, failing_task),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(utilities::parallel_for(100, 4, failing_task),
+                      std::runtime_error);
+  }
+}
+
+TEST_CASE("Test scratch arena", "[Helpers][Parallel]") {
+
+  SECTION("Test allocations are aligned and released by scopes") {
+    utilities::ScratchArena arena(1024);
+    double* first = nullptr;
+    {
+      utilities::ScratchArena::Scope scope(arena);
+      first = arena.allocate<double>(3);
+      double* second = arena.allocate<double>(5);
+      REQUIRE(reinterpret_cast<std::uintptr_t>(first) % 64 == 0);
+      REQUIRE(reinterpret_cast<std::uintptr_t>(second) % 64 == 0);
+      REQUIRE(second >= first + 3);
+
+      {
+        utilities::ScratchArena::Scope inner_scope(arena);
+        auto matrix = arena.matrix(4, 4);
+        matrix.setIdentity();
+        REQUIRE(matrix.trace() == Approx(4.0));
+      }
+      // Inner scope releases only its own allocations
+      REQUIRE(arena.allocate<double>(1) > second);
+    }
+    REQUIRE(arena.allocate<double>(3) == first);
+  }
+
+  SECTION("Test blocks are merged when arena is reset") {
+    utilities::ScratchArena arena(1024);
+    arena.allocate<double>(100);
+    arena.allocate<double>(200);
+    arena.allocate<double>(1000);
+    REQUIRE(arena.num_blocks() > 1);
+    std::size_t capacity = arena.capacity();
+
+    arena.reset();
+    REQUIRE(arena.num_blocks() == 1);
+    REQUIRE(arena.capacity() == capacity);
+
+    // Same allocations now fit in single block
+    arena.allocate<double>(100);
+    arena.allocate<double>(200);
+    arena.allocate<double>(1000);
+    REQUIRE(arena.num_blocks() == 1);
+  }
+
+  SECTION("Test each thread has its own arena") {
+    std::vector<utilities::ScratchArena*> arenas(8, nullptr);
+    std::vector<double> sums(8, 0.0);
+    utilities::parallel_for(8, 4, [&](unsigned int i) {
+      arenas[i] = &utilities::ScratchArena::local();
+      utilities::ScratchArena::Scope scope(*arenas[i]);
+      auto values = arenas[i]->vector(1000);
+      values.setConstant(i);
+      sums[i] = values.sum();
+    });
+    for (unsigned int i = 0; i < arenas.size(); ++i) {
+      REQUIRE(arenas[i] != nullptr);
+      REQUIRE(sums[i] == Approx(1000.0 * i));
+    }
+    REQUIRE(&utilities::ScratchArena::local() ==
+            &utilities::ScratchArena::local());
+  }
+}
+
+TEST_CASE("Test profiling of stages and counters", "[Helpers][Parallel]") {
+
+  SECTION("Test stages and counters are accumulated") {
+    utilities::Profile profile;
+    profile.add_time("synthesis", 0.5);
+    profile.add_time("synthesis", 0.25);
+    profile.add_count("fftTransforms", 3);
+    profile.add_count("fftTransforms", 4);
+
+    auto json = profile.json().get_library_json();
+    REQUIRE(json["stages"]["synthesis"]["seconds"] == Approx(0.75));
+    REQUIRE(json["stages"]["synthesis"]["calls"] == 2);
+    REQUIRE(json["counters"]["fftTransforms"] == 7);
+
+    profile.reset();
+    json = profile.json().get_library_json();
+    REQUIRE(json["stages"].empty());
+    REQUIRE(json["counters"].empty());
+  }
+
+  SECTION("Test timers and counts record into active profile") {
+    utilities::Profile profile;
+    REQUIRE(utilities::Profile::active() == nullptr);
+    {
+      utilities::ScopedProfile scoped_profile(&profile);
+      REQUIRE(utilities::Profile::active() == &profile);
+      utilities::StageTimer timer("stage");
+      utilities::Profile::count("events", 2);
+    }
+    REQUIRE(utilities::Profile::active() == nullptr);
+
+    // Nothing is recorded without an active profile
+    {
+      utilities::StageTimer timer("stage");
+      utilities::Profile::count("events", 2);
+    }
+
+    auto json = profile.json().get_library_json();
+    REQUIRE(json["stages"]["stage"]["calls"] == 1);
+    REQUIRE(json["stages"]["stage"]["seconds"] >= 0.0);
+    REQUIRE(json["counters"]["events"] == 2);
+  }
+
+  SECTION("Test workers of parallel tasks record into calling profile") {
+    utilities::Profile profile;
+    {
+      SMELT_PROFILE_ACTIVATE(profile);
+      utilities::parallel_for(100, 4, [](unsigned int i) {
+        SMELT_PROFILE_COUNT("tasks", 1);
+      });
+    }
+
+    auto json = profile.json().get_library_json();
+    if (utilities::profiling_enabled()) {
+      REQUIRE(json["counters"]["tasks"] == 100);
+    } else {
+      REQUIRE(json["counters"].empty());
+    }
+    REQUIRE(utilities::Profile::active() == nullptr);
+  }
+}
@@ -0,0 +1,94 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "random_stream.h"
+
+TEST_CASE("Test counter-based random streams", "[Helpers][Random]") {
+
+  SECTION("Test Philox4x32-10 against known answers") {
+    auto result = numeric_utils::RandomStream::philox({{0, 0, 0, 0}}, {{0, 0}});
+    REQUIRE(result[0] == 0x6627e8d5);
+    REQUIRE(result[1] == 0xe169c58d);
+    REQUIRE(result[2] == 0xbc57ac4c);
+    REQUIRE(result[3] == 0x9b00dbd8);
+
+    result = numeric_utils::RandomStream::philox(
+        {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+        {{0xa4093822, 0x299f31d0}});
+    REQUIRE(result[0] == 0xd16cfe09);
+    REQUIRE(result[1] == 0x94fdcceb);
+    REQUIRE(result[2] == 0x5001e420);
+    REQUIRE(result[3] == 0x24126ea1);
+  }
+
+  SECTION("Test streams are reproducible and independent of order") {
+    numeric_utils::RandomStream stream_a(100, 2, 3, 1);
+    std::vector<double> values_a(50);
+    for (auto& value : values_a) {
+      value = stream_a.normal();
+    }
+
+    // Drawing from other streams first has no effect
+    numeric_utils::RandomStream other(100, 2, 4, 1);
+    other.uniform();
+    numeric_utils::RandomStream stream_b(100, 2, 3, 1);
+    for (auto value : values_a) {
+      REQUIRE(stream_b.normal() == value);
+    }
+
+    // Different keys give different streams
+    numeric_utils::RandomStream seed_stream(101, 2, 3, 1),
+        spectrum_stream(100, 3, 3, 1), sim_stream(100, 2, 4, 1),
+        component_stream(100, 2, 3, 0), stream_c(100, 2, 3, 1);
+    auto value = stream_c();
+    REQUIRE(seed_stream() != value);
+    REQUIRE(spectrum_stream() != value);
+    REQUIRE(sim_stream() != value);
+    REQUIRE(component_stream() != value);
+  }
+
+  SECTION("Test skipping ahead in stream") {
+    for (unsigned long long skip : {0ULL, 1ULL, 3ULL, 4ULL, 5ULL, 37ULL}) {
+      numeric_utils::RandomStream stream(7, 0, 0), skipped(7, 0, 0);
+      stream();
+      skipped();
+      for (unsigned long long i = 0; i < skip; ++i) {
+        stream();
+      }
+      skipped.discard(skip);
+      REQUIRE(stream() == skipped());
+      REQUIRE(stream() == skipped());
+    }
+  }
+
+  SECTION("Test uniform and normal statistics") {
+    numeric_utils::RandomStream stream(12345, 0, 0);
+    unsigned int num_samples = 100000;
+    double uniform_sum = 0.0, normal_sum = 0.0, normal_sq_sum = 0.0;
+    for (unsigned int i = 0; i < num_samples; ++i) {
+      double uniform = stream.uniform();
+      REQUIRE(uniform > 0.0);
+      REQUIRE(uniform < 1.0);
+      uniform_sum += uniform;
+
+      double normal = stream.normal();
+      normal_sum += normal;
+      normal_sq_sum += normal * normal;
+    }
+
+    REQUIRE(uniform_sum / num_samples == Approx(0.5).epsilon(0.01));
+    REQUIRE(normal_sum / num_samples + 1.0 == Approx(1.0).epsilon(0.01));
+    REQUIRE(normal_sq_sum / num_samples == Approx(1.0).epsilon(0.02));
+  }
+
+  SECTION("Test stream seeds") {
+    REQUIRE(numeric_utils::stream_seed(10) == 10);
+    auto seed_1 =
+        numeric_utils::stream_seed(std::numeric_limits<int>::infinity());
+    auto seed_2 =
+        numeric_utils::stream_seed(std::numeric_limits<int>::infinity());
+    REQUIRE(seed_1 != seed_2);
+    REQUIRE(seed_1 > std::numeric_limits<unsigned int>::max());
+  }
+}
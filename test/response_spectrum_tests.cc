@@ -0,0 +1,83 @@
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <Eigen/Dense>
+#include "response_spectrum.h"
+
+TEST_CASE("Test response spectrum calculation", "[Helpers][Seismic]") {
+  double time_step = 0.01;
+  std::vector<double> periods = {0.05, 0.2, 1.0, 3.0};
+  std::vector<double> damping_ratios = {0.0, 0.05, 0.2};
+  numeric_utils::ResponseSpectrum response_spectrum(periods, damping_ratios,
+                                                    time_step);
+
+  SECTION("Test response to constant acceleration against exact solution") {
+    unsigned int num_steps = 1000;
+    double accel = 1.5;
+    std::vector<double> record(num_steps, accel);
+
+    auto spectrum = response_spectrum.compute(record);
+    REQUIRE(spectrum.rows() == damping_ratios.size());
+    REQUIRE(spectrum.cols() == periods.size());
+
+    for (unsigned int i = 0; i < damping_ratios.size(); ++i) {
+      double zeta = damping_ratios[i];
+      for (unsigned int j = 0; j < periods.size(); ++j) {
+        double omega = 2.0 * M_PI / periods[j];
+        double omega_damped = omega * std::sqrt(1.0 - zeta * zeta);
+
+        // Maximum of exact displacement at time steps
+        double max_displacement = 0.0;
+        for (unsigned int k = 0; k < num_steps; ++k) {
+          double time = k * time_step;
+          double displacement =
+              -accel / (omega * omega) *
+              (1.0 - std::exp(-zeta * omega * time) *
+                         (std::cos(omega_damped * time) +
+                          zeta / std::sqrt(1.0 - zeta * zeta) *
+                              std::sin(omega_damped * time)));
+          max_displacement = std::max(max_displacement, std::abs(displacement));
+        }
+
+        REQUIRE(spectrum(i, j) ==
+                Approx(omega * omega * max_displacement).epsilon(1.0e-8));
+      }
+    }
+  }
+
+  SECTION("Test batch calculation matches single record calculation") {
+    std::vector<std::vector<double>> records(5, std::vector<double>(500));
+    for (unsigned int i = 0; i < records.size(); ++i) {
+      for (unsigned int j = 0; j < records[i].size(); ++j) {
+        records[i][j] = std::sin(0.05 * (i + 1) * j) * std::exp(-0.004 * j);
+      }
+    }
+
+    auto serial_spectra = response_spectrum.compute(records);
+    auto parallel_spectra = response_spectrum.compute(records, 3);
+    REQUIRE(serial_spectra.size() == records.size());
+    for (unsigned int i = 0; i < records.size(); ++i) {
+      auto spectrum = response_spectrum.compute(records[i]);
+      REQUIRE(serial_spectra[i] == spectrum);
+      REQUIRE(parallel_spectra[i] == spectrum);
+    }
+  }
+
+  SECTION("Test invalid inputs") {
+    REQUIRE_THROWS_AS(numeric_utils::ResponseSpectrum(std::vector<double>(),
+                                                      damping_ratios, 0.01),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(
+        numeric_utils::ResponseSpectrum(periods, damping_ratios, 0.0),
+        std::runtime_error);
+    REQUIRE_THROWS_AS(numeric_utils::ResponseSpectrum(
+                          std::vector<double>{0.0, 1.0}, damping_ratios, 0.01),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(numeric_utils::ResponseSpectrum(
+                          periods, std::vector<double>{0.05, 1.0}, 0.01),
+                      std::runtime_error);
+  }
+}
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <Eigen/Dense>
+#include <nlohmann/json.hpp>
+#include "configure.h"
+#include "dabaghi_der_kiureghian.h"
+#include "record_iterator.h"
+#include "scenario_batch.h"
+#include "spatial_correlation.h"
+#include "stochastic_model.h"
+#include "time_history_block.h"
+#include "vlachos_et_al.h"
+#include "vlachos_multi_site.h"
+
+namespace {
+// Models of scenarios with fixed seeds, so separate instances generate the
+// same records
+std::vector<std::shared_ptr<stochastic::StochasticModel>> scenario_models() {
+  return {std::make_shared<stochastic::VlachosEtAl>(6.5, 30.0, 500.0, 30.0, 1,
+                                                    2, 100),
+          std::make_shared<stochastic::VlachosEtAl>(7.0, 20.0, 300.0, 0.0, 2,
+                                                    1, 200),
+          std::make_shared<stochastic::DabaghiDerKiureghian>(
+              stochastic::FaultType::StrikeSlip,
+              stochastic::SimulationType::NoPulse, 6.5, 0.0, 10.0, 760.0, 26.0,
+              0.0, 1, 1, true, 100)};
+}
+
+// Correlation coefficient of two records over their common length
+double record_correlation(const std::vector<double>& first,
+                          const std::vector<double>& second) {
+  std::size_t length = std::min(first.size(), second.size());
+  double product = 0.0, first_energy = 0.0, second_energy = 0.0;
+  for (std::size_t i = 0; i < length; ++i) {
+    product += first[i] * second[i];
+    first_energy += first[i] * first[i];
+    second_energy += second[i] * second[i];
+  }
+  return product / std::sqrt(first_energy * second_energy);
+}
+}  // namespace
+
+TEST_CASE("Test generation of multiple scenarios", "[Stochastic][Batch]") {
+  // Initialize the factories
+  config::initialize();
+  std::vector<std::string> names = {"SiteA", "SiteB", "SiteC"};
+
+  SECTION("Test records match records of each scenario generated alone") {
+    auto batch_models = scenario_models();
+    auto reference_models = scenario_models();
+
+    stochastic::ScenarioBatch batch(2);
+    for (std::size_t i = 0; i < batch_models.size(); ++i) {
+      batch.add_scenario(names[i], batch_models[i]);
+    }
+    batch_models[0]->set_num_threads(3);
+    REQUIRE(batch.num_scenarios() == 3);
+
+    std::vector<std::vector<stochastic::RecordMetadata>> reference_metadata(3);
+    std::vector<utilities::TimeHistoryBlock> reference_records(3);
+    for (std::size_t i = 0; i < reference_models.size(); ++i) {
+      reference_records[i] =
+          reference_models[i]->generate(names[i], reference_metadata[i]);
+    }
+
+    std::vector<std::size_t> num_records(3, 0);
+    std::size_t last_scenario = 0;
+    batch.generate([&](std::size_t scenario, std::size_t first_record,
+                       utilities::TimeHistoryBlock& records,
+                       const std::vector<stochastic::RecordMetadata>& metadata) {
+      // Blocks arrive in order of scenarios and records
+      REQUIRE(scenario >= last_scenario);
+      REQUIRE(first_record == num_records[scenario]);
+      last_scenario = scenario;
+
+      REQUIRE(metadata.size() == records.num_records());
+      for (std::size_t i = 0; i < records.num_records(); ++i) {
+        std::size_t record = first_record + i;
+        REQUIRE(metadata[i].name == reference_metadata[scenario][record].name);
+        for (unsigned int j = 0; j < records.num_components(); ++j) {
+          REQUIRE(records.component(i, j) ==
+                  reference_records[scenario].component(record, j));
+        }
+      }
+      num_records[scenario] += records.num_records();
+    });
+
+    REQUIRE(num_records == std::vector<std::size_t>{2, 2, 1});
+    REQUIRE(batch_models[0]->num_threads() == 3);
+    REQUIRE(batch_models[1]->num_threads() == 1);
+  }
+
+  SECTION("Test events of all scenarios are written to a single file") {
+    auto batch_models = scenario_models();
+    auto reference_models = scenario_models();
+
+    stochastic::ScenarioBatch batch(0);
+    for (std::size_t i = 0; i < batch_models.size(); ++i) {
+      batch.add_scenario(names[i], batch_models[i]);
+    }
+    REQUIRE(batch.generate(std::string("./scenario_batch.json")));
+
+    std::ifstream batch_file("./scenario_batch.json");
+    nlohmann::json batch_json;
+    batch_file >> batch_json;
+
+    std::size_t event = 0;
+    for (std::size_t i = 0; i < reference_models.size(); ++i) {
+      auto reference =
+          reference_models[i]->generate(names[i]).get_library_json();
+      for (auto const& reference_event : reference["Events"]) {
+        REQUIRE(batch_json["Events"][event] == reference_event);
+        ++event;
+      }
+    }
+    REQUIRE(batch_json["Events"].size() == event);
+  }
+
+  SECTION("Test shards concatenated in order match the whole batch") {
+    auto reference_models = scenario_models();
+    stochastic::ScenarioBatch reference_batch(2);
+    for (std::size_t i = 0; i < reference_models.size(); ++i) {
+      reference_batch.add_scenario(names[i], reference_models[i]);
+    }
+    REQUIRE(reference_batch.num_records() == 5);
+    REQUIRE(reference_batch.generate(std::string("./scenario_batch.json")));
+
+    std::ifstream reference_file("./scenario_batch.json");
+    nlohmann::json reference_json;
+    reference_file >> reference_json;
+
+    // Each shard is generated by its own batch, as by separate processes
+    std::vector<std::string> locations = {"./scenario_shard0.json",
+                                          "./scenario_shard1.json",
+                                          "./scenario_shard2.json"};
+    nlohmann::json shard_events = nlohmann::json::array();
+    for (std::size_t shard = 0; shard < locations.size(); ++shard) {
+      auto shard_models = scenario_models();
+      stochastic::ScenarioBatch batch(2);
+      for (std::size_t i = 0; i < shard_models.size(); ++i) {
+        batch.add_scenario(names[i], shard_models[i]);
+      }
+      batch.set_shard(shard, locations.size());
+      REQUIRE(batch.generate(locations[shard]));
+
+      std::ifstream shard_file(locations[shard]);
+      nlohmann::json shard_json;
+      shard_file >> shard_json;
+      REQUIRE(shard_json["Events"].size() == batch.shard_range(shard).second);
+      for (auto const& event : shard_json["Events"]) {
+        shard_events.push_back(event);
+      }
+    }
+    REQUIRE(shard_events == reference_json["Events"]);
+
+    reference_batch.set_shard(0, locations.size());
+    auto index = reference_batch.shard_index(locations).get_library_json();
+    REQUIRE(index["numRecords"] == 5);
+    REQUIRE(index["shards"].size() == 3);
+    REQUIRE(index["shards"][1]["location"] == locations[1]);
+    REQUIRE(index["shards"][1]["firstRecord"] == 1);
+    REQUIRE(index["shards"][1]["numRecords"] == 2);
+    REQUIRE(index["scenarios"][2]["name"] == "SiteC");
+    REQUIRE(index["scenarios"][2]["firstRecord"] == 4);
+    REQUIRE(index["scenarios"][2]["numRecords"] == 1);
+
+    REQUIRE_THROWS_AS(reference_batch.set_shard(3, 3), std::runtime_error);
+    REQUIRE_THROWS_AS(reference_batch.set_shard(0, 0), std::runtime_error);
+    REQUIRE_THROWS_AS(reference_batch.shard_index({"./scenario_batch.json"}),
+                      std::runtime_error);
+  }
+
+  SECTION("Test scenarios require separate models") {
+    auto models = scenario_models();
+    stochastic::ScenarioBatch batch;
+    batch.add_scenario("SiteA", models[0]);
+    REQUIRE_THROWS_AS(batch.add_scenario("SiteB", models[0]),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(batch.add_scenario("SiteB", nullptr),
+                      std::runtime_error);
+  }
+}
+
+TEST_CASE("Test spatially correlated multi-site generation",
+          "[Stochastic][Batch]") {
+  config::initialize();
+  // Two nearly coincident sites and one site beyond the taper length
+  std::vector<stochastic::VlachosMultiSite::Site> sites = {
+      {0.0, 0.0, 20.0, 400.0}, {0.01, 0.0, 20.0, 400.0},
+      {50.0, 0.0, 20.0, 400.0}};
+  auto site_records = [](const stochastic::VlachosMultiSite& region,
+                         std::size_t site) {
+    std::vector<stochastic::RecordMetadata> metadata;
+    auto records = region.model(site)->generate("Region", metadata);
+    std::vector<std::vector<double>> components;
+    for (std::size_t i = 0; i < records.num_records(); ++i) {
+      components.push_back(records.component(i, 0));
+    }
+    return components;
+  };
+
+  SECTION("Test nearby sites share correlated phase fields") {
+    stochastic::VlachosMultiSite region(6.5, sites, 0.0, 2, 1, 10.0, 30.0,
+                                        true, 100);
+    stochastic::VlachosMultiSite repeated(6.5, sites, 0.0, 2, 1, 10.0, 30.0,
+                                          true, 100);
+    REQUIRE(region.num_sites() == 3);
+    REQUIRE(region.correlation().correlation(0, 2) == 0.0);
+
+    std::vector<std::vector<std::vector<double>>> records;
+    for (std::size_t i = 0; i < sites.size(); ++i) {
+      records.push_back(site_records(region, i));
+      REQUIRE(records[i] == site_records(repeated, i));
+    }
+    for (std::size_t k = 0; k < 2; ++k) {
+      REQUIRE(record_correlation(records[0][k], records[1][k]) > 0.9);
+      REQUIRE(std::abs(record_correlation(records[0][k], records[2][k])) <
+              0.5);
+    }
+  }
+
+  SECTION("Test phases of sites are independent unless correlated") {
+    stochastic::VlachosMultiSite region(6.5, sites, 0.0, 2, 1, 10.0, 30.0,
+                                        false, 100);
+    auto first_records = site_records(region, 0);
+    auto second_records = site_records(region, 1);
+    for (std::size_t k = 0; k < 2; ++k) {
+      REQUIRE(std::abs(record_correlation(first_records[k],
+                                          second_records[k])) < 0.5);
+    }
+  }
+
+  SECTION("Test site streams are keyed by region seed and site") {
+    // Seeds near the limits of int give repeatable sites
+    for (int seed : {std::numeric_limits<int>::max(), -1, -2, -3}) {
+      stochastic::VlachosMultiSite region(6.5, sites, 0.0, 1, 1, 10.0, 30.0,
+                                          false, seed);
+      stochastic::VlachosMultiSite repeated(6.5, sites, 0.0, 1, 1, 10.0,
+                                            30.0, false, seed);
+      for (std::size_t i = 0; i < sites.size(); ++i) {
+        REQUIRE(site_records(region, i) == site_records(repeated, i));
+      }
+    }
+
+    // Regions with adjacent seeds do not share the phases of any site
+    stochastic::VlachosMultiSite region(6.5, sites, 0.0, 2, 1, 10.0, 30.0,
+                                        false, 100);
+    stochastic::VlachosMultiSite adjacent(6.5, sites, 0.0, 2, 1, 10.0, 30.0,
+                                          false, 101);
+    auto shifted_records = site_records(region, 1);
+    auto adjacent_records = site_records(adjacent, 0);
+    for (std::size_t k = 0; k < 2; ++k) {
+      REQUIRE(std::abs(record_correlation(shifted_records[k],
+                                          adjacent_records[k])) < 0.5);
+    }
+  }
+
+  SECTION("Test sites are synthesized in parallel by scenario batch") {
+    stochastic::VlachosMultiSite region(6.5, sites, 0.0, 2, 1, 10.0, 30.0,
+                                        true, 100);
+    stochastic::VlachosMultiSite reference(6.5, sites, 0.0, 2, 1, 10.0, 30.0,
+                                           true, 100);
+    stochastic::ScenarioBatch batch(3);
+    region.add_scenarios(batch, "Region");
+    REQUIRE(batch.num_scenarios() == 3);
+    REQUIRE(batch.num_records() == 6);
+
+    std::vector<std::vector<std::vector<double>>> reference_records;
+    for (std::size_t i = 0; i < sites.size(); ++i) {
+      reference_records.push_back(site_records(reference, i));
+    }
+    using Metadata = std::vector<stochastic::RecordMetadata>;
+    batch.generate([&](std::size_t scenario, std::size_t first_record,
+                       utilities::TimeHistoryBlock& records,
+                       const Metadata& metadata) {
+      for (std::size_t i = 0; i < records.num_records(); ++i) {
+        REQUIRE(metadata[i].name.find("Region_Site" +
+                                      std::to_string(scenario)) == 0);
+        REQUIRE(records.component(i, 0) ==
+                reference_records[scenario][first_record + i]);
+      }
+    });
+  }
+
+  SECTION("Test invalid regions throw exceptions") {
+    REQUIRE_THROWS_AS(
+        stochastic::VlachosMultiSite(6.5, {}, 0.0, 2, 1, 10.0, 30.0, true,
+                                     100),
+        std::runtime_error);
+    REQUIRE_THROWS_AS(stochastic::VlachosEtAl(6.5, 20.0, 400.0, 0.0,
+                                              Eigen::MatrixXd::Zero(2, 17),
+                                              1, 100),
+                      std::runtime_error);
+    stochastic::VlachosEtAl model(6.5, 20.0, 400.0, 0.0, 1, 1, 100);
+    auto correlation = std::make_shared<numeric_utils::SpatialCorrelation>(
+        std::vector<double>{0.0}, std::vector<double>{0.0}, 10.0, 30.0);
+    REQUIRE_THROWS_AS(model.set_phase_field(correlation, 1, 100),
+                      std::runtime_error);
+  }
+}
@@ -1,11 +1,25 @@
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
 #include <catch2/catch.hpp>
 #include <Eigen/Dense>
 #include <nlohmann/json.hpp>
+#include "acceptance_criteria.h"
+#include "configure.h"
 #include "dabaghi_der_kiureghian.h"
+#include "device_backend.h"
 #include "factory.h"
+#include "json_object.h"
+#include "numeric_utils.h"
+#include "profiler.h"
+#include "response_spectrum.h"
 #include "vlachos_et_al.h"
 #include "wittig_sinha.h"
 
@@ -94,6 +108,44 @@ TEST_CASE("Test Vlachos et al. (2018) implementation", "[Stochastic][Seismic]")
             Approx(-1.0 / (100.0 * 9.81 * std::sqrt(2.0))).epsilon(0.01));
   }
 
+  SECTION("Test fused post-processing and rotation") {
+    stochastic::VlachosEtAl test_model_2(6.5, 30.0, 500.0, 315.0, 1, 1);
+    numeric_utils::Convolver highpass_filter(std::vector<double>{
+        0.5, -0.25, 0.125, -0.0625});
+    std::vector<double> acceleration(500);
+    for (unsigned int i = 0; i < acceleration.size(); ++i) {
+      acceleration[i] = std::sin(0.05 * i) + 0.01 * i;
+    }
+
+    // Separate post-processing followed by rotation
+    std::vector<double> filtered = acceleration, x_expected, y_expected;
+    test_model_2.post_process(filtered, highpass_filter);
+    test_model_2.rotate_acceleration(filtered, x_expected, y_expected, true);
+
+    std::vector<double> time_history = acceleration, x_accels, y_accels;
+    test_model_2.post_process(time_history, highpass_filter, x_accels,
+                              y_accels, true);
+    REQUIRE(x_accels.size() == x_expected.size());
+    REQUIRE(y_accels.size() == y_expected.size());
+    for (unsigned int i = 0; i < x_accels.size(); ++i) {
+      REQUIRE(x_accels[i] == Approx(x_expected[i]).margin(1.0e-12));
+      REQUIRE(y_accels[i] == Approx(y_expected[i]).margin(1.0e-12));
+    }
+
+    // Reused buffers are not reallocated
+    const double* x_data = x_accels.data();
+    time_history = acceleration;
+    test_model_2.post_process(time_history, highpass_filter, x_accels,
+                              y_accels, true);
+    REQUIRE(x_accels.data() == x_data);
+
+    // Records shorter than the taper are rejected
+    time_history.assign(50, 1.0);
+    REQUIRE_THROWS_AS(test_model_2.post_process(time_history, highpass_filter,
+                                                x_accels, y_accels, true),
+                      std::runtime_error);
+  }
+
   SECTION("Test K-T model") {
     std::vector<double> params = {2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
     std::vector<double> frequencies = {1.0, 2.0};
@@ -107,7 +159,176 @@ TEST_CASE("Test Vlachos et al. (2018) implementation", "[Stochastic][Seismic]")
     }
   }
 
-  SECTION("Test time history generation") {  
+  SECTION("Test evolutionary power spectrum matches K-T model at each time") {
+    Eigen::VectorXd initial_params = Eigen::VectorXd::Ones(18);
+    initial_params(11) = 100.0;
+    initial_params(14) = 1.0;
+    initial_params(17) = 5.0;
+    auto params = test_model.identify_parameters(initial_params);
+    auto power_spectrum = test_model.evolutionary_power_spectrum(params);
+
+    // Row-wise evaluation at the time and frequency steps of the model
+    double time_step = 0.01, freq_step = 0.2;
+    REQUIRE(power_spectrum.rows() == std::ceil(params[17] / time_step) + 1);
+    REQUIRE(power_spectrum.cols() == 1101);
+    std::vector<double> times(power_spectrum.rows());
+    for (unsigned int i = 0; i < times.size(); ++i) {
+      times[i] = i * time_step / ((times.size() - 1) * time_step);
+    }
+    times[0] = 1E-6;
+    std::vector<double> frequencies(power_spectrum.cols());
+    std::vector<double> highpass_butter(frequencies.size());
+    for (unsigned int j = 0; j < frequencies.size(); ++j) {
+      frequencies[j] = j * freq_step;
+      double freq_ratio_sq = std::pow(frequencies[j] / (2.0 * M_PI * 0.2), 8);
+      highpass_butter[j] = freq_ratio_sq / (1.0 + freq_ratio_sq);
+    }
+
+    auto energy = test_model.energy_accumulation({params[0], params[1]}, times);
+    auto mode_1_freqs = test_model.modal_frequencies(
+        {params[2], params[3], params[4]}, energy);
+    auto mode_2_freqs = test_model.modal_frequencies(
+        {params[5], params[6], params[7]}, energy);
+    auto participation = test_model.modal_participation_factor(
+        {params[10], params[11], params[12], params[13], params[14],
+         params[15]},
+        energy);
+    auto modulation = test_model.amplitude_modulating_function(
+        params[17], params[16], {params[0], params[1]}, times);
+
+    for (unsigned int i = 0; i < times.size(); ++i) {
+      Eigen::VectorXd row =
+          test_model.kt_2({mode_1_freqs[i], params[8], 1.0, mode_2_freqs[i],
+                           params[9], participation[i]},
+                          frequencies, highpass_butter);
+      row *= modulation[i] /
+             (2.0 * numeric_utils::trapazoid_rule(row, freq_step));
+      double error =
+          (power_spectrum.row(i).transpose() - row).cwiseAbs().maxCoeff();
+      REQUIRE(error <= 1.0e-12 * row.cwiseAbs().maxCoeff());
+    }
+  }
+
+  SECTION("Test overlap-add synthesis against direct summation") {
+    unsigned int num_times = 1000, num_freqs = 300;
+    double time_step = 0.01, freq_step = 0.2;
+    Eigen::MatrixXd power_spectrum(num_times, num_freqs);
+    std::vector<double> phase_angles(num_freqs);
+
+    std::mt19937 generator(10);
+    std::uniform_real_distribution<double> distribution(0.0, 2.0 * M_PI);
+    for (auto& angle : phase_angles) {
+      angle = distribution(generator);
+    }
+
+    for (unsigned int i = 0; i < num_times; ++i) {
+      double time = i * time_step;
+      for (unsigned int j = 0; j < num_freqs; ++j) {
+        double freq = j * freq_step;
+        power_spectrum(i, j) = time * time * std::exp(-time / 3.0) *
+                               std::exp(-std::pow((freq - 20.0) / 10.0, 2));
+      }
+    }
+
+    std::vector<double> direct_history(num_times, 0.0);
+    for (unsigned int i = 0; i < num_times; ++i) {
+      for (unsigned int j = 0; j < num_freqs; ++j) {
+        direct_history[i] += std::sqrt(power_spectrum(i, j)) *
+                             std::cos(j * freq_step * i * time_step +
+                                      phase_angles[j]);
+      }
+      direct_history[i] = 2.0 * std::sqrt(freq_step) * direct_history[i];
+    }
+
+    std::vector<double> ola_history;
+    test_model.set_synthesis_method(stochastic::SynthesisMethod::OverlapAddFFT,
+                                    100);
+    test_model.overlap_add_synthesis(ola_history, power_spectrum,
+                                     phase_angles);
+    double error_bound = test_model.overlap_add_error_bound(power_spectrum);
+
+    REQUIRE(ola_history.size() == num_times);
+    double max_error = 0.0, error_sq = 0.0, history_sq = 0.0;
+    for (unsigned int i = 0; i < num_times; ++i) {
+      double error = ola_history[i] - direct_history[i];
+      max_error = std::max(max_error, std::abs(error));
+      error_sq += error * error;
+      history_sq += direct_history[i] * direct_history[i];
+    }
+    REQUIRE(max_error <= error_bound);
+    REQUIRE(std::sqrt(error_sq / history_sq) < 0.05);
+
+    REQUIRE_THROWS_AS(test_model.set_synthesis_method(
+                          stochastic::SynthesisMethod::OverlapAddFFT, 99),
+                      std::runtime_error);
+    REQUIRE_NOTHROW(test_model.generate("OverlapAdd"));
+  }
+
+  SECTION("Test low-rank synthesis against direct summation") {
+    unsigned int num_times = 800, num_freqs = 250;
+    double time_step = 0.01, freq_step = 0.2;
+    Eigen::MatrixXd power_spectrum(num_times, num_freqs);
+    std::vector<double> phase_angles(num_freqs);
+
+    std::mt19937 generator(20);
+    std::uniform_real_distribution<double> distribution(0.0, 2.0 * M_PI);
+    for (auto& angle : phase_angles) {
+      angle = distribution(generator);
+    }
+
+    // Dominant frequency shifts over time so spectrum is not separable
+    for (unsigned int i = 0; i < num_times; ++i) {
+      double time = i * time_step;
+      for (unsigned int j = 0; j < num_freqs; ++j) {
+        double freq = j * freq_step;
+        power_spectrum(i, j) =
+            time * time * std::exp(-time / 2.0) *
+            std::exp(-std::pow((freq - 25.0 + 2.0 * time) / 8.0, 2));
+      }
+    }
+
+    std::vector<double> direct_history(num_times, 0.0);
+    for (unsigned int i = 0; i < num_times; ++i) {
+      for (unsigned int j = 0; j < num_freqs; ++j) {
+        direct_history[i] += std::sqrt(power_spectrum(i, j)) *
+                             std::cos(j * freq_step * i * time_step +
+                                      phase_angles[j]);
+      }
+      direct_history[i] = 2.0 * std::sqrt(freq_step) * direct_history[i];
+    }
+
+    for (double tolerance : {1.0e-2, 1.0e-8}) {
+      test_model.set_low_rank_tolerance(tolerance);
+      Eigen::MatrixXd time_modulation, frequency_shapes;
+      REQUIRE(test_model.factor_spectrum(power_spectrum, time_modulation,
+                                         frequency_shapes));
+      REQUIRE(time_modulation.cols() < num_freqs);
+
+      Eigen::MatrixXd amplitudes = power_spectrum.array().sqrt().matrix();
+      REQUIRE((amplitudes - time_modulation * frequency_shapes.transpose())
+                  .norm() <= tolerance * amplitudes.norm() * (1.0 + 1.0e-6));
+
+      std::vector<double> low_rank_history;
+      test_model.low_rank_synthesis(low_rank_history, time_modulation,
+                                    frequency_shapes, phase_angles);
+      REQUIRE(low_rank_history.size() == num_times);
+
+      double error_sq = 0.0, history_sq = 0.0;
+      for (unsigned int i = 0; i < num_times; ++i) {
+        error_sq += std::pow(low_rank_history[i] - direct_history[i], 2);
+        history_sq += direct_history[i] * direct_history[i];
+      }
+      REQUIRE(std::sqrt(error_sq / history_sq) < 5.0 * tolerance + 1.0e-9);
+    }
+
+    REQUIRE_THROWS_AS(test_model.set_low_rank_tolerance(1.5),
+                      std::runtime_error);
+    test_model.set_low_rank_tolerance(1.0e-3);
+    test_model.set_synthesis_method(stochastic::SynthesisMethod::LowRank);
+    REQUIRE_NOTHROW(test_model.generate("LowRank"));
+  }
+
+  SECTION("Test time history generation") {
     auto test_model_factory =
         Factory<stochastic::StochasticModel, double, double, double, double,
                 unsigned int, unsigned int>::instance()
@@ -122,7 +343,618 @@ TEST_CASE("Test Vlachos et al. (2018) implementation", "[Stochastic][Seismic]")
     // stochastic::VlachosEtAl coalinga_model(6.36, 43.6, 441.4, 0.0, 0.01, 0.2, 1, 1);
     // auto results = coalinga_model.generate("TestHistory", "./coalinga.json");
   }
+
+  SECTION("Test batched parameter identification matches sequential") {
+    // Mode 1 mean greater than mode 2 mean so initial parameters are rejected
+    Eigen::VectorXd initial_params = Eigen::VectorXd::Ones(18);
+    initial_params(11) = 100.0;
+    initial_params(14) = 1.0;
+
+    for (int seed : {10, 20, 30}) {
+      stochastic::VlachosEtAl sequential_model(moment_magnitude, rupture_dist,
+                                               vs30, orientation, 1, 1, seed);
+      stochastic::VlachosEtAl batched_model(moment_magnitude, rupture_dist,
+                                            vs30, orientation, 1, 1, seed);
+
+      auto sequential_params =
+          sequential_model.identify_parameters(initial_params, 1);
+      auto batched_params = batched_model.identify_parameters(initial_params);
+
+      REQUIRE(sequential_params(11) <= sequential_params(14));
+      REQUIRE(sequential_params == batched_params);
+
+      // Candidates left over by one call are used by the next ones
+      for (unsigned int i = 0; i < 8; ++i) {
+        REQUIRE(sequential_model.identify_parameters(initial_params, 1) ==
+                batched_model.identify_parameters(initial_params));
+      }
+    }
+
+    // Parameters satisfying constraints are returned unchanged
+    auto identified_params = test_model.identify_parameters(initial_params);
+    REQUIRE(test_model.identify_parameters(identified_params) ==
+            identified_params);
+  }
+
+  SECTION("Test tabulated distributions are used when switched on") {
+    stochastic::VlachosEtAl exact_model(moment_magnitude, rupture_dist, vs30,
+                                        orientation, 3, 1, 100);
+    config::set_tabulated_distributions(true);
+    REQUIRE(config::tabulated_distributions());
+    stochastic::VlachosEtAl tabulated_model(moment_magnitude, rupture_dist,
+                                            vs30, orientation, 3, 1, 100);
+    config::set_tabulated_distributions(false);
+
+    // Beta, Student's t and inverse Gaussian parameters go through tables,
+    // while other parameters are unchanged
+    auto exact_spectra =
+        exact_model.spectral_archive("Exact").get_library_json()["spectra"];
+    auto tabulated_spectra = tabulated_model.spectral_archive("Tabulated")
+                                 .get_library_json()["spectra"];
+    std::vector<unsigned int> tabulated_indices = {8, 9, 11, 12, 14, 15};
+    for (unsigned int i = 0; i < 3; ++i) {
+      for (unsigned int j = 0; j < 18; ++j) {
+        double exact = exact_spectra[i][j], tabulated = tabulated_spectra[i][j];
+        if (std::find(tabulated_indices.begin(), tabulated_indices.end(), j) !=
+            tabulated_indices.end()) {
+          REQUIRE(tabulated != exact);
+          REQUIRE(tabulated == Approx(exact).epsilon(1.0e-5));
+        } else {
+          REQUIRE(tabulated == exact);
+        }
+      }
+    }
+  }
+
+  SECTION("Test parallel generation matches serial generation for seed") {
+    stochastic::VlachosEtAl serial_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 3, 2, 100);
+    stochastic::VlachosEtAl parallel_model(moment_magnitude, rupture_dist,
+                                           vs30, orientation, 3, 2, 100);
+    parallel_model.set_num_threads(4);
+    REQUIRE(parallel_model.num_threads() == 4);
+
+    auto serial_json = serial_model.generate("Serial").get_library_json();
+    auto parallel_json = parallel_model.generate("Parallel").get_library_json();
+
+    REQUIRE(serial_json["Events"].size() == parallel_json["Events"].size());
+    for (unsigned int i = 0; i < serial_json["Events"].size(); ++i) {
+      REQUIRE(serial_json["Events"][i]["timeSeries"] ==
+              parallel_json["Events"][i]["timeSeries"]);
+    }
+
+    // Simulations for the same spectrum use different random streams
+    REQUIRE(serial_json["Events"][0]["timeSeries"][0]["data"] !=
+            serial_json["Events"][1]["timeSeries"][0]["data"]);
+  }
+
+  SECTION("Test FFT padding keeps records up to rounding") {
+    stochastic::VlachosEtAl exact_model(moment_magnitude, rupture_dist, vs30,
+                                        orientation, 2, 1, 100);
+    stochastic::VlachosEtAl padded_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 2, 1, 100);
+    REQUIRE(!padded_model.fft_padding());
+    padded_model.set_fft_padding(true);
+    REQUIRE(padded_model.fft_padding());
+
+    std::vector<stochastic::RecordMetadata> metadata;
+    auto exact_records = exact_model.generate("Exact", metadata);
+    auto padded_records = padded_model.generate("Padded", metadata);
+
+    // Filter convolutions are exact for any zero-padded length
+    REQUIRE(padded_records.num_records() == exact_records.num_records());
+    for (unsigned int i = 0; i < exact_records.num_records(); ++i) {
+      REQUIRE(padded_records.num_steps(i) == exact_records.num_steps(i));
+      auto exact = exact_records.component(i, 0);
+      double peak = 0.0;
+      for (auto value : exact) {
+        peak = std::max(peak, std::abs(value));
+      }
+      auto padded = padded_records.component(i, 0);
+      for (unsigned int j = 0; j < exact.size(); ++j) {
+        REQUIRE(padded[j] == Approx(exact[j]).margin(1.0e-9 * peak));
+      }
+    }
+  }
+
+  SECTION("Test cached deterministic intermediates keep records") {
+    stochastic::VlachosEtAl cached_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 2, 1, 100);
+    stochastic::VlachosEtAl reference_model(moment_magnitude, rupture_dist,
+                                            vs30, orientation, 2, 1, 100);
+    REQUIRE(!cached_model.deterministic_cache());
+    cached_model.set_deterministic_cache(true);
+    REQUIRE(cached_model.deterministic_cache());
+
+    auto require_equal_records = [&]() {
+      std::vector<stochastic::RecordMetadata> metadata;
+      auto reference_records = reference_model.generate("Cache", metadata);
+      for (unsigned int call = 0; call < 2; ++call) {
+        auto cached_records = cached_model.generate("Cache", metadata);
+        REQUIRE(cached_records.num_records() ==
+                reference_records.num_records());
+        for (unsigned int i = 0; i < reference_records.num_records(); ++i) {
+          for (unsigned int j = 0; j < 2; ++j) {
+            REQUIRE(cached_records.component(i, j) ==
+                    reference_records.component(i, j));
+          }
+        }
+      }
+    };
+    require_equal_records();
+
+    // Cached filter is rebuilt when padding changes
+    cached_model.set_fft_padding(true);
+    reference_model.set_fft_padding(true);
+    require_equal_records();
+
+    cached_model.set_deterministic_cache(false);
+    require_equal_records();
+  }
+
+  SECTION("Test streamed file output matches JSON object output") {
+    stochastic::VlachosEtAl object_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 3, 2, 100);
+    stochastic::VlachosEtAl stream_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 3, 2, 100);
+    auto response_spectrum =
+        std::make_shared<const numeric_utils::ResponseSpectrum>(
+            std::vector<double>{0.1, 1.0}, std::vector<double>{0.05}, 0.01);
+    object_model.set_response_spectrum(response_spectrum);
+    stream_model.set_response_spectrum(response_spectrum);
+    // Two threads generate the three spectra in two batches
+    stream_model.set_num_threads(2);
+
+    object_model.generate("Stream").write_to_file("./vlachos_object.json");
+    REQUIRE(stream_model.generate("Stream", "./vlachos_stream.json", false));
+
+    std::ifstream object_file("./vlachos_object.json"),
+        stream_file("./vlachos_stream.json");
+    std::string object_output((std::istreambuf_iterator<char>(object_file)),
+                              std::istreambuf_iterator<char>());
+    std::string stream_output((std::istreambuf_iterator<char>(stream_file)),
+                              std::istreambuf_iterator<char>());
+    REQUIRE(!stream_output.empty());
+    REQUIRE(stream_output == object_output);
+  }
+
+  SECTION("Test generation into contiguous storage with metadata") {
+    std::shared_ptr<stochastic::StochasticModel> block_model =
+        std::make_shared<stochastic::VlachosEtAl>(
+            moment_magnitude, rupture_dist, vs30, orientation, 2, 2, 100);
+    stochastic::VlachosEtAl json_model(moment_magnitude, rupture_dist, vs30,
+                                       orientation, 2, 2, 100);
+    std::vector<stochastic::RecordMetadata> metadata;
+    auto records = block_model->generate("Block", metadata);
+    auto json = json_model.generate("Block").get_library_json();
+
+    REQUIRE(metadata.size() == 4);
+    REQUIRE(records.num_records() == 4);
+    for (unsigned int i = 0; i < metadata.size(); ++i) {
+      REQUIRE(metadata[i].name == json["Events"][i]["name"]);
+      REQUIRE(metadata[i].type == "Seismic");
+      REQUIRE(metadata[i].time_step == json["Events"][i]["dT"]);
+      REQUIRE(metadata[i].num_steps == json["Events"][i]["numSteps"]);
+      REQUIRE(metadata[i].components ==
+              std::vector<std::string>{"accel_x", "accel_y"});
+      for (unsigned int j = 0; j < 2; ++j) {
+        REQUIRE(metadata[i].components[j] ==
+                json["Events"][i]["timeSeries"][j]["name"]);
+        REQUIRE(records.component(i, j) ==
+                json["Events"][i]["timeSeries"][j]["data"]
+                    .get<std::vector<double>>());
+      }
+    }
+  }
+
+  SECTION("Test profile of stages of generate") {
+    stochastic::VlachosEtAl profiled_model(moment_magnitude, rupture_dist,
+                                           vs30, orientation, 2, 2, 100);
+    profiled_model.set_num_threads(2);
+    std::vector<stochastic::RecordMetadata> metadata;
+    profiled_model.generate("Profile", metadata);
+
+    auto profile = profiled_model.profile().get_library_json();
+    if (utilities::profiling_enabled()) {
+      for (const auto& stage :
+           {"parameterIdentification", "powerSpectrum", "synthesis",
+            "filtering"}) {
+        REQUIRE(profile["stages"].count(stage) == 1);
+        REQUIRE(profile["stages"][stage]["seconds"] >= 0.0);
+      }
+      REQUIRE(profile["stages"]["synthesis"]["calls"] == 4);
+      REQUIRE(profile["counters"]["candidates"] == 4);
+      REQUIRE(profile["counters"]["recordBytesAllocated"] > 0);
+    } else {
+      REQUIRE(profile["stages"].empty());
+      REQUIRE(profile["counters"].empty());
+    }
+
+    // Each call to generate starts a new profile
+    profiled_model.generate("Profile", metadata);
+    auto second_profile = profiled_model.profile().get_library_json();
+    REQUIRE(second_profile["stages"].size() == profile["stages"].size());
+    REQUIRE(second_profile["counters"]["candidates"] ==
+            profile["counters"]["candidates"]);
+  }
+
+  SECTION("Test records generated on demand match records of all events") {
+    stochastic::VlachosEtAl iterator_model(moment_magnitude, rupture_dist,
+                                           vs30, orientation, 2, 2, 100);
+    stochastic::VlachosEtAl block_model(moment_magnitude, rupture_dist, vs30,
+                                        orientation, 2, 2, 100);
+    std::vector<stochastic::RecordMetadata> metadata;
+    auto records = block_model.generate("Lazy", metadata);
+
+    // Batches of three records split the family of the first spectrum
+    auto iterator = iterator_model.records("Lazy", false, 3);
+    REQUIRE(iterator.num_records() == 4);
+    utilities::TimeHistoryBlock batch;
+    std::vector<stochastic::RecordMetadata> batch_metadata;
+    std::vector<std::size_t> batch_sizes;
+    while (!iterator.done()) {
+      std::size_t first_record = iterator.position();
+      REQUIRE(iterator.next(batch, batch_metadata));
+      batch_sizes.push_back(batch.num_records());
+      REQUIRE(batch_metadata.size() == batch.num_records());
+      for (std::size_t i = 0; i < batch.num_records(); ++i) {
+        REQUIRE(batch_metadata[i].name == metadata[first_record + i].name);
+        REQUIRE(batch.num_steps(i) == records.num_steps(first_record + i));
+        for (unsigned int j = 0; j < 2; ++j) {
+          REQUIRE(batch.component(i, j) ==
+                  records.component(first_record + i, j));
+        }
+      }
+    }
+    REQUIRE(batch_sizes == std::vector<std::size_t>{3, 1});
+    REQUIRE(!iterator.next(batch));
+
+    REQUIRE_THROWS_AS(
+        stochastic::RecordIterator(
+            4, 0,
+            [](std::size_t, std::size_t,
+               std::vector<stochastic::RecordMetadata>*) {
+              return utilities::TimeHistoryBlock();
+            }),
+        std::runtime_error);
+  }
+
+  SECTION("Test binary file output") {
+    stochastic::VlachosEtAl binary_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 2, 2, 100);
+    stochastic::VlachosEtAl json_model(moment_magnitude, rupture_dist, vs30,
+                                       orientation, 2, 2, 100);
+    binary_model.set_output_format(stochastic::OutputFormat::Binary);
+    REQUIRE(binary_model.generate("Binary", "./vlachos_binary.bin", false));
+    auto json = json_model.generate("Binary").get_library_json();
+
+    std::ifstream binary_file("./vlachos_binary.bin", std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(binary_file)),
+                         std::istreambuf_iterator<char>());
+    REQUIRE(contents.compare(0, 8, "SMELTBIN") == 0);
+    std::uint64_t header_size, data_offset;
+    std::memcpy(&header_size, contents.data() + 24, sizeof(header_size));
+    std::memcpy(&data_offset, contents.data() + 32, sizeof(data_offset));
+    auto header = nlohmann::json::parse(contents.substr(64, header_size));
+
+    REQUIRE(header["Events"].size() == 4);
+    for (unsigned int i = 0; i < header["Events"].size(); ++i) {
+      auto& event = header["Events"][i];
+      REQUIRE(event["name"] == json["Events"][i]["name"]);
+      REQUIRE(event["numSteps"] == json["Events"][i]["numSteps"]);
+      REQUIRE(event["pattern"] == json["Events"][i]["pattern"]);
+      for (unsigned int j = 0; j < 2; ++j) {
+        auto& time_series = event["timeSeries"][j];
+        std::vector<double> values(
+            time_series["numValues"].get<std::size_t>());
+        std::memcpy(values.data(),
+                    contents.data() + data_offset +
+                        time_series["dataOffset"].get<std::size_t>(),
+                    values.size() * sizeof(double));
+        REQUIRE(values == json["Events"][i]["timeSeries"][j]["data"]
+                              .get<std::vector<double>>());
+      }
+    }
+  }
+
+  SECTION("Test appended simulations match one larger campaign") {
+    stochastic::VlachosEtAl appended_model(moment_magnitude, rupture_dist,
+                                           vs30, orientation, 2, 1, 100);
+    stochastic::VlachosEtAl larger_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 2, 3, 100);
+    REQUIRE_THROWS_AS(appended_model.append_records("Append", 2),
+                      std::runtime_error);
+
+    std::vector<stochastic::RecordMetadata> metadata, larger_metadata;
+    auto records = appended_model.generate("Append", metadata);
+    auto larger_records = larger_model.generate("Append", larger_metadata);
+    auto require_larger_record = [&](const utilities::TimeHistoryBlock& block,
+                                     std::size_t record,
+                                     const std::string& name) {
+      std::size_t index = 0;
+      while (index < larger_metadata.size() &&
+             larger_metadata[index].name != name) {
+        ++index;
+      }
+      REQUIRE(index < larger_metadata.size());
+      for (unsigned int j = 0; j < 2; ++j) {
+        REQUIRE(block.component(record, j) ==
+                larger_records.component(index, j));
+      }
+    };
+    for (std::size_t i = 0; i < records.num_records(); ++i) {
+      require_larger_record(records, i, metadata[i].name);
+    }
+
+    // Batches of three records span the appended records of both spectra
+    auto iterator = appended_model.append_records("Append", 2, false, 3);
+    REQUIRE(iterator.num_records() == 4);
+    REQUIRE(appended_model.num_records() == 6);
+    utilities::TimeHistoryBlock batch;
+    std::vector<stochastic::RecordMetadata> batch_metadata;
+    std::vector<std::string> names;
+    while (iterator.next(batch, batch_metadata)) {
+      REQUIRE(batch_metadata.size() == batch.num_records());
+      for (std::size_t i = 0; i < batch.num_records(); ++i) {
+        require_larger_record(batch, i, batch_metadata[i].name);
+        names.push_back(batch_metadata[i].name);
+      }
+    }
+    REQUIRE(names == std::vector<std::string>{
+                         "Append_Spectra0_Sim1", "Append_Spectra0_Sim2",
+                         "Append_Spectra1_Sim1", "Append_Spectra1_Sim2"});
+
+    // Screened candidates depend on the number of simulations
+    appended_model.set_acceptance_criteria(
+        std::make_shared<stochastic::AcceptanceCriteria>(2));
+    REQUIRE_THROWS_AS(appended_model.append_records("Append", 1),
+                      std::runtime_error);
+  }
+
+  SECTION("Test appending simulations to files") {
+    stochastic::VlachosEtAl json_model(moment_magnitude, rupture_dist, vs30,
+                                       orientation, 2, 1, 100);
+    stochastic::VlachosEtAl binary_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 2, 1, 100);
+    stochastic::VlachosEtAl larger_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 2, 2, 100);
+    binary_model.set_output_format(stochastic::OutputFormat::Binary);
+    auto larger_json = larger_model.generate("File").get_library_json();
+    auto require_larger_event = [&](const nlohmann::json& event,
+                                    const std::vector<double>& accel_x) {
+      for (const auto& larger_event : larger_json["Events"]) {
+        if (larger_event["name"] == event["name"]) {
+          REQUIRE(larger_event["timeSeries"][0]["data"]
+                      .get<std::vector<double>>() == accel_x);
+          return;
+        }
+      }
+      FAIL("No event named " << event["name"]);
+    };
+
+    REQUIRE(json_model.generate("File", "./vlachos_append.json", false));
+    REQUIRE(json_model.append("File", "./vlachos_append.json", 1));
+    std::ifstream json_file("./vlachos_append.json");
+    auto appended_json = nlohmann::json::parse(json_file);
+    REQUIRE(appended_json["Events"].size() == 4);
+    for (const auto& event : appended_json["Events"]) {
+      require_larger_event(
+          event, event["timeSeries"][0]["data"].get<std::vector<double>>());
+    }
+
+    REQUIRE(binary_model.generate("File", "./vlachos_append.bin", false));
+    REQUIRE(binary_model.append("File", "./vlachos_append.bin", 1));
+    std::ifstream binary_file("./vlachos_append.bin", std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(binary_file)),
+                         std::istreambuf_iterator<char>());
+    std::uint64_t header_size, data_offset;
+    std::memcpy(&header_size, contents.data() + 24, sizeof(header_size));
+    std::memcpy(&data_offset, contents.data() + 32, sizeof(data_offset));
+    auto header = nlohmann::json::parse(contents.substr(64, header_size));
+    REQUIRE(header["Events"].size() == 4);
+    for (const auto& event : header["Events"]) {
+      auto& time_series = event["timeSeries"][0];
+      std::vector<double> values(time_series["numValues"].get<std::size_t>());
+      std::memcpy(values.data(),
+                  contents.data() + data_offset +
+                      time_series["dataOffset"].get<std::size_t>(),
+                  values.size() * sizeof(double));
+      require_larger_event(event, values);
+    }
+
+    // Campaign keeps its size when appending to a file of another format
+    REQUIRE_THROWS(binary_model.append("File", "./vlachos_append.json", 1));
+    REQUIRE(binary_model.num_records() == 4);
+  }
+
+  SECTION("Test records rebuilt from spectral archives match generated ones") {
+    stochastic::VlachosEtAl archive_model(moment_magnitude, rupture_dist,
+                                          vs30, orientation, 2, 3, 100);
+    stochastic::VlachosEtAl reference_model(moment_magnitude, rupture_dist,
+                                            vs30, orientation, 2, 3, 100);
+    archive_model.set_output_format(stochastic::OutputFormat::Spectral);
+    REQUIRE(
+        archive_model.generate("Archive", "./vlachos_archive.json", false));
+    std::vector<stochastic::RecordMetadata> metadata;
+    auto reference = reference_model.generate("Archive", metadata);
+
+    utilities::JsonObject archive;
+    REQUIRE(archive.read_from_file("./vlachos_archive.json"));
+    auto contents = archive.get_library_json();
+    REQUIRE(contents["records"].size() == 6);
+    for (std::size_t i = 0; i < metadata.size(); ++i) {
+      REQUIRE(contents["records"][i]["name"] == metadata[i].name);
+      REQUIRE(contents["records"][i]["numSteps"] == metadata[i].num_steps);
+    }
+
+    // Archive holds a small fraction of the values of the records
+    REQUIRE(contents["spectra"].size() * contents["spectra"][0].size() * 100 <
+            reference.size());
+
+    stochastic::VlachosEtAl rebuild_model(moment_magnitude, rupture_dist,
+                                          vs30, orientation, 2, 3, 100);
+    auto rebuilt = rebuild_model.rebuild_records(archive, 2, 3);
+    REQUIRE(rebuilt.num_records() == 3);
+    for (std::size_t i = 0; i < rebuilt.num_records(); ++i) {
+      for (unsigned int j = 0; j < 2; ++j) {
+        REQUIRE(rebuilt.component(i, j) == reference.component(i + 2, j));
+      }
+    }
+
+    auto window = rebuild_model.rebuild_record(archive, 4, 100, 50);
+    REQUIRE(window.num_records() == 1);
+    REQUIRE(window.num_steps(0) == 50);
+    auto reference_x = reference.component(4, 0);
+    REQUIRE(window.component(0, 0) ==
+            std::vector<double>(reference_x.begin() + 100,
+                                reference_x.begin() + 150));
+
+    REQUIRE_THROWS_AS(rebuild_model.rebuild_records(archive, 4, 3),
+                      std::runtime_error);
+    stochastic::VlachosEtAl other_model(moment_magnitude, rupture_dist, vs30,
+                                        orientation, 2, 2, 100);
+    REQUIRE_THROWS_AS(other_model.rebuild_records(archive, 0, 1),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(
+        archive_model.append("Archive", "./vlachos_archive.json", 1),
+        std::runtime_error);
+    archive_model.set_acceptance_criteria(
+        std::make_shared<stochastic::AcceptanceCriteria>(2));
+    REQUIRE_THROWS_AS(archive_model.spectral_archive("Archive"),
+                      std::runtime_error);
+  }
+
+  SECTION("Test generated records match JSON time histories") {
+    stochastic::VlachosEtAl test_model(moment_magnitude, rupture_dist, vs30,
+                                       orientation, 2, 2, 100);
+    auto records = test_model.generate_records();
+    auto json = test_model.generate("Records").get_library_json();
+
+    REQUIRE(records.num_records() == 4);
+    REQUIRE(records.num_components() == 2);
+    REQUIRE(json["Events"].size() == 4);
+    for (unsigned int i = 0; i < records.num_records(); ++i) {
+      REQUIRE(json["Events"][i]["numSteps"] == records.num_steps(i));
+      REQUIRE(json["Events"][i]["dT"] == records.time_step());
+      REQUIRE(json["Events"][i]["timeSeries"][0]["data"]
+                  .get<std::vector<double>>() == records.component(i, 0));
+      REQUIRE(json["Events"][i]["timeSeries"][1]["data"]
+                  .get<std::vector<double>>() == records.component(i, 1));
+    }
+  }
   
+  SECTION("Test screening of generated time histories") {
+    auto peak = [](const nlohmann::json& event) {
+      double peak_accel = 0.0;
+      for (auto& time_series : event["timeSeries"]) {
+        for (double value : time_series["data"]) {
+          peak_accel = std::max(peak_accel, std::abs(value));
+        }
+      }
+      return peak_accel;
+    };
+
+    stochastic::VlachosEtAl unscreened_model(moment_magnitude, rupture_dist,
+                                             vs30, orientation, 1, 4, 100);
+    auto unscreened_json =
+        unscreened_model.generate("Unscreened").get_library_json();
+    std::vector<double> peaks;
+    for (auto& event : unscreened_json["Events"]) {
+      peaks.push_back(peak(event));
+    }
+    std::sort(peaks.begin(), peaks.end());
+    double min_peak = peaks[2];
+
+    auto criteria = std::make_shared<stochastic::AcceptanceCriteria>(200);
+    criteria->add_criterion(
+        stochastic::AcceptanceCriteria::peak_acceleration_between(min_peak,
+                                                                  1.0e10));
+
+    stochastic::VlachosEtAl serial_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 1, 4, 100);
+    stochastic::VlachosEtAl parallel_model(moment_magnitude, rupture_dist,
+                                           vs30, orientation, 1, 4, 100);
+    serial_model.set_acceptance_criteria(criteria);
+    parallel_model.set_acceptance_criteria(criteria);
+    parallel_model.set_num_threads(4);
+    auto serial_json = serial_model.generate("Screened").get_library_json();
+    auto parallel_json = parallel_model.generate("Screened").get_library_json();
+
+    REQUIRE(serial_json["Events"].size() == 4);
+    for (unsigned int i = 0; i < 4; ++i) {
+      REQUIRE(peak(serial_json["Events"][i]) >= min_peak);
+      REQUIRE(serial_json["Events"][i]["timeSeries"] ==
+              parallel_json["Events"][i]["timeSeries"]);
+      // Records accepted on first attempt are unchanged by screening
+      if (peak(unscreened_json["Events"][i]) >= min_peak) {
+        REQUIRE(serial_json["Events"][i]["timeSeries"] ==
+                unscreened_json["Events"][i]["timeSeries"]);
+      }
+    }
+
+    // Criteria that cannot be satisfied stop generation
+    auto impossible_criteria =
+        std::make_shared<stochastic::AcceptanceCriteria>(3);
+    impossible_criteria->add_criterion(
+        stochastic::AcceptanceCriteria::significant_duration_between(-2.0,
+                                                                     -1.0));
+    serial_model.set_acceptance_criteria(impossible_criteria);
+    REQUIRE_THROWS_AS(serial_model.generate("Impossible"), std::runtime_error);
+    REQUIRE_THROWS_AS(stochastic::AcceptanceCriteria(0), std::runtime_error);
+
+    // Rejected candidates are replaced by fresh draws from the stream of the
+    // next attempt rather than accumulating onto them
+    unsigned int num_checks = 0;
+    auto reject_first = std::make_shared<stochastic::AcceptanceCriteria>(2);
+    reject_first->add_criterion(
+        [&num_checks](
+            const std::vector<stochastic::IntensityMeasures>& measures) {
+          return ++num_checks > 1;
+        });
+    stochastic::VlachosEtAl retry_model(moment_magnitude, rupture_dist, vs30,
+                                        orientation, 1, 1, 100);
+    stochastic::VlachosEtAl stream_model(moment_magnitude, rupture_dist, vs30,
+                                         orientation, 1, 2, 100);
+    retry_model.set_acceptance_criteria(reject_first);
+    auto retried_json = retry_model.generate("Retried").get_library_json();
+    auto stream_json = stream_model.generate("Streams").get_library_json();
+    REQUIRE(num_checks == 2);
+    for (unsigned int j = 0; j < 2; ++j) {
+      REQUIRE(retried_json["Events"][0]["timeSeries"][j]["data"] ==
+              stream_json["Events"][1]["timeSeries"][j]["data"]);
+    }
+  }
+
+  SECTION("Test response spectra are added to generated events") {
+    stochastic::VlachosEtAl spectra_model(moment_magnitude, rupture_dist, vs30,
+                                          orientation, 1, 2, 100);
+    auto response_spectrum =
+        std::make_shared<const numeric_utils::ResponseSpectrum>(
+            std::vector<double>{0.1, 0.5, 1.0}, std::vector<double>{0.05},
+            0.01);
+    spectra_model.set_response_spectrum(response_spectrum);
+    auto json = spectra_model.generate("Spectra").get_library_json();
+
+    REQUIRE(json["Events"].size() == 2);
+    for (auto& event : json["Events"]) {
+      REQUIRE(event.find("responseSpectra") != event.end());
+      std::vector<double> x_accels = event["timeSeries"][0]["data"];
+      auto spectrum = response_spectrum->compute(x_accels);
+      std::vector<std::vector<double>> accel_x =
+          event["responseSpectra"]["accel_x"];
+      REQUIRE(accel_x.size() == 1);
+      REQUIRE(accel_x[0].size() == 3);
+      for (unsigned int j = 0; j < 3; ++j) {
+        REQUIRE(accel_x[0][j] == Approx(spectrum(0, j)));
+      }
+    }
+
+    // Events do not include spectra by default
+    auto default_json = test_model.generate("Default").get_library_json();
+    REQUIRE(default_json["Events"][0].find("responseSpectra") ==
+            default_json["Events"][0].end());
+  }
+
   SECTION("Test time history generation") {
     int seed = 10;    
     auto test_model_factory1 =
@@ -284,9 +1116,390 @@ TEST_CASE("Test Wittig & Sinha (1975) implementation", "[Stochastic][Wind]") {
     }
   }
 
-  SECTION(
-      "Test that trying to generate time histories when x and y are vectors "
-      "throws exception since this capability isn't currently implemented") {
+  SECTION("Test records do not depend on the number of threads") {
+    stochastic::WittigSinha serial_model("D", 30.0, 123.0, 12, 200.0, 100);
+    stochastic::WittigSinha parallel_model("D", 30.0, 123.0, 12, 200.0, 100);
+    parallel_model.set_num_threads(3);
+    auto serial_records = serial_model.generate_records();
+    auto parallel_records = parallel_model.generate_records();
+
+    REQUIRE(parallel_records.num_components() == 12);
+    for (unsigned int i = 0; i < parallel_records.num_components(); ++i) {
+      REQUIRE(parallel_records.component(0, i) ==
+              serial_records.component(0, i));
+    }
+  }
+
+  SECTION("Test interpolated Cholesky factors approximate exact records") {
+    stochastic::WittigSinha exact_model("D", 30.0, 123.0, 12, 600.0, 100);
+    stochastic::WittigSinha serial_model("D", 30.0, 123.0, 12, 600.0, 100);
+    stochastic::WittigSinha parallel_model("D", 30.0, 123.0, 12, 600.0, 100);
+    REQUIRE(serial_model.cholesky_tolerance() == 0.0);
+    serial_model.set_cholesky_tolerance(1.0e-3);
+    parallel_model.set_cholesky_tolerance(1.0e-3);
+    parallel_model.set_num_threads(3);
+    REQUIRE_THROWS_AS(parallel_model.set_cholesky_tolerance(-1.0),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(parallel_model.set_cholesky_tolerance(1.0),
+                      std::runtime_error);
+
+    auto exact_records = exact_model.generate_records();
+    auto serial_records = serial_model.generate_records();
+    auto parallel_records = parallel_model.generate_records();
+
+    for (unsigned int i = 0; i < exact_records.num_components(); ++i) {
+      auto exact = exact_records.component(0, i);
+      auto approximate = serial_records.component(0, i);
+      REQUIRE(parallel_records.component(0, i) == approximate);
+
+      double error = 0.0, norm = 0.0;
+      for (unsigned int j = 0; j < exact.size(); ++j) {
+        error += (approximate[j] - exact[j]) * (approximate[j] - exact[j]);
+        norm += exact[j] * exact[j];
+      }
+      REQUIRE(std::sqrt(error) < 1.0e-2 * std::sqrt(norm));
+    }
+  }
+
+  SECTION("Test proper orthogonal decomposition matches velocity statistics") {
+    // Velocities at horizontal locations of one model are correlated, so
+    // statistics are averaged over models with independent seeds
+    stochastic::WittigSinha parallel_model("D", 30.0, 123.0, 12, 600.0, 100);
+    REQUIRE(parallel_model.pod_energy_fraction() == 0.0);
+    parallel_model.set_pod_energy_fraction(0.95);
+    parallel_model.set_num_threads(3);
+    REQUIRE_THROWS_AS(parallel_model.set_pod_energy_fraction(-0.1),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(parallel_model.set_pod_energy_fraction(1.1),
+                      std::runtime_error);
+
+    unsigned int num_models = 40;
+    std::vector<utilities::TimeHistoryBlock> exact_records(num_models);
+    std::vector<utilities::TimeHistoryBlock> serial_records(num_models);
+    for (unsigned int k = 0; k < num_models; ++k) {
+      stochastic::WittigSinha exact_model("D", 30.0, 123.0, 12, 600.0,
+                                          100 + k);
+      stochastic::WittigSinha serial_model("D", 30.0, 123.0, 12, 600.0,
+                                           100 + k);
+      serial_model.set_pod_energy_fraction(0.95);
+      exact_records[k] = exact_model.generate_records();
+      serial_records[k] = serial_model.generate_records();
+    }
+    auto parallel_records = parallel_model.generate_records();
+    REQUIRE(serial_records[0].num_components() == 12);
+    REQUIRE(serial_records[0].component(0, 0) !=
+            exact_records[0].component(0, 0));
+
+    // Sample paths differ from those of Cholesky factors, while variances
+    // and correlations between heights are preserved
+    auto covariance = [](const std::vector<double>& first,
+                         const std::vector<double>& second) {
+      double mean_first = 0.0, mean_second = 0.0, product = 0.0;
+      for (unsigned int j = 0; j < first.size(); ++j) {
+        mean_first += first[j] / first.size();
+        mean_second += second[j] / second.size();
+      }
+      for (unsigned int j = 0; j < first.size(); ++j) {
+        product += (first[j] - mean_first) * (second[j] - mean_second) /
+                   first.size();
+      }
+      return product;
+    };
+
+    for (unsigned int i = 0; i < 12; ++i) {
+      REQUIRE(parallel_records.component(0, i) ==
+              serial_records[0].component(0, i));
+
+      double exact_variance = 0.0, approximate_variance = 0.0;
+      double exact_covariance = 0.0, approximate_covariance = 0.0;
+      for (unsigned int k = 0; k < num_models; ++k) {
+        auto exact = exact_records[k].component(0, i);
+        auto approximate = serial_records[k].component(0, i);
+        exact_variance += covariance(exact, exact);
+        approximate_variance += covariance(approximate, approximate);
+        if (i > 0) {
+          exact_covariance +=
+              covariance(exact, exact_records[k].component(0, i - 1));
+          approximate_covariance += covariance(
+              approximate, serial_records[k].component(0, i - 1));
+        }
+      }
+      REQUIRE(approximate_variance == Approx(exact_variance).epsilon(0.1));
+      if (i > 0) {
+        REQUIRE(approximate_covariance / approximate_variance ==
+                Approx(exact_covariance / exact_variance).margin(0.05));
+      }
+    }
+  }
+
+  SECTION("Test coherence decays with horizontal separation of locations") {
+    std::vector<double> heights = {10.0, 20.0};
+    std::vector<double> x_locations = {0.0, 2.0, 200.0};
+    std::vector<double> y_locations = {0.0};
+    stochastic::WittigSinha serial_model("D", 30.0, heights, x_locations,
+                                         y_locations, 600.0, 100);
+    stochastic::WittigSinha parallel_model("D", 30.0, heights, x_locations,
+                                           y_locations, 600.0, 100);
+    parallel_model.set_num_threads(3);
+
+    // Points are ordered by location and then by height, and coherence at the
+    // same height only depends on the horizontal separation
+    double frequency = 0.01;
+    auto density = serial_model.cross_spectral_density(frequency);
+    REQUIRE(density.rows() == 6);
+    REQUIRE(density.cols() == 6);
+    REQUIRE(density(2, 2) == Approx(density(0, 0)));
+    REQUIRE(density(0, 2) < density(0, 0));
+    REQUIRE(density(0, 4) < density(0, 2));
+    REQUIRE(density(1, 3) / density(1, 1) > density(0, 2) / density(0, 0));
+
+    auto records = serial_model.generate_records();
+    auto parallel_records = parallel_model.generate_records();
+    REQUIRE(records.num_records() == 3);
+    for (unsigned int k = 0; k < records.num_records(); ++k) {
+      for (unsigned int i = 0; i < records.num_components(); ++i) {
+        REQUIRE(parallel_records.component(k, i) ==
+                records.component(k, i));
+      }
+    }
+
+    auto correlation = [](const std::vector<double>& first,
+                          const std::vector<double>& second) {
+      Eigen::Map<const Eigen::ArrayXd> x(first.data(), first.size());
+      Eigen::Map<const Eigen::ArrayXd> y(second.data(), second.size());
+      Eigen::ArrayXd x_centered = x - x.mean();
+      Eigen::ArrayXd y_centered = y - y.mean();
+      return (x_centered * y_centered).sum() /
+             std::sqrt(x_centered.square().sum() * y_centered.square().sum());
+    };
+    double near_correlation =
+        correlation(records.component(0, 0), records.component(1, 0));
+    double far_correlation =
+        correlation(records.component(0, 0), records.component(2, 0));
+    REQUIRE(near_correlation > 0.5);
+    REQUIRE(near_correlation > std::abs(far_correlation));
+  }
+
+  SECTION("Test cached Cholesky factors keep records") {
+    stochastic::WittigSinha cached_model("B", 30.0, 60.0, 6, 120.0, 100);
+    stochastic::WittigSinha reference_model("B", 30.0, 60.0, 6, 120.0, 100);
+    cached_model.set_deterministic_cache(true);
+
+    auto require_equal_records = [&]() {
+      auto reference_records = reference_model.generate_records();
+      for (unsigned int call = 0; call < 2; ++call) {
+        auto cached_records = cached_model.generate_records();
+        REQUIRE(cached_records.num_steps(0) == reference_records.num_steps(0));
+        for (unsigned int i = 0; i < 6; ++i) {
+          REQUIRE(cached_records.component(0, i) ==
+                  reference_records.component(0, i));
+        }
+      }
+    };
+    require_equal_records();
+
+    // Factors follow the frequencies when padding changes
+    cached_model.set_fft_padding(true);
+    reference_model.set_fft_padding(true);
+    require_equal_records();
+
+    cached_model.set_precision(stochastic::Precision::Single);
+    reference_model.set_precision(stochastic::Precision::Single);
+    require_equal_records();
+
+    cached_model.set_deterministic_cache(false);
+    require_equal_records();
+  }
+
+  SECTION("Test appending simulations is not supported") {
+    REQUIRE_THROWS_AS(test_wittig_sinha.append_records("Wind", 1),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(test_wittig_sinha.append("Wind", "./wind.json", 1),
+                      std::runtime_error);
+  }
+
+  SECTION("Test records rebuilt from spectral archives match generated ones") {
+    std::vector<double> heights = {10.0, 20.0}, x_locations = {0.0, 10.0},
+                        y_locations = {0.0};
+    stochastic::WittigSinha archive_model("D", 30.0, heights, x_locations,
+                                          y_locations, 60.0, 100);
+    stochastic::WittigSinha reference_model("D", 30.0, heights, x_locations,
+                                            y_locations, 60.0, 100);
+    stochastic::WittigSinha rebuild_model("D", 30.0, heights, x_locations,
+                                          y_locations, 60.0, 100);
+    auto archive = archive_model.spectral_archive("Wind", true);
+    auto reference = reference_model.generate_records(true);
+    REQUIRE(archive.get_library_json()["records"][1]["name"] ==
+            "Wind_Location1");
+
+    // Cached factors are reused by later rebuilds
+    rebuild_model.set_deterministic_cache(true);
+    for (unsigned int k = 0; k < 2; ++k) {
+      auto rebuilt = rebuild_model.rebuild_records(archive, 1, 1);
+      REQUIRE(rebuilt.num_records() == 1);
+      for (unsigned int j = 0; j < heights.size(); ++j) {
+        REQUIRE(rebuilt.component(0, j) == reference.component(1, j));
+      }
+    }
+
+    stochastic::WittigSinha single_location("D", 30.0, 123.0, 4, 60.0, 100);
+    REQUIRE_THROWS_AS(single_location.rebuild_records(archive, 0, 1),
+                      std::runtime_error);
+    stochastic::VlachosEtAl seismic_model(6.5, 30.0, 500.0, 0.0, 1, 2, 100);
+    REQUIRE_THROWS_AS(seismic_model.rebuild_records(archive, 0, 1),
+                      std::runtime_error);
+  }
+
+  SECTION("Test FFT padding keeps record lengths") {
+    // Duration gives an FFT length with large prime factors
+    stochastic::WittigSinha test_model("D", 30.0, 123.0, 4, 203.3, 100);
+    auto exact_records = test_model.generate_records();
+    test_model.set_fft_padding(true);
+    auto padded_records = test_model.generate_records();
+    auto repeated_records = test_model.generate_records();
+
+    // Padding refines frequencies, which changes the velocities
+    REQUIRE(padded_records.num_steps(0) == exact_records.num_steps(0));
+    REQUIRE(padded_records.num_components() == 4);
+    REQUIRE(padded_records.component(0, 0) != exact_records.component(0, 0));
+    for (unsigned int i = 0; i < 4; ++i) {
+      REQUIRE(repeated_records.component(0, i) ==
+              padded_records.component(0, i));
+    }
+
+    test_model.set_fft_padding(false);
+    auto restored_records = test_model.generate_records();
+    for (unsigned int i = 0; i < 4; ++i) {
+      REQUIRE(restored_records.component(0, i) ==
+              exact_records.component(0, i));
+    }
+  }
+
+  SECTION("Test GPU factorizations match host factorizations") {
+    stochastic::WittigSinha test_model("B", 25.0, 100.0, 5, 120.0, 100);
+    numeric_utils::device::set_enabled(true);
+    auto device_records = test_model.generate_records();
+    numeric_utils::device::set_enabled(false);
+    auto host_records = test_model.generate_records();
+
+    for (unsigned int i = 0; i < 5; ++i) {
+      auto device = device_records.component(0, i);
+      auto host = host_records.component(0, i);
+      REQUIRE(device.size() == host.size());
+      for (unsigned int k = 0; k < host.size(); ++k) {
+        REQUIRE(std::abs(device[k] - host[k]) < 1.0e-9);
+      }
+    }
+  }
+
+  SECTION("Test single precision matches double precision") {
+    stochastic::WittigSinha test_model("B", 25.0, 100.0, 5, 120.0, 100);
+    auto double_records = test_model.generate_records();
+    REQUIRE(test_model.precision() == stochastic::Precision::Double);
+    test_model.set_precision(stochastic::Precision::Single);
+    REQUIRE(test_model.precision() == stochastic::Precision::Single);
+    auto single_records = test_model.generate_records();
+
+    REQUIRE(single_records.num_steps(0) == double_records.num_steps(0));
+    for (unsigned int i = 0; i < 5; ++i) {
+      auto exact = double_records.component(0, i);
+      auto single = single_records.component(0, i);
+      double error_sq = 0.0, norm_sq = 0.0;
+      for (unsigned int k = 0; k < exact.size(); ++k) {
+        error_sq += std::pow(single[k] - exact[k], 2);
+        norm_sq += exact[k] * exact[k];
+      }
+      REQUIRE(std::sqrt(error_sq / norm_sq) < 1.0e-4);
+    }
+  }
+
+  SECTION("Test generated records match JSON time histories") {
+    stochastic::WittigSinha test_model("D", 30.0, 123.0, 4, 200.0, 100);
+    auto records = test_model.generate_records();
+    auto json = test_model.generate("Records").get_library_json();
+
+    REQUIRE(records.num_records() == 1);
+    REQUIRE(records.num_components() == 4);
+    for (unsigned int i = 0; i < records.num_components(); ++i) {
+      REQUIRE(json["Events"][0]["timeSeries"][i]["data"]
+                  .get<std::vector<double>>() == records.component(0, i));
+    }
+  }
+
+  SECTION("Test generation into contiguous storage with metadata") {
+    stochastic::WittigSinha test_model("D", 30.0, 123.0, 4, 200.0, 100);
+    std::vector<stochastic::RecordMetadata> metadata;
+    auto records = test_model.generate("Block", metadata);
+    auto json = test_model.generate("Block").get_library_json();
+
+    REQUIRE(metadata.size() == 1);
+    REQUIRE(metadata[0].name == "Block");
+    REQUIRE(metadata[0].type == "Wind");
+    REQUIRE(metadata[0].time_step == json["dT"]);
+    REQUIRE(metadata[0].num_steps == records.num_steps(0));
+    REQUIRE(metadata[0].components.size() == 4);
+    for (unsigned int i = 0; i < 4; ++i) {
+      REQUIRE(metadata[0].components[i] ==
+              json["Events"][0]["timeSeries"][i]["name"]);
+      REQUIRE(records.component(0, i) ==
+              json["Events"][0]["timeSeries"][i]["data"]
+                  .get<std::vector<double>>());
+    }
+  }
+
+  SECTION("Test binary file output") {
+    stochastic::WittigSinha test_model("D", 30.0, 123.0, 4, 200.0, 100);
+    test_model.set_output_format(stochastic::OutputFormat::Binary);
+    REQUIRE(test_model.output_format() == stochastic::OutputFormat::Binary);
+    REQUIRE(test_model.generate("Binary", "./wittig_binary.bin", false));
+    auto records = test_model.generate_records();
+    auto json = test_model.generate("Binary").get_library_json();
+
+    std::ifstream binary_file("./wittig_binary.bin", std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(binary_file)),
+                         std::istreambuf_iterator<char>());
+    std::uint64_t header_size, data_offset;
+    std::memcpy(&header_size, contents.data() + 24, sizeof(header_size));
+    std::memcpy(&data_offset, contents.data() + 32, sizeof(data_offset));
+    auto header = nlohmann::json::parse(contents.substr(64, header_size));
+
+    REQUIRE(header["dT"] == json["dT"]);
+    REQUIRE(header["numSteps"] == json["numSteps"]);
+    REQUIRE(header["Events"][0]["pattern"] == json["Events"][0]["pattern"]);
+    auto& time_series = header["Events"][0]["timeSeries"];
+    REQUIRE(time_series.size() == 4);
+    for (unsigned int i = 0; i < time_series.size(); ++i) {
+      REQUIRE(time_series[i]["name"] ==
+              json["Events"][0]["timeSeries"][i]["name"]);
+      REQUIRE(time_series[i].count("data") == 0);
+      std::vector<double> values(time_series[i]["numValues"].get<std::size_t>());
+      std::size_t offset = time_series[i]["dataOffset"];
+      REQUIRE((data_offset + offset) % 64 == 0);
+      std::memcpy(values.data(), contents.data() + data_offset + offset,
+                  values.size() * sizeof(double));
+      REQUIRE(values == records.component(0, i));
+    }
+  }
+
+  SECTION("Test batched location histories match single location histories") {
+    auto random_numbers = test_wittig_sinha.complex_random_numbers();
+    for (bool units : {false, true}) {
+      auto histories = test_wittig_sinha.gen_location_hists(random_numbers,
+                                                            units);
+      REQUIRE(histories.size() == random_numbers.cols());
+      for (unsigned int i = 0; i < histories.size(); ++i) {
+        auto history =
+            test_wittig_sinha.gen_location_hist(random_numbers, i, units);
+        REQUIRE(histories[i].size() == history.size());
+        for (unsigned int j = 0; j < history.size(); ++j) {
+          REQUIRE(histories[i][j] + 100.0 ==
+                  Approx(history[j] + 100.0).epsilon(1.0e-12));
+        }
+      }
+    }
+  }
+
+  SECTION("Test generation of events at several horizontal locations") {
 
     auto vector_case =
         Factory<stochastic::StochasticModel, std::string, double,
@@ -298,7 +1511,17 @@ TEST_CASE("Test Wittig & Sinha (1975) implementation", "[Stochastic][Wind]") {
                      std::move(std::vector<double>{10.0, 23.0, 50.0}),
                      std::move(200.0), std::move(25));
 
-    REQUIRE_THROWS_AS(vector_case->generate("Test"), std::runtime_error);
+    auto vector_case_events =
+        vector_case->generate("Test").get_library_json()["Events"];
+    std::vector<double> y_locations = {10.0, 23.0, 50.0};
+    REQUIRE(vector_case_events.size() == 3);
+    for (unsigned int i = 0; i < vector_case_events.size(); ++i) {
+      REQUIRE(vector_case_events[i]["name"] ==
+              "Test_Location" + std::to_string(i));
+      REQUIRE(vector_case_events[i]["x"] == 0.0);
+      REQUIRE(vector_case_events[i]["y"] == y_locations[i]);
+      REQUIRE(vector_case_events[i]["timeSeries"].size() == 2);
+    }
 
     auto non_vector_case =
         Factory<stochastic::StochasticModel, std::string, double,
@@ -387,6 +1610,40 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
     test_model.transform_parameters_from_normal_space(false, nopulse_params);
   }
 
+  SECTION("Test tabulated distributions are used when switched on") {
+    config::set_tabulated_distributions(true);
+    stochastic::DabaghiDerKiureghian tabulated_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, num_sims, num_realizations,
+        truncate);
+    config::set_tabulated_distributions(false);
+
+    // Only beta distributed parameters go through tables
+    for (bool pulse_like : {true, false}) {
+      auto exact_params =
+          test_model.compute_transformed_model_parameters(pulse_like);
+      Eigen::VectorXd tabulated_params = exact_params;
+      test_model.transform_parameters_from_normal_space(pulse_like,
+                                                        exact_params);
+      tabulated_model.transform_parameters_from_normal_space(
+          pulse_like, tabulated_params);
+
+      std::vector<unsigned int> beta_indices =
+          pulse_like ? std::vector<unsigned int>{2, 11, 18}
+                     : std::vector<unsigned int>{6, 13};
+      for (unsigned int i = 0; i < exact_params.size(); ++i) {
+        if (std::find(beta_indices.begin(), beta_indices.end(), i) !=
+            beta_indices.end()) {
+          REQUIRE(tabulated_params(i) != exact_params(i));
+          REQUIRE(tabulated_params(i) ==
+                  Approx(exact_params(i)).epsilon(1.0e-5));
+        } else {
+          REQUIRE(tabulated_params(i) == exact_params(i));
+        }
+      }
+    }
+  }
+
   SECTION("Test model parameter simulation") {
 
     auto pulse_params = test_model.simulate_model_parameters(true, 20);
@@ -412,6 +1669,12 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
     REQUIRE(backcalced_params(2) == Approx(6.5923).epsilon(0.01));
     REQUIRE(backcalced_params(3) == Approx(0.0375).epsilon(0.01));
 
+    // Closed-form intensity times of back-calculated parameters match targets
+    REQUIRE(test_model.calc_parameter_error(
+                {backcalced_params(0), backcalced_params(1),
+                 backcalced_params(2)},
+                3.9, 5.7, 3.9 + 14.0, 1.7) < 1.0e-6);
+
     params << 9.0, 15.2, 3.9, 5.5;
     backcalced_params = test_model.backcalculate_modulating_params(params, 1.7);
 
@@ -446,6 +1709,17 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
     REQUIRE(t30 == Approx(0.02).epsilon(0.01));
     REQUIRE(t99 == Approx(0.025).epsilon(0.01));
 
+    // Single pass over modulating function gives same intensity times
+    const double percentages[4] = {99.0, 1.0, 30.0, 101.0};
+    double intensity_times[4];
+    test_model.calc_times_to_intensity(mod_func, percentages, intensity_times,
+                                       4);
+    REQUIRE(intensity_times[0] == t99);
+    REQUIRE(intensity_times[1] == t01);
+    REQUIRE(intensity_times[2] == t30);
+    REQUIRE(intensity_times[3] ==
+            test_model.calc_time_to_intensity(mod_func, 101.0));
+
     auto frequency_filter =
         test_model.calc_linear_filter(num_steps, filter_params, t01, t30, t99);
 
@@ -470,6 +1744,32 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
             Approx(expected_response.lpNorm<2>()).epsilon(0.01));
   }
 
+  SECTION("Test truncated impulse response filter matches dense filter") {
+    unsigned int num_steps = 2000, num_gms = 3;
+    Eigen::VectorXd filter_params(2);
+    filter_params << 4.0, -0.1;
+    auto frequency_filter =
+        test_model.calc_linear_filter(num_steps, filter_params, 1.0, 4.0, 8.0);
+
+    Eigen::MatrixXd white_noise = Eigen::MatrixXd::Random(num_gms, num_steps);
+    for (double zeta : {0.05, 0.3}) {
+      Eigen::MatrixXd expected =
+          white_noise * test_model.calc_impulse_response_filter(
+                            num_steps, frequency_filter, zeta);
+      Eigen::MatrixXd filtered =
+          test_model.filter_white_noise(white_noise, frequency_filter, zeta);
+
+      REQUIRE(filtered.rows() == num_gms);
+      REQUIRE(filtered.cols() == num_steps);
+      REQUIRE((filtered - expected).cwiseAbs().maxCoeff() < 1.0e-8);
+
+      // Loose tolerance truncates support but stays close
+      filtered = test_model.filter_white_noise(white_noise, frequency_filter,
+                                               zeta, 1.0e-4);
+      REQUIRE((filtered - expected).cwiseAbs().maxCoeff() < 1.0e-2);
+    }
+  }
+
   SECTION("Test acceleration filter") {
     double freq_corner = std::pow(10, 1.4071 - 0.3452 * moment_magnitude);
     unsigned int filter_order = 4;
@@ -490,6 +1790,83 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
     REQUIRE(filtered_accel[5] == Approx(expected_accel[5]).epsilon(0.01));    
   }
 
+  SECTION("Test batched acceleration filter matches single record filter") {
+    double freq_corner = std::pow(10, 1.4071 - 0.3452 * moment_magnitude);
+    unsigned int filter_order = 4;
+    Eigen::MatrixXd accels = Eigen::MatrixXd::Random(64, 3);
+    Eigen::MatrixXd filtered_accels = accels;
+    test_model.filter_acceleration(filtered_accels, freq_corner, filter_order);
+
+    for (unsigned int i = 0; i < accels.cols(); ++i) {
+      auto filtered_accel = test_model.filter_acceleration(
+          accels.col(i), freq_corner, filter_order);
+      for (unsigned int j = 0; j < filtered_accel.size(); ++j) {
+        REQUIRE(filtered_accels(j, i) + 10.0 ==
+                Approx(filtered_accel[j] + 10.0).epsilon(1.0e-12));
+      }
+    }
+  }
+
+  SECTION("Test FFT padding keeps record lengths") {
+    // Records are not truncated, since truncation depends on their values
+    stochastic::DabaghiDerKiureghian exact_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 1, false, 100);
+    stochastic::DabaghiDerKiureghian padded_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 1, false, 100);
+    padded_model.set_fft_padding(true);
+
+    std::vector<stochastic::RecordMetadata> metadata;
+    auto exact_records = exact_model.generate("Exact", metadata);
+    auto padded_records = padded_model.generate("Padded", metadata);
+
+    // Only the frequencies at which the high-pass filter is evaluated change
+    REQUIRE(padded_records.num_records() == exact_records.num_records());
+    for (unsigned int i = 0; i < exact_records.num_records(); ++i) {
+      REQUIRE(padded_records.num_steps(i) == exact_records.num_steps(i));
+      for (unsigned int j = 0; j < exact_records.num_components(); ++j) {
+        auto exact = exact_records.component(i, j);
+        auto padded = padded_records.component(i, j);
+        double error_sq = 0.0, norm_sq = 0.0;
+        for (unsigned int k = 0; k < exact.size(); ++k) {
+          error_sq += std::pow(padded[k] - exact[k], 2);
+          norm_sq += exact[k] * exact[k];
+        }
+        REQUIRE(std::sqrt(error_sq / norm_sq) < 1.0e-4);
+      }
+    }
+  }
+
+  SECTION("Test single precision matches double precision") {
+    stochastic::DabaghiDerKiureghian double_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 1, false, 100);
+    stochastic::DabaghiDerKiureghian single_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 1, false, 100);
+    single_model.set_precision(stochastic::Precision::Single);
+
+    std::vector<stochastic::RecordMetadata> metadata;
+    auto double_records = double_model.generate("Double", metadata);
+    auto single_records = single_model.generate("Single", metadata);
+
+    REQUIRE(single_records.num_records() == double_records.num_records());
+    for (unsigned int i = 0; i < double_records.num_records(); ++i) {
+      REQUIRE(single_records.num_steps(i) == double_records.num_steps(i));
+      for (unsigned int j = 0; j < double_records.num_components(); ++j) {
+        auto exact = double_records.component(i, j);
+        auto single = single_records.component(i, j);
+        double error_sq = 0.0, norm_sq = 0.0;
+        for (unsigned int k = 0; k < exact.size(); ++k) {
+          error_sq += std::pow(single[k] - exact[k], 2);
+          norm_sq += exact[k] * exact[k];
+        }
+        REQUIRE(std::sqrt(error_sq / norm_sq) < 1.0e-4);
+      }
+    }
+  }
+
   SECTION("Test pulse acceleration calculation") {
     Eigen::VectorXd params(5);
     params << 2.0, 3.0, 4.0, 5.0, 6.0;
@@ -512,6 +1889,204 @@ TEST_CASE("Test Dabaghi & Der Kiureghian (2018) implementation", "[Stochastic][S
     REQUIRE(pulse_accel[7] == Approx(expected_accel[7]).epsilon(0.01));
   }
   
+  SECTION("Test parallel generation matches serial generation for seed") {
+    stochastic::DabaghiDerKiureghian serial_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 3, 2, truncate, 100);
+    stochastic::DabaghiDerKiureghian parallel_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 3, 2, truncate, 100);
+    parallel_model.set_num_threads(4);
+
+    auto serial_json = serial_model.generate("Serial").get_library_json();
+    auto parallel_json = parallel_model.generate("Parallel").get_library_json();
+
+    REQUIRE(serial_json["Events"].size() == 6);
+    REQUIRE(parallel_json["Events"].size() == 6);
+    for (unsigned int i = 0; i < serial_json["Events"].size(); ++i) {
+      REQUIRE(serial_json["Events"][i]["timeSeries"] ==
+              parallel_json["Events"][i]["timeSeries"]);
+    }
+
+    // Simulating realizations one at a time gives the same motions as
+    // simulating them together
+    auto parameters = serial_model.simulate_model_parameters(false, 1);
+    std::vector<std::vector<double>> together_1, together_2, single_1,
+        single_2;
+    serial_model.simulate_near_fault_ground_motion(
+        false, parameters.row(0), together_1, together_2, 2, 3);
+    Eigen::VectorXd modulating_params_1 =
+        serial_model.backcalculate_modulating_params(parameters.row(0).head(4));
+    Eigen::VectorXd modulating_params_2 =
+        serial_model.backcalculate_modulating_params(
+            parameters.row(0).segment(7, 4));
+    serial_model.simulate_near_fault_ground_motion(
+        false, parameters.row(0), modulating_params_1, modulating_params_2,
+        single_1, single_2, 1, 3, 1);
+    REQUIRE(single_1.size() == 1);
+    REQUIRE(single_1[0] == together_1[1]);
+    REQUIRE(single_2[0] == together_2[1]);
+  }
+
+  SECTION("Test generation into contiguous storage with metadata") {
+    stochastic::DabaghiDerKiureghian block_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 1, truncate, 100);
+    stochastic::DabaghiDerKiureghian json_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 1, truncate, 100);
+    std::vector<stochastic::RecordMetadata> metadata;
+    auto records = block_model.generate("Block", metadata);
+    auto json = json_model.generate("Block").get_library_json();
+
+    REQUIRE(metadata.size() == 2);
+    for (unsigned int i = 0; i < metadata.size(); ++i) {
+      REQUIRE(metadata[i].name == json["Events"][i]["name"]);
+      REQUIRE(metadata[i].type == "Seismic");
+      REQUIRE(metadata[i].num_steps == json["Events"][i]["numSteps"]);
+      REQUIRE(records.component(i, 1) ==
+              json["Events"][i]["timeSeries"][1]["data"]
+                  .get<std::vector<double>>());
+    }
+  }
+
+  SECTION("Test generated records match JSON time histories") {
+    // Model parameters are drawn from the model's generator, so use separate
+    // models with the same seed
+    stochastic::DabaghiDerKiureghian records_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 2, truncate, 100);
+    stochastic::DabaghiDerKiureghian json_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 2, truncate, 100);
+    records_model.set_num_threads(2);
+    auto records = records_model.generate_records();
+    auto json = json_model.generate("Records").get_library_json();
+
+    REQUIRE(records.num_records() == 4);
+    REQUIRE(json["Events"].size() == 4);
+    for (unsigned int i = 0; i < records.num_records(); ++i) {
+      REQUIRE(json["Events"][i]["numSteps"] == records.num_steps(i));
+      REQUIRE(json["Events"][i]["timeSeries"][0]["data"]
+                  .get<std::vector<double>>() == records.component(i, 0));
+      REQUIRE(json["Events"][i]["timeSeries"][1]["data"]
+                  .get<std::vector<double>>() == records.component(i, 1));
+    }
+  }
+
+  SECTION("Test records generated on demand match records of all events") {
+    stochastic::DabaghiDerKiureghian iterator_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 2, truncate, 100);
+    stochastic::DabaghiDerKiureghian block_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 2, truncate, 100);
+    std::vector<stochastic::RecordMetadata> metadata;
+    auto records = block_model.generate("Lazy", metadata);
+
+    auto iterator = iterator_model.records("Lazy", false, 3);
+    REQUIRE(iterator.num_records() == 4);
+    utilities::TimeHistoryBlock batch;
+    std::vector<stochastic::RecordMetadata> batch_metadata;
+    std::size_t num_batches = 0;
+    while (!iterator.done()) {
+      std::size_t first_record = iterator.position();
+      REQUIRE(iterator.next(batch, batch_metadata));
+      ++num_batches;
+      for (std::size_t i = 0; i < batch.num_records(); ++i) {
+        REQUIRE(batch_metadata[i].name == metadata[first_record + i].name);
+        REQUIRE(batch.component(i, 0) ==
+                records.component(first_record + i, 0));
+        REQUIRE(batch.component(i, 1) ==
+                records.component(first_record + i, 1));
+      }
+    }
+    REQUIRE(num_batches == 2);
+  }
+
+  SECTION("Test streamed file output matches JSON object output") {
+    stochastic::DabaghiDerKiureghian object_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 3, 2, truncate, 100);
+    stochastic::DabaghiDerKiureghian stream_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 3, 2, truncate, 100);
+
+    // A single thread generates the six records in two batches
+    object_model.generate("Stream").write_to_file("./dabaghi_object.json");
+    REQUIRE(stream_model.generate("Stream", "./dabaghi_stream.json", false));
+
+    std::ifstream object_file("./dabaghi_object.json"),
+        stream_file("./dabaghi_stream.json");
+    std::string object_output((std::istreambuf_iterator<char>(object_file)),
+                              std::istreambuf_iterator<char>());
+    std::string stream_output((std::istreambuf_iterator<char>(stream_file)),
+                              std::istreambuf_iterator<char>());
+    REQUIRE(!stream_output.empty());
+    REQUIRE(stream_output == object_output);
+  }
+
+  SECTION("Test appended realizations match one larger campaign") {
+    stochastic::DabaghiDerKiureghian appended_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 1, truncate, 100);
+    stochastic::DabaghiDerKiureghian larger_model(
+        faulting, simulation_type, moment_magnitude, depth_to_rupt,
+        rupture_dist, vs30, s_or_d, theta_or_phi, 2, 3, truncate, 100);
+    std::vector<stochastic::RecordMetadata> larger_metadata;
+    auto larger_records = larger_model.generate("Append", larger_metadata);
+    auto require_larger_record = [&](const utilities::TimeHistoryBlock& block,
+                                     std::size_t record,
+                                     const std::string& name) {
+      std::size_t index = 0;
+      while (index < larger_metadata.size() &&
+             larger_metadata[index].name != name) {
+        ++index;
+      }
+      REQUIRE(index < larger_metadata.size());
+      for (unsigned int j = 0; j < 2; ++j) {
+        REQUIRE(block.component(record, j) ==
+                larger_records.component(index, j));
+      }
+    };
+
+    REQUIRE(appended_model.generate("Append", "./dabaghi_append.json", false));
+    REQUIRE(appended_model.append("Append", "./dabaghi_append.json", 1));
+    REQUIRE(appended_model.num_records() == 4);
+    std::ifstream appended_file("./dabaghi_append.json");
+    auto appended_json = nlohmann::json::parse(appended_file);
+    REQUIRE(appended_json["Events"].size() == 4);
+    auto larger_events = larger_model.events_json("Append", larger_records, 0);
+    unsigned int num_matches = 0;
+    for (const auto& event : appended_json["Events"]) {
+      for (const auto& larger_event : larger_events) {
+        auto larger = larger_event.get_library_json();
+        if (larger["name"] == event["name"]) {
+          REQUIRE(larger["timeSeries"] == event["timeSeries"]);
+          ++num_matches;
+        }
+      }
+    }
+    REQUIRE(num_matches == 4);
+
+    // Iterators continue the grown campaign
+    auto iterator = appended_model.append_records("Append", 1);
+    REQUIRE(iterator.num_records() == 2);
+    utilities::TimeHistoryBlock batch;
+    std::vector<stochastic::RecordMetadata> metadata;
+    while (iterator.next(batch, metadata)) {
+      for (std::size_t i = 0; i < batch.num_records(); ++i) {
+        require_larger_record(batch, i, metadata[i].name);
+      }
+    }
+    REQUIRE(appended_model.num_records() == 6);
+  }
+
+  SECTION("Test spectral archives are not supported") {
+    REQUIRE_THROWS_AS(test_model.spectral_archive("Seismic"),
+                      std::runtime_error);
+  }
+
   SECTION("Test JSON generation") {
     bool success = test_model.generate("BlahBlah", "./dabaghi_test.json", true);
   }